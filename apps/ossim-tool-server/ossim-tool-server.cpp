@@ -7,20 +7,53 @@
 
 #include <ossim/init/ossimInit.h>
 #include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimApplicationUsage.h>
+#include <ossim/base/ossimNotify.h>
 #include <ossim/sockets/ossimToolServer.h>
+#include <cstdlib>
 
 int main(int argc, char *argv[])
 {
+   ossimArgumentParser ap(&argc, argv);
+   ap.getApplicationUsage()->setApplicationName(ap.getApplicationName());
+   ap.getApplicationUsage()->setCommandLineUsage(ap.getApplicationName() + " [options] [<port>]");
+   ap.getApplicationUsage()->addCommandLineOption("-h or --help", "Display this information");
+   ap.getApplicationUsage()->addCommandLineOption("--fork",
+      "Serve each connection in a forked child process.");
+   ap.getApplicationUsage()->addCommandLineOption("--serial",
+      "Serve one connection at a time in this process.");
+   ap.getApplicationUsage()->addCommandLineOption("--threads <n>",
+      "Worker threads serving connections in this process. This is the default, with one thread "
+      "per core.");
 
    // Initialize ossim stuff, factories, plugin, etc.
-   ossimInit::instance()->initialize(argc, argv);
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   if (ap.read("-h") || ap.read("--help"))
+   {
+      ap.getApplicationUsage()->write(ossimNotify(ossimNotifyLevel_INFO));
+      return 0;
+   }
+
+   ossimToolServer ots;
+   std::string ts;
+   ossimArgumentParser::ossimParameter sp(ts);
+   if (ap.read("--threads", sp))
+   {
+      ots.setServerMode(ossimToolServer::THREAD_POOL_MODE);
+      ots.setNumberOfThreads((ossim_uint32) atoi(ts.c_str()));
+   }
+   if (ap.read("--fork"))
+      ots.setServerMode(ossimToolServer::FORK_MODE);
+   if (ap.read("--serial"))
+      ots.setServerMode(ossimToolServer::SERIAL_MODE);
 
    const char* DEFAULT_PORT = "ossimd";
    const char* portid = DEFAULT_PORT;
-   if (argc > 1)
-      portid = argv[1];
+   if (ap.argc() > 1)
+      portid = ap[1];
 
-   ossimToolServer ots;
    ots.startListening(portid);
 
    return 0;
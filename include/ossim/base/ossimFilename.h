@@ -212,6 +212,13 @@ public:
    static bool wildcardRemove(const ossimFilename& pathname);
 
    bool rename(const ossimFilename& destFile, bool overwriteDestinationFlag=true)const;
+
+   /**
+    * @return This file name with a ".<pid>.<thread>.<time>.tmp" suffix no other writer, in this
+    * or another process, uses at the same time.  Write to it, then rename it over this file so
+    * readers only ever see a whole file.
+    */
+   ossimFilename getUniqueTempFilename()const;
    
    bool remove()const;
    bool wildcardRemove()const;
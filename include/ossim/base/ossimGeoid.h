@@ -19,6 +19,7 @@
 #include <ossim/base/ossimObject.h>
 #include <ossim/base/ossimErrorStatusInterface.h>
 
+class ossimDpt;
 class ossimGpt;
 class ossimFilename;
 
@@ -36,6 +37,25 @@ public:
     */
    virtual double offsetFromEllipsoid(const ossimGpt& gpt) = 0;
 
+   /**
+    *  Batch form of offsetFromEllipsoid.  Writes the offset of each of the count
+    *  points to offsets (ossim::nan() where the grid does not contain the point).
+    *  The default implementation loops over offsetFromEllipsoid.
+    */
+   virtual void offsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                     double* offsets);
+
+   /**
+    *  Offsets over a regular WGS-84 grid of rows x cols points.  Point (r, c)
+    *  is at lat = origin.y + r * spacing.y, lon = origin.x + c * spacing.x
+    *  and its offset is written to offsets[r * cols + c].  The default
+    *  implementation calls offsetsFromEllipsoid a row at a time.
+    */
+   virtual void offsetsFromEllipsoidGrid(const ossimDpt& origin,
+                                         const ossimDpt& spacing,
+                                         ossim_uint32 cols, ossim_uint32 rows,
+                                         double* offsets);
+
 protected:
    virtual ~ossimGeoid();
    
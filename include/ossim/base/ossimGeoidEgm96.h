@@ -16,6 +16,7 @@
 #define ossimGeoidEgm96_HEADER
 
 #include <ossim/base/ossimGeoid.h>
+#include <memory>
 #include <vector>
 
 #define GEOID_NO_ERROR              0x0000
@@ -48,6 +49,25 @@ public:
     */
    virtual double offsetFromEllipsoid(const ossimGpt& gpt);
 
+   /**
+    *  Batch form of offsetFromEllipsoid.  Points already on WGS-84 skip the
+    *  datum shift.
+    */
+   virtual void offsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                     double* offsets);
+
+   /**
+    *  Grid form of offsetFromEllipsoid.  The grid posts and weights are
+    *  computed once per row and column.
+    */
+   virtual void offsetsFromEllipsoidGrid(const ossimDpt& origin,
+                                         const ossimDpt& spacing,
+                                         ossim_uint32 cols, ossim_uint32 rows,
+                                         double* offsets);
+
+   /** @return true if the grid is memory mapped rather than read to the heap. */
+   bool isMemoryMapped() const;
+
    double geoidToEllipsoidHeight(double lat,
                                  double lon,
                                  double geoidHeight);
@@ -57,8 +77,25 @@ public:
                            double ellipsoidHeight);
 protected:
 
+   /** Reads the grid to theGeoidHeightBuffer. */
+   bool readGrid(const ossimFilename& grid, ossimByteOrder byteOrder);
+
+   /**
+    * Maps a native byte order grid read only, so every process using it
+    * shares its pages.  A grid of the other byte order is first written in
+    * native order to the geoid_egm_96_grid.native_cache_directory preference
+    * if that is set.
+    */
+   bool mapGrid(const ossimFilename& grid, ossimByteOrder byteOrder);
+
+   /** @return Offset at a WGS-84 point or nan. */
+   double interpolate(double lat, double lon) const;
+
    std::vector<float> theGeoidHeightBuffer;
-   mutable float* theGeoidHeightBufferPtr;
+   const float* theGeoidHeightBufferPtr;
+
+   /** Mapped grid, header included.  Shared by instances on the same file. */
+   std::shared_ptr<const float> theMappedGrid;
    TYPE_DATA
 };
 
@@ -48,6 +48,22 @@ public:
     */
    virtual double offsetFromEllipsoid(const ossimGpt& gpt);
 
+   /**
+    *  Batch form of offsetFromEllipsoid.  Each geoid in the list is asked once
+    *  for all points the geoids before it could not resolve.
+    */
+   virtual void offsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                     double* offsets);
+
+   /**
+    *  Grid form of offsetsFromEllipsoid.  The first geoid is asked for the
+    *  whole grid, the others for the points it could not resolve.
+    */
+   virtual void offsetsFromEllipsoidGrid(const ossimDpt& origin,
+                                         const ossimDpt& spacing,
+                                         ossim_uint32 cols, ossim_uint32 rows,
+                                         double* offsets);
+
    /**
     * Method to save the state of the object to a keyword list.
     * Return true if ok or false on error. DO NOTHING
@@ -80,6 +96,15 @@ private:
     */
    ossimGeoidManager();
 
+   /**
+    *  Resolves the points of gpts listed in pending, with their offsets
+    *  still nan, with the geoids from geoid on.
+    */
+   void resolvePending(const ossimGpt* gpts,
+                       std::vector<ossim_uint32>& pending,
+                       std::vector< ossimRefPtr<ossimGeoid> >::iterator geoid,
+                       double* offsets);
+
    //static ossimGeoidManager* theInstance;
    mutable std::vector< ossimRefPtr<ossimGeoid> > theGeoidList;
    
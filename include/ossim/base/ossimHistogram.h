@@ -105,6 +105,23 @@ class OSSIMDLLEXPORT ossimHistogram : public ossimObject
   
 // Attribute accessors
     void UpCount(float newval, float occurences=1);
+
+    /**
+     * @brief Adds the counts of size consecutive integer values starting at
+     * firstValue.  Same as UpCount(firstValue + i, counts[i]) for each i with
+     * a non zero count, so values outside of the range are dropped.
+     */
+    void UpCountRange(ossim_int32 firstValue,
+                      const ossim_uint32* counts,
+                      ossim_uint32 size);
+
+    /**
+     * @brief Adds the counts of histo to this one.
+     * @return false, with nothing added, if histo does not have the same
+     * number of bins and range.
+     */
+    bool addCounts(const ossimHistogram& histo);
+
     float GetCount(float uval)const;
     float SetCount(float pixelval, float count);
 
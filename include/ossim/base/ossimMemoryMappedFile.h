@@ -0,0 +1,80 @@
+//---
+//
+// License: MIT
+//
+// Description: Read-only memory mapping of a local file.
+//
+//---
+// $Id$
+
+#ifndef ossimMemoryMappedFile_HEADER
+#define ossimMemoryMappedFile_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+
+/**
+ * Maps a local file read-only into the address space.  Pages are brought in by the
+ * operating system on first touch and shared between every process mapping the same
+ * file, so mapping a large file costs address space only.
+ *
+ * The mapped bytes are never modified, so any number of threads may read through
+ * data() concurrently without locking.  The mapping stays valid until close() or
+ * destruction; hold the object in a std::shared_ptr to share one mapping between
+ * several readers (e.g. duplicated elevation cell handlers).
+ *
+ * @code
+ * ossimMemoryMappedFile mmf;
+ * if ( mmf.open( file ) )
+ * {
+ *    const ossim_uint8* buf = mmf.data();
+ *    ...
+ * }
+ * @endcode
+ */
+class OSSIM_DLL ossimMemoryMappedFile
+{
+public:
+   ossimMemoryMappedFile();
+
+   /** Unmaps the file. */
+   ~ossimMemoryMappedFile();
+
+   /**
+    * Maps the whole file.
+    *
+    * @param file Local file to map.
+    * @return true on success, false if the file is missing, empty or cannot be mapped.
+    */
+   bool open( const ossimFilename& file );
+
+   /** Unmaps the file.  Pointers previously returned by data() become invalid. */
+   void close();
+
+   /** @return true if a file is mapped. */
+   bool isOpen() const { return ( m_data != 0 ); }
+
+   /** @return Pointer to the first byte of the file or 0 if not open. */
+   const ossim_uint8* data() const { return m_data; }
+
+   /** @return Size of the mapping in bytes. */
+   ossim_uint64 size() const { return m_size; }
+
+   /** @return The mapped file. */
+   const ossimFilename& getFilename() const { return m_filename; }
+
+private:
+   // Not copyable; share through a std::shared_ptr instead.
+   ossimMemoryMappedFile( const ossimMemoryMappedFile& );
+   const ossimMemoryMappedFile& operator=( const ossimMemoryMappedFile& );
+
+   const ossim_uint8* m_data;
+   ossim_uint64       m_size;
+   ossimFilename      m_filename;
+#if defined(_WIN32)
+   void*              m_fileHandle;
+   void*              m_mappingHandle;
+#endif
+};
+
+#endif /* #ifndef ossimMemoryMappedFile_HEADER */
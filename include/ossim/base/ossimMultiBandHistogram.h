@@ -41,6 +41,12 @@ public:
 
    void create(ossim_int32 numberOfBands);
    void setBinCount(double binNumber, double count);
+
+   /**
+    * @brief Adds the counts of each band of histo to the same band of this.
+    * @return false if the band count or the bins of a band differ.
+    */
+   bool addCounts(const ossimMultiBandHistogram& histo);
    ossimRefPtr<ossimHistogram> getHistogram(ossim_int32 band);
    const ossimRefPtr<ossimHistogram> getHistogram(ossim_int32 band)const;
 
@@ -25,6 +25,7 @@
 
 #include <ossim/base/ossimConstants.h>
 #include <ossim/base/ossimString.h>
+#include <ossim/base/ossimMemoryMappedFile.h>
 #include <ossim/elevation/ossimElevCellHandler.h>
 #include <ossim/support_data/ossimDtedVol.h>
 #include <ossim/support_data/ossimDtedHdr.h>
@@ -67,6 +68,8 @@ public:
    * Constructor
    */
    ossimDtedHandler()
+   : m_cellBuf(0),
+     m_cellBufSize(0)
    {
    }
 
@@ -75,9 +78,8 @@ public:
    *
    * @param dted_file is a file path to the dted cell we wish to
    *        open
-   * @param memoryMapFlag If this is set we will pull the entire cell
-   *        into memory and treat that memory location as an 
-   *        inputstream.
+   * @param memoryMapFlag If this is set the cell is memory mapped and
+   *        posts are read straight from the mapping without locking.
    */
    ossimDtedHandler(const ossimFilename& dted_file, bool memoryMapFlag=false);
 
@@ -94,9 +96,8 @@ public:
    *
    * @param file is a file path to the dted cell we wish to
    *        open
-   * @param memoryMapFlag If this is set we will pull the entire cell
-   *        into memory and treat that memory location as an 
-   *        inputstream.
+   * @param memoryMapFlag If this is set the cell is memory mapped and
+   *        posts are read straight from the mapping without locking.
    */
    virtual bool open(const ossimFilename& file, bool memoryMapFlag=false);
 
@@ -107,9 +108,9 @@ public:
    *        to a cell.
    * @param connectionString is the connection string used to open the
    *        input stream.
-   * @param memoryMapFlag If this is set we will pull the entire cell
-   *        into memory and treat that memory location as an 
-   *        inputstream.
+   * @param memoryMapFlag If this is set the cell is memory mapped when the
+   *        connection string is a local file, otherwise the stream is
+   *        read into memory.
    */
    virtual bool open(std::shared_ptr<ossim::istream>& fileStr, const std::string& connectionString, bool memoryMapFlag=false);
    virtual void close();
@@ -166,7 +167,7 @@ public:
 
    virtual ossimObject* dup () const
    {
-      return new ossimDtedHandler(this->getFilename(), (m_memoryMap.size() != 0));
+      return new ossimDtedHandler(this->getFilename(), (m_cellBuf != 0));
    }
 
    virtual ~ossimDtedHandler();
@@ -252,8 +253,13 @@ protected:
    // Indicates whether byte swapping is needed.
    bool m_swapBytesFlag;
 
-   mutable std::mutex m_memoryMapMutex;
-   mutable std::vector<ossim_uint8> m_memoryMap;
+   // In-memory cell: either the file mapping or, for streams that cannot be
+   // mapped, a copy.  m_cellBuf points at whichever is in use and is null when
+   // posts are read from m_fileStr.  The buffer is read-only, so no lock.
+   std::shared_ptr<ossimMemoryMappedFile> m_memoryMap;
+   std::vector<ossim_uint8> m_memoryCopy;
+   const ossim_uint8*       m_cellBuf;
+   ossim_uint64             m_cellBufSize;
    
    std::shared_ptr<ossimDtedVol> m_vol;
    std::shared_ptr<ossimDtedHdr> m_hdr;
@@ -284,7 +290,7 @@ inline ossim_sint16 ossimDtedHandler::convertSignedMagnitude(ossim_uint16& s) co
 inline bool ossimDtedHandler::isOpen()const
 {
 
-  if(!m_memoryMap.empty()) return true;
+  if(m_cellBuf) return true;
   std::lock_guard<std::mutex> lock(m_fileStrMutex);
 
   return (m_fileStr != 0);
@@ -293,7 +299,10 @@ inline bool ossimDtedHandler::isOpen()const
 inline void ossimDtedHandler::close()
 {
    m_fileStr.reset();
-   m_memoryMap.clear();
+   m_cellBuf = 0;
+   m_cellBufSize = 0;
+   m_memoryMap.reset();
+   m_memoryCopy.clear();
 }
 
 #endif
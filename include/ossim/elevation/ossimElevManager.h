@@ -25,7 +25,9 @@
 #include <ossim/base/ossimVisitor.h>
 #include <ossim/elevation/ossimElevSource.h>
 #include <ossim/elevation/ossimElevationDatabase.h>
+#include <atomic>
 #include <mutex>
+#include <unordered_map>
 
 class OSSIM_DLL ossimElevManager : public ossimElevSource
 {
@@ -58,6 +60,38 @@ public:
    virtual double getHeightAboveMSL(const ossimGpt& gpt);
    virtual bool pointHasCoverage(const ossimGpt&) const;
 
+   /**
+    * Batch forms of getHeightAboveEllipsoid() and getHeightAboveMSL().  Results equal the
+    * single point calls, including the default height, geoid and elevation offset
+    * fallbacks, but the database list is picked once and, per one degree bucket, each
+    * database covering the bucket is queried once with all points the databases before it
+    * could not resolve.  Cell databases group the points by cell, so cell lookups and their
+    * locks happen once per cell.
+    *
+    * @param gpts    count ground points.
+    * @param count   Number of points.
+    * @param heights Output, count values.
+    */
+   virtual void getHeightsAboveEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                         double* heights);
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts, ossim_uint32 count, double* heights);
+
+   /**
+    * Heights above ellipsoid for separate latitude and longitude arrays (WGS84 degrees).
+    */
+   void getHeightsAboveEllipsoid(const ossim_float64* lats, const ossim_float64* lons,
+                                 ossim_uint32 count, double* heights);
+
+   /**
+    * Heights above ellipsoid for a regular lat/lon grid.  Point (line, sample) is at
+    * (origin.lat + line*deltaLat, origin.lon + sample*deltaLon); heights are written
+    * line by line and must hold numLines*numSamples values.
+    */
+   void getHeightsAboveEllipsoid(const ossimGpt& origin,
+                                 ossim_float64 deltaLat, ossim_float64 deltaLon,
+                                 ossim_uint32 numLines, ossim_uint32 numSamples,
+                                 double* heights);
+
    /**
     * Returns the mean post spacing (in meters) for the highest resolution DEM in the list or NaN
     * if no DEMs have been loaded. Recommended to perform a getHeight() call for a central
@@ -172,6 +206,33 @@ protected:
    void loadStandardElevationPaths();
 
    ElevationDatabaseListType& getNextElevDbList() const; // for multithreading
+
+   /**
+    * Picks a round robin list and, bucket by bucket, queries the databases that may cover
+    * the bucket in order, each with the points still unresolved.  On return unresolved holds
+    * the indexes of the points no database covers.
+    */
+   void getDatabaseHeights(bool ellipsoidFlag, const ossimGpt* gpts, ossim_uint32 count,
+                           double* heights, std::vector<ossim_uint32>& unresolved);
+
+   /**
+    * @return Indexes, in list order, of the databases whose coverage may hold gpt.  The last
+    * bucket looked up is kept per thread, so runs of nearby points skip the hash lookup.
+    */
+   const std::vector<ossim_uint32>& getCandidateDatabases(const ossimGpt& gpt) const;
+
+   /** @return true if database idx can be skipped for gpt as gpt is outside its coverage. */
+   bool isOutsideCoverage(ossim_uint32 idx, const ossimGpt& gpt) const;
+
+   /**
+    * Rebuilds the coverage index from the databases in m_dbRoundRobin[0] if it is stale.  Called
+    * on the first lookup after databases change rather than on every addDatabase, as getting the
+    * coverage of an image database opens each of its DEMs.
+    */
+   void rebuildCoverageIndex() const;
+
+   /** @return Key of the one degree bucket holding gpt. */
+   static ossim_int32 getCoverageBucket(const ossimGpt& gpt);
    
    //static ossimElevManager* m_instance;
    mutable std::vector<ElevationDatabaseListType> m_dbRoundRobin;
@@ -184,6 +245,22 @@ protected:
    bool m_useStandardPaths;
    
    mutable ossim_uint32 m_currentDatabaseIdx;
+
+   /**
+    * Coverage index.  m_coverageIndex maps a one degree bucket to the databases whose
+    * coverage rectangles touch it, merged in list order with m_unboundedDatabases, the ones
+    * that do not know their coverage up front.  Buckets no rectangle touches use
+    * m_unboundedDatabases.  Indexes are positions in the round robin lists, which all hold
+    * the same databases in the same order.  m_coverageIndexGeneration changes on every
+    * rebuild so per thread lookups cached from an older index are dropped.  The index is built
+    * lazily under m_coverageMutex once m_coverageIndexStale is set.
+    */
+   mutable std::unordered_map<ossim_int32, std::vector<ossim_uint32> > m_coverageIndex;
+   mutable std::vector<ossim_uint32> m_unboundedDatabases;
+   mutable std::vector<ossimGrect>   m_databaseCoverage; // nan if unknown
+   mutable ossim_uint32              m_coverageIndexGeneration;
+   mutable std::atomic<bool>         m_coverageIndexStale;
+   mutable std::mutex                m_coverageMutex;
    
    /**
     * I have tried the readwrite lock interfaces but have found it unstable.  I am using the standard Mutex
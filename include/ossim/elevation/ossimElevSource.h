@@ -38,6 +38,16 @@ public:
    virtual double getHeightAboveMSL(const ossimGpt&) = 0;
    virtual double getHeightAboveEllipsoid(const ossimGpt&);
 
+   /**
+    * Batch height access.  Computes the height for each of the count points in gpts and
+    * writes it to the matching entry of heights (NaN where there is no coverage).  The
+    * default implementation loops over the single point methods; sources that can share
+    * locks, cell lookups or geoid work across points override these.
+    */
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts, ossim_uint32 count, double* heights);
+   virtual void getHeightsAboveEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                         double* heights);
+
    // Forces all concrete subtypes to implement:
    virtual ossimObject* dup() const = 0;
 
@@ -123,6 +123,20 @@ public:
    }
    virtual ossimRefPtr<ossimElevCellHandler> getOrCreateCellHandler(const ossimGpt& gpt);
 
+   /**
+    * Batch height access.  Points are grouped by createId() so the cell cache is
+    * searched (and its mutex taken) once per cell rather than once per point, and each
+    * cell handler gets all of its points in a single call.  Points a cell handler does
+    * not cover fall back to getHeightAboveMSL().
+    */
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts, ossim_uint32 count, double* heights);
+
+   /**
+    * Same as getHeightsAboveMSL() with the geoid offsets looked up as one batch.
+    */
+   virtual void getHeightsAboveEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                         double* heights);
+
    virtual std::ostream& print(std::ostream& out) const;
 
 protected:
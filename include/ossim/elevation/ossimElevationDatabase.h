@@ -66,6 +66,21 @@ public:
       return m_connectionString;
    }
 
+   /**
+    * @brief Gets the ground rectangle the database can return heights in.
+    *
+    * Used by ossimElevManager to skip databases that cannot cover a point.  Called on the
+    * first height lookup after the database is added rather than by addDatabase.
+    *
+    * @param rect Initialized by this.
+    * @return false if the coverage is not known up front, e.g. a directory of
+    * cells that are only found when a point asks for them.
+    */
+   virtual bool getCoverageRect(ossimGrect& /*rect*/) const
+   {
+      return false;
+   }
+
    virtual bool loadState(const ossimKeywordlist& kwl, const char* prefix=0);
    
    virtual bool saveState(ossimKeywordlist& kwl, const char* prefix=0)const;
@@ -79,6 +94,12 @@ protected:
    }
    virtual double getOffsetFromEllipsoid(const ossimGpt& gpt);
 
+   /**
+    * Batch form of getOffsetFromEllipsoid.  Points outside the geoid grid get 0.0.
+    */
+   virtual void getOffsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                        double* offsets);
+
    ossimString m_connectionString;
    ossimRefPtr<ossimGeoid>    m_geoid;
    ossim_float64              m_meanSpacing;
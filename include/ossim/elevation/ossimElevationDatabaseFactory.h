@@ -15,8 +15,10 @@
 * elevation_manager.elevation_source1.enabled: true
 * elevation_manager.elevation_source1.memory_map_cells: true
 * @endcode
-* Note:  only use memory_map_cells to true if they are small files.  DTED0 is 
-* small so we set it to true.
+* Note:  memory_map_cells maps local cell files with mmap so the cost is address
+* space rather than heap, and posts are read without locking.  Cells that are
+* not local files (e.g. remote streams) are still read fully into memory, so
+* only set it for those if they are small.
 * Where the dted file tree has the form: <rootdir>/w056/n49.dt0
 *
 * Example General Raster directory:
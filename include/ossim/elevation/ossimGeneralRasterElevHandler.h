@@ -16,6 +16,7 @@
 //#include <fstream>
 
 #include <ossim/base/ossimString.h>
+#include <ossim/base/ossimMemoryMappedFile.h>
 #include <ossim/base/ossimDatum.h>
 #include <ossim/elevation/ossimElevCellHandler.h>
 #include <ossim/imaging/ossimGeneralRasterInfo.h>
@@ -29,6 +30,7 @@
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimDpt.h>
 #include <ossim/base/ossimGpt.h>
+#include <memory>
 #include <mutex>
 class ossimProjection;
 /**
@@ -162,7 +164,8 @@ private:
    /** @brief true if stream is open. */
    bool          m_streamOpen;
    
-   std::vector<char> m_memoryMap;
+   /** Mapping of the raster if opened with memoryMapFlag; read without locking. */
+   std::shared_ptr<ossimMemoryMappedFile> m_memoryMap;
 TYPE_DATA
 };
 
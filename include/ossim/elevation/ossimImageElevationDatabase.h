@@ -87,6 +87,16 @@ public:
     * @return Height above MSL.
     */
    virtual double getHeightAboveEllipsoid(const ossimGpt&);
+
+   /**
+    * @brief Batch height queries.
+    *
+    * Cells are arbitrary images found through the entry map, not createId(), so
+    * these go point by point like the ossimElevSource defaults.
+    */
+   virtual void getHeightsAboveMSL(const ossimGpt* gpts, ossim_uint32 count, double* heights);
+   virtual void getHeightsAboveEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                         double* heights);
    
    /**
     * Satisfies pure virtual ossimElevSource::pointHasCoverage
@@ -126,6 +136,12 @@ public:
     */
    void getBoundingRect(ossimGrect& rect) const;
 
+   /**
+    * @brief Gets the bounding rectangle of all entries.
+    * @return false if no entry could be opened.
+    */
+   virtual bool getCoverageRect(ossimGrect& rect) const;
+
    /**
     * @brief ProcessFile method.
     *
@@ -182,8 +198,11 @@ private:
       /** file name */
       ossimFilename m_file;
 
-      /** Bounding rectangle in decimal degrees. */
-      ossimGrect m_rect;
+      /**
+       * Bounding rectangle in decimal degrees.  Nan until the file is opened.
+       * Mutable so getBoundingRect can keep it.
+       */
+      mutable ossimGrect m_rect;
       ossimDpt m_nominalGSD; // post spacing at center
 
       /** True if in ossimElevationCellDatabase::m_cacheMap. */
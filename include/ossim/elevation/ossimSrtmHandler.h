@@ -17,8 +17,10 @@
 //#include <fstream>
 
 #include <ossim/base/ossimString.h>
+#include <ossim/base/ossimMemoryMappedFile.h>
 #include <ossim/elevation/ossimElevCellHandler.h>
 #include <ossim/support_data/ossimSrtmSupportData.h>
+#include <memory>
 #include <mutex>
 
 class ossimEndian;
@@ -77,7 +79,7 @@ public:
    virtual ossimObject* dup() const
    {
       ossimSrtmHandler* obj = new ossimSrtmHandler();
-      obj->open(theFilename, (m_memoryMap.size() != 0));
+      obj->open(theFilename, (m_memoryMap != 0));
       return obj;
    }
 
@@ -100,7 +102,8 @@ protected:
    ossimEndian*     m_swapper;
    ossimScalarType  m_scalarType;
    
-   mutable std::vector<ossim_int8> m_memoryMap;
+   /** Mapping of the cell if opened with memoryMapFlag; read without locking. */
+   std::shared_ptr<ossimMemoryMappedFile> m_memoryMap;
    
    template <class T>
    double getHeightAboveMSLFileTemplate(T dummy, const ossimGpt& gpt);
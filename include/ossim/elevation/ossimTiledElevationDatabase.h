@@ -98,6 +98,11 @@ public:
     */
    virtual bool pointHasCoverage(const ossimGpt& gpt) const;
 
+   /**
+    * @brief Gets the mapped rectangle.
+    * @return false if nothing is mapped yet.
+    */
+   virtual bool getCoverageRect(ossimGrect& rect) const;
 
    /** @brief Initialize from keyword list. */
    virtual bool loadState(const ossimKeywordlist& kwl, const char* prefix=0);
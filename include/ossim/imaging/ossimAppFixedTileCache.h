@@ -18,11 +18,22 @@
 #include <ossim/base/ossimConstants.h>
 #include <ossim/base/ossimRefPtr.h>
 #include <ossim/base/ossimIrect.h>
+#include <ossim/base/RWLock.h>
+#include <ossim/imaging/ossimFixedTileCache.h>
+#include <atomic>
 #include <mutex>
 
-class ossimFixedTileCache;
 class ossimImageData;
 
+/**
+ * Application wide registry of fixed tile caches sharing one global byte budget.
+ *
+ * The cache map is guarded by a read/write lock so tile lookups from many threads only take a
+ * shared lock here; the per-tile locking is done by the sharded ossimFixedTileCache. The current
+ * byte total is kept in an atomic counter and trimmed by one thread at a time when the budget is
+ * exceeded. Flushes subtract the bytes the fixed tile cache reports removing, so the total equals
+ * the sum of the cache sizes once concurrent adds and flushes have finished.
+ */
 class OSSIM_DLL ossimAppFixedTileCache
 {
 public:
@@ -67,30 +78,24 @@ public:
    const ossimIpt& getTileSize(ossimAppFixedCacheId cacheId);
    
    virtual void setMaxCacheSize(ossim_uint32 cacheSize);
+
+   /**
+    * Returns hit, miss and eviction counters for the cache.
+    * @return false if cacheId is not a valid cache.
+    */
+   bool getStatistics(ossimAppFixedCacheId cacheId,
+                      ossimFixedTileCache::Statistics& stats)const;
+
+   /** Returns bytes currently held over all caches. */
+   ossim_uint32 getCurrentCacheSize()const;
    
 protected:
-//    struct ossimAppFixedCacheTileInfo
-//    {
-//    public:
-//       ossimAppFixedCacheTileInfo(ossimAppFixedCacheId appId,
-//                                  const ossimIpt& origin)
-//          :theAppCacheId(appId),
-//           theOrigin(origin)
-//          {}
-//       ossimAppFixedCacheId  theAppCacheId;
-//       ossimIpt       theOrigin;
-      
-//       bool operator ==(const ossimAppFixedCacheTileInfo &rhs)const
-//          {
-//             return (theAppCacheId == rhs.theAppCacheId &&
-//                     theOrigin     == rhs.theOrigin);
-//          } 
-//    };
-   
    ossimAppFixedTileCache();
    
-   ossimFixedTileCache* getCache(ossimAppFixedCacheId cacheId);
+   /** Looks up cache. Caller must hold theCacheMapLock (read or write). */
+   ossimFixedTileCache* getCache(ossimAppFixedCacheId cacheId)const;
 
+   /** Evicts least recently used tiles round-robin over caches. Caller holds read lock. */
    void shrinkGlobalCacheSize(ossim_int32 byteCount);
    void shrinkCacheSize(ossimAppFixedCacheId id,
                         ossim_int32 byteCount);
@@ -107,11 +112,15 @@ protected:
    ossimIpt                       theTileSize;
    ossim_uint32                   theMaxCacheSize;
    ossim_uint32                   theMaxGlobalCacheSize;
-   ossim_uint32                   theCurrentCacheSize;
+   std::atomic<ossim_int64>       theCurrentCacheSize;
+
+   std::map<ossimAppFixedCacheId, ossimRefPtr<ossimFixedTileCache> > theAppCacheMap;
 
-   std::map<ossimAppFixedCacheId, ossimFixedTileCache*> theAppCacheMap;
+   /** Guards theAppCacheMap. Writers are cache creation/deletion only. */
+   mutable ossim::RWLock theCacheMapLock;
 
-   std::mutex theMutex;
+   /** Serializes global shrinking so only one thread evicts at a time. */
+   std::mutex theShrinkMutex;
 };
 
 #endif
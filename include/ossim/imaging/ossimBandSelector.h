@@ -37,6 +37,11 @@ public:
    virtual ossimRefPtr<ossimImageData> getTile(const ossimIrect& tileRect,
                                                ossim_uint32 resLevel=0);
 
+   /** Passed to the input since tiles are requested one to one. */
+   virtual void setTileRequestOrder(const ossimIrect& area,
+                                    const ossimIpt& tileSize,
+                                    ossim_uint32 resLevel=0);
+
    /**
     * Initializes bandList to the zero based order of output bands.
     */
@@ -73,6 +73,22 @@ protected:
    virtual ossimRefPtr<ossimImageData> fillTile(
       const ossimIrect& tileRect, ossim_uint32 resLevel,
       ossimAppFixedTileCache::ossimAppFixedCacheId cacheId );
+
+   /**
+    * @brief Gets one cache tile from the application cache, then the shared
+    * tile cache, then the input.  Tiles read from the input are added to
+    * both caches.
+    */
+   ossimRefPtr<ossimImageData> getCacheTile(
+      const ossimIrect& rect, ossim_uint32 resLevel,
+      ossimAppFixedTileCache::ossimAppFixedCacheId cacheId );
+
+   /**
+    * @brief Computes the id tiles are keyed by in the shared tile cache from
+    * the state of the chain down to the image handler.
+    * @return Id or 0 if there is no image handler below us.
+    */
+   ossim_uint64 computeSharedCacheId() const;
                                                 
 
    ossimRefPtr<ossimImageData> theTile;
@@ -82,6 +98,9 @@ protected:
    bool                        theUseInputTileSizeFlag;
    RLevelCacheList             theRLevelCacheList;
    ossimIpt                    theTileSizeXY;
+
+   /** Key of our input in ossimSharedTileCache. 0 if not shared. */
+   ossim_uint64                theSharedCacheId;
    
    /** For lock and unlock. */
 
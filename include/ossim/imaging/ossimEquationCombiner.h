@@ -13,6 +13,7 @@
 #define ossimEquationCombiner_HEADER
 #include <ossim/imaging/ossimImageCombiner.h>
 #include <ossim/imaging/ossimCastTileSourceFilter.h>
+#include <ossim/imaging/ossimEquationProgram.h>
 #include <ossim/base/ossimEquTokenizer.h>
 #include <stack>
 
@@ -161,6 +162,10 @@
  * 
  * Rescaled NDVI between 0 and 1:
  * (N+1)/2 = in[0]/(in[0]+in[1])
+ *
+ * Pixel wise equations, i.e. ones without shift, blurr, conv, assign_band
+ * or clamp, are compiled once into an ossimEquationProgram and evaluated
+ * without re-parsing or float64 tile copies.  The others are parsed per tile.
  * 
  * With an ossimImageToPlaneNormalFilter feeding the DEM-image input, the slope at each pixel,
  * normalized so that 1.0 = 90 deg from vertical, is computed with:
@@ -259,6 +264,14 @@ protected:
    mutable int                theCurrentId;
    mutable std::stack<ossimEquValue> theValueStack;
    ossim_uint32                     theCurrentResLevel;
+   ossimEquationProgram             theProgram;
+
+   /**
+    * Evaluates theEquation with theProgram into theTile, compiling it first
+    * if it changed.
+    * @return false if the equation must be parsed instead.
+    */
+   virtual bool evaluateProgram();
    virtual void assignValue();
    virtual void clearStacks();
    virtual void clearArgList(vector<ossimEquValue>& argList);
@@ -0,0 +1,136 @@
+//*******************************************************************
+//
+// License:  MIT
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description:
+//
+// Contains class declaration for ossimEquationProgram.
+//
+//*******************************************************************
+
+#ifndef ossimEquationProgram_HEADER
+#define ossimEquationProgram_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <vector>
+
+/**
+ * @class ossimEquationProgram
+ *
+ * An ossimEquationCombiner equation compiled once into a tree of nodes and
+ * evaluated per tile in fused loops over strips of pixels.  Input tiles are
+ * read in their native scalar type, and the only temporaries are a few strip
+ * sized registers, so no float64 copy of a tile is made per operator.
+ *
+ * Results match the ossimEquationCombiner interpreter, including its null
+ * handling: an operator leaves pixels that are null in its left operand
+ * null, keeps the left value where the right one is null, and an image that
+ * is empty for the tile takes the value of the image it is combined with.
+ *
+ * Only pixel wise equations compile: numbers, pi, in[i], band(in[i], n),
+ * the arithmetic, bitwise and boolean operators, min, max and the math
+ * functions.  compile() returns false for shift, blurr, conv, assign_band
+ * and clamp, which ossimEquationCombiner still interprets.
+ */
+class OSSIM_DLL ossimEquationProgram
+{
+public:
+   ossimEquationProgram();
+
+   /**
+    * @brief Compiles equation.
+    * @return true if the equation can be evaluated by this program.
+    */
+   bool compile(const ossimString& equation);
+
+   /** @return true if the last compile() succeeded. */
+   bool isCompiled() const;
+
+   /** @return The equation last passed to compile(). */
+   const ossimString& getEquation() const;
+
+   /** @return Sorted indexes of the inputs the equation reads. */
+   const std::vector<ossim_uint32>& getInputIndexes() const;
+
+   /**
+    * @brief Evaluates the equation into result.
+    *
+    * @param inputs Tiles indexed by input index.  Entries not in
+    * getInputIndexes() are not used.
+    * @param result OSSIM_FLOAT64 tile, blank on entry.  Pixels the equation
+    * gives no value for are left null.  Not validated.
+    * @return false if the tiles do not fit the program, e.g. a missing tile,
+    * a size differing from result or band counts the interpreter would mix
+    * in its own way.  The caller should interpret the equation instead.
+    */
+   bool evaluate(const std::vector< ossimRefPtr<ossimImageData> >& inputs,
+                 ossimImageData* result) const;
+
+private:
+   enum NodeType
+   {
+      CONSTANT_NODE = 0,
+      INPUT_NODE    = 1,
+      BAND_NODE     = 2,
+      UNARY_NODE    = 3,
+      BINARY_NODE   = 4
+   };
+
+   /** Expression tree node.  Operators are OSSIM_EQU_TOKEN_* ids. */
+   struct Node
+   {
+      NodeType     m_type;
+      int          m_op;
+      double       m_value;  // CONSTANT_NODE
+      ossim_uint32 m_input;  // INPUT_NODE, BAND_NODE
+      ossim_uint32 m_band;   // BAND_NODE
+      ossim_int32  m_left;   // Operand node indexes.
+      ossim_int32  m_right;
+   };
+
+   /** Per tile state of a node. */
+   struct NodeState
+   {
+      ossim_uint32 m_bands;
+      bool         m_empty;
+   };
+
+   /** One step of the evaluation of an output band. */
+   struct Instruction
+   {
+      int          m_code;
+      int          m_op;
+      double       m_value;
+      ossim_uint32 m_input;
+      ossim_uint32 m_band;
+   };
+
+   class Parser;
+
+   ossim_int32 addNode(const Node& node);
+
+   bool computeState(ossim_int32 nodeIndex,
+                     const std::vector< ossimRefPtr<ossimImageData> >& inputs,
+                     ossim_uint32 size,
+                     std::vector<NodeState>& states) const;
+
+   void emit(ossim_int32 nodeIndex,
+             ossim_uint32 band,
+             const std::vector<NodeState>& states,
+             std::vector<Instruction>& program,
+             ossim_uint32& depth,
+             ossim_uint32& maxDepth) const;
+
+   ossimString               m_equation;
+   bool                      m_compiled;
+   std::vector<Node>         m_nodes;
+   ossim_int32               m_root;
+   std::vector<ossim_uint32> m_inputIndexes;
+};
+
+#endif /* #ifndef ossimEquationProgram_HEADER */
@@ -94,6 +94,14 @@ public:
 
   ossim_float64 getBlurFactor()const;
 
+  /**
+   * Enables the two pass (horizontal then vertical) kernel used when the
+   * input to output mapping is an axis aligned scale.  Output is identical
+   * to the 2-D kernel either way.  Default is enabled; keyword "separable".
+   */
+  void setSeparableFlag(bool flag);
+  bool getSeparableFlag()const;
+
   const ossimDpt& getScaleFactor()const
   {
     return theScaleFactor;
@@ -127,6 +135,24 @@ private:
 			    const ossimDpt& deltaUl,
 			    const ossimDpt& deltaUr,
 			    const ossimDpt& outLength);
+
+  /**
+   * Separable version of resampleBilinearTile for an axis aligned scale.
+   * Pixels whose result could differ from the 2-D kernel in the output type
+   * are filtered with the 2-D kernel.
+   * @return false if the mapping is not an axis aligned scale or the filter
+   * is nearest neighbor; nothing is written then.
+   */
+  template <class T>
+  bool resampleSeparableTile(T dummy,
+                             const ossimRefPtr<ossimImageData>& input,
+                             ossimRefPtr<ossimImageData>& output,
+                             const ossimIrect& outputSubRect,
+                             const ossimDpt& inputUl,
+                             const ossimDpt& inputUr,
+                             const ossimDpt& deltaUl,
+                             const ossimDpt& deltaUr,
+                             const ossimDpt& outLength);
   
    void computeTable();
    ossimString getFilterTypeAsString(ossimFilterResamplerType type)const;
@@ -146,6 +172,7 @@ private:
    
    ossimIrect               theInputRect;
    ossim_float64            theBlurFactor;
+   bool                     theSeparableFlag;
 };
 
 #endif
@@ -56,15 +56,35 @@ public:
     */
    const double* getClosestWeights(const double& x, const double& y)const;
 
+   /**
+    * Inlined below.
+    *
+    * The 2-D weights are the products of these, so
+    * getClosestWeights(x, y)[iy*getWidth()+ix] ==
+    * getClosestYWeights(y)[iy]*getClosestXWeights(x)[ix].
+    *
+    * @return const double* to the getWidth() horizontal weights closest to x.
+    */
+   const double* getClosestXWeights(const double& x)const;
+
+   /**
+    * Inlined below.
+    *
+    * @return const double* to the getHeight() vertical weights closest to y.
+    */
+   const double* getClosestYWeights(const double& y)const;
+
 protected:
 
    /**
-    * Creates the weight array "theWeights".  Will delete if previously
-    * allocated.
+    * Creates the weight arrays "theWeights", "theXWeights" and "theYWeights".
+    * Will delete if previously allocated.
     */
    void allocateWeights();
 
    double*      theWeights;
+   double*      theXWeights;
+   double*      theYWeights;
    ossim_uint32 theWidth;
    ossim_uint32 theHeight;
    ossim_uint32 theWidthHeight;
@@ -94,4 +114,20 @@ inline const double* ossimFilterTable::getClosestWeights(const double& x,
                       kernelSamp)*theWidthHeight];
 }
 
+inline const double* ossimFilterTable::getClosestXWeights(const double& x)const
+{
+   double intPartDummy;
+   ossim_int32 kernelSamp =
+      (ossim_int32)(theFilterSteps*fabs(modf(x, &intPartDummy)));
+   return &theXWeights[kernelSamp*theWidth];
+}
+
+inline const double* ossimFilterTable::getClosestYWeights(const double& y)const
+{
+   double intPartDummy;
+   ossim_int32 kernelLine =
+      (ossim_int32)(theFilterSteps*fabs(modf(y, &intPartDummy)));
+   return &theYWeights[kernelLine*theHeight];
+}
+
 #endif /* End of "#ifndef ossimFilterTable_HEADER" */
@@ -13,8 +13,9 @@
 // $Id: ossimFixedTileCache.h 16276 2010-01-06 01:54:47Z gpotts $
 #ifndef ossimFixedTileCache_HEADER
 #define ossimFixedTileCache_HEADER
-#include <map>
 #include <list>
+#include <unordered_map>
+#include <atomic>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimReferenced.h>
 #include <ossim/base/ossimRefPtr.h>
@@ -27,7 +28,9 @@ public:
    ossimFixedTileCacheInfo(ossimRefPtr<ossimImageData>& tile,
                            ossim_int32 tileId=-1)
       :theTile(tile),
-      theTileId(tileId)
+      theTileId(tileId),
+      theLruPosition(),
+      theLastAccess(0)
       {
       }
    
@@ -58,59 +61,85 @@ public:
    
    ossimRefPtr<ossimImageData> theTile;
    ossim_int32 theTileId;
+
+   /** Position in the owning shard's LRU queue, valid only when LRU is enabled. */
+   std::list<ossim_int32>::iterator theLruPosition;
+
+   /** Access tick used to pick the globally oldest tile across shards. */
+   ossim_uint64 theLastAccess;
 };
 
+/**
+ * Fixed tile-grid cache. Tiles are distributed over NUMBER_OF_SHARDS independently locked shards
+ * (by tile id) so that concurrent readers of different tiles do not contend on a single mutex.
+ * Each shard keeps a hash map of tiles and an O(1) LRU queue. Eviction picks the least recently
+ * used tile over all shards by comparing the access tick at the head of each shard's queue.
+ */
 class ossimFixedTileCache : public ossimReferenced
 {
 public:
+   static const ossim_uint32 NUMBER_OF_SHARDS = 16;
+
+   /** Hit, miss and eviction counters. */
+   struct Statistics
+   {
+      Statistics() : theHits(0), theMisses(0), theEvictions(0) {}
+      ossim_uint64 theHits;
+      ossim_uint64 theMisses;
+      ossim_uint64 theEvictions;
+   };
+
    ossimFixedTileCache();
-   virtual void setRect(const ossimIrect& rect);
-   virtual void setRect(const ossimIrect& rect,
-                        const ossimIpt& tileSize);
+
+   /**
+    * Sets the tile boundary rect and flushes the cache.
+    * @return Bytes of the tiles flushed.
+    */
+   virtual ossim_uint32 setRect(const ossimIrect& rect);
+   virtual ossim_uint32 setRect(const ossimIrect& rect,
+                                const ossimIpt& tileSize);
    void keepTilesWithinRect(const ossimIrect& rect);
    virtual ossimRefPtr<ossimImageData> addTile(ossimRefPtr<ossimImageData> imageData,
                                                bool duplicateData=true);
    virtual ossimRefPtr<ossimImageData> getTile(ossim_int32 id);
-   virtual ossimRefPtr<ossimImageData> getTile(const ossimIpt& origin)
-      {
-         return getTile(computeId(origin));
-      }
-   virtual void setUseLruFlag(bool flag)
-      {
-         theUseLruFlag = flag;
-      }
+   virtual ossimRefPtr<ossimImageData> getTile(const ossimIpt& origin);
+   virtual void setUseLruFlag(bool flag);
    virtual bool getUseLruFlag()const
       {
          return theUseLruFlag;
       }
-   virtual void flush();
+
+   /**
+    * Removes all tiles.
+    * @return Bytes of the tiles removed, counted under the shard locks, so a tile added
+    * concurrently is either counted here or still in the cache.
+    */
+   virtual ossim_uint32 flush();
    virtual void deleteTile(const ossimIpt& origin)
       {
-         deleteTile(computeId(origin));
+         removeTile(origin);
       }
    virtual void deleteTile(ossim_int32 tileId);
-   virtual ossimRefPtr<ossimImageData> removeTile(const ossimIpt& origin)
-      {
-         return removeTile(computeId(origin));
-      }
+   virtual ossimRefPtr<ossimImageData> removeTile(const ossimIpt& origin);
    virtual ossimRefPtr<ossimImageData> removeTile(ossim_int32 tileId);
    virtual const ossimIrect& getTileBoundaryRect()const
       {
          return theTileBoundaryRect;
       }
-   virtual ossim_uint32 getNumberOfTiles()const
-      {
-         return (ossim_uint32)theTileMap.size();
-      }
+   virtual ossim_uint32 getNumberOfTiles()const;
    virtual const ossimIpt& getTileSize()const
       {
          return theTileSize;
       }
    virtual ossim_uint32 getCacheSize()const
       {
-         return theCacheSize;
+         return theCacheSize.load(std::memory_order_relaxed);
       }
+
+   /** Deletes the least recently used tile. Does nothing if the LRU flag is off. */
    virtual void deleteTile();
+
+   /** Removes and returns the least recently used tile, or NULL if the LRU flag is off. */
    virtual ossimRefPtr<ossimImageData> removeTile();
    
    virtual void setMaxCacheSize(ossim_uint32 cacheSize)
@@ -126,21 +155,68 @@ public:
    virtual ossimIpt getTileOrigin(ossim_int32 tileId);
    virtual ossim_int32 computeId(const ossimIpt& tileOrigin)const;
    virtual void setTileSize(const ossimIpt& tileSize);
+
+   /** Returns snapshot of hit, miss and eviction counters. */
+   Statistics getStatistics()const;
+   void resetStatistics();
+
 protected:
+   struct Shard
+   {
+      std::mutex theMutex;
+      std::unordered_map<ossim_int32, ossimFixedTileCacheInfo> theTileMap;
+      std::list<ossim_int32> theLruQueue; // front is least recently used
+   };
+
    virtual ~ossimFixedTileCache();
-   std::mutex theMutex;
+
+   Shard& getShard(ossim_int32 tileId)
+      {
+         return theShards[static_cast<ossim_uint32>(tileId) % NUMBER_OF_SHARDS];
+      }
+
+   /**
+    * Locks the shard of the tile at tileOrigin into lock. The tile grid only changes with all
+    * shards locked, so the returned id stays valid while the lock is held.
+    * @return Tile id, or -1 with nothing locked if tileOrigin is outside the grid.
+    */
+   ossim_int32 lockShard(const ossimIpt& tileOrigin, std::unique_lock<std::mutex>& lock);
+
+   /** Computes the tile id. At least one shard mutex must be held by caller. */
+   ossim_int32 computeIdLocked(const ossimIpt& tileOrigin)const;
+
+   /** Returns tile from the shard and updates its LRU position. Shard mutex must be held. */
+   ossimRefPtr<ossimImageData> getTileFromShard(Shard& shard, ossim_int32 tileId);
+
+   /** Removes tile from the shard. Shard mutex must be held by caller. */
+   ossimRefPtr<ossimImageData> removeTileFromShard(Shard& shard, ossim_int32 tileId);
+
+   /**
+    * Removes all tiles of the shard. Shard mutex must be held by caller.
+    * @return Bytes of the tiles removed.
+    */
+   ossim_uint32 flushShard(Shard& shard);
+
+   /** Locks shards in index order to exclude all other access during geometry changes. */
+   void lockAllShards();
+   void unlockAllShards();
+
    ossimIrect   theTileBoundaryRect;
    ossimIpt     theTileSize;
    ossimIpt     theBoundaryWidthHeight;
    ossim_uint32 theTilesHorizontal;
    ossim_uint32 theTilesVertical;
-   ossim_uint32 theCacheSize;
+   std::atomic<ossim_uint32> theCacheSize;
    ossim_uint32 theMaxCacheSize;
-   std::map<ossim_int32, ossimFixedTileCacheInfo> theTileMap;
-   std::list<ossim_int32> theLruQueue;
-   bool                   theUseLruFlag;
-   virtual void eraseFromLru(ossim_int32 id);
-   void adjustLru(ossim_int32 id);
+   Shard        theShards[NUMBER_OF_SHARDS];
+   bool         theUseLruFlag;
+   std::atomic<ossim_uint64> theAccessTick;
+   std::atomic<ossim_uint64> theHits;
+   std::atomic<ossim_uint64> theMisses;
+   std::atomic<ossim_uint64> theEvictions;
+
+   /** Moves the tile to the most recently used end of its shard's queue. */
+   void adjustLru(ossimFixedTileCacheInfo& info, Shard& shard);
 };
 
 #endif
@@ -146,6 +146,13 @@ public:
     */
    virtual ossimRefPtr<ossimImageData> getTile(const ossimIrect& tileRect,
                                                ossim_uint32 resLevel=0);
+
+   /**
+    * Passed to the head of the list, like getTile.
+    */
+   virtual void setTileRequestOrder(const ossimIrect& area,
+                                    const ossimIpt& tileSize,
+                                    ossim_uint32 resLevel=0);
    
    /**
     * this call is passed to the head of the list.
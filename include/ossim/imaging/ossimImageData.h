@@ -579,6 +579,18 @@ public:
     */
    virtual void initialize();
 
+   /**
+    * @brief Returns the tile to the state of a newly constructed one of the same
+    * scalar type, bands and size: default min/max/null, origin (0,0), no alpha
+    * or histogram and status OSSIM_NULL.  The data buffer is kept, so a
+    * following initialize() blanks it without reallocating.
+    *
+    * Used by ossimImageDataPool to hand out released tiles again.
+    *
+    * @param owner New owner of the tile.  This can be null.
+    */
+   virtual void recycle(ossimSource* owner);
+
    /**
     * @brief Writes tile to stream.
     *
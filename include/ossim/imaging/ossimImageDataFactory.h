@@ -16,14 +16,20 @@
 
 #include <ossim/imaging/ossimImageData.h>
 #include <ossim/base/ossimRefPtr.h>
-#include <mutex>
 class ossimSource;
 class ossimImageSource;
+class ossimImageDataPool;
 
 
 /*!
  * This factory should be called by all image source producers to allocate
  * an image tile.
+ *
+ * Tiles are drawn from an ossimImageDataPool, so a tile released by one
+ * getTile() call is handed back out by a later create() of the same scalar
+ * type, band count and size instead of being reallocated.  The pool size in
+ * megabytes comes from the "ossim.imaging.image_data_factory.pool_size"
+ * preference; 0 disables pooling.
  */
 class OSSIM_DLL ossimImageDataFactory
 {
@@ -50,14 +56,25 @@ public:
    virtual ossimRefPtr<ossimImageData> create(
       ossimSource* owner,
       ossimImageSource* inputSource)const;
+
+   /** @return The tile pool. Use it to read statistics or change the size. */
+   ossimImageDataPool* getPool()const;
    
 protected:
    ossimImageDataFactory(); // hide
-   ossimImageDataFactory(const ossimImageDataFactory&){}//hide
+   ossimImageDataFactory(const ossimImageDataFactory&):m_pool(0){}//hide
    void operator = (ossimImageDataFactory&){}// hide
+
+   /** Allocates a new tile of the class specialized for scalar. */
+   static ossimImageData* newImageData(ossimSource* owner,
+                                       ossimScalarType scalar,
+                                       ossim_uint32 bands,
+                                       ossim_uint32 width,
+                                       ossim_uint32 height);
    
    static ossimImageDataFactory* theInstance;
-   static std::mutex theInstanceMutex;
+
+   ossimImageDataPool* m_pool;
 };
 
 #endif
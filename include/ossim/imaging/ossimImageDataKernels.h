@@ -0,0 +1,130 @@
+//---
+//
+// License: MIT
+//
+// Description: Vectorized pixel kernels behind the ossimImageData load, scan
+// and normalize paths, with run time instruction set dispatch.
+//
+//---
+// $Id$
+
+#ifndef ossimImageDataKernels_HEADER
+#define ossimImageDataKernels_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+
+namespace ossim
+{
+   /** Instruction set levels the image data kernels are built for. */
+   enum SimdLevel
+   {
+      SIMD_NONE  = 0, //!< Portable scalar code.
+      SIMD_SSE42 = 1, //!< SSE4.2 (x86).
+      SIMD_AVX2  = 2  //!< AVX2 (x86).
+   };
+
+   /**
+    * Table of kernel entry points for one instruction set level.  A null entry in an
+    * instruction set specific table means that level has no specialized version and
+    * the next lower level is used.
+    *
+    * All counts are in pixels.  Kernels read and write unaligned memory.
+    *
+    * Deinterleave kernels split count band interleaved pixels of bands bands into
+    * the per band rows dst[0] ... dst[bands-1].  They move bits only, so they are
+    * keyed by element size.
+    *
+    * minMax kernels return false if every pixel equals exclude (or is NaN);
+    * otherwise they set the minimum and maximum of the remaining pixels.
+    *
+    * minAbove kernels return false if no pixel other than exclude is greater than
+    * threshold; otherwise they set the minimum of those pixels.
+    *
+    * normalize kernels write 0.0 for nullPix, OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT for
+    * minPix and (p-minPix)/(maxPix-minPix) otherwise, computed in double precision
+    * like the scalar ossimImageData templates.
+    *
+    * unnormalize kernels write nullPix for 0.0 and minPix+(maxPix-minPix)*p,
+    * clamped to maxPix and truncated, otherwise.
+    *
+    * Resampling kernels (used by the separable ossimFilterResampler path) sum in an
+    * unspecified order, so results may differ from a sequential sum in the last bits:
+    *    weightedSumF64:       dst[i] = sum over k < taps of weights[k]*rows[k][i].
+    *    gatherWeightedSumF64: dst[i] = sum over k < taps of
+    *                          weights[k*count+i]*src[start[i]+k].
+    */
+   struct ImageDataKernels
+   {
+      void (*deinterleave8)(const ossim_uint8* src, ossim_uint32 bands,
+                            ossim_uint32 count, ossim_uint8** dst);
+      void (*deinterleave16)(const ossim_uint16* src, ossim_uint32 bands,
+                             ossim_uint32 count, ossim_uint16** dst);
+      void (*deinterleave32)(const ossim_uint32* src, ossim_uint32 bands,
+                             ossim_uint32 count, ossim_uint32** dst);
+
+      bool (*minMaxU8)(const ossim_uint8* buf, ossim_uint32 count, ossim_uint8 exclude,
+                       ossim_uint8* minVal, ossim_uint8* maxVal);
+      bool (*minMaxU16)(const ossim_uint16* buf, ossim_uint32 count, ossim_uint16 exclude,
+                        ossim_uint16* minVal, ossim_uint16* maxVal);
+      bool (*minMaxS16)(const ossim_sint16* buf, ossim_uint32 count, ossim_sint16 exclude,
+                        ossim_sint16* minVal, ossim_sint16* maxVal);
+      bool (*minMaxF32)(const ossim_float32* buf, ossim_uint32 count, ossim_float32 exclude,
+                        ossim_float32* minVal, ossim_float32* maxVal);
+
+      bool (*minAboveU8)(const ossim_uint8* buf, ossim_uint32 count, ossim_uint8 exclude,
+                         ossim_uint8 threshold, ossim_uint8* minVal);
+      bool (*minAboveU16)(const ossim_uint16* buf, ossim_uint32 count, ossim_uint16 exclude,
+                          ossim_uint16 threshold, ossim_uint16* minVal);
+      bool (*minAboveS16)(const ossim_sint16* buf, ossim_uint32 count, ossim_sint16 exclude,
+                          ossim_sint16 threshold, ossim_sint16* minVal);
+      bool (*minAboveF32)(const ossim_float32* buf, ossim_uint32 count, ossim_float32 exclude,
+                          ossim_float32 threshold, ossim_float32* minVal);
+
+      void (*normalizeU8)(const ossim_uint8* src, ossim_uint32 count, ossim_float64 minPix,
+                          ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst);
+      void (*normalizeU16)(const ossim_uint16* src, ossim_uint32 count, ossim_float64 minPix,
+                           ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst);
+      void (*normalizeS16)(const ossim_sint16* src, ossim_uint32 count, ossim_float64 minPix,
+                           ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst);
+      void (*normalizeF32)(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                           ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst);
+
+      void (*unnormalizeU8)(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                            ossim_float64 maxPix, ossim_uint8 nullPix, ossim_uint8* dst);
+      void (*unnormalizeU16)(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                             ossim_float64 maxPix, ossim_uint16 nullPix, ossim_uint16* dst);
+      void (*unnormalizeS16)(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                             ossim_float64 maxPix, ossim_sint16 nullPix, ossim_sint16* dst);
+      void (*unnormalizeF32)(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                             ossim_float64 maxPix, ossim_float32 nullPix, ossim_float32* dst);
+
+      void (*weightedSumF64)(const ossim_float64* const* rows, const ossim_float64* weights,
+                             ossim_uint32 taps, ossim_uint32 count, ossim_float64* dst);
+      void (*gatherWeightedSumF64)(const ossim_float64* src, const ossim_int32* start,
+                                   const ossim_float64* weights, ossim_uint32 taps,
+                                   ossim_uint32 count, ossim_float64* dst);
+   };
+
+   /**
+    * @return The kernels for the active level.  The first call detects the CPU and
+    * activates the highest level that is both supported and compiled in.
+    */
+   OSSIM_DLL const ImageDataKernels& getImageDataKernels();
+
+   /** @return The active kernel level. */
+   OSSIM_DLL SimdLevel getSimdLevel();
+
+   /** @return The highest level this CPU and build support. */
+   OSSIM_DLL SimdLevel getSupportedSimdLevel();
+
+   /**
+    * Selects the kernel level, e.g. SIMD_NONE to compare against the scalar code.
+    * Levels above getSupportedSimdLevel() are clamped to it.
+    */
+   OSSIM_DLL void setSimdLevel(SimdLevel level);
+
+   /** @return "none", "sse4.2" or "avx2". */
+   OSSIM_DLL const char* getSimdLevelName(SimdLevel level);
+}
+
+#endif /* #ifndef ossimImageDataKernels_HEADER */
@@ -0,0 +1,160 @@
+//---
+//
+// License: MIT
+//
+// Description: Pool of recyclable ossimImageData tiles.
+//
+//---
+// $Id$
+
+#ifndef ossimImageDataPool_HEADER
+#define ossimImageDataPool_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <atomic>
+#include <iosfwd>
+#include <map>
+#include <mutex>
+#include <vector>
+
+class ossimSource;
+
+/**
+ * Keeps a reference to tiles handed out by ossimImageDataFactory and recycles
+ * them, band buffers included, once every other reference is gone.  Tiles are
+ * keyed by (scalar type, bands, width, height).
+ *
+ * A tile is idle when the pool holds the only reference.  checkout() returns an
+ * idle tile of the requested shape reset to the state of a newly constructed
+ * one (see ossimImageData::recycle), so callers cannot tell a recycled tile from
+ * a new one.
+ *
+ * Tiles are spread over NUMBER_OF_SHARDS independently locked shards by calling
+ * thread so concurrent chains do not contend on one mutex.  A miss in the
+ * calling thread's shard tries the other shards without blocking.
+ *
+ * The bytes of all pooled tiles are capped by getMaxBytes().  Adding a tile over
+ * the cap first drops idle tiles from the shard; if that is not enough the tile
+ * is not pooled and is freed normally when released.  A cap of 0 disables the
+ * pool.
+ */
+class OSSIM_DLL ossimImageDataPool
+{
+public:
+   static const ossim_uint32 NUMBER_OF_SHARDS = 16;
+
+   /** Request, hit, allocation and eviction counters. */
+   struct Statistics
+   {
+      Statistics()
+         : m_requests(0), m_hits(0), m_allocations(0), m_evictions(0), m_overflows(0),
+           m_tiles(0), m_bytes(0)
+      {}
+      ossim_uint64 m_requests;    //!< checkout() calls.
+      ossim_uint64 m_hits;        //!< Requests served with a recycled tile.
+      ossim_uint64 m_allocations; //!< New tiles added to the pool.
+      ossim_uint64 m_evictions;   //!< Idle tiles dropped to stay under the cap.
+      ossim_uint64 m_overflows;   //!< New tiles not pooled because of the cap.
+      ossim_uint64 m_tiles;       //!< Tiles currently pooled, idle or in use.
+      ossim_uint64 m_bytes;       //!< Buffer bytes of the pooled tiles.
+   };
+
+   /** @param maxBytes Cap on the buffer bytes of pooled tiles; 0 disables the pool. */
+   ossimImageDataPool(ossim_uint64 maxBytes);
+
+   ~ossimImageDataPool();
+
+   /**
+    * @return An idle tile of the given shape, reset and owned by owner, or a null
+    * pointer if there is none.
+    */
+   ossimRefPtr<ossimImageData> checkout(ossimSource* owner,
+                                        ossimScalarType scalar,
+                                        ossim_uint32 bands,
+                                        ossim_uint32 width,
+                                        ossim_uint32 height);
+
+   /**
+    * Starts pooling a newly created tile.
+    * @return true if the tile was pooled, false if the pool is disabled or full.
+    */
+   bool add(ossimImageData* tile);
+
+   /** Drops all idle tiles. Tiles in use are dropped when released. */
+   void clear();
+
+   /** Sets the cap; lowering it drops idle tiles over the new cap. */
+   void setMaxBytes(ossim_uint64 maxBytes);
+
+   ossim_uint64 getMaxBytes() const;
+
+   /** Returns snapshot of the counters. */
+   Statistics getStatistics() const;
+   void resetStatistics();
+
+   std::ostream& print(std::ostream& out) const;
+
+private:
+   struct Key
+   {
+      Key(ossimScalarType scalar, ossim_uint32 bands, ossim_uint32 width, ossim_uint32 height)
+         : m_scalar(scalar), m_bands(bands), m_width(width), m_height(height)
+      {}
+      bool operator<(const Key& rhs) const;
+
+      ossimScalarType m_scalar;
+      ossim_uint32    m_bands;
+      ossim_uint32    m_width;
+      ossim_uint32    m_height;
+   };
+
+   struct Entry
+   {
+      ossimRefPtr<ossimImageData> m_tile;
+      ossim_uint64                m_bytes; // Size when added, the tile may be resized later.
+   };
+
+   typedef std::map< Key, std::vector<Entry> > TileMap;
+
+   struct Shard
+   {
+      std::mutex m_mutex;
+      TileMap    m_tiles;
+   };
+
+   // Not copyable.
+   ossimImageDataPool(const ossimImageDataPool&);
+   const ossimImageDataPool& operator=(const ossimImageDataPool&);
+
+   /** @return The shard of the calling thread. */
+   Shard& getShard();
+
+   /**
+    * Returns an idle tile of key from shard; it stays pooled.  Idle tiles that were
+    * reshaped since they were added are dropped.  Shard mutex must be held.
+    */
+   ossimRefPtr<ossimImageData> takeIdleTile(Shard& shard, const Key& key);
+
+   /**
+    * Drops idle tiles from shard until bytes more fit under the cap, or all idle
+    * tiles if bytes is 0 and the cap is exceeded. Shard mutex must be held.
+    */
+   void evictIdleTiles(Shard& shard, ossim_uint64 bytes);
+
+   /** Drops the entry at index of list. Shard mutex must be held. */
+   void removeEntry(std::vector<Entry>& list, std::vector<Entry>::size_type index);
+
+   Shard                     m_shards[NUMBER_OF_SHARDS];
+   std::atomic<ossim_uint64> m_maxBytes;
+   std::atomic<ossim_uint64> m_bytes;
+   std::atomic<ossim_uint64> m_tileCount;
+   std::atomic<ossim_uint64> m_requests;
+   std::atomic<ossim_uint64> m_hits;
+   std::atomic<ossim_uint64> m_allocations;
+   std::atomic<ossim_uint64> m_evictions;
+   std::atomic<ossim_uint64> m_overflows;
+};
+
+#endif /* #ifndef ossimImageDataPool_HEADER */
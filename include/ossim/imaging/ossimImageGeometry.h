@@ -151,6 +151,15 @@ public:
    bool worldToLocal(const ossimGpt& world_pt, ossimDpt& local_pt) const;
    bool worldToLocal(const ossimGrect& world_rect, ossimDrect& local_rect) const;
 
+   //! Batch forms of localToWorld and worldToLocal for count points. The projection is called
+   //! once for all points through its batch methods, and heights needed by elevation sensitive
+   //! projections are looked up in one batch. Returns false, with NaN output points, if there
+   //! is no projection.
+   bool localToWorldPoints(const ossimDpt* local_pts, ossim_uint32 count,
+                           ossimGpt* world_pts) const;
+   bool worldToLocalPoints(const ossimGpt* world_pts, ossim_uint32 count,
+                           ossimDpt* local_pts) const;
+
    //! Sets the transform to be used for local-to-full-image coordinate transformation
    void setTransform(ossim2dTo2dTransform* transform);
 
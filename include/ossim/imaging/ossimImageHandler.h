@@ -416,6 +416,27 @@ public:
     */
    virtual bool isValidRLevel(ossim_uint32 resLevel) const;
 
+   /**
+    * @brief Passes the hint to the overview if it holds resLevel.
+    *
+    * Overrides ossimImageSource::setTileRequestOrder.  Handlers that read
+    * ahead should call this for levels they do not hold themselves.
+    */
+   virtual void setTileRequestOrder(const ossimIrect& area,
+                                    const ossimIpt& tileSize,
+                                    ossim_uint32 resLevel=0);
+
+   /**
+    * @brief Indicates getTile(ossimImageData*, resLevel) may be called from
+    * several threads at once on this handler.
+    *
+    * Only the getTile that fills the caller's tile is covered; the others
+    * return a tile owned by the handler.  Default returns false.
+    *
+    * @return true if concurrent reads are supported; else, false.
+    */
+   virtual bool supportsConcurrentReads() const;
+
    /**
     * Connection rule.  Since image handler currently don't have any
     * inputs this will just return false saying we can't connect anything
@@ -22,6 +22,7 @@
 #include <memory>
 #include <ossim/base/ItemCache.h>
 #include <ossim/support_data/ImageHandlerState.h>
+#include <ossim/support_data/ImageHandlerStateStore.h>
 
 class ossimImageHandler;
 class ossimFilename;
@@ -186,6 +187,9 @@ protected:
 
    mutable std::shared_ptr<ossim::ItemCache<ossim::ImageHandlerState> > m_stateCache;
 
+   /** On disk states shared by processes.  Null unless enabled. */
+   mutable std::shared_ptr<ossim::ImageHandlerStateStore> m_stateStore;
+
    //static ossimImageHandlerRegistry*            theInstance;
    
 TYPE_DATA
@@ -15,6 +15,8 @@
 #include <ossim/base/ossimObjectEvents.h>
 #include <ossim/base/ossimIrect.h>
 
+class ossimImageSourceSequencer;
+
 /*!
  * This source expects as input an ossimImageSource.
  * it will slice up the requested region into tiles and compute
@@ -65,6 +67,21 @@ public:
 
    ossimHistogramMode getComputationMode()const;
    void setComputationMode(ossimHistogramMode mode);
+
+   /**
+    * @brief Sets the number of threads the normal mode histogram is computed
+    * with.
+    *
+    * Each thread reads tiles of the res level and counts them in a histogram
+    * of its own.  These are added up once all tiles are read.  Tiles are read
+    * one at a time unless the input is an image handler that supports
+    * concurrent reads.
+    *
+    * Defaults to the preference "ossim.imaging.histogram.threads", or 1 if
+    * it is not set.
+    */
+   void setNumberOfThreads(ossim_uint32 threads);
+   ossim_uint32 getNumberOfThreads()const;
 	
    virtual void propertyEvent(ossimPropertyEvent& event);
    
@@ -84,6 +101,21 @@ protected:
                           ossim_uint32 band)const;
    virtual void computeNormalModeHistogram();
    virtual void computeFastModeHistogram();
+
+   /**
+    * @brief Counts the tiles of sequencer at resLevel into histo on
+    * theNumberOfThreads threads.  Called by computeNormalModeHistogram.
+    * @param tileCount Tiles done so far, for the percent complete.  Incremented
+    * by the tiles of this res level.
+    * @param totalTiles Tiles of all res levels.
+    * @return false if the counts of the threads could not be added to histo,
+    * leaving histo partly counted; true otherwise.
+    */
+   bool populateConcurrent(const ossimImageSourceSequencer* sequencer,
+                           ossim_uint32 resLevel,
+                           ossimMultiBandHistogram* histo,
+                           double& tileCount,
+                           double totalTiles);
    
    /*!
     * Initialized to ossimNAN'S
@@ -100,6 +132,7 @@ protected:
    ossim_float64      theMaxValueOverride;
    ossim_int32        theNumberOfBinsOverride;
    ossimHistogramMode theComputationMode;
+   ossim_uint32       theNumberOfThreads;
    // ossim_uint32       theNumberOfTilesToUseInFastMode;
 TYPE_DATA
 };
@@ -14,14 +14,19 @@
 #define ossimImageRenderer_HEADER
 #include <ossim/imaging/ossimImageSourceFilter.h>
 #include <ossim/projection/ossimImageViewTransform.h>
+#include <ossim/projection/ossimImageViewGridTransform.h>
 #include <ossim/base/ossimDrect.h>
 #include <ossim/base/ossimPolyArea2d.h>
 #include <ossim/base/ossimViewInterface.h>
 #include <ossim/base/ossimRationalNumber.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 class ossimImageData;
 class ossimDiscreteConvolutionKernel;
 class ossimFilterResampler;
+class ossimJobMultiThreadQueue;
 
 class OSSIMDLLEXPORT ossimImageRenderer : public ossimImageSourceFilter,
                                           public ossimViewInterface
@@ -150,7 +155,54 @@ public:
     */
    virtual void setEnableFlag(bool flag);
 
-   
+   /**
+    * @brief Enables the warp grid.
+    *
+    * When enabled, and the image view transform is a projection transform,
+    * tiles find their image space corners through an
+    * ossimImageViewGridTransform instead of projecting every point.  The
+    * grid is kept between getTile calls and is only cleared when the image
+    * view transform or the view changes.  Defaults to the
+    * ossim.imaging.image_renderer.warp_grid preference (false if not set).
+    * Keywords: warp_grid, warp_grid_spacing (view pixels) and
+    * warp_grid_error (image pixels).
+    */
+   void setWarpGridEnabled(bool flag);
+   bool getWarpGridEnabled() const { return m_warpGridEnabled; }
+
+   /**
+    * @brief Builds the warp grid over viewRect ahead of getTile calls.
+    *
+    * Does nothing if the warp grid is not in use.  See
+    * ossimImageViewGridTransform::buildGrid for the thread requirements.
+    */
+   void buildWarpGrid(const ossimIrect& viewRect, ossim_uint32 numberOfThreads=1);
+
+   /**
+    * @brief Sets the number of threads used within a single getTile call.
+    *
+    * With more than one thread the sub rectangles of a tile are decimated
+    * (for levels the input does not have) and resampled on a job queue
+    * owned by this renderer.  Input tiles are still requested in order on
+    * the calling thread since input chains are not thread safe; each is
+    * copied so the next request can go out while earlier pieces are being
+    * resampled.  The output is the same as with one thread.
+    * Keyword and property: threads.  default = 1
+    *
+    * @param threads Number of threads.
+    */
+   void setNumberOfThreads(ossim_uint32 threads);
+   ossim_uint32 getNumberOfThreads() const { return m_numberOfThreads; }
+
+   /**
+    * @brief Caps the input requests fetched but not yet resampled when
+    * running with more than one thread, which bounds the memory one getTile
+    * call holds.  0 means two per thread.
+    * Keyword and property: max_pending_inputs.  default = 0
+    */
+   void setMaxPendingInputs(ossim_uint32 maxPending);
+   ossim_uint32 getMaxPendingInputs() const { return m_maxPendingInputs; }
+
 protected:
 private:
    
@@ -265,13 +317,67 @@ private:
       void splitAll(std::vector<ossimRendererSubRectInfo>& result)const;
    };
 
+   /**
+    * Everything fillTile works out for a sub rectangle before it requests
+    * input, so the request and the resample can run on different threads.
+    */
+   class ossimRendererFillInfo
+   {
+   public:
+      ossimDrect   m_viewRect;
+      ossimDpt     m_imageToViewScale;
+      ossim_uint32 m_resLevel;
+      double       m_closestScale;
+      ossimDrect   m_requestRect; //!< Input rect at m_resLevel, kernel included.
+      ossimDpt     m_ul;
+      ossimDpt     m_ur;
+      ossimDpt     m_lr;
+      ossimDpt     m_ll;
+   };
+
+   class ResampleJob;
+
    void recursiveResample(ossimRefPtr<ossimImageData> outputData,
                           const ossimRendererSubRectInfo& rectInfo,
 			  ossim_uint32 level);
    
+   //! Splits rectInfo into the sub rectangles to fill, in fill order.
+   void getFillRects(const ossimRendererSubRectInfo& rectInfo,
+                     std::vector<ossimRendererSubRectInfo>& result) const;
 
    void fillTile(ossimRefPtr<ossimImageData> outputData,
                  const ossimRendererSubRectInfo& rectInfo);
+
+   //! @return false if there is nothing to fill for rectInfo.
+   bool prepareFill(const ossimRendererSubRectInfo& rectInfo,
+                    ossimRendererFillInfo& info) const;
+
+   //! @return true if input from info's request rect gets resampled at all.
+   bool isResampled(const ossimRendererFillInfo& info) const;
+
+   //! Resamples input into outputData.  Safe to call from several threads.
+   void resampleFill(ossimFilterResampler* resampler,
+                     const ossimRendererFillInfo& info,
+                     const ossimRefPtr<ossimImageData>& input,
+                     ossimRefPtr<ossimImageData>& outputData) const;
+
+   //! fillTile over rects on the job queue.  See setNumberOfThreads.
+   void threadedResample(ossimRefPtr<ossimImageData> outputData,
+                         const std::vector<ossimRendererSubRectInfo>& rects);
+
+   /**
+    * @brief Requests the input for info the way getTileAtResLevel does and
+    * hands copies of it to job.
+    * @return false if there is no input to resample.
+    */
+   bool fetchFillInput(const ossimRendererFillInfo& info, ResampleJob& job);
+
+   //! A resampler configured like m_Resampler, for one job at a time.
+   ossimFilterResampler* acquireResampler();
+   void releaseResampler(ossimFilterResampler* resampler);
+
+   //! Drops pooled resamplers if m_Resampler's filter settings changed.
+   void updateResamplerPool();
                  
    ossimIrect getBoundingImageRect()const;
 
@@ -285,8 +391,35 @@ private:
     */
    void initializeBoundingRects();
 
+   /**
+    * @brief Points m_warpGrid at m_ImageViewTransform, or drops it if the
+    * grid is disabled or not useful for the transform.  Clears the grid.
+    */
+   void updateWarpGrid();
+
+   //! @return The transform tiles are rendered through.
+   ossimImageViewTransform* getRenderTransform();
+
    ossimRefPtr<ossimImageData> getTileAtResLevel(const ossimIrect& boundingRect,
                                      ossim_uint32 resLevel);
+
+   /**
+    * @brief For resLevels beyond the input's, gets the rect to fill at
+    * resLevel (mappedRect), the rect to read at the last input level
+    * (validRect), the size of each read and the decimation multiplier.
+    */
+   void getDecimationRects(const ossimIrect& boundingRect,
+                           ossim_uint32 resLevel,
+                           ossim_uint32 levels,
+                           ossimIrect& mappedRect,
+                           ossimIrect& validRect,
+                           ossimIpt& tileSize,
+                           ossim_int32& multiplier) const;
+
+   //! resampleTileToDecimation for the scalar type of tile.
+   void decimateTile(ossimRefPtr<ossimImageData> result,
+                     ossimRefPtr<ossimImageData> tile,
+                     ossim_uint32 multiplier);
   template <class T>
   void resampleTileToDecimation(T dummyVariable,
 				ossimRefPtr<ossimImageData> result,
@@ -338,6 +471,18 @@ private:
 
    ossimPolyArea2d          m_viewArea;
    bool                     m_crossesDateline;
+
+   bool                     m_warpGridEnabled;
+   ossim_uint32             m_warpGridSpacing;
+   ossim_float64            m_warpGridError;
+   ossimRefPtr<ossimImageViewGridTransform> m_warpGrid;
+
+   ossim_uint32                              m_numberOfThreads;
+   ossim_uint32                              m_maxPendingInputs;
+   std::shared_ptr<ossimJobMultiThreadQueue> m_jobQueue;
+   std::vector<ossimFilterResampler*>        m_resamplerPool;
+   ossimString                               m_resamplerPoolConfig;
+   std::mutex                                m_resamplerPoolMutex;
    
 TYPE_DATA
 };
@@ -232,6 +232,20 @@ public:
     * This should be replaced by a getPhotoInterpretation().
     */
    virtual bool isIndexedData() const;
+
+   /**
+    * @brief Tells this source the order tiles are about to be requested in:
+    * tiles of tileSize, left to right and top to bottom across area, at
+    * resLevel.  Sources that can read ahead may use this; it is only a hint
+    * and requests in any other order still work.  An area with nans ends the
+    * hint.
+    *
+    * The default ignores it.  Sources whose tiles map one to one onto their
+    * input's pass it on.
+    */
+   virtual void setTileRequestOrder(const ossimIrect& area,
+                                    const ossimIpt& tileSize,
+                                    ossim_uint32 resLevel=0);
    
 protected:
 
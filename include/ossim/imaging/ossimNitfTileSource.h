@@ -23,8 +23,11 @@
 #include <ossim/support_data/ossimNitfFileHeader.h>
 #include <ossim/support_data/ossimNitfImageHeader.h>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 struct jpeg_decompress_struct;
+class ossimJobMultiThreadQueue;
 
 class OSSIM_DLL ossimNitfTileSource : public ossimImageHandler
 {
@@ -212,6 +215,19 @@ public:
     */
    void setCacheEnabledFlag(bool flag);
 
+   /**
+    * @brief Sets the number of threads that read and decode the blocks of a
+    * tile spanning several blocks.
+    *
+    * Each thread reads with a stream of its own.  One, the default unless set
+    * by the preference "ossim.imaging.nitf.decode_threads", reads blocks one
+    * at a time on the calling thread.
+    */
+   void setNumberOfDecodeThreads(ossim_uint32 threads);
+
+   /** @return The number of block decode threads. */
+   ossim_uint32 getNumberOfDecodeThreads() const;
+
    virtual double getMinPixelValue(ossim_uint32 band=0)const;
    virtual double getMaxPixelValue(ossim_uint32 band=0)const;
    virtual double getNullPixelValue(ossim_uint32 band=0)const;
@@ -403,6 +419,53 @@ protected:
     */
    virtual bool loadBlock(ossim_uint32 x, ossim_uint32 y);
 
+   /**
+    * @brief Reads and decodes a block into block.  Does not touch the cache.
+    *
+    * @param x Starting x position of block to load.
+    * @param y Starting y position of block to load.
+    * @param block Tile the size of theCacheTile.  Its origin is set to x, y.
+    * @param in Stream to read from.
+    * @param compressedBuf Buffer the size of theCompressedBuf.
+    * @param readError Set to true if a read of in failed.
+    *
+    * @return true on success, false on error.
+    *
+    * @note Called from the decode threads, so only reads the state of this
+    * object unless block is theCacheTile.
+    */
+   bool readBlock(ossim_uint32 x, ossim_uint32 y,
+                  ossimImageData* block,
+                  ossim::istream& in,
+                  std::vector<ossim_uint8>& compressedBuf,
+                  bool& readError);
+
+   /**
+    * @brief Whether loadTile may read and decode blocks on the decode threads.
+    *
+    * The decode threads call readBlock, not loadBlock or uncompressJpegBlock,
+    * so a derived class overriding either would be bypassed.  Returns true
+    * only for this class; a derived class that keeps the block decoding of
+    * this class can override this to return true.
+    */
+   virtual bool canDecodeConcurrently() const;
+
+   /**
+    * @brief Reads and decodes the blocks at origins on the decode threads and
+    * loads them into theTile and the cache.
+    * @return true on success, false on error.
+    */
+   bool loadBlocksConcurrent(const std::vector<ossimIpt>& origins,
+                             const ossimIrect& clipRect);
+
+   /** @return A stream from the pool, opening one if none is free. */
+   std::shared_ptr<ossim::istream> acquireReadStream();
+
+   void releaseReadStream(std::shared_ptr<ossim::istream> str);
+
+   /** @brief Stops the decode threads and closes the pooled streams. */
+   void closeDecodeThreads();
+
    /**
     * @param x Horizontal upper left pixel position of the requested block.
     *
@@ -467,6 +530,11 @@ protected:
    /**
     * @brief scans the file storing in offsets in "theNitfBlockOffset" and
     * block sizes in "theNitfBlockSize".
+    *
+    * M3 offsets are taken from the block mask.  C3 offsets are read from the
+    * "jbi" index file next to the image if it is current, else scanned for
+    * on several threads, see ossimNitfJpegBlockIndex.
+    * 
     * @return true on success, false on error.  This checks for arrays being
     * the same size as number of blocks.
     */
@@ -482,6 +550,20 @@ protected:
     */
    virtual bool uncompressJpegBlock(ossim_uint32 x, ossim_uint32 y);
 
+   /**
+    * @brief Scans for the jpeg block offsets if not done yet.
+    * @return true if the offsets are available.
+    */
+   bool loadJpegBlockOffsets();
+
+   /**
+    * @brief Decodes jpeg block blockNumber read from in into block.
+    * @return true on success, false on error.
+    */
+   bool decodeJpegBlock(ossim_uint32 blockNumber,
+                        ossimImageData* block,
+                        ossim::istream& in) const;
+
    /**
     * @brief Loads one of the default tables based on COMRAT value.
     *
@@ -546,6 +628,13 @@ protected:
    // prior to grabbing a block.
    //---
    bool m_jpegOffsetsDirty;
+
+   class DecodeJob;
+
+   ossim_uint32                                  m_decodeThreads;
+   std::shared_ptr<ossimJobMultiThreadQueue>     m_decodeQueue;
+   std::vector<std::shared_ptr<ossim::istream> > m_readStreams;
+   std::mutex                                    m_readStreamMutex;
    
 TYPE_DATA
 };
@@ -19,10 +19,13 @@
 #include <ossim/imaging/ossimFilterResampler.h>
 #include <ossim/imaging/ossimBitMaskWriter.h>
 #include <ossim/imaging/ossimMaskFilter.h>
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
 class ossimFilename;
+class ossimJobMultiThreadQueue;
 
 /**
  * @class Sequencer for building overview files.
@@ -170,6 +173,39 @@ public:
    void setResampleType(
       ossimFilterResampler::ossimFilterResamplerType resampleType);
 
+   /**
+    * @brief Sets the number of threads used to resample tiles.
+    *
+    * With more than one thread getNextTile reads ahead and resamples up to
+    * two tiles per thread concurrently.  Input tiles are still read, scanned
+    * and added to the histogram in order on the calling thread.  Each call
+    * then returns a distinct tile so callers may hold on to it.
+    * default = 1
+    *
+    * @param threads Number of threads.
+    */
+   void setNumberOfThreads(ossim_uint32 threads);
+
+   /** @return The number of threads used to resample tiles. */
+   ossim_uint32 getNumberOfThreads() const;
+
+   /**
+    * @brief Decimates inputTile into outputTile.
+    *
+    * The decimated pixels are written starting at outputOffset, clipped to
+    * outputTile, so an output tile can be built from four input tiles of its
+    * own size.  Only the resample type and decimation factor of this object
+    * are used; it does not need to be initialized.  May be called from
+    * several threads for disjoint regions of the same output tile.
+    *
+    * @param inputTile Tile to decimate.
+    * @param outputTile Tile to write to.
+    * @param outputOffset Sample and line in outputTile of the first pixel.
+    */
+   void resampleTile(const ossimImageData* inputTile,
+                     ossimImageData* outputTile,
+                     const ossimIpt& outputOffset) const;
+
    /**
     * @brief Turn on/off scan for min max flag.
     * This method assumes the null is known.
@@ -225,6 +261,26 @@ protected:
     */
    void getOutputTileRectangle(ossimIrect& outputRect) const;
 
+   /** @brief Gets the image rectangle for the input tile for tileNumber. */
+   void getInputTileRectangle(ossim_uint32 tileNumber, ossimIrect& inputRect) const;
+
+   /** @brief Gets the image rectangle for the output tile for tileNumber. */
+   void getOutputTileRectangle(ossim_uint32 tileNumber, ossimIrect& outputRect) const;
+
+   /**
+    * @brief Reads the input tile for tileNumber and runs the min, max, null
+    * scans and histogram on it.
+    * @return The input tile, which may be reused by the source on the next
+    * read, or a null pointer if the read failed.
+    */
+   ossimRefPtr<ossimImageData> readInputTile(ossim_uint32 tileNumber);
+
+   /** @brief getNextTile for more than one thread. */
+   ossimRefPtr<ossimImageData> getNextTileThreaded();
+
+   /** @brief Waits for and drops resample jobs still queued or running. */
+   void clearPendingTiles();
+
    /**
     * @brief Updates theNumberOfTilesHorizontal and theNumberOfTilesVertical.
     *
@@ -232,13 +288,10 @@ protected:
     */
    void updateTileDimensions();
 
-   /**
-    *  Resamples a patch of data.
-    */
-   void resampleTile(const ossimImageData* inputTile);
-
    template <class T> void resampleTile(const ossimImageData* inputTile,
-                                        T dummy);
+                                        ossimImageData* outputTile,
+                                        const ossimIpt& outputOffset,
+                                        T dummy) const;
 
    /** @brief Clears out the arrays from a scan for min, max, nulls. */
    void clearMinMaxNullArrays();
@@ -284,6 +337,19 @@ protected:
    std::vector<ossim_float64> m_minValues; 
    std::vector<ossim_float64> m_maxValues; 
    std::vector<ossim_float64> m_nulValues;
+
+   /** Resamples one tile on a worker thread. */
+   class ResampleJob;
+
+   ossim_uint32 m_numberOfThreads;
+
+   /** Next tile to read when reading ahead. */
+   ossim_uint32 m_readAheadTileNumber;
+
+   std::shared_ptr<ossimJobMultiThreadQueue> m_jobQueue;
+
+   /** Queued or running resample jobs in tile order. */
+   std::deque< std::shared_ptr<ResampleJob> > m_pendingJobs;
 };
 
 #endif /* #ifndef ossimOverviewSequencer_HEADER */
@@ -38,6 +38,9 @@ public:
                           const char* prefix=0);
    
 protected:
+   /** Blocks are decoded by ossimNitfTileSource, so this can use its decode threads. */
+   virtual bool canDecodeConcurrently() const;
+
    ossimRefPtr<ossim2dTo2dTransform> m_transform;
 TYPE_DATA   
 };
@@ -0,0 +1,132 @@
+//******************************************************************
+//
+// License:  MIT
+// 
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Tile cache shared by processes through a shared memory
+// mapping.
+//
+//*******************************************************************
+#ifndef ossimSharedTileCache_HEADER
+#define ossimSharedTileCache_HEADER 1
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <iosfwd>
+#include <mutex>
+
+class ossimImageData;
+
+/**
+ * Fixed size tile cache in a shared memory mapping so several processes see
+ * the same tiles.
+ *
+ * The mapping is either anonymous, in which case processes forked after
+ * open() share it, or backed by a file that unrelated processes open with
+ * the same name and size.  It is split into equal slots.  A tile is looked
+ * for in a short run of slots starting at its key's hash.  A slot is
+ * replaced with a second chance (clock) pass over that run.
+ *
+ * Each slot has a sequence number that is odd while a writer fills it.
+ * Readers copy the tile and check the sequence again, so no locks are
+ * taken and a tile torn by a concurrent write is treated as a miss.
+ *
+ * Tiles are keyed by a source id, the caller's hash of what produced them,
+ * plus resolution level and tile rectangle.  Scalar type, band count and
+ * size must also match.  ossimCacheTileSource uses this as a second level
+ * under the per-process ossimAppFixedTileCache once the cache is open.
+ *
+ * Not available on Windows; open() returns false.
+ */
+class OSSIM_DLL ossimSharedTileCache
+{
+public:
+   static ossimSharedTileCache* instance();
+
+   ~ossimSharedTileCache();
+
+   /**
+    * @brief Maps the cache.
+    * @param sizeInBytes Total size of the mapping.
+    * @param slotSizeInBytes Largest tile that can be cached.
+    * @param file Backing file shared by unrelated processes.  Empty for an
+    * anonymous mapping shared with children forked afterward.
+    * @return true on success.
+    */
+   bool open(ossim_uint64 sizeInBytes,
+             ossim_uint32 slotSizeInBytes,
+             const ossimFilename& file = ossimFilename::NIL);
+
+   /**
+    * @brief Opens with the "ossim.imaging.shared_tile_cache.*" preferences
+    * if size is set there.
+    * @return true if open.
+    */
+   bool openFromPreferences();
+
+   /** @brief Unmaps the cache.  Tiles stay in a backing file. */
+   void close();
+
+   bool isOpen() const;
+
+   /**
+    * @brief Fills tile from the cache.  tile must be initialized with its
+    * image rectangle, scalar type and band count set.
+    * @return true on a hit.
+    */
+   bool getTile(ossim_uint64 sourceId, ossim_uint32 resLevel, ossimImageData* tile);
+
+   /**
+    * @brief Copies tile into the cache unless it is too big or already
+    * cached.
+    * @return true if added.
+    */
+   bool addTile(ossim_uint64 sourceId, ossim_uint32 resLevel, const ossimImageData* tile);
+
+   /** @brief Marks every slot empty. */
+   void flush();
+
+   /** @brief Statistics of all processes sharing the cache. */
+   ossim_uint64 getNumberOfHits() const;
+   ossim_uint64 getNumberOfMisses() const;
+   ossim_uint64 getNumberOfInserts() const;
+   ossim_uint64 getNumberOfEvictions() const;
+   ossim_uint32 getNumberOfSlots() const;
+
+   std::ostream& print(std::ostream& out) const;
+
+private:
+   struct Header;
+   struct Slot;
+
+   ossimSharedTileCache();
+   ossimSharedTileCache(const ossimSharedTileCache&);
+   const ossimSharedTileCache& operator=(const ossimSharedTileCache&);
+
+   /** @return Slot i. */
+   Slot* getSlot(ossim_uint32 i) const;
+
+   /**
+    * @brief Writes the header and empty slots into a zeroed map.  Called
+    * before a backing file is unlocked so no other process sees it half
+    * built.
+    */
+   static void format(ossim_uint8* map,
+                      ossim_uint64 slotCount,
+                      ossim_uint64 slotSize,
+                      ossim_uint64 stride);
+
+   /** @return Hash of the key, used to pick the first slot looked at. */
+   static ossim_uint64 hashKey(ossim_uint64 sourceId,
+                               ossim_uint32 resLevel,
+                               ossim_int32 x,
+                               ossim_int32 y);
+
+   mutable std::mutex m_mutex; // open and close only
+   ossim_uint8*       m_map;
+   ossim_uint64       m_mapSize;
+   Header*            m_header;
+   ossim_uint64       m_slotStride;
+};
+
+#endif /* #ifndef ossimSharedTileCache_HEADER */
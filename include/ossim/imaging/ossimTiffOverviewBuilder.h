@@ -16,19 +16,25 @@
 #ifndef ossimTiffOverviewBuilder_HEADER
 #define ossimTiffOverviewBuilder_HEADER
 
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include <ossim/base/ossimConstants.h>
 #include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimIrect.h>
 
 #include <ossim/imaging/ossimOverviewBuilderBase.h>
 #include <ossim/imaging/ossimFilterResampler.h>
+#include <ossim/imaging/ossimImageData.h>
 
 #include <tiffio.h>
 
 class ossimConnectableObject;
 class ossimFilename;
 class ossimImageGeometry;
+class ossimJobMultiThreadQueue;
+class ossimOverviewSequencer;
 
 class OSSIM_DLL ossimTiffOverviewBuilder
    :
@@ -51,6 +57,21 @@ public:
     * Supports BOX or NEAREST NEIGHBOR.  When indexed you should probably use nearest neighbor
     */ 
    void setResampleType(ossimFilterResampler::ossimFilterResamplerType resampleType);
+
+   /**
+    * @brief Sets the number of threads used to resample and compress tiles.
+    *
+    * Tiles are read and written in order on the calling thread.  Resampling,
+    * deflate compression and decimation into the next level run on the
+    * worker threads.  Forced to 1 when running under mpi.
+    * default = ossim::getNumberOfThreads()
+    *
+    * @param threads Number of threads.
+    */
+   void setNumberOfThreads(ossim_uint32 threads);
+
+   /** @return The number of threads used to resample and compress tiles. */
+   ossim_uint32 getNumberOfThreads() const;
    
    /**
     *  Builds overview file and sets "theOutputFile" to that of
@@ -235,6 +256,55 @@ private:
                 TIFF* tif,
                 ossim_uint32 resLevel,
                 bool firstResLevel);
+
+   /**
+    *  Write reduced resolution data set from the tiles decimated into memory
+    *  while the previous level was written.
+    */
+   bool writeRnFromMemory(TIFF* tif, ossim_uint32 resLevel);
+
+   /**
+    * @brief Decimates the tiles of the level being written into memory as
+    * the next level if it fits in the level memory budget, so the next level
+    * does not have to be read back from the file.
+    *
+    * @param levelRect The zero based rectangle of the level being written.
+    * @param resLevel The level being written.
+    */
+   void initializeNextLevel(const ossimIrect& levelRect, ossim_uint32 resLevel);
+
+   /**
+    * @brief Hands a tile of the level being written to the worker threads and
+    * writes the tiles that are finished.
+    *
+    * @param tif Pointer to the tif file.
+    * @param tile The tile, not reused by the caller.  A null tile writes the
+    * null data buffer.
+    * @param row Tile row.
+    * @param col Tile column.
+    * @return true on success, false on error.
+    */
+   bool queueTile(TIFF* tif, ossimImageData* tile, ossim_uint32 row, ossim_uint32 col);
+
+   /**
+    * @brief Writes finished tiles in order until no more than maxPending are
+    * left, waiting on the worker threads as needed.
+    * @return true on success, false on error.
+    */
+   bool writeQueuedTiles(TIFF* tif, ossim_uint32 maxPending);
+
+   /**
+    * @brief Writes all queued tiles and makes the decimated next level, if
+    * any, the level to write next.
+    * @return true on success, false on error.
+    */
+   bool finishLevel(TIFF* tif);
+
+   /** @brief Drops queued tiles and in memory levels, e.g. on error. */
+   void clearQueuedTiles();
+
+   /** @return Copy of tile from the tile pool for tiles the source reuses. */
+   ossimRefPtr<ossimImageData> copyTile(const ossimImageData* tile) const;
    
    /**
     *  Set the tiff tags for the appropriate resLevel.  Level zero is the
@@ -277,6 +347,9 @@ private:
     */
    bool copyR0() const;
 
+   /** Decimates and compresses one tile on a worker thread. */
+   class TileJob;
+
    // Disallow these...
    ossimTiffOverviewBuilder(const ossimTiffOverviewBuilder& source);
    ossimTiffOverviewBuilder& operator=(const ossimTiffOverviewBuilder& rhs); 
@@ -297,6 +370,28 @@ private:
    ossimString                                        m_tempExtension;
    bool                                               m_outputTileSizeSetFlag;
    bool                                               m_internalOverviewsFlag;
+   ossim_uint32                                       m_numberOfThreads;
+
+   /** Largest level in bytes decimated into memory; 0 disables. */
+   ossim_uint64                                       m_levelMemoryBudget;
+
+   /** Tiles of the level to write next when it is in memory, row major. */
+   std::vector< ossimRefPtr<ossimImageData> >         m_levelTiles;
+   ossimIrect                                         m_levelRect;
+
+   /** Tiles of the level decimated from the level being written. */
+   std::vector< ossimRefPtr<ossimImageData> >         m_nextLevelTiles;
+   ossimIrect                                         m_nextLevelRect;
+   ossim_uint32                                       m_nextLevelTilesWide;
+
+   /** Only used for its resampleTile method. */
+   ossimRefPtr<ossimOverviewSequencer>                m_levelResampler;
+
+   /** true if the worker threads deflate tiles for TIFFWriteRawTile. */
+   bool                                               m_deflateTiles;
+
+   std::deque< std::shared_ptr<TileJob> >             m_queuedTiles;
+   std::shared_ptr<ossimJobMultiThreadQueue>          m_jobQueue;
 
 TYPE_DATA   
 };
@@ -0,0 +1,137 @@
+//*******************************************************************
+//
+// License:  MIT
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description:
+//
+// Contains class declaration for ossimTiffTilePrefetcher.
+//
+//*******************************************************************
+
+#ifndef ossimTiffTilePrefetcher_HEADER
+#define ossimTiffTilePrefetcher_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <condition_variable>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+typedef struct tiff TIFF;
+
+class ossimJobMultiThreadQueue;
+
+namespace ossim
+{
+   class TiffIStreamAdaptor;
+}
+
+/**
+ * @class ossimTiffTilePrefetcher
+ *
+ * Reads and decodes tiles of a tiled tiff on a background thread ahead of
+ * the tiff reader that asks for them.  It opens a libtiff handle of its own
+ * on the image, so the reader's handle is never touched off its thread.
+ *
+ * The reader calls request() for tiles in the order it expects to need them
+ * and take() when it needs one.  Tiles stay in the buffer until release()
+ * is called with a request index past the last one that needs them, so the
+ * buffer is bounded by what the reader requests.
+ */
+class OSSIM_DLL ossimTiffTilePrefetcher
+{
+public:
+   ossimTiffTilePrefetcher();
+
+   /** Waits for the read in progress, if any, and closes the handle. */
+   ~ossimTiffTilePrefetcher();
+
+   /**
+    * @brief Opens a handle of its own on the image.
+    * @param connectionString File or stream to open.
+    * @return true on success.
+    */
+   bool open(const std::string& connectionString);
+
+   /** @brief Drops all tiles and closes the handle. */
+   void close();
+
+   bool isOpen() const;
+
+   /**
+    * @brief Queues a read of tile in directory unless it is already buffered
+    * or queued.
+    * @param lastUse Index of the last request that needs the tile.  Only
+    * raised if the tile is already buffered.
+    */
+   void request(ossim_uint16 directory, ossim_uint32 tile, ossim_uint64 lastUse);
+
+   /**
+    * @brief Gets a tile that was requested, waiting for it if its read is
+    * still queued or running.
+    * @return The decoded tile, or a null pointer if the tile was never
+    * requested or its read failed.  The tile stays buffered.
+    */
+   std::shared_ptr<const std::vector<ossim_uint8> > take(ossim_uint16 directory,
+                                                         ossim_uint32 tile);
+
+   /** @brief Drops buffered tiles whose last use is before requestIndex. */
+   void release(ossim_uint64 requestIndex);
+
+   /** @brief Drops all tiles.  Reads already queued are skipped. */
+   void clear();
+
+   /** @return Number of tiles buffered or queued. */
+   ossim_uint32 getNumberOfTiles() const;
+
+   /** @return true if tile is buffered or queued. */
+   bool hasTile(ossim_uint16 directory, ossim_uint32 tile) const;
+
+   /** @brief Statistics since open. */
+   ossim_uint64 getNumberOfRequests() const;
+   ossim_uint64 getNumberOfHits() const;
+   ossim_uint64 getNumberOfMisses() const;
+   ossim_uint32 getMaxNumberOfTiles() const;
+
+   /** @brief Prints the statistics in keyword: value form. */
+   std::ostream& print(std::ostream& out) const;
+
+private:
+   class ReadJob;
+
+   typedef std::pair<ossim_uint16, ossim_uint32> TileKey;
+
+   class Tile
+   {
+   public:
+      Tile() : m_ready(false), m_data(), m_lastUse(0) {}
+      bool                                             m_ready;
+      std::shared_ptr<const std::vector<ossim_uint8> > m_data;
+      ossim_uint64                                     m_lastUse;
+   };
+
+   /** Reads a tile on the worker thread. */
+   void readTile(const TileKey& key, ossim_uint32 generation);
+
+   std::shared_ptr<ossim::TiffIStreamAdaptor> m_streamAdaptor;
+   TIFF*                                      m_tiffPtr;
+   std::shared_ptr<ossimJobMultiThreadQueue>  m_jobQueue;
+
+   mutable std::mutex              m_mutex;
+   std::condition_variable         m_tileReady;
+   std::map<TileKey, Tile>         m_tiles;
+   ossim_uint32                    m_generation; // bumped by clear()
+
+   ossim_uint64 m_requests;
+   ossim_uint64 m_hits;
+   ossim_uint64 m_misses;
+   ossim_uint32 m_maxTiles;
+};
+
+#endif /* #ifndef ossimTiffTilePrefetcher_HEADER */
@@ -23,6 +23,8 @@
 #include <vector>
 #include <ossim/base/ossimStreamFactoryRegistry.h>
 #include <ossim/support_data/TiffStreamAdaptor.h>
+#include <memory>
+#include <mutex>
 /*
  * TIFF is defined as an incomplete type to hide the tiff library's internal
  * data structures from clients.
@@ -31,6 +33,7 @@ typedef struct tiff TIFF;
 
 class ossimImageData;
 class ossimTiffOverviewTileSource;
+class ossimTiffTilePrefetcher;
 class TiffStreamAdaptor;
 class OSSIMDLLEXPORT ossimTiffTileSource : public ossimImageHandler
 {
@@ -212,6 +215,47 @@ public:
    void setApplyColorPaletteFlag(bool flag);
    bool getApplyColorPaletteFlag()const;
 
+   /**
+    * @brief Starts reading tiles ahead of the caller if prefetch_tiles is
+    * set and area is read from a tiled directory of this file.
+    *
+    * Overrides ossimImageSource::setTileRequestOrder.  Tiles are then read
+    * and decoded on a background thread with a libtiff handle of its own, in
+    * the order tiles of tileSize are walked across area, while the caller
+    * processes the tile it has.
+    */
+   virtual void setTileRequestOrder(const ossimIrect& area,
+                                    const ossimIpt& tileSize,
+                                    ossim_uint32 resLevel=0);
+
+   /**
+    * @brief Sets the number of tiff tiles that may be read ahead of the
+    * caller.  Zero, the default, turns read ahead off.
+    *
+    * The default can be set with the preference
+    * "ossim.imaging.tiff.prefetch_tiles".
+    */
+   void setNumberOfPrefetchTiles(ossim_uint32 tiles);
+   ossim_uint32 getNumberOfPrefetchTiles() const;
+
+   /**
+    * @brief Turns on reads from several threads at once.
+    *
+    * When on, getTile(ossimImageData*, resLevel) decodes tiled directories
+    * with a libtiff handle per concurrent caller, drawn from a pool, so
+    * threads no longer wait on each other to decompress.  Reads of other
+    * layouts are serialized internally.  getTile(rect) still returns the
+    * reader's own tile and is not covered.
+    *
+    * The default can be set with the preference
+    * "ossim.imaging.tiff.concurrent_reads".
+    */
+   void setConcurrentReads(bool flag);
+   bool getConcurrentReads() const;
+
+   /** @return true if concurrent reads are turned on. */
+   virtual bool supportsConcurrentReads() const;
+
    virtual void setProperty(ossimRefPtr<ossimProperty> property);
    virtual ossimRefPtr<ossimProperty> getProperty(const ossimString& name)const;
    virtual void getPropertyNames(std::vector<ossimString>& propertyNames)const;
@@ -260,6 +304,9 @@ private:
     */
    void adjustToStartOfTile(ossimIpt& pt) const;
 
+   /** @brief adjustToStartOfTile for tiles of tw by th. */
+   static void adjustToStartOfTile(ossimIpt& pt, ossim_int32 tw, ossim_int32 th);
+
    /**
     *  If the tiff source has R0 then this returns the current tiff directory
     *  that the tiff pointer is pointing to; else, it returns the current
@@ -293,6 +340,61 @@ private:
 
    bool loadFromTile(const ossimIrect& clip_rect,
                      ossimImageData* result);
+
+   /**
+    * @brief Reads the tiff tile at origin from the current directory, from
+    * the prefetcher if it has it or else into theBuffer.
+    * @param data Set to the tile read.
+    * @return Bytes read, 0 if the tile is empty or < 0 on error as with
+    * TIFFReadTile.
+    */
+   ossim_int32 readTiffTile(const ossimIpt& origin,
+                            ossim_uint16 sample,
+                            const ossim_uint8*& data);
+
+   /**
+    * @brief Releases tiles read ahead for requests before tile_rect and
+    * queues reads for the requests after it.
+    */
+   void prefetch(const ossimIrect& tile_rect);
+
+   /** @brief Queues reads of the tiff tiles covering a request. */
+   void requestTiffTiles(ossim_uint64 requestIndex);
+
+   /** @return Index of tiff tile at origin of sample in directory. */
+   ossim_uint32 computeTiffTile(ossim_uint32 directory,
+                                const ossimIpt& origin,
+                                ossim_uint16 sample) const;
+
+   /** @brief Closes the prefetcher logging its statistics if debug. */
+   void closePrefetcher();
+
+   class ReadHandle;
+
+   /**
+    * @brief Fills result without touching theTiffPtr or theBuffer.
+    * @param status Set to the result of the read if handled.
+    * @return true if handled; false if the caller must read it serially.
+    */
+   bool getTileConcurrent(ossimImageData* result,
+                          ossim_uint32 resLevel,
+                          bool& status);
+
+   /**
+    * @brief loadFromTile with a pooled handle.  Uses the tile size of
+    * directory, not of theCurrentDirectory.
+    */
+   bool loadFromTileConcurrent(ReadHandle* handle,
+                               ossim_uint32 directory,
+                               const ossimIrect& clip_rect,
+                               ossimImageData* result);
+
+   /** @return A handle from the pool, opening one if none is free. */
+   ReadHandle* acquireReadHandle();
+   void releaseReadHandle(ReadHandle* handle);
+
+   /** @brief Closes the pooled handles. */
+   void closeReadHandles();
    
    void setReadMethod();
    
@@ -377,6 +479,22 @@ private:
    std::vector<ossim_uint32> theOutputBandList;
    std::shared_ptr<ossim::TiffIStreamAdaptor> m_streamAdaptor;
 
+   // Read ahead.  m_prefetchArea is nan when not active.
+   std::shared_ptr<ossimTiffTilePrefetcher> m_prefetcher;
+   std::shared_ptr<const std::vector<ossim_uint8> > m_prefetchedTile;
+   ossim_uint32              m_prefetchTiles;
+   ossimIrect                m_prefetchArea;
+   ossimIpt                  m_prefetchTileSize;
+   ossim_uint32              m_prefetchResLevel;
+   ossim_uint32              m_prefetchDirectory;
+   ossim_uint64              m_prefetchCursor;
+
+   // Concurrent reads.  m_readMutex serializes everything else.
+   bool                      m_concurrentReads;
+   std::mutex                m_readMutex;
+   std::vector<ReadHandle*>  m_readHandles;
+   std::mutex                m_readHandleMutex;
+
 TYPE_DATA
 };
 
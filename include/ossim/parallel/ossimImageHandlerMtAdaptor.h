@@ -39,7 +39,8 @@ public:
    virtual ossimRefPtr<ossimImageData> getTile(const ossimIrect& rect, ossim_uint32 resLevel=0);
 
    //! Intercepts the getTile call intended for the adaptee and sets a mutex lock around the
-   //! adaptee's getTile call.
+   //! adaptee's getTile call. No lock is taken if the adaptee supports concurrent reads and
+   //! the cache is not used.
    virtual bool getTile(ossimImageData* result, ossim_uint32 resLevel=0);
    
    //! Method to save the state of an object to a keyword list.
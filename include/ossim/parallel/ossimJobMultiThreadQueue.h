@@ -53,10 +53,8 @@
 *       jobQueue->add(job);
 *    }
 * 
-*    while(jobThreadQueue->hasJobsToProcess())
-*    {
-*       ossim::Thread::sleepInMilliSeconds(10);
-*    }
+*    // Block until every job added has been run:
+*    jobThreadQueue->waitAll();
 * 
 *    std::cout << "Finished and cancelling thread queue\n";
 *    jobThreadQueue->cancel();
@@ -124,6 +122,34 @@ public:
    */
    bool hasJobsToProcess()const;
 
+   /**
+   * Blocks the caller until every job added to the job queue has been run or removed.
+   * This is driven by the queue's completion notifications; no polling is involved.
+   */
+   void waitAll();
+
+   /**
+   * Blocks the caller until every job has been run or removed, or the time expires.
+   * Useful for reporting progress while waiting.
+   *
+   * @param waitTimeMillis maximum time to wait in milliseconds
+   * @return true if all jobs are done
+   */
+   bool waitAll(ossim_uint64 waitTimeMillis);
+
+   /**
+   * Blocks the caller until at least one more job completes.  Returns immediately if
+   * no jobs are pending.
+   *
+   * @return the number of jobs still queued or running
+   */
+   ossim_uint32 waitAny();
+
+   /**
+   * @return the number of jobs still queued or running
+   */
+   ossim_uint32 getNumberOfPendingJobs()const;
+
    /**
    * Allows one to cancel all threads
    */
@@ -10,8 +10,11 @@
 
 #include <ossim/parallel/ossimJob.h>
 #include <ossim/base/Block.h>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
 #include <memory>
+#include <unordered_set>
 
 /**
 * This is the base implementation for the job queue.  It allows one to add and remove
@@ -21,6 +24,12 @@
 *
 * The job queue is thread safe and can be shared by multiple threads.
 *
+* The queue also counts pending jobs, i.e. jobs that were added and have neither been
+* removed nor reported back through jobCompleted().  ossimJobThreadQueue reports every job
+* it pulls, so waitAll() and waitAny() can be used to block on the completion of the
+* work instead of polling.  Other consumers of nextJob() must call jobCompleted() for
+* each job they receive.
+*
 * Here is a quick code example on how to create a shared queue and to attach
 * a thread to it.  In this example we do not block the calling thread for nextJob
 * @code
@@ -144,7 +153,8 @@ public:
 
    /**
    * Will add a job to the queue and if the guaranteeUniqueFlag is set it will
-   * scan and make sure the job is not on the queue before adding
+   * make sure the job is not on the queue before adding.  The check is a
+   * constant time lookup in the job index.
    *
    * @param job The job to add to the queue.
    * @param guaranteeUniqueFlag if set to true will force a find to make sure the job
@@ -169,7 +179,8 @@ public:
    virtual std::shared_ptr<ossimJob> removeById(const ossimString& id);
 
    /**
-   * Allows one to pass in a job pointer to remove
+   * Allows one to pass in a job pointer to remove.  A job not queued is found in
+   * constant time in the job index; a queued job is found by a linear search.
    *
    * @param job the job you wish to remove from the list
    */
@@ -204,12 +215,46 @@ public:
    /**
    * @return true if the queue is empty false otherwise
    */
-   bool isEmpty()const;
+   virtual bool isEmpty()const;
 
    /**
    * @return the number of jobs on the queue
    */
-   ossim_uint32 size();
+   virtual ossim_uint32 size();
+
+   /**
+   * Called by the consumer once a job returned by nextJob() has been run (or discarded).
+   * Wakes any threads blocked in waitAll() or waitAny().
+   *
+   * @param job the job that was completed
+   */
+   virtual void jobCompleted(std::shared_ptr<ossimJob> job);
+
+   /**
+   * @return the number of jobs added that are either still queued or being run
+   */
+   ossim_uint32 getNumberOfPendingJobs()const;
+
+   /**
+   * Blocks the caller until there are no pending jobs.
+   */
+   void waitAll();
+
+   /**
+   * Blocks the caller until there are no pending jobs or the time expires.
+   *
+   * @param waitTimeMillis maximum time to wait in milliseconds
+   * @return true if there are no pending jobs
+   */
+   bool waitAll(ossim_uint64 waitTimeMillis);
+
+   /**
+   * Blocks the caller until at least one pending job completes or is removed.  Returns
+   * immediately if there are no pending jobs.
+   *
+   * @return the number of jobs still pending
+   */
+   ossim_uint32 waitAny();
 
    /**
    *  Allows one to set the callback to the list
@@ -262,11 +307,41 @@ protected:
    * @param job the job you wish to search for
    */
    bool hasJob(std::shared_ptr<ossimJob> job);
+
+   /**
+   * Internal method that erases the job from the list and the job index.
+   * The queue mutex must be held by the caller.
+   *
+   * @param iter the list position to erase
+   * @return the iterator following the erased position
+   */
+   ossimJob::List::iterator eraseJob(ossimJob::List::iterator iter);
+
+   /**
+   * Internal methods for the pending job accounting.  addPending() is called for every
+   * job added, releasePending() for jobs completed or removed without being run.
+   * releasePending() stops the count at 0; releasing more than is pending is logged
+   * when the trace ossimJobQueue:debug is enabled.
+   */
+   void addPending();
+   void releasePending(ossim_uint32 count);
    
    mutable std::mutex m_jobQueueMutex;
    ossim::Block m_block;
    ossimJob::List m_jobQueue;
+
+   /**
+   * Index of the jobs currently on m_jobQueue for constant time uniqueness checks.  A
+   * multiset since a job may be queued more than once when added without the unique flag.
+   */
+   std::unordered_multiset<const ossimJob*> m_jobIndex;
    std::shared_ptr<Callback> m_callback;
+
+   std::atomic<ossim_uint32> m_pendingCount;
+   std::atomic<ossim_uint64> m_completedCount;
+   std::atomic<ossim_uint32> m_pendingWaiters;
+   std::mutex                m_pendingMutex;
+   std::condition_variable   m_pendingCondition;
 };
 
 #endif
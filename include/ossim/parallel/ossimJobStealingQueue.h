@@ -0,0 +1,136 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+#ifndef ossimJobStealingQueue_HEADER
+#define ossimJobStealingQueue_HEADER
+
+#include <ossim/parallel/ossimJobQueue.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+/**
+* Work-stealing job queue.  Instead of a single list behind a single mutex, jobs are kept
+* in a number of lanes, each a deque with its own mutex.  Every thread that pulls jobs with
+* nextJob() is bound to one lane.  A consumer first takes from its own lane and, if that is
+* empty, steals from the other lanes.  Jobs added from a consumer thread (e.g. a job that
+* queues a follow-on job) go to that thread's lane; jobs added from any other thread are
+* distributed round robin over the lanes.  Both owners and thieves take from the front of a
+* lane so submission order is preserved per lane.
+*
+* Uniqueness checks for add() use a sharded pointer index, so they are constant time and do
+* not serialize producers.  remove() returns at once for a job not in the index; a queued
+* job is found by a linear search of the lanes.
+*
+* It is a drop-in for the default queue of ossimJobMultiThreadQueue.  The number of lanes
+* should usually match the number of threads:
+* @code
+* ossim_uint32 nThreads = ossim::getNumberOfThreads();
+* std::shared_ptr<ossimJobQueue> jobQueue = std::make_shared<ossimJobStealingQueue>(nThreads);
+* std::shared_ptr<ossimJobMultiThreadQueue> jobMtQueue =
+*    std::make_shared<ossimJobMultiThreadQueue>(jobQueue, nThreads);
+* jobQueue->add(job);
+* @endcode
+*/
+class OSSIM_DLL ossimJobStealingQueue : public ossimJobQueue
+{
+public:
+   /**
+   * @param numberOfLanes Number of per-consumer deques.  If 0, ossim::getNumberOfThreads()
+   *        is used.  Consumers beyond this count share lanes.
+   */
+   ossimJobStealingQueue(ossim_uint32 numberOfLanes=0);
+
+   virtual ~ossimJobStealingQueue();
+
+   virtual void add(std::shared_ptr<ossimJob> job, bool guaranteeUniqueFlag=true);
+   virtual std::shared_ptr<ossimJob> removeByName(const ossimString& name);
+   virtual std::shared_ptr<ossimJob> removeById(const ossimString& id);
+   virtual void remove(const std::shared_ptr<ossimJob> job);
+   virtual void removeStoppedJobs();
+   virtual void clear();
+
+   /**
+   * Pops from the calling thread's lane, stealing from the other lanes if it is empty.
+   * If blockIfEmptyFlag is set, waits until a job is added or releaseBlock() is called.
+   */
+   virtual std::shared_ptr<ossimJob> nextJob(bool blockIfEmptyFlag=true);
+
+   /**
+   * Wakes all threads currently blocked in nextJob().
+   */
+   virtual void releaseBlock();
+
+   virtual bool isEmpty()const;
+   virtual ossim_uint32 size();
+
+   /**
+   * @return the number of lanes
+   */
+   ossim_uint32 getNumberOfLanes()const;
+
+protected:
+   static const ossim_uint32 NUMBER_OF_INDEX_SHARDS = 16;
+
+   struct Lane
+   {
+      Lane() : m_count(0) {}
+      std::mutex                            m_mutex;
+      std::deque<std::shared_ptr<ossimJob> > m_jobs;
+      std::atomic<ossim_uint32>             m_count; //<! Mirror of m_jobs.size() for lock free peeks
+   };
+
+   struct IndexShard
+   {
+      std::mutex                               m_mutex;
+      std::unordered_multiset<const ossimJob*> m_jobs;
+   };
+
+   /**
+   * @return the lane of the calling thread, binding it to one if bindFlag is set and the
+   *         thread has not pulled from this queue before.
+   */
+   ossim_uint32 consumerLane(bool bindFlag);
+
+   /**
+   * Takes the next job from the given lane, or steals one from the others.
+   * Canceled jobs encountered are marked finished and dropped.
+   */
+   std::shared_ptr<ossimJob> popJob(ossim_uint32 lane);
+
+   /**
+   * Takes the front job of a lane.  Returns a null pointer if the lane is empty.
+   */
+   std::shared_ptr<ossimJob> popFront(Lane& lane);
+
+   /**
+   * Removes the jobs matching the predicate from all lanes.
+   *
+   * @param firstOnly stop after the first match
+   */
+   template <class Predicate>
+   void removeIf(Predicate pred, bool firstOnly, ossimJob::List& removedJobs);
+
+   IndexShard& indexShard(const ossimJob* job);
+   void unindex(const ossimJob* job);
+   void notifyRemoved(const ossimJob::List& removedJobs);
+
+   std::vector<Lane*>        m_lanes;
+   IndexShard                m_index[NUMBER_OF_INDEX_SHARDS];
+   std::atomic<ossim_uint32> m_size;
+   std::atomic<ossim_uint32> m_nextProducerLane;
+   std::atomic<ossim_uint32> m_nextConsumerLane;
+
+   std::mutex                m_waitMutex;
+   std::condition_variable   m_waitCondition;
+   std::atomic<ossim_uint32> m_idleCount;
+   std::atomic<ossim_uint32> m_releaseCount;
+};
+
+#endif
@@ -19,22 +19,66 @@
 class ossimSource;
 
 /***************************************************************************************************
- * Base class for all Point Cloud data sources, including input file handlers and processing nodes.
+ * Container for a block of point cloud samples. Points are stored column-wise (structure of
+ * arrays): one contiguous array each for the point ID, latitude, longitude and height, plus one
+ * contiguous float array per field selected by the field code. No per-point heap allocation is
+ * performed, so blocks holding tens of millions of points cost only a handful of allocations.
+ *
+ * Individual points are accessed through the lightweight PointView returned by getPoint() and
+ * operator[]. The view only references the block, so it must not outlive it. For bulk processing,
+ * the column buffers (getLatBuf(), getFieldBuf(), etc.) should be used directly.
  **************************************************************************************************/
 class OSSIMDLLEXPORT ossimPointBlock: public ossimDataObject
 {
 public:
    typedef std::vector< ossimRefPtr<ossimPointRecord> > PointList;
 
+   /** Number of optional fields (columns) that can be stored in addition to the position */
+   static const ossim_uint32 NUM_FIELDS = 8;
+
+   /**
+    * Read-only proxy for a single point in the block. Provides the same accessors as
+    * ossimPointRecord so that existing per-point code can operate on the columnar storage.
+    * operator->() is provided so that the legacy "block[i]->getField()" form still compiles.
+    */
+   class OSSIMDLLEXPORT PointView
+   {
+   public:
+      PointView(const ossimPointBlock* block, ossim_uint32 index)
+      : m_block(block), m_index(index) {}
+
+      bool valid() const { return (m_block != 0) && (m_index < m_block->size()); }
+      ossim_uint32 getIndex() const { return m_index; }
+      ossim_uint32 getPointId() const { return m_block->m_pointIds[m_index]; }
+      ossimGpt getPosition() const { return m_block->getPosition(m_index); }
+      ossim_float32 getField(ossimPointRecord::FIELD_CODES fc) const
+      { return m_block->getField(m_index, fc); }
+      bool hasFields(ossim_uint32 code_mashup) const
+      { return (m_block->m_fieldCode & code_mashup) == code_mashup; }
+      ossim_uint32 getFieldCode() const { return m_block->m_fieldCode; }
+
+      /** Copies the point into a standalone record. */
+      void getRecord(ossimPointRecord& record) const { m_block->getRecord(m_index, record); }
+
+      const PointView* operator->() const { return this; }
+
+   private:
+      const ossimPointBlock* m_block;
+      ossim_uint32 m_index;
+   };
+
    explicit ossimPointBlock(ossimSource* owner=0, ossim_uint32 fields=0);
 
    ~ossimPointBlock();
 
-   /** Returns allocated size. The pointList may contain only null points if not assigned */
-   virtual ossim_uint32 size() const { return (ossim_uint32)m_pointList.size(); }
+   /** Returns number of points stored. */
+   virtual ossim_uint32 size() const { return (ossim_uint32)m_pointIds.size(); }
 
    bool empty() const { return (size() == 0); }
 
+   /** Pre-allocates the columns for numPoints points to avoid reallocation during fill. */
+   void reserve(ossim_uint32 numPoints);
+
    /**
     * Returns OR'd mash-up of ossimPointRecord field codes being stored (or desired to be stored)
     */
@@ -43,22 +87,58 @@ public:
 
    /**
     * Initializes the desired fields to be stored. This will affect future getBlock() calls. If
-    * the point list contains points from prior read, they will be deleted unless the points field
+    * the block contains points from prior read, they will be deleted unless the block's field
     * code matches the code argument.
     */
    void setFieldCode(ossim_uint32 code);
 
-   /** Adds single point to the tail of the list. */
+   /**
+    * Adds single point to the tail of the block. The record's values are copied into the columns;
+    * the caller keeps ownership of the record. Fields present in the record but not yet in the
+    * block are added as new columns. Fields stored by the block but missing in the record are set
+    * to NaN.
+    */
    virtual void addPoint(ossimPointRecord* point);
 
-   virtual const ossimPointRecord* getPoint(ossim_uint32 point_offset) const;
-   virtual ossimPointRecord* getPoint(ossim_uint32 point_offset);
+   /**
+    * Preferred method for adding points. Appends a point with the given position. Fields are
+    * initialized to NaN and can be assigned with setField(). Returns the index of the new point.
+    */
+   ossim_uint32 addPoint(const ossimGpt& position, ossim_uint32 pointId=0);
+
+   /** Appends point at index <i> of another block, copying only the fields this block stores. */
+   void addPoint(const ossimPointBlock& src, ossim_uint32 i);
 
-   const ossimPointRecord* operator[](ossim_uint32 i) const { return getPoint(i); }
-   ossimPointRecord* operator[](ossim_uint32 i) { return getPoint(i); }
+   /** Returns a view of point at offset. The view is invalid if the offset is out of range. */
+   PointView getPoint(ossim_uint32 point_offset) const;
+   PointView operator[](ossim_uint32 i) const { return getPoint(i); }
 
-   virtual const PointList&  getPoints() const { return m_pointList; }
-   virtual PointList&  getPoints()  { return m_pointList; }
+   /**
+    * Compatibility accessors for code written against the former list of records. The list is
+    * rebuilt from the columns on every call, one record allocation per point, and changes made
+    * to it are not written back to the block. Use getPoint() or the column buffers instead.
+    */
+   virtual const PointList& getPoints() const;
+   virtual PointList& getPoints();
+
+   /** Per-point accessors. No range checking is performed. */
+   ossimGpt getPosition(ossim_uint32 i) const { return ossimGpt(m_lat[i], m_lon[i], m_hgt[i]); }
+   void setPosition(ossim_uint32 i, const ossimGpt& p);
+   ossim_float32 getField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc) const;
+   void setField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc, ossim_float32 value);
+   void getRecord(ossim_uint32 i, ossimPointRecord& record) const;
+
+   /**
+    * Column access. The position buffers are always available (when not empty). getFieldBuf()
+    * returns NULL if the field is not stored in this block.
+    */
+   const ossim_float64* getLatBuf() const { return m_lat.empty() ? 0 : &m_lat.front(); }
+   const ossim_float64* getLonBuf() const { return m_lon.empty() ? 0 : &m_lon.front(); }
+   const ossim_float64* getHgtBuf() const { return m_hgt.empty() ? 0 : &m_hgt.front(); }
+   const ossim_uint32*  getPointIdBuf() const
+   { return m_pointIds.empty() ? 0 : &m_pointIds.front(); }
+   const ossim_float32* getFieldBuf(ossimPointRecord::FIELD_CODES fc) const;
+   ossim_float32* getFieldBuf(ossimPointRecord::FIELD_CODES fc);
 
    void getFieldMin(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const;
    void getFieldMax(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const;
@@ -68,28 +148,38 @@ public:
 
    virtual ossimObject* dup() const;
 
-   /** Resets any storage to empty. */
-   virtual void clear() { m_pointList.clear(); m_isNormalized = false; m_minMaxValid = false;}
+   /** Resets any storage to empty. The field code is retained. */
+   virtual void clear();
 
    /**
     *  Fulfills base class pure virtual. TODO: Needs to be correctly implemented
     */
    virtual bool isEqualTo(const ossimDataObject& /*rhs*/, bool /*deep_copy*/) const { return false; }
    virtual ossim_uint32 getHashId() const { return 0; }
-   virtual ossim_uint32 getDataSizeInBytes() const { return 0; };
+   virtual ossim_uint32 getDataSizeInBytes() const;
    virtual void initialize() {};
 
+   /** Returns the column index for the field code, or -1 if not a single valid field. */
+   static int fieldIndex(ossimPointRecord::FIELD_CODES fc);
+
 protected:
-   ossimPointBlock(const ossimPointBlock& /* rhs */) {}
+   ossimPointBlock(const ossimPointBlock& rhs);
    void scanForMinMax() const;
 
-   ossimPointRecord m_nullPCR;
+   /** Adds columns (filled with NaN) for any fields in code not yet stored. */
+   void addFields(ossim_uint32 code);
+
    mutable ossimPointRecord m_minRecord;
    mutable ossimPointRecord m_maxRecord;
    mutable bool m_minMaxValid;
-   PointList m_pointList;
-   mutable ossim_uint32 m_fieldCode; // OR'd mash-up of ossimPointRecord::FIELD_CODES
+   std::vector<ossim_uint32>  m_pointIds;
+   std::vector<ossim_float64> m_lat;
+   std::vector<ossim_float64> m_lon;
+   std::vector<ossim_float64> m_hgt;
+   std::vector<ossim_float32> m_fields[NUM_FIELDS]; // empty if field not stored
+   ossim_uint32 m_fieldCode; // OR'd mash-up of ossimPointRecord::FIELD_CODES
    bool m_isNormalized;
+   mutable PointList m_pointList; // Only filled by getPoints()
 
 TYPE_DATA
 };
@@ -217,27 +217,27 @@ public:
 
 
 protected:
-   class PcrBucket
-   {
-   public:
-      PcrBucket() : m_bucket(0), m_numSamples(0) {}
-      PcrBucket(const ossim_float32* init_value, ossim_uint32 numBands);
-      PcrBucket(const ossim_float32& R, const ossim_float32& G, const ossim_float32& B);
-
-      explicit PcrBucket(const ossim_float32& init_value);
-
-      ~PcrBucket();
-      ossim_float32* m_bucket;
-      int m_numSamples;
-   };
-
    void initTile();
 
-   void addSample(std::map<ossim_int32, PcrBucket*>& accumulator,
-                  ossim_int32 index,
-                  const ossimPointRecord* sample);
-
-   void normalize(std::map<ossim_int32, PcrBucket*>& accumulator);
+   /**
+    * Rasterizes the points of the block into the dense, band-sequential accumulator (tile_size
+    * floats per band) and per-pixel sample counts. If roi is not NULL, points outside of it are
+    * skipped.
+    */
+   void accumulate(const ossimPointBlock& pointBlock,
+                   const ossimGrect* roi,
+                   ossim_uint32 resLevel,
+                   const ossimIpt& tile_offset,
+                   ossim_uint32 tile_width,
+                   ossim_uint32 tile_size,
+                   ossim_float32* accumulator,
+                   ossim_uint32* counts);
+
+   /** Converts accumulated sums to means for the components that are averaged. */
+   void normalize(ossim_float32* accumulator,
+                  const ossim_uint32* counts,
+                  ossim_uint32 tile_size,
+                  ossim_uint32 numBands);
 
    ossim_uint32 componentToFieldCode() const;
 
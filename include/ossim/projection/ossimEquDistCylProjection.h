@@ -78,6 +78,25 @@ public:
    virtual void     worldToLineSample(const ossimGpt &worldPoint,
                                       ossimDpt&       lineSample)const;
 
+   /**
+    * @brief Batch forms of worldToLineSample, lineSampleToWorld and
+    * lineSampleHeightToWorld.
+    *
+    * Without a model transform the projection math is inlined and datum
+    * shifts are only done for points not already on this datum.  Elevation
+    * lookups, if enabled, are made in one batch.
+    */
+   virtual void worldToLineSamplePoints(const ossimGpt* worldPoints,
+                                        ossim_uint32    count,
+                                        ossimDpt*       lineSampPoints) const;
+   virtual void lineSampleToWorldPoints(const ossimDpt* lineSampPoints,
+                                        ossim_uint32    count,
+                                        ossimGpt*       worldPoints) const;
+   virtual void lineSampleHeightToWorldPoints(const ossimDpt* lineSampPoints,
+                                              const double*   heightsAboveEllipsoid,
+                                              ossim_uint32    count,
+                                              ossimGpt*       worldPoints) const;
+
    /**
     * @brief Specialized worldToLineSample.
     * 
@@ -113,7 +132,17 @@ public:
    virtual bool loadState(const ossimKeywordlist& kwl,
                           const char* prefix=0);
    
-private:   
+private:
+   /**
+    * Worker for lineSampleToWorldPoints and lineSampleHeightToWorldPoints.
+    * A null heightsAboveEllipsoid gives every point a NaN height, as
+    * lineSampleToWorld does.
+    */
+   void inverseLineSamplePoints(const ossimDpt* lineSampPoints,
+                                const double*   heightsAboveEllipsoid,
+                                ossim_uint32    count,
+                                ossimGpt*       worldPoints) const;
+
    //---------------------GEOTRANS-------------------------------
    mutable double Eqcy_a;                  /* Semi-major axis of ellipsoid in meters */
    mutable double Eqcy_f;          /* Flattening of ellipsoid */
@@ -0,0 +1,133 @@
+//*******************************************************************
+//
+// License:  See top level LICENSE.txt file.
+//
+// DESCRIPTION: Contains declaration of ossimImageViewGridTransform.
+//    Wraps another image view transform and answers viewToImage from a
+//    coarse grid of view-to-image displacements, in the spirit of
+//    ossimCoarseGridModel.  The grid is built lazily in blocks as the view
+//    is visited and kept until clearGrid() is called, so repeat requests
+//    over the same view do no projection math.
+//
+//*******************************************************************
+#ifndef ossimImageViewGridTransform_HEADER
+#define ossimImageViewGridTransform_HEADER 1
+
+#include <ossim/projection/ossimImageViewTransform.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+class OSSIMDLLEXPORT ossimImageViewGridTransform : public ossimImageViewTransform
+{
+public:
+   /**
+    * @param transform The transform to approximate.  Held by reference.
+    * @param gridSpacing Distance between grid nodes in view pixels.
+    * @param maxError Largest image space error in pixels allowed for a grid
+    * cell.  Cells that miss it are passed to the wrapped transform.
+    * @param maxBlocks Number of grid blocks kept before the oldest are
+    * dropped.  A block covers BLOCK_CELLS x BLOCK_CELLS cells.
+    */
+   ossimImageViewGridTransform(ossimImageViewTransform* transform=0,
+                               ossim_uint32 gridSpacing=16,
+                               double maxError=0.1,
+                               ossim_uint32 maxBlocks=1024);
+
+   //! Copies the settings and the wrapped transform but not the grid.
+   ossimImageViewGridTransform(const ossimImageViewGridTransform& src);
+
+   virtual ossimObject* dup() const { return new ossimImageViewGridTransform(*this); }
+   virtual ~ossimImageViewGridTransform();
+
+   //! Sets the transform to approximate and clears the grid.
+   void setTransform(ossimImageViewTransform* transform);
+   ossimImageViewTransform* getTransform() { return m_transform.get(); }
+   const ossimImageViewTransform* getTransform() const { return m_transform.get(); }
+
+   //! Setters clear the grid.
+   void setGridSpacing(ossim_uint32 gridSpacing);
+   ossim_uint32 getGridSpacing() const { return m_gridSpacing; }
+   void setMaxError(double maxError);
+   double getMaxError() const { return m_maxError; }
+   void setMaxBlocks(ossim_uint32 maxBlocks);
+   ossim_uint32 getMaxBlocks() const { return m_maxBlocks; }
+
+   /**
+    * Drops the grid.  Must be called whenever the wrapped transform changes
+    * (new geometry, new view, ...) since the grid cannot detect that itself.
+    */
+   void clearGrid();
+
+   //! @return Number of grid blocks currently held.
+   ossim_uint32 getNumberOfBlocks() const;
+
+   /**
+    * Builds the grid blocks covering viewRect ahead of use.  With more than
+    * one thread the blocks are built on a job queue; only do that when the
+    * wrapped transform can be called from several threads at once.
+    * At most getMaxBlocks() blocks are built.
+    */
+   void buildGrid(const ossimIrect& viewRect, ossim_uint32 numberOfThreads=1);
+
+   //! Passed to the wrapped transform.
+   virtual bool isIdentity() const;
+   virtual bool isValid() const;
+   virtual ossimDpt getInputMetersPerPixel() const;
+   virtual ossimDpt getOutputMetersPerPixel() const;
+   virtual void imageToView(const ossimDpt& imagePoint, ossimDpt& viewPoint) const;
+   virtual void imageToViewPoints(const ossimDpt* imagePoints, ossim_uint32 count,
+                                  ossimDpt* viewPoints) const;
+
+   //! Grid lookups, falling back to the wrapped transform where the grid is not good enough.
+   virtual void viewToImage(const ossimDpt& viewPoint, ossimDpt& imagePoint) const;
+   virtual void viewToImagePoints(const ossimDpt* viewPoints, ossim_uint32 count,
+                                  ossimDpt* imagePoints) const;
+
+   //! Passed to the wrapped transform.  A new view clears the grid.
+   virtual bool setView(ossimObject* baseObject);
+   virtual ossimObject* getView();
+   virtual const ossimObject* getView() const;
+
+   virtual std::ostream& print(std::ostream& out) const;
+
+   //! Grid cells along each side of a block.
+   static const ossim_uint32 BLOCK_CELLS = 16;
+
+private:
+   class Block;
+   class BlockJob;
+   typedef std::pair<ossim_int32, ossim_int32> BlockKey;
+   typedef std::map< BlockKey, std::shared_ptr<const Block> > BlockMap;
+
+   //! @return Key of the block holding viewPoint (which must not be NaN).
+   BlockKey getBlockKey(const ossimDpt& viewPoint) const;
+
+   //! Finds the block, building and adding it if needed.
+   std::shared_ptr<const Block> getBlock(const BlockKey& key) const;
+
+   //! Projects the nodes and cell centers of a block.  No lock held.
+   std::shared_ptr<const Block> buildBlock(const BlockKey& key) const;
+
+   //! Caches block unless the grid was cleared after generation was read.
+   void addBlock(const BlockKey& key, std::shared_ptr<const Block> block,
+                 ossim_uint32 generation) const;
+
+   ossimRefPtr<ossimImageViewTransform> m_transform;
+   ossim_uint32 m_gridSpacing;
+   double       m_maxError;
+   ossim_uint32 m_maxBlocks;
+
+   mutable std::mutex           m_mutex;
+   mutable BlockMap             m_blocks;
+   mutable std::deque<BlockKey> m_blockOrder; // oldest first
+   ossim_uint32                 m_generation; // bumped by clearGrid()
+
+TYPE_DATA
+};
+
+#endif
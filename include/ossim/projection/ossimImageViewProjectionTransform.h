@@ -53,6 +53,14 @@ public:
    //! Other workhorse of the object. Converts view-space to image-space.
    virtual void viewToImage(const ossimDpt& viewPoint, ossimDpt& imagePoint) const;
 
+   //! Batch forms of imageToView() and viewToImage(). When the points go through the ground,
+   //! each geometry projects them with its batch methods (see
+   //! ossimImageGeometry::localToWorldPoints and worldToLocalPoints).
+   virtual void imageToViewPoints(const ossimDpt* imagePoints, ossim_uint32 count,
+                                  ossimDpt* viewPoints) const;
+   virtual void viewToImagePoints(const ossimDpt* viewPoints, ossim_uint32 count,
+                                  ossimDpt* imagePoints) const;
+
    //! Dumps contents to stream
    virtual std::ostream& print(std::ostream& out) const;
    
@@ -79,6 +79,20 @@ public:
   
   virtual void viewToImage(const ossimDpt& viewPoint,
                            ossimDpt&       imagePoint)const;
+
+  /*!
+   * Batch forms of imageToView and viewToImage.  Transform count points from
+   * the first array into the second.  The defaults loop over the single point
+   * methods; derived classes override them when work such as projections and
+   * elevation lookups can be shared between the points.
+   */
+  virtual void imageToViewPoints(const ossimDpt* imagePoints,
+                                 ossim_uint32    count,
+                                 ossimDpt*       viewPoints)const;
+
+  virtual void viewToImagePoints(const ossimDpt* viewPoints,
+                                 ossim_uint32    count,
+                                 ossimDpt*       imagePoints)const;
   
   virtual std::ostream& print(std::ostream& out) const;
   
@@ -47,6 +47,15 @@ public:
    virtual void  worldToLineSample(const ossimGpt& world_point,
                                    ossimDpt&       image_point) const;
 
+   /**
+    * @brief worldToLineSamplePoints()
+    * Batch form of worldToLineSample(); calls
+    * ossimRpcModel::worldToLineSamplePoints(), then applies decimation.
+    */
+   virtual void worldToLineSamplePoints(const ossimGpt* world_points,
+                                        ossim_uint32    count,
+                                        ossimDpt*       image_points) const;
+
    /**
     * @brief lineSampleHeightToWorld()
     * Backs out decimation of image_point (if needed) then calls:
@@ -71,6 +71,31 @@ public:
                                         const double&   heightAboveEllipsoid,
                                         ossimGpt&       worldPt) const = 0;
 
+   /*!
+    * METHODS: worldToLineSamplePoints(), lineSampleToWorldPoints(),
+    *          lineSampleHeightToWorldPoints()
+    * Batch forms of the single point projections above.  Each transforms
+    * count points and gives the same results, to within floating point
+    * rounding, as calling the single point method on every point.  The
+    * defaults loop over the single point methods; projections override them
+    * where work can be shared between points.
+    */
+   virtual void worldToLineSamplePoints(const ossimGpt* worldPoints,
+                                        ossim_uint32    count,
+                                        ossimDpt*       lineSampPoints) const;
+
+   virtual void lineSampleToWorldPoints(const ossimDpt* lineSampPoints,
+                                        ossim_uint32    count,
+                                        ossimGpt*       worldPoints) const;
+
+   /*!
+    * heightsAboveEllipsoid holds one height per point.
+    */
+   virtual void lineSampleHeightToWorldPoints(const ossimDpt* lineSampPoints,
+                                              const double*   heightsAboveEllipsoid,
+                                              ossim_uint32    count,
+                                              ossimGpt*       worldPoints) const;
+
    virtual void getRoundTripError(const ossimDpt& imagePoint,
                                   ossimDpt& errorResult)const;
 
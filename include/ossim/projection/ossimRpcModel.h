@@ -109,6 +109,17 @@ public:
     */
    virtual void  worldToLineSample(const ossimGpt& world_point,
                                    ossimDpt&       image_point) const;
+
+   /**
+    * @brief worldToLineSamplePoints()
+    * Overrides base class implementation. Evaluates the polynomials for
+    * blocks of points at a time, forming the monomials of each point once
+    * for all four polynomials.
+    */
+   virtual void worldToLineSamplePoints(const ossimGpt* world_points,
+                                        ossim_uint32    count,
+                                        ossimDpt*       image_points) const;
+
    /**
     * @brief print()
     * Extends base-class implementation. Dumps contents of object to ostream.
@@ -10,35 +10,127 @@
 
 #include <ossim/base/ossimConstants.h>
 #include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <condition_variable>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ossimJobMultiThreadQueue;
+class ossimTool;
 
 /**
  * Utility class provides the server interface to ossimTool-derived functionality via TCP sockets
  * Results are returned either as streamed text (for non-image responses such as image info) or
  * streamed binary file representing imagery or vector products. Clients interfacing to this class
  * should know the commands available (or execute the command "help" and view the text response).
+ *
+ * Connections are served one at a time (SERIAL_MODE), by a forked child process each
+ * (FORK_MODE) or, on Linux, by a fixed pool of threads in this process (THREAD_POOL_MODE). In
+ * the latter the listener waits on the listening and idle client sockets with epoll and hands
+ * each readable connection to a worker, so a persistent connection keeps its requests in order
+ * while other connections are served beside it, and caches and ossimInit stay warm.
+ *
+ * A tool whose isReusable() is true goes back to a pool after its request, cleared to its
+ * constructed state, and is taken by the next request for that tool; other tools, e.g. those of
+ * plugins, are created for each request. A connection is served one request at a time: the next
+ * request is read once the response is sent, so requests are not pipelined. Only chip requests
+ * run beside each other. The text response of any other tool is its stdout, which is redirected
+ * process wide, so those requests run one at a time whatever the number of threads.
+ *
+ * The command "stats" returns the request latency statistics of the process serving it.
  * @see ossimToolClient for concrete client implementation.
  */
 class OSSIM_DLL ossimToolServer
 {
 public:
+   enum ServerMode
+   {
+      SERIAL_MODE      = 0,
+      FORK_MODE        = 1,
+      THREAD_POOL_MODE = 2
+   };
+
    ossimToolServer();
    ~ossimToolServer();
+
+   /**
+    * @brief Sets how connections are served. Defaults to THREAD_POOL_MODE on Linux and
+    * SERIAL_MODE elsewhere. Call before startListening.
+    */
+   void setServerMode(ServerMode mode);
+
+   /**
+    * @brief Sets the number of worker threads for THREAD_POOL_MODE. Defaults to the number of
+    * cores.
+    */
+   void setNumberOfThreads(ossim_uint32 threads);
+
    void startListening(const char* portid);
 
+   /** @brief Prints count, mean, p50, p99 and max request latency in keyword: value form. */
+   std::ostream& printStatistics(std::ostream& out) const;
+
 private:
+   class RequestJob;
+   class Session;
+
    void initSocket(const char* portid);
-   bool processOssimRequest(struct sockaddr_in& cli_addr);
-   bool runCommand(ossimString& command);
-   void writeSocket(const char* buf, int bufsize);
-   bool sendFile(const ossimFilename& fname);
+   void serveWithThreadPool();
+   void serveSession(std::shared_ptr<Session> session);
    void error(const char* msg);
-   bool acknowledgeRcvd();
+
+   /**
+    * Stdout is redirected process wide to capture a tool's output, so a capture waits for every
+    * other tool run to finish and vice versa.
+    */
+   void beginToolRun(bool capture);
+   void endToolRun(bool capture);
+
+   /**
+    * Writes text to stdout. Text written while a tool's output is captured is held until the
+    * capture ends so it does not end up in that tool's response.
+    */
+   void writeConsole(const std::string& text);
+
+   /** @return An idle pooled tool of the name, else a new one (null if the name is unknown). */
+   ossimRefPtr<ossimTool> acquireTool(const std::string& name);
+
+   /** Clears a reusable tool and returns it to the pool. Other tools are dropped. */
+   void releaseTool(const std::string& name, ossimRefPtr<ossimTool> tool);
+
+   void addLatency(double seconds);
 
    static void sigchld_handler(int s);
 
    int m_svrsockfd;
-   int m_clisockfd;
-   char* m_buffer;
+
+   ServerMode   m_mode;
+   ossim_uint32 m_numThreads;
+
+   std::shared_ptr<ossimJobMultiThreadQueue>     m_jobQueue;
+   int                                           m_epollfd;
+   std::mutex                                    m_sessionMutex;
+   std::map<int, std::shared_ptr<Session> >      m_sessions;
+
+   std::mutex              m_outputMutex;
+   std::condition_variable m_outputCondition;
+   ossim_uint32            m_uncapturedRuns;
+   bool                    m_capturing;
+   std::string             m_heldConsole;
+
+   std::mutex                                                  m_toolMutex;
+   std::map<std::string, std::vector< ossimRefPtr<ossimTool> > > m_idleTools;
+
+   mutable std::mutex  m_statsMutex;
+   ossim_uint64        m_requestCount;
+   double              m_totalLatency;
+   double              m_maxLatency;
+   std::vector<double> m_latencies; // last LATENCY_WINDOW requests
+   ossim_uint32        m_latencyIndex;
 };
 
 
@@ -0,0 +1,110 @@
+//*******************************************************************
+//
+// License:  See top level LICENSE.txt file.
+// 
+//*****************************************************************************
+#ifndef ossimImageHandlerStateStore_HEADER
+#define ossimImageHandlerStateStore_HEADER 1
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/support_data/ImageHandlerState.h>
+#include <memory>
+
+namespace ossim
+{
+   /**
+   * Persistent store of image handler states shared by processes.
+   *
+   * Each state is written to its own small keyword list file in the store
+   * directory, named from the image path and entry.  The file also records
+   * the image size and modification time and the modification time of the
+   * image's directory.  A state is only returned if all still match, so a
+   * changed image, or an overview or other support file added next to it,
+   * means it is opened the slow way and its state rewritten.  Files are
+   * written to a temporary name and renamed so readers in other processes
+   * never see a partial state.
+   *
+   * Only handlers that make an ImageHandlerState known to
+   * ImageHandlerStateRegistry are stored.  Currently that is
+   * ossimTiffTileSource through TiffHandlerState.  Other handlers, e.g. the
+   * nitf reader, have no state, so they are not stored and always open the
+   * normal way.
+   *
+   * Used by ossimImageHandlerRegistry when the preference
+   * "ossim.imaging.handler.registry.state_store.directory" is set.
+   *
+   * Example:
+   *
+   * @code
+   * ossim::ImageHandlerStateStore store("/tmp/ossim_states");
+   * std::shared_ptr<ossim::ImageHandlerState> state = store.getState(file, 0);
+   * if(!state)
+   * {
+   *    ossimRefPtr<ossimImageHandler> h = ossimImageHandlerRegistry::instance()->open(file);
+   *    if(h) store.addState(file, h->getState());
+   * }
+   * @endCode
+   */
+   class OSSIM_DLL ImageHandlerStateStore
+   {
+   public:
+      /**
+      * @param directory Where states are stored.  Created on first write
+      *        if it does not exist.
+      */
+      ImageHandlerStateStore(const ossimFilename& directory);
+
+      /**
+      * @return The state of entry of file if stored and the file has not
+      *         changed since; else, null.
+      */
+      std::shared_ptr<ImageHandlerState> getState(const ossimFilename& file,
+                                                  ossim_uint32 entry)const;
+
+      /**
+      * Stores state for file under the state's current entry.
+      *
+      * @return true on success.
+      */
+      bool addState(const ossimFilename& file,
+                    std::shared_ptr<const ImageHandlerState> state)const;
+
+      /**
+      * Removes the stored state of entry of file if any.
+      */
+      void removeState(const ossimFilename& file, ossim_uint32 entry)const;
+
+      /**
+      * @return File in the store for other support data of entry of file,
+      *         e.g. an index that cannot be written next to the image.
+      *         Named like the state file, with extension ext.  The caller
+      *         checks the data is current and creates the directory.
+      */
+      ossimFilename getSupportFile(const ossimFilename& file,
+                                   ossim_uint32 entry,
+                                   const ossimString& ext)const;
+
+      const ossimFilename& getDirectory()const{return m_directory;}
+
+   private:
+      /** @return The store file for entry of file. */
+      ossimFilename getStateFile(const ossimString& id)const;
+
+      /**
+      * Gets the size and modification time of file and the modification
+      * time of its directory.
+      * @return false if the file does not exist.
+      */
+      static bool getStamp(const ossimFilename& file,
+                           ossim_int64& size,
+                           ossim_int64& modified,
+                           ossim_int64& directoryModified);
+
+      /** @return Modification time of file or -1 if it does not exist. */
+      static ossim_int64 getModified(const ossimFilename& file);
+
+      ossimFilename m_directory;
+   };
+};
+
+#endif
@@ -0,0 +1,147 @@
+//*******************************************************************
+//
+// License:  MIT
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description:
+//
+// Contains class declaration for ossimNitfJpegBlockIndex.
+//
+//*******************************************************************
+
+#ifndef ossimNitfJpegBlockIndex_HEADER
+#define ossimNitfJpegBlockIndex_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimIosFwd.h>
+#include <string>
+#include <vector>
+
+class ossimNitfImageHeader;
+
+/**
+ * @class ossimNitfJpegBlockIndex
+ *
+ * Offsets and sizes of the jpeg blocks of a C3 or M3 compressed nitf image
+ * segment.  Blocks are variable length, so their offsets must be found
+ * before the first one can be read.
+ *
+ * - For M3 the offsets come from the block mask and no image data is read
+ *   except for the end of the last block.
+ * - For C3 the image data is split into chunks scanned on several threads.
+ *   Each thread collects the start of image markers in its chunk whose
+ *   marker segments parse up to a start of scan.  Marker candidates inside
+ *   the headers of a block are then dropped in a sequential pass, which
+ *   needs no further reads.
+ * - The result can be written to a small index file and read back on the
+ *   next open, so the scan is only done once per image.  The file records
+ *   the image size and modification time and is only used while both match.
+ */
+class OSSIM_DLL ossimNitfJpegBlockIndex
+{
+public:
+   ossimNitfJpegBlockIndex();
+
+   void clear();
+
+   /**
+    * @brief Builds the index from the block mask of hdr.
+    *
+    * Masked blocks get a size of zero.
+    *
+    * @param in Stream of the image, only read for the end of the last block.
+    * @param hdr Image header with block mask records.
+    * @return true on success.
+    */
+   bool buildFromBlockMask(ossim::istream& in, const ossimNitfImageHeader& hdr);
+
+   /**
+    * @brief Scans the image data for the blocks.
+    *
+    * @param connectionString Image to scan.  Each thread opens its own
+    * stream on it.
+    * @param start Offset of the first block.
+    * @param numberOfBlocks Blocks to find.
+    * @param numberOfThreads Threads to scan with.
+    * @return true if all blocks were found.
+    */
+   bool scan(const std::string& connectionString,
+             std::streamoff start,
+             ossim_uint32 numberOfBlocks,
+             ossim_uint32 numberOfThreads);
+
+   /**
+    * @brief Reads an index written by write().
+    * @return true if indexFile was written for imageFile as it is now, with
+    * the same start and number of blocks.
+    */
+   bool read(const ossimFilename& indexFile,
+             const ossimFilename& imageFile,
+             std::streamoff start,
+             ossim_uint32 numberOfBlocks);
+
+   /**
+    * @brief Writes the index.  The file is written to a temporary name and
+    * renamed so readers never see a partial index.
+    * @return true on success.
+    */
+   bool write(const ossimFilename& indexFile, const ossimFilename& imageFile) const;
+
+   ossim_uint32 getNumberOfBlocks() const;
+
+   /**
+    * @brief Moves the index into offsets and sizes, leaving it empty.
+    */
+   void release(std::vector<std::streamoff>& offsets, std::vector<ossim_uint32>& sizes);
+
+private:
+   class ScanJob;
+
+   /** Start of image marker found by a scan thread. */
+   struct Candidate
+   {
+      std::streamoff m_soi;
+      std::streamoff m_headerEnd; // End of the start of scan segment.
+   };
+
+   /** Candidates of one chunk. */
+   struct ChunkResult
+   {
+      ChunkResult() : m_candidates(), m_status(true) {}
+      std::vector<Candidate> m_candidates;
+      bool                   m_status;
+   };
+
+   /**
+    * @brief Parses the marker segments after the start of image at soi.
+    * @param headerEnd Initialized with the end of the start of scan segment.
+    * @return false if they do not parse up to a start of scan.
+    */
+   static bool parseHeaders(ossim::istream& in,
+                            std::streamoff soi,
+                            std::streamoff& headerEnd);
+
+   /**
+    * @brief Finds the end of the block starting at soi.
+    * @param end Initialized with the offset past its end of image marker.
+    * @return true on success.
+    */
+   static bool findEndOfImage(ossim::istream& in, std::streamoff soi, std::streamoff& end);
+
+   /**
+    * @brief Scans [begin, end) for start of image markers.  Called by ScanJob.
+    * @return false if the image could not be opened.
+    */
+   static bool scanRange(const std::string& connectionString,
+                         std::streamoff begin,
+                         std::streamoff end,
+                         std::vector<Candidate>& candidates);
+
+   std::streamoff              m_start;
+   std::vector<std::streamoff> m_offsets;
+   std::vector<ossim_uint32>   m_sizes;
+};
+
+#endif /* #ifndef ossimNitfJpegBlockIndex_HEADER */
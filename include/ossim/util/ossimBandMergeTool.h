@@ -29,6 +29,11 @@ public:
 
    virtual ossimString getClassName() const { return "ossimBandMergeUtil"; }
 
+   /** Resets the tool to its constructed state. */
+   virtual void clear();
+
+   virtual bool isReusable() const { return true; }
+
    virtual void getKwlTemplate(ossimKeywordlist& kwl);
 
    virtual bool execute();
@@ -53,7 +53,8 @@ public:
 
    virtual void setUsage(ossimArgumentParser& ap);
 
-   /** Disconnects and clears the dem and image layers. */
+   /** Disconnects and clears the dem and image layers, and resets the product settings to those
+    * of a new tool. Derived classes reset their own members and call this. */
    virtual void clear();
    
    /** Initial method to be ran prior to execute. Intended for command-line app usage.
@@ -45,6 +45,8 @@ public:
 
    virtual ossimString getClassName() const { return "ossimHillshadeUtil"; }
 
+   virtual bool isReusable() const { return true; }
+
    /** Used by ossimUtilityFactory */
    static const char* DESCRIPTION;
 
@@ -46,6 +46,11 @@ public:
 
    virtual ossimString getClassName() const { return "ossimHlzUtil"; }
 
+   /** Resets the tool to its constructed state. */
+   virtual void clear();
+
+   virtual bool isReusable() const { return true; }
+
    /** Used by ossimUtilityFactory */
    static const char* DESCRIPTION;
 
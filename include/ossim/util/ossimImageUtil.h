@@ -26,6 +26,7 @@
 #include <ossim/imaging/ossimOverviewBuilderBase.h>
 #include <ostream>
 #include <vector>
+#include <condition_variable>
 #include <mutex>
 
 class ossimArgumentParser;
@@ -252,6 +253,18 @@ public:
    /** @return Histogram mode or OSSIM_HISTO_MODE_UNKNOWN if not set. */
    ossimHistogramMode getHistogramMode() const;
 
+   /**
+    * @brief Sets the number of threads each histogram made by createHistogram
+    * is computed with, keyword HISTOGRAM_THREADS_KW.
+    *
+    * This is per file, so files walked on several threads use threads times
+    * this.
+    *
+    * @param threads If not set the ossimImageHistogramSource default is used.
+    */
+   void setNumberOfHistogramThreads( ossim_uint32 threads );
+   void setNumberOfHistogramThreads( const std::string& threads );
+
    /**
     * @brief Sets scan for min/max flag keyword SCAN_MIN_MAX_KW used by
     * processFile method.
@@ -383,6 +396,19 @@ public:
    void setNumberOfThreads( ossim_uint32 threads );
    void setNumberOfThreads( const std::string& threads );
 
+   /**
+    * @brief Sets the memory budget, keyword MEMORY_BUDGET_KW, of the files
+    * processed at the same time.
+    *
+    * Each file is admitted when its estimated memory fits in what is left
+    * of the budget, so large images run on fewer threads than small ones.
+    * A file is always admitted when no other file is running.
+    *
+    * @param megabytes Zero, the default, for no budget.
+    */
+   void setMemoryBudget( ossim_uint32 megabytes );
+   void setMemoryBudget( const std::string& megabytes );
+
    /** @return The list of filtered out files. */
    const std::vector<std::string>& getFilteredImages() const;
 
@@ -423,11 +449,18 @@ private:
                        bool& consumedHistogramOptions,
                        bool& consumedCmmOptions);
 
+   /**
+    * @brief Creates overview for entry.
+    *
+    * consumedHistogramOptions and consumedCmmOptions are set to false if the
+    * entry already has its overviews, as the builder is then not run.
+    */
    void createOverview(ossimRefPtr<ossimImageHandler>& ih,
                        ossimRefPtr<ossimOverviewBuilderBase>& ob,
                        ossim_uint32 entry,
                        bool useEntryIndex,
-                       bool& consumedHistogramOptions);
+                       bool& consumedHistogramOptions,
+                       bool& consumedCmmOptions);
 
    void createThumbnail(ossimRefPtr<ossimImageHandler> &ih);
 
@@ -444,11 +477,22 @@ private:
                        ossim_uint32 entry,
                        bool useEntryIndex);
 
-   void computeMinMax(ossimRefPtr<ossimImageHandler>& ih);
-
+   /**
+    * @brief Scans for min, max and writes the dot omd file of each entry.
+    *
+    * @param histogramFlag If true, and a normal mode histogram is wanted,
+    * the histogram is populated from the same tiles as the scan and written
+    * along with the dot omd.  consumedHistogramOptions is then set to true.
+    */
    void computeMinMax(ossimRefPtr<ossimImageHandler>& ih,
+                      bool histogramFlag,
+                      bool& consumedHistogramOptions);
+
+   /** @return true if the histogram of entry was written. */
+   bool computeMinMax(ossimRefPtr<ossimImageHandler>& ih,
                       ossim_uint32 entry,
-                      bool useEntryIndex);
+                      bool useEntryIndex,
+                      bool histogramFlag);
    
    /** @brief Initializes arg parser and outputs usage. */
    void usage(ossimArgumentParser& ap);
@@ -475,6 +519,54 @@ private:
     */
    ossim_uint32 getNumberOfThreads() const;
 
+   /**
+    * @return Threads to compute a histogram with, or 0 if HISTOGRAM_THREADS_KW
+    * is not found.
+    */
+   ossim_uint32 getNumberOfHistogramThreads() const;
+
+   /**
+    * @return Memory budget in bytes from MEMORY_BUDGET_KW, else the
+    * preference "ossim.util.image_util.memory_budget" in megabytes, else 0
+    * for no budget.
+    */
+   ossim_uint64 getMemoryBudget() const;
+
+   /**
+    * @return Estimate of the memory needed to process ih.  This is a row of
+    * full resolution tiles, read and reduced, plus the histogram bins.
+    */
+   ossim_uint64 getMemoryEstimate( ossimImageHandler* ih ) const;
+
+   /**
+    * @brief Blocks until bytes fit in the memory budget, then adds them to
+    * m_memoryInUse.
+    * @return Bytes taken, to be passed to releaseMemory.  Zero if there is
+    * no budget.
+    */
+   ossim_uint64 acquireMemory( ossim_uint64 bytes );
+
+   /** @brief Returns bytes taken by acquireMemory to the budget. */
+   void releaseMemory( ossim_uint64 bytes );
+
+   /**
+    * @brief Takes memory from the budget with acquireMemory and returns it
+    * when it goes out of scope, so an exception in processFile does not
+    * leave the budget short.
+    */
+   class MemoryReservation
+   {
+   public:
+      MemoryReservation( ossimImageUtil* util, ossim_uint64 bytes );
+      ~MemoryReservation();
+   private:
+      MemoryReservation( const MemoryReservation& );
+      const MemoryReservation& operator=( const MemoryReservation& );
+
+      ossimImageUtil* m_util;
+      ossim_uint64    m_bytes;
+   };
+
    /** @return the next writer prop index. */
    ossim_uint32 getNextWriterPropIndex() const;
 
@@ -533,6 +625,12 @@ private:
    ossimFileWalker*   m_fileWalker;
    std::mutex m_mutex;
 
+   /** Signaled when memory is returned to the budget. */
+   std::condition_variable m_memoryCondition;
+
+   /** Estimated bytes of the files being processed, guarded by m_mutex. */
+   ossim_uint64 m_memoryInUse;
+
    ossim_int32 m_errorStatus;
 
    /** Hold images we never want to process. */
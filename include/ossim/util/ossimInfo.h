@@ -75,6 +75,11 @@ public:
 
    virtual ossimString getClassName() const { return "ossimInfo"; }
 
+   /** Resets the tool to its constructed state. */
+   virtual void clear();
+
+   virtual bool isReusable() const { return true; }
+
    /**
     * @brief handles image options.
     *
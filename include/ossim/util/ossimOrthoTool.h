@@ -47,6 +47,8 @@ public:
 
    virtual ossimString getClassName() const { return "ossimOrthoUtil"; }
 
+   virtual bool isReusable() const { return true; }
+
    /** Used by ossimUtilityFactory */
    static const char* DESCRIPTION;
 
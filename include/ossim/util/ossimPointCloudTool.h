@@ -36,6 +36,11 @@ public:
    void saveJSON(Json::Value& json) const override;
    virtual bool execute() override;
 
+   /** Resets the tool to its constructed state. */
+   virtual void clear() override;
+
+   virtual bool isReusable() const override { return true; }
+
 protected:
    bool initialize();
    void setGSD(const double& meters_per_pixel);
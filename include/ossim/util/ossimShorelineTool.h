@@ -50,6 +50,11 @@ public:
 
    virtual ossimString getClassName() const { return "ossimShorelineUtil"; }
 
+   /** Resets the tool to its constructed state. */
+   virtual void clear();
+
+   virtual bool isReusable() const { return true; }
+
    /** Used by ossimUtilityFactory */
    static const char* DESCRIPTION;
 
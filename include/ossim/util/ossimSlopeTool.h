@@ -47,6 +47,8 @@ public:
 
    virtual ossimString getClassName() const { return "ossimSlopeUtil"; }
 
+   virtual bool isReusable() const { return true; }
+
    /** Used by ossimUtilityFactory */
    static const char* DESCRIPTION;
 
@@ -56,6 +56,11 @@ public:
 
    virtual ossimString getClassName() const { return "ossimSubImageTool"; }
 
+   /** Resets the tool to its constructed state. */
+   virtual void clear();
+
+   virtual bool isReusable() const { return true; }
+
    /** Used by ossimUtilityFactory */
    static const char* DESCRIPTION;
 
@@ -76,6 +76,12 @@ public:
     */
    virtual void clear();
 
+   /**
+    * Returns true when clear() puts the tool back in its constructed state, so that one instance
+    * can be initialized and executed again for another request (see ossimToolServer).
+    */
+   virtual bool isReusable() const { return false; }
+
    /**
     * Kills current (asynchronous) process. Defaults to do nothing.
     */
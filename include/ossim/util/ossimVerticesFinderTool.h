@@ -31,6 +31,11 @@ public:
 
    virtual ossimString getClassName() const { return "ossimVerticesFinderUtil"; }
 
+   /** Resets the tool to its constructed state. */
+   virtual void clear();
+
+   virtual bool isReusable() const { return true; }
+
    virtual void getKwlTemplate(ossimKeywordlist& kwl);
 
    /** Used by ossimUtilityFactory */
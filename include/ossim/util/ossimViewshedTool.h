@@ -55,6 +55,8 @@ public:
    /** Disconnects and clears the DEM and image layers. Leaves OSSIM initialized. */
    virtual void clear();
 
+   virtual bool isReusable() const { return true; }
+
    virtual ossimString getClassName() const { return "ossimViewshedUtil"; }
 
    /** Used by ossimUtilityFactory */
@@ -80,6 +82,7 @@ protected:
    virtual void initializeAOI();
    void paintReticle();
    void initRadials();
+   void deleteRadials();
    bool writeHorizonProfile();
    void computeRadius();
    bool optimizeFOV();
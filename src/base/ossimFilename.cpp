@@ -20,16 +20,21 @@
 #include <ossim/base/ossimStreamFactoryRegistry.h>
 
 
+#include <chrono>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <functional>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <thread>
 using namespace std;
 
 #if defined(_WIN32)
 #  include <io.h>
+#  include <process.h>
 #  include <direct.h>
 #  include <sys/utime.h>
 #  include <windows.h>
@@ -1260,6 +1265,20 @@ bool ossimFilename::rename(const ossimFilename& destFile, bool overwriteDestinat
    }
    return result;
 }
+
+ossimFilename ossimFilename::getUniqueTempFilename()const
+{
+#if defined(_WIN32)
+   const ossim_int64 PID = (ossim_int64)_getpid();
+#else
+   const ossim_int64 PID = (ossim_int64)getpid();
+#endif
+   std::ostringstream name;
+   name << *this << "." << PID << "."
+        << std::hash<std::thread::id>()(std::this_thread::get_id()) << "."
+        << std::chrono::steady_clock::now().time_since_epoch().count() << ".tmp";
+   return ossimFilename(name.str());
+}
    
 bool ossimFilename::remove()const
 {
@@ -13,6 +13,9 @@
 //*****************************************************************************
 
 #include <ossim/base/ossimGeoid.h>
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimGpt.h>
+#include <vector>
 
 RTTI_DEF2(ossimGeoid, "ossimGeoid", ossimObject, ossimErrorStatusInterface)
 RTTI_DEF1(ossimIdentityGeoid, "ossimIdentityGeoid", ossimGeoid)
@@ -25,3 +28,23 @@ ossimGeoid::ossimGeoid()
 
 ossimGeoid::~ossimGeoid()
 {}
+
+void ossimGeoid::offsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count, double* offsets)
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+      offsets[i] = offsetFromEllipsoid(gpts[i]);
+}
+
+void ossimGeoid::offsetsFromEllipsoidGrid(const ossimDpt& origin, const ossimDpt& spacing,
+                                          ossim_uint32 cols, ossim_uint32 rows, double* offsets)
+{
+   std::vector<ossimGpt> row(cols);
+   for (ossim_uint32 r = 0; r < rows; ++r)
+   {
+      const double LAT = origin.y + r * spacing.y;
+      for (ossim_uint32 c = 0; c < cols; ++c)
+         row[c] = ossimGpt(LAT, origin.x + c * spacing.x);
+      if (cols)
+         offsetsFromEllipsoid(&row.front(), cols, offsets + r * cols);
+   }
+}
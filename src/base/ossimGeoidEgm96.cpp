@@ -14,8 +14,23 @@
 #include <ossim/base/ossimEndian.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/base/ossimNotifyContext.h>
+#include <ossim/base/ossimDatum.h>
 #include <ossim/base/ossimDatumFactory.h>
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimPreferences.h>
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 static ossimTrace traceDebug ("ossimGeoidEgm96:debug");
 
@@ -27,22 +42,111 @@ static ossimTrace traceDebug ("ossimGeoidEgm96:debug");
 #define NumbGeoidElevs NumbGeoidCols * NumbGeoidRows
 // #define PI              3.14159265358979323e0
 
+/** Size of a grid file, header included. */
+static const ossim_int64 GRID_FILE_SIZE = (NumbHeaderItems + NumbGeoidElevs) * 4;
+
+/** @return true if header holds the bounds and spacing of the egm96 grid. */
+static bool isValidHeader(const float* header)
+{
+   return ( ossim::almostEqual(header[0], (float)-90.0) &&
+            ossim::almostEqual(header[1], (float)90.0) &&
+            ossim::almostEqual(header[2], (float)0.0) &&
+            ossim::almostEqual(header[3], (float)360.0) &&
+            ossim::almostEqual(header[4], (float)(1.0 / ScaleFactor)) &&
+            ossim::almostEqual(header[5], (float)(1.0 / ScaleFactor)) );
+}
+
+/**
+ * Western post and weight of the column of lon.
+ * @return false if lon is out of range.
+ */
+static inline bool geoidColumn(double lon, long& post, double& delta)
+{
+   // Check for wrap.
+   if (lon < -180.0)
+   {
+      lon = lon + 360.0;
+   }
+   else if (lon > 180.0)
+   {
+      lon = lon - 360.0;
+   }
+   if ( !( (lon >= -180.0) && (lon <= 180.0) ) )
+   {
+      return false; // Out of range or nan.
+   }
+
+   double offsetX = ( lon < 0.0 ) ? ( lon + 360.0 ) * ScaleFactor : lon * ScaleFactor;
+   double postX = floor( offsetX );
+   if ((postX + 1) == NumbGeoidCols)
+      postX--;
+   post  = (long)postX;
+   delta = offsetX - postX;
+   return true;
+}
+
+/**
+ * Northern post and weight of the row of lat.  Row 0 is the north edge.
+ * @return false if lat is out of range.
+ */
+static inline bool geoidRow(double lat, long& post, double& delta)
+{
+   // Check for wrap.
+   if (lat < -90.0)
+   {
+      lat = -180.0 - lat;
+   }
+   else if (lat > 90.0)
+   {
+      lat = 180.0 - lat;
+   }
+   if ( !( (lat >= -90.0) && (lat <= 90.0) ) )
+   {
+      return false; // Out of range or nan.
+   }
+
+   double offsetY = ( 90.0 - lat ) * ScaleFactor;
+   double postY = floor( offsetY );
+   if ((postY + 1) == NumbGeoidRows)
+      postY--;
+   post  = (long)postY;
+   delta = offsetY - postY;
+   return true;
+}
+
+/** Bilinear interpolation between the posts of north and the row below it. */
+static inline double geoidBilinear(const float* north, long postX, double deltaX, double deltaY)
+{
+   const float* south = north + NumbGeoidCols;
+   double elevationNW = north[postX];
+   double elevationNE = north[postX + 1];
+   double elevationSW = south[postX];
+   double elevationSE = south[postX + 1];
+
+   double upperY = elevationNW + deltaX * ( elevationNE - elevationNW );
+   double lowerY = elevationSW + deltaX * ( elevationSE - elevationSW );
+   return upperY + deltaY * ( lowerY - upperY );
+}
+
 
 RTTI_DEF1(ossimGeoidEgm96, "ossimGeoidEgm96", ossimGeoid)
 
 ossimGeoidEgm96::ossimGeoidEgm96()
-   :theGeoidHeightBufferPtr(0)
+   :theGeoidHeightBufferPtr(0),
+    theMappedGrid()
 {
 }
 
 ossimGeoidEgm96::ossimGeoidEgm96(const ossimFilename& grid_file,
                                  ossimByteOrder byteOrder)
-   :theGeoidHeightBufferPtr(0)
+   :theGeoidHeightBufferPtr(0),
+    theMappedGrid()
 {
    open(grid_file, byteOrder);
    if (getErrorStatus() != ossimErrorCodes::OSSIM_OK)
    {
       theGeoidHeightBuffer.clear();
+      theGeoidHeightBufferPtr = 0;
    }
 }
 
@@ -65,16 +169,8 @@ bool ossimGeoidEgm96::open(const ossimFilename& grid_file,
       ossimNotify(ossimNotifyLevel_DEBUG) << MODULE << " Entered...\n";
    }
 
-   if(theGeoidHeightBuffer.size() != NumbGeoidElevs)
-   {
-      theGeoidHeightBuffer.resize(NumbGeoidElevs);
-      theGeoidHeightBufferPtr = &theGeoidHeightBuffer.front();
-   }
-   
-   // int   ItemsRead = 0;
-   long  ElevationsRead = 0;
-   // long  ItemsDiscarded = 0;
-   long  num = 0;
+   theMappedGrid.reset();
+   theGeoidHeightBufferPtr = 0;
 
    ossimFilename grid = grid_file;
    if (grid_file.isDir())
@@ -86,7 +182,36 @@ bool ossimGeoidEgm96::open(const ossimFilename& grid_file,
    {
       ossimNotify(ossimNotifyLevel_DEBUG) << MODULE << " Grid file:" << grid << "\n";
    }
+
+   if ( mapGrid(grid, byteOrder) )
+   {
+      if (traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "Mapped geoid grid:  " << grid.c_str() << std::endl;
+      }
+      return true;
+   }
+
+   // mapGrid may have read it already for a native copy it could not write.
+   return theGeoidHeightBufferPtr ? true : readGrid(grid, byteOrder);
+}
+
+bool ossimGeoidEgm96::readGrid(const ossimFilename& grid,
+                               ossimByteOrder byteOrder)
+{
+   static const char MODULE[] = "ossimGeoidEgm96::readGrid";
+
+   if(theGeoidHeightBuffer.size() != NumbGeoidElevs)
+   {
+      theGeoidHeightBuffer.resize(NumbGeoidElevs);
+   }
    
+   // int   ItemsRead = 0;
+   long  ElevationsRead = 0;
+   // long  ItemsDiscarded = 0;
+   long  num = 0;
+
    // Open the File READONLY, or Return Error Condition:
    std::ifstream gridHeightFile(grid.c_str(), std::ios::in|std::ios::binary);
 //   FILE* GeoidHeightFile;
@@ -114,13 +239,7 @@ bool ossimGeoidEgm96::open(const ossimFilename& grid_file,
       ++num;
    }
    // Determine if header read properly, or NOT:
-   if ((!ossim::almostEqual(theGeoidHeightBuffer[0], (float)-90.0)) ||
-       (!ossim::almostEqual(theGeoidHeightBuffer[1], (float)90.0)) ||
-       (!ossim::almostEqual(theGeoidHeightBuffer[2], (float)0.0)) ||
-       (!ossim::almostEqual(theGeoidHeightBuffer[3],(float)360.0))||
-       (!ossim::almostEqual(theGeoidHeightBuffer[4],(float)(1.0 / ScaleFactor ))) ||
-       (!ossim::almostEqual(theGeoidHeightBuffer[5],(float)( 1.0 / ScaleFactor ))) ||
-       gridHeightFile.fail())
+   if (!isValidHeader(&theGeoidHeightBuffer.front()) || gridHeightFile.fail())
    {
       if(traceDebug())
       {
@@ -152,12 +271,14 @@ bool ossimGeoidEgm96::open(const ossimFilename& grid_file,
    if (ElevationsRead != NumbGeoidElevs)
    {
       setErrorStatus();
-      ossimSetError("ossimGeoidEgm96::open",
+      ossimSetError("ossimGeoidEgm96::readGrid",
                     ossimErrorCodes::OSSIM_ERROR,
                     "Bad grid file...%s", grid.c_str());
      return false;
   }
 
+   theGeoidHeightBufferPtr = &theGeoidHeightBuffer.front();
+
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -167,15 +288,106 @@ bool ossimGeoidEgm96::open(const ossimFilename& grid_file,
    return true;
 }
 
-double ossimGeoidEgm96::offsetFromEllipsoid(const ossimGpt& gpt)
+bool ossimGeoidEgm96::mapGrid(const ossimFilename& grid,
+                              ossimByteOrder byteOrder)
 {
-   double offset = ossim::nan();
-   ossimGpt savedGpt = gpt;
-   if(ossimDatumFactory::instance()->wgs84())
+#if defined(_WIN32)
+   return false;
+#else
+   ossimFilename mapFile = grid;
+   if ( byteOrder != ossim::byteOrder() )
    {
-      savedGpt.changeDatum(ossimDatumFactory::instance()->wgs84());
+      ossimFilename dir = ossimPreferences::instance()->
+         findPreference("geoid_egm_96_grid.native_cache_directory");
+      if ( dir.empty() )
+      {
+         return false;
+      }
+      dir = dir.expand();
+      mapFile = dir.dirCat( (ossim::byteOrder() == OSSIM_LITTLE_ENDIAN) ?
+                            "egm96_le.grd" : "egm96_be.grd" );
+
+      if ( mapFile.fileSize() != GRID_FILE_SIZE )
+      {
+         // Written once, then every process maps it.
+         if ( !readGrid(grid, byteOrder) )
+         {
+            return false;
+         }
+         if ( !dir.exists() )
+         {
+            dir.createDirectory(true);
+         }
+
+         const float HEADER[NumbHeaderItems] =
+            { -90.0, 90.0, 0.0, 360.0, 1.0 / ScaleFactor, 1.0 / ScaleFactor };
+         ossimFilename tmpFile = mapFile.getUniqueTempFilename();
+         std::ofstream os(tmpFile.c_str(), std::ios::out|std::ios::binary);
+         os.write((const char*)HEADER, sizeof(HEADER));
+         os.write((const char*)&theGeoidHeightBuffer.front(), NumbGeoidElevs * 4);
+         os.close();
+         if ( os.fail() || ( std::rename(tmpFile.c_str(), mapFile.c_str()) != 0 ) )
+         {
+            tmpFile.remove();
+            if (traceDebug())
+            {
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << "ossimGeoidEgm96::mapGrid WARNING: could not write "
+                  << mapFile << std::endl;
+            }
+            return false;
+         }
+      }
    }
-   
+
+   // Instances on the same file share one mapping.
+   static std::mutex mapMutex;
+   static std::map<std::string, std::weak_ptr<const float> > mappedGrids;
+   std::lock_guard<std::mutex> lock(mapMutex);
+   std::shared_ptr<const float> mapped = mappedGrids[mapFile.string()].lock();
+   if ( !mapped )
+   {
+      int fd = ::open(mapFile.c_str(), O_RDONLY);
+      if ( fd < 0 )
+      {
+         return false;
+      }
+      void* data = MAP_FAILED;
+      struct stat sbuf;
+      if ( ( fstat(fd, &sbuf) == 0 ) && ( sbuf.st_size >= GRID_FILE_SIZE ) )
+      {
+         data = mmap(0, GRID_FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+      }
+      ::close(fd);
+      if ( data == MAP_FAILED )
+      {
+         return false;
+      }
+      if ( !isValidHeader( static_cast<const float*>(data) ) )
+      {
+         munmap(data, GRID_FILE_SIZE);
+         return false;
+      }
+      mapped.reset( static_cast<const float*>(data),
+                    [](const float* p) { munmap((void*)p, GRID_FILE_SIZE); } );
+      mappedGrids[mapFile.string()] = mapped;
+   }
+
+   theMappedGrid = mapped;
+   theGeoidHeightBufferPtr = mapped.get() + NumbHeaderItems;
+   std::vector<float>().swap(theGeoidHeightBuffer);
+   return true;
+#endif
+}
+
+bool ossimGeoidEgm96::isMemoryMapped() const
+{
+   return ( theMappedGrid.get() != 0 );
+}
+
+double ossimGeoidEgm96::offsetFromEllipsoid(const ossimGpt& gpt)
+{
+   double offset = ossim::nan();
    if (!theGeoidHeightBufferPtr)
    {
       if(traceDebug())
@@ -187,105 +399,110 @@ double ossimGeoidEgm96::offsetFromEllipsoid(const ossimGpt& gpt)
 
       return offset;
    }
-   
-   long    Index;
-   double DeltaX, DeltaY;
-   double ElevationSE, ElevationSW, ElevationNE, ElevationNW;
-   double LatitudeDD, LongitudeDD;
-   double OffsetX, OffsetY;
-   double PostX, PostY;
-   double UpperY, LowerY;
-
-   LatitudeDD  = savedGpt.latd();
-   
-   // Check for wrap.
-   if (LatitudeDD < -90.0)
+
+   const ossimDatum* wgs84 = ossimDatumFactory::instance()->wgs84();
+   if ( wgs84 && ( gpt.datum() != wgs84 ) )
    {
-      LatitudeDD = -180.0 - LatitudeDD;
+      ossimGpt savedGpt = gpt;
+      savedGpt.changeDatum(wgs84);
+      offset = interpolate(savedGpt.latd(), savedGpt.lond());
    }
-   else if (LatitudeDD > 90.0)
+   else
    {
-      LatitudeDD = 180.0 - LatitudeDD;
+      offset = interpolate(gpt.latd(), gpt.lond());
    }
 
-   if ( (LatitudeDD < -90.0) || LatitudeDD > 90.0)
+   if ( ossim::isnan(offset) && traceDebug() )
    {
-      if(traceDebug())
-      {
-         // Latitude out of range
-         ossimNotify(ossimNotifyLevel_FATAL)
-            << "FATAL: " << "ossimGeoidEgm96::offsetFromEllipsoid, "
-            << "Point out of range:  " << savedGpt << "\n";
-      }
-      return offset;
+      ossimNotify(ossimNotifyLevel_FATAL)
+         << "FATAL: " << "ossimGeoidEgm96::offsetFromEllipsoid, "
+         << "Point out of range:  " << gpt << "\n";
    }
    
-   LongitudeDD = savedGpt.lond();
+   return offset;
+}
 
-   // Check for wrap.
-   if (LongitudeDD < -180)
-   {
-      LongitudeDD = LongitudeDD + 360.0;
-   }
-   else if (LongitudeDD > 180.0)
+void ossimGeoidEgm96::offsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                           double* offsets)
+{
+   if (!theGeoidHeightBufferPtr)
    {
-      LongitudeDD = LongitudeDD - 360.0;
+      std::fill(offsets, offsets + count, ossim::nan());
+      return;
    }
 
-   if ( (LongitudeDD < -180.0) || (LongitudeDD > 180.0) )
+   const ossimDatum* wgs84 = ossimDatumFactory::instance()->wgs84();
+   for (ossim_uint32 i = 0; i < count; ++i)
    {
-      // Longitude out of range
-      if(traceDebug())
+      if ( wgs84 && ( gpts[i].datum() != wgs84 ) )
       {
-         ossimNotify(ossimNotifyLevel_FATAL)
-            << "FATAL: " << "ossimGeoidEgm96::offsetFromEllipsoid, "
-            << "Point out of range:  " << savedGpt << "\n";
+         ossimGpt savedGpt = gpts[i];
+         savedGpt.changeDatum(wgs84);
+         offsets[i] = interpolate(savedGpt.latd(), savedGpt.lond());
+      }
+      else
+      {
+         offsets[i] = interpolate(gpts[i].latd(), gpts[i].lond());
       }
-      return offset;
    }
-   
-   // Compute X and Y Offsets into Geoid Height Array:
-   
-   if (LongitudeDD < 0.0)
+}
+
+void ossimGeoidEgm96::offsetsFromEllipsoidGrid(const ossimDpt& origin,
+                                               const ossimDpt& spacing,
+                                               ossim_uint32 cols, ossim_uint32 rows,
+                                               double* offsets)
+{
+   if (!theGeoidHeightBufferPtr)
    {
-      OffsetX = ( LongitudeDD + 360.0 ) * ScaleFactor;
+      std::fill(offsets, offsets + cols * rows, ossim::nan());
+      return;
    }
-   else
+
+   // Columns are the same on every row:
+   std::vector<long>   postX(cols);
+   std::vector<double> deltaX(cols);
+   std::vector<bool>   validX(cols);
+   for (ossim_uint32 c = 0; c < cols; ++c)
    {
-      OffsetX = LongitudeDD * ScaleFactor;
+      validX[c] = geoidColumn(origin.x + c * spacing.x, postX[c], deltaX[c]);
    }
-   OffsetY = ( 90.0 - LatitudeDD ) * ScaleFactor;
-   
+
+   for (ossim_uint32 r = 0; r < rows; ++r)
+   {
+      double* out = offsets + r * cols;
+      long postY;
+      double deltaY;
+      if ( !geoidRow(origin.y + r * spacing.y, postY, deltaY) )
+      {
+         std::fill(out, out + cols, ossim::nan());
+         continue;
+      }
+
+      const float* north = theGeoidHeightBufferPtr + postY * NumbGeoidCols;
+      for (ossim_uint32 c = 0; c < cols; ++c)
+      {
+         out[c] = validX[c] ? geoidBilinear(north, postX[c], deltaX[c], deltaY) : ossim::nan();
+      }
+   }
+}
+
+double ossimGeoidEgm96::interpolate(double lat, double lon) const
+{
    //---
    // Find Four Nearest Geoid Height Cells for specified Latitude,
    // Longitude;  Assumes that (0,0) of Geoid Height Array is at
    // Northwest corner:
    //---
-   PostX = floor( OffsetX );
-   if ((PostX + 1) == NumbGeoidCols)
-      PostX--;
-   PostY = floor( OffsetY );
-   if ((PostY + 1) == NumbGeoidRows)
-      PostY--;
-   
-   Index = (long)(PostY * NumbGeoidCols + PostX);
-   ElevationNW = theGeoidHeightBufferPtr[ Index ];
-   ElevationNE = theGeoidHeightBufferPtr[ Index+ 1 ];
-   
-   Index = (long)((PostY + 1) * NumbGeoidCols + PostX);
-   ElevationSW = theGeoidHeightBufferPtr[ Index ];
-   ElevationSE = theGeoidHeightBufferPtr[ Index + 1 ];
-   
-   //Perform Bi-Linear Interpolation to compute Height above Ellipsoid:
-   DeltaX = OffsetX - PostX;
-   DeltaY = OffsetY - PostY;
-   
-   UpperY = ElevationNW + DeltaX * ( ElevationNE - ElevationNW );
-   LowerY = ElevationSW + DeltaX * ( ElevationSE - ElevationSW );
-   
-   offset = UpperY + DeltaY * ( LowerY - UpperY );
-   
-   return offset;
+   long postX;
+   long postY;
+   double deltaX;
+   double deltaY;
+   if ( geoidRow(lat, postY, deltaY) && geoidColumn(lon, postX, deltaX) )
+   {
+      return geoidBilinear(theGeoidHeightBufferPtr + postY * NumbGeoidCols,
+                           postX, deltaX, deltaY);
+   }
+   return ossim::nan();
 }
 
 double ossimGeoidEgm96::geoidToEllipsoidHeight(double lat,
@@ -21,8 +21,10 @@
 #include <ossim/base/ossimGeoidNgs.h>
 #include <ossim/base/ossimGeoidEgm96.h>
 #include <ossim/base/ossimGeoidImage.h>
+#include <ossim/base/ossimDpt.h>
 #include <ossim/base/ossimFilename.h>
 #include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimGpt.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimKeyword.h>
 #include <ossim/base/ossimNotifyContext.h>
@@ -30,6 +32,7 @@
 // Define Trace flags for use within this file:
 //***
 #include <ossim/base/ossimTrace.h>
+#include <algorithm>
 static ossimTrace traceExec  ("ossimGeoidManager:exec");
 static ossimTrace traceDebug ("ossimGeoidManager:debug");
 
@@ -325,6 +328,85 @@ double ossimGeoidManager::offsetFromEllipsoid(const ossimGpt& gpt)
    return offset;
 }
 
+void ossimGeoidManager::offsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                             double* offsets)
+{
+   std::fill(offsets, offsets + count, ossim::nan());
+   if ( theGeoidList.empty() )
+      return;
+
+   theGeoidList.front()->offsetsFromEllipsoid(gpts, count, offsets);
+
+   // Indexes of the points still without an offset:
+   std::vector<ossim_uint32> pending;
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      if ( ossim::isnan(offsets[i]) )
+         pending.push_back(i);
+   }
+   resolvePending(gpts, pending, theGeoidList.begin() + 1, offsets);
+}
+
+void ossimGeoidManager::offsetsFromEllipsoidGrid(const ossimDpt& origin,
+                                                 const ossimDpt& spacing,
+                                                 ossim_uint32 cols, ossim_uint32 rows,
+                                                 double* offsets)
+{
+   const ossim_uint32 COUNT = cols * rows;
+   std::fill(offsets, offsets + COUNT, ossim::nan());
+   if ( theGeoidList.empty() )
+      return;
+
+   theGeoidList.front()->offsetsFromEllipsoidGrid(origin, spacing, cols, rows, offsets);
+
+   // Points off the first geoid go through the others one at a time:
+   std::vector<ossim_uint32> pending;
+   for (ossim_uint32 i = 0; i < COUNT; ++i)
+   {
+      if ( ossim::isnan(offsets[i]) )
+         pending.push_back(i);
+   }
+   if ( pending.empty() )
+      return;
+
+   std::vector<ossimGpt> gpts(COUNT);
+   for (ossim_uint32 i = 0; i < (ossim_uint32)pending.size(); ++i)
+   {
+      const ossim_uint32 R = pending[i] / cols;
+      const ossim_uint32 C = pending[i] % cols;
+      gpts[pending[i]] = ossimGpt(origin.y + R * spacing.y, origin.x + C * spacing.x);
+   }
+   resolvePending(&gpts.front(), pending, theGeoidList.begin() + 1, offsets);
+}
+
+void ossimGeoidManager::resolvePending(const ossimGpt* gpts,
+                                       std::vector<ossim_uint32>& pending,
+                                       std::vector< ossimRefPtr<ossimGeoid> >::iterator geoid,
+                                       double* offsets)
+{
+   std::vector<ossimGpt> pendingPts;
+   std::vector<double> pendingOffsets;
+   while ( !pending.empty() && (geoid != theGeoidList.end()) )
+   {
+      ossim_uint32 n = (ossim_uint32)pending.size();
+      pendingPts.resize(n);
+      pendingOffsets.resize(n);
+      for (ossim_uint32 i = 0; i < n; ++i)
+         pendingPts[i] = gpts[pending[i]];
+      (*geoid)->offsetsFromEllipsoid(&pendingPts.front(), n, &pendingOffsets.front());
+
+      ossim_uint32 remaining = 0;
+      for (ossim_uint32 i = 0; i < n; ++i)
+      {
+         offsets[pending[i]] = pendingOffsets[i];
+         if ( ossim::isnan(pendingOffsets[i]) )
+            pending[remaining++] = pending[i];
+      }
+      pending.resize(remaining);
+      ++geoid;
+   }
+}
+
 ossimGeoid* ossimGeoidManager::findGeoidByShortName(const ossimString& shortName, bool caseSensitive)
 {
    ossim_uint32 idx=0;
@@ -1048,6 +1048,41 @@ void ossimHistogram::UpCount(float pixelval, float occurences)
    }
 }
 
+void ossimHistogram::UpCountRange(ossim_int32 firstValue,
+                                  const ossim_uint32* counts,
+                                  ossim_uint32 size)
+{
+   m_statsConsistent = 0;
+   for (ossim_uint32 i = 0; i < size; ++i)
+   {
+      if (counts[i])
+      {
+         int idx = GetIndex((float)(firstValue + (ossim_int32)i));
+         if (idx >= 0)
+         {
+            m_counts[idx] += (float)counts[i];
+         }
+      }
+   }
+}
+
+bool ossimHistogram::addCounts(const ossimHistogram& histo)
+{
+   if ( (histo.m_num != m_num) ||
+        (histo.m_vmin != m_vmin) ||
+        (histo.m_vmax != m_vmax) )
+   {
+      return false;
+   }
+
+   m_statsConsistent = 0;
+   for (int i = 0; i < m_num; ++i)
+   {
+      m_counts[i] += histo.m_counts[i];
+   }
+   return true;
+}
+
 float ossimHistogram::ComputeArea(float low, float high)const
 {
    float sum = 0.0;
@@ -0,0 +1,140 @@
+//---
+//
+// License: MIT
+//
+// Description: Read-only memory mapping of a local file.
+//
+//---
+// $Id$
+
+#include <ossim/base/ossimMemoryMappedFile.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimTrace.h>
+
+#if defined(_WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+static ossimTrace traceDebug("ossimMemoryMappedFile:debug");
+
+ossimMemoryMappedFile::ossimMemoryMappedFile()
+   :
+   m_data(0),
+   m_size(0),
+   m_filename()
+#if defined(_WIN32)
+   ,
+   m_fileHandle(INVALID_HANDLE_VALUE),
+   m_mappingHandle(0)
+#endif
+{
+}
+
+ossimMemoryMappedFile::~ossimMemoryMappedFile()
+{
+   close();
+}
+
+bool ossimMemoryMappedFile::open( const ossimFilename& file )
+{
+   close();
+
+   if ( file.empty() )
+   {
+      return false;
+   }
+
+#if defined(_WIN32)
+   HANDLE fileHandle = CreateFileA( file.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+   if ( fileHandle == INVALID_HANDLE_VALUE )
+   {
+      return false;
+   }
+
+   LARGE_INTEGER fileSize;
+   if ( !GetFileSizeEx( fileHandle, &fileSize ) || ( fileSize.QuadPart == 0 ) )
+   {
+      CloseHandle( fileHandle );
+      return false;
+   }
+
+   HANDLE mappingHandle = CreateFileMappingA( fileHandle, 0, PAGE_READONLY, 0, 0, 0 );
+   if ( !mappingHandle )
+   {
+      CloseHandle( fileHandle );
+      return false;
+   }
+
+   void* addr = MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+   if ( !addr )
+   {
+      CloseHandle( mappingHandle );
+      CloseHandle( fileHandle );
+      return false;
+   }
+
+   m_fileHandle    = fileHandle;
+   m_mappingHandle = mappingHandle;
+   m_size          = static_cast<ossim_uint64>( fileSize.QuadPart );
+   m_data          = static_cast<const ossim_uint8*>( addr );
+#else
+   int fd = ::open( file.c_str(), O_RDONLY );
+   if ( fd < 0 )
+   {
+      return false;
+   }
+
+   struct stat sb;
+   if ( ( fstat( fd, &sb ) != 0 ) || ( sb.st_size <= 0 ) )
+   {
+      ::close( fd );
+      return false;
+   }
+
+   void* addr = mmap( 0, static_cast<size_t>( sb.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+
+   // The mapping holds its own reference to the file so the descriptor is not needed.
+   ::close( fd );
+
+   if ( addr == MAP_FAILED )
+   {
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimMemoryMappedFile::open DEBUG: mmap failed for " << file << std::endl;
+      }
+      return false;
+   }
+
+   m_size = static_cast<ossim_uint64>( sb.st_size );
+   m_data = static_cast<const ossim_uint8*>( addr );
+#endif
+
+   m_filename = file;
+   return true;
+}
+
+void ossimMemoryMappedFile::close()
+{
+   if ( m_data )
+   {
+#if defined(_WIN32)
+      UnmapViewOfFile( m_data );
+      CloseHandle( m_mappingHandle );
+      CloseHandle( m_fileHandle );
+      m_mappingHandle = 0;
+      m_fileHandle    = INVALID_HANDLE_VALUE;
+#else
+      munmap( const_cast<ossim_uint8*>( m_data ), static_cast<size_t>( m_size ) );
+#endif
+      m_data = 0;
+      m_size = 0;
+      m_filename.clear();
+   }
+}
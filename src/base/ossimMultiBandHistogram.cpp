@@ -203,6 +203,31 @@ const ossimRefPtr<ossimHistogram> ossimMultiBandHistogram::getHistogram(ossim_in
    return 0;
 }
 
+bool ossimMultiBandHistogram::addCounts(const ossimMultiBandHistogram& histo)
+{
+   if(histo.theHistogramList.size() != theHistogramList.size())
+   {
+      return false;
+   }
+
+   bool result = true;
+   for(ossim_uint32 idx = 0; idx < theHistogramList.size(); ++idx)
+   {
+      if(theHistogramList[idx].valid() && histo.theHistogramList[idx].valid())
+      {
+         if(!theHistogramList[idx]->addCounts(*histo.theHistogramList[idx]))
+         {
+            result = false;
+         }
+      }
+      else if(theHistogramList[idx].valid() != histo.theHistogramList[idx].valid())
+      {
+         result = false;
+      }
+   }
+   return result;
+}
+
 void ossimMultiBandHistogram::setBinCount(double binNumber, double count)
 {
    if(theHistogramList.size() > 0)
@@ -47,7 +47,11 @@ ossimDtedHandler::ossimDtedHandler(const ossimFilename& dted_file, bool memoryMa
       m_latSpacing(0.0),
       m_lonSpacing(0.0),
       m_swCornerPost(),
-      m_swapBytesFlag(false)
+      m_swapBytesFlag(false),
+      m_memoryMap(),
+      m_memoryCopy(),
+      m_cellBuf(0),
+      m_cellBufSize(0)
 {
 
    static const char MODULE[] = "ossimDtedHandler (Filename) Constructor";
@@ -115,7 +119,7 @@ bool ossimDtedHandler::getAccuracyInfo(ossimElevationAccuracyInfo& info,
 
 double ossimDtedHandler::getHeightAboveMSL(const ossimGpt& gpt)
 {
-   if(m_memoryMap.size())
+   if(m_cellBuf)
    {
       return getHeightAboveMSL(gpt, false);
    }
@@ -189,15 +193,36 @@ bool ossimDtedHandler::open(std::shared_ptr<ossim::istream>& fileStr,
   }
   if(memoryMapFlag)
   {
-    ossim_int64 streamSize;
-    m_fileStr->clear();
-    m_fileStr->seekg(0, std::ios::end);
-    streamSize = m_fileStr->tellg();
-    m_fileStr->seekg(0, std::ios::beg);
-
-    m_memoryMap.resize(streamSize);//theFilename.fileSize());
-    m_fileStr->read((char*)(&m_memoryMap.front()), (std::streamsize)m_memoryMap.size());
-    m_fileStr.reset();
+    // Local files are mapped; the pages are shared with every other handler
+    // (and process) using the same cell.  Other streams are read into memory.
+    ossimFilename localFile(m_connectionString);
+    std::shared_ptr<ossimMemoryMappedFile> mmf = std::make_shared<ossimMemoryMappedFile>();
+    if(localFile.isFile() && mmf->open(localFile))
+    {
+      m_memoryMap   = mmf;
+      m_cellBuf     = m_memoryMap->data();
+      m_cellBufSize = m_memoryMap->size();
+    }
+    else
+    {
+      ossim_int64 streamSize;
+      m_fileStr->clear();
+      m_fileStr->seekg(0, std::ios::end);
+      streamSize = m_fileStr->tellg();
+      m_fileStr->seekg(0, std::ios::beg);
+
+      if(streamSize > 0)
+      {
+        m_memoryCopy.resize(streamSize);
+        m_fileStr->read((char*)(&m_memoryCopy.front()), (std::streamsize)m_memoryCopy.size());
+        m_cellBuf     = &m_memoryCopy.front();
+        m_cellBufSize = m_memoryCopy.size();
+      }
+    }
+    if(m_cellBuf)
+    {
+      m_fileStr.reset();
+    }
   }
 
   m_numLonLines  = m_uhl->numLonLines();
@@ -309,7 +334,13 @@ double ossimDtedHandler::getHeightAboveMSL(const ossimGpt& gpt, bool readFromFil
    }
    else
    {
-     ossim_uint8* buf = &m_memoryMap.front();
+     // Truncated cell:
+     if ( (ossim_uint64)(offset + m_dtedRecordSizeInBytes + 2*POST_SIZE) > m_cellBufSize )
+     {
+       return ossim::nan();
+     }
+
+     const ossim_uint8* buf = m_cellBuf;
      {
        ossim_uint16 us;
 
@@ -410,13 +441,26 @@ double ossimDtedHandler::getPostValue(const ossimIpt& gridPt) const
       m_offsetToFirstDataRecord + gridPt.x * m_dtedRecordSizeInBytes +
       gridPt.y * 2 + DATA_RECORD_OFFSET_TO_POST;
    
-   // Put the file pointer at the start of the first elevation post.
-   m_fileStr->seekg(offset, std::ios::beg);
+   ossim_uint16 us = 0;
+
+   if (m_cellBuf)
+   {
+      if ( (ossim_uint64)(offset + POST_SIZE) > m_cellBufSize )
+      {
+         return ossim::nan();
+      }
+      memcpy(&us, m_cellBuf + offset, POST_SIZE);
+   }
+   else
+   {
+      std::lock_guard<std::mutex> lock( m_fileStrMutex );
 
-   ossim_uint16 us;
+      // Put the file pointer at the start of the first elevation post.
+      m_fileStr->seekg(offset, std::ios::beg);
 
-   // Get the post.
-   m_fileStr->read((char*)&us, POST_SIZE);
+      // Get the post.
+      m_fileStr->read((char*)&us, POST_SIZE);
+   }
    
    return double(convertSignedMagnitude(us));
 }
@@ -456,7 +500,7 @@ void ossimDtedHandler::gatherStatistics()
       theMinHeightAboveMSL = atoi(min_str);
       theMaxHeightAboveMSL = atoi(max_str);
    }
-   else if (theComputeStatsFlag&&!m_memoryMap.size())  // Scan the cell and gather the statistics...
+   else if (theComputeStatsFlag&&!m_cellBuf)  // Scan the cell and gather the statistics...
    {
       if(traceDebug())
       {
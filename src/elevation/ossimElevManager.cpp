@@ -30,10 +30,48 @@
 #include <ossim/elevation/ossimElevationDatabaseRegistry.h>
 #include <ossim/base/ossimKeywordNames.h>
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 
 //ossimElevManager* ossimElevManager::m_instance = 0;
 static ossimTrace traceDebug("ossimElevManager:debug");
 
+namespace
+{
+   //---
+   // Databases whose rectangle touches more buckets than this are kept with the unbounded
+   // ones rather than listed in every bucket, e.g. a global DEM would be 64800 entries.
+   //---
+   const ossim_uint32 MAX_INDEXED_BUCKETS = 4096;
+
+   // Unique across instances so a lookup cached for one manager never matches another.
+   std::atomic<ossim_uint32> s_coverageIndexGeneration(0);
+
+   // Last coverage bucket looked up by this thread.
+   struct CoverageLookup
+   {
+      ossim_uint32                     m_generation;
+      ossim_int32                      m_bucket;
+      const std::vector<ossim_uint32>* m_databases;
+   };
+   thread_local CoverageLookup t_coverageLookup = { 0, 0, 0 };
+
+   // True while this thread rebuilds a coverage index.
+   thread_local bool t_rebuildingCoverageIndex = false;
+
+   inline ossim_int32 coverageRow(ossim_float64 lat)
+   {
+      ossim_int32 row = (ossim_int32)std::floor(lat) + 90;
+      return std::min(std::max(row, 0), 179);
+   }
+
+   inline ossim_int32 coverageCol(ossim_float64 lon)
+   {
+      ossim_int32 col = (ossim_int32)std::floor(lon) + 180;
+      return std::min(std::max(col, 0), 359);
+   }
+}
+
 //---
 // For std::sort of ElevationDatabaseListType
 // e.g.: std::sort( dbList.begin(), dbList.end(), dbSort );
@@ -84,6 +122,12 @@ ossimElevManager::ossimElevManager()
     m_useGeoidIfNullFlag(false),
     m_useStandardPaths(false),
     m_currentDatabaseIdx(0),
+    m_coverageIndex(),
+    m_unboundedDatabases(),
+    m_databaseCoverage(),
+    m_coverageIndexGeneration(++s_coverageIndexGeneration),
+    m_coverageIndexStale(false),
+    m_coverageMutex(),
     m_mutex()
 {
    //---
@@ -106,9 +150,12 @@ double ossimElevManager::getHeightAboveEllipsoid(const ossimGpt& gpt)
       return result;
 
    ElevationDatabaseListType& elevDbList = getNextElevDbList();
-   for (ossim_uint32 idx = 0; (idx < elevDbList.size()) && ossim::isnan(result); ++idx)
+   const std::vector<ossim_uint32>& candidates = getCandidateDatabases(gpt);
+   for (ossim_uint32 i = 0; (i < candidates.size()) && ossim::isnan(result); ++i)
    {
-      result = elevDbList[idx]->getHeightAboveEllipsoid(gpt);
+      const ossim_uint32 idx = candidates[i];
+      if ((idx < elevDbList.size()) && !isOutsideCoverage(idx, gpt))
+         result = elevDbList[idx]->getHeightAboveEllipsoid(gpt);
    }
 
    if (ossim::isnan(result))
@@ -141,9 +188,12 @@ double ossimElevManager::getHeightAboveMSL(const ossimGpt& gpt)
       return result;
 
    ElevationDatabaseListType& elevDbList = getNextElevDbList();
-   for (ossim_uint32 idx = 0; (idx < elevDbList.size()) && ossim::isnan(result); ++idx)
+   const std::vector<ossim_uint32>& candidates = getCandidateDatabases(gpt);
+   for (ossim_uint32 i = 0; (i < candidates.size()) && ossim::isnan(result); ++i)
    {
-      result = elevDbList[idx]->getHeightAboveMSL(gpt);
+      const ossim_uint32 idx = candidates[i];
+      if ((idx < elevDbList.size()) && !isOutsideCoverage(idx, gpt))
+         result = elevDbList[idx]->getHeightAboveMSL(gpt);
    }
 
    if (ossim::isnan(result) && m_useGeoidIfNullFlag)
@@ -168,6 +218,326 @@ double ossimElevManager::getHeightAboveMSL(const ossimGpt& gpt)
    return result;
 }
 
+void ossimElevManager::getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                                ossim_uint32 count,
+                                                double* heights)
+{
+   std::vector<ossim_uint32> unresolved;
+   getDatabaseHeights(true, gpts, count, heights, unresolved);
+
+   if (!unresolved.empty())
+   {
+      // Same fallbacks as getHeightAboveEllipsoid():
+      if (!ossim::isnan(m_defaultHeightAboveEllipsoid))
+      {
+         for (ossim_uint32 i = 0; i < unresolved.size(); ++i)
+            heights[unresolved[i]] = m_defaultHeightAboveEllipsoid;
+      }
+      else if (m_useGeoidIfNullFlag)
+      {
+         std::vector<ossimGpt> pts(unresolved.size());
+         std::vector<double> offsets(unresolved.size());
+         for (ossim_uint32 i = 0; i < unresolved.size(); ++i)
+            pts[i] = gpts[unresolved[i]];
+         ossimGeoidManager::instance()->offsetsFromEllipsoid(&pts.front(),
+                                                             (ossim_uint32)pts.size(),
+                                                             &offsets.front());
+         for (ossim_uint32 i = 0; i < unresolved.size(); ++i)
+            heights[unresolved[i]] = offsets[i];
+      }
+   }
+
+   if (!ossim::isnan(m_elevationOffset))
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (!ossim::isnan(heights[i]))
+            heights[i] += m_elevationOffset;
+      }
+   }
+}
+
+void ossimElevManager::getHeightsAboveMSL(const ossimGpt* gpts,
+                                          ossim_uint32 count,
+                                          double* heights)
+{
+   std::vector<ossim_uint32> unresolved;
+   getDatabaseHeights(false, gpts, count, heights, unresolved);
+
+   if (!unresolved.empty() && m_useGeoidIfNullFlag)
+   {
+      // Same fallbacks as getHeightAboveMSL():
+      if (!ossim::isnan(m_defaultHeightAboveEllipsoid))
+      {
+         std::vector<ossimGpt> pts(unresolved.size());
+         std::vector<double> offsets(unresolved.size());
+         for (ossim_uint32 i = 0; i < unresolved.size(); ++i)
+            pts[i] = gpts[unresolved[i]];
+         ossimGeoidManager::instance()->offsetsFromEllipsoid(&pts.front(),
+                                                             (ossim_uint32)pts.size(),
+                                                             &offsets.front());
+         for (ossim_uint32 i = 0; i < unresolved.size(); ++i)
+         {
+            if (ossim::isnan(offsets[i]))
+               heights[unresolved[i]] = 0.0; // MSL
+            else
+               heights[unresolved[i]] = m_defaultHeightAboveEllipsoid - offsets[i];
+         }
+      }
+      else
+      {
+         for (ossim_uint32 i = 0; i < unresolved.size(); ++i)
+            heights[unresolved[i]] = 0.0; // MSL
+      }
+   }
+
+   if (!ossim::isnan(m_elevationOffset))
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (!ossim::isnan(heights[i]))
+            heights[i] += m_elevationOffset;
+      }
+   }
+}
+
+void ossimElevManager::getHeightsAboveEllipsoid(const ossim_float64* lats,
+                                                const ossim_float64* lons,
+                                                ossim_uint32 count,
+                                                double* heights)
+{
+   std::vector<ossimGpt> gpts(count);
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      gpts[i].lat = lats[i];
+      gpts[i].lon = lons[i];
+   }
+   if (count)
+      getHeightsAboveEllipsoid(&gpts.front(), count, heights);
+}
+
+void ossimElevManager::getHeightsAboveEllipsoid(const ossimGpt& origin,
+                                                ossim_float64 deltaLat,
+                                                ossim_float64 deltaLon,
+                                                ossim_uint32 numLines,
+                                                ossim_uint32 numSamples,
+                                                double* heights)
+{
+   ossim_uint32 count = numLines * numSamples;
+   if (!count)
+      return;
+
+   std::vector<ossimGpt> gpts(count, origin);
+   ossim_uint32 i = 0;
+   for (ossim_uint32 line = 0; line < numLines; ++line)
+   {
+      ossim_float64 lat = origin.lat + line * deltaLat;
+      for (ossim_uint32 samp = 0; samp < numSamples; ++samp, ++i)
+      {
+         gpts[i].lat = lat;
+         gpts[i].lon = origin.lon + samp * deltaLon;
+      }
+   }
+   getHeightsAboveEllipsoid(&gpts.front(), count, heights);
+}
+
+void ossimElevManager::getDatabaseHeights(bool ellipsoidFlag,
+                                          const ossimGpt* gpts,
+                                          ossim_uint32 count,
+                                          double* heights,
+                                          std::vector<ossim_uint32>& unresolved)
+{
+   std::fill(heights, heights + count, ossim::nan());
+   unresolved.clear();
+   if (!count || !isSourceEnabled())
+      return;
+
+   //---
+   // Group the points by coverage bucket so each group is only offered to the databases that
+   // may cover it.  Grids and chips fall in a handful of buckets.
+   //---
+   std::vector< std::pair<ossim_int32, ossim_uint32> > buckets(count);
+   for (ossim_uint32 i = 0; i < count; ++i)
+      buckets[i] = std::make_pair(getCoverageBucket(gpts[i]), i);
+   std::sort(buckets.begin(), buckets.end());
+
+   std::vector<ossim_uint32> group;
+   std::vector<ossim_uint32> pending;
+   std::vector<ossimGpt> pendingPts;
+   std::vector<double> pendingHeights;
+   ElevationDatabaseListType& elevDbList = getNextElevDbList();
+   ossim_uint32 start = 0;
+   while (start < count)
+   {
+      ossim_uint32 end = start + 1;
+      while ((end < count) && (buckets[end].first == buckets[start].first))
+         ++end;
+      group.clear();
+      for (ossim_uint32 i = start; i < end; ++i)
+         group.push_back(buckets[i].second);
+
+      const std::vector<ossim_uint32>& candidates = getCandidateDatabases(gpts[group[0]]);
+      for (ossim_uint32 c = 0; (c < candidates.size()) && !group.empty(); ++c)
+      {
+         const ossim_uint32 idx = candidates[c];
+         if (idx >= elevDbList.size())
+            continue;
+
+         // Only the points inside the database coverage are queried:
+         pending.clear();
+         pendingPts.clear();
+         for (ossim_uint32 i = 0; i < group.size(); ++i)
+         {
+            if (!isOutsideCoverage(idx, gpts[group[i]]))
+            {
+               pending.push_back(group[i]);
+               pendingPts.push_back(gpts[group[i]]);
+            }
+         }
+         if (pending.empty())
+            continue;
+
+         ossim_uint32 n = (ossim_uint32)pending.size();
+         pendingHeights.resize(n);
+         if (ellipsoidFlag)
+            elevDbList[idx]->getHeightsAboveEllipsoid(&pendingPts.front(), n, &pendingHeights.front());
+         else
+            elevDbList[idx]->getHeightsAboveMSL(&pendingPts.front(), n, &pendingHeights.front());
+         for (ossim_uint32 i = 0; i < n; ++i)
+            heights[pending[i]] = pendingHeights[i];
+
+         ossim_uint32 remaining = 0;
+         for (ossim_uint32 i = 0; i < group.size(); ++i)
+         {
+            if (ossim::isnan(heights[group[i]]))
+               group[remaining++] = group[i];
+         }
+         group.resize(remaining);
+      }
+
+      unresolved.insert(unresolved.end(), group.begin(), group.end());
+      start = end;
+   }
+   std::sort(unresolved.begin(), unresolved.end());
+}
+
+const std::vector<ossim_uint32>& ossimElevManager::getCandidateDatabases(
+   const ossimGpt& gpt) const
+{
+   if (m_coverageIndexStale.load(std::memory_order_acquire))
+      rebuildCoverageIndex();
+
+   const ossim_int32 BUCKET = getCoverageBucket(gpt);
+   CoverageLookup& last = t_coverageLookup;
+   if ((last.m_generation != m_coverageIndexGeneration) || (last.m_bucket != BUCKET))
+   {
+      std::unordered_map<ossim_int32, std::vector<ossim_uint32> >::const_iterator i =
+         m_coverageIndex.find(BUCKET);
+      last.m_databases = (i != m_coverageIndex.end()) ? &i->second : &m_unboundedDatabases;
+      last.m_generation = m_coverageIndexGeneration;
+      last.m_bucket = BUCKET;
+   }
+   return *last.m_databases;
+}
+
+inline bool ossimElevManager::isOutsideCoverage(ossim_uint32 idx, const ossimGpt& gpt) const
+{
+   return (idx < m_databaseCoverage.size()) && !m_databaseCoverage[idx].isLonLatNan() &&
+          !m_databaseCoverage[idx].pointWithin(gpt);
+}
+
+ossim_int32 ossimElevManager::getCoverageBucket(const ossimGpt& gpt)
+{
+   if (ossim::isnan(gpt.lat) || ossim::isnan(gpt.lon))
+      return -1; // No bucket, gets the unbounded databases.
+   return coverageRow(gpt.lat) * 360 + coverageCol(gpt.lon);
+}
+
+void ossimElevManager::rebuildCoverageIndex() const
+{
+   //---
+   // Opening a DEM for its rectangle may look up heights on this thread; that lookup uses the
+   // old index instead of waiting on itself.
+   //---
+   if (t_rebuildingCoverageIndex)
+      return;
+
+   std::lock_guard<std::mutex> lock (m_coverageMutex);
+   if (!m_coverageIndexStale.load(std::memory_order_relaxed))
+      return; // Rebuilt by another thread.
+
+   // Gather the rectangles before the old index is cleared:
+   std::vector<ossimGrect> coverage;
+   std::vector<bool> known;
+   if ( m_dbRoundRobin.size() )
+   {
+      t_rebuildingCoverageIndex = true;
+      const ElevationDatabaseListType& elevDbList = m_dbRoundRobin[0];
+      coverage.resize(elevDbList.size());
+      known.resize(elevDbList.size(), false);
+      for (ossim_uint32 idx = 0; idx < elevDbList.size(); ++idx)
+         known[idx] = elevDbList[idx].valid() && elevDbList[idx]->getCoverageRect(coverage[idx]);
+      t_rebuildingCoverageIndex = false;
+   }
+
+   m_coverageIndex.clear();
+   m_unboundedDatabases.clear();
+   m_databaseCoverage.clear();
+
+   if ( coverage.size() )
+   {
+      m_databaseCoverage.swap(coverage);
+      for (ossim_uint32 idx = 0; idx < m_databaseCoverage.size(); ++idx)
+      {
+         ossimGrect& rect = m_databaseCoverage[idx];
+         bool indexed = false;
+         if ( known[idx] && !rect.isLonLatNan() &&
+              (rect.ul().lon <= rect.lr().lon) && (rect.lr().lat <= rect.ul().lat) )
+         {
+            const ossim_int32 MIN_ROW = coverageRow(rect.lr().lat);
+            const ossim_int32 MAX_ROW = coverageRow(rect.ul().lat);
+            const ossim_int32 MIN_COL = coverageCol(rect.ul().lon);
+            const ossim_int32 MAX_COL = coverageCol(rect.lr().lon);
+            if ( (ossim_uint32)((MAX_ROW - MIN_ROW + 1) * (MAX_COL - MIN_COL + 1)) <=
+                 MAX_INDEXED_BUCKETS )
+            {
+               for (ossim_int32 row = MIN_ROW; row <= MAX_ROW; ++row)
+               {
+                  for (ossim_int32 col = MIN_COL; col <= MAX_COL; ++col)
+                     m_coverageIndex[row * 360 + col].push_back(idx);
+               }
+               indexed = true;
+            }
+         }
+         if (!indexed)
+         {
+            rect.makeNan();
+            m_unboundedDatabases.push_back(idx);
+         }
+      }
+
+      // Bucket lists are in list order as idx ascends; keep that when merging:
+      if ( m_unboundedDatabases.size() )
+      {
+         std::vector<ossim_uint32> merged;
+         std::unordered_map<ossim_int32, std::vector<ossim_uint32> >::iterator i =
+            m_coverageIndex.begin();
+         while (i != m_coverageIndex.end())
+         {
+            merged.resize(i->second.size() + m_unboundedDatabases.size());
+            std::merge(i->second.begin(), i->second.end(),
+                       m_unboundedDatabases.begin(), m_unboundedDatabases.end(),
+                       merged.begin());
+            i->second.swap(merged);
+            ++i;
+         }
+      }
+   }
+
+   m_coverageIndexGeneration = ++s_coverageIndexGeneration;
+   m_coverageIndexStale.store(false, std::memory_order_release);
+}
+
 void ossimElevManager::loadStandardElevationPaths()
 {
    if (!m_useStandardPaths)
@@ -354,6 +724,7 @@ void ossimElevManager::clear()
       i->clear();
       ++i;
    }
+   m_coverageIndexStale = true;
 }
 
 void ossimElevManager::accept(ossimVisitor& visitor)
@@ -384,9 +755,12 @@ void ossimElevManager::accept(ossimVisitor& visitor)
 bool ossimElevManager::getAccuracyInfo(ossimElevationAccuracyInfo& info, const ossimGpt& gpt) const
 {
    ElevationDatabaseListType& elevDbList = getNextElevDbList();
-   for(ossim_uint32 idx = 0;(idx < elevDbList.size()); ++idx)
+   const std::vector<ossim_uint32>& candidates = getCandidateDatabases(gpt);
+   for(ossim_uint32 i = 0;(i < candidates.size()); ++i)
    {
-      if(elevDbList[idx]->getAccuracyInfo(info, gpt))
+      const ossim_uint32 idx = candidates[i];
+      if((idx < elevDbList.size()) && !isOutsideCoverage(idx, gpt) &&
+         elevDbList[idx]->getAccuracyInfo(info, gpt))
       {
          return true;
       }
@@ -400,9 +774,12 @@ bool ossimElevManager::pointHasCoverage(const ossimGpt& gpt) const
    if ( m_dbRoundRobin.size() )
    {
       ElevationDatabaseListType& elevDbList = m_dbRoundRobin[0];
-      for(ossim_uint32 idx = 0;(idx < elevDbList.size()); ++idx)
+      const std::vector<ossim_uint32>& candidates = getCandidateDatabases(gpt);
+      for(ossim_uint32 i = 0;(i < candidates.size()); ++i)
       {
-         if(elevDbList[idx]->pointHasCoverage(gpt))
+         const ossim_uint32 idx = candidates[i];
+         if((idx < elevDbList.size()) && !isOutsideCoverage(idx, gpt) &&
+            elevDbList[idx]->pointHasCoverage(gpt))
          {
             return true;
          }
@@ -624,6 +1001,8 @@ void ossimElevManager::addDatabase(ossimElevationDatabase* database, bool set_as
             rri->push_back(dupDb);
          ++rri;
       }
+
+      m_coverageIndexStale = true;
    }
 }
 
@@ -652,7 +1031,9 @@ std::ostream& ossimElevManager::print(ostream& out) const
          << "\nm_elevationOffset = "<<m_elevationOffset
          << "\nm_useGeoidIfNullFlag = "<<m_useGeoidIfNullFlag
          << "\nm_currentDatabaseIdx = "<<m_currentDatabaseIdx
-         << "\nm_dbRoundRobin.size = "<<m_dbRoundRobin.size();
+         << "\nm_dbRoundRobin.size = "<<m_dbRoundRobin.size()
+         << "\ncoverage buckets = "<<m_coverageIndex.size()
+         << "\nunbounded databases = "<<m_unboundedDatabases.size();
    for (ossim_uint32 i=0; i<m_dbRoundRobin.size(); ++i)
    {
       out<<"\nm_dbRoundRobin["<<i<<"].size = "<<m_dbRoundRobin[i].size()<<endl;
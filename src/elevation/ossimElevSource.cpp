@@ -102,6 +102,20 @@ double ossimElevSource::getHeightAboveEllipsoid(const ossimGpt& /* argGpt */)
    return theNullHeightValue;
 }
 
+void ossimElevSource::getHeightsAboveMSL(const ossimGpt* gpts, ossim_uint32 count,
+                                         double* heights)
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+      heights[i] = getHeightAboveMSL(gpts[i]);
+}
+
+void ossimElevSource::getHeightsAboveEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                               double* heights)
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+      heights[i] = getHeightAboveEllipsoid(gpts[i]);
+}
+
 //*****************************************************************************
 //  METHOD: intersectRay()
 //  
@@ -1,4 +1,5 @@
 #include <ossim/elevation/ossimElevationCellDatabase.h>
+#include <algorithm>
 
 RTTI_DEF1(ossimElevationCellDatabase, "ossimElevationCellDatabase", ossimElevationDatabase);
 
@@ -175,6 +176,97 @@ ossimRefPtr<ossimElevCellHandler> ossimElevationCellDatabase::getOrCreateCellHan
 }
 #endif
 
+void ossimElevationCellDatabase::getHeightsAboveMSL(const ossimGpt* gpts,
+                                                    ossim_uint32 count,
+                                                    double* heights)
+{
+   std::fill(heights, heights + count, ossim::nan());
+   if(!count || !isSourceEnabled())
+   {
+      return;
+   }
+
+   // Sort the points by cell so each cell is looked up once:
+   std::vector< std::pair<ossim_uint64, ossim_uint32> > order(count);
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      order[i] = std::make_pair(createId(gpts[i]), i);
+   }
+   std::sort(order.begin(), order.end());
+
+   std::vector<ossimGpt> cellPts;
+   std::vector<double> cellHeights;
+   std::vector<ossim_uint32> cellIdx;
+   ossim_uint32 i = 0;
+   while(i < count)
+   {
+      ossim_uint64 id = order[i].first;
+      ossimRefPtr<ossimElevCellHandler> handler = getOrCreateCellHandler(gpts[order[i].second]);
+
+      cellPts.clear();
+      cellIdx.clear();
+      for(; (i < count) && (order[i].first == id); ++i)
+      {
+         ossim_uint32 idx = order[i].second;
+         if(!handler.valid())
+         {
+            continue; // No cell for this id, leave as nan.
+         }
+         if(handler->pointHasCoverage(gpts[idx]))
+         {
+            cellPts.push_back(gpts[idx]);
+            cellIdx.push_back(idx);
+         }
+         else
+         {
+            heights[idx] = getHeightAboveMSL(gpts[idx]);
+         }
+      }
+
+      if(!cellPts.empty())
+      {
+         cellHeights.resize(cellPts.size());
+         handler->getHeightsAboveMSL(&cellPts.front(), (ossim_uint32)cellPts.size(),
+                                     &cellHeights.front());
+         for(ossim_uint32 j = 0; j < cellIdx.size(); ++j)
+         {
+            heights[cellIdx[j]] = cellHeights[j];
+         }
+      }
+   }
+}
+
+void ossimElevationCellDatabase::getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                                          ossim_uint32 count,
+                                                          double* heights)
+{
+   getHeightsAboveMSL(gpts, count, heights);
+
+   // Only the points that have a height need a geoid offset:
+   std::vector<ossimGpt> validPts;
+   std::vector<ossim_uint32> validIdx;
+   validPts.reserve(count);
+   validIdx.reserve(count);
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      if(!ossim::isnan(heights[i]))
+      {
+         validPts.push_back(gpts[i]);
+         validIdx.push_back(i);
+      }
+   }
+
+   if(!validPts.empty())
+   {
+      std::vector<double> offsets(validPts.size());
+      getOffsetsFromEllipsoid(&validPts.front(), (ossim_uint32)validPts.size(), &offsets.front());
+      for(ossim_uint32 i = 0; i < validIdx.size(); ++i)
+      {
+         heights[validIdx[i]] += offsets[i];
+      }
+   }
+}
+
 bool ossimElevationCellDatabase::loadState(const ossimKeywordlist& kwl, const char* prefix)
 {
    ossimString minOpenCells = kwl.find(prefix, "min_open_cells");
@@ -22,6 +22,27 @@ double ossimElevationDatabase::getOffsetFromEllipsoid(const ossimGpt& gpt)
    return result;
 }
 
+void ossimElevationDatabase::getOffsetsFromEllipsoid(const ossimGpt* gpts, ossim_uint32 count,
+                                                     double* offsets)
+{
+   if(m_geoid.valid())
+   {
+      m_geoid->offsetsFromEllipsoid(gpts, count, offsets);
+   }
+   else
+   {
+      ossimGeoidManager::instance()->offsetsFromEllipsoid(gpts, count, offsets);
+   }
+
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      if(ossim::isnan(offsets[i]))
+      {
+         offsets[i] = 0.0;
+      }
+   }
+}
+
 bool ossimElevationDatabase::loadState(const ossimKeywordlist& kwl, const char* prefix)
 {
    // Connection string:
@@ -12,6 +12,7 @@
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimDpt.h>
 #include <ossim/base/ossimGpt.h>
+#include <cstring> /* for memcpy */
 
 RTTI_DEF1(ossimGeneralRasterElevHandler, "ossimGeneralRasterElevHandler", ossimElevCellHandler);
 
@@ -29,7 +30,7 @@ ossimGeneralRasterElevHandler::ossimGeneralRasterElevHandler(const ossimGeneralR
    :ossimElevCellHandler(src),
     theGeneralRasterInfo(src.theGeneralRasterInfo),
     m_streamOpen(false), // ????
-    m_memoryMap(src.m_memoryMap)
+    m_memoryMap(src.m_memoryMap) // Shares the mapping.
 {
 }
 
@@ -53,7 +54,7 @@ double ossimGeneralRasterElevHandler::getHeightAboveMSL(const ossimGpt& gpt)
 {
    ossim_float64 result = theGeneralRasterInfo.theNullHeightValue;
 
-   if(m_memoryMap.empty())
+   if(!m_memoryMap)
    {
       switch(theGeneralRasterInfo.theScalarType)
       {
@@ -204,7 +205,7 @@ double ossimGeneralRasterElevHandler::getPostValue(const ossimIpt& /* gridPt */)
 
 bool ossimGeneralRasterElevHandler::isOpen()const
 {
-   if(!m_memoryMap.empty()) return true;
+   if(m_memoryMap) return true;
    std::lock_guard<std::mutex> lock(m_inputStreamMutex);
 
    //---
@@ -217,22 +218,20 @@ bool ossimGeneralRasterElevHandler::open(const ossimFilename& file, bool memoryM
 {
    close();
    if(!setFilename(file)) return false;
-   m_inputStream.clear();
-   m_inputStream.open(theGeneralRasterInfo.theFilename.c_str(), ios::in | ios::binary);
-
    if(memoryMapFlag)
    {
-      if(!m_inputStream.bad())
+      std::shared_ptr<ossimMemoryMappedFile> mmf = std::make_shared<ossimMemoryMappedFile>();
+      if(mmf->open(theGeneralRasterInfo.theFilename))
       {
-         m_memoryMap.resize(theGeneralRasterInfo.theFilename.fileSize());
-         if(!m_memoryMap.empty())
-         {
-           m_inputStream.read((char*)(&m_memoryMap.front()), (streamsize)m_memoryMap.size());
-         }
+         m_memoryMap = mmf;
+         return true;
       }
-      m_inputStream.close();
+      // Fall back to stream reads.
    }
 
+   m_inputStream.clear();
+   m_inputStream.open(theGeneralRasterInfo.theFilename.c_str(), ios::in | ios::binary);
+
    // Capture the stream state for non-const is_open on old compiler.
    m_streamOpen = m_inputStream.is_open();
    
@@ -245,7 +244,7 @@ bool ossimGeneralRasterElevHandler::open(const ossimFilename& file, bool memoryM
 void ossimGeneralRasterElevHandler::close()
 {
    m_inputStream.close();
-   m_memoryMap.clear();
+   m_memoryMap.reset();
    m_streamOpen = false;
 }
 
@@ -614,11 +613,18 @@ double ossimGeneralRasterElevHandler::getHeightAboveMSLMemoryTemplate(
    
    ossim_uint64 offset = y0*bytesPerLine + x0*sizeof(T);
    ossim_uint64 offset2 = offset+bytesPerLine;
+   if ( (offset2 + 2*sizeof(T)) > m_memoryMap->size() )
+   {
+      return ossim::nan(); // Truncated raster.
+   }
    
-   T v00 = *(reinterpret_cast<T*> (&m_memoryMap[offset]));
-   T v01 = *(reinterpret_cast<T*> (&m_memoryMap[offset + sizeof(T)]));
-   T v10 = *(reinterpret_cast<T*> (&m_memoryMap[offset2]));
-   T v11 = *(reinterpret_cast<T*> (&m_memoryMap[offset2 + sizeof(T)]));
+   // memcpy as rows are not guaranteed to be aligned for T:
+   const ossim_uint8* buf = m_memoryMap->data();
+   T v00, v01, v10, v11;
+   memcpy(&v00, buf + offset, sizeof(T));
+   memcpy(&v01, buf + offset + sizeof(T), sizeof(T));
+   memcpy(&v10, buf + offset2, sizeof(T));
+   memcpy(&v11, buf + offset2 + sizeof(T), sizeof(T));
    if(endian.getSystemEndianType() != info.theByteOrder)
    {
       endian.swap(v00);
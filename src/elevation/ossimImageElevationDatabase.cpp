@@ -115,6 +115,20 @@ double ossimImageElevationDatabase::getHeightAboveEllipsoid(const ossimGpt& gpt)
    return h;
 }
 
+void ossimImageElevationDatabase::getHeightsAboveMSL(const ossimGpt* gpts,
+                                                     ossim_uint32 count,
+                                                     double* heights)
+{
+   ossimElevSource::getHeightsAboveMSL(gpts, count, heights);
+}
+
+void ossimImageElevationDatabase::getHeightsAboveEllipsoid(const ossimGpt* gpts,
+                                                           ossim_uint32 count,
+                                                           double* heights)
+{
+   ossimElevSource::getHeightsAboveEllipsoid(gpts, count, heights);
+}
+
 ossimRefPtr<ossimElevCellHandler> ossimImageElevationDatabase::createCell(
    const ossimGpt& gpt)
 {
@@ -320,10 +334,13 @@ void ossimImageElevationDatabase::getBoundingRect(ossimGrect& rect) const
       subRect = i->second.m_rect;
       if (subRect.isLonLatNan())
       {
-         // The DEM source was not yet initialized:
+         // The DEM source was not yet initialized.  Keep its rect so the file is opened once.
          ossimRefPtr<ossimImageElevationHandler> h = new ossimImageElevationHandler();
          if ( h->open( i->second.m_file ) )
+         {
             subRect = h->getBoundingGndRect();
+            i->second.m_rect = subRect;
+         }
          else
          {
             ++i;
@@ -338,6 +355,11 @@ void ossimImageElevationDatabase::getBoundingRect(ossimGrect& rect) const
    }
 }
 
+bool ossimImageElevationDatabase::getCoverageRect(ossimGrect& rect) const
+{
+   getBoundingRect(rect);
+   return ( rect.isLonLatNan() == false );
+}
 
 bool ossimImageElevationDatabase::getAccuracyInfo(ossimElevationAccuracyInfo& info, const ossimGpt& gpt) const
 {
@@ -18,6 +18,7 @@
 #include <ossim/base/ossimGpt.h>
 #include <ossim/base/ossimEndian.h>
 #include <ossim/base/ossimStreamFactoryRegistry.h>
+#include <cstring> /* for memcpy */
 
 RTTI_DEF1(ossimSrtmHandler, "ossimSrtmHandler" , ossimElevCellHandler)
 
@@ -54,7 +55,7 @@ ossimSrtmHandler::~ossimSrtmHandler()
 double ossimSrtmHandler::getHeightAboveMSL(const ossimGpt& gpt)
 {
    if(!isOpen()) return ossim::nan();
-   if(!m_memoryMap.empty())
+   if(m_memoryMap)
    {
       switch(m_scalarType)
       {
@@ -270,10 +271,16 @@ double ossimSrtmHandler::getHeightAboveMSLMemoryTemplate(T /* dummy */,
    // Grab the four points from the srtm cell needed.
    ossim_uint64 offset = y0 * m_srtmRecordSizeInBytes + x0 * sizeof(T);
    ossim_uint64 offset2 =offset+m_srtmRecordSizeInBytes;
-   T v00 = *(reinterpret_cast<T*> (&m_memoryMap[offset]));
-   T v01 = *(reinterpret_cast<T*> (&m_memoryMap[offset + sizeof(T)]));
-   T v10 = *(reinterpret_cast<T*> (&m_memoryMap[offset2]));
-   T v11 = *(reinterpret_cast<T*> (&m_memoryMap[offset2 + sizeof(T)]));
+   if ( (offset2 + 2*sizeof(T)) > m_memoryMap->size() )
+   {
+      return ossim::nan(); // Truncated cell.
+   }
+   const ossim_uint8* buf = m_memoryMap->data();
+   T v00, v01, v10, v11;
+   memcpy(&v00, buf + offset, sizeof(T));
+   memcpy(&v01, buf + offset + sizeof(T), sizeof(T));
+   memcpy(&v10, buf + offset2, sizeof(T));
+   memcpy(&v11, buf + offset2 + sizeof(T), sizeof(T));
    if (m_swapper)
    {
       m_swapper->swap(v00);
@@ -393,9 +400,9 @@ m_lonSpacing(src.m_lonSpacing),
 m_nwCornerPost(src.m_nwCornerPost),
 m_swapper(src.m_swapper?new ossimEndian:0),
 m_scalarType(src.m_scalarType),
-m_memoryMap(src.m_memoryMap)
+m_memoryMap(src.m_memoryMap) // Shares the mapping.
 {
-   if(m_memoryMap.empty()&&src.isOpen())
+   if(!m_memoryMap&&src.isOpen())
    {
       m_fileStr.open(src.getFilename().c_str(),
                      std::ios::binary|std::ios::in);
@@ -404,7 +411,7 @@ m_memoryMap(src.m_memoryMap)
 
 bool ossimSrtmHandler::isOpen()const
 {
-   if(!m_memoryMap.empty()) return true;
+   if(m_memoryMap) return true;
    
    std::lock_guard<std::mutex> lock(m_fileStrMutex);
    return m_streamOpen;
@@ -448,6 +455,20 @@ bool ossimSrtmHandler::open(const ossimFilename& file, bool memoryMapFlag)
    // Set the base class null height value.
    theNullHeightValue = -32768.0;
 
+   m_memoryMap.reset();
+   if(memoryMapFlag)
+   {
+      std::shared_ptr<ossimMemoryMappedFile> mmf = std::make_shared<ossimMemoryMappedFile>();
+      if(mmf->open(theFilename))
+      {
+         m_memoryMap = mmf;
+         m_fileStr.close();
+         m_streamOpen = true;
+         return true;
+      }
+      // Fall back to stream reads.
+   }
+
    m_fileStr.clear();
    m_fileStr.open(theFilename.c_str(), std::ios::in | std::ios::binary);
    if(!m_fileStr)
@@ -455,12 +476,6 @@ bool ossimSrtmHandler::open(const ossimFilename& file, bool memoryMapFlag)
       return false;
    }
    
-   if(memoryMapFlag)
-   {
-      m_memoryMap.resize(theFilename.fileSize());
-      m_fileStr.read((char*)&m_memoryMap.front(), (streamsize)m_memoryMap.size());
-      m_fileStr.close();
-   }
    m_streamOpen = true;
    // Capture the stream state for non-const is_open on old compiler.
    
@@ -492,6 +507,6 @@ bool ossimSrtmHandler::open(const ossimFilename& file, bool memoryMapFlag)
 void ossimSrtmHandler::close()
 {
    m_fileStr.close();
-   m_memoryMap.clear();
+   m_memoryMap.reset();
    m_streamOpen = false;
 }
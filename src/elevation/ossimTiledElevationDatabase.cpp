@@ -358,6 +358,12 @@ bool ossimTiledElevationDatabase::pointHasCoverage(const ossimGpt& gpt) const
    return false;
 }
 
+bool ossimTiledElevationDatabase::getCoverageRect(ossimGrect& rect) const
+{
+   rect = theGroundRect;
+   return ( theGroundRect.isLonLatNan() == false );
+}
+
 bool ossimTiledElevationDatabase::loadState(const ossimKeywordlist& kwl, const char* prefix)
 {
    static const char M[] = "ossimTiledElevationDatabase::loadState";
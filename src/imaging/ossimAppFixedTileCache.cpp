@@ -25,7 +25,8 @@ const ossim_uint32 ossimAppFixedTileCache::DEFAULT_SIZE = 1024*1024*80;
 static const ossimTrace traceDebug("ossimAppFixedTileCache:debug");
 std::ostream& operator <<(std::ostream& out, const ossimAppFixedTileCache& rhs)
 {
-   std::map<ossimAppFixedTileCache::ossimAppFixedCacheId, ossimFixedTileCache*>::const_iterator iter = rhs.theAppCacheMap.begin();
+   ossim::ScopeReadLock lock(rhs.theCacheMapLock);
+   std::map<ossimAppFixedTileCache::ossimAppFixedCacheId, ossimRefPtr<ossimFixedTileCache> >::const_iterator iter = rhs.theAppCacheMap.begin();
 
    if(iter == rhs.theAppCacheMap.end())
    {
@@ -36,7 +37,10 @@ std::ostream& operator <<(std::ostream& out, const ossimAppFixedTileCache& rhs)
    {
       while(iter != rhs.theAppCacheMap.end())
       {
-         out << "Cache id = "<< (*iter).first << " size = " << (*iter).second->getCacheSize() << endl;
+         ossimFixedTileCache::Statistics stats = (*iter).second->getStatistics();
+         out << "Cache id = "<< (*iter).first << " size = " << (*iter).second->getCacheSize()
+             << " hits = " << stats.theHits << " misses = " << stats.theMisses
+             << " evictions = " << stats.theEvictions << endl;
          ++iter;
       }
    }
@@ -54,6 +58,8 @@ ossimAppFixedTileCache::ossimAppFixedTileCache()
    theInstance = this;
    theTileSize = ossimIpt(64, 64);
    theCurrentCacheSize = 0;
+   theMaxCacheSize = 0;
+   theMaxGlobalCacheSize = 0;
 
    // ossim::defaultTileSize(theTileSize);
    
@@ -118,7 +124,7 @@ ossimAppFixedTileCache *ossimAppFixedTileCache::instance(ossim_uint32  maxSize)
 
 void ossimAppFixedTileCache::setMaxCacheSize(ossim_uint32 cacheSize)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeWriteLock lock(theCacheMapLock);
    theMaxGlobalCacheSize = cacheSize;
    theMaxCacheSize = cacheSize;
    //   theMaxCacheSize      = (ossim_uint32)(theMaxGlobalCacheSize*.2);
@@ -126,42 +132,43 @@ void ossimAppFixedTileCache::setMaxCacheSize(ossim_uint32 cacheSize)
 
 void ossimAppFixedTileCache::flush()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::iterator currentIter = theAppCacheMap.begin();
+   ossim::ScopeReadLock lock(theCacheMapLock);
+   std::map<ossimAppFixedCacheId, ossimRefPtr<ossimFixedTileCache> >::iterator currentIter = theAppCacheMap.begin();
    
    while(currentIter != theAppCacheMap.end())
    {
-      (*currentIter).second->flush();
+      theCurrentCacheSize -= (*currentIter).second->flush();
       ++currentIter;
    }
-   theCurrentCacheSize = 0;
 }
 
 void ossimAppFixedTileCache::flush(ossimAppFixedCacheId cacheId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimFixedTileCache* cache = getCache(cacheId);
+   if(cache)
    {
-      if(cache)
-      {
-         theCurrentCacheSize -= cache->getCacheSize();
-         cache->flush();
-      }
+      theCurrentCacheSize -= cache->flush();
    }
 }
 
 void ossimAppFixedTileCache::deleteCache(ossimAppFixedCacheId cacheId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimRefPtr<ossimFixedTileCache> cache = getCache(cacheId);
+   ossimRefPtr<ossimFixedTileCache> cache = 0;
    {
-      std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::iterator iter = theAppCacheMap.find(cacheId);
-      
-      if(cache.valid())
+      ossim::ScopeWriteLock lock(theCacheMapLock);
+      std::map<ossimAppFixedCacheId, ossimRefPtr<ossimFixedTileCache> >::iterator iter = theAppCacheMap.find(cacheId);
+      if(iter != theAppCacheMap.end())
       {
+         cache = (*iter).second;
          theAppCacheMap.erase(iter);
-         theCurrentCacheSize -= cache->getCacheSize();
       }
+   }
+
+   // Release the tiles outside of the map lock:
+   if(cache.valid())
+   {
+      theCurrentCacheSize -= cache->flush();
       cache = 0;
    }
 }
@@ -169,9 +176,7 @@ void ossimAppFixedTileCache::deleteCache(ossimAppFixedCacheId cacheId)
 ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCache(const ossimIrect& tileBoundaryRect,
                                                                                   const ossimIpt& tileSize)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimAppFixedCacheId result = -1; 
-   ossimFixedTileCache* newCache = new ossimFixedTileCache;
+   ossimRefPtr<ossimFixedTileCache> newCache = new ossimFixedTileCache;
    if(tileSize.x == 0 ||
       tileSize.y == 0)
    {
@@ -183,7 +188,9 @@ ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCach
    {
       newCache->setRect(tileBoundaryRect, tileSize);
    }
-   result = theUniqueAppIdCounter;
+
+   ossim::ScopeWriteLock lock(theCacheMapLock);
+   ossimAppFixedCacheId result = theUniqueAppIdCounter;
    theAppCacheMap.insert(std::make_pair(result, newCache));
    ++theUniqueAppIdCounter;
    
@@ -192,46 +199,38 @@ ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCach
 
 ossimAppFixedTileCache::ossimAppFixedCacheId ossimAppFixedTileCache::newTileCache()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimAppFixedCacheId result = -1;
-   ossimFixedTileCache* newCache = new ossimFixedTileCache;
-   
-   {
-      result = theUniqueAppIdCounter;
-      theAppCacheMap.insert(std::make_pair(result, newCache));
-      ++theUniqueAppIdCounter;
-   }
+   ossimRefPtr<ossimFixedTileCache> newCache = new ossimFixedTileCache;
+
+   ossim::ScopeWriteLock lock(theCacheMapLock);
+   ossimAppFixedCacheId result = theUniqueAppIdCounter;
+   theAppCacheMap.insert(std::make_pair(result, newCache));
+   ++theUniqueAppIdCounter;
    
    return result;
-   
 }
 
 void ossimAppFixedTileCache::setRect(ossimAppFixedCacheId cacheId,
                                      const ossimIrect& boundaryTileRect)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimFixedTileCache* cache = getCache(cacheId);
    if(cache)
    {
-      
-      ossim_uint32 cacheSize = cache->getCacheSize();
+      // Changing the rect flushes the cache:
       // cache->setRect(boundaryTileRect, theTileSize);
-      cache->setRect(boundaryTileRect,
-                     cache->getTileSize());      
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
+      theCurrentCacheSize -= cache->setRect(boundaryTileRect,
+                                            cache->getTileSize());
    }
 }
 
 void ossimAppFixedTileCache::setTileSize(ossimAppFixedCacheId cacheId,
                                          const ossimIpt& tileSize)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimFixedTileCache* cache = getCache(cacheId);
    if(cache)
    {
-      ossim_uint32 cacheSize = cache->getCacheSize();
-      cache->setRect(cache->getTileBoundaryRect(), tileSize);
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
+      theCurrentCacheSize -= cache->setRect(cache->getTileBoundaryRect(), tileSize);
       theTileSize = cache->getTileSize();
    }
 }
@@ -240,7 +239,7 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::getTile(
    ossimAppFixedCacheId cacheId,
    const ossimIpt& origin)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimRefPtr<ossimImageData> result = 0;
    ossimFixedTileCache* cache = getCache(cacheId);
    if(cache)
@@ -257,8 +256,13 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::addTile(
                                                             ossimRefPtr<ossimImageData> data,
                                                             bool duplicateData)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = 0;
+   if(!data.valid())
+   {
+      return result;
+   }
+
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimFixedTileCache *aCache = this->getCache(cacheId);
    if(!aCache)
    {         
@@ -266,27 +270,28 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::addTile(
    }
    ossim_uint32 dataSize = data->getDataSizeInBytes();
 
-   if( (theCurrentCacheSize+dataSize) > theMaxGlobalCacheSize)
+   if( (theCurrentCacheSize.load(std::memory_order_relaxed) + dataSize) > theMaxGlobalCacheSize)
    {
-      shrinkGlobalCacheSize((ossim_int32)(theMaxGlobalCacheSize*0.1));
+      // Only one thread trims at a time, the others proceed with the add:
+      std::unique_lock<std::mutex> shrinkLock(theShrinkMutex, std::try_to_lock);
+      if(shrinkLock.owns_lock())
+      {
+         shrinkGlobalCacheSize((ossim_int32)(theMaxGlobalCacheSize*0.1));
+      }
    }
 
-   ossim_uint32 cacheSize = 0;
-   {
-      cacheSize = aCache->getCacheSize();
-   }
-   if(cacheSize > theMaxCacheSize)
+   if(aCache->getCacheSize() > theMaxCacheSize)
    {
 //       shrinkCacheSize(aCache,
 //                       (ossim_int32)(aCache->getCacheSize()*.1));
       shrinkCacheSize(aCache,
                       (ossim_int32)(1024*1024));
    }
+
+   result = aCache->addTile(data, duplicateData);
+   if(result.valid())
    {
-      cacheSize = aCache->getCacheSize();
-      result    = aCache->addTile(data, duplicateData);
-   
-      theCurrentCacheSize += (aCache->getCacheSize() - cacheSize);
+      theCurrentCacheSize += result->getDataSizeInBytes();
    }
    
    return result;
@@ -294,7 +299,7 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::addTile(
 
 void ossimAppFixedTileCache::deleteAll()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeWriteLock lock(theCacheMapLock);
    theCurrentCacheSize = 0;
    theAppCacheMap.clear();
 }
@@ -303,15 +308,17 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::removeTile(
    ossimAppFixedCacheId cacheId,
    const ossimIpt& origin)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimRefPtr<ossimImageData> result = 0;
    
    ossimFixedTileCache* cache = getCache(cacheId);
    if(cache)
    {
-      ossim_uint32 cacheSize = cache->getCacheSize();
       result = cache->removeTile(origin);
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
+      if(result.valid())
+      {
+         theCurrentCacheSize -= result->getDataSizeInBytes();
+      }
    }
 
    return result;
@@ -320,26 +327,19 @@ ossimRefPtr<ossimImageData> ossimAppFixedTileCache::removeTile(
 void ossimAppFixedTileCache::deleteTile(ossimAppFixedCacheId cacheId,
                                         const ossimIpt& origin)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimFixedTileCache* cache = getCache(cacheId);
-   if(cache)
-   {
-      ossim_uint32 cacheSize = cache->getCacheSize();
-      cache->deleteTile(origin);
-      theCurrentCacheSize += (cache->getCacheSize() - cacheSize);
-   }
+   removeTile(cacheId, origin);
 }
 
 ossimFixedTileCache* ossimAppFixedTileCache::getCache(
-   ossimAppFixedCacheId cacheId)
+   ossimAppFixedCacheId cacheId)const
 {   
-   std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::const_iterator
+   std::map<ossimAppFixedCacheId, ossimRefPtr<ossimFixedTileCache> >::const_iterator
       currentIter = theAppCacheMap.find(cacheId);
    ossimFixedTileCache* result = 0;
    
    if(currentIter != theAppCacheMap.end())
    {
-      result = (*currentIter).second;
+      result = const_cast<ossimFixedTileCache*>((*currentIter).second.get());
    }
 
    return result;
@@ -347,29 +347,38 @@ ossimFixedTileCache* ossimAppFixedTileCache::getCache(
 
 void ossimAppFixedTileCache::shrinkGlobalCacheSize(ossim_int32 byteCount)
 {
-   if(static_cast<ossim_uint32>(byteCount) >= theCurrentCacheSize)
+   if(static_cast<ossim_int64>(byteCount) >= theCurrentCacheSize.load())
    {
-      flush();
+      std::map<ossimAppFixedCacheId, ossimRefPtr<ossimFixedTileCache> >::iterator iter = theAppCacheMap.begin();
+      while(iter != theAppCacheMap.end())
+      {
+         theCurrentCacheSize -= (*iter).second->flush();
+         ++iter;
+      }
    }
    else
    {
       while(byteCount > 0)
       {
-         std::map<ossimAppFixedCacheId, ossimFixedTileCache*>::iterator iter = theAppCacheMap.begin();
+         bool evicted = false;
+         std::map<ossimAppFixedCacheId, ossimRefPtr<ossimFixedTileCache> >::iterator iter = theAppCacheMap.begin();
          while( (iter != theAppCacheMap.end())&&(byteCount>0))
          {
-            ossimFixedTileCache* cache = getCache((*iter).first);
-            if(cache)
+            ossimRefPtr<ossimImageData> tile = (*iter).second->removeTile();
+            if(tile.valid())
             {
-               ossim_uint32 before = cache->getCacheSize();
-               cache->deleteTile();
-               ossim_uint32 after = cache->getCacheSize();
-               ossim_uint32 delta = (before - after);
+               ossim_uint32 delta = tile->getDataSizeInBytes();
                byteCount -= delta;
-               theCurrentCacheSize -= (delta);
+               theCurrentCacheSize -= delta;
+               evicted = true;
             }
             ++iter;
          }
+         if(!evicted)
+         {
+            // Nothing left to evict (e.g. LRU disabled on all caches).
+            break;
+         }
       }
    }
 }
@@ -377,6 +386,7 @@ void ossimAppFixedTileCache::shrinkGlobalCacheSize(ossim_int32 byteCount)
 void ossimAppFixedTileCache::shrinkCacheSize(ossimAppFixedCacheId id,
                                              ossim_int32 byteCount)
 {
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimFixedTileCache* cache = getCache(id);
 
    if(cache)
@@ -390,23 +400,20 @@ void ossimAppFixedTileCache::shrinkCacheSize(ossimFixedTileCache* cache,
 {
    if(cache)
    {
-      ossim_int32 cacheSize = cache->getCacheSize();
-      if(cacheSize <= byteCount)
+      if(static_cast<ossim_int64>(cache->getCacheSize()) <= byteCount)
       {
-         cache->flush();
+         theCurrentCacheSize -= cache->flush();
       }
       else
       {
          while(byteCount > 0)
          {
-            ossim_uint32 before = cache->getCacheSize();
-            cache->deleteTile();
-            ossim_uint32 after = cache->getCacheSize();
-            ossim_uint32 delta = std::abs((int)(before - after));
-            if(delta)
+            ossimRefPtr<ossimImageData> tile = cache->removeTile();
+            if(tile.valid())
             {
+               ossim_uint32 delta = tile->getDataSizeInBytes();
                byteCount -= delta;
-               theCurrentCacheSize -= (delta);
+               theCurrentCacheSize -= delta;
             }
             else
             {
@@ -419,7 +426,7 @@ void ossimAppFixedTileCache::shrinkCacheSize(ossimFixedTileCache* cache,
 
 const ossimIpt& ossimAppFixedTileCache::getTileSize(ossimAppFixedCacheId cacheId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
+   ossim::ScopeReadLock lock(theCacheMapLock);
    ossimFixedTileCache* cache = getCache(cacheId);
    if(cache)
    {
@@ -427,3 +434,22 @@ const ossimIpt& ossimAppFixedTileCache::getTileSize(ossimAppFixedCacheId cacheId
    }
    return theTileSize;
 }
+
+bool ossimAppFixedTileCache::getStatistics(ossimAppFixedCacheId cacheId,
+                                           ossimFixedTileCache::Statistics& stats)const
+{
+   ossim::ScopeReadLock lock(theCacheMapLock);
+   ossimFixedTileCache* cache = getCache(cacheId);
+   if(cache)
+   {
+      stats = cache->getStatistics();
+      return true;
+   }
+   return false;
+}
+
+ossim_uint32 ossimAppFixedTileCache::getCurrentCacheSize()const
+{
+   ossim_int64 size = theCurrentCacheSize.load(std::memory_order_relaxed);
+   return (size > 0) ? (ossim_uint32)size : 0;
+}
@@ -110,6 +110,16 @@ ossimRefPtr<ossimImageData> ossimBandSelector::getTile(
    return m_tile;
 }
 
+void ossimBandSelector::setTileRequestOrder(const ossimIrect& area,
+                                            const ossimIpt& tileSize,
+                                            ossim_uint32 resLevel)
+{
+   if (theInputConnection)
+   {
+      theInputConnection->setTileRequestOrder(area, tileSize, resLevel);
+   }
+}
+
 void ossimBandSelector::setThreeBandRgb()
 {
    m_outputBandList.clear();
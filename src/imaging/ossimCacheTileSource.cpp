@@ -17,8 +17,11 @@
 #include <ossim/imaging/ossimCacheTileSource.h>
 #include <ossim/imaging/ossimImageData.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimSharedTileCache.h>
 #include <ossim/base/ossimKeywordNames.h>
 #include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimDate.h>
 
 static ossimTrace traceDebug("ossimCacheTileSource:debug");
 
@@ -35,7 +38,8 @@ ossimCacheTileSource::ossimCacheTileSource()
      theCachingEnabled(true),
      theEventProgressFlag(false),
      theUseInputTileSizeFlag(false),
-     theTileSizeXY()
+     theTileSizeXY(),
+     theSharedCacheId(0)
 {
    ossim::defaultTileSize(theFixedTileSize);
    ossim::defaultTileSize(theTileSizeXY);
@@ -66,6 +70,13 @@ void ossimCacheTileSource::initialize()
    ossimImageSourceFilter::initialize();
    flush();
    theTile = 0;
+
+   // The id saves the state of the input chain so only compute it when the cache is in use.
+   theSharedCacheId = 0;
+   if ( ossimSharedTileCache::instance()->isOpen() )
+   {
+      theSharedCacheId = computeSharedCacheId();
+   }
 }
    
 void ossimCacheTileSource::allocate()
@@ -201,37 +212,11 @@ ossimRefPtr<ossimImageData> ossimCacheTileSource::fillTile(
                 col+=theFixedTileSize.x)
             {
                ++currentTile;
-               if(theCachingEnabled)
-               {
-                  tempTile =
-                     ossimAppFixedTileCache::instance()->getTile(cacheId,
-                                                                 origin);
-               }
-               else
-               {
-                  tempTile = 0;
-               }
-               if(!tempTile.valid())
-               {
-                  ossimIrect rect(origin.x,
-                                  origin.y,
-                                  origin.x + cacheTileSize.x-1,
-                                  origin.y + cacheTileSize.y-1);
-                  
-                  tempTile = theInputConnection->getTile(rect, resLevel);
-                  
-                  if(tempTile.valid())
-                  {
-                     // drb if(theTile->getBuf()&&
-                     if(tempTile->getBuf()&&                        
-                        (tempTile->getDataObjectStatus()!=OSSIM_EMPTY)&&
-                        theCachingEnabled)
-                     {
-                        ossimAppFixedTileCache::instance()->
-                           addTile(cacheId, tempTile);
-                     }
-                  }
-               }
+               ossimIrect rect(origin.x,
+                               origin.y,
+                               origin.x + cacheTileSize.x-1,
+                               origin.y + cacheTileSize.y-1);
+               tempTile = getCacheTile(rect, resLevel, cacheId);
              //  else
              //  {
              //     std::cout << "FOUND IN CACHE AT RES " << resLevel << "\n";
@@ -283,25 +268,7 @@ ossimRefPtr<ossimImageData> ossimCacheTileSource::fillTile(
          (static_cast<ossim_int32>(tileRect.height()) == cacheTileSize.y))
       {
          // Grabbing whole tile either from cache or input.
-         ossimIpt origin = tileRect.ul();
-         if(theCachingEnabled)
-         {
-            result = ossimAppFixedTileCache::instance()->getTile(cacheId, origin);
-         }
-         if(!result.valid())
-         {
-            result = theInputConnection->getTile(tileRect, resLevel);
-            
-            if(result.valid())
-            {
-               if((result->getBuf())&&
-                  (result->getDataObjectStatus()!=OSSIM_EMPTY)&&
-                  theCachingEnabled)
-               {
-                  ossimAppFixedTileCache::instance()->addTile(cacheId, result);
-               }
-            }
-         }
+         result = getCacheTile(tileRect, resLevel, cacheId);
 //         else
 //         {
 //            std::cout << "FOUND IN CACHE AT RES " << resLevel << "\n";
@@ -341,37 +308,11 @@ ossimRefPtr<ossimImageData> ossimCacheTileSource::fillTile(
                 col+=theFixedTileSize.x)
             {
                ++currentTile;
-               if(theCachingEnabled)
-               {
-                  tempTile =
-                     ossimAppFixedTileCache::instance()->getTile(cacheId,
-                                                                 origin);
-               }
-               else
-               {
-                  tempTile = 0;
-               }
-               if(!tempTile.valid())
-               {
-                  ossimIrect rect(origin.x,
-                                  origin.y,
-                                  origin.x + cacheTileSize.x-1,
-                                  origin.y + cacheTileSize.y-1);
-                  
-                  tempTile = theInputConnection->getTile(rect, resLevel);
-                  
-                  if(tempTile.valid())
-                  {
-                     // drb if(theTile->getBuf()&&
-                     if(tempTile->getBuf()&&                        
-                        (tempTile->getDataObjectStatus()!=OSSIM_EMPTY)&&
-                        theCachingEnabled)
-                     {
-                        ossimAppFixedTileCache::instance()->
-                           addTile(cacheId, tempTile);
-                     }
-                  }
-               }
+               ossimIrect rect(origin.x,
+                               origin.y,
+                               origin.x + cacheTileSize.x-1,
+                               origin.y + cacheTileSize.y-1);
+               tempTile = getCacheTile(rect, resLevel, cacheId);
              //  else
              //  {
              //     std::cout << "FOUND IN CACHE AT RES " << resLevel << "\n";
@@ -407,6 +348,96 @@ ossimRefPtr<ossimImageData> ossimCacheTileSource::fillTile(
    return result;
 }
 
+ossimRefPtr<ossimImageData> ossimCacheTileSource::getCacheTile(
+   const ossimIrect& rect, ossim_uint32 resLevel,
+   ossimAppFixedTileCache::ossimAppFixedCacheId cacheId )
+{
+   ossimRefPtr<ossimImageData> result = 0;
+   if(!theCachingEnabled)
+   {
+      return theInputConnection->getTile(rect, resLevel);
+   }
+
+   result = ossimAppFixedTileCache::instance()->getTile(cacheId, rect.ul());
+   if(result.valid())
+   {
+      return result;
+   }
+
+   // Another process may have read it already.
+   ossimSharedTileCache* sharedCache = ossimSharedTileCache::instance();
+   const bool SHARED = ( theSharedCacheId && sharedCache->isOpen() );
+   if(SHARED)
+   {
+      result = ossimImageDataFactory::instance()->create(this, this);
+      result->setImageRectangle(rect);
+      result->initialize();
+      if(sharedCache->getTile(theSharedCacheId, resLevel, result.get()))
+      {
+         ossimAppFixedTileCache::instance()->addTile(cacheId, result);
+         return result;
+      }
+      result = 0;
+   }
+
+   result = theInputConnection->getTile(rect, resLevel);
+   if(result.valid())
+   {
+      if((result->getBuf())&&
+         (result->getDataObjectStatus()!=OSSIM_EMPTY))
+      {
+         ossimAppFixedTileCache::instance()->addTile(cacheId, result);
+         if(SHARED)
+         {
+            sharedCache->addTile(theSharedCacheId, resLevel, result.get());
+         }
+      }
+   }
+
+   return result;
+}
+
+ossim_uint64 ossimCacheTileSource::computeSharedCacheId() const
+{
+   //---
+   // Tiles are the same in two processes if the chains below the cache
+   // are.  The image file stamp catches the image being rewritten.
+   //---
+   ossimKeywordlist kwl;
+   ossim_uint32 index = 0;
+   ossimImageSource* source = theInputConnection;
+   ossimImageHandler* handler = 0;
+   while(source && !handler)
+   {
+      ossimString prefix = "source" + ossimString::toString(index++) + ".";
+      source->saveState(kwl, prefix.c_str());
+      handler = dynamic_cast<ossimImageHandler*>(source);
+      source = dynamic_cast<ossimImageSource*>(source->getInput(0));
+   }
+   if(!handler)
+   {
+      return 0;
+   }
+
+   ossimLocalTm modified;
+   if(handler->getFilename().getTimes(0, &modified, 0))
+   {
+      kwl.add("source_modified", (ossim_int64)((time_t)modified), true);
+   }
+   kwl.add("source_size", handler->getFilename().fileSize(), true);
+
+   // 64 bit FNV-1a so the id is the same in every process.
+   ossimString state;
+   kwl.toString(state);
+   ossim_uint64 hash = 14695981039346656037ULL;
+   for(std::string::size_type i = 0; i < state.size(); ++i)
+   {
+      hash ^= (ossim_uint8)state[i];
+      hash *= 1099511628211ULL;
+   }
+   return hash ? hash : 1;
+}
+
 ossim_uint32 ossimCacheTileSource::getTileWidth() const
 {
    return theFixedTileSize.x;
@@ -385,7 +385,8 @@ ossimEquationCombiner::ossimEquationCombiner()
     theCastFilter(NULL),
     theCastOutputFilter(NULL),
     theCurrentId(0),
-    theCurrentResLevel(0)
+    theCurrentResLevel(0),
+    theProgram()
 {
    theLexer      = new ossimEquTokenizer;
    theCastFilter = new ossimCastTileSourceFilter;
@@ -401,7 +402,8 @@ ossimEquationCombiner::ossimEquationCombiner(ossimConnectableObject::Connectable
     theCastFilter(NULL),
     theCastOutputFilter(NULL),
     theCurrentId(0),
-    theCurrentResLevel(0)
+    theCurrentResLevel(0),
+    theProgram()
 {
    theLexer      = new ossimEquTokenizer;
    theCastFilter = new ossimCastTileSourceFilter;
@@ -526,7 +528,16 @@ ossimRefPtr<ossimImageData> ossimEquationCombiner::getTile(
       }
       theCurrentResLevel = resLevel;
       
-      ossimRefPtr<ossimImageData> outputTile =  parseEquation();
+      ossimRefPtr<ossimImageData> outputTile;
+      if(evaluateProgram())
+      {
+         theTile->validate();
+         outputTile = theTile;
+      }
+      else
+      {
+         outputTile = parseEquation();
+      }
 
       if(theCastOutputFilter.valid())
       {
@@ -654,6 +665,56 @@ void ossimEquationCombiner::initialize()
    {
       theCastOutputFilter->initialize();
    }
+   if(theProgram.getEquation() != theEquation)
+   {
+      theProgram.compile(theEquation);
+   }
+}
+
+bool ossimEquationCombiner::evaluateProgram()
+{
+   if(theProgram.getEquation() != theEquation)
+   {
+      theProgram.compile(theEquation);
+   }
+   if(!theProgram.isCompiled())
+   {
+      return false;
+   }
+
+   const vector<ossim_uint32>& indexes = theProgram.getInputIndexes();
+   vector<ossimRefPtr<ossimImageData> > inputs;
+   if(indexes.size())
+   {
+      inputs.resize(indexes.back() + 1);
+   }
+   for(ossim_uint32 i = 0; i < indexes.size(); ++i)
+   {
+      ossimImageSource* inter = PTR_CAST(ossimImageSource, getInput(indexes[i]));
+      if(!inter)
+      {
+         return false;
+      }
+      ossimRefPtr<ossimImageData> data = inter->getTile(theTile->getImageRectangle(),
+                                                        theCurrentResLevel);
+      if(!data.valid())
+      {
+         return false;
+      }
+
+      // A source connected twice reuses its tile, so keep a copy of the first.
+      for(ossim_uint32 j = i + 1; j < indexes.size(); ++j)
+      {
+         if(getInput(indexes[j]) == inter)
+         {
+            data = (ossimImageData*)data->dup();
+            break;
+         }
+      }
+      inputs[indexes[i]] = data;
+   }
+
+   return theProgram.evaluate(inputs, theTile.get());
 }
 
 void ossimEquationCombiner::assignValue()
@@ -1330,7 +1391,9 @@ bool ossimEquationCombiner::parseStdFuncs()
             theValueStack.pop();
             v1 = theValueStack.top();
             theValueStack.pop();
-            argCount -=2;
+
+            // One op per argument after the first:
+            argCount -= 1;
 
             do
             {
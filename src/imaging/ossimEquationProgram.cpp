@@ -0,0 +1,1120 @@
+//---
+//
+// License: MIT
+//
+// Description:
+//
+// Contains class definition for ossimEquationProgram.
+//
+//---
+
+#include <ossim/imaging/ossimEquationProgram.h>
+#include <ossim/base/ossimEquTokenizer.h>
+#include <ossim/base/ossimNotify.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+
+namespace
+{
+   // Pixels per strip.  Registers are this long so they stay in cache.
+   const ossim_uint32 STRIP_SIZE = 256;
+
+   enum InstructionCode
+   {
+      LOAD_CODE         = 0, // Push input band.
+      NULL_CODE         = 1, // Push all null.
+      UNARY_CODE        = 2, // top = op(top)
+      BINARY_CODE       = 3, // Pop b, top = op(top, b)
+      SCALAR_LEFT_CODE  = 4, // top = op(value, top)
+      SCALAR_RIGHT_CODE = 5  // top = op(top, value)
+   };
+
+   struct Token
+   {
+      int         m_id;
+      std::string m_text;
+   };
+
+   //---
+   // Operators.  These must give the same values as the ossimBinaryOp and
+   // ossimUnaryOp classes of ossimEquationCombiner.
+   //---
+   struct AddOp  { double operator()(double a, double b) const { return a + b; } };
+   struct SubOp  { double operator()(double a, double b) const { return a - b; } };
+   struct MulOp  { double operator()(double a, double b) const { return a * b; } };
+   struct DivOp
+   {
+      double operator()(double a, double b) const
+      {
+         return ( std::fabs(b) > FLT_EPSILON ) ? a / b : 1.0 / FLT_EPSILON;
+      }
+   };
+   struct ModOp
+   {
+      double operator()(double a, double b) const
+      {
+         return ( std::fabs(b) > FLT_EPSILON ) ? std::fmod(a, b) : 1.0 / FLT_EPSILON;
+      }
+   };
+   struct PowOp  { double operator()(double a, double b) const { return std::pow(a, b); } };
+   struct AndOp
+   {
+      double operator()(double a, double b) const
+      {
+         return (double)( ((ossim_uint32)a) & ((ossim_uint32)b) );
+      }
+   };
+   struct OrOp
+   {
+      double operator()(double a, double b) const
+      {
+         return (double)( ((ossim_uint32)a) | ((ossim_uint32)b) );
+      }
+   };
+   struct XorOp
+   {
+      double operator()(double a, double b) const
+      {
+         return (double)( ((ossim_uint32)a) ^ ((ossim_uint32)b) );
+      }
+   };
+   struct MinOp  { double operator()(double a, double b) const { return std::min(a, b); } };
+   struct MaxOp  { double operator()(double a, double b) const { return std::max(a, b); } };
+   struct EqualOp   { double operator()(double a, double b) const { return (a == b) ? 1.0 : 0.0; } };
+   struct GreaterOp { double operator()(double a, double b) const { return (a > b) ? 1.0 : 0.0; } };
+   struct GreaterOrEqualOp
+   {
+      double operator()(double a, double b) const { return (a >= b) ? 1.0 : 0.0; }
+   };
+   struct LessOp { double operator()(double a, double b) const { return (a < b) ? 1.0 : 0.0; } };
+   struct LessOrEqualOp
+   {
+      double operator()(double a, double b) const { return (a <= b) ? 1.0 : 0.0; }
+   };
+   struct DifferentOp
+   {
+      double operator()(double a, double b) const { return (a != b) ? 1.0 : 0.0; }
+   };
+
+   inline double clampUnit(double v)
+   {
+      return ( v > 1.0 ) ? 1.0 : ( ( v < -1.0 ) ? -1.0 : v );
+   }
+
+   struct NegOp   { double operator()(double v) const { return -v; } };
+   struct OnesComplementOp
+   {
+      double operator()(double v) const { return (double)((ossim_uint8)~((ossim_uint8)v)); }
+   };
+   struct AbsOp   { double operator()(double v) const { return std::fabs(v); } };
+   struct SinOp   { double operator()(double v) const { return std::sin(v); } };
+   struct SindOp  { double operator()(double v) const { return std::sin(v*M_PI/180.0); } };
+   struct ASinOp  { double operator()(double v) const { return std::asin(clampUnit(v)); } };
+   struct ASindOp
+   {
+      double operator()(double v) const { return (180/M_PI)*std::asin(clampUnit(v)); }
+   };
+   struct CosOp   { double operator()(double v) const { return std::cos(v); } };
+   struct CosdOp  { double operator()(double v) const { return std::cos(v*M_PI/180.0); } };
+   struct ACosOp  { double operator()(double v) const { return std::acos(clampUnit(v)); } };
+   struct ACosdOp
+   {
+      double operator()(double v) const { return (180/M_PI)*std::acos(clampUnit(v)); }
+   };
+   struct TanOp   { double operator()(double v) const { return std::tan(v); } };
+   struct TandOp  { double operator()(double v) const { return std::tan(v*M_PI/180.0); } };
+   struct ATanOp  { double operator()(double v) const { return std::atan(v); } };
+   struct ATandOp { double operator()(double v) const { return (180/M_PI)*std::atan(v); } };
+   struct LogOp   { double operator()(double v) const { return std::log(v); } };
+   struct Log10Op { double operator()(double v) const { return std::log10(v); } };
+   struct SqrtOp
+   {
+      double operator()(double v) const { return ( v >= 0 ) ? std::sqrt(v) : -1; }
+   };
+   struct ExpOp   { double operator()(double v) const { return std::exp(v); } };
+
+   /** Calls kernel.run<Op>() for binary operator op.  @return false if op is unknown. */
+   template <class Kernel> bool dispatchBinary(int op, Kernel& kernel)
+   {
+      switch ( op )
+      {
+         case OSSIM_EQU_TOKEN_PLUS:            kernel.template run<AddOp>(); break;
+         case OSSIM_EQU_TOKEN_MINUS:           kernel.template run<SubOp>(); break;
+         case OSSIM_EQU_TOKEN_MULT:            kernel.template run<MulOp>(); break;
+         case OSSIM_EQU_TOKEN_DIV:             kernel.template run<DivOp>(); break;
+         case OSSIM_EQU_TOKEN_MOD:             kernel.template run<ModOp>(); break;
+         case OSSIM_EQU_TOKEN_POWER:           kernel.template run<PowOp>(); break;
+         case OSSIM_EQU_TOKEN_AMPERSAND:       kernel.template run<AndOp>(); break;
+         case OSSIM_EQU_TOKEN_OR_BAR:          kernel.template run<OrOp>(); break;
+         case OSSIM_EQU_TOKEN_XOR:             kernel.template run<XorOp>(); break;
+         case OSSIM_EQU_TOKEN_MIN:             kernel.template run<MinOp>(); break;
+         case OSSIM_EQU_TOKEN_MAX:             kernel.template run<MaxOp>(); break;
+         case OSSIM_EQU_TOKEN_BEQUAL:          kernel.template run<EqualOp>(); break;
+         case OSSIM_EQU_TOKEN_BGREATER:        kernel.template run<GreaterOp>(); break;
+         case OSSIM_EQU_TOKEN_BGREATEROREQUAL: kernel.template run<GreaterOrEqualOp>(); break;
+         case OSSIM_EQU_TOKEN_BLESS:           kernel.template run<LessOp>(); break;
+         case OSSIM_EQU_TOKEN_BLESSOREQUAL:    kernel.template run<LessOrEqualOp>(); break;
+         case OSSIM_EQU_TOKEN_BDIFFERENT:      kernel.template run<DifferentOp>(); break;
+         default:
+            return false;
+      }
+      return true;
+   }
+
+   /** Calls kernel.run<Op>() for unary operator or function op.  @return false if unknown. */
+   template <class Kernel> bool dispatchUnary(int op, Kernel& kernel)
+   {
+      switch ( op )
+      {
+         case OSSIM_EQU_TOKEN_MINUS: kernel.template run<NegOp>(); break;
+         case OSSIM_EQU_TOKEN_TILDE: kernel.template run<OnesComplementOp>(); break;
+         case OSSIM_EQU_TOKEN_ABS:   kernel.template run<AbsOp>(); break;
+         case OSSIM_EQU_TOKEN_SIN:   kernel.template run<SinOp>(); break;
+         case OSSIM_EQU_TOKEN_SIND:  kernel.template run<SindOp>(); break;
+         case OSSIM_EQU_TOKEN_ASIN:  kernel.template run<ASinOp>(); break;
+         case OSSIM_EQU_TOKEN_ASIND: kernel.template run<ASindOp>(); break;
+         case OSSIM_EQU_TOKEN_COS:   kernel.template run<CosOp>(); break;
+         case OSSIM_EQU_TOKEN_COSD:  kernel.template run<CosdOp>(); break;
+         case OSSIM_EQU_TOKEN_ACOS:  kernel.template run<ACosOp>(); break;
+         case OSSIM_EQU_TOKEN_ACOSD: kernel.template run<ACosdOp>(); break;
+         case OSSIM_EQU_TOKEN_TAN:   kernel.template run<TanOp>(); break;
+         case OSSIM_EQU_TOKEN_TAND:  kernel.template run<TandOp>(); break;
+         case OSSIM_EQU_TOKEN_ATAN:  kernel.template run<ATanOp>(); break;
+         case OSSIM_EQU_TOKEN_ATAND: kernel.template run<ATandOp>(); break;
+         case OSSIM_EQU_TOKEN_LOG:   kernel.template run<LogOp>(); break;
+         case OSSIM_EQU_TOKEN_LOG10: kernel.template run<Log10Op>(); break;
+         case OSSIM_EQU_TOKEN_SQRT:  kernel.template run<SqrtOp>(); break;
+         case OSSIM_EQU_TOKEN_EXP:   kernel.template run<ExpOp>(); break;
+         default:
+            return false;
+      }
+      return true;
+   }
+
+   // Constant folding.
+   struct FoldBinary
+   {
+      double m_a, m_b, m_result;
+      template <class Op> void run() { m_result = Op()(m_a, m_b); }
+   };
+   struct FoldUnary
+   {
+      double m_v, m_result;
+      template <class Op> void run() { m_result = Op()(m_v); }
+   };
+
+   //---
+   // Strip kernels.  Values are computed for every pixel and kept where the
+   // operands are valid, which leaves the loops free of branches.
+   //---
+   struct BinaryStrip
+   {
+      double* m_a; const double* m_b; const ossim_uint8* m_aNull; const ossim_uint8* m_bNull;
+      ossim_uint32 m_n;
+      template <class Op> void run()
+      {
+         Op op;
+         for ( ossim_uint32 i = 0; i < m_n; ++i )
+         {
+            const double R = op(m_a[i], m_b[i]);
+            m_a[i] = ( m_aNull[i] | m_bNull[i] ) ? m_a[i] : R;
+         }
+      }
+   };
+   struct ScalarLeftStrip
+   {
+      double m_value; double* m_v; const ossim_uint8* m_null; ossim_uint32 m_n;
+      template <class Op> void run()
+      {
+         Op op;
+         for ( ossim_uint32 i = 0; i < m_n; ++i )
+         {
+            const double R = op(m_value, m_v[i]);
+            m_v[i] = m_null[i] ? m_v[i] : R;
+         }
+      }
+   };
+   struct ScalarRightStrip
+   {
+      double m_value; double* m_v; const ossim_uint8* m_null; ossim_uint32 m_n;
+      template <class Op> void run()
+      {
+         Op op;
+         for ( ossim_uint32 i = 0; i < m_n; ++i )
+         {
+            const double R = op(m_v[i], m_value);
+            m_v[i] = m_null[i] ? m_v[i] : R;
+         }
+      }
+   };
+   struct UnaryStrip
+   {
+      double* m_v; const ossim_uint8* m_null; ossim_uint32 m_n;
+      template <class Op> void run()
+      {
+         Op op;
+         for ( ossim_uint32 i = 0; i < m_n; ++i )
+         {
+            const double R = op(m_v[i]);
+            m_v[i] = m_null[i] ? m_v[i] : R;
+         }
+      }
+   };
+
+   /**
+    * Reads n pixels as ossimCastTileSourceFilter would cast them to float64:
+    * clamped to the band range, null where a partial tile holds the null.
+    */
+   template <class T> void loadStrip(const T* in,
+                                     ossim_uint32 n,
+                                     bool partial,
+                                     double nullPix,
+                                     double minPix,
+                                     double maxPix,
+                                     double* values,
+                                     ossim_uint8* nulls)
+   {
+      const T NP = static_cast<T>(nullPix);
+      for ( ossim_uint32 i = 0; i < n; ++i )
+      {
+         const double D = in[i];
+         values[i] = ( D < minPix ) ? minPix : ( ( D > maxPix ) ? maxPix : D );
+      }
+      if ( partial )
+      {
+         for ( ossim_uint32 i = 0; i < n; ++i )
+         {
+            nulls[i] = ( in[i] == NP ) ? 1 : 0;
+         }
+      }
+      else
+      {
+         std::fill(nulls, nulls + n, 0);
+      }
+   }
+
+   template <class T> bool hasValidPixel(const T* in, ossim_uint32 n, double nullPix)
+   {
+      const T NP = static_cast<T>(nullPix);
+      for ( ossim_uint32 i = 0; i < n; ++i )
+      {
+         if ( in[i] != NP )
+         {
+            return true;
+         }
+      }
+      return false;
+   }
+
+   /** @return true if the scalar type is one ossimCastTileSourceFilter casts. */
+   bool isLoadable(ossimScalarType scalar)
+   {
+      switch ( scalar )
+      {
+         case OSSIM_UINT8:
+         case OSSIM_SINT8:
+         case OSSIM_UINT16:
+         case OSSIM_USHORT11:
+         case OSSIM_USHORT12:
+         case OSSIM_USHORT13:
+         case OSSIM_USHORT14:
+         case OSSIM_USHORT15:
+         case OSSIM_SINT16:
+         case OSSIM_UINT32:
+         case OSSIM_SINT32:
+         case OSSIM_FLOAT32:
+         case OSSIM_NORMALIZED_FLOAT:
+         case OSSIM_FLOAT64:
+         case OSSIM_NORMALIZED_DOUBLE:
+            return true;
+         default:
+            return false;
+      }
+   }
+
+   void loadStrip(const ossimImageData* tile,
+                  ossim_uint32 band,
+                  ossim_uint32 offset,
+                  ossim_uint32 n,
+                  double* values,
+                  ossim_uint8* nulls)
+   {
+      const bool   PARTIAL = ( tile->getDataObjectStatus() == OSSIM_PARTIAL );
+      const double NP      = tile->getNullPix(band);
+      const double MIN     = tile->getMinPix(band);
+      const double MAX     = tile->getMaxPix(band);
+      const void*  BUF     = tile->getBuf(band);
+
+      switch ( tile->getScalarType() )
+      {
+         case OSSIM_UINT8:
+            loadStrip(static_cast<const ossim_uint8*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+         case OSSIM_SINT8:
+            loadStrip(static_cast<const ossim_sint8*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+         case OSSIM_UINT16:
+         case OSSIM_USHORT11:
+         case OSSIM_USHORT12:
+         case OSSIM_USHORT13:
+         case OSSIM_USHORT14:
+         case OSSIM_USHORT15:
+            loadStrip(static_cast<const ossim_uint16*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+         case OSSIM_SINT16:
+            loadStrip(static_cast<const ossim_sint16*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+         case OSSIM_UINT32:
+            loadStrip(static_cast<const ossim_uint32*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+         case OSSIM_SINT32:
+            loadStrip(static_cast<const ossim_sint32*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+         case OSSIM_FLOAT32:
+         case OSSIM_NORMALIZED_FLOAT:
+            loadStrip(static_cast<const ossim_float32*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+         default: // OSSIM_FLOAT64, OSSIM_NORMALIZED_DOUBLE
+            loadStrip(static_cast<const ossim_float64*>(BUF) + offset, n, PARTIAL, NP, MIN, MAX,
+                      values, nulls);
+            break;
+      }
+   }
+
+   /** @return true if the band of a partial tile holds only nulls. */
+   bool isBandEmpty(const ossimImageData* tile, ossim_uint32 band)
+   {
+      const ossim_uint32 N  = tile->getSizePerBand();
+      const double       NP = tile->getNullPix(band);
+      const void*        BUF = tile->getBuf(band);
+      switch ( tile->getScalarType() )
+      {
+         case OSSIM_UINT8:
+            return !hasValidPixel(static_cast<const ossim_uint8*>(BUF), N, NP);
+         case OSSIM_SINT8:
+            return !hasValidPixel(static_cast<const ossim_sint8*>(BUF), N, NP);
+         case OSSIM_UINT16:
+         case OSSIM_USHORT11:
+         case OSSIM_USHORT12:
+         case OSSIM_USHORT13:
+         case OSSIM_USHORT14:
+         case OSSIM_USHORT15:
+            return !hasValidPixel(static_cast<const ossim_uint16*>(BUF), N, NP);
+         case OSSIM_SINT16:
+            return !hasValidPixel(static_cast<const ossim_sint16*>(BUF), N, NP);
+         case OSSIM_UINT32:
+            return !hasValidPixel(static_cast<const ossim_uint32*>(BUF), N, NP);
+         case OSSIM_SINT32:
+            return !hasValidPixel(static_cast<const ossim_sint32*>(BUF), N, NP);
+         case OSSIM_FLOAT32:
+         case OSSIM_NORMALIZED_FLOAT:
+            return !hasValidPixel(static_cast<const ossim_float32*>(BUF), N, NP);
+         default:
+            return !hasValidPixel(static_cast<const ossim_float64*>(BUF), N, NP);
+      }
+   }
+}
+
+/**
+ * Recursive descent parser following the ossimEquationCombiner grammar,
+ * building nodes instead of evaluating.  Parse methods return the node
+ * index or -1 on an error or a function only the interpreter supports.
+ */
+class ossimEquationProgram::Parser
+{
+public:
+   Parser(ossimEquationProgram* program, const std::vector<Token>& tokens)
+      :
+      m_program(program),
+      m_tokens(tokens),
+      m_position(0)
+   {
+   }
+
+   bool atEnd() const
+   {
+      return ( m_position >= m_tokens.size() );
+   }
+
+   int current() const
+   {
+      return atEnd() ? 0 : m_tokens[m_position].m_id;
+   }
+
+   void next()
+   {
+      ++m_position;
+   }
+
+   // Expression : Term { (+|-) Term }
+   ossim_int32 parseExpression()
+   {
+      ossim_int32 result = parseTerm();
+      while ( ( result >= 0 ) &&
+              ( ( current() == OSSIM_EQU_TOKEN_PLUS ) || ( current() == OSSIM_EQU_TOKEN_MINUS ) ) )
+      {
+         int op = current();
+         next();
+         ossim_int32 right = parseTerm();
+         result = ( right >= 0 ) ? makeBinary(op, result, right) : -1;
+      }
+      return result;
+   }
+
+private:
+   static bool isTermOp(int id)
+   {
+      switch ( id )
+      {
+         case OSSIM_EQU_TOKEN_MULT:
+         case OSSIM_EQU_TOKEN_DIV:
+         case OSSIM_EQU_TOKEN_XOR:
+         case OSSIM_EQU_TOKEN_AMPERSAND:
+         case OSSIM_EQU_TOKEN_OR_BAR:
+         case OSSIM_EQU_TOKEN_MOD:
+         case OSSIM_EQU_TOKEN_POWER:
+         case OSSIM_EQU_TOKEN_BEQUAL:
+         case OSSIM_EQU_TOKEN_BGREATER:
+         case OSSIM_EQU_TOKEN_BGREATEROREQUAL:
+         case OSSIM_EQU_TOKEN_BLESS:
+         case OSSIM_EQU_TOKEN_BLESSOREQUAL:
+         case OSSIM_EQU_TOKEN_BDIFFERENT:
+            return true;
+         default:
+            return false;
+      }
+   }
+
+   // Term : Factor { op Factor }
+   ossim_int32 parseTerm()
+   {
+      ossim_int32 result = parseFactor();
+      while ( ( result >= 0 ) && isTermOp( current() ) )
+      {
+         int op = current();
+         next();
+         ossim_int32 right = parseFactor();
+         result = ( right >= 0 ) ? makeBinary(op, result, right) : -1;
+      }
+      return result;
+   }
+
+   ossim_int32 parseFactor()
+   {
+      ossim_int32 result = -1;
+      const int ID = current();
+      switch ( ID )
+      {
+         case OSSIM_EQU_TOKEN_CONSTANT:
+         {
+            result = makeConstant( std::atof( m_tokens[m_position].m_text.c_str() ) );
+            next();
+            break;
+         }
+         case OSSIM_EQU_TOKEN_PI:
+         {
+            result = makeConstant(M_PI);
+            next();
+            break;
+         }
+         case OSSIM_EQU_TOKEN_IMAGE_VARIABLE:
+         {
+            next();
+            if ( current() == OSSIM_EQU_TOKEN_LEFT_ARRAY_BRACKET )
+            {
+               next();
+               ossim_int32 index = parseExpression();
+               if ( ( index >= 0 ) &&
+                    ( m_program->m_nodes[index].m_type == CONSTANT_NODE ) &&
+                    ( current() == OSSIM_EQU_TOKEN_RIGHT_ARRAY_BRACKET ) )
+               {
+                  next();
+                  Node node = newNode(INPUT_NODE);
+                  node.m_input = (ossim_uint32)m_program->m_nodes[index].m_value;
+                  result = m_program->addNode(node);
+               }
+            }
+            break;
+         }
+         case OSSIM_EQU_TOKEN_LEFT_PAREN:
+         {
+            next();
+            result = parseExpression();
+            if ( current() == OSSIM_EQU_TOKEN_RIGHT_PAREN )
+            {
+               next();
+            }
+            else
+            {
+               result = -1;
+            }
+            break;
+         }
+         case OSSIM_EQU_TOKEN_MINUS:
+         case OSSIM_EQU_TOKEN_TILDE:
+         {
+            next();
+            ossim_int32 operand = parseFactor();
+            if ( operand >= 0 )
+            {
+               result = makeUnary(ID, operand);
+            }
+            break;
+         }
+         case OSSIM_EQU_TOKEN_MIN:
+         case OSSIM_EQU_TOKEN_MAX:
+         {
+            next();
+            std::vector<ossim_int32> args;
+            if ( parseArgs(args) && ( args.size() > 1 ) )
+            {
+               // The interpreter folds from the right: min(a, min(b, c)).
+               result = args.back();
+               for ( ossim_int32 i = (ossim_int32)args.size() - 2; i >= 0; --i )
+               {
+                  result = makeBinary(ID, args[i], result);
+               }
+            }
+            break;
+         }
+         case OSSIM_EQU_TOKEN_BAND:
+         {
+            next();
+            std::vector<ossim_int32> args;
+            if ( parseArgs(args) && ( args.size() == 2 ) &&
+                 ( m_program->m_nodes[args[0]].m_type == INPUT_NODE ) &&
+                 ( m_program->m_nodes[args[1]].m_type == CONSTANT_NODE ) )
+            {
+               Node node = newNode(BAND_NODE);
+               node.m_input = m_program->m_nodes[args[0]].m_input;
+               node.m_band  = (ossim_uint32)m_program->m_nodes[args[1]].m_value;
+               result = m_program->addNode(node);
+            }
+            break;
+         }
+         case OSSIM_EQU_TOKEN_ABS:
+         case OSSIM_EQU_TOKEN_SIN:
+         case OSSIM_EQU_TOKEN_SIND:
+         case OSSIM_EQU_TOKEN_ASIN:
+         case OSSIM_EQU_TOKEN_ASIND:
+         case OSSIM_EQU_TOKEN_COS:
+         case OSSIM_EQU_TOKEN_COSD:
+         case OSSIM_EQU_TOKEN_ACOS:
+         case OSSIM_EQU_TOKEN_ACOSD:
+         case OSSIM_EQU_TOKEN_TAN:
+         case OSSIM_EQU_TOKEN_TAND:
+         case OSSIM_EQU_TOKEN_ATAN:
+         case OSSIM_EQU_TOKEN_ATAND:
+         case OSSIM_EQU_TOKEN_LOG:
+         case OSSIM_EQU_TOKEN_LOG10:
+         case OSSIM_EQU_TOKEN_SQRT:
+         case OSSIM_EQU_TOKEN_EXP:
+         {
+            next();
+            if ( current() == OSSIM_EQU_TOKEN_LEFT_PAREN )
+            {
+               next();
+               ossim_int32 operand = parseExpression();
+               if ( ( operand >= 0 ) && ( current() == OSSIM_EQU_TOKEN_RIGHT_PAREN ) )
+               {
+                  next();
+                  result = makeUnary(ID, operand);
+               }
+            }
+            break;
+         }
+         default:
+         {
+            // shift, blurr, conv, assign_band, clamp or a syntax error.
+            break;
+         }
+      }
+      return result;
+   }
+
+   // ( Expression { , Expression } )
+   bool parseArgs(std::vector<ossim_int32>& args)
+   {
+      if ( current() != OSSIM_EQU_TOKEN_LEFT_PAREN )
+      {
+         return false;
+      }
+      next();
+      while ( true )
+      {
+         ossim_int32 arg = parseExpression();
+         if ( arg < 0 )
+         {
+            return false;
+         }
+         args.push_back(arg);
+         if ( current() == OSSIM_EQU_TOKEN_RIGHT_PAREN )
+         {
+            next();
+            return true;
+         }
+         if ( current() != OSSIM_EQU_TOKEN_COMMA )
+         {
+            return false;
+         }
+         next();
+      }
+   }
+
+   static Node newNode(NodeType type)
+   {
+      Node node;
+      node.m_type  = type;
+      node.m_op    = 0;
+      node.m_value = 0.0;
+      node.m_input = 0;
+      node.m_band  = 0;
+      node.m_left  = -1;
+      node.m_right = -1;
+      return node;
+   }
+
+   ossim_int32 makeConstant(double value)
+   {
+      Node node = newNode(CONSTANT_NODE);
+      node.m_value = value;
+      return m_program->addNode(node);
+   }
+
+   ossim_int32 makeBinary(int op, ossim_int32 left, ossim_int32 right)
+   {
+      const Node& L = m_program->m_nodes[left];
+      const Node& R = m_program->m_nodes[right];
+      if ( ( L.m_type == CONSTANT_NODE ) && ( R.m_type == CONSTANT_NODE ) )
+      {
+         FoldBinary fold = { L.m_value, R.m_value, 0.0 };
+         dispatchBinary(op, fold);
+         return makeConstant(fold.m_result);
+      }
+      Node node = newNode(BINARY_NODE);
+      node.m_op    = op;
+      node.m_left  = left;
+      node.m_right = right;
+      return m_program->addNode(node);
+   }
+
+   ossim_int32 makeUnary(int op, ossim_int32 operand)
+   {
+      const Node& V = m_program->m_nodes[operand];
+      if ( V.m_type == CONSTANT_NODE )
+      {
+         FoldUnary fold = { V.m_value, 0.0 };
+         dispatchUnary(op, fold);
+         return makeConstant(fold.m_result);
+      }
+      Node node = newNode(UNARY_NODE);
+      node.m_op   = op;
+      node.m_left = operand;
+      return m_program->addNode(node);
+   }
+
+   ossimEquationProgram*     m_program;
+   const std::vector<Token>& m_tokens;
+   std::vector<Token>::size_type m_position;
+};
+
+ossimEquationProgram::ossimEquationProgram()
+   :
+   m_equation(),
+   m_compiled(false),
+   m_nodes(),
+   m_root(-1),
+   m_inputIndexes()
+{
+}
+
+bool ossimEquationProgram::compile(const ossimString& equation)
+{
+   m_equation = equation;
+   m_compiled = false;
+   m_nodes.clear();
+   m_root = -1;
+   m_inputIndexes.clear();
+
+   std::vector<Token> tokens;
+   std::istringstream in( equation.string() );
+   ossimEquTokenizer lexer;
+   lexer.switch_streams(&in, &ossimNotify(ossimNotifyLevel_WARN));
+   int id = lexer.yylex();
+   while ( id )
+   {
+      Token token;
+      token.m_id   = id;
+      token.m_text = lexer.YYText();
+      tokens.push_back(token);
+      id = lexer.yylex();
+   }
+
+   if ( tokens.size() )
+   {
+      Parser parser(this, tokens);
+      m_root = parser.parseExpression();
+      m_compiled = ( ( m_root >= 0 ) && parser.atEnd() );
+   }
+
+   if ( m_compiled )
+   {
+      for ( std::vector<Node>::const_iterator i = m_nodes.begin(); i != m_nodes.end(); ++i )
+      {
+         if ( ( i->m_type == INPUT_NODE ) || ( i->m_type == BAND_NODE ) )
+         {
+            m_inputIndexes.push_back(i->m_input);
+         }
+      }
+      std::sort(m_inputIndexes.begin(), m_inputIndexes.end());
+      m_inputIndexes.erase(std::unique(m_inputIndexes.begin(), m_inputIndexes.end()),
+                           m_inputIndexes.end());
+   }
+   else
+   {
+      m_nodes.clear();
+      m_root = -1;
+   }
+
+   return m_compiled;
+}
+
+bool ossimEquationProgram::isCompiled() const
+{
+   return m_compiled;
+}
+
+const ossimString& ossimEquationProgram::getEquation() const
+{
+   return m_equation;
+}
+
+const std::vector<ossim_uint32>& ossimEquationProgram::getInputIndexes() const
+{
+   return m_inputIndexes;
+}
+
+bool ossimEquationProgram::evaluate(const std::vector< ossimRefPtr<ossimImageData> >& inputs,
+                                    ossimImageData* result) const
+{
+   if ( !m_compiled || !result || !result->getBuf() ||
+        ( result->getScalarType() != OSSIM_FLOAT64 ) )
+   {
+      return false;
+   }
+
+   const ossim_uint32 BANDS = result->getNumberOfBands();
+   const ossim_uint32 SIZE  = result->getSizePerBand();
+   const Node& ROOT = m_nodes[m_root];
+
+   if ( ROOT.m_type == CONSTANT_NODE )
+   {
+      ossim_float64* buf = static_cast<ossim_float64*>( result->getBuf() );
+      std::fill(buf, buf + result->getSize(), ROOT.m_value);
+      return true;
+   }
+
+   std::vector<NodeState> states( m_nodes.size() );
+   if ( !computeState(m_root, inputs, SIZE, states) )
+   {
+      return false;
+   }
+   if ( states[m_root].m_empty )
+   {
+      return true; // Nothing to assign, the tile stays blank.
+   }
+
+   // One instruction list per output band.  Bands past the result's repeat its last.
+   std::vector< std::vector<Instruction> > programs(BANDS);
+   ossim_uint32 maxDepth = 0;
+   for ( ossim_uint32 band = 0; band < BANDS; ++band )
+   {
+      ossim_uint32 depth = 0;
+      emit(m_root, std::min(band, states[m_root].m_bands - 1), states, programs[band],
+           depth, maxDepth);
+   }
+
+   std::vector<double>      values(maxDepth * STRIP_SIZE);
+   std::vector<ossim_uint8> nulls(maxDepth * STRIP_SIZE);
+
+   for ( ossim_uint32 band = 0; band < BANDS; ++band )
+   {
+      const std::vector<Instruction>& program = programs[band];
+      ossim_float64* out = static_cast<ossim_float64*>( result->getBuf(band) );
+
+      for ( ossim_uint32 offset = 0; offset < SIZE; offset += STRIP_SIZE )
+      {
+         const ossim_uint32 N = std::min(STRIP_SIZE, SIZE - offset);
+         ossim_uint32 top = 0; // Registers in use.
+
+         for ( std::vector<Instruction>::const_iterator i = program.begin();
+               i != program.end(); ++i )
+         {
+            switch ( i->m_code )
+            {
+               case LOAD_CODE:
+               {
+                  loadStrip(inputs[i->m_input].get(), i->m_band, offset, N,
+                            &values[top * STRIP_SIZE], &nulls[top * STRIP_SIZE]);
+                  ++top;
+                  break;
+               }
+               case NULL_CODE:
+               {
+                  std::fill(nulls.begin() + top * STRIP_SIZE,
+                            nulls.begin() + top * STRIP_SIZE + N, 1);
+                  ++top;
+                  break;
+               }
+               case UNARY_CODE:
+               {
+                  UnaryStrip kernel = { &values[(top-1) * STRIP_SIZE],
+                                        &nulls[(top-1) * STRIP_SIZE], N };
+                  dispatchUnary(i->m_op, kernel);
+                  break;
+               }
+               case BINARY_CODE:
+               {
+                  BinaryStrip kernel = { &values[(top-2) * STRIP_SIZE],
+                                         &values[(top-1) * STRIP_SIZE],
+                                         &nulls[(top-2) * STRIP_SIZE],
+                                         &nulls[(top-1) * STRIP_SIZE], N };
+                  dispatchBinary(i->m_op, kernel);
+                  --top;
+                  break;
+               }
+               case SCALAR_LEFT_CODE:
+               {
+                  ScalarLeftStrip kernel = { i->m_value, &values[(top-1) * STRIP_SIZE],
+                                             &nulls[(top-1) * STRIP_SIZE], N };
+                  dispatchBinary(i->m_op, kernel);
+                  break;
+               }
+               case SCALAR_RIGHT_CODE:
+               {
+                  ScalarRightStrip kernel = { i->m_value, &values[(top-1) * STRIP_SIZE],
+                                              &nulls[(top-1) * STRIP_SIZE], N };
+                  dispatchBinary(i->m_op, kernel);
+                  break;
+               }
+               default:
+                  break;
+            }
+         }
+
+         // Assign the valid pixels; the rest keep the null of the blank result.
+         const double*      V = &values.front();
+         const ossim_uint8* M = &nulls.front();
+         for ( ossim_uint32 i = 0; i < N; ++i )
+         {
+            out[offset + i] = M[i] ? out[offset + i] : V[i];
+         }
+      }
+   }
+
+   return true;
+}
+
+ossim_int32 ossimEquationProgram::addNode(const Node& node)
+{
+   m_nodes.push_back(node);
+   return (ossim_int32)m_nodes.size() - 1;
+}
+
+bool ossimEquationProgram::computeState(
+   ossim_int32 nodeIndex,
+   const std::vector< ossimRefPtr<ossimImageData> >& inputs,
+   ossim_uint32 size,
+   std::vector<NodeState>& states) const
+{
+   const Node& node = m_nodes[nodeIndex];
+   NodeState& state = states[nodeIndex];
+   state.m_bands = 0;
+   state.m_empty = false;
+
+   switch ( node.m_type )
+   {
+      case CONSTANT_NODE:
+      {
+         break;
+      }
+      case INPUT_NODE:
+      case BAND_NODE:
+      {
+         if ( ( node.m_input >= inputs.size() ) || !inputs[node.m_input].valid() )
+         {
+            return false;
+         }
+         const ossimImageData* tile = inputs[node.m_input].get();
+         const ossimDataObjectStatus STATUS = tile->getDataObjectStatus();
+         const ossim_uint32 TILE_BANDS = tile->getNumberOfBands();
+         if ( !TILE_BANDS || ( tile->getSizePerBand() != size ) ||
+              ( ( node.m_type == BAND_NODE ) && ( node.m_band >= TILE_BANDS ) ) )
+         {
+            return false;
+         }
+
+         // Empty is what validate() reports after the cast, i.e. no valid pixel.
+         if ( ( STATUS == OSSIM_EMPTY ) || ( STATUS == OSSIM_NULL ) )
+         {
+            state.m_empty = true;
+         }
+         else if ( !tile->getBuf() || !isLoadable( tile->getScalarType() ) )
+         {
+            return false;
+         }
+         else if ( STATUS == OSSIM_PARTIAL )
+         {
+            if ( node.m_type == BAND_NODE )
+            {
+               state.m_empty = isBandEmpty(tile, node.m_band);
+            }
+            else
+            {
+               state.m_empty = true;
+               for ( ossim_uint32 band = 0; ( band < TILE_BANDS ) && state.m_empty; ++band )
+               {
+                  state.m_empty = isBandEmpty(tile, band);
+               }
+            }
+         }
+         state.m_bands = ( node.m_type == BAND_NODE ) ? 1 : TILE_BANDS;
+         break;
+      }
+      case UNARY_NODE:
+      {
+         if ( !computeState(node.m_left, inputs, size, states) )
+         {
+            return false;
+         }
+         state = states[node.m_left];
+         break;
+      }
+      case BINARY_NODE:
+      {
+         if ( !computeState(node.m_left, inputs, size, states) ||
+              !computeState(node.m_right, inputs, size, states) )
+         {
+            return false;
+         }
+         const NodeState& LEFT  = states[node.m_left];
+         const NodeState& RIGHT = states[node.m_right];
+         if ( m_nodes[node.m_left].m_type == CONSTANT_NODE )
+         {
+            state = RIGHT;
+         }
+         else if ( m_nodes[node.m_right].m_type == CONSTANT_NODE )
+         {
+            state = LEFT;
+         }
+         else
+         {
+            //---
+            // The interpreter repeats the last band of a right operand with
+            // fewer bands but folds all bands of a longer right operand into
+            // the last band of the left.  Leave the latter to it.
+            //---
+            if ( LEFT.m_bands < RIGHT.m_bands )
+            {
+               return false;
+            }
+            state.m_bands = LEFT.m_bands;
+            state.m_empty = LEFT.m_empty && RIGHT.m_empty;
+         }
+         break;
+      }
+   }
+   return true;
+}
+
+void ossimEquationProgram::emit(ossim_int32 nodeIndex,
+                                ossim_uint32 band,
+                                const std::vector<NodeState>& states,
+                                std::vector<Instruction>& program,
+                                ossim_uint32& depth,
+                                ossim_uint32& maxDepth) const
+{
+   const Node& node = m_nodes[nodeIndex];
+   Instruction instruction = { NULL_CODE, node.m_op, 0.0, 0, 0 };
+
+   if ( states[nodeIndex].m_empty )
+   {
+      program.push_back(instruction);
+      ++depth;
+   }
+   else
+   {
+      switch ( node.m_type )
+      {
+         case INPUT_NODE:
+         case BAND_NODE:
+         {
+            instruction.m_code  = LOAD_CODE;
+            instruction.m_input = node.m_input;
+            instruction.m_band  = ( node.m_type == BAND_NODE ) ? node.m_band : band;
+            program.push_back(instruction);
+            ++depth;
+            break;
+         }
+         case UNARY_NODE:
+         {
+            emit(node.m_left, band, states, program, depth, maxDepth);
+            instruction.m_code = UNARY_CODE;
+            program.push_back(instruction);
+            break;
+         }
+         case BINARY_NODE:
+         {
+            const Node& LEFT  = m_nodes[node.m_left];
+            const Node& RIGHT = m_nodes[node.m_right];
+            if ( LEFT.m_type == CONSTANT_NODE )
+            {
+               emit(node.m_right, band, states, program, depth, maxDepth);
+               instruction.m_code  = SCALAR_LEFT_CODE;
+               instruction.m_value = LEFT.m_value;
+               program.push_back(instruction);
+            }
+            else if ( RIGHT.m_type == CONSTANT_NODE )
+            {
+               emit(node.m_left, band, states, program, depth, maxDepth);
+               instruction.m_code  = SCALAR_RIGHT_CODE;
+               instruction.m_value = RIGHT.m_value;
+               program.push_back(instruction);
+            }
+            else
+            {
+               const ossim_uint32 RIGHT_BAND = std::min(band, states[node.m_right].m_bands - 1);
+               if ( states[node.m_left].m_empty )
+               {
+                  // An empty left operand takes the right one's values.
+                  emit(node.m_right, RIGHT_BAND, states, program, depth, maxDepth);
+               }
+               else
+               {
+                  emit(node.m_left, band, states, program, depth, maxDepth);
+                  emit(node.m_right, RIGHT_BAND, states, program, depth, maxDepth);
+                  instruction.m_code = BINARY_CODE;
+                  program.push_back(instruction);
+                  --depth;
+               }
+            }
+            break;
+         }
+         default:
+            break;
+      }
+   }
+
+   maxDepth = std::max(maxDepth, depth);
+}
@@ -22,6 +22,168 @@
 #include <ossim/base/ossimDpt.h>
 #include <ossim/base/ossimDrect.h>
 #include <ossim/imaging/ossimFilterTable.h>
+#include <ossim/imaging/ossimImageDataKernels.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+   /** Per tile constants of the 2-D kernel loop. */
+   template <class T>
+   struct FilterTileInfo
+   {
+      const ossimFilterTable* table;
+      const T* const*         inputBuf;
+      ossim_uint32            bands;
+      ossim_uint32            inWidth;
+      ossim_uint32            inBandSize;
+      ossim_uint32            xkernelWidth;
+      ossim_uint32            ykernelHeight;
+      double                  xkernelHalfWidth;
+      double                  ykernelHalfHeight;
+      const ossim_float64*    nullPix;
+      const ossim_float64*    minPix;
+      const ossim_float64*    maxPix;
+      ossim_float64*          densityvals; // bands scratch values
+      ossim_float64*          pixelvals;   // bands scratch values
+   };
+
+   /**
+    * Applies the 2-D filter kernel centered at input point (pointx, pointy) and
+    * writes each band to resultBuf[band][resultX].
+    */
+   template <class T>
+   void filterPixel(const FilterTileInfo<T>& info,
+                    double pointx,
+                    double pointy,
+                    T* const* resultBuf,
+                    ossim_uint32 resultX)
+   {
+      const ossim_uint32   BANDS        = info.bands;
+      const ossim_uint32   inWidth      = info.inWidth;
+      const ossim_uint32   inBandSize   = info.inBandSize;
+      const ossim_float64* NULL_PIX     = info.nullPix;
+      const ossim_float64* MIN_PIX      = info.minPix;
+      const ossim_float64* MAX_PIX      = info.maxPix;
+      const T* const*      inputBuf     = info.inputBuf;
+      ossim_float64*       densityvals  = info.densityvals;
+      ossim_float64*       pixelvals    = info.pixelvals;
+      
+      const double* kernel;
+      ossim_uint32 band,iy,ix,sourceIndex,nullCount,centerOffset;
+      ossim_int32 starty,startx;
+      ossim_float64 tmpFlt64;
+
+      starty  = ossim::round<int>(pointy - info.ykernelHalfHeight + .5);
+      startx  = ossim::round<int>(pointx - info.xkernelHalfWidth + .5);
+      centerOffset = ossim::round<int>(pointy)*inWidth + ossim::round<int>(pointx);
+      sourceIndex = starty*inWidth+startx;
+
+      // look at center pixel, make sure they aren't all null.
+      nullCount=0;
+      if(centerOffset<inBandSize)
+      {
+         for (band=0;band<BANDS;++band)
+         {
+            if(inputBuf[band][centerOffset]==static_cast<T>(NULL_PIX[band]))
+            {
+               ++nullCount;
+            }
+         }
+         // the center of the kernel is outside the input space, just set null.
+      }
+      else
+      {
+         nullCount=BANDS;
+      }
+
+      // make sure we have non-null data and we fit within the inputBuf.
+      if ( nullCount==BANDS || (sourceIndex>=inBandSize))
+      {
+         // we don't need to continue, just assign null!
+         for (band=0;band<BANDS;++band)
+         {
+            resultBuf[band][resultX] = static_cast<T>(NULL_PIX[band]);
+         }
+      }
+      else
+      {  
+         kernel = info.table->getClosestWeights(pointx,pointy);
+         if(kernel)
+         {
+            // reset the pixel/density sums for each band to zero.
+            memset(densityvals,'\0',sizeof(ossim_float64)*BANDS);
+            memset(pixelvals,'\0',sizeof(ossim_float64)*BANDS);
+
+            // apply kernel to input space.
+            for (iy=0;((iy<info.ykernelHeight)&&(sourceIndex<inBandSize));++iy)
+            {
+               for (ix = 0;((ix<info.xkernelWidth)&&(sourceIndex<inBandSize));++ix)
+               {
+                  tmpFlt64=*kernel; // pixel weight;
+                  for(band=0;band<BANDS;++band)
+                  {
+                     if(inputBuf[band][sourceIndex]!=NULL_PIX[band])
+                     {
+                        densityvals[band] += tmpFlt64;
+                        pixelvals[band] += (inputBuf[band][sourceIndex]*tmpFlt64);
+                     }
+                  }
+                  ++sourceIndex;
+                  ++kernel;
+                  if(sourceIndex>=inBandSize)
+                  {
+                     break;
+                  }
+               }
+               sourceIndex+=(inWidth-info.xkernelWidth);
+            }
+
+            // actually assign the value to the output
+            for (band = 0; band < BANDS; ++band)
+            {
+               if(densityvals[band]<=FLT_EPSILON)
+               {
+                  //---
+                  // Setting tempFlt64 to pixelvals[band] causing 0's where -32768
+                  // should be when null check was skipped above.
+                  // tmpFlt64 = pixelvals[band];
+                  //---
+                  tmpFlt64 = NULL_PIX[band];
+               }
+               else
+               {
+                  // normalize
+                  tmpFlt64 = pixelvals[band]/densityvals[band];
+               }
+               
+               // clamp
+               tmpFlt64 = (tmpFlt64>=MIN_PIX[band]?(tmpFlt64<MAX_PIX[band]?tmpFlt64:MAX_PIX[band]):MIN_PIX[band]); 
+               // set resultant pixel value.
+               resultBuf[band][resultX] = static_cast<T>(tmpFlt64);
+            }
+
+            // we didn't get a filter kernel, just set NULL in this disaster.
+         }
+         else
+         {
+            for (band=0;band<BANDS;++band)
+            {
+               resultBuf[band][resultX] = static_cast<T>(NULL_PIX[band]);
+            }
+         }                  
+      }
+   }
+
+   inline ossim_float64 clampPix(ossim_float64 v, ossim_float64 minPix, ossim_float64 maxPix)
+   {
+      return (v>=minPix?(v<maxPix?v:maxPix):minPix);
+   }
+}
+
 ossimFilterResampler::ossimFilterResampler()
    :theMinifyFilter(new ossimNearestNeighborFilter()),
     theMagnifyFilter(new ossimNearestNeighborFilter()),
@@ -29,7 +191,8 @@ ossimFilterResampler::ossimFilterResampler()
     theMagnifyFilterType(ossimFilterResampler_NEAREST_NEIGHBOR),
     theScaleFactor(1.0, 1.0),
     theInverseScaleFactor(1.0, 1.0),
-    theBlurFactor(1.0)
+    theBlurFactor(1.0),
+    theSeparableFlag(true)
 {
    setScaleFactor(ossimDpt(1.0, 1.0));
    loadState(ossimPreferences::instance()->preferencesKWL(),"resampler.");
@@ -330,9 +493,15 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
              << "deltaUr= " << deltaUr << std::endl
              << "outlength= " << outLength << std::endl;
 #endif
+
+   if ( resampleSeparableTile(T(0), input, output, outputSubRect, inputUl, inputUr,
+                              deltaUl, deltaUr, outLength) )
+   {
+      return;
+   }
    
    ossim_uint32  band, centerOffset;
-   ossim_float64 tmpFlt64, stepSizeWidth;
+   ossim_float64 stepSizeWidth;
 
    if(outLength.x>1) {
       stepSizeWidth  = 1.0/(outLength.x-1.0);
@@ -386,7 +555,6 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
    double terminalx = inputUr.x-inputRect.ul().x;
    double terminaly = inputUr.y-inputRect.ul().y;
    double pointx,pointy,deltaX,deltaY;
-   ossim_int32 starty,startx; 
 
    if(xkernel_width==0 || ykernel_height==0)
    {
@@ -427,8 +595,22 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
    else
    {
       // USING A KERNEL
-      const double* kernel;
-      ossim_uint32 iy,ix,sourceIndex,nullCount;
+      FilterTileInfo<T> info;
+      info.table             = &theFilterTable;
+      info.inputBuf          = inputBuf;
+      info.bands             = BANDS;
+      info.inWidth           = inWidth;
+      info.inBandSize        = inBandSize;
+      info.xkernelWidth      = xkernel_width;
+      info.ykernelHeight     = ykernel_height;
+      info.xkernelHalfWidth  = xkernel_half_width;
+      info.ykernelHalfHeight = ykernel_half_height;
+      info.nullPix           = NULL_PIX;
+      info.minPix            = MIN_PIX;
+      info.maxPix            = MAX_PIX;
+      info.densityvals       = densityvals;
+      info.pixelvals         = pixelvals;
+
       for(ossim_uint32 resultY = 0; resultY < resultRectH; ++resultY)
       {
          deltaX = (terminalx-initialx) * stepSizeWidth;
@@ -437,105 +619,7 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
          pointy = initialy;
          for(ossim_uint32 resultX = 0; resultX < resultRectW; ++resultX)
          {
-            starty  = ossim::round<int>(pointy - ykernel_half_height + .5);
-            startx  = ossim::round<int>(pointx - xkernel_half_width + .5);
-            centerOffset = ossim::round<int>(pointy)*inWidth + ossim::round<int>(pointx);
-            sourceIndex = starty*inWidth+startx;
-
-            // look at center pixel, make sure they aren't all null.
-            nullCount=0;
-            if(centerOffset<inBandSize)
-            {
-               for (band=0;band<BANDS;++band)
-               {
-                  if(inputBuf[band][centerOffset]==static_cast<T>(NULL_PIX[band]))
-                  {
-                     ++nullCount;
-                  }
-               }
-               // the center of the kernel is outside the input space, just set null.
-            }
-            else
-            {
-               nullCount=BANDS;
-            }
-
-            // make sure we have non-null data and we fit within the inputBuf.
-            if ( nullCount==BANDS || (sourceIndex>=inBandSize))
-            {
-               // we don't need to continue, just assign null!
-               for (band=0;band<BANDS;++band)
-               {
-                  resultBuf[band][resultX] = static_cast<T>(NULL_PIX[band]);
-               }
-            }
-            else
-            {  
-               kernel = theFilterTable.getClosestWeights(pointx,pointy);
-               if(kernel)
-               {
-                  // reset the pixel/density sums for each band to zero.
-                  memset(densityvals,'\0',sizeof(ossim_float64)*BANDS);
-                  memset(pixelvals,'\0',sizeof(ossim_float64)*BANDS);
-
-                  // apply kernel to input space.
-                  for (iy=0;((iy<ykernel_height)&&(sourceIndex<inBandSize));++iy)
-                  {
-                     for (ix = 0;((ix<xkernel_width)&&(sourceIndex<inBandSize));++ix)
-                     {
-                        tmpFlt64=*kernel; // pixel weight;
-                        for(band=0;band<BANDS;++band)
-                        {
-                           if(inputBuf[band][sourceIndex]!=NULL_PIX[band])
-                           {
-                              densityvals[band] += tmpFlt64;
-                              pixelvals[band] += (inputBuf[band][sourceIndex]*tmpFlt64);
-                           }
-                        }
-                        ++sourceIndex;
-                        ++kernel;
-                        if(sourceIndex>=inBandSize)
-                        {
-                           break;
-                        }
-                     }
-                     sourceIndex+=(inWidth-xkernel_width);
-                  }
-
-                  // actually assign the value to the output
-                  for (band = 0; band < BANDS; ++band)
-                  {
-                     if(densityvals[band]<=FLT_EPSILON)
-                     {
-                        //---
-                        // Setting tempFlt64 to pixelvals[band] causing 0's where -32768
-                        // should be when null check was skipped above.
-                        // tmpFlt64 = pixelvals[band];
-                        //---
-                        tmpFlt64 = NULL_PIX[band];
-                     }
-                     else
-                     {
-                        // normalize
-                        tmpFlt64 = pixelvals[band]/densityvals[band];
-                     }
-                     
-                     // clamp
-                     tmpFlt64 = (tmpFlt64>=MIN_PIX[band]?(tmpFlt64<MAX_PIX[band]?tmpFlt64:MAX_PIX[band]):MIN_PIX[band]); 
-                     // set resultant pixel value.
-                     resultBuf[band][resultX] = static_cast<T>(tmpFlt64);
-                  }
-
-                  // we didn't get a filter kernel, just set NULL in this disaster.
-               }
-               else
-               {
-                  for (band=0;band<BANDS;++band)
-                  {
-                     resultBuf[band][resultX] = static_cast<T>(NULL_PIX[band]);
-                  }
-               }                  
-            }
+            filterPixel(info, pointx, pointy, resultBuf, resultX);
             pointy += deltaY;
             pointx += deltaX;
          } // End of loop in x direction.
@@ -558,6 +642,383 @@ template <class T> void ossimFilterResampler::resampleBilinearTile(
    delete [] inputBuf;
 }
 
+template <class T> bool ossimFilterResampler::resampleSeparableTile(
+   T /* dummy */,
+   const ossimRefPtr<ossimImageData>& input,
+   ossimRefPtr<ossimImageData>& output,
+   const ossimIrect& outputSubRect,
+   const ossimDpt& inputUl,
+   const ossimDpt& inputUr,
+   const ossimDpt& deltaUl,
+   const ossimDpt& deltaUr,
+   const ossimDpt& outLength)
+{
+   //---
+   // Only an axis aligned scale keeps every output column on one input x and every
+   // output row on one input y, which is what makes the kernel separable.
+   //---
+   if ( !theSeparableFlag ||
+        (deltaUl.x != 0.0) || (deltaUr.x != 0.0) ||
+        (inputUl.y != inputUr.y) || (deltaUl.y != deltaUr.y) )
+   {
+      return false;
+   }
+
+   // Reordered sums can change the last bits, which a double output always shows.
+   if ( !std::numeric_limits<T>::is_integer && (sizeof(T) > sizeof(ossim_float32)) )
+   {
+      return false;
+   }
+
+   const ossim_uint32 XW = theFilterTable.getWidth();
+   const ossim_uint32 YH = theFilterTable.getHeight();
+   if ( !XW || !YH )
+   {
+      return false; // nearest neighbor
+   }
+   if ( XW*YH < 16 )
+   {
+      // 2x2 kernels: the passes touch as many pixels as the 2-D loop.
+      return false;
+   }
+
+   ossim_float64 stepSizeWidth = (outLength.x>1) ? 1.0/(outLength.x-1.0) : 1.0;
+
+   // INPUT INFORMATION
+   const ossim_uint32 inWidth    = input->getWidth();
+   const ossim_uint32 inHeight   = input->getHeight();
+   const ossim_uint32 BANDS      = input->getNumberOfBands();
+   const ossimIrect   inputRect  = input->getImageRectangle();
+
+   // OUTPUT INFORMATION
+   const ossim_float64* NULL_PIX    = output->getNullPix(); 
+   const ossim_float64* MIN_PIX     = output->getMinPix(); 
+   const ossim_float64* MAX_PIX     = output->getMaxPix(); 
+   const ossimIrect     outputRect  = output->getImageRectangle();
+   const ossim_uint32   resultRectH = outputSubRect.height();
+   const ossim_uint32   resultRectW = outputSubRect.width();
+   const ossim_uint32   outputRectW = outputRect.width();
+   const ossim_uint32   resultOffset=(outputSubRect.ul().y - outputRect.ul().y)*outputRectW +
+                                     (outputSubRect.ul().x - outputRect.ul().x);
+
+   const double xkernel_half_width  = theFilterTable.getXSupport();
+   const double ykernel_half_height = theFilterTable.getYSupport();
+
+   //---
+   // Input point of each output column and row, accumulated exactly as the 2-D loop
+   // does so both paths sample the same points.
+   //---
+   std::vector<double> colX(resultRectW);
+   std::vector<double> rowY(resultRectH);
+   {
+      const double initialx  = inputUl.x-inputRect.ul().x;
+      const double terminalx = inputUr.x-inputRect.ul().x;
+      const double deltaX    = (terminalx-initialx) * stepSizeWidth;
+      double pointx = initialx;
+      for (ossim_uint32 x = 0; x < resultRectW; ++x)
+      {
+         colX[x] = pointx;
+         pointx += deltaX;
+      }
+      double initialy = inputUl.y-inputRect.ul().y;
+      for (ossim_uint32 y = 0; y < resultRectH; ++y)
+      {
+         rowY[y] = initialy;
+         initialy += deltaUl.y;
+      }
+   }
+
+   //---
+   // Columns and rows whose whole kernel and center are inside the input tile.  The
+   // rest keep the 2-D loop and its edge handling.
+   //---
+   std::vector<ossim_uint32>  cols;
+   std::vector<ossim_int32>   colStart;
+   std::vector<ossim_int32>   colCenter;
+   std::vector<const double*> colWeights;
+   for (ossim_uint32 x = 0; x < resultRectW; ++x)
+   {
+      const ossim_int32 START  = ossim::round<int>(colX[x] - xkernel_half_width + .5);
+      const ossim_int32 CENTER = ossim::round<int>(colX[x]);
+      if ( (START >= 0) && (START + (ossim_int32)XW <= (ossim_int32)inWidth) &&
+           (CENTER >= 0) && (CENTER < (ossim_int32)inWidth) )
+      {
+         cols.push_back(x);
+         colStart.push_back(START);
+         colCenter.push_back(CENTER);
+         colWeights.push_back(theFilterTable.getClosestXWeights(colX[x]));
+      }
+   }
+   std::vector<ossim_uint32>  rows;
+   std::vector<ossim_int32>   rowStart;
+   std::vector<ossim_int32>   rowCenter;
+   std::vector<const double*> rowWeights;
+   for (ossim_uint32 y = 0; y < resultRectH; ++y)
+   {
+      const ossim_int32 START  = ossim::round<int>(rowY[y] - ykernel_half_height + .5);
+      const ossim_int32 CENTER = ossim::round<int>(rowY[y]);
+      if ( (START >= 0) && (START + (ossim_int32)YH <= (ossim_int32)inHeight) &&
+           (CENTER >= 0) && (CENTER < (ossim_int32)inHeight) )
+      {
+         rows.push_back(y);
+         rowStart.push_back(START);
+         rowCenter.push_back(CENTER);
+         rowWeights.push_back(theFilterTable.getClosestYWeights(rowY[y]));
+      }
+   }
+   if ( cols.empty() || rows.empty() )
+   {
+      return false;
+   }
+
+   const ossim_uint32 COLS    = (ossim_uint32)cols.size();
+   const ossim_uint32 ROWS    = (ossim_uint32)rows.size();
+   const ossim_uint32 ROW_MIN = *std::min_element(rowStart.begin(), rowStart.end());
+   const ossim_uint32 ROW_MAX = *std::max_element(rowStart.begin(), rowStart.end()) + YH;
+   const ossim_uint32 IN_ROWS = ROW_MAX - ROW_MIN;
+   const ossim_uint32 COL_MIN = *std::min_element(colStart.begin(), colStart.end());
+   const ossim_uint32 COL_MAX = *std::max_element(colStart.begin(), colStart.end()) + XW;
+
+   // Horizontal weights laid out tap major for the gather kernel, and weight sums.
+   std::vector<double> colWeightsT(XW*COLS);
+   std::vector<double> colWeightSum(COLS);
+   double maxColAbsSum = 0.0;
+   for (ossim_uint32 c = 0; c < COLS; ++c)
+   {
+      double sum = 0.0;
+      double absSum = 0.0;
+      for (ossim_uint32 k = 0; k < XW; ++k)
+      {
+         colWeightsT[k*COLS + c] = colWeights[c][k];
+         sum    += colWeights[c][k];
+         absSum += fabs(colWeights[c][k]);
+      }
+      colWeightSum[c] = sum;
+      maxColAbsSum = ossim::max(maxColAbsSum, absSum);
+   }
+   std::vector<double> rowWeightSum(ROWS);
+   double maxRowAbsSum = 0.0;
+   for (ossim_uint32 r = 0; r < ROWS; ++r)
+   {
+      double sum = 0.0;
+      double absSum = 0.0;
+      for (ossim_uint32 k = 0; k < YH; ++k)
+      {
+         sum    += rowWeights[r][k];
+         absSum += fabs(rowWeights[r][k]);
+      }
+      rowWeightSum[r] = sum;
+      maxRowAbsSum = ossim::max(maxRowAbsSum, absSum);
+   }
+
+   std::vector<const T*> inputBuf(BANDS);
+   std::vector<T*>       resultBuf(BANDS);
+   for (ossim_uint32 band = 0; band < BANDS; ++band)
+   {
+      inputBuf[band]  = static_cast<const T*>(input->getBuf(band));
+      resultBuf[band] = static_cast<T*>(output->getBuf(band))+resultOffset;
+   }
+
+   //---
+   // Bound on the difference between these sums and the 2-D loop's sequential sums
+   // of the same products, for any summation order.  Pixels whose output could
+   // change within the bound are redone with the 2-D loop, so the output is
+   // identical to it.
+   //---
+   const double WEIGHT_ABS_SUM = maxColAbsSum * maxRowAbsSum;
+   const double ERROR_SCALE    = 2.0 * (XW*YH + XW + YH + 4) * DBL_EPSILON * WEIGHT_ABS_SUM;
+   const double DENSITY_ERROR  = ERROR_SCALE;
+   const bool   INTEGER_TYPE   = std::numeric_limits<T>::is_integer;
+   const double TYPE_BOUND     = ossim::max(fabs((double)std::numeric_limits<T>::min()),
+                                            (double)std::numeric_limits<T>::max());
+
+   // Center pixels null in every band make the output null.
+   std::vector<ossim_uint8> redo(ROWS*COLS, 0);
+   std::vector<ossim_uint8> centerNull(ROWS*COLS, 0);
+   for (ossim_uint32 r = 0; r < ROWS; ++r)
+   {
+      for (ossim_uint32 c = 0; c < COLS; ++c)
+      {
+         const ossim_uint32 CENTER_OFFSET = rowCenter[r]*inWidth + colCenter[c];
+         ossim_uint32 nullCount = 0;
+         for (ossim_uint32 band = 0; band < BANDS; ++band)
+         {
+            if ( inputBuf[band][CENTER_OFFSET] == static_cast<T>(NULL_PIX[band]) )
+            {
+               ++nullCount;
+            }
+         }
+         centerNull[r*COLS + c] = (nullCount == BANDS);
+      }
+   }
+
+   const ossim::ImageDataKernels& K = ossim::getImageDataKernels();
+   std::vector<double> line(inWidth);
+   std::vector<double> mask(inWidth);
+   std::vector<double> hPix(IN_ROWS*COLS);
+   std::vector<double> hDensity(IN_ROWS*COLS);
+   std::vector<double> vPix(COLS);
+   std::vector<double> vDensity(COLS);
+   std::vector<const double*> taps(YH);
+
+   for (ossim_uint32 band = 0; band < BANDS; ++band)
+   {
+      const ossim_float64 NP = NULL_PIX[band];
+
+      // Horizontal pass over the input rows, null pixels weighted 0.
+      bool bandHasNull = false;
+      double pixelBound = INTEGER_TYPE ? TYPE_BOUND : 0.0;
+      for (ossim_uint32 y = 0; y < IN_ROWS; ++y)
+      {
+         const T* in = inputBuf[band] + (ROW_MIN + y)*inWidth;
+         ossim_uint32 nullCount = 0;
+         for (ossim_uint32 x = COL_MIN; x < COL_MAX; ++x)
+         {
+            const bool VALID = (in[x] != NP);
+            line[x] = VALID ? (double)in[x] : 0.0;
+            nullCount += !VALID;
+         }
+         if ( !INTEGER_TYPE )
+         {
+            for (ossim_uint32 x = COL_MIN; x < COL_MAX; ++x)
+            {
+               // NaN compares false here; it makes V NaN, which the 2-D loop also clamps.
+               if ( fabs(line[x]) > pixelBound ) pixelBound = fabs(line[x]);
+            }
+         }
+         K.gatherWeightedSumF64(&line.front(), &colStart.front(), &colWeightsT.front(),
+                                XW, COLS, &hPix[y*COLS]);
+         if ( nullCount )
+         {
+            for (ossim_uint32 x = COL_MIN; x < COL_MAX; ++x)
+            {
+               mask[x] = (in[x] != NP) ? 1.0 : 0.0;
+            }
+            K.gatherWeightedSumF64(&mask.front(), &colStart.front(), &colWeightsT.front(),
+                                   XW, COLS, &hDensity[y*COLS]);
+            bandHasNull = true;
+         }
+         else
+         {
+            memcpy(&hDensity[y*COLS], &colWeightSum.front(), COLS*sizeof(double));
+         }
+      }
+
+      // Vertical pass and normalization.
+      for (ossim_uint32 r = 0; r < ROWS; ++r)
+      {
+         const ossim_uint32 FIRST = rowStart[r] - ROW_MIN;
+         for (ossim_uint32 k = 0; k < YH; ++k)
+         {
+            taps[k] = &hPix[(FIRST + k)*COLS];
+         }
+         K.weightedSumF64(&taps.front(), rowWeights[r], YH, COLS, &vPix.front());
+         if ( bandHasNull )
+         {
+            for (ossim_uint32 k = 0; k < YH; ++k)
+            {
+               taps[k] = &hDensity[(FIRST + k)*COLS];
+            }
+            K.weightedSumF64(&taps.front(), rowWeights[r], YH, COLS, &vDensity.front());
+         }
+         else
+         {
+            for (ossim_uint32 c = 0; c < COLS; ++c)
+            {
+               vDensity[c] = rowWeightSum[r]*colWeightSum[c];
+            }
+         }
+
+         T* out = resultBuf[band] + rows[r]*outputRectW;
+         for (ossim_uint32 c = 0; c < COLS; ++c)
+         {
+            const ossim_uint32 IDX = r*COLS + c;
+            if ( centerNull[IDX] )
+            {
+               out[cols[c]] = static_cast<T>(NP);
+               continue;
+            }
+            const double DENSITY = vDensity[c];
+            if ( fabs(DENSITY - FLT_EPSILON) <= DENSITY_ERROR )
+            {
+               redo[IDX] = 1;
+               continue;
+            }
+            if ( DENSITY <= FLT_EPSILON )
+            {
+               out[cols[c]] = static_cast<T>(clampPix(NP, MIN_PIX[band], MAX_PIX[band]));
+               continue;
+            }
+            const double V   = vPix[c]/DENSITY;
+            const double TOL = ERROR_SCALE*(pixelBound + fabs(V))/(DENSITY - DENSITY_ERROR) +
+                               4.0*DBL_EPSILON*fabs(V);
+            const T LO = static_cast<T>(clampPix(V - TOL, MIN_PIX[band], MAX_PIX[band]));
+            const T HI = static_cast<T>(clampPix(V + TOL, MIN_PIX[band], MAX_PIX[band]));
+            if ( LO == HI )
+            {
+               out[cols[c]] = LO;
+            }
+            else
+            {
+               redo[IDX] = 1;
+            }
+         }
+      }
+   }
+
+   //---
+   // Everything not covered above goes through the 2-D loop: edge pixels, and pixels
+   // too close to a rounding boundary of T.
+   //---
+   std::vector<ossim_float64> densityvals(BANDS);
+   std::vector<ossim_float64> pixelvals(BANDS);
+   FilterTileInfo<T> info;
+   info.table             = &theFilterTable;
+   info.inputBuf          = &inputBuf.front();
+   info.bands             = BANDS;
+   info.inWidth           = inWidth;
+   info.inBandSize        = input->getSizePerBand();
+   info.xkernelWidth      = XW;
+   info.ykernelHeight     = YH;
+   info.xkernelHalfWidth  = xkernel_half_width;
+   info.ykernelHalfHeight = ykernel_half_height;
+   info.nullPix           = NULL_PIX;
+   info.minPix            = MIN_PIX;
+   info.maxPix            = MAX_PIX;
+   info.densityvals       = &densityvals.front();
+   info.pixelvals         = &pixelvals.front();
+
+   std::vector<T*> rowBuf(BANDS);
+   ossim_uint32 r = 0;
+   for (ossim_uint32 y = 0; y < resultRectH; ++y)
+   {
+      for (ossim_uint32 band = 0; band < BANDS; ++band)
+      {
+         rowBuf[band] = resultBuf[band] + y*outputRectW;
+      }
+      const bool INTERIOR_ROW = ( (r < ROWS) && (rows[r] == y) );
+      ossim_uint32 c = 0;
+      for (ossim_uint32 x = 0; x < resultRectW; ++x)
+      {
+         const bool INTERIOR = INTERIOR_ROW && (c < COLS) && (cols[c] == x);
+         if ( !INTERIOR || redo[r*COLS + c] )
+         {
+            filterPixel(info, colX[x], rowY[y], &rowBuf.front(), x);
+         }
+         if ( (c < COLS) && (cols[c] == x) )
+         {
+            ++c;
+         }
+      }
+      if ( INTERIOR_ROW )
+      {
+         ++r;
+      }
+   }
+
+   return true;
+}
+
 ossimString ossimFilterResampler::getFilterTypeAsString(ossimFilterResamplerType type)const
 {
    switch(type)
@@ -875,6 +1336,16 @@ void ossimFilterResampler::setBlurFactor(ossim_float64 blur)
    theBlurFactor = blur;
 }
 
+void ossimFilterResampler::setSeparableFlag(bool flag)
+{
+   theSeparableFlag = flag;
+}
+
+bool ossimFilterResampler::getSeparableFlag()const
+{
+   return theSeparableFlag;
+}
+
 bool ossimFilterResampler::saveState(ossimKeywordlist& kwl,
                                      const char* prefix)const
 {
@@ -894,6 +1365,10 @@ bool ossimFilterResampler::saveState(ossimKeywordlist& kwl,
            "magnify_type",
            getFilterTypeAsString(theMagnifyFilterType),
            true);
+   kwl.add(prefix,
+           "separable",
+           (theSeparableFlag ? "true" : "false"),
+           true);
 
    return true;
 }
@@ -927,6 +1402,12 @@ bool ossimFilterResampler::loadState(const ossimKeywordlist& kwl,
       setMagnifyFilterType(lookup);
    }
 
+   lookup = kwl.find(prefix, "separable");
+   if (lookup)
+   {
+      theSeparableFlag = ossimString(lookup).toBool();
+   }
+
    if(fabs(theScaleFactor.x) <= FLT_EPSILON)
    {
       theScaleFactor.x = 1.0;
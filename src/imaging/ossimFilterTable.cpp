@@ -14,6 +14,8 @@
 
 ossimFilterTable::ossimFilterTable()
    :theWeights(0),
+    theXWeights(0),
+    theYWeights(0),
     theWidth(0),
     theHeight(0),
     theWidthHeight(0),
@@ -31,6 +33,16 @@ ossimFilterTable::~ossimFilterTable()
       delete [] theWeights;
       theWeights = 0;
    }
+   if(theXWeights)
+   {
+      delete [] theXWeights;
+      theXWeights = 0;
+   }
+   if(theYWeights)
+   {
+      delete [] theYWeights;
+      theYWeights = 0;
+   }
 }
 
 void ossimFilterTable::buildTable(ossim_uint32  filterSteps,
@@ -104,6 +116,26 @@ void ossimFilterTable::buildTable(ossim_uint32  filterSteps,
           }
         }
      }
+
+   // 1-D factors of the weights above for separable resampling.
+   idx = 0;
+   for (subpixelSample = 0; subpixelSample < (int)filterSteps; ++subpixelSample)
+   {
+      dx = subpixelSample / (double)(filterSteps);
+      for(kernelH=left; kernelH<=right;++kernelH)
+      {
+         theXWeights[idx++] = xFilter.filter(kernelH - dx, xFilter.getSupport());
+      }
+   }
+   idx = 0;
+   for (subpixelLine = 0; subpixelLine < (int)filterSteps; ++subpixelLine)
+   {
+      dy = subpixelLine / (double)(filterSteps);
+      for (kernelV=top; kernelV<=bottom; ++kernelV)
+      {
+         theYWeights[idx++] = yFilter.filter(kernelV - dy, yFilter.getSupport());
+      }
+   }
 }
 
 ossim_uint32 ossimFilterTable::getWidthByHeight()const
@@ -139,10 +171,23 @@ void ossimFilterTable::allocateWeights()
       theWeights = 0;
    }
 
+   if(theXWeights)
+   {
+      delete [] theXWeights;
+      theXWeights = 0;
+   }
+   if(theYWeights)
+   {
+      delete [] theYWeights;
+      theYWeights = 0;
+   }
+
    ossim_uint32 size = (theWidthHeight*(theFilterSteps*theFilterSteps));
 
    if(size)
    {
-      theWeights = new double[size];
+      theWeights  = new double[size];
+      theXWeights = new double[theWidth*theFilterSteps];
+      theYWeights = new double[theHeight*theFilterSteps];
    }
 }
\ No newline at end of file
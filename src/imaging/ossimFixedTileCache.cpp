@@ -3,7 +3,7 @@
 // License:  See top level LICENSE.txt file.
 //
 // Author: Garrett Potts
-// 
+//
 // Description: This file contains the Application cache algorithm
 //
 //***********************************
@@ -19,9 +19,11 @@ ossimFixedTileCache::ossimFixedTileCache()
      theTilesVertical(0),
      theCacheSize(0),
      theMaxCacheSize(0),
-     theTileMap(),
-     theLruQueue(),
-     theUseLruFlag(true)
+     theUseLruFlag(true),
+     theAccessTick(0),
+     theHits(0),
+     theMisses(0),
+     theEvictions(0)
 {
    ossim::defaultTileSize(theTileSize);
 
@@ -29,10 +31,6 @@ ossimFixedTileCache::ossimFixedTileCache()
    tempRect.makeNan();
 
    setRect(tempRect);
-   
-   // theCacheSize    = 0;
-   // theMaxCacheSize = 0;
-   // theUseLruFlag = true;
 }
 
 ossimFixedTileCache::~ossimFixedTileCache()
@@ -40,61 +38,108 @@ ossimFixedTileCache::~ossimFixedTileCache()
    flush();
 }
 
-void ossimFixedTileCache::setRect(const ossimIrect& rect)
+void ossimFixedTileCache::lockAllShards()
 {
+   for(ossim_uint32 idx = 0; idx < NUMBER_OF_SHARDS; ++idx)
    {
-      std::lock_guard<std::mutex> lock(theMutex);
-      ossim::defaultTileSize(theTileSize);
-      theTileBoundaryRect      = rect;
-      theTileBoundaryRect.stretchToTileBoundary(theTileSize);
-      theBoundaryWidthHeight.x = theTileBoundaryRect.width();
-      theBoundaryWidthHeight.y = theTileBoundaryRect.height();
-      theTilesHorizontal       = theBoundaryWidthHeight.x/theTileSize.x;
-      theTilesVertical         = theBoundaryWidthHeight.y/theTileSize.y;
+      theShards[idx].theMutex.lock();
    }
-   flush();
 }
 
-void ossimFixedTileCache::setRect(const ossimIrect& rect,
-                                  const ossimIpt& tileSize)
+void ossimFixedTileCache::unlockAllShards()
 {
+   for(ossim_uint32 idx = NUMBER_OF_SHARDS; idx > 0; --idx)
    {
-      std::lock_guard<std::mutex> lock(theMutex);
-      theTileBoundaryRect      = rect;
-      theTileSize              = tileSize;
-      theTileBoundaryRect.stretchToTileBoundary(theTileSize);
-      theBoundaryWidthHeight.x = theTileBoundaryRect.width();
-      theBoundaryWidthHeight.y = theTileBoundaryRect.height();
-      theTilesHorizontal       = theBoundaryWidthHeight.x/theTileSize.x;
-      theTilesVertical         = theBoundaryWidthHeight.y/theTileSize.y;
+      theShards[idx-1].theMutex.unlock();
    }
-   flush();
 }
 
+ossim_uint32 ossimFixedTileCache::setRect(const ossimIrect& rect)
+{
+   ossimIpt tileSize;
+   ossim::defaultTileSize(tileSize);
+   return setRect(rect, tileSize);
+}
 
-void ossimFixedTileCache::keepTilesWithinRect(const ossimIrect& rect)
+ossim_uint32 ossimFixedTileCache::setRect(const ossimIrect& rect,
+                                          const ossimIpt& tileSize)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter = theTileMap.begin();
+   // Flush with the shards still locked so no tile is added under the old grid:
+   ossim_uint32 result = 0;
+   lockAllShards();
+   theTileBoundaryRect      = rect;
+   theTileSize              = tileSize;
+   theTileBoundaryRect.stretchToTileBoundary(theTileSize);
+   theBoundaryWidthHeight.x = theTileBoundaryRect.width();
+   theBoundaryWidthHeight.y = theTileBoundaryRect.height();
+   theTilesHorizontal       = theBoundaryWidthHeight.x/theTileSize.x;
+   theTilesVertical         = theBoundaryWidthHeight.y/theTileSize.y;
+   for(ossim_uint32 idx = 0; idx < NUMBER_OF_SHARDS; ++idx)
+   {
+      result += flushShard(theShards[idx]);
+   }
+   unlockAllShards();
 
-   while(tileIter != theTileMap.end())
+   return result;
+}
+
+void ossimFixedTileCache::setUseLruFlag(bool flag)
+{
+   lockAllShards();
+   if(theUseLruFlag != flag)
    {
-      ossimIrect tileRect = (*tileIter).second.theTile->getImageRectangle();
-      if(!tileRect.intersects(rect))
+      theUseLruFlag = flag;
+      for(ossim_uint32 idx = 0; idx < NUMBER_OF_SHARDS; ++idx)
       {
-         eraseFromLru(computeId((*tileIter).second.theTile->getOrigin()));
-         theCacheSize -= (*tileIter).second.theTile->getDataSizeInBytes();
-         (*tileIter).second.theTile = NULL;
-         theTileMap.erase(tileIter);
+         Shard& shard = theShards[idx];
+         shard.theLruQueue.clear();
+         if(theUseLruFlag)
+         {
+            std::unordered_map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
+               shard.theTileMap.begin();
+            while(tileIter != shard.theTileMap.end())
+            {
+               tileIter->second.theLruPosition =
+                  shard.theLruQueue.insert(shard.theLruQueue.end(), tileIter->first);
+               ++tileIter;
+            }
+         }
+      }
+   }
+   unlockAllShards();
+}
+
+void ossimFixedTileCache::keepTilesWithinRect(const ossimIrect& rect)
+{
+   for(ossim_uint32 idx = 0; idx < NUMBER_OF_SHARDS; ++idx)
+   {
+      Shard& shard = theShards[idx];
+      std::lock_guard<std::mutex> lock(shard.theMutex);
+      std::unordered_map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
+         shard.theTileMap.begin();
+      while(tileIter != shard.theTileMap.end())
+      {
+         ossimIrect tileRect = (*tileIter).second.theTile->getImageRectangle();
+         if(!tileRect.intersects(rect))
+         {
+            if(theUseLruFlag)
+            {
+               shard.theLruQueue.erase((*tileIter).second.theLruPosition);
+            }
+            theCacheSize -= (*tileIter).second.theTile->getDataSizeInBytes();
+            tileIter = shard.theTileMap.erase(tileIter);
+         }
+         else
+         {
+            ++tileIter;
+         }
       }
-      ++tileIter;
    }
 }
 
 ossimRefPtr<ossimImageData> ossimFixedTileCache::addTile(ossimRefPtr<ossimImageData> imageData,
                                                          bool duplicateData)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = NULL;
    if(!imageData.valid())
    {
@@ -104,50 +149,100 @@ ossimRefPtr<ossimImageData> ossimFixedTileCache::addTile(ossimRefPtr<ossimImageD
    {
       return result;
    }
-   
-   ossim_int32 id = computeId(imageData->getOrigin());
+
+   const ossimIpt origin = imageData->getOrigin();
+   std::unique_lock<std::mutex> lock;
+   ossim_int32 id = lockShard(origin, lock);
    if(id < 0)
    {
       return result;
    }
-   
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(id);
 
-   if(tileIter==theTileMap.end())
    {
-      if(duplicateData)
+      // Check first so the duplicate is not made for a tile that is already cached:
+      Shard& shard = getShard(id);
+      if(shard.theTileMap.find(id) != shard.theTileMap.end())
       {
-         result = (ossimImageData*)imageData->dup();
+         return result;
       }
-      else
-      {
-         result = imageData;
-      }
-      ossimFixedTileCacheInfo cacheInfo(result, id);
-       
-      theCacheSize += imageData->getDataSizeInBytes();
-      theTileMap.insert(make_pair(id, cacheInfo));
+      lock.unlock();
+   }
+
+   ossimRefPtr<ossimImageData> tile;
+   if(duplicateData)
+   {
+      tile = (ossimImageData*)imageData->dup();
+   }
+   else
+   {
+      tile = imageData;
+   }
+
+   // The grid may have changed while the lock was released:
+   id = lockShard(origin, lock);
+   if(id < 0)
+   {
+      return result;
+   }
+   Shard& shard = getShard(id);
+   std::pair<std::unordered_map<ossim_int32, ossimFixedTileCacheInfo>::iterator, bool> inserted =
+      shard.theTileMap.insert(std::make_pair(id, ossimFixedTileCacheInfo(tile, id)));
+   if(inserted.second)
+   {
+      ossimFixedTileCacheInfo& info = inserted.first->second;
+      info.theLastAccess = ++theAccessTick;
       if(theUseLruFlag)
       {
-         theLruQueue.push_back(id);
+         info.theLruPosition = shard.theLruQueue.insert(shard.theLruQueue.end(), id);
       }
+      theCacheSize += tile->getDataSizeInBytes();
+      result = tile;
    }
-   
+
    return result;
 }
 
 ossimRefPtr<ossimImageData> ossimFixedTileCache::getTile(ossim_int32 id)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimRefPtr<ossimImageData> result = NULL;
+   if(id < 0)
+   {
+      ++theMisses;
+      return result;
+   }
+
+   Shard& shard = getShard(id);
+   std::lock_guard<std::mutex> lock(shard.theMutex);
+   return getTileFromShard(shard, id);
+}
 
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(id);
-   if(tileIter!=theTileMap.end())
+ossimRefPtr<ossimImageData> ossimFixedTileCache::getTile(const ossimIpt& origin)
+{
+   std::unique_lock<std::mutex> lock;
+   ossim_int32 id = lockShard(origin, lock);
+   if(id < 0)
+   {
+      ++theMisses;
+      return NULL;
+   }
+   return getTileFromShard(getShard(id), id);
+}
+
+ossimRefPtr<ossimImageData> ossimFixedTileCache::getTileFromShard(Shard& shard,
+                                                                  ossim_int32 tileId)
+{
+   ossimRefPtr<ossimImageData> result = NULL;
+   std::unordered_map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
+      shard.theTileMap.find(tileId);
+   if(tileIter!=shard.theTileMap.end())
    {
       result = (*tileIter).second.theTile;
-      adjustLru(id);
+      adjustLru((*tileIter).second, shard);
+      ++theHits;
+   }
+   else
+   {
+      ++theMisses;
    }
 
    return result;
@@ -155,7 +250,6 @@ ossimRefPtr<ossimImageData> ossimFixedTileCache::getTile(ossim_int32 id)
 
 ossimIpt ossimFixedTileCache::getTileOrigin(ossim_int32 tileId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
    ossimIpt result;
    result.makeNan();
 
@@ -163,17 +257,52 @@ ossimIpt ossimFixedTileCache::getTileOrigin(ossim_int32 tileId)
    {
       return result;
    }
+   std::lock_guard<std::mutex> lock(getShard(tileId).theMutex);
+   if(theTilesHorizontal == 0)
+   {
+      return result;
+   }
    ossim_int32 ty = (tileId/theTilesHorizontal);
-   ossim_int32 tx = (tileId%theTilesVertical);
-   
+   ossim_int32 tx = (tileId%theTilesHorizontal);
+
    ossimIpt ul = theTileBoundaryRect.ul();
-   
+
    result = ossimIpt(ul.x + tx*theTileSize.x, ul.y + ty*theTileSize.y);
 
    return result;
 }
 
 ossim_int32 ossimFixedTileCache::computeId(const ossimIpt& tileOrigin)const
+{
+   std::unique_lock<std::mutex> lock;
+   return const_cast<ossimFixedTileCache*>(this)->lockShard(tileOrigin, lock);
+}
+
+ossim_int32 ossimFixedTileCache::lockShard(const ossimIpt& tileOrigin,
+                                           std::unique_lock<std::mutex>& lock)
+{
+   // Holding any shard lock excludes a grid change, so the id is computed under the lock of a
+   // shard picked from the origin and confirmed under the lock of the shard it maps to.
+   ossim_uint32 hash = static_cast<ossim_uint32>(tileOrigin.x)*73856093u ^
+                       static_cast<ossim_uint32>(tileOrigin.y)*19349663u;
+   Shard* shard = &theShards[(hash ^ (hash >> 16)) % NUMBER_OF_SHARDS];
+   std::unique_lock<std::mutex> shardLock(shard->theMutex);
+   ossim_int32 id = computeIdLocked(tileOrigin);
+   while((id >= 0) && (&getShard(id) != shard))
+   {
+      shardLock.unlock();
+      shard = &getShard(id);
+      shardLock = std::unique_lock<std::mutex>(shard->theMutex);
+      id = computeIdLocked(tileOrigin);
+   }
+   if(id >= 0)
+   {
+      lock.swap(shardLock);
+   }
+   return id;
+}
+
+ossim_int32 ossimFixedTileCache::computeIdLocked(const ossimIpt& tileOrigin)const
 {
    ossimIpt idDiff = tileOrigin - theTileBoundaryRect.ul();
 
@@ -188,126 +317,191 @@ ossim_int32 ossimFixedTileCache::computeId(const ossimIpt& tileOrigin)const
    y*=theTilesHorizontal;
 
    ossim_uint32 x = idDiff.x/theTileSize.x;
-   
-   
+
+
    return (y + x);
 }
 
-void ossimFixedTileCache::deleteTile(ossim_int32 tileId)
+ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTileFromShard(Shard& shard,
+                                                                     ossim_int32 tileId)
 {
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(tileId);
+   ossimRefPtr<ossimImageData> result = NULL;
+   std::unordered_map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
+      shard.theTileMap.find(tileId);
 
-   if(tileIter != theTileMap.end())
+   if(tileIter != shard.theTileMap.end())
    {
-      if((*tileIter).second.theTile.valid())
+      result = (*tileIter).second.theTile;
+      if(result.valid())
+      {
+         theCacheSize -= result->getDataSizeInBytes();
+      }
+      if(theUseLruFlag)
       {
-         theCacheSize -= (*tileIter).second.theTile->getDataSizeInBytes();
-         (*tileIter).second.theTile = NULL;
+         shard.theLruQueue.erase((*tileIter).second.theLruPosition);
       }
-      theTileMap.erase(tileIter);
-      eraseFromLru(tileId);
+      shard.theTileMap.erase(tileIter);
+   }
+
+   return result;
+}
+
+void ossimFixedTileCache::deleteTile(ossim_int32 tileId)
+{
+   if(tileId < 0)
+   {
+      return;
    }
+   Shard& shard = getShard(tileId);
+   std::lock_guard<std::mutex> lock(shard.theMutex);
+   removeTileFromShard(shard, tileId);
 }
 
 ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTile(ossim_int32 tileId)
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   ossimRefPtr<ossimImageData> result = NULL;
-   
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.find(tileId);
+   if(tileId < 0)
+   {
+      return NULL;
+   }
+   Shard& shard = getShard(tileId);
+   std::lock_guard<std::mutex> lock(shard.theMutex);
+   return removeTileFromShard(shard, tileId);
+}
 
-   if(tileIter != theTileMap.end())
+ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTile(const ossimIpt& origin)
+{
+   std::unique_lock<std::mutex> lock;
+   ossim_int32 id = lockShard(origin, lock);
+   if(id < 0)
    {
-      theCacheSize -= (*tileIter).second.theTile->getDataSizeInBytes();
-      if((*tileIter).second.theTile.valid())
-      {
-         result =  (*tileIter).second.theTile;
-      }
-      theTileMap.erase(tileIter);
-      eraseFromLru(tileId);
+      return NULL;
    }
-   
-   return result;
+   return removeTileFromShard(getShard(id), id);
 }
 
-void ossimFixedTileCache::flush()
+ossim_uint32 ossimFixedTileCache::flush()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   std::map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
-      theTileMap.begin();
+   ossim_uint32 result = 0;
+   for(ossim_uint32 idx = 0; idx < NUMBER_OF_SHARDS; ++idx)
+   {
+      Shard& shard = theShards[idx];
+      std::lock_guard<std::mutex> lock(shard.theMutex);
+      result += flushShard(shard);
+   }
+   return result;
+}
 
-   while(tileIter != theTileMap.end())
+ossim_uint32 ossimFixedTileCache::flushShard(Shard& shard)
+{
+   ossim_uint32 result = 0;
+   std::unordered_map<ossim_int32, ossimFixedTileCacheInfo>::iterator tileIter =
+      shard.theTileMap.begin();
+   while(tileIter != shard.theTileMap.end())
    {
-      if( (*tileIter).second.theTile.valid())
+      if((*tileIter).second.theTile.valid())
       {
-         (*tileIter).second.theTile = 0;
+         result += (*tileIter).second.theTile->getDataSizeInBytes();
       }
       ++tileIter;
    }
-   theLruQueue.clear();
-   theTileMap.clear();
-   theCacheSize = 0;
+   theCacheSize -= result;
+   shard.theLruQueue.clear();
+   shard.theTileMap.clear();
+   return result;
 }
 
-void ossimFixedTileCache::deleteTile()
+ossim_uint32 ossimFixedTileCache::getNumberOfTiles()const
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   if(theUseLruFlag)
+   ossim_uint32 result = 0;
+   for(ossim_uint32 idx = 0; idx < NUMBER_OF_SHARDS; ++idx)
    {
-      if(theLruQueue.begin() != theLruQueue.end())
-      {
-         deleteTile(*(theLruQueue.begin()));
-      }
+      Shard& shard = const_cast<Shard&>(theShards[idx]);
+      std::lock_guard<std::mutex> lock(shard.theMutex);
+      result += (ossim_uint32)shard.theTileMap.size();
    }
+   return result;
+}
+
+void ossimFixedTileCache::deleteTile()
+{
+   removeTile();
 }
 
 ossimRefPtr<ossimImageData> ossimFixedTileCache::removeTile()
 {
-   std::lock_guard<std::mutex> lock(theMutex);
-   if(theUseLruFlag)
+   if(!theUseLruFlag)
+   {
+      return NULL;
+   }
+
+   // Each shard queue is ordered by access tick, so the globally least recently used tile is at
+   // the head of one of the queues. Retry if it was touched between the scan and the removal.
+   for(int attempt = 0; attempt < 4; ++attempt)
    {
-      if(theLruQueue.begin() != theLruQueue.end())
+      ossim_int32  oldestShard = -1;
+      ossim_uint64 oldestTick  = 0;
+      for(ossim_uint32 idx = 0; idx < NUMBER_OF_SHARDS; ++idx)
+      {
+         Shard& shard = theShards[idx];
+         std::lock_guard<std::mutex> lock(shard.theMutex);
+         if(!shard.theLruQueue.empty())
+         {
+            ossim_uint64 tick = shard.theTileMap.find(shard.theLruQueue.front())->second.theLastAccess;
+            if((oldestShard < 0) || (tick < oldestTick))
+            {
+               oldestShard = (ossim_int32)idx;
+               oldestTick  = tick;
+            }
+         }
+      }
+      if(oldestShard < 0)
       {
-         return removeTile(*(theLruQueue.begin()));
+         break;
+      }
+
+      Shard& shard = theShards[oldestShard];
+      std::lock_guard<std::mutex> lock(shard.theMutex);
+      if(!shard.theLruQueue.empty())
+      {
+         ossim_int32 tileId = shard.theLruQueue.front();
+         if(shard.theTileMap.find(tileId)->second.theLastAccess == oldestTick)
+         {
+            ++theEvictions;
+            return removeTileFromShard(shard, tileId);
+         }
       }
    }
 
    return NULL;
 }
 
-void ossimFixedTileCache::adjustLru(ossim_int32 id)
+void ossimFixedTileCache::adjustLru(ossimFixedTileCacheInfo& info, Shard& shard)
 {
+   info.theLastAccess = ++theAccessTick;
    if(theUseLruFlag)
    {
-      std::list<ossim_int32>::iterator iter = std::find(theLruQueue.begin(), theLruQueue.end(), id);
-      
-      if(iter != theLruQueue.end())
-      {
-         ossim_int32 value = *iter;
-         theLruQueue.erase(iter);
-         theLruQueue.push_back(value);
-      }
+      // O(1) move to the most recently used end:
+      shard.theLruQueue.splice(shard.theLruQueue.end(), shard.theLruQueue, info.theLruPosition);
    }
 }
 
-void ossimFixedTileCache::eraseFromLru(ossim_int32 id)
+void ossimFixedTileCache::setTileSize(const ossimIpt& tileSize)
 {
-   if(theUseLruFlag)
-   {
-      
-      std::list<ossim_int32>::iterator iter = std::find(theLruQueue.begin(), theLruQueue.end(), id);
-      
-      if(iter != theLruQueue.end())
-      {
-         theLruQueue.erase(iter);
-      }
-   }
+   setRect(theTileBoundaryRect, tileSize);
 }
 
+ossimFixedTileCache::Statistics ossimFixedTileCache::getStatistics()const
+{
+   Statistics stats;
+   stats.theHits      = theHits.load(std::memory_order_relaxed);
+   stats.theMisses    = theMisses.load(std::memory_order_relaxed);
+   stats.theEvictions = theEvictions.load(std::memory_order_relaxed);
+   return stats;
+}
 
-void ossimFixedTileCache::setTileSize(const ossimIpt& tileSize)
+void ossimFixedTileCache::resetStatistics()
 {
-   setRect(theTileBoundaryRect, tileSize);
+   theHits      = 0;
+   theMisses    = 0;
+   theEvictions = 0;
 }
@@ -837,6 +837,25 @@ ossimRefPtr<ossimImageData> ossimImageChain::getTile(
    return 0;
 }
 
+void ossimImageChain::setTileRequestOrder(const ossimIrect& area,
+                                          const ossimIpt& tileSize,
+                                          ossim_uint32 resLevel)
+{
+   ossimImageSource* inputSource = 0;
+   if((imageChainList().size() > 0)&&(isSourceEnabled()))
+   {
+      inputSource = PTR_CAST(ossimImageSource, imageChainList()[0].get());
+   }
+   else if(getInput(0))
+   {
+      inputSource = PTR_CAST(ossimImageSource, getInput(0));
+   }
+   if(inputSource)
+   {
+      inputSource->setTileRequestOrder(area, tileSize, resLevel);
+   }
+}
+
 ossim_uint32 ossimImageChain::getNumberOfInputBands() const
 {
    if((imageChainList().size() > 0)&&(isSourceEnabled()))
@@ -23,6 +23,7 @@
 //#include <ossim/base/ossimSource.h>
 #include <ossim/base/ossimString.h>
 #include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageDataKernels.h>
 #include <algorithm>
 #include <cstring>
 #include <fstream>
@@ -30,6 +31,298 @@
 #include <iterator>
 //#include <ostream>
 
+//---
+// Per band pixel loops.  The templates are the portable versions; the overloads
+// route the common scalar types to the vectorized kernels in
+// ossimImageDataKernels.h.
+//---
+namespace
+{
+   template <class T>
+   void deinterleaveLine(const T* src, ossim_uint32 bands, ossim_uint32 count, T** dst)
+   {
+      for (ossim_uint32 band = 0; band < bands; ++band)
+      {
+         const T* s = src + band;
+         T* d = dst[band];
+         for (ossim_uint32 i = 0; i < count; ++i)
+         {
+            d[i] = *s;
+            s += bands;
+         }
+      }
+   }
+
+   inline void deinterleaveLine(const ossim_uint8* src, ossim_uint32 bands,
+                                ossim_uint32 count, ossim_uint8** dst)
+   {
+      ossim::getImageDataKernels().deinterleave8(src, bands, count, dst);
+   }
+
+   inline void deinterleaveLine(const ossim_sint8* src, ossim_uint32 bands,
+                                ossim_uint32 count, ossim_sint8** dst)
+   {
+      ossim::getImageDataKernels().deinterleave8(
+         (const ossim_uint8*)src, bands, count, (ossim_uint8**)dst);
+   }
+
+   inline void deinterleaveLine(const ossim_uint16* src, ossim_uint32 bands,
+                                ossim_uint32 count, ossim_uint16** dst)
+   {
+      ossim::getImageDataKernels().deinterleave16(src, bands, count, dst);
+   }
+
+   inline void deinterleaveLine(const ossim_sint16* src, ossim_uint32 bands,
+                                ossim_uint32 count, ossim_sint16** dst)
+   {
+      ossim::getImageDataKernels().deinterleave16(
+         (const ossim_uint16*)src, bands, count, (ossim_uint16**)dst);
+   }
+
+   inline void deinterleaveLine(const ossim_uint32* src, ossim_uint32 bands,
+                                ossim_uint32 count, ossim_uint32** dst)
+   {
+      ossim::getImageDataKernels().deinterleave32(src, bands, count, dst);
+   }
+
+   inline void deinterleaveLine(const ossim_sint32* src, ossim_uint32 bands,
+                                ossim_uint32 count, ossim_sint32** dst)
+   {
+      ossim::getImageDataKernels().deinterleave32(
+         (const ossim_uint32*)src, bands, count, (ossim_uint32**)dst);
+   }
+
+   inline void deinterleaveLine(const ossim_float32* src, ossim_uint32 bands,
+                                ossim_uint32 count, ossim_float32** dst)
+   {
+      ossim::getImageDataKernels().deinterleave32(
+         (const ossim_uint32*)src, bands, count, (ossim_uint32**)dst);
+   }
+
+   /** @return false if every pixel is exclude (or NaN). */
+   template <class T>
+   bool bandMinMax(const T* buf, ossim_uint32 count, T exclude, T& minVal, T& maxVal)
+   {
+      bool found = false;
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p == p) )
+         {
+            if (!found)
+            {
+               minVal = p;
+               maxVal = p;
+               found = true;
+            }
+            if (p < minVal) minVal = p;
+            if (p > maxVal) maxVal = p;
+         }
+      }
+      return found;
+   }
+
+   inline bool bandMinMax(const ossim_uint8* buf, ossim_uint32 count, ossim_uint8 exclude,
+                          ossim_uint8& minVal, ossim_uint8& maxVal)
+   {
+      return ossim::getImageDataKernels().minMaxU8(buf, count, exclude, &minVal, &maxVal);
+   }
+
+   inline bool bandMinMax(const ossim_uint16* buf, ossim_uint32 count, ossim_uint16 exclude,
+                          ossim_uint16& minVal, ossim_uint16& maxVal)
+   {
+      return ossim::getImageDataKernels().minMaxU16(buf, count, exclude, &minVal, &maxVal);
+   }
+
+   inline bool bandMinMax(const ossim_sint16* buf, ossim_uint32 count, ossim_sint16 exclude,
+                          ossim_sint16& minVal, ossim_sint16& maxVal)
+   {
+      return ossim::getImageDataKernels().minMaxS16(buf, count, exclude, &minVal, &maxVal);
+   }
+
+   inline bool bandMinMax(const ossim_float32* buf, ossim_uint32 count, ossim_float32 exclude,
+                          ossim_float32& minVal, ossim_float32& maxVal)
+   {
+      return ossim::getImageDataKernels().minMaxF32(buf, count, exclude, &minVal, &maxVal);
+   }
+
+   /** @return false if no pixel other than exclude is above threshold. */
+   template <class T>
+   bool bandMinAbove(const T* buf, ossim_uint32 count, T exclude, T threshold, T& minVal)
+   {
+      bool found = false;
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p > threshold) && (!found || (p < minVal)) )
+         {
+            minVal = p;
+            found = true;
+         }
+      }
+      return found;
+   }
+
+   inline bool bandMinAbove(const ossim_uint8* buf, ossim_uint32 count, ossim_uint8 exclude,
+                            ossim_uint8 threshold, ossim_uint8& minVal)
+   {
+      return ossim::getImageDataKernels().minAboveU8(buf, count, exclude, threshold, &minVal);
+   }
+
+   inline bool bandMinAbove(const ossim_uint16* buf, ossim_uint32 count, ossim_uint16 exclude,
+                            ossim_uint16 threshold, ossim_uint16& minVal)
+   {
+      return ossim::getImageDataKernels().minAboveU16(buf, count, exclude, threshold, &minVal);
+   }
+
+   inline bool bandMinAbove(const ossim_sint16* buf, ossim_uint32 count, ossim_sint16 exclude,
+                            ossim_sint16 threshold, ossim_sint16& minVal)
+   {
+      return ossim::getImageDataKernels().minAboveS16(buf, count, exclude, threshold, &minVal);
+   }
+
+   inline bool bandMinAbove(const ossim_float32* buf, ossim_uint32 count, ossim_float32 exclude,
+                            ossim_float32 threshold, ossim_float32& minVal)
+   {
+      return ossim::getImageDataKernels().minAboveF32(buf, count, exclude, threshold, &minVal);
+   }
+
+   template <class T>
+   void normalizeBand(const T* s, ossim_uint32 count, ossim_float64 minPix,
+                      ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* d)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      for (ossim_uint32 offset = 0; offset < count; ++offset)
+      {
+         ossim_float64 p = s[offset];
+         if (p != nullPix)
+         {
+            if (p == minPix)
+            {
+               d[offset] = OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT;
+            }
+            else
+            {
+               d[offset] = (p - minPix) / RANGE;
+            }
+         }
+         else
+         {
+            d[offset] = 0.0;
+         }
+      }
+   }
+
+   inline void normalizeBand(const ossim_uint8* s, ossim_uint32 count, ossim_float64 minPix,
+                             ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* d)
+   {
+      ossim::getImageDataKernels().normalizeU8(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   inline void normalizeBand(const ossim_uint16* s, ossim_uint32 count, ossim_float64 minPix,
+                             ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* d)
+   {
+      ossim::getImageDataKernels().normalizeU16(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   inline void normalizeBand(const ossim_sint16* s, ossim_uint32 count, ossim_float64 minPix,
+                             ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* d)
+   {
+      ossim::getImageDataKernels().normalizeS16(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   inline void normalizeBand(const ossim_float32* s, ossim_uint32 count, ossim_float64 minPix,
+                             ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* d)
+   {
+      ossim::getImageDataKernels().normalizeF32(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   template <class T>
+   void unnormalizeBand(const ossim_float32* s, ossim_uint32 count, ossim_float64 minPix,
+                        ossim_float64 maxPix, T nullPix, T* d)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      for (ossim_uint32 offset = 0; offset < count; ++offset)
+      {
+         const ossim_float64 P = s[offset];
+         if (P != 0.0)
+         {
+            ossim_float64 test = minPix + RANGE * P;
+            if (test > maxPix) test = maxPix;
+            d[offset] = (T)test;
+         }
+         else
+         {
+            d[offset] = nullPix;
+         }
+      }
+   }
+
+   inline void unnormalizeBand(const ossim_float32* s, ossim_uint32 count, ossim_float64 minPix,
+                               ossim_float64 maxPix, ossim_uint8 nullPix, ossim_uint8* d)
+   {
+      ossim::getImageDataKernels().unnormalizeU8(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   inline void unnormalizeBand(const ossim_float32* s, ossim_uint32 count, ossim_float64 minPix,
+                               ossim_float64 maxPix, ossim_uint16 nullPix, ossim_uint16* d)
+   {
+      ossim::getImageDataKernels().unnormalizeU16(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   inline void unnormalizeBand(const ossim_float32* s, ossim_uint32 count, ossim_float64 minPix,
+                               ossim_float64 maxPix, ossim_sint16 nullPix, ossim_sint16* d)
+   {
+      ossim::getImageDataKernels().unnormalizeS16(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   inline void unnormalizeBand(const ossim_float32* s, ossim_uint32 count, ossim_float64 minPix,
+                               ossim_float64 maxPix, ossim_float32 nullPix, ossim_float32* d)
+   {
+      ossim::getImageDataKernels().unnormalizeF32(s, count, minPix, maxPix, nullPix, d);
+   }
+
+   //---
+   // Histogram of an integer band.  The non null pixels are counted in a table
+   // indexed by value over the range found by bandMinMax, then the table is
+   // added to the histogram, so each value is binned once instead of each
+   // pixel.  The bins are the same as UpCount on each pixel.  Bands with fewer
+   // pixels than values in their range are counted pixel by pixel.
+   //---
+   template <class T>
+   void bandHistogram(const T* buf, ossim_uint32 count, T nullPix,
+                      ossimHistogram* histo, std::vector<ossim_uint32>& valueCounts)
+   {
+      T minVal;
+      T maxVal;
+      if (!bandMinMax(buf, count, nullPix, minVal, maxVal))
+      {
+         return; // All null.
+      }
+
+      const ossim_int32 FIRST = (ossim_int32)minVal;
+      const ossim_uint32 SIZE = (ossim_uint32)((ossim_int32)maxVal - FIRST) + 1;
+      if (SIZE > count)
+      {
+         for (ossim_uint32 offset = 0; offset < count; ++offset)
+         {
+            if (buf[offset] != nullPix)
+               histo->UpCount((float)buf[offset]);
+         }
+         return;
+      }
+
+      valueCounts.assign(SIZE, 0);
+      ossim_uint32* counts = &valueCounts.front();
+      for (ossim_uint32 offset = 0; offset < count; ++offset)
+      {
+         if (buf[offset] != nullPix)
+            ++counts[(ossim_int32)buf[offset] - FIRST];
+      }
+      histo->UpCountRange(FIRST, counts, SIZE);
+   }
+}
+
 
 RTTI_DEF1(ossimImageData, "ossimImageData", ossimRectilinearDataObject)
 
@@ -859,6 +1152,11 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
    {
       return;
    }
+
+   // Value counts of the integer types, reused by each band.
+   std::vector<ossim_uint32> valueCounts;
+   const ossim_uint32 upperBound = getWidth()*getHeight();
+
    switch(getScalarType())
    {
    case OSSIM_UINT8:
@@ -872,7 +1170,6 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
             float* histoBins = currentHisto->GetCounts();
             int binCount = currentHisto->GetRes();
             ossim_uint8* buffer = (ossim_uint8*)getBuf(band);
-            ossim_uint32 upperBound = getWidth()*getHeight();
             if ( binCount == 256 )
             {
                for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
@@ -883,11 +1180,7 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
             }
             else
             {
-               for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
-               {
-                  if (buffer[offset] != nullpix)
-                     currentHisto->UpCount((float)buffer[offset]);
-               }
+               bandHistogram(buffer, upperBound, nullpix, currentHisto.get(), valueCounts);
             }
          }
       }
@@ -905,14 +1198,8 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
          ossimRefPtr<ossimHistogram> currentHisto = histo->getHistogram(band);
          if(currentHisto.valid())
          {
-            ossim_uint16 nullpix = (ossim_uint16)getNullPix(band);
-            ossim_uint16* buffer = (ossim_uint16*)getBuf(band);
-            ossim_uint32 upperBound = getWidth()*getHeight();
-            for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
-            {
-               if (buffer[offset] != nullpix)
-                  currentHisto->UpCount((float)buffer[offset]);
-            }
+            bandHistogram((const ossim_uint16*)getBuf(band), upperBound,
+                          (ossim_uint16)getNullPix(band), currentHisto.get(), valueCounts);
          }
       }
       break;
@@ -924,14 +1211,8 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
          ossimRefPtr<ossimHistogram> currentHisto = histo->getHistogram(band);
          if(currentHisto.valid())
          {
-            ossim_sint16 nullpix = (ossim_sint16)getNullPix(band);
-            ossim_sint16* buffer = (ossim_sint16*)getBuf(band);
-            ossim_uint32 upperBound = getWidth()*getHeight();
-            for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
-            {
-               if (buffer[offset] != nullpix)
-                  currentHisto->UpCount((float)buffer[offset]);
-            }
+            bandHistogram((const ossim_sint16*)getBuf(band), upperBound,
+                          (ossim_sint16)getNullPix(band), currentHisto.get(), valueCounts);
          }
       }
       break;
@@ -945,7 +1226,6 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
          {
             ossim_sint32 nullpix = (ossim_sint32)getNullPix(band);
             ossim_sint32* buffer = (ossim_sint32*)getBuf(band);
-            ossim_uint32 upperBound = getWidth()*getHeight();
             for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
             {
                if (buffer[offset] != nullpix)
@@ -964,7 +1244,6 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
          {
             ossim_uint32 nullpix = (ossim_uint32)getNullPix(band);
             ossim_uint32* buffer = (ossim_uint32*)getBuf(band);
-            ossim_uint32 upperBound = getWidth()*getHeight();
             for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
             {
                if (buffer[offset] != nullpix)
@@ -987,7 +1266,6 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
             if (nullpix == 0.0)
                epsilon = 0;
             ossim_float64* buffer = (ossim_float64*)getBuf(band);
-            ossim_uint32 upperBound = getWidth()*getHeight();
             for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
             {
                if (!ossim::almostEqual<ossim_float64>(buffer[offset], nullpix, epsilon))
@@ -1010,7 +1288,6 @@ void ossimImageData::populateHistogram(ossimRefPtr<ossimMultiBandHistogram> hist
             if (nullpix == 0.0)
                epsilon = 0;
             ossim_float32* buffer = (ossim_float32*)getBuf(band);
-            ossim_uint32 upperBound = getWidth()*getHeight();
             for(ossim_uint32 offset = 0; offset < upperBound; ++offset)
             {
                if (!ossim::almostEqual<ossim_float32>(buffer[offset], nullpix, epsilon))
@@ -1360,6 +1637,18 @@ void ossimImageData::initialize()
    }
 }
 
+void ossimImageData::recycle(ossimSource* owner)
+{
+   setOwner(owner);
+   initializeDefaults();
+   m_alpha.clear();
+   m_origin = ossimIpt(0, 0);
+   m_indexedFlag = false;
+   m_histogram = 0;
+   m_percentFull = 0;
+   setDataObjectStatus(OSSIM_NULL);
+}
+
 // Write the tile out to disk with a general raster header file.
 bool ossimImageData::write(const ossimFilename& f) const
 {
@@ -3828,26 +4117,20 @@ void ossimImageData::computeMinMaxPix(T /* dummyValue */,
       const T* bandBuffer = (const T*)getBuf(band);
       if(bandBuffer)
       {
-         const T NP   = static_cast<T>(getNullPix(band));
-         ossim_float64 currentMin = minBands[band];
-         ossim_float64 currentMax = maxBands[band];
-         for(ossim_uint32 offset = 0; offset < SPB; ++offset)
+         const T NP = static_cast<T>(getNullPix(band));
+         T tileMin = 0;
+         T tileMax = 0;
+         if ( bandMinMax(bandBuffer, SPB, NP, tileMin, tileMax) )
          {
-            T p = bandBuffer[offset];
-            if(p != NP)
+            if(tileMin < minBands[band])
             {
-               if(p < currentMin)
-               {
-                  currentMin = p;
-               }
-               else if(p > currentMax)
-               {
-                  currentMax = p;
-               }
+               minBands[band] = tileMin;
+            }
+            if(tileMax > maxBands[band])
+            {
+               maxBands[band] = tileMax;
             }
          }
-         minBands[band] = currentMin;
-         maxBands[band] = currentMax;
       }
    }
 }
@@ -3978,45 +4261,40 @@ void ossimImageData::computeMinMaxNulPix(T /* dummyValue */,
       const T* bandBuffer = (const T*)getBuf(band);
       if(bandBuffer)
       {
-         ossim_float64 currentMin = minBands[band];
-         ossim_float64 currentMax = maxBands[band];
-         ossim_float64 currentNul = nulBands[band];
-         for(ossim_uint32 offset = 0; offset < SPB; ++offset)
+         // Since we are scanning for nulls this is making an assumption that the default
+         // null is incorrect and should be ignored in this scan as it could have been
+         // introduced by a make blank on a partial tile so ignore it.
+         // NOTE (OLK 03/2015): It is a bad idea to ignore pixels with default nulls, as it may
+         // be the actual null value being used. By ignoring it, a new null will be latched
+         // corresponding to actual, non-null, minimum value. Unfortunately, when tiles are
+         // initialized, they are filled with default nulls since (with float-data), the
+         // null (if any exists) is not yet known -- effectively creating two null pixel values.
+         // The recommendation (if you're looking at this code, then you're probably having the
+         // problem that your nulls aren't being recognized), is to turn off the flag in your
+         // ossim prefs file with: overview_builder.scan_for_min_max_null_if_float: false
+         // (or just delete that line)
+         T tileNul = 0;
+         T tileMax = 0;
+         if ( bandMinMax(bandBuffer, SPB, DEFAULT_NULL, tileNul, tileMax) )
          {
-            T p = bandBuffer[offset];
-
-            // Since we are scanning for nulls this is making an assumption that the default
-            // null is incorrect and should be ignored in this scan as it could have been
-            // introduced by a make blank on a partial tile so ignore it.
-            // NOTE (OLK 03/2015): It is a bad idea to ignore pixels with default nulls, as it may
-            // be the actual null value being used. By ignoring it, a new null will be latched
-            // corresponding to actual, non-null, minimum value. Unfortunately, when tiles are
-            // initialized, they are filled with default nulls since (with float-data), the
-            // null (if any exists) is not yet known -- effectively creating two null pixel values.
-            // The recommendation (if you're looking at this code, then you're probably having the
-            // problem that your nulls aren't being recognized), is to turn off the flag in your
-            // ossim prefs file with: overview_builder.scan_for_min_max_null_if_float: false
-            // (or just delete that line)
-            if ( p != DEFAULT_NULL )
+            // Must do null first as min depends on null.
+            if ( tileNul < nulBands[band] )
             {
-               // Must do null first as min depends on null.
-               if ( p < currentNul )
-               {
-                  currentNul = p;
-               }
-               if( ( p < currentMin ) && ( p > currentNul ) )
-               {
-                  currentMin = p;
-               }
-               else if( p > currentMax )
-               {
-                  currentMax = p;
-               }
+               nulBands[band] = tileNul;
+            }
+            if ( tileMax > maxBands[band] )
+            {
+               maxBands[band] = tileMax;
+            }
+
+            T tileMin = 0;
+            if ( bandMinAbove(bandBuffer, SPB, DEFAULT_NULL,
+                              static_cast<T>(nulBands[band]), tileMin) &&
+                 ( tileMin < minBands[band] ) )
+            {
+               minBands[band] = tileMin;
             }
          }
-         minBands[band] = currentMin;
-         maxBands[band] = currentMax;
-         nulBands[band] = currentNul;
       }
    }
 }
@@ -4112,15 +4390,7 @@ void ossimImageData::loadTileFromBipTemplate(T, // dummy template variable
 
    for (ossim_uint32 line = 0; line < clipHeight; ++line)
    {
-      ossim_uint32 j = 0;
-      for (ossim_uint32 sample = 0; sample < clipWidth; ++sample)
-      {
-         for (band=0; band<num_bands; band++)
-         {
-            d[band][sample] = s[j+band];
-         }
-         j += num_bands;
-      }
+      deinterleaveLine(s, num_bands, clipWidth, d);
 
       s += s_width;
       for (band=0; band<num_bands; band++)
@@ -4302,10 +4572,7 @@ void ossimImageData::loadTileFromBilTemplate(T, // dummy template variable
    {
       for (band = 0; band < num_bands; ++band)
       {
-         for (ossim_uint32 sample = 0; sample < clipWidth; ++sample)
-         {
-            d[band][sample] = s[sample];
-         }
+         std::memcpy(d[band], s, clipWidth * sizeof(T));
          s       += s_width;
          d[band] += d_width;
       }
@@ -4392,11 +4659,8 @@ void ossimImageData::loadTileFromBsqTemplate(T, // dummy template variable
 
       for (ossim_uint32 line = 0; line < clipHeight; ++line)
       {
-         for (ossim_uint32 sample = 0; sample < clipWidth; ++sample)
-         {
-            destinationBand[destinationIndex + sample]
-                            = s[sourceIndex+sample];
-         }
+         std::memcpy(destinationBand + destinationIndex, s + sourceIndex,
+                     clipWidth * sizeof(T));
          sourceIndex += s_width;
          destinationIndex += d_width;
       }
@@ -6032,31 +6296,12 @@ void ossimImageData::copyTileToNormalizedBuffer(T /* dummyTemplate */,
    {
       const ossim_float64 MIN_PIX = getMinPix(band);
       const ossim_float64 MAX_PIX = getMaxPix(band);
-      const ossim_float64 RANGE   = (MAX_PIX-MIN_PIX);
       const ossim_float64 NP      = getNullPix(band);
 
       const T* s = (T*)getBuf(band);  // source
       ossim_float32* d = (ossim_float32*)(buf + (band*SIZE));  // destination
 
-      for(ossim_uint32 offset = 0; offset < SIZE; ++offset)
-      {
-         ossim_float64 p = s[offset];
-         if(p != NP)
-         {
-            if( p == MIN_PIX)
-            {
-               d[offset] = OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT;
-            }
-            else
-            {
-               d[offset] = (p-MIN_PIX)/RANGE;
-            }
-         }
-         else
-         {
-            d[offset] = 0.0;
-         }
-      }
+      normalizeBand(s, SIZE, MIN_PIX, MAX_PIX, NP, d);
    }   
 }
 
@@ -6103,31 +6348,12 @@ void ossimImageData::copyTileToNormalizedBuffer(T /* dummyTemplate */,
    const ossim_uint32  SIZE    = getSizePerBand();
    const ossim_float64 MIN_PIX = getMinPix(band);
    const ossim_float64 MAX_PIX = getMaxPix(band);
-   const ossim_float64 RANGE   = (MAX_PIX-MIN_PIX);
    const ossim_float64 NP      = getNullPix(band);
 
    const T* s = (T*)getBuf(band);  // source
    ossim_float32* d     = (ossim_float32*)(buf);  // destination
 
-   for(ossim_uint32 offset = 0; offset < SIZE; ++offset)
-   {
-      ossim_float64 p = s[offset];
-      if(p != NP)
-      {
-         if( p == MIN_PIX)
-         {
-            d[offset] = OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT;
-         }
-         else
-         {
-            d[offset] = (p-MIN_PIX)/RANGE;
-         }
-      }
-      else
-      {
-         d[offset] = 0.0;
-      }
-   }   
+   normalizeBand(s, SIZE, MIN_PIX, MAX_PIX, NP, d);
 }
 
 template <class T>
@@ -6173,26 +6399,12 @@ void ossimImageData::copyNormalizedBufferToTile(T /* dummyTemplate */,
    {
       const ossim_float64 MIN_PIX = getMinPix(band);
       const ossim_float64 MAX_PIX = getMaxPix(band);
-      const ossim_float64 RANGE   = (MAX_PIX-MIN_PIX);
       const T             NP      = (T)getNullPix(band);
 
       ossim_float32* s = buf + (band*SIZE); // source
       T* d   = (T*)getBuf(band); // destination
 
-      for(ossim_uint32 offset = 0; offset < SIZE; ++offset)
-      {
-         const ossim_float64 P = s[offset];
-         if(P != 0.0)
-         {
-            ossim_float64 test = MIN_PIX + RANGE*P;
-            if(test > MAX_PIX) test = MAX_PIX;
-            d[offset] = (T)test;
-         }
-         else
-         {
-            d[offset] = NP;
-         }
-      }
+      unnormalizeBand(s, SIZE, MIN_PIX, MAX_PIX, NP, d);
    }
 }
 
@@ -6234,26 +6446,12 @@ void ossimImageData::copyNormalizedBufferToTile(T /* dummyTemplate */,
    const ossim_uint32 SIZE     = getSizePerBand();
    const ossim_float64 MIN_PIX = getMinPix(band);
    const ossim_float64 MAX_PIX = getMaxPix(band);
-   const ossim_float64 RANGE   = (MAX_PIX-MIN_PIX);
    const T NP                  = (T)getNullPix(band);
 
    ossim_float32* s = buf; // source
    T* d   = (T*)getBuf(band); // destination
 
-   for(ossim_uint32 offset = 0; offset < SIZE; ++offset)
-   {
-      const ossim_float64 P = s[offset];
-      if(P != 0.0)
-      {
-         ossim_float64 test = MIN_PIX + RANGE*P;
-         if(test > MAX_PIX) test = MAX_PIX;
-         d[offset] = (T)test;
-      }
-      else
-      {
-         d[offset] = NP;
-      }
-   }
+   unnormalizeBand(s, SIZE, MIN_PIX, MAX_PIX, NP, d);
 }
 
 void ossimImageData::copyTileBandToNormalizedBuffer(ossim_uint32 band,
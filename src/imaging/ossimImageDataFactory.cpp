@@ -20,20 +20,36 @@
 #include <ossim/imaging/ossimU16ImageData.h>
 #include <ossim/imaging/ossimS16ImageData.h>
 #include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageDataPool.h>
 #include <ossim/imaging/ossimImageSource.h>
 #include <ossim/base/ossimCommon.h>
 #include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/base/ossimScalarTypeLut.h>
+#include <mutex>
 
 // Static trace for debugging
 static ossimTrace traceDebug("ossimImageDataFactory:debug");
 
+// Default pool size in megabytes when the preference is not set.
+static const ossim_uint64 DEFAULT_POOL_SIZE_MB = 64;
+
 ossimImageDataFactory* ossimImageDataFactory::theInstance = 0;
-std::mutex ossimImageDataFactory::theInstanceMutex;
+
 ossimImageDataFactory::ossimImageDataFactory() 
+   : m_pool(0)
 {
    theInstance = 0;
+
+   ossim_uint64 poolSize = DEFAULT_POOL_SIZE_MB;
+   ossimString poolSizeString = ossimPreferences::instance()->
+      findPreference("ossim.imaging.image_data_factory.pool_size");
+   if ( poolSizeString.size() )
+   {
+      poolSize = poolSizeString.toUInt64();
+   }
+   m_pool = new ossimImageDataPool(poolSize * 1024 * 1024);
 }
 
 ossimImageDataFactory::~ossimImageDataFactory()
@@ -43,48 +59,33 @@ ossimImageDataFactory::~ossimImageDataFactory()
       //delete theInstance;
       theInstance = 0;
    }
+   delete m_pool;
+   m_pool = 0;
 }
 
 ossimImageDataFactory* ossimImageDataFactory::instance()
 {
-   theInstanceMutex.lock();
-   if(!theInstance)
+   // Called for every tile, so only the first call pays for synchronization.
+   static std::once_flag instanceFlag;
+   std::call_once(instanceFlag, []()
    {
       theInstance = new ossimImageDataFactory;
-   }
-   theInstanceMutex.unlock();
+   });
    return theInstance;
 }
 
-ossimRefPtr<ossimImageData> ossimImageDataFactory::create(
-   ossimSource* owner,
-   ossimScalarType scalar,
-   ossim_uint32 bands)const
+ossimImageDataPool* ossimImageDataFactory::getPool()const
 {
-   ossimIpt tileSize;
-   ossim::defaultTileSize(tileSize);
-   ossim_uint32 width  = tileSize.x;
-   ossim_uint32 height = tileSize.y;
-   
-   // do some bounds checking and initialize to a default
-   bands  = (bands>0)?bands:1;
-   scalar = scalar != OSSIM_SCALAR_UNKNOWN?scalar:OSSIM_UINT8;
+   return m_pool;
+}
 
-   if (traceDebug())
-   {
-      ossimNotify(ossimNotifyLevel_DEBUG)
-         << "ossimImageDataFactory::create DEBUG:"
-         << "\nCaller:  "
-         << (owner ? owner->getClassName().c_str() : "unknown")
-         << "\nbands:   " << bands
-         << "\nwidth:   " << width
-         << "\nheight:  " << height
-         << "\nScalar type:  "
-         << (ossimScalarTypeLut::instance()->getEntryString(scalar))
-         << std::endl;
-   }
-   
-   ossimRefPtr<ossimImageData> result = 0;
+ossimImageData* ossimImageDataFactory::newImageData(ossimSource* owner,
+                                                    ossimScalarType scalar,
+                                                    ossim_uint32 bands,
+                                                    ossim_uint32 width,
+                                                    ossim_uint32 height)
+{
+   ossimImageData* result = 0;
    switch(scalar)
    {
       case OSSIM_UINT8:
@@ -131,10 +132,45 @@ ossimRefPtr<ossimImageData> ossimImageDataFactory::create(
       {
          // create a generic image data implementation.
          result = new ossimImageData(owner, scalar, bands, width, height);
+         break;
+      }
+   }
+   return result;
+}
+
+ossimRefPtr<ossimImageData> ossimImageDataFactory::create(
+   ossimSource* owner,
+   ossimScalarType scalar,
+   ossim_uint32 bands)const
+{
+   ossimIpt tileSize;
+   ossim::defaultTileSize(tileSize);
+   
+   // do some bounds checking and initialize to a default
+   bands  = (bands>0)?bands:1;
+   scalar = scalar != OSSIM_SCALAR_UNKNOWN?scalar:OSSIM_UINT8;
 
+   ossimRefPtr<ossimImageData> result = create(owner, scalar, bands,
+                                               tileSize.x, tileSize.y);
+
+   switch(scalar)
+   {
+      case OSSIM_UINT8:
+      case OSSIM_USHORT11:
+      case OSSIM_USHORT12:
+      case OSSIM_USHORT13:
+      case OSSIM_USHORT14:
+      case OSSIM_USHORT15:
+      case OSSIM_UINT16:
+      case OSSIM_SINT16:
+      {
+         break;
+      }
+      default:
+      {
          // Set the scalar type for stretching.
          ossimImageSource* inputSource = dynamic_cast<ossimImageSource*>(owner);
-         if( inputSource )
+         if( inputSource && result.valid() )
          {
             for(ossim_uint32 band = 0; band < bands; ++band)
             {
@@ -179,55 +215,11 @@ ossimRefPtr<ossimImageData> ossimImageDataFactory::create(
          << std::endl;
    }
    
-   ossimRefPtr<ossimImageData> result = 0;
-   switch(scalar)
+   ossimRefPtr<ossimImageData> result = m_pool->checkout(owner, scalar, bands, width, height);
+   if ( !result.valid() )
    {
-      case OSSIM_UINT8:
-      {
-         result = new ossimU8ImageData(owner, bands, width, height);
-         break;
-      }
-      case OSSIM_USHORT11:
-      {
-         result = new ossimU11ImageData(owner, bands, width, height);
-         break;
-      }
-      case OSSIM_USHORT12:
-      {
-         result = new ossimU12ImageData(owner, bands, width, height);
-         break;
-      }
-      case OSSIM_USHORT13:
-      {
-         result = new ossimU13ImageData(owner, bands, width, height);
-         break;
-      }
-      case OSSIM_USHORT14:
-      {
-         result = new ossimU14ImageData(owner, bands, width, height);
-         break;
-      }
-      case OSSIM_USHORT15:
-      {
-         result = new ossimU15ImageData(owner, bands, width, height);
-         break;
-      }
-      case OSSIM_UINT16:
-      {
-         result = new ossimU16ImageData(owner, bands, width, height);
-         break;
-      }
-      case OSSIM_SINT16:
-      {
-         result = new ossimS16ImageData(owner, bands, width, height);
-         break;
-      }
-      default:
-      {
-         // create a generic image data implementation.
-         result = new ossimImageData(owner, scalar, bands, width, height);
-         break;
-      }
+      result = newImageData(owner, scalar, bands, width, height);
+      m_pool->add(result.get());
    }
 
    return result;
@@ -0,0 +1,343 @@
+//---
+//
+// License: MIT
+//
+// Description: Scalar image data kernels and run time instruction set dispatch.
+// The SSE4.2 and AVX2 versions live in ossimImageDataKernelsSse42.cpp and
+// ossimImageDataKernelsAvx2.cpp, which are the only files built with those
+// instruction sets enabled.
+//
+//---
+// $Id$
+
+#include <ossim/imaging/ossimImageDataKernels.h>
+#include <atomic>
+#include <cfloat>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
+namespace ossim
+{
+   // Defined in the instruction set specific files. Return 0 if the file was built
+   // without that instruction set.
+   const ImageDataKernels* getSse42ImageDataKernels();
+   const ImageDataKernels* getAvx2ImageDataKernels();
+}
+
+namespace
+{
+   template <class T>
+   void deinterleaveScalar(const T* src, ossim_uint32 bands, ossim_uint32 count, T** dst)
+   {
+      if (bands == 1)
+      {
+         std::memcpy(dst[0], src, count * sizeof(T));
+         return;
+      }
+      // Band outer loop keeps the stores sequential:
+      for (ossim_uint32 band = 0; band < bands; ++band)
+      {
+         const T* s = src + band;
+         T* d = dst[band];
+         for (ossim_uint32 i = 0; i < count; ++i)
+         {
+            d[i] = *s;
+            s += bands;
+         }
+      }
+   }
+
+   template <class T>
+   bool minMaxScalar(const T* buf, ossim_uint32 count, T exclude, T* minVal, T* maxVal)
+   {
+      bool found = false;
+      T currentMin = 0;
+      T currentMax = 0;
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p == p) ) // p == p skips NaN
+         {
+            if (!found)
+            {
+               currentMin = p;
+               currentMax = p;
+               found = true;
+            }
+            if (p < currentMin)
+            {
+               currentMin = p;
+            }
+            if (p > currentMax)
+            {
+               currentMax = p;
+            }
+         }
+      }
+      if (found)
+      {
+         *minVal = currentMin;
+         *maxVal = currentMax;
+      }
+      return found;
+   }
+
+   template <class T>
+   bool minAboveScalar(const T* buf, ossim_uint32 count, T exclude, T threshold, T* minVal)
+   {
+      bool found = false;
+      T currentMin = 0;
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p > threshold) && (!found || (p < currentMin)) )
+         {
+            currentMin = p;
+            found = true;
+         }
+      }
+      if (found)
+      {
+         *minVal = currentMin;
+      }
+      return found;
+   }
+
+   template <class T>
+   void normalizeScalar(const T* src, ossim_uint32 count, ossim_float64 minPix,
+                        ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         const ossim_float64 p = src[i];
+         if (p == nullPix)
+         {
+            dst[i] = 0.0;
+         }
+         else if (p == minPix)
+         {
+            dst[i] = OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT;
+         }
+         else
+         {
+            dst[i] = (ossim_float32)((p - minPix) / RANGE);
+         }
+      }
+   }
+
+   template <class T>
+   void unnormalizeScalar(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                          ossim_float64 maxPix, T nullPix, T* dst)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         const ossim_float64 p = src[i];
+         if (p != 0.0)
+         {
+            ossim_float64 test = minPix + RANGE * p;
+            if (test > maxPix) test = maxPix;
+            dst[i] = (T)test;
+         }
+         else
+         {
+            dst[i] = nullPix;
+         }
+      }
+   }
+
+   void weightedSumScalar(const ossim_float64* const* rows, const ossim_float64* weights,
+                          ossim_uint32 taps, ossim_uint32 count, ossim_float64* dst)
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         ossim_float64 sum = 0.0;
+         for (ossim_uint32 k = 0; k < taps; ++k)
+            sum += weights[k] * rows[k][i];
+         dst[i] = sum;
+      }
+   }
+
+   void gatherWeightedSumScalar(const ossim_float64* src, const ossim_int32* start,
+                                const ossim_float64* weights, ossim_uint32 taps,
+                                ossim_uint32 count, ossim_float64* dst)
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         const ossim_float64* s = src + start[i];
+         ossim_float64 sum = 0.0;
+         for (ossim_uint32 k = 0; k < taps; ++k)
+            sum += weights[k * count + i] * s[k];
+         dst[i] = sum;
+      }
+   }
+
+   const ossim::ImageDataKernels SCALAR_KERNELS =
+   {
+      deinterleaveScalar<ossim_uint8>,
+      deinterleaveScalar<ossim_uint16>,
+      deinterleaveScalar<ossim_uint32>,
+
+      minMaxScalar<ossim_uint8>,
+      minMaxScalar<ossim_uint16>,
+      minMaxScalar<ossim_sint16>,
+      minMaxScalar<ossim_float32>,
+
+      minAboveScalar<ossim_uint8>,
+      minAboveScalar<ossim_uint16>,
+      minAboveScalar<ossim_sint16>,
+      minAboveScalar<ossim_float32>,
+
+      normalizeScalar<ossim_uint8>,
+      normalizeScalar<ossim_uint16>,
+      normalizeScalar<ossim_sint16>,
+      normalizeScalar<ossim_float32>,
+
+      unnormalizeScalar<ossim_uint8>,
+      unnormalizeScalar<ossim_uint16>,
+      unnormalizeScalar<ossim_sint16>,
+      unnormalizeScalar<ossim_float32>,
+
+      weightedSumScalar,
+      gatherWeightedSumScalar
+   };
+
+   /** @return The highest level the CPU (and OS, for AVX state) supports. */
+   ossim::SimdLevel detectCpuLevel()
+   {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+      __builtin_cpu_init();
+      if (__builtin_cpu_supports("avx2"))
+         return ossim::SIMD_AVX2;
+      if (__builtin_cpu_supports("sse4.2"))
+         return ossim::SIMD_SSE42;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+      int info[4];
+      __cpuid(info, 0);
+      const int maxLeaf = info[0];
+      __cpuid(info, 1);
+      const bool sse42   = (info[2] & (1 << 20)) != 0;
+      const bool osxsave = (info[2] & (1 << 27)) != 0;
+      const bool avx     = (info[2] & (1 << 28)) != 0;
+      if ( (maxLeaf >= 7) && osxsave && avx && ((_xgetbv(0) & 0x6) == 0x6) )
+      {
+         __cpuidex(info, 7, 0);
+         if (info[1] & (1 << 5))
+            return ossim::SIMD_AVX2;
+      }
+      if (sse42)
+         return ossim::SIMD_SSE42;
+#endif
+      return ossim::SIMD_NONE;
+   }
+
+   /** Replaces the entries of table that level provides. */
+   void overlay(ossim::ImageDataKernels& table, const ossim::ImageDataKernels* level)
+   {
+      if (!level)
+         return;
+
+#define OSSIM_OVERLAY_KERNEL(name) if (level->name) table.name = level->name
+      OSSIM_OVERLAY_KERNEL(deinterleave8);
+      OSSIM_OVERLAY_KERNEL(deinterleave16);
+      OSSIM_OVERLAY_KERNEL(deinterleave32);
+      OSSIM_OVERLAY_KERNEL(minMaxU8);
+      OSSIM_OVERLAY_KERNEL(minMaxU16);
+      OSSIM_OVERLAY_KERNEL(minMaxS16);
+      OSSIM_OVERLAY_KERNEL(minMaxF32);
+      OSSIM_OVERLAY_KERNEL(minAboveU8);
+      OSSIM_OVERLAY_KERNEL(minAboveU16);
+      OSSIM_OVERLAY_KERNEL(minAboveS16);
+      OSSIM_OVERLAY_KERNEL(minAboveF32);
+      OSSIM_OVERLAY_KERNEL(normalizeU8);
+      OSSIM_OVERLAY_KERNEL(normalizeU16);
+      OSSIM_OVERLAY_KERNEL(normalizeS16);
+      OSSIM_OVERLAY_KERNEL(normalizeF32);
+      OSSIM_OVERLAY_KERNEL(unnormalizeU8);
+      OSSIM_OVERLAY_KERNEL(unnormalizeU16);
+      OSSIM_OVERLAY_KERNEL(unnormalizeS16);
+      OSSIM_OVERLAY_KERNEL(unnormalizeF32);
+      OSSIM_OVERLAY_KERNEL(weightedSumF64);
+      OSSIM_OVERLAY_KERNEL(gatherWeightedSumF64);
+#undef OSSIM_OVERLAY_KERNEL
+   }
+
+   struct Dispatch
+   {
+      Dispatch()
+         : m_supported(ossim::SIMD_NONE),
+           m_active(0)
+      {
+         m_tables[ossim::SIMD_NONE] = SCALAR_KERNELS;
+         m_tables[ossim::SIMD_SSE42] = SCALAR_KERNELS;
+         overlay(m_tables[ossim::SIMD_SSE42], ossim::getSse42ImageDataKernels());
+         m_tables[ossim::SIMD_AVX2] = m_tables[ossim::SIMD_SSE42];
+         overlay(m_tables[ossim::SIMD_AVX2], ossim::getAvx2ImageDataKernels());
+
+         // Supported means the CPU has it and the matching file was built with it:
+         ossim::SimdLevel cpu = detectCpuLevel();
+         if ( (cpu >= ossim::SIMD_SSE42) && ossim::getSse42ImageDataKernels() )
+         {
+            m_supported = ossim::SIMD_SSE42;
+            if ( (cpu >= ossim::SIMD_AVX2) && ossim::getAvx2ImageDataKernels() )
+               m_supported = ossim::SIMD_AVX2;
+         }
+         m_active = m_supported;
+      }
+
+      ossim::ImageDataKernels      m_tables[3];
+      ossim::SimdLevel             m_supported;
+      std::atomic<int>             m_active;
+   };
+
+   Dispatch& dispatch()
+   {
+      static Dispatch d;
+      return d;
+   }
+}
+
+const ossim::ImageDataKernels& ossim::getImageDataKernels()
+{
+   Dispatch& d = dispatch();
+   return d.m_tables[d.m_active.load(std::memory_order_relaxed)];
+}
+
+ossim::SimdLevel ossim::getSimdLevel()
+{
+   return static_cast<ossim::SimdLevel>(dispatch().m_active.load());
+}
+
+ossim::SimdLevel ossim::getSupportedSimdLevel()
+{
+   return dispatch().m_supported;
+}
+
+void ossim::setSimdLevel(ossim::SimdLevel level)
+{
+   Dispatch& d = dispatch();
+   if (level > d.m_supported)
+      level = d.m_supported;
+   if (level < ossim::SIMD_NONE)
+      level = ossim::SIMD_NONE;
+   d.m_active.store(level);
+}
+
+const char* ossim::getSimdLevelName(ossim::SimdLevel level)
+{
+   switch (level)
+   {
+      case ossim::SIMD_SSE42:
+         return "sse4.2";
+      case ossim::SIMD_AVX2:
+         return "avx2";
+      case ossim::SIMD_NONE:
+      default:
+         return "none";
+   }
+}
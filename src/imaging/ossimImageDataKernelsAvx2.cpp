@@ -0,0 +1,574 @@
+//---
+//
+// License: MIT
+//
+// Description: AVX2 image data kernels.
+//
+// This file is built with AVX2 code generation enabled (see src/CMakeLists.txt)
+// and is only called after ossim::getImageDataKernels() has checked the CPU, so it
+// must not include headers with inline code that could be shared with the rest of
+// the library.  Deinterleave is left to the SSE4.2 version; the 128 bit lane split
+// of the AVX2 byte shuffle makes it no faster for 3 band data.
+//
+//---
+// $Id$
+
+#include <ossim/imaging/ossimImageDataKernels.h>
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+namespace
+{
+   //---
+   // Min/max scans.  Excluded lanes are replaced with the identity of the reduction
+   // so no per pixel branch is needed.
+   //---
+   struct U8Ops
+   {
+      typedef ossim_uint8 T;
+      typedef __m256i V;
+      enum { N = 32 };
+      static T lowest()  { return 0; }
+      static T highest() { return 0xff; }
+      static V load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+      static void store(T* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+      static V set1(T v) { return _mm256_set1_epi8((char)v); }
+      static V ones() { return _mm256_set1_epi32(-1); }
+      static V invalid(V p, V ex) { return _mm256_cmpeq_epi8(p, ex); }
+      static V gt(V a, V b)
+      {
+         const V SIGN = _mm256_set1_epi8((char)0x80);
+         return _mm256_cmpgt_epi8(_mm256_xor_si256(a, SIGN), _mm256_xor_si256(b, SIGN));
+      }
+      static V vmin(V a, V b) { return _mm256_min_epu8(a, b); }
+      static V vmax(V a, V b) { return _mm256_max_epu8(a, b); }
+      static V select(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+      static V and_(V a, V b) { return _mm256_and_si256(a, b); }
+      static V or_(V a, V b) { return _mm256_or_si256(a, b); }
+      static V andnot(V a, V b) { return _mm256_andnot_si256(a, b); }
+      static bool allSet(V v) { return _mm256_movemask_epi8(v) == -1; }
+   };
+
+   struct U16Ops
+   {
+      typedef ossim_uint16 T;
+      typedef __m256i V;
+      enum { N = 16 };
+      static T lowest()  { return 0; }
+      static T highest() { return 0xffff; }
+      static V load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+      static void store(T* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+      static V set1(T v) { return _mm256_set1_epi16((short)v); }
+      static V ones() { return _mm256_set1_epi32(-1); }
+      static V invalid(V p, V ex) { return _mm256_cmpeq_epi16(p, ex); }
+      static V gt(V a, V b)
+      {
+         const V SIGN = _mm256_set1_epi16((short)0x8000);
+         return _mm256_cmpgt_epi16(_mm256_xor_si256(a, SIGN), _mm256_xor_si256(b, SIGN));
+      }
+      static V vmin(V a, V b) { return _mm256_min_epu16(a, b); }
+      static V vmax(V a, V b) { return _mm256_max_epu16(a, b); }
+      static V select(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+      static V and_(V a, V b) { return _mm256_and_si256(a, b); }
+      static V or_(V a, V b) { return _mm256_or_si256(a, b); }
+      static V andnot(V a, V b) { return _mm256_andnot_si256(a, b); }
+      static bool allSet(V v) { return _mm256_movemask_epi8(v) == -1; }
+   };
+
+   struct S16Ops
+   {
+      typedef ossim_sint16 T;
+      typedef __m256i V;
+      enum { N = 16 };
+      static T lowest()  { return -32768; }
+      static T highest() { return 32767; }
+      static V load(const T* p) { return _mm256_loadu_si256((const __m256i*)p); }
+      static void store(T* p, V v) { _mm256_storeu_si256((__m256i*)p, v); }
+      static V set1(T v) { return _mm256_set1_epi16(v); }
+      static V ones() { return _mm256_set1_epi32(-1); }
+      static V invalid(V p, V ex) { return _mm256_cmpeq_epi16(p, ex); }
+      static V gt(V a, V b) { return _mm256_cmpgt_epi16(a, b); }
+      static V vmin(V a, V b) { return _mm256_min_epi16(a, b); }
+      static V vmax(V a, V b) { return _mm256_max_epi16(a, b); }
+      static V select(V mask, V a, V b) { return _mm256_blendv_epi8(b, a, mask); }
+      static V and_(V a, V b) { return _mm256_and_si256(a, b); }
+      static V or_(V a, V b) { return _mm256_or_si256(a, b); }
+      static V andnot(V a, V b) { return _mm256_andnot_si256(a, b); }
+      static bool allSet(V v) { return _mm256_movemask_epi8(v) == -1; }
+   };
+
+   struct F32Ops
+   {
+      typedef ossim_float32 T;
+      typedef __m256 V;
+      enum { N = 8 };
+      static T lowest()  { return -highest(); }
+      static T highest() { return _mm_cvtss_f32(_mm_castsi128_ps(_mm_set1_epi32(0x7f800000))); }
+      static V load(const T* p) { return _mm256_loadu_ps(p); }
+      static void store(T* p, V v) { _mm256_storeu_ps(p, v); }
+      static V set1(T v) { return _mm256_set1_ps(v); }
+      static V ones() { return _mm256_castsi256_ps(_mm256_set1_epi32(-1)); }
+      static V invalid(V p, V ex)
+      {
+         return _mm256_or_ps(_mm256_cmp_ps(p, ex, _CMP_EQ_OQ), _mm256_cmp_ps(p, p, _CMP_UNORD_Q));
+      }
+      static V gt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+      static V vmin(V a, V b) { return _mm256_min_ps(a, b); }
+      static V vmax(V a, V b) { return _mm256_max_ps(a, b); }
+      static V select(V mask, V a, V b) { return _mm256_blendv_ps(b, a, mask); }
+      static V and_(V a, V b) { return _mm256_and_ps(a, b); }
+      static V or_(V a, V b) { return _mm256_or_ps(a, b); }
+      static V andnot(V a, V b) { return _mm256_andnot_ps(a, b); }
+      static bool allSet(V v) { return _mm256_movemask_ps(v) == 0xff; }
+   };
+
+   template <class Ops>
+   bool minMax(const typename Ops::T* buf, ossim_uint32 count, typename Ops::T exclude,
+               typename Ops::T* minVal, typename Ops::T* maxVal)
+   {
+      typedef typename Ops::T T;
+      typedef typename Ops::V V;
+
+      bool found = false;
+      T currentMin = 0;
+      T currentMax = 0;
+      ossim_uint32 i = 0;
+      if (count >= (ossim_uint32)Ops::N)
+      {
+         const V EX = Ops::set1(exclude);
+         const V HI = Ops::set1(Ops::highest());
+         const V LO = Ops::set1(Ops::lowest());
+         V vmin = HI;
+         V vmax = LO;
+         V allInvalid = Ops::ones();
+         for (; i + Ops::N <= count; i += Ops::N)
+         {
+            const V p = Ops::load(buf + i);
+            const V bad = Ops::invalid(p, EX);
+            allInvalid = Ops::and_(allInvalid, bad);
+            vmin = Ops::vmin(vmin, Ops::select(bad, HI, p));
+            vmax = Ops::vmax(vmax, Ops::select(bad, LO, p));
+         }
+         if (!Ops::allSet(allInvalid))
+         {
+            T lanesMin[Ops::N];
+            T lanesMax[Ops::N];
+            Ops::store(lanesMin, vmin);
+            Ops::store(lanesMax, vmax);
+            currentMin = lanesMin[0];
+            currentMax = lanesMax[0];
+            for (int lane = 1; lane < Ops::N; ++lane)
+            {
+               if (lanesMin[lane] < currentMin) currentMin = lanesMin[lane];
+               if (lanesMax[lane] > currentMax) currentMax = lanesMax[lane];
+            }
+            found = true;
+         }
+      }
+      for (; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p == p) )
+         {
+            if (!found)
+            {
+               currentMin = p;
+               currentMax = p;
+               found = true;
+            }
+            if (p < currentMin) currentMin = p;
+            if (p > currentMax) currentMax = p;
+         }
+      }
+      if (found)
+      {
+         *minVal = currentMin;
+         *maxVal = currentMax;
+      }
+      return found;
+   }
+
+   template <class Ops>
+   bool minAbove(const typename Ops::T* buf, ossim_uint32 count, typename Ops::T exclude,
+                 typename Ops::T threshold, typename Ops::T* minVal)
+   {
+      typedef typename Ops::T T;
+      typedef typename Ops::V V;
+
+      bool found = false;
+      T currentMin = 0;
+      ossim_uint32 i = 0;
+      if (count >= (ossim_uint32)Ops::N)
+      {
+         const V EX  = Ops::set1(exclude);
+         const V THR = Ops::set1(threshold);
+         const V HI  = Ops::set1(Ops::highest());
+         V vmin = HI;
+         V allInvalid = Ops::ones();
+         for (; i + Ops::N <= count; i += Ops::N)
+         {
+            const V p = Ops::load(buf + i);
+            const V bad = Ops::or_(Ops::invalid(p, EX), Ops::andnot(Ops::gt(p, THR), Ops::ones()));
+            allInvalid = Ops::and_(allInvalid, bad);
+            vmin = Ops::vmin(vmin, Ops::select(bad, HI, p));
+         }
+         if (!Ops::allSet(allInvalid))
+         {
+            T lanes[Ops::N];
+            Ops::store(lanes, vmin);
+            currentMin = lanes[0];
+            for (int lane = 1; lane < Ops::N; ++lane)
+            {
+               if (lanes[lane] < currentMin) currentMin = lanes[lane];
+            }
+            found = true;
+         }
+      }
+      for (; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p > threshold) && (!found || (p < currentMin)) )
+         {
+            currentMin = p;
+            found = true;
+         }
+      }
+      if (found)
+      {
+         *minVal = currentMin;
+      }
+      return found;
+   }
+
+   //---
+   // Normalize:  Eight pixels per step, widened to two double quads so the math
+   // matches the scalar templates bit for bit.
+   //---
+   inline void widen(__m256i v, __m256d& lo, __m256d& hi)
+   {
+      lo = _mm256_cvtepi32_pd(_mm256_castsi256_si128(v));
+      hi = _mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1));
+   }
+
+   inline void widen(const ossim_uint8* p, __m256d& lo, __m256d& hi)
+   {
+      widen(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)p)), lo, hi);
+   }
+
+   inline void widen(const ossim_uint16* p, __m256d& lo, __m256d& hi)
+   {
+      widen(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)p)), lo, hi);
+   }
+
+   inline void widen(const ossim_sint16* p, __m256d& lo, __m256d& hi)
+   {
+      widen(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)p)), lo, hi);
+   }
+
+   inline void widen(const ossim_float32* p, __m256d& lo, __m256d& hi)
+   {
+      const __m256 v = _mm256_loadu_ps(p);
+      lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+      hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+   }
+
+   inline __m256 narrow(__m256d lo, __m256d hi)
+   {
+      return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)),
+                                  _mm256_cvtpd_ps(hi), 1);
+   }
+
+   template <class T>
+   void normalize(const T* src, ossim_uint32 count, ossim_float64 minPix,
+                  ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      const __m256d MIN   = _mm256_set1_pd(minPix);
+      const __m256d RNG   = _mm256_set1_pd(RANGE);
+      const __m256d NUL   = _mm256_set1_pd(nullPix);
+      const __m256d NORM  = _mm256_set1_pd(OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT);
+      const __m256d ZERO  = _mm256_setzero_pd();
+
+      ossim_uint32 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         __m256d p[2];
+         widen(src + i, p[0], p[1]);
+         for (int k = 0; k < 2; ++k)
+         {
+            __m256d v = _mm256_div_pd(_mm256_sub_pd(p[k], MIN), RNG);
+            v = _mm256_blendv_pd(v, NORM, _mm256_cmp_pd(p[k], MIN, _CMP_EQ_OQ));
+            p[k] = _mm256_blendv_pd(v, ZERO, _mm256_cmp_pd(p[k], NUL, _CMP_EQ_OQ));
+         }
+         _mm256_storeu_ps(dst + i, narrow(p[0], p[1]));
+      }
+      for (; i < count; ++i)
+      {
+         const ossim_float64 p = src[i];
+         if (p == nullPix)
+            dst[i] = 0.0;
+         else if (p == minPix)
+            dst[i] = OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT;
+         else
+            dst[i] = (ossim_float32)((p - minPix) / RANGE);
+      }
+   }
+
+   void normalizeU8(const ossim_uint8* src, ossim_uint32 count, ossim_float64 minPix,
+                    ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void normalizeU16(const ossim_uint16* src, ossim_uint32 count, ossim_float64 minPix,
+                     ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void normalizeS16(const ossim_sint16* src, ossim_uint32 count, ossim_float64 minPix,
+                     ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void normalizeF32(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                     ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   //---
+   // Unnormalize:  Eight floats per step to double, scale, clamp to max and truncate.
+   // The caller packs the int32 lanes (with saturation) to the tile type.
+   //---
+   struct Unnormalizer
+   {
+      Unnormalizer(ossim_float64 minPix, ossim_float64 maxPix)
+         : MIN(_mm256_set1_pd(minPix)),
+           MAX(_mm256_set1_pd(maxPix)),
+           RNG(_mm256_set1_pd(maxPix - minPix))
+      {
+      }
+
+      /** @return Scaled and clamped values; isZero set for null input lanes. */
+      void scale(const ossim_float32* s, __m256d& lo, __m256d& hi, __m256& isZero) const
+      {
+         const __m256 f = _mm256_loadu_ps(s);
+         isZero = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_EQ_OQ);
+         lo = _mm256_cvtps_pd(_mm256_castps256_ps128(f));
+         hi = _mm256_cvtps_pd(_mm256_extractf128_ps(f, 1));
+         // min(MAX, t) keeps a NaN t like the scalar "if (t > max)" does:
+         lo = _mm256_min_pd(MAX, _mm256_add_pd(MIN, _mm256_mul_pd(RNG, lo)));
+         hi = _mm256_min_pd(MAX, _mm256_add_pd(MIN, _mm256_mul_pd(RNG, hi)));
+      }
+
+      __m256i toInt(const ossim_float32* s, __m256i nullPix) const
+      {
+         __m256d lo, hi;
+         __m256 isZero;
+         scale(s, lo, hi, isZero);
+         const __m256i v = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm256_cvttpd_epi32(lo)), _mm256_cvttpd_epi32(hi), 1);
+         return _mm256_blendv_epi8(v, nullPix, _mm256_castps_si256(isZero));
+      }
+
+      const __m256d MIN;
+      const __m256d MAX;
+      const __m256d RNG;
+   };
+
+   template <class T>
+   void unnormalizeTail(const ossim_float32* src, ossim_uint32 start, ossim_uint32 count,
+                        ossim_float64 minPix, ossim_float64 maxPix, T nullPix, T* dst)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      for (ossim_uint32 i = start; i < count; ++i)
+      {
+         const ossim_float64 p = src[i];
+         if (p != 0.0)
+         {
+            ossim_float64 test = minPix + RANGE * p;
+            if (test > maxPix) test = maxPix;
+            dst[i] = (T)test;
+         }
+         else
+         {
+            dst[i] = nullPix;
+         }
+      }
+   }
+
+   /** Packs eight int32 lanes to eight 16 bit values, unsigned saturation. */
+   inline __m128i packus16(__m256i v)
+   {
+      return _mm_packus_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+   }
+
+   void unnormalizeU8(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                      ossim_float64 maxPix, ossim_uint8 nullPix, ossim_uint8* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m256i NUL = _mm256_set1_epi32(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 16 <= count; i += 16)
+      {
+         const __m128i a = packus16(U.toInt(src + i, NUL));
+         const __m128i b = packus16(U.toInt(src + i + 8, NUL));
+         _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void unnormalizeU16(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                       ossim_float64 maxPix, ossim_uint16 nullPix, ossim_uint16* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m256i NUL = _mm256_set1_epi32(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         _mm_storeu_si128((__m128i*)(dst + i), packus16(U.toInt(src + i, NUL)));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void unnormalizeS16(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                       ossim_float64 maxPix, ossim_sint16 nullPix, ossim_sint16* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m256i NUL = _mm256_set1_epi32(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         const __m256i v = U.toInt(src + i, NUL);
+         _mm_storeu_si128((__m128i*)(dst + i),
+                          _mm_packs_epi32(_mm256_castsi256_si128(v),
+                                          _mm256_extracti128_si256(v, 1)));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void unnormalizeF32(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                       ossim_float64 maxPix, ossim_float32 nullPix, ossim_float32* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m256 NUL = _mm256_set1_ps(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         __m256d lo, hi;
+         __m256 isZero;
+         U.scale(src + i, lo, hi, isZero);
+         _mm256_storeu_ps(dst + i, _mm256_blendv_ps(narrow(lo, hi), NUL, isZero));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   //---
+   // Resampling sums.  Four columns per step; no FMA so the build flag stays -mavx2.
+   //---
+   void weightedSumF64(const ossim_float64* const* rows, const ossim_float64* weights,
+                       ossim_uint32 taps, ossim_uint32 count, ossim_float64* dst)
+   {
+      ossim_uint32 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         __m256d sum0 = _mm256_setzero_pd();
+         __m256d sum1 = _mm256_setzero_pd();
+         for (ossim_uint32 k = 0; k < taps; ++k)
+         {
+            const __m256d W = _mm256_set1_pd(weights[k]);
+            sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(W, _mm256_loadu_pd(rows[k] + i)));
+            sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(W, _mm256_loadu_pd(rows[k] + i + 4)));
+         }
+         _mm256_storeu_pd(dst + i, sum0);
+         _mm256_storeu_pd(dst + i + 4, sum1);
+      }
+      for (; i < count; ++i)
+      {
+         ossim_float64 sum = 0.0;
+         for (ossim_uint32 k = 0; k < taps; ++k)
+            sum += weights[k] * rows[k][i];
+         dst[i] = sum;
+      }
+   }
+
+   void gatherWeightedSumF64(const ossim_float64* src, const ossim_int32* start,
+                             const ossim_float64* weights, ossim_uint32 taps,
+                             ossim_uint32 count, ossim_float64* dst)
+   {
+      ossim_uint32 i = 0;
+      for (; i + 4 <= count; i += 4)
+      {
+         const __m128i IDX = _mm_loadu_si128((const __m128i*)(start + i));
+         __m256d sum = _mm256_setzero_pd();
+         for (ossim_uint32 k = 0; k < taps; ++k)
+         {
+            const __m256d P = _mm256_i32gather_pd(src + k, IDX, 8);
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(weights + k * count + i), P));
+         }
+         _mm256_storeu_pd(dst + i, sum);
+      }
+      for (; i < count; ++i)
+      {
+         const ossim_float64* s = src + start[i];
+         ossim_float64 sum = 0.0;
+         for (ossim_uint32 k = 0; k < taps; ++k)
+            sum += weights[k * count + i] * s[k];
+         dst[i] = sum;
+      }
+   }
+
+   const ossim::ImageDataKernels AVX2_KERNELS =
+   {
+      0, // deinterleave8:  SSE4.2 version
+      0, // deinterleave16: SSE4.2 version
+      0, // deinterleave32: SSE4.2 version
+
+      minMax<U8Ops>,
+      minMax<U16Ops>,
+      minMax<S16Ops>,
+      minMax<F32Ops>,
+
+      minAbove<U8Ops>,
+      minAbove<U16Ops>,
+      minAbove<S16Ops>,
+      minAbove<F32Ops>,
+
+      normalizeU8,
+      normalizeU16,
+      normalizeS16,
+      normalizeF32,
+
+      unnormalizeU8,
+      unnormalizeU16,
+      unnormalizeS16,
+      unnormalizeF32,
+
+      weightedSumF64,
+      gatherWeightedSumF64
+   };
+}
+
+namespace ossim
+{
+   const ImageDataKernels* getAvx2ImageDataKernels()
+   {
+      return &AVX2_KERNELS;
+   }
+}
+
+#else /* No AVX2 code generation for this target. */
+
+namespace ossim
+{
+   const ImageDataKernels* getAvx2ImageDataKernels()
+   {
+      return 0;
+   }
+}
+
+#endif
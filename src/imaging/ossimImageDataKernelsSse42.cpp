@@ -0,0 +1,644 @@
+//---
+//
+// License: MIT
+//
+// Description: SSE4.2 image data kernels.
+//
+// This file is built with SSE4.2 code generation enabled (see src/CMakeLists.txt)
+// and is only called after ossim::getImageDataKernels() has checked the CPU, so it
+// must not include headers with inline code that could be shared with the rest of
+// the library.
+//
+//---
+// $Id$
+
+#include <ossim/imaging/ossimImageDataKernels.h>
+
+#if defined(__SSE4_2__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+
+#include <nmmintrin.h>
+
+namespace
+{
+   //---
+   // Deinterleave:  A block is one 16 byte load per band, i.e. 16 bytes of output per
+   // band.  Each output vector is the OR of one byte shuffle of every input vector.
+   //---
+   template <int E, int B> // element size, bands
+   struct ShuffleMasks
+   {
+      ShuffleMasks()
+      {
+         for (int band = 0; band < B; ++band)
+         {
+            for (int chunk = 0; chunk < B; ++chunk)
+            {
+               char bytes[16];
+               for (int i = 0; i < 16; ++i)
+               {
+                  // Output byte i of this band comes from input byte:
+                  const int element = (i / E) * B + band;
+                  const int srcByte = element * E + (i % E);
+                  bytes[i] = ( (srcByte / 16) == chunk ) ? (char)(srcByte % 16) : (char)0x80;
+               }
+               m_masks[band][chunk] = _mm_loadu_si128((const __m128i*)bytes);
+            }
+         }
+      }
+      __m128i m_masks[B][B];
+   };
+
+   template <int E, int B>
+   void deinterleaveBlocks(const ossim_uint8* src, ossim_uint32 blocks, ossim_uint8** dst)
+   {
+      static const ShuffleMasks<E, B> SM;
+
+      __m128i in[B];
+      for (ossim_uint32 blk = 0; blk < blocks; ++blk)
+      {
+         for (int chunk = 0; chunk < B; ++chunk)
+         {
+            in[chunk] = _mm_loadu_si128((const __m128i*)(src + 16 * chunk));
+         }
+         for (int band = 0; band < B; ++band)
+         {
+            __m128i v = _mm_shuffle_epi8(in[0], SM.m_masks[band][0]);
+            for (int chunk = 1; chunk < B; ++chunk)
+            {
+               v = _mm_or_si128(v, _mm_shuffle_epi8(in[chunk], SM.m_masks[band][chunk]));
+            }
+            _mm_storeu_si128((__m128i*)(dst[band] + 16 * blk), v);
+         }
+         src += 16 * B;
+      }
+   }
+
+   template <class T>
+   void deinterleave(const T* src, ossim_uint32 bands, ossim_uint32 count, T** dst)
+   {
+      const ossim_uint32 PIXELS_PER_BLOCK = 16 / sizeof(T);
+      ossim_uint32 blocks = count / PIXELS_PER_BLOCK;
+
+      ossim_uint8* d[4];
+      for (ossim_uint32 band = 0; (band < bands) && (band < 4); ++band)
+      {
+         d[band] = reinterpret_cast<ossim_uint8*>(dst[band]);
+      }
+
+      const ossim_uint8* s = reinterpret_cast<const ossim_uint8*>(src);
+      switch (bands)
+      {
+         case 2:
+            deinterleaveBlocks<sizeof(T), 2>(s, blocks, d);
+            break;
+         case 3:
+            deinterleaveBlocks<sizeof(T), 3>(s, blocks, d);
+            break;
+         case 4:
+            deinterleaveBlocks<sizeof(T), 4>(s, blocks, d);
+            break;
+         default:
+            blocks = 0; // 1 band is a copy; more than 4 is left to the scalar loop.
+            break;
+      }
+
+      for (ossim_uint32 band = 0; band < bands; ++band)
+      {
+         T* out = dst[band];
+         for (ossim_uint32 i = blocks * PIXELS_PER_BLOCK; i < count; ++i)
+         {
+            out[i] = src[i * bands + band];
+         }
+      }
+   }
+
+   void deinterleave8(const ossim_uint8* src, ossim_uint32 bands, ossim_uint32 count,
+                      ossim_uint8** dst)
+   {
+      deinterleave(src, bands, count, dst);
+   }
+
+   void deinterleave16(const ossim_uint16* src, ossim_uint32 bands, ossim_uint32 count,
+                       ossim_uint16** dst)
+   {
+      deinterleave(src, bands, count, dst);
+   }
+
+   void deinterleave32(const ossim_uint32* src, ossim_uint32 bands, ossim_uint32 count,
+                       ossim_uint32** dst)
+   {
+      deinterleave(src, bands, count, dst);
+   }
+
+   //---
+   // Min/max scans.  Excluded lanes are replaced with the identity of the reduction
+   // so no per pixel branch is needed.
+   //---
+   struct U8Ops
+   {
+      typedef ossim_uint8 T;
+      typedef __m128i V;
+      enum { N = 16 };
+      static T lowest()  { return 0; }
+      static T highest() { return 0xff; }
+      static V load(const T* p) { return _mm_loadu_si128((const __m128i*)p); }
+      static void store(T* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+      static V set1(T v) { return _mm_set1_epi8((char)v); }
+      static V ones() { return _mm_set1_epi32(-1); }
+      static V invalid(V p, V ex) { return _mm_cmpeq_epi8(p, ex); }
+      static V gt(V a, V b)
+      {
+         const V SIGN = _mm_set1_epi8((char)0x80);
+         return _mm_cmpgt_epi8(_mm_xor_si128(a, SIGN), _mm_xor_si128(b, SIGN));
+      }
+      static V vmin(V a, V b) { return _mm_min_epu8(a, b); }
+      static V vmax(V a, V b) { return _mm_max_epu8(a, b); }
+      static V select(V mask, V a, V b) { return _mm_blendv_epi8(b, a, mask); }
+      static V and_(V a, V b) { return _mm_and_si128(a, b); }
+      static V or_(V a, V b) { return _mm_or_si128(a, b); }
+      static V andnot(V a, V b) { return _mm_andnot_si128(a, b); }
+      static bool allSet(V v) { return _mm_movemask_epi8(v) == 0xffff; }
+   };
+
+   struct U16Ops
+   {
+      typedef ossim_uint16 T;
+      typedef __m128i V;
+      enum { N = 8 };
+      static T lowest()  { return 0; }
+      static T highest() { return 0xffff; }
+      static V load(const T* p) { return _mm_loadu_si128((const __m128i*)p); }
+      static void store(T* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+      static V set1(T v) { return _mm_set1_epi16((short)v); }
+      static V ones() { return _mm_set1_epi32(-1); }
+      static V invalid(V p, V ex) { return _mm_cmpeq_epi16(p, ex); }
+      static V gt(V a, V b)
+      {
+         const V SIGN = _mm_set1_epi16((short)0x8000);
+         return _mm_cmpgt_epi16(_mm_xor_si128(a, SIGN), _mm_xor_si128(b, SIGN));
+      }
+      static V vmin(V a, V b) { return _mm_min_epu16(a, b); }
+      static V vmax(V a, V b) { return _mm_max_epu16(a, b); }
+      static V select(V mask, V a, V b) { return _mm_blendv_epi8(b, a, mask); }
+      static V and_(V a, V b) { return _mm_and_si128(a, b); }
+      static V or_(V a, V b) { return _mm_or_si128(a, b); }
+      static V andnot(V a, V b) { return _mm_andnot_si128(a, b); }
+      static bool allSet(V v) { return _mm_movemask_epi8(v) == 0xffff; }
+   };
+
+   struct S16Ops
+   {
+      typedef ossim_sint16 T;
+      typedef __m128i V;
+      enum { N = 8 };
+      static T lowest()  { return -32768; }
+      static T highest() { return 32767; }
+      static V load(const T* p) { return _mm_loadu_si128((const __m128i*)p); }
+      static void store(T* p, V v) { _mm_storeu_si128((__m128i*)p, v); }
+      static V set1(T v) { return _mm_set1_epi16(v); }
+      static V ones() { return _mm_set1_epi32(-1); }
+      static V invalid(V p, V ex) { return _mm_cmpeq_epi16(p, ex); }
+      static V gt(V a, V b) { return _mm_cmpgt_epi16(a, b); }
+      static V vmin(V a, V b) { return _mm_min_epi16(a, b); }
+      static V vmax(V a, V b) { return _mm_max_epi16(a, b); }
+      static V select(V mask, V a, V b) { return _mm_blendv_epi8(b, a, mask); }
+      static V and_(V a, V b) { return _mm_and_si128(a, b); }
+      static V or_(V a, V b) { return _mm_or_si128(a, b); }
+      static V andnot(V a, V b) { return _mm_andnot_si128(a, b); }
+      static bool allSet(V v) { return _mm_movemask_epi8(v) == 0xffff; }
+   };
+
+   struct F32Ops
+   {
+      typedef ossim_float32 T;
+      typedef __m128 V;
+      enum { N = 4 };
+      static T lowest()  { return -highest(); }
+      static T highest() { return _mm_cvtss_f32(_mm_castsi128_ps(_mm_set1_epi32(0x7f800000))); }
+      static V load(const T* p) { return _mm_loadu_ps(p); }
+      static void store(T* p, V v) { _mm_storeu_ps(p, v); }
+      static V set1(T v) { return _mm_set1_ps(v); }
+      static V ones() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+      static V invalid(V p, V ex) { return _mm_or_ps(_mm_cmpeq_ps(p, ex), _mm_cmpunord_ps(p, p)); }
+      static V gt(V a, V b) { return _mm_cmpgt_ps(a, b); }
+      static V vmin(V a, V b) { return _mm_min_ps(a, b); }
+      static V vmax(V a, V b) { return _mm_max_ps(a, b); }
+      static V select(V mask, V a, V b) { return _mm_blendv_ps(b, a, mask); }
+      static V and_(V a, V b) { return _mm_and_ps(a, b); }
+      static V or_(V a, V b) { return _mm_or_ps(a, b); }
+      static V andnot(V a, V b) { return _mm_andnot_ps(a, b); }
+      static bool allSet(V v) { return _mm_movemask_ps(v) == 0xf; }
+   };
+
+   template <class Ops>
+   bool minMax(const typename Ops::T* buf, ossim_uint32 count, typename Ops::T exclude,
+               typename Ops::T* minVal, typename Ops::T* maxVal)
+   {
+      typedef typename Ops::T T;
+      typedef typename Ops::V V;
+
+      bool found = false;
+      T currentMin = 0;
+      T currentMax = 0;
+      ossim_uint32 i = 0;
+      if (count >= (ossim_uint32)Ops::N)
+      {
+         const V EX = Ops::set1(exclude);
+         const V HI = Ops::set1(Ops::highest());
+         const V LO = Ops::set1(Ops::lowest());
+         V vmin = HI;
+         V vmax = LO;
+         V allInvalid = Ops::ones();
+         for (; i + Ops::N <= count; i += Ops::N)
+         {
+            const V p = Ops::load(buf + i);
+            const V bad = Ops::invalid(p, EX);
+            allInvalid = Ops::and_(allInvalid, bad);
+            vmin = Ops::vmin(vmin, Ops::select(bad, HI, p));
+            vmax = Ops::vmax(vmax, Ops::select(bad, LO, p));
+         }
+         if (!Ops::allSet(allInvalid))
+         {
+            T lanesMin[Ops::N];
+            T lanesMax[Ops::N];
+            Ops::store(lanesMin, vmin);
+            Ops::store(lanesMax, vmax);
+            currentMin = lanesMin[0];
+            currentMax = lanesMax[0];
+            for (int lane = 1; lane < Ops::N; ++lane)
+            {
+               if (lanesMin[lane] < currentMin) currentMin = lanesMin[lane];
+               if (lanesMax[lane] > currentMax) currentMax = lanesMax[lane];
+            }
+            found = true;
+         }
+      }
+      for (; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p == p) )
+         {
+            if (!found)
+            {
+               currentMin = p;
+               currentMax = p;
+               found = true;
+            }
+            if (p < currentMin) currentMin = p;
+            if (p > currentMax) currentMax = p;
+         }
+      }
+      if (found)
+      {
+         *minVal = currentMin;
+         *maxVal = currentMax;
+      }
+      return found;
+   }
+
+   template <class Ops>
+   bool minAbove(const typename Ops::T* buf, ossim_uint32 count, typename Ops::T exclude,
+                 typename Ops::T threshold, typename Ops::T* minVal)
+   {
+      typedef typename Ops::T T;
+      typedef typename Ops::V V;
+
+      bool found = false;
+      T currentMin = 0;
+      ossim_uint32 i = 0;
+      if (count >= (ossim_uint32)Ops::N)
+      {
+         const V EX  = Ops::set1(exclude);
+         const V THR = Ops::set1(threshold);
+         const V HI  = Ops::set1(Ops::highest());
+         V vmin = HI;
+         V allInvalid = Ops::ones();
+         for (; i + Ops::N <= count; i += Ops::N)
+         {
+            const V p = Ops::load(buf + i);
+            const V bad = Ops::or_(Ops::invalid(p, EX), Ops::andnot(Ops::gt(p, THR), Ops::ones()));
+            allInvalid = Ops::and_(allInvalid, bad);
+            vmin = Ops::vmin(vmin, Ops::select(bad, HI, p));
+         }
+         if (!Ops::allSet(allInvalid))
+         {
+            T lanes[Ops::N];
+            Ops::store(lanes, vmin);
+            currentMin = lanes[0];
+            for (int lane = 1; lane < Ops::N; ++lane)
+            {
+               if (lanes[lane] < currentMin) currentMin = lanes[lane];
+            }
+            found = true;
+         }
+      }
+      for (; i < count; ++i)
+      {
+         const T p = buf[i];
+         if ( (p != exclude) && (p > threshold) && (!found || (p < currentMin)) )
+         {
+            currentMin = p;
+            found = true;
+         }
+      }
+      if (found)
+      {
+         *minVal = currentMin;
+      }
+      return found;
+   }
+
+   //---
+   // Normalize:  Four pixels per step, widened to two double pairs so the math
+   // matches the scalar templates bit for bit.
+   //---
+   inline void widen(const ossim_uint8* p, __m128d& lo, __m128d& hi)
+   {
+      const __m128i v = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(*(const int*)p));
+      lo = _mm_cvtepi32_pd(v);
+      hi = _mm_cvtepi32_pd(_mm_srli_si128(v, 8));
+   }
+
+   inline void widen(const ossim_uint16* p, __m128d& lo, __m128d& hi)
+   {
+      const __m128i v = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i*)p));
+      lo = _mm_cvtepi32_pd(v);
+      hi = _mm_cvtepi32_pd(_mm_srli_si128(v, 8));
+   }
+
+   inline void widen(const ossim_sint16* p, __m128d& lo, __m128d& hi)
+   {
+      const __m128i v = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)p));
+      lo = _mm_cvtepi32_pd(v);
+      hi = _mm_cvtepi32_pd(_mm_srli_si128(v, 8));
+   }
+
+   inline void widen(const ossim_float32* p, __m128d& lo, __m128d& hi)
+   {
+      const __m128 v = _mm_loadu_ps(p);
+      lo = _mm_cvtps_pd(v);
+      hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+   }
+
+   template <class T>
+   void normalize(const T* src, ossim_uint32 count, ossim_float64 minPix,
+                  ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      const __m128d MIN   = _mm_set1_pd(minPix);
+      const __m128d RNG   = _mm_set1_pd(RANGE);
+      const __m128d NUL   = _mm_set1_pd(nullPix);
+      const __m128d NORM  = _mm_set1_pd(OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT);
+      const __m128d ZERO  = _mm_setzero_pd();
+
+      ossim_uint32 i = 0;
+      for (; i + 4 <= count; i += 4)
+      {
+         __m128d p[2];
+         widen(src + i, p[0], p[1]);
+         __m128 r[2];
+         for (int k = 0; k < 2; ++k)
+         {
+            __m128d v = _mm_div_pd(_mm_sub_pd(p[k], MIN), RNG);
+            v = _mm_blendv_pd(v, NORM, _mm_cmpeq_pd(p[k], MIN));
+            v = _mm_blendv_pd(v, ZERO, _mm_cmpeq_pd(p[k], NUL));
+            r[k] = _mm_cvtpd_ps(v);
+         }
+         _mm_storeu_ps(dst + i, _mm_movelh_ps(r[0], r[1]));
+      }
+      for (; i < count; ++i)
+      {
+         const ossim_float64 p = src[i];
+         if (p == nullPix)
+            dst[i] = 0.0;
+         else if (p == minPix)
+            dst[i] = OSSIM_DEFAULT_MIN_PIX_NORM_FLOAT;
+         else
+            dst[i] = (ossim_float32)((p - minPix) / RANGE);
+      }
+   }
+
+   void normalizeU8(const ossim_uint8* src, ossim_uint32 count, ossim_float64 minPix,
+                    ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void normalizeU16(const ossim_uint16* src, ossim_uint32 count, ossim_float64 minPix,
+                     ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void normalizeS16(const ossim_sint16* src, ossim_uint32 count, ossim_float64 minPix,
+                     ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void normalizeF32(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                     ossim_float64 maxPix, ossim_float64 nullPix, ossim_float32* dst)
+   {
+      normalize(src, count, minPix, maxPix, nullPix, dst);
+   }
+
+   //---
+   // Unnormalize:  Four floats per step to double, scale, clamp to max and truncate.
+   // The caller packs the int32 lanes (with saturation) to the tile type.
+   //---
+   struct Unnormalizer
+   {
+      Unnormalizer(ossim_float64 minPix, ossim_float64 maxPix)
+         : MIN(_mm_set1_pd(minPix)),
+           MAX(_mm_set1_pd(maxPix)),
+           RNG(_mm_set1_pd(maxPix - minPix))
+      {
+      }
+
+      /** @return Scaled and clamped values; isZero set for null input lanes. */
+      void scale(const ossim_float32* s, __m128d& lo, __m128d& hi, __m128& isZero) const
+      {
+         const __m128 f = _mm_loadu_ps(s);
+         isZero = _mm_cmpeq_ps(f, _mm_setzero_ps());
+         lo = _mm_cvtps_pd(f);
+         hi = _mm_cvtps_pd(_mm_movehl_ps(f, f));
+         // min(MAX, t) keeps a NaN t like the scalar "if (t > max)" does:
+         lo = _mm_min_pd(MAX, _mm_add_pd(MIN, _mm_mul_pd(RNG, lo)));
+         hi = _mm_min_pd(MAX, _mm_add_pd(MIN, _mm_mul_pd(RNG, hi)));
+      }
+
+      __m128i toInt(const ossim_float32* s, __m128i nullPix) const
+      {
+         __m128d lo, hi;
+         __m128 isZero;
+         scale(s, lo, hi, isZero);
+         const __m128i v = _mm_unpacklo_epi64(_mm_cvttpd_epi32(lo), _mm_cvttpd_epi32(hi));
+         return _mm_blendv_epi8(v, nullPix, _mm_castps_si128(isZero));
+      }
+
+      const __m128d MIN;
+      const __m128d MAX;
+      const __m128d RNG;
+   };
+
+   template <class T>
+   void unnormalizeTail(const ossim_float32* src, ossim_uint32 start, ossim_uint32 count,
+                        ossim_float64 minPix, ossim_float64 maxPix, T nullPix, T* dst)
+   {
+      const ossim_float64 RANGE = maxPix - minPix;
+      for (ossim_uint32 i = start; i < count; ++i)
+      {
+         const ossim_float64 p = src[i];
+         if (p != 0.0)
+         {
+            ossim_float64 test = minPix + RANGE * p;
+            if (test > maxPix) test = maxPix;
+            dst[i] = (T)test;
+         }
+         else
+         {
+            dst[i] = nullPix;
+         }
+      }
+   }
+
+   void unnormalizeU8(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                      ossim_float64 maxPix, ossim_uint8 nullPix, ossim_uint8* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m128i NUL = _mm_set1_epi32(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 16 <= count; i += 16)
+      {
+         const __m128i a = _mm_packus_epi32(U.toInt(src + i, NUL), U.toInt(src + i + 4, NUL));
+         const __m128i b = _mm_packus_epi32(U.toInt(src + i + 8, NUL), U.toInt(src + i + 12, NUL));
+         _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(a, b));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void unnormalizeU16(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                       ossim_float64 maxPix, ossim_uint16 nullPix, ossim_uint16* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m128i NUL = _mm_set1_epi32(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         _mm_storeu_si128((__m128i*)(dst + i),
+                          _mm_packus_epi32(U.toInt(src + i, NUL), U.toInt(src + i + 4, NUL)));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void unnormalizeS16(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                       ossim_float64 maxPix, ossim_sint16 nullPix, ossim_sint16* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m128i NUL = _mm_set1_epi32(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         _mm_storeu_si128((__m128i*)(dst + i),
+                          _mm_packs_epi32(U.toInt(src + i, NUL), U.toInt(src + i + 4, NUL)));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   void unnormalizeF32(const ossim_float32* src, ossim_uint32 count, ossim_float64 minPix,
+                       ossim_float64 maxPix, ossim_float32 nullPix, ossim_float32* dst)
+   {
+      const Unnormalizer U(minPix, maxPix);
+      const __m128 NUL = _mm_set1_ps(nullPix);
+      ossim_uint32 i = 0;
+      for (; i + 4 <= count; i += 4)
+      {
+         __m128d lo, hi;
+         __m128 isZero;
+         U.scale(src + i, lo, hi, isZero);
+         const __m128 v = _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+         _mm_storeu_ps(dst + i, _mm_blendv_ps(v, NUL, isZero));
+      }
+      unnormalizeTail(src, i, count, minPix, maxPix, nullPix, dst);
+   }
+
+   //---
+   // Resampling sums.  The gather version is left to the scalar code; without a
+   // gather instruction two lane loads per tap are no faster.
+   //---
+   void weightedSumF64(const ossim_float64* const* rows, const ossim_float64* weights,
+                       ossim_uint32 taps, ossim_uint32 count, ossim_float64* dst)
+   {
+      ossim_uint32 i = 0;
+      for (; i + 4 <= count; i += 4)
+      {
+         __m128d sum0 = _mm_setzero_pd();
+         __m128d sum1 = _mm_setzero_pd();
+         for (ossim_uint32 k = 0; k < taps; ++k)
+         {
+            const __m128d W = _mm_set1_pd(weights[k]);
+            sum0 = _mm_add_pd(sum0, _mm_mul_pd(W, _mm_loadu_pd(rows[k] + i)));
+            sum1 = _mm_add_pd(sum1, _mm_mul_pd(W, _mm_loadu_pd(rows[k] + i + 2)));
+         }
+         _mm_storeu_pd(dst + i, sum0);
+         _mm_storeu_pd(dst + i + 2, sum1);
+      }
+      for (; i < count; ++i)
+      {
+         ossim_float64 sum = 0.0;
+         for (ossim_uint32 k = 0; k < taps; ++k)
+            sum += weights[k] * rows[k][i];
+         dst[i] = sum;
+      }
+   }
+
+   const ossim::ImageDataKernels SSE42_KERNELS =
+   {
+      deinterleave8,
+      deinterleave16,
+      deinterleave32,
+
+      minMax<U8Ops>,
+      minMax<U16Ops>,
+      minMax<S16Ops>,
+      minMax<F32Ops>,
+
+      minAbove<U8Ops>,
+      minAbove<U16Ops>,
+      minAbove<S16Ops>,
+      minAbove<F32Ops>,
+
+      normalizeU8,
+      normalizeU16,
+      normalizeS16,
+      normalizeF32,
+
+      unnormalizeU8,
+      unnormalizeU16,
+      unnormalizeS16,
+      unnormalizeF32,
+
+      weightedSumF64,
+      0  // gatherWeightedSumF64: scalar version
+   };
+}
+
+namespace ossim
+{
+   const ImageDataKernels* getSse42ImageDataKernels()
+   {
+      return &SSE42_KERNELS;
+   }
+}
+
+#else /* No SSE4.2 code generation for this target. */
+
+namespace ossim
+{
+   const ImageDataKernels* getSse42ImageDataKernels()
+   {
+      return 0;
+   }
+}
+
+#endif
@@ -0,0 +1,296 @@
+//---
+//
+// License: MIT
+//
+// Description: Pool of recyclable ossimImageData tiles.
+//
+//---
+// $Id$
+
+#include <ossim/imaging/ossimImageDataPool.h>
+#include <functional>
+#include <ostream>
+#include <thread>
+
+bool ossimImageDataPool::Key::operator<(const Key& rhs) const
+{
+   if (m_scalar != rhs.m_scalar) return (m_scalar < rhs.m_scalar);
+   if (m_bands  != rhs.m_bands)  return (m_bands  < rhs.m_bands);
+   if (m_width  != rhs.m_width)  return (m_width  < rhs.m_width);
+   return (m_height < rhs.m_height);
+}
+
+ossimImageDataPool::ossimImageDataPool(ossim_uint64 maxBytes)
+   :
+   m_maxBytes(maxBytes),
+   m_bytes(0),
+   m_tileCount(0),
+   m_requests(0),
+   m_hits(0),
+   m_allocations(0),
+   m_evictions(0),
+   m_overflows(0)
+{
+}
+
+ossimImageDataPool::~ossimImageDataPool()
+{
+   // Tiles still in use outlive the pool; the ossimRefPtr entries just drop a reference.
+}
+
+ossimRefPtr<ossimImageData> ossimImageDataPool::checkout(ossimSource* owner,
+                                                         ossimScalarType scalar,
+                                                         ossim_uint32 bands,
+                                                         ossim_uint32 width,
+                                                         ossim_uint32 height)
+{
+   ossimRefPtr<ossimImageData> result = 0;
+   if ( m_maxBytes.load(std::memory_order_relaxed) == 0 )
+   {
+      return result;
+   }
+
+   ++m_requests;
+   const Key KEY(scalar, bands, width, height);
+
+   Shard& home = getShard();
+   {
+      std::lock_guard<std::mutex> lock(home.m_mutex);
+      result = takeIdleTile(home, KEY);
+   }
+
+   if ( !result.valid() )
+   {
+      // Tiles released by other threads sit in their shards; look without waiting.
+      for (ossim_uint32 i = 0; (i < NUMBER_OF_SHARDS) && !result.valid(); ++i)
+      {
+         Shard& shard = m_shards[i];
+         if ( (&shard != &home) && shard.m_mutex.try_lock() )
+         {
+            result = takeIdleTile(shard, KEY);
+            shard.m_mutex.unlock();
+         }
+      }
+   }
+
+   if ( result.valid() )
+   {
+      ++m_hits;
+      result->recycle(owner);
+   }
+   return result;
+}
+
+bool ossimImageDataPool::add(ossimImageData* tile)
+{
+   const ossim_uint64 MAX_BYTES = m_maxBytes.load(std::memory_order_relaxed);
+   if ( !tile || (MAX_BYTES == 0) )
+   {
+      return false;
+   }
+
+   const ossim_uint64 BYTES = tile->getDataSizeInBytes();
+   const Key KEY(tile->getScalarType(), tile->getNumberOfBands(),
+                 tile->getWidth(), tile->getHeight());
+
+   Shard& shard = getShard();
+   std::lock_guard<std::mutex> lock(shard.m_mutex);
+
+   if ( m_bytes.load() + BYTES > MAX_BYTES )
+   {
+      evictIdleTiles(shard, BYTES);
+      if ( m_bytes.load() + BYTES > MAX_BYTES )
+      {
+         ++m_overflows;
+         return false;
+      }
+   }
+
+   Entry entry;
+   entry.m_tile  = tile;
+   entry.m_bytes = BYTES;
+   shard.m_tiles[KEY].push_back(entry);
+
+   m_bytes += BYTES;
+   ++m_tileCount;
+   ++m_allocations;
+   return true;
+}
+
+void ossimImageDataPool::clear()
+{
+   for (ossim_uint32 i = 0; i < NUMBER_OF_SHARDS; ++i)
+   {
+      Shard& shard = m_shards[i];
+      std::lock_guard<std::mutex> lock(shard.m_mutex);
+      TileMap::iterator mapIter = shard.m_tiles.begin();
+      while ( mapIter != shard.m_tiles.end() )
+      {
+         std::vector<Entry>& list = mapIter->second;
+         for (std::vector<Entry>::size_type idx = list.size(); idx > 0; --idx)
+         {
+            if ( list[idx-1].m_tile->referenceCount() == 1 )
+            {
+               removeEntry(list, idx-1);
+            }
+         }
+         if ( list.empty() )
+         {
+            shard.m_tiles.erase(mapIter++);
+         }
+         else
+         {
+            ++mapIter;
+         }
+      }
+   }
+}
+
+void ossimImageDataPool::setMaxBytes(ossim_uint64 maxBytes)
+{
+   const ossim_uint64 OLD_MAX = m_maxBytes.exchange(maxBytes);
+   if ( maxBytes == 0 )
+   {
+      clear();
+   }
+   else if ( maxBytes < OLD_MAX )
+   {
+      for (ossim_uint32 i = 0; i < NUMBER_OF_SHARDS; ++i)
+      {
+         std::lock_guard<std::mutex> lock(m_shards[i].m_mutex);
+         evictIdleTiles(m_shards[i], 0);
+      }
+   }
+}
+
+ossim_uint64 ossimImageDataPool::getMaxBytes() const
+{
+   return m_maxBytes.load();
+}
+
+ossimImageDataPool::Statistics ossimImageDataPool::getStatistics() const
+{
+   Statistics stats;
+   stats.m_requests    = m_requests.load();
+   stats.m_hits        = m_hits.load();
+   stats.m_allocations = m_allocations.load();
+   stats.m_evictions   = m_evictions.load();
+   stats.m_overflows   = m_overflows.load();
+   stats.m_tiles       = m_tileCount.load();
+   stats.m_bytes       = m_bytes.load();
+   return stats;
+}
+
+void ossimImageDataPool::resetStatistics()
+{
+   m_requests    = 0;
+   m_hits        = 0;
+   m_allocations = 0;
+   m_evictions   = 0;
+   m_overflows   = 0;
+}
+
+std::ostream& ossimImageDataPool::print(std::ostream& out) const
+{
+   Statistics stats = getStatistics();
+   out << "ossimImageDataPool:"
+       << "\nmax_bytes:   " << getMaxBytes()
+       << "\nbytes:       " << stats.m_bytes
+       << "\ntiles:       " << stats.m_tiles
+       << "\nrequests:    " << stats.m_requests
+       << "\nhits:        " << stats.m_hits
+       << "\nallocations: " << stats.m_allocations
+       << "\nevictions:   " << stats.m_evictions
+       << "\noverflows:   " << stats.m_overflows
+       << std::endl;
+   return out;
+}
+
+ossimImageDataPool::Shard& ossimImageDataPool::getShard()
+{
+   std::hash<std::thread::id> hasher;
+   return m_shards[hasher(std::this_thread::get_id()) % NUMBER_OF_SHARDS];
+}
+
+ossimRefPtr<ossimImageData> ossimImageDataPool::takeIdleTile(Shard& shard, const Key& key)
+{
+   ossimRefPtr<ossimImageData> result = 0;
+
+   TileMap::iterator mapIter = shard.m_tiles.find(key);
+   if ( mapIter != shard.m_tiles.end() )
+   {
+      std::vector<Entry>& list = mapIter->second;
+      std::vector<Entry>::size_type idx = 0;
+      while ( idx < list.size() )
+      {
+         ossimImageData* tile = list[idx].m_tile.get();
+
+         // Only the pool references the tile, so no other thread can get to it:
+         if ( tile->referenceCount() == 1 )
+         {
+            if ( (tile->getScalarType() == key.m_scalar) &&
+                 (tile->getNumberOfBands() == key.m_bands) &&
+                 (tile->getWidth() == key.m_width) &&
+                 (tile->getHeight() == key.m_height) )
+            {
+               result = tile;
+               break;
+            }
+
+            // Reshaped by its last user; drop it rather than hand out the wrong size.
+            removeEntry(list, idx);
+            ++m_evictions;
+            continue;
+         }
+         ++idx;
+      }
+
+      if ( list.empty() )
+      {
+         shard.m_tiles.erase(mapIter);
+      }
+   }
+
+   return result;
+}
+
+void ossimImageDataPool::evictIdleTiles(Shard& shard, ossim_uint64 bytes)
+{
+   const ossim_uint64 MAX_BYTES = m_maxBytes.load();
+   TileMap::iterator mapIter = shard.m_tiles.begin();
+   while ( (mapIter != shard.m_tiles.end()) && (m_bytes.load() + bytes > MAX_BYTES) )
+   {
+      std::vector<Entry>& list = mapIter->second;
+      for (std::vector<Entry>::size_type idx = list.size();
+           (idx > 0) && (m_bytes.load() + bytes > MAX_BYTES); --idx)
+      {
+         if ( list[idx-1].m_tile->referenceCount() == 1 )
+         {
+            removeEntry(list, idx-1);
+            ++m_evictions;
+         }
+      }
+      if ( list.empty() )
+      {
+         shard.m_tiles.erase(mapIter++);
+      }
+      else
+      {
+         ++mapIter;
+      }
+   }
+}
+
+void ossimImageDataPool::removeEntry(std::vector<Entry>& list,
+                                     std::vector<Entry>::size_type index)
+{
+   m_bytes -= list[index].m_bytes;
+   --m_tileCount;
+
+   // Order does not matter; swap with the last entry so the erase is O(1).
+   if ( index + 1 < list.size() )
+   {
+      std::swap(list[index], list.back());
+   }
+   list.pop_back();
+}
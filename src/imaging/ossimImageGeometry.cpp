@@ -310,6 +310,82 @@ bool ossimImageGeometry::worldToLocal(const ossimGrect& world_rect, ossimDrect&
    return false;
 }
 
+//**************************************************************************************************
+//! Batch form of localToWorld(const ossimDpt&, ossimGpt&).
+//**************************************************************************************************
+bool ossimImageGeometry::localToWorldPoints(const ossimDpt* local_pts,
+                                            ossim_uint32 count,
+                                            ossimGpt* world_pts) const
+{
+   if (!m_projection.valid())
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+         world_pts[i].makeNan();
+      return false;
+   }
+
+   std::vector<ossimDpt> full_image_pts(count);
+   for (ossim_uint32 i = 0; i < count; ++i)
+      rnToFull(local_pts[i], m_targetRrds, full_image_pts[i]);
+
+   if (count)
+      m_projection->lineSampleToWorldPoints(&full_image_pts.front(), count, world_pts);
+
+   return true;
+}
+
+//**************************************************************************************************
+//! Batch form of worldToLocal(const ossimGpt&, ossimDpt&).
+//**************************************************************************************************
+bool ossimImageGeometry::worldToLocalPoints(const ossimGpt* world_pts,
+                                            ossim_uint32 count,
+                                            ossimDpt* local_pts) const
+{
+   if (!m_projection.valid())
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+         local_pts[i].makeNan();
+      return false;
+   }
+   if (!count)
+      return true;
+
+   std::vector<ossimDpt> full_image_pts(count);
+   if ( isAffectedByElevation() )
+   {
+      // Same heights worldToLocal() would look up one point at a time:
+      std::vector<ossimGpt> copyPts(world_pts, world_pts + count);
+      std::vector<ossimGpt> nullHgtPts;
+      std::vector<ossim_uint32> nullHgtIdx;
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (copyPts[i].isHgtNan())
+         {
+            nullHgtPts.push_back(copyPts[i]);
+            nullHgtIdx.push_back(i);
+         }
+      }
+      if (!nullHgtPts.empty())
+      {
+         std::vector<double> heights(nullHgtPts.size());
+         ossimElevManager::instance()->getHeightsAboveEllipsoid(
+            &nullHgtPts.front(), (ossim_uint32)nullHgtPts.size(), &heights.front());
+         for (ossim_uint32 i = 0; i < nullHgtIdx.size(); ++i)
+            copyPts[nullHgtIdx[i]].hgt = heights[i];
+      }
+      m_projection->worldToLineSamplePoints(&copyPts.front(), count, &full_image_pts.front());
+   }
+   else
+   {
+      m_projection->worldToLineSamplePoints(world_pts, count, &full_image_pts.front());
+   }
+
+   for (ossim_uint32 i = 0; i < count; ++i)
+      fullToRn(full_image_pts[i], m_targetRrds, local_pts[i]);
+
+   return true;
+}
+
 //**************************************************************************************************
 //! Sets the transform to be used for local-to-full-image coordinate transformation
 //**************************************************************************************************
@@ -1229,6 +1229,21 @@ bool ossimImageHandler::isValidRLevel(ossim_uint32 resLevel) const
    return result;
 }
 
+void ossimImageHandler::setTileRequestOrder(const ossimIrect& area,
+                                            const ossimIpt& tileSize,
+                                            ossim_uint32 resLevel)
+{
+   if ( theOverview.valid() && theOverview->isValidRLevel(resLevel) )
+   {
+      theOverview->setTileRequestOrder(area, tileSize, resLevel);
+   }
+}
+
+bool ossimImageHandler::supportsConcurrentReads() const
+{
+   return false;
+}
+
 void ossimImageHandler::getValidImageVertices(vector<ossimIpt>& validVertices,
                                               ossimVertexOrdering ordering,
                                               ossim_uint32 resLevel) const
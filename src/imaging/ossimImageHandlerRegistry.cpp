@@ -151,7 +151,20 @@ void ossimImageHandlerRegistry::getSupportedExtensions(
 std::shared_ptr<ossim::ImageHandlerState> ossimImageHandlerRegistry::getState(const ossimString& connectionString, 
                                                                               ossim_uint32 entry)const
 {
-   return getState(connectionString + "_e" + ossimString::toString(entry));
+   ossimString id = connectionString + "_e" + ossimString::toString(entry);
+   std::shared_ptr<ossim::ImageHandlerState> result = getState(id);
+
+   // Fall back to the states other processes left on disk.
+   if(!result && m_stateStore)
+   {
+      result = m_stateStore->getState(connectionString, entry);
+      if(result && m_stateCache)
+      {
+         m_stateCache->addItem(id, result);
+      }
+   }
+
+   return result;
 }
 
 std::shared_ptr<ossim::ImageHandlerState> ossimImageHandlerRegistry::getState(const ossimString& id)const
@@ -546,6 +559,12 @@ ossimImageHandlerRegistry::ossimImageHandlerRegistry(const ossimImageHandlerRegi
 void ossimImageHandlerRegistry::initializeStateCache()const
 {
    m_stateCache = 0;
+   m_stateStore = 0;
+   ossimString storeString = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_store.directory");
+   if(!storeString.empty())
+   {
+      m_stateStore = std::make_shared<ossim::ImageHandlerStateStore>(ossimFilename(storeString));
+   }
    ossimString enabledString = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_cache.enabled");
    ossimString minSizeString = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_cache.min_size");
    ossimString maxSizeString = ossimPreferences::instance()->findPreference("ossim.imaging.handler.registry.state_cache.max_size");
@@ -594,6 +613,10 @@ void ossimImageHandlerRegistry::addToStateCache(ossimImageHandler* handler)const
          }
          m_stateCache->addItem(id, state);
       }
+      if(state&&m_stateStore)
+      {
+         m_stateStore->addState(handler->getFilename(), state);
+      }
    }
 }
 
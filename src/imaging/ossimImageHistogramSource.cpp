@@ -11,12 +11,99 @@
 #include <ossim/base/ossimMultiResLevelHistogram.h>
 #include <ossim/base/ossimMultiBandHistogram.h>
 #include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/imaging/ossimImageSourceSequencer.h>
 #include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimTrace.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
+#include <atomic>
+#include <mutex>
 
 static ossimTrace traceDebug("ossimImageHistogramSource:debug");
 
+static const char NUMBER_OF_THREADS_KW[] = "number_of_threads";
+
+/** Tiles of one res level shared by the jobs of populateConcurrent. */
+struct ossimHistogramTiles
+{
+   ossimImageSource*                m_input;
+   ossimImageHandler*               m_concurrentHandler; // Set if read with no lock.
+   const ossimImageSourceSequencer* m_sequencer;
+   ossim_uint32                     m_resLevel;
+   ossim_int64                      m_numberOfTiles;
+   std::atomic<ossim_int64>         m_nextTile;
+   std::atomic<ossim_int64>         m_tilesDone;
+   std::mutex                       m_readMutex;
+};
+
+/**
+ * Reads the next tile not taken by another job until all are taken, and
+ * counts each in a histogram of its own.
+ */
+class ossimHistogramPopulateJob : public ossimJob
+{
+public:
+   ossimHistogramPopulateJob(ossimImageHistogramSource* source,
+                             ossimHistogramTiles* tiles,
+                             ossimMultiBandHistogram* histo)
+      :
+      ossimJob(),
+      m_source(source),
+      m_tiles(tiles),
+      m_histo(histo)
+   {
+   }
+
+protected:
+   virtual void run()
+   {
+      ossimRefPtr<ossimImageData> tile =
+         ossimImageDataFactory::instance()->create(0, m_tiles->m_input);
+      if ( !tile.valid() )
+      {
+         return;
+      }
+      tile->initialize();
+
+      ossimIrect rect;
+      ossim_int64 id = 0;
+      while ( ( (id = m_tiles->m_nextTile++) < m_tiles->m_numberOfTiles ) &&
+              !m_source->needsAborting() )
+      {
+         if ( m_tiles->m_sequencer->getTileRect(id, rect) )
+         {
+            tile->setImageRectangle(rect);
+
+            bool status = false;
+            if ( m_tiles->m_concurrentHandler )
+            {
+               status = m_tiles->m_concurrentHandler->getTile(tile.get(), m_tiles->m_resLevel);
+            }
+            else
+            {
+               std::lock_guard<std::mutex> lock(m_tiles->m_readMutex);
+               status = m_tiles->m_input->getTile(tile.get(), m_tiles->m_resLevel);
+            }
+
+            if ( status && tile->getBuf() && (tile->getDataObjectStatus() != OSSIM_EMPTY) )
+            {
+               tile->populateHistogram(m_histo);
+            }
+         }
+         ++m_tiles->m_tilesDone;
+      }
+   }
+
+private:
+   ossimImageHistogramSource* m_source;
+   ossimHistogramTiles*       m_tiles;
+   ossimMultiBandHistogram*   m_histo;
+};
+
   RTTI_DEF3(ossimImageHistogramSource, "ossimImageHistogramSource", ossimHistogramSource, ossimConnectableObjectListener, ossimProcessInterface);
 
 ossimImageHistogramSource::ossimImageHistogramSource(ossimObject* owner)
@@ -27,7 +114,8 @@ ossimImageHistogramSource::ossimImageHistogramSource(ossimObject* owner)
                          false),// output can still grow though
     theHistogramRecomputeFlag(true),
     theMaxNumberOfResLevels(1),
-    theComputationMode(OSSIM_HISTO_MODE_NORMAL)
+    theComputationMode(OSSIM_HISTO_MODE_NORMAL),
+    theNumberOfThreads(1)
     // theNumberOfTilesToUseInFastMode(100)
 {
    theAreaOfInterest.makeNan();
@@ -36,6 +124,13 @@ ossimImageHistogramSource::ossimImageHistogramSource(ossimObject* owner)
    theMinValueOverride     = ossim::nan();
    theMaxValueOverride     = ossim::nan();
    theNumberOfBinsOverride = -1;
+
+   const char* lookup =
+      ossimPreferences::instance()->findPreference("ossim.imaging.histogram.threads");
+   if ( lookup )
+   {
+      setNumberOfThreads( ossimString(lookup).toUInt32() );
+   }
 }
 
 ossimImageHistogramSource::~ossimImageHistogramSource()
@@ -177,6 +272,16 @@ void ossimImageHistogramSource::setComputationMode(ossimHistogramMode mode)
    theComputationMode = mode;
 }
 
+void ossimImageHistogramSource::setNumberOfThreads(ossim_uint32 threads)
+{
+   theNumberOfThreads = ossim::max<ossim_uint32>(threads, 1);
+}
+
+ossim_uint32 ossimImageHistogramSource::getNumberOfThreads()const
+{
+   return theNumberOfThreads;
+}
+
 void ossimImageHistogramSource::propertyEvent(ossimPropertyEvent& /* event */)
 {
    theHistogramRecomputeFlag = true;
@@ -398,6 +503,27 @@ void ossimImageHistogramSource::computeNormalModeHistogram()
                                                                minValue,
                                                                maxValue);
             
+            if ( theNumberOfThreads > 1 )
+            {
+               const double START = tileCount;
+               if ( populateConcurrent(sequencer.get(),
+                                       index,
+                                       theHistogram->getMultiBandHistogram(index).get(),
+                                       tileCount,
+                                       totalTiles) )
+               {
+                  continue;
+               }
+
+               // Count this res level again in this thread.
+               tileCount = START;
+               theHistogram->getMultiBandHistogram(index)->create(numberOfBands,
+                                                                  numberOfBins,
+                                                                  minValue,
+                                                                  maxValue);
+               sequencer->setToStartOfSequence();
+            }
+
             ossimRefPtr<ossimImageData> data = sequencer->getNextTile(index);
             ++tileCount;
             setPercentComplete((100.0*(tileCount/totalTiles)));
@@ -431,6 +557,78 @@ void ossimImageHistogramSource::computeNormalModeHistogram()
    }
 }
 
+bool ossimImageHistogramSource::populateConcurrent(const ossimImageSourceSequencer* sequencer,
+                                                   ossim_uint32 resLevel,
+                                                   ossimMultiBandHistogram* histo,
+                                                   double& tileCount,
+                                                   double totalTiles)
+{
+   ossimImageSource* input = PTR_CAST(ossimImageSource, getInput(0));
+   if ( !input || !histo || !histo->getHistogram(0).valid() )
+   {
+      return true;
+   }
+
+   ossimHistogramTiles tiles;
+   tiles.m_input             = input;
+   tiles.m_concurrentHandler = dynamic_cast<ossimImageHandler*>(input);
+   if ( tiles.m_concurrentHandler && !tiles.m_concurrentHandler->supportsConcurrentReads() )
+   {
+      tiles.m_concurrentHandler = 0;
+   }
+   tiles.m_sequencer     = sequencer;
+   tiles.m_resLevel      = resLevel;
+   tiles.m_numberOfTiles = sequencer->getNumberOfTiles();
+   tiles.m_nextTile      = 0;
+   tiles.m_tilesDone     = 0;
+
+   const ossim_uint32 THREADS =
+      (ossim_uint32)ossim::min<ossim_int64>(theNumberOfThreads, tiles.m_numberOfTiles);
+   if ( THREADS == 0 )
+   {
+      return true;
+   }
+
+   //---
+   // One histogram per thread, so counting needs no lock.  All bands of histo
+   // have the bins of band 0, see computeNormalModeHistogram.
+   //---
+   const ossimRefPtr<ossimHistogram> BINS = histo->getHistogram(0);
+   std::vector< ossimRefPtr<ossimMultiBandHistogram> > histos(THREADS);
+   std::shared_ptr<ossimJobMultiThreadQueue> queue =
+      std::make_shared<ossimJobMultiThreadQueue>(std::make_shared<ossimJobQueue>(), THREADS);
+   for (ossim_uint32 i = 0; i < THREADS; ++i)
+   {
+      histos[i] = new ossimMultiBandHistogram(histo->getNumberOfBands(),
+                                              BINS->GetRes(),
+                                              BINS->GetRangeMin(),
+                                              BINS->GetRangeMax());
+      queue->getJobQueue()->add(
+         std::make_shared<ossimHistogramPopulateJob>(this, &tiles, histos[i].get()));
+   }
+
+   const double START = tileCount;
+   while ( !queue->waitAll(250) )
+   {
+      setPercentComplete( 100.0 * ( (START + tiles.m_tilesDone) / totalTiles ) );
+   }
+   tileCount = START + tiles.m_numberOfTiles;
+   setPercentComplete( 100.0 * (tileCount / totalTiles) );
+
+   for (ossim_uint32 i = 0; i < THREADS; ++i)
+   {
+      if ( !histo->addCounts(*histos[i]) )
+      {
+         ossimNotify(ossimNotifyLevel_WARN)
+            << "ossimImageHistogramSource::populateConcurrent WARNING:"
+            << "\nThread histogram bins differ from those of res level " << resLevel
+            << ".  Counting it in one thread." << std::endl;
+         return false;
+      }
+   }
+   return true;
+}
+
 void ossimImageHistogramSource::computeFastModeHistogram()
 {
    // Compute at most 9 x 9 tiles of 16 x 16 tile size. 
@@ -633,6 +831,12 @@ bool ossimImageHistogramSource::loadState(const ossimKeywordlist& kwl,
    {
       setNumberOfInputs(1);
    }
+
+   ossimString threads = kwl.find(prefix, NUMBER_OF_THREADS_KW);
+   if(!threads.empty())
+   {
+      setNumberOfThreads(threads.toUInt32());
+   }
    
    // ossimString numberOfTiles = kwl.find(prefix, "number_of_tiles");
    // if(!numberOfTiles.empty())
@@ -654,6 +858,7 @@ bool ossimImageHistogramSource::saveState(ossimKeywordlist& kwl,
    {
       ossimString newPrefix = ossimString(prefix) + "area_of_interest.";
       theAreaOfInterest.saveState(kwl, newPrefix);
+      kwl.add(prefix, NUMBER_OF_THREADS_KW, theNumberOfThreads, true);
    }
    return result;
 }
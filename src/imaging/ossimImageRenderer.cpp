@@ -22,6 +22,7 @@
 #include <ossim/base/ossimViewController.h>
 #include <ossim/base/ossimStringProperty.h>
 #include <ossim/base/ossimNumericProperty.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/imaging/ossimImageData.h>
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
@@ -34,6 +35,11 @@
 #include <ossim/projection/ossimImageViewTransformFactory.h>
 #include <ossim/projection/ossimMapProjection.h>
 #include <ossim/projection/ossimEquDistCylProjection.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
+#include <algorithm>
+#include <deque>
 #include <iostream>
 #include <stack>
 // using namespace std;
@@ -44,6 +50,27 @@ static const char OSSIM_ID[] = "$Id: ossimImageRenderer.cpp 23663 2015-12-11 21:
 
 static ossimTrace traceDebug("ossimImageRenderer:debug");
 
+static const char WARP_GRID_KW[]         = "warp_grid";
+static const char WARP_GRID_SPACING_KW[] = "warp_grid_spacing";
+static const char WARP_GRID_ERROR_KW[]   = "warp_grid_error";
+static const char MAX_PENDING_INPUTS_KW[] = "max_pending_inputs";
+
+// Warp grid defaults: nodes every 16 view pixels, cells kept to a tenth of an image pixel.
+static const ossim_uint32  DEFAULT_WARP_GRID_SPACING = 16;
+static const ossim_float64 DEFAULT_WARP_GRID_ERROR   = 0.1;
+
+static bool getDefaultWarpGridEnabled()
+{
+   bool result = false;
+   const char* str = ossimPreferences::instance()->
+      findPreference("ossim.imaging.image_renderer.warp_grid");
+   if ( str )
+   {
+      result = ossimString(str).toBool();
+   }
+   return result;
+}
+
 RTTI_DEF2(ossimImageRenderer, "ossimImageRenderer", ossimImageSourceFilter, ossimViewInterface);
 
 
@@ -564,10 +591,14 @@ void ossimImageRenderer::ossimRendererSubRectInfo::transformViewToImage()
    ossim_float64 w = vrect.width() - 1; // subtract 1 to prevent core dump in full-earth view rect
    ossim_float64 h = vrect.height();
 
-   m_transform->viewToImage(m_Vul, m_Iul);
-   m_transform->viewToImage(m_Vur, m_Iur);
-   m_transform->viewToImage(m_Vlr, m_Ilr);
-   m_transform->viewToImage(m_Vll, m_Ill);
+   // The corners go through the transform as one batch so elevation is queried once:
+   ossimDpt vpts[4] = { m_Vul, m_Vur, m_Vlr, m_Vll };
+   ossimDpt ipts[4];
+   m_transform->viewToImagePoints(vpts, 4, ipts);
+   m_Iul = ipts[0];
+   m_Iur = ipts[1];
+   m_Ilr = ipts[2];
+   m_Ill = ipts[3];
 
 //  m_ulRoundTripError = m_transform->getRoundTripErrorView(m_Vul);
 //  m_urRoundTripError = m_transform->getRoundTripErrorView(m_Vur);
@@ -1051,7 +1082,17 @@ m_viewRect(),
 m_rectsDirty(true),
 m_MaxRecursionLevel(5),
 m_AutoUpdateInputTransform(true),
-m_MaxLevelsToCompute(999999) // something large so it will always compute
+m_MaxLevelsToCompute(999999), // something large so it will always compute
+m_warpGridEnabled(getDefaultWarpGridEnabled()),
+m_warpGridSpacing(DEFAULT_WARP_GRID_SPACING),
+m_warpGridError(DEFAULT_WARP_GRID_ERROR),
+m_warpGrid(0),
+m_numberOfThreads(1),
+m_maxPendingInputs(0),
+m_jobQueue(),
+m_resamplerPool(),
+m_resamplerPoolConfig(),
+m_resamplerPoolMutex()
 {
    ossimViewInterface::theObject = this;
    m_Resampler = new ossimFilterResampler();
@@ -1073,7 +1114,17 @@ ossimImageRenderer::ossimImageRenderer(ossimImageSource* inputSource,
      m_rectsDirty(true),
      m_MaxRecursionLevel(5),
      m_AutoUpdateInputTransform(true),
-     m_MaxLevelsToCompute(999999) // something large so it will always compute
+     m_MaxLevelsToCompute(999999), // something large so it will always compute
+     m_warpGridEnabled(getDefaultWarpGridEnabled()),
+     m_warpGridSpacing(DEFAULT_WARP_GRID_SPACING),
+     m_warpGridError(DEFAULT_WARP_GRID_ERROR),
+     m_warpGrid(0),
+     m_numberOfThreads(1),
+     m_maxPendingInputs(0),
+     m_jobQueue(),
+     m_resamplerPool(),
+     m_resamplerPoolConfig(),
+     m_resamplerPoolMutex()
 {
    ossimViewInterface::theObject = this;
    m_Resampler = new ossimFilterResampler();
@@ -1085,8 +1136,17 @@ ossimImageRenderer::ossimImageRenderer(ossimImageSource* inputSource,
 
 ossimImageRenderer::~ossimImageRenderer()
 {
+  m_warpGrid = 0;
   m_ImageViewTransform = 0;
 
+   // Joins the worker threads before their resamplers go.
+   m_jobQueue.reset();
+   for(std::vector<ossimFilterResampler*>::size_type i = 0; i < m_resamplerPool.size(); ++i)
+   {
+      delete m_resamplerPool[i];
+   }
+   m_resamplerPool.clear();
+
    if(m_Resampler)
    {
       delete m_Resampler;
@@ -1205,7 +1265,7 @@ ossimRefPtr<ossimImageData> ossimImageRenderer::getTile(
                                         viewRectClip.lr(),
                                         viewRectClip.ll());
 #else
-   ossimRendererSubRectInfo subRectInfo(m_ImageViewTransform.get(),
+   ossimRendererSubRectInfo subRectInfo(getRenderTransform(),
                                         tileRect.ul(),
                                         tileRect.ur(),
                                         tileRect.lr(),
@@ -1247,9 +1307,165 @@ ossimRefPtr<ossimImageData> ossimImageRenderer::getTile(
    return m_Tile;
 }
 
+/**
+ * Decimates (for levels the input does not have) and resamples the input
+ * for one sub rectangle into a tile of its own.  The renderer copies the
+ * tile into its output in fill order once the job is done.
+ */
+class ossimImageRenderer::ResampleJob : public ossimJob
+{
+public:
+   ResampleJob(ossimImageRenderer* renderer,
+               const ossimRendererFillInfo& info)
+      :
+      ossimJob(),
+      m_renderer(renderer),
+      m_info(info),
+      m_input(0),
+      m_sources(),
+      m_multiplier(1),
+      m_output(0),
+      m_resampled(false)
+   {
+   }
+
+   //! Input at the fill resLevel.
+   void setInput(ossimImageData* input)
+   {
+      m_input = input;
+   }
+
+   //! Input at the last input level, decimated into buffer by the job.
+   void setDecimation(ossimImageData* buffer, ossim_uint32 multiplier)
+   {
+      m_input = buffer;
+      m_multiplier = multiplier;
+   }
+   void addSource(ossimImageData* source)
+   {
+      m_sources.push_back(source);
+   }
+   bool hasSources() const
+   {
+      return !m_sources.empty();
+   }
+
+   void setOutput(ossimImageData* output)
+   {
+      m_output = output;
+   }
+
+   /** @return true if the output tile holds resampled data. */
+   bool isResampled() const
+   {
+      return m_resampled;
+   }
+
+   ossimRefPtr<ossimImageData> getTile()
+   {
+      return m_output;
+   }
+
+protected:
+   virtual void run()
+   {
+      if ( m_sources.size() )
+      {
+         for ( std::vector< ossimRefPtr<ossimImageData> >::size_type i = 0;
+               i < m_sources.size(); ++i )
+         {
+            m_renderer->decimateTile(m_input, m_sources[i], m_multiplier);
+         }
+         m_sources.clear();
+         m_input->validate();
+      }
+
+      ossimDataObjectStatus status = OSSIM_NULL;
+      if ( m_input.valid() )
+      {
+         status = m_input->getDataObjectStatus();
+      }
+      if ( (status != OSSIM_NULL) && (status != OSSIM_EMPTY) )
+      {
+         ossimFilterResampler* resampler = m_renderer->acquireResampler();
+         m_renderer->resampleFill(resampler, m_info, m_input, m_output);
+         m_renderer->releaseResampler(resampler);
+         m_resampled = true;
+      }
+      m_input = 0;
+   }
+
+private:
+   ossimImageRenderer*                        m_renderer;
+   ossimRendererFillInfo                      m_info;
+   ossimRefPtr<ossimImageData>                m_input;
+   std::vector< ossimRefPtr<ossimImageData> > m_sources;
+   ossim_uint32                               m_multiplier;
+   ossimRefPtr<ossimImageData>                m_output;
+   bool                                       m_resampled;
+};
+
 void ossimImageRenderer::recursiveResample(ossimRefPtr<ossimImageData> outputData,
                                            const ossimRendererSubRectInfo& rectInfo,
                                            ossim_uint32 /* level */)
+{
+  std::vector<ossimRendererSubRectInfo> fillRects;
+  getFillRects(rectInfo, fillRects);
+
+  if(m_numberOfThreads > 1)
+  {
+    threadedResample(outputData, fillRects);
+  }
+  else
+  {
+    for(std::vector<ossimRendererSubRectInfo>::size_type idx = 0; idx < fillRects.size(); ++idx)
+    {
+      fillTile(outputData, fillRects[idx]);
+    }
+  }
+  #if 0
+   ossimIrect tempViewRect = rectInfo.getViewRect();
+   if(rectInfo.imageIsNan())
+   {
+      return;
+   } 
+
+  if(tempViewRect.width() <2 ||
+      tempViewRect.height() <2)
+  {
+      if(!rectInfo.imageHasNans())
+      {
+         fillTile(outputData,
+                  rectInfo);
+      }
+      return;
+  }
+  //
+  std::vector<ossimRendererSubRectInfo> splitRects;
+  rectInfo.splitView(splitRects);
+
+//std::cout << "SHOULD BE SPLITTING: " << splitRects.size() <<"\n";
+  ossim_uint32 idx = 0;
+  if(!splitRects.empty())
+  {
+   // std::cout << "SPLITTING " << level << ", " << tempViewRect << "\n";
+    for(idx = 0; idx < splitRects.size();++idx)
+    {
+      recursiveResample(outputData,
+                        splitRects[idx],
+                        level + 1);
+    }
+  }
+  else if(!rectInfo.imageHasNans())
+  {
+    fillTile(outputData,
+            rectInfo);
+  }
+  #endif
+}
+
+void ossimImageRenderer::getFillRects(const ossimRendererSubRectInfo& rectInfo,
+                                      std::vector<ossimRendererSubRectInfo>& result) const
 {
   // Removed recursion and just use the std::stack.
   //
@@ -1268,8 +1484,7 @@ void ossimImageRenderer::recursiveResample(ossimRefPtr<ossimImageData> outputDat
       {
           if(!currentRectInfo.imageHasNans())
           {
-             fillTile(outputData,
-                      currentRectInfo);
+             result.push_back(currentRectInfo);
           }
       }
       else
@@ -1294,53 +1509,13 @@ void ossimImageRenderer::recursiveResample(ossimRefPtr<ossimImageData> outputDat
         {
           if(!currentRectInfo.imageHasNans())
           {
-            fillTile(outputData,
-                    currentRectInfo);
+            result.push_back(currentRectInfo);
           }
         }
       }
 
     }
   }
-  #if 0
-   ossimIrect tempViewRect = rectInfo.getViewRect();
-   if(rectInfo.imageIsNan())
-   {
-      return;
-   } 
-
-  if(tempViewRect.width() <2 ||
-      tempViewRect.height() <2)
-  {
-      if(!rectInfo.imageHasNans())
-      {
-         fillTile(outputData,
-                  rectInfo);
-      }
-      return;
-  }
-  //
-  std::vector<ossimRendererSubRectInfo> splitRects;
-  rectInfo.splitView(splitRects);
-
-//std::cout << "SHOULD BE SPLITTING: " << splitRects.size() <<"\n";
-  ossim_uint32 idx = 0;
-  if(!splitRects.empty())
-  {
-   // std::cout << "SPLITTING " << level << ", " << tempViewRect << "\n";
-    for(idx = 0; idx < splitRects.size();++idx)
-    {
-      recursiveResample(outputData,
-                        splitRects[idx],
-                        level + 1);
-    }
-  }
-  else if(!rectInfo.imageHasNans())
-  {
-    fillTile(outputData,
-            rectInfo);
-  }
-  #endif
 }
 
 #define RSET_SEARCH_THRESHHOLD 0.1
@@ -1348,17 +1523,47 @@ void ossimImageRenderer::recursiveResample(ossimRefPtr<ossimImageData> outputDat
 void ossimImageRenderer::fillTile(ossimRefPtr<ossimImageData> outputData,
                                   const ossimRendererSubRectInfo& rectInfo)
 {
-   if(!outputData.valid() || !outputData->getBuf() || rectInfo.imageHasNans())
+   if(!outputData.valid() || !outputData->getBuf())
+   {
+      return;
+   }
+   ossimRendererFillInfo info;
+   if(!prepareFill(rectInfo, info))
    {
       return;
    }
+   
+   ossimRefPtr<ossimImageData> data = getTileAtResLevel(info.m_requestRect, info.m_resLevel);
+   
+   ossimDataObjectStatus status = OSSIM_NULL;
+   if( data.valid() )
+   {
+      status = data->getDataObjectStatus();
+   }
+   if( (status == OSSIM_NULL) || (status == OSSIM_EMPTY) )
+   {
+      return;
+   }
+   
+   if(isResampled(info))
+   {
+      resampleFill(m_Resampler, info, data, outputData);
+   }
+}
+
+bool ossimImageRenderer::prepareFill(const ossimRendererSubRectInfo& rectInfo,
+                                     ossimRendererFillInfo& info) const
+{
+   if(rectInfo.imageHasNans())
+   {
+      return false;
+   }
    ossimDrect vrect = rectInfo.getViewRect();
    
    ossimDpt imageToViewScale = rectInfo.getAbsValueImageToViewScales();
    
-   if(imageToViewScale.hasNans()) return;
+   if(imageToViewScale.hasNans()) return false;
    
-   ossimDpt tile_size = ossimDpt(vrect.width(), vrect.height());
    double kernelSupportX, kernelSupportY;
    
    double resLevelX = log( 1.0 / imageToViewScale.x )/ log( 2.0 );
@@ -1466,58 +1671,272 @@ void ossimImageRenderer::fillTile(ossimRefPtr<ossimImageData> outputData,
                              (ossim_int32)ceil (boundingRect.lr().x + (kernelSupportX)+.5),
                              (ossim_int32)ceil (boundingRect.lr().y + (kernelSupportY)+.5));
    
-   ossimDrect requestRect = boundingRect;
+   info.m_viewRect         = vrect;
+   info.m_imageToViewScale = imageToViewScale;
+   info.m_resLevel         = resLevel;
+   info.m_closestScale     = closestScale;
+   info.m_requestRect      = boundingRect;
+   info.m_ul               = nul;
+   info.m_ur               = nur;
+   info.m_lr               = nlr;
+   info.m_ll               = nll;
    
-   ossimRefPtr<ossimImageData> data = getTileAtResLevel(requestRect, resLevel);
+   return true;
+}
+
+bool ossimImageRenderer::isResampled(const ossimRendererFillInfo& info) const
+{
+   // Single pixel requests are fetched but not resampled.
+   return !((info.m_requestRect.width() <2)&&(info.m_requestRect.height()<2));
+}
+
+void ossimImageRenderer::resampleFill(ossimFilterResampler* resampler,
+                                      const ossimRendererFillInfo& info,
+                                      const ossimRefPtr<ossimImageData>& input,
+                                      ossimRefPtr<ossimImageData>& outputData) const
+{
+   const ossimDrect& vrect = info.m_viewRect;
+   const ossimDpt& nul = info.m_ul;
+   const ossimDpt& nur = info.m_ur;
+   const ossimDpt& nlr = info.m_lr;
+   const ossimDpt& nll = info.m_ll;
+   double closestScale = info.m_closestScale;
+   ossimDpt tile_size = ossimDpt(vrect.width(), vrect.height());
+
+   ossimDrect inputRect = m_inputR0Rect;
+   inputRect = inputRect*ossimDpt(closestScale, closestScale);
+   resampler->setBoundingInputRect(inputRect);
    
-   ossimDataObjectStatus status = OSSIM_NULL;
-   if( data.valid() )
+   double denominatorY = 1.0;
+   if(tile_size.y > 2)
    {
-      status = data->getDataObjectStatus();
+      denominatorY = tile_size.y-1.0;
    }
-   if( (status == OSSIM_NULL) || (status == OSSIM_EMPTY) )
+   
+   ossimDpt newScale( info.m_imageToViewScale.x / closestScale,
+                      info.m_imageToViewScale.y / closestScale );
+   resampler->setScaleFactor(newScale);
+   
+   resampler->resample(input,
+                       outputData,
+                       vrect,
+                       nul,
+                       nur,
+                       ossimDpt( ( (nll.x - nul.x)/denominatorY ),
+                                 ( (nll.y - nul.y)/denominatorY ) ),
+                       ossimDpt( ( (nlr.x - nur.x)/denominatorY ),
+                                 ( (nlr.y - nur.y)/denominatorY ) ),
+                       tile_size);
+}
+
+void ossimImageRenderer::threadedResample(ossimRefPtr<ossimImageData> outputData,
+                                          const std::vector<ossimRendererSubRectInfo>& rects)
+{
+   if(!outputData.valid() || !outputData->getBuf())
    {
       return;
    }
+   if(!m_jobQueue)
+   {
+      m_jobQueue = std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(), m_numberOfThreads);
+   }
+   updateResamplerPool();
+
+   const std::deque< std::shared_ptr<ResampleJob> >::size_type MAX_PENDING =
+      m_maxPendingInputs ? m_maxPendingInputs : 2 * m_numberOfThreads;
+   std::deque< std::shared_ptr<ResampleJob> > pendingJobs;
+
+   std::vector<ossimRendererSubRectInfo>::size_type idx = 0;
+   while((idx < rects.size()) || !pendingJobs.empty())
+   {
+      if((idx < rects.size()) && (pendingJobs.size() < MAX_PENDING))
+      {
+         ossimRendererFillInfo info;
+         if(prepareFill(rects[idx++], info) && isResampled(info))
+         {
+            std::shared_ptr<ResampleJob> job = std::make_shared<ResampleJob>(this, info);
+            if(fetchFillInput(info, *job))
+            {
+               //---
+               // Sibling sub rects can share a column so each job writes to a
+               // tile of its own, copied to the output below in fill order.
+               //---
+               ossimIrect vrect = info.m_viewRect;
+               ossimRefPtr<ossimImageData> tile = ossimImageDataFactory::instance()->
+                  create( 0, outputData->getScalarType(), outputData->getNumberOfBands(),
+                          vrect.width(), vrect.height() );
+               tile->setNullPix( outputData->getNullPix(), outputData->getNumberOfBands() );
+               tile->setMinPix( outputData->getMinPix(), outputData->getNumberOfBands() );
+               tile->setMaxPix( outputData->getMaxPix(), outputData->getNumberOfBands() );
+               tile->initialize();
+               tile->setImageRectangle(vrect);
+               job->setOutput(tile.get());
+
+               pendingJobs.push_back(job);
+               m_jobQueue->getJobQueue()->add(job);
+            }
+         }
+      }
+      else
+      {
+         std::shared_ptr<ResampleJob> job = pendingJobs.front();
+         pendingJobs.pop_front();
+         while ( !job->isFinished() )
+         {
+            m_jobQueue->waitAny();
+         }
+         if(job->isResampled())
+         {
+            ossimRefPtr<ossimImageData> tile = job->getTile();
+            outputData->loadTile(tile->getBuf(), tile->getImageRectangle(), OSSIM_BSQ);
+         }
+      }
+   }
+}
+
+bool ossimImageRenderer::fetchFillInput(const ossimRendererFillInfo& info, ResampleJob& job)
+{
+   if(!theInputConnection)
+   {
+      return false;
+   }
    
-   if((boundingRect.width() <2)&&(boundingRect.height()<2))
+   //---
+   // Same requests as getTileAtResLevel.  Inputs reuse their tiles so the job
+   // gets copies, and decimation to levels the input lacks is left to the job.
+   //---
+   ossimIrect boundingRect = info.m_requestRect;
+   ossim_uint32 resLevel = info.m_resLevel;
+   ossim_uint32 levels = theInputConnection->getNumberOfDecimationLevels();
+   if((resLevel == 0) || (resLevel < levels))
    {
-              
-//    return;
-   }// std::cout << "SMALL RECT!!!!!!\n";
+      ossimRefPtr<ossimImageData> data = theInputConnection->getTile(boundingRect, resLevel);
+      if(!data.valid() ||
+         (data->getDataObjectStatus() == OSSIM_NULL) ||
+         (data->getDataObjectStatus() == OSSIM_EMPTY))
+      {
+         return false;
+      }
+      ossimRefPtr<ossimImageData> dataCopy = ossimImageDataFactory::instance()->
+         create( 0, data->getScalarType(), data->getNumberOfBands(),
+                 data->getWidth(), data->getHeight() );
+      dataCopy->assign( data.get() );
+      job.setInput(dataCopy.get());
+   }
+   else if((resLevel - levels) < m_MaxLevelsToCompute)
+   {
+      ossimIrect mappedRequestedRect;
+      ossimIrect requestedRectAtValidRLevel;
+      ossimIpt tileSize;
+      ossim_int32 multiplier = 1;
+      getDecimationRects(boundingRect, resLevel, levels,
+                         mappedRequestedRect, requestedRectAtValidRLevel,
+                         tileSize, multiplier);
+      
+      ossimIrect inputRect = theInputConnection->getBoundingRect(levels-1);
+      for(ossim_int32 yIndex = requestedRectAtValidRLevel.ul().y;
+          yIndex < requestedRectAtValidRLevel.lr().y; yIndex += tileSize.y)
+      {
+         for(ossim_int32 xIndex = requestedRectAtValidRLevel.ul().x;
+             xIndex < requestedRectAtValidRLevel.lr().x; xIndex += tileSize.x)
+         {
+            ossimIrect request(xIndex,
+                               yIndex,
+                               xIndex + (tileSize.x-1),
+                               yIndex + (tileSize.y-1));
+            ossimRefPtr<ossimImageData> data = theInputConnection->getTile(request, levels-1);
+            
+            if(data.valid() && (data->getDataObjectStatus()!=OSSIM_EMPTY)&&
+               data->getBuf()&&
+               inputRect.intersects(request))
+            {
+               ossimRefPtr<ossimImageData> dataCopy = ossimImageDataFactory::instance()->
+                  create( 0, data->getScalarType(), data->getNumberOfBands(),
+                          data->getWidth(), data->getHeight() );
+               dataCopy->assign( data.get() );
+               job.addSource(dataCopy.get());
+            }
+         }
+      }
+      
+      // Nothing to decimate leaves the buffer empty.
+      if(!job.hasSources())
+      {
+         return false;
+      }
+      ossimRefPtr<ossimImageData> buffer = (ossimImageData*)m_BlankTile->dup();
+      buffer->setImageRectangle(mappedRequestedRect);
+      buffer->initialize();
+      job.setDecimation(buffer.get(), multiplier);
+   }
    else
    {
-     ossimDrect inputRect = m_inputR0Rect;
-     inputRect = inputRect*ossimDpt(closestScale, closestScale);
-     m_Resampler->setBoundingInputRect(inputRect);
-     
-     double denominatorY = 1.0;
-     if(tile_size.y > 2)
-     {
-        denominatorY = tile_size.y-1.0;
-     }
-     
-     ossimDpt newScale( imageToViewScale.x / closestScale,
-                       imageToViewScale.y / closestScale );
-     m_Resampler->setScaleFactor(newScale);
-     
-
-  //std::cout << "SPLIT VIEW RECT: " << vrect << std::endl;
-  //std::cout << "VIEW RECT: " << outputData->getImageRectangle() << std::endl;
-
-
-     m_Resampler->resample(data,
-                           outputData,
-                           vrect,
-                           nul,
-                           nur,
-                           ossimDpt( ( (nll.x - nul.x)/denominatorY ),
-                                     ( (nll.y - nul.y)/denominatorY ) ),
-                           ossimDpt( ( (nlr.x - nur.x)/denominatorY ),
-                                     ( (nlr.y - nur.y)/denominatorY ) ),
-                           tile_size);
+      return false;
    }
    
+   return true;
+}
+
+ossimFilterResampler* ossimImageRenderer::acquireResampler()
+{
+   std::lock_guard<std::mutex> lock(m_resamplerPoolMutex);
+   ossimFilterResampler* result = 0;
+   if(m_resamplerPool.empty())
+   {
+      // blur is not in the resampler's keyword list.
+      ossimKeywordlist kwl;
+      m_Resampler->saveState(kwl);
+      result = new ossimFilterResampler();
+      result->loadState(kwl);
+      result->setBlurFactor(m_Resampler->getBlurFactor());
+   }
+   else
+   {
+      result = m_resamplerPool.back();
+      m_resamplerPool.pop_back();
+   }
+   return result;
+}
+
+void ossimImageRenderer::releaseResampler(ossimFilterResampler* resampler)
+{
+   std::lock_guard<std::mutex> lock(m_resamplerPoolMutex);
+   m_resamplerPool.push_back(resampler);
+}
+
+void ossimImageRenderer::updateResamplerPool()
+{
+   ossimString config = m_Resampler->getMinifyFilterTypeAsString() + " " +
+                        m_Resampler->getMagnifyFilterTypeAsString() + " " +
+                        ossimString::toString(m_Resampler->getBlurFactor()) + " " +
+                        (m_Resampler->getSeparableFlag() ? "1" : "0");
+
+   std::lock_guard<std::mutex> lock(m_resamplerPoolMutex);
+   if(config != m_resamplerPoolConfig)
+   {
+      for(std::vector<ossimFilterResampler*>::size_type i = 0; i < m_resamplerPool.size(); ++i)
+      {
+         delete m_resamplerPool[i];
+      }
+      m_resamplerPool.clear();
+      m_resamplerPoolConfig = config;
+   }
+}
+
+void ossimImageRenderer::setNumberOfThreads(ossim_uint32 threads)
+{
+   threads = std::max<ossim_uint32>(threads, 1);
+   if(threads != m_numberOfThreads)
+   {
+      m_jobQueue.reset();
+      m_numberOfThreads = threads;
+   }
+}
+
+void ossimImageRenderer::setMaxPendingInputs(ossim_uint32 maxPending)
+{
+   m_maxPendingInputs = maxPending;
 }
 
 long ossimImageRenderer::computeClosestResLevel(const std::vector<ossimDpt>& decimationFactors,
@@ -1600,6 +2019,10 @@ void ossimImageRenderer::getBoundingRect(ossimIrect& rect, ossim_uint32 resLevel
 void ossimImageRenderer::initializeBoundingRects()
 {
    m_rectsDirty      = true;
+
+   // Anything that calls for new bounds may also have changed the transform:
+   updateWarpGrid();
+
    ossimImageViewProjectionTransform* ivpt = 
                    dynamic_cast<ossimImageViewProjectionTransform*>(m_ImageViewTransform.get()); 
    if(!theInputConnection||!m_ImageViewTransform.valid()) return;
@@ -1791,6 +2214,11 @@ bool ossimImageRenderer::saveState(ossimKeywordlist& kwl,
    kwl.add(prefix,
            "max_levels_to_compute",
            m_MaxLevelsToCompute);
+   kwl.add(prefix, WARP_GRID_KW, (m_warpGridEnabled?"true":"false"), true);
+   kwl.add(prefix, WARP_GRID_SPACING_KW, m_warpGridSpacing);
+   kwl.add(prefix, WARP_GRID_ERROR_KW, m_warpGridError);
+   kwl.add(prefix, ossimKeywordNames::THREADS_KW, m_numberOfThreads, true);
+   kwl.add(prefix, MAX_PENDING_INPUTS_KW, m_maxPendingInputs, true);
    
    return ossimImageSource::saveState(kwl, prefix);
 }
@@ -1829,6 +2257,34 @@ bool ossimImageRenderer::loadState(const ossimKeywordlist& kwl,
    {
       m_MaxLevelsToCompute = ossimString(maxLevelsToCompute).toUInt32();
    }
+   const char* lookup = kwl.find(prefix, WARP_GRID_KW);
+   if(lookup)
+   {
+      m_warpGridEnabled = ossimString(lookup).toBool();
+   }
+   lookup = kwl.find(prefix, WARP_GRID_SPACING_KW);
+   if(lookup)
+   {
+      m_warpGridSpacing = ossimString(lookup).toUInt32();
+      if(!m_warpGridSpacing) m_warpGridSpacing = DEFAULT_WARP_GRID_SPACING;
+   }
+   lookup = kwl.find(prefix, WARP_GRID_ERROR_KW);
+   if(lookup)
+   {
+      m_warpGridError = ossimString(lookup).toFloat64();
+   }
+   m_warpGrid = 0; // Rebuilt for the new transform and settings.
+   updateWarpGrid();
+   lookup = kwl.find(prefix, ossimKeywordNames::THREADS_KW);
+   if(lookup)
+   {
+      setNumberOfThreads(ossimString(lookup).toUInt32());
+   }
+   lookup = kwl.find(prefix, MAX_PENDING_INPUTS_KW);
+   if(lookup)
+   {
+      setMaxPendingInputs(ossimString(lookup).toUInt32());
+   }
    
    return result;
 }
@@ -1975,6 +2431,14 @@ void ossimImageRenderer::setProperty(ossimRefPtr<ossimProperty> property)
          m_Resampler->setFilterType(property->valueToString());
       }
    }
+   else if(tempName == ossimKeywordNames::THREADS_KW)
+   {
+      setNumberOfThreads(property->valueToString().toUInt32());
+   }
+   else if(tempName == MAX_PENDING_INPUTS_KW)
+   {
+      setMaxPendingInputs(property->valueToString().toUInt32());
+   }
    //   else if(tempName == "Blur factor")
    //     {
    //       if(m_Resampler)
@@ -2008,6 +2472,21 @@ ossimRefPtr<ossimProperty> ossimImageRenderer::getProperty(const ossimString& na
       
       return stringProp;
    }
+   else if(tempName == ossimKeywordNames::THREADS_KW)
+   {
+      ossimNumericProperty* numericProperty =
+         new ossimNumericProperty(name, ossimString::toString(m_numberOfThreads), 1, 256);
+      numericProperty->setNumericType(ossimNumericProperty::ossimNumericPropertyType_UINT);
+      numericProperty->setCacheRefreshBit();
+      return numericProperty;
+   }
+   else if(tempName == MAX_PENDING_INPUTS_KW)
+   {
+      ossimNumericProperty* numericProperty =
+         new ossimNumericProperty(name, ossimString::toString(m_maxPendingInputs), 0, 4096);
+      numericProperty->setNumericType(ossimNumericProperty::ossimNumericPropertyType_UINT);
+      return numericProperty;
+   }
 //   else if(tempName == "Blur factor")
 //   {
 //      ossimNumericProperty* numericProperty = new ossimNumericProperty("Blur factor",
@@ -2028,6 +2507,8 @@ void ossimImageRenderer::getPropertyNames(std::vector<ossimString>& propertyName
   ossimImageSourceFilter::getPropertyNames(propertyNames);
 
   propertyNames.push_back("Filter type");
+  propertyNames.push_back(ossimKeywordNames::THREADS_KW);
+  propertyNames.push_back(MAX_PENDING_INPUTS_KW);
 //  propertyNames.push_back("Blur factor");
 }
 
@@ -2232,38 +2713,17 @@ ossimRefPtr<ossimImageData>  ossimImageRenderer::getTileAtResLevel(const ossimIr
    }
    else if((resLevel - levels) < m_MaxLevelsToCompute)
    {
-      // check to see how many decimations we must achiev for the
-      // request
-      //
-      int decimations = (resLevel - (levels-1));
-      ossimIpt tileSize(theInputConnection->getTileWidth(),
-                        theInputConnection->getTileHeight());
-      
-      ossim_int32 multiplier = (1 << decimations);
+      ossimIrect mappedRequestedRect;
+      ossimIrect requestedRectAtValidRLevel;
+      ossimIpt tileSize;
+      ossim_int32 multiplier = 1;
+      getDecimationRects(boundingRect, resLevel, levels,
+                         mappedRequestedRect, requestedRectAtValidRLevel,
+                         tileSize, multiplier);
       
       ossim_int32 xIndex = 0;
       ossim_int32 yIndex = 0;
       
-      // adjust the tilesize so it at least will cover the multiplier
-      // We will probably come up with something better later but for now
-      // this will do.
-      if(multiplier > tileSize.x)
-      {
-         tileSize.x = multiplier;
-      }
-      if(multiplier > tileSize.y)
-      {
-         tileSize.y = multiplier;
-      }
-      
-      // set the rect that covers the requested RLevel to the valid RLevel. 
-      // the valid RLevel is what is available on the input side.
-      //
-      ossimIrect requestedRectAtValidRLevel = boundingRect;
-      requestedRectAtValidRLevel.stretchToTileBoundary(tileSize);
-      ossimIrect mappedRequestedRect = requestedRectAtValidRLevel;
-      requestedRectAtValidRLevel  = requestedRectAtValidRLevel*((double)multiplier);
-      
       if(!m_TemporaryBuffer)
       {
          m_TemporaryBuffer = (ossimImageData*)m_BlankTile->dup();
@@ -2294,61 +2754,7 @@ ossimRefPtr<ossimImageData>  ossimImageRenderer::getTileAtResLevel(const ossimIr
                data->getBuf()&&
                boundingRect.intersects(request))
             {
-               switch(data->getScalarType())
-               {
-                  case OSSIM_UINT8:
-                  {
-                     resampleTileToDecimation((ossim_uint8)0,
-                                              m_TemporaryBuffer,
-                                              data,
-                                              multiplier);
-                     break;
-                  }
-                  case OSSIM_SINT16:
-                  {
-                     resampleTileToDecimation((ossim_sint16)0,
-                                              m_TemporaryBuffer,
-                                              data,
-                                              multiplier);
-                     break;
-                  }
-                  case OSSIM_UINT16:
-                  case OSSIM_USHORT11:
-                  case OSSIM_USHORT12:
-                  case OSSIM_USHORT13:
-                  case OSSIM_USHORT14:
-                  case OSSIM_USHORT15:
-                  {
-                     resampleTileToDecimation((ossim_uint16)0,
-                                              m_TemporaryBuffer,
-                                              data,
-                                              multiplier);
-                     break;
-                  }
-                  case OSSIM_FLOAT32:
-                  case OSSIM_NORMALIZED_FLOAT:
-                  {
-                     resampleTileToDecimation((ossim_float32)0,
-                                              m_TemporaryBuffer,
-                                              data,
-                                              multiplier);
-                     break;
-                  }
-                  case OSSIM_FLOAT64:
-                  case OSSIM_NORMALIZED_DOUBLE:
-                  {
-                     resampleTileToDecimation((ossim_float64)0,
-                                              m_TemporaryBuffer,
-                                              data,
-                                              multiplier);
-                     break;
-                  }
-                  case OSSIM_SCALAR_UNKNOWN:
-                  default:
-                  {
-                     break;
-                  }
-               }
+               decimateTile(m_TemporaryBuffer, data, multiplier);
             }
             ++currentCount;
          }
@@ -2360,6 +2766,105 @@ ossimRefPtr<ossimImageData>  ossimImageRenderer::getTileAtResLevel(const ossimIr
    return 0;
 }
 
+void ossimImageRenderer::getDecimationRects(const ossimIrect& boundingRect,
+                                            ossim_uint32 resLevel,
+                                            ossim_uint32 levels,
+                                            ossimIrect& mappedRect,
+                                            ossimIrect& validRect,
+                                            ossimIpt& tileSize,
+                                            ossim_int32& multiplier) const
+{
+   // check to see how many decimations we must achiev for the
+   // request
+   //
+   int decimations = (resLevel - (levels-1));
+   tileSize = ossimIpt(theInputConnection->getTileWidth(),
+                       theInputConnection->getTileHeight());
+   
+   multiplier = (1 << decimations);
+   
+   // adjust the tilesize so it at least will cover the multiplier
+   // We will probably come up with something better later but for now
+   // this will do.
+   if(multiplier > tileSize.x)
+   {
+      tileSize.x = multiplier;
+   }
+   if(multiplier > tileSize.y)
+   {
+      tileSize.y = multiplier;
+   }
+   
+   // set the rect that covers the requested RLevel to the valid RLevel. 
+   // the valid RLevel is what is available on the input side.
+   //
+   validRect = boundingRect;
+   validRect.stretchToTileBoundary(tileSize);
+   mappedRect = validRect;
+   validRect  = validRect*((double)multiplier);
+}
+
+void ossimImageRenderer::decimateTile(ossimRefPtr<ossimImageData> result,
+                                      ossimRefPtr<ossimImageData> tile,
+                                      ossim_uint32 multiplier)
+{
+   switch(tile->getScalarType())
+   {
+      case OSSIM_UINT8:
+      {
+         resampleTileToDecimation((ossim_uint8)0,
+                                  result,
+                                  tile,
+                                  multiplier);
+         break;
+      }
+      case OSSIM_SINT16:
+      {
+         resampleTileToDecimation((ossim_sint16)0,
+                                  result,
+                                  tile,
+                                  multiplier);
+         break;
+      }
+      case OSSIM_UINT16:
+      case OSSIM_USHORT11:
+      case OSSIM_USHORT12:
+      case OSSIM_USHORT13:
+      case OSSIM_USHORT14:
+      case OSSIM_USHORT15:
+      {
+         resampleTileToDecimation((ossim_uint16)0,
+                                  result,
+                                  tile,
+                                  multiplier);
+         break;
+      }
+      case OSSIM_FLOAT32:
+      case OSSIM_NORMALIZED_FLOAT:
+      {
+         resampleTileToDecimation((ossim_float32)0,
+                                  result,
+                                  tile,
+                                  multiplier);
+         break;
+      }
+      case OSSIM_FLOAT64:
+      case OSSIM_NORMALIZED_DOUBLE:
+      {
+         resampleTileToDecimation((ossim_float64)0,
+                                  result,
+                                  tile,
+                                  multiplier);
+         break;
+      }
+      case OSSIM_SCALAR_UNKNOWN:
+      default:
+      {
+         break;
+      }
+   }
+}
+
 void ossimImageRenderer::setMaxLevelsToCompute(ossim_uint32 maxLevels)
 {
    m_MaxLevelsToCompute = maxLevels;
@@ -2544,6 +3049,58 @@ void ossimImageRenderer::refreshEvent(ossimRefreshEvent& event)
    initialize();
 }
 
+void ossimImageRenderer::setWarpGridEnabled(bool flag)
+{
+   if ( m_warpGridEnabled != flag )
+   {
+      m_warpGridEnabled = flag;
+      updateWarpGrid();
+   }
+}
+
+void ossimImageRenderer::buildWarpGrid(const ossimIrect& viewRect, ossim_uint32 numberOfThreads)
+{
+   if ( getRenderTransform() == m_warpGrid.get() )
+   {
+      m_warpGrid->buildGrid(viewRect, numberOfThreads);
+   }
+}
+
+void ossimImageRenderer::updateWarpGrid()
+{
+   //---
+   // Only projection transforms are worth approximating. Other transforms
+   // (affine) are exact and cheap already.
+   //---
+   if ( m_warpGridEnabled &&
+        dynamic_cast<ossimImageViewProjectionTransform*>(m_ImageViewTransform.get()) )
+   {
+      if ( !m_warpGrid.valid() )
+      {
+         m_warpGrid = new ossimImageViewGridTransform(0, m_warpGridSpacing, m_warpGridError);
+      }
+      m_warpGrid->setTransform(m_ImageViewTransform.get()); // Clears the grid.
+   }
+   else
+   {
+      m_warpGrid = 0;
+   }
+}
+
+ossimImageViewTransform* ossimImageRenderer::getRenderTransform()
+{
+   if ( m_warpGrid.valid() && (m_warpGrid->getTransform() != m_ImageViewTransform.get()) )
+   {
+      // The transform was replaced without going through initializeBoundingRects.
+      updateWarpGrid();
+   }
+   if ( m_warpGrid.valid() )
+   {
+      return m_warpGrid.get();
+   }
+   return m_ImageViewTransform.get();
+}
+
 void ossimImageRenderer::enableSource()
 {
    if ( isSourceEnabled() == false )
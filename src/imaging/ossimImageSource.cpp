@@ -366,6 +366,12 @@ bool ossimImageSource::isIndexedData() const
    return result;
 }
 
+void ossimImageSource::setTileRequestOrder(const ossimIrect& /* area */,
+                                           const ossimIpt& /* tileSize */,
+                                           ossim_uint32 /* resLevel */)
+{
+}
+
 // Protected to hide from use...
 ossimImageSource::ossimImageSource (const ossimImageSource& /* rhs */)
    :ossimSource() 
@@ -243,6 +243,12 @@ const ossimIrect& ossimImageSourceSequencer::getAreaOfInterest()const
 void ossimImageSourceSequencer::setToStartOfSequence()
 {
    theCurrentTileNumber = 0;
+
+   // Let readers that can read ahead know the order tiles will be asked for.
+   if( theInputConnection && !theAreaOfInterest.hasNans() )
+   {
+      theInputConnection->setTileRequestOrder(theAreaOfInterest, theTileSize, 0);
+   }
 }
 
 ossimRefPtr<ossimImageData> ossimImageSourceSequencer::getTile(
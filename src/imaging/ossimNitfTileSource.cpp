@@ -26,11 +26,16 @@
 #include <ossim/base/ossimScalarTypeLut.h>
 #include <ossim/base/ossimEndian.h>
 #include <ossim/base/ossimBooleanProperty.h>
+#include <ossim/base/ossimNumericProperty.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimStreamFactoryRegistry.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
 #include <ossim/imaging/ossimImageGeometry.h>
 #include <ossim/imaging/ossimJpegMemSrc.h>
 #include <ossim/imaging/ossimTiffTileSource.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
 #include <ossim/imaging/ossimJpegDefaultTable.h>
 #include <ossim/base/ossim2dTo2dShiftTransform.h>
 #include <ossim/base/ossimContainerProperty.h>
@@ -38,6 +43,8 @@
 #include <ossim/support_data/ossimNitfIchipbTag.h>
 #include <ossim/support_data/ossimNitfImageHeaderV2_0.h>
 #include <ossim/support_data/ossimNitfImageHeaderV2_1.h>
+#include <ossim/support_data/ossimNitfJpegBlockIndex.h>
+#include <ossim/support_data/ImageHandlerStateStore.h>
 #include <ossim/support_data/ossimNitfStdidcTag.h>
 #include <ossim/support_data/ossimNitfVqCompressionHeader.h>
 
@@ -48,6 +55,7 @@
 #include <jpeglib.h>
 #include <fstream>
 #include <algorithm> /* for std::fill */
+#include <typeinfo>
 
 RTTI_DEF1_INST(ossimNitfTileSource, "ossimNitfTileSource", ossimImageHandler)
 
@@ -77,6 +85,8 @@ static ossimTrace traceDebug("ossimNitfTileSource:debug");
 // divide by 8 bits to get bytes gives you 6144 bytes
 static const ossim_uint32   OSSIM_NITF_VQ_BLOCKSIZE = 6144;
 
+static const char DECODE_THREADS_KW[] = "decode_threads";
+
 /** @brief Extended error handler struct for jpeg code. */
 struct ossimJpegErrorMgr
 {
@@ -85,6 +95,56 @@ struct ossimJpegErrorMgr
 };
 
 
+/** A block read and decoded by a DecodeJob. */
+struct ossimNitfBlockLoad
+{
+   ossimNitfBlockLoad()
+      : m_origin(0, 0), m_block(0), m_status(false), m_readError(false), m_noStream(false)
+   {
+   }
+   ossimIpt                    m_origin;
+   ossimRefPtr<ossimImageData> m_block;
+   bool                        m_status;
+   bool                        m_readError;
+   bool                        m_noStream;
+};
+
+/** Reads and decodes one block on a decode thread with a pooled stream. */
+class ossimNitfTileSource::DecodeJob : public ossimJob
+{
+public:
+   DecodeJob(ossimNitfTileSource* source, ossimNitfBlockLoad* load)
+      :
+      ossimJob(),
+      m_source(source),
+      m_load(load)
+   {
+   }
+
+protected:
+   virtual void run()
+   {
+      std::shared_ptr<ossim::istream> str = m_source->acquireReadStream();
+      if ( !str )
+      {
+         m_load->m_noStream = true;
+         return;
+      }
+      std::vector<ossim_uint8> compressedBuf( m_source->theCompressedBuf.size() );
+      m_load->m_status = m_source->readBlock( m_load->m_origin.x,
+                                              m_load->m_origin.y,
+                                              m_load->m_block.get(),
+                                              *str,
+                                              compressedBuf,
+                                              m_load->m_readError );
+      m_source->releaseReadStream(str);
+   }
+
+private:
+   ossimNitfTileSource* m_source;
+   ossimNitfBlockLoad*  m_load;
+};
+
 ossimNitfTileSource::ossimNitfTileSource()
    :
       ossimImageHandler(),
@@ -113,8 +173,19 @@ ossimNitfTileSource::ossimNitfTileSource()
       theCompressedBuf(0),
       theNitfBlockOffset(0),
       theNitfBlockSize(0),
-      m_jpegOffsetsDirty(false)
+      m_jpegOffsetsDirty(false),
+      m_decodeThreads(1),
+      m_decodeQueue(),
+      m_readStreams(),
+      m_readStreamMutex()
 {
+   ossimString threads = ossimPreferences::instance()->
+      findPreference("ossim.imaging.nitf.decode_threads");
+   if ( threads.size() )
+   {
+      m_decodeThreads = threads.toUInt32();
+   }
+
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -133,6 +204,8 @@ ossimNitfTileSource::~ossimNitfTileSource()
 
 void ossimNitfTileSource::destroy()
 {
+   closeDecodeThreads();
+
    if (theCacheId != -1)
    {
       ossimAppFixedTileCache::instance()->deleteCache(theCacheId);
@@ -695,7 +768,7 @@ bool ossimNitfTileSource::canUncompress(const ossimNitfImageHeader* hdr) const
    {
       ossimString code = hdr->getCompressionCode();
 
-      if (code == "C3") // jpeg
+      if ( (code == "C3") || (code == "M3") ) // jpeg, jpeg with block mask
       {
          if (hdr->getBitsPerPixelPerBand() == 8)
          {
@@ -742,7 +815,8 @@ void ossimNitfTileSource::initializeReadMode()
    ossimString imode           = hdr->getIMode();
    ossimString compressionCode = hdr->getCompressionCode();
 
-   if ( (compressionCode == "C3") && ((imode == "B")||(imode == "P")) )
+   if ( ((compressionCode == "C3") || (compressionCode == "M3")) &&
+        ((imode == "B")||(imode == "P")) )
    {
       theReadMode = READ_JPEG_BLOCK; 
    }
@@ -1142,7 +1216,7 @@ bool ossimNitfTileSource::initializeBlockSize()
       {
          theBlockSizeInBytes *= theNumberOfInputBands;
          ossimString code = hdr->getCompressionCode();
-         if (code == "C3") // jpeg
+         if ( (code == "C3") || (code == "M3") ) // jpeg
          {
             m_jpegOffsetsDirty  = true;
          }
@@ -1660,6 +1734,10 @@ bool ossimNitfTileSource::loadTile(const ossimIrect& clipRect)
    //---
    ossimIpt nitfBlockOrigin = zbClipRect.ul();
 
+   // Blocks not in the cache when decoding on several threads.
+   std::vector<ossimIpt> origins;
+   const bool CONCURRENT = ( m_decodeThreads > 1 ) && canDecodeConcurrently();
+
    // Vertical block loop.
    ossim_int32 y = nitfBlockOrigin.y;
    while (y < zbClipRect.lr().y)
@@ -1670,7 +1748,11 @@ bool ossimNitfTileSource::loadTile(const ossimIrect& clipRect)
       {
          if ( loadBlockFromCache(x, y, clipRect) == false )
          {
-            if ( loadBlock(x, y) )
+            if ( CONCURRENT )
+            {
+               origins.push_back( ossimIpt(x, y) );
+            }
+            else if ( loadBlock(x, y) )
             {
                //---
                // Note: Clip the cache tile(nitf block) to the image clipRect
@@ -1698,9 +1780,150 @@ bool ossimNitfTileSource::loadTile(const ossimIrect& clipRect)
       y += BLOCK_HEIGHT; // Go to next row of blocks.
    }
 
+   if ( origins.size() == 1 )
+   {
+      if ( loadBlock(origins[0].x, origins[0].y) == false )
+      {
+         return false;
+      }
+      ossimIrect cr = theCacheTile->getImageRectangle().clipToRect(clipRect);
+      theTile->loadTile(theCacheTile->getBuf(),
+                        theCacheTile->getImageRectangle(),
+                        cr,
+                        theCacheTileInterLeaveType);
+   }
+   else if ( origins.size() )
+   {
+      return loadBlocksConcurrent(origins, clipRect);
+   }
+
+   return true;
+}
+
+bool ossimNitfTileSource::canDecodeConcurrently() const
+{
+   return ( typeid(*this) == typeid(ossimNitfTileSource) );
+}
+
+bool ossimNitfTileSource::loadBlocksConcurrent(const std::vector<ossimIpt>& origins,
+                                               const ossimIrect& clipRect)
+{
+   // Offsets are scanned for here so the decode threads only read them.
+   if ( ( theReadMode == READ_JPEG_BLOCK ) && !loadJpegBlockOffsets() )
+   {
+      return false;
+   }
+
+   if ( !m_decodeQueue )
+   {
+      m_decodeQueue = std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(), m_decodeThreads);
+   }
+
+   std::vector<ossimNitfBlockLoad> loads(origins.size());
+   for (ossim_uint32 i = 0; i < loads.size(); ++i)
+   {
+      loads[i].m_origin = origins[i];
+      loads[i].m_block  = ossimImageDataFactory::instance()->create(
+         this, theScalarType, theNumberOfOutputBands, theCacheSize.x, theCacheSize.y);
+      loads[i].m_block->initialize();
+      m_decodeQueue->getJobQueue()->add( std::make_shared<DecodeJob>(this, &loads[i]) );
+   }
+   m_decodeQueue->waitAll();
+
+   //---
+   // Blocks are loaded into theTile and the cache on this thread, in the
+   // order the serial loop would have.
+   //---
+   for (ossim_uint32 i = 0; i < loads.size(); ++i)
+   {
+      ossimNitfBlockLoad& load = loads[i];
+      if ( load.m_noStream )
+      {
+         // The image could not be opened again, read on our own stream.
+         load.m_status = readBlock(load.m_origin.x, load.m_origin.y, load.m_block.get(),
+                                   *theFileStr, theCompressedBuf, load.m_readError);
+      }
+      if ( !load.m_status )
+      {
+         if ( load.m_readError )
+         {
+            theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+         }
+         return false;
+      }
+
+      ossimIrect cr = load.m_block->getImageRectangle().clipToRect(clipRect);
+      theTile->loadTile(load.m_block->getBuf(),
+                        load.m_block->getImageRectangle(),
+                        cr,
+                        theCacheTileInterLeaveType);
+      if (theCacheEnabledFlag)
+      {
+         ossimAppFixedTileCache::instance()->addTile(theCacheId, load.m_block);
+      }
+   }
+
+   // Keep the last block for getTile as the serial loop does.
+   theCacheTile = loads.back().m_block;
+
    return true;
 }
 
+std::shared_ptr<ossim::istream> ossimNitfTileSource::acquireReadStream()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_readStreamMutex);
+      if ( m_readStreams.size() )
+      {
+         std::shared_ptr<ossim::istream> str = m_readStreams.back();
+         m_readStreams.pop_back();
+         return str;
+      }
+   }
+
+   // None free so open another.
+   std::shared_ptr<ossim::istream> str =
+      ossim::StreamFactoryRegistry::instance()->createIstream( theImageFile.string() );
+   if ( !str && traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+         << "ossimNitfTileSource::acquireReadStream WARNING:\n"
+         << "Could not open " << theImageFile << endl;
+   }
+   return str;
+}
+
+void ossimNitfTileSource::releaseReadStream(std::shared_ptr<ossim::istream> str)
+{
+   str->clear();
+   std::lock_guard<std::mutex> lock(m_readStreamMutex);
+   m_readStreams.push_back(str);
+}
+
+void ossimNitfTileSource::closeDecodeThreads()
+{
+   // Waits for the jobs in progress.
+   m_decodeQueue.reset();
+
+   std::lock_guard<std::mutex> lock(m_readStreamMutex);
+   m_readStreams.clear();
+}
+
+void ossimNitfTileSource::setNumberOfDecodeThreads(ossim_uint32 threads)
+{
+   if ( threads != m_decodeThreads )
+   {
+      closeDecodeThreads();
+      m_decodeThreads = threads;
+   }
+}
+
+ossim_uint32 ossimNitfTileSource::getNumberOfDecodeThreads() const
+{
+   return m_decodeThreads;
+}
+
 bool ossimNitfTileSource::loadBlockFromCache(ossim_uint32 x, ossim_uint32 y,
                                              const ossimIrect& clipRect)
 {
@@ -1748,7 +1971,32 @@ bool ossimNitfTileSource::loadBlock(ossim_uint32 x, ossim_uint32 y)
          << "  x:  " << x << " y:  " << y << endl;
    }
 #endif
+
+   bool readError = false;
+   if ( !readBlock(x, y, theCacheTile.get(), *theFileStr, theCompressedBuf, readError) )
+   {
+      if ( readError )
+      {
+         theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+      }
+      return false;
+   }
+
+   if (theCacheEnabledFlag)
+   {
+      // Add it to the cache for the next time.
+      ossimAppFixedTileCache::instance()->addTile(theCacheId, theCacheTile);
+   }
    
+   return true;
+}
+
+bool ossimNitfTileSource::readBlock(ossim_uint32 x, ossim_uint32 y,
+                                    ossimImageData* block,
+                                    ossim::istream& in,
+                                    std::vector<ossim_uint8>& compressedBuf,
+                                    bool& readError)
+{
    //---
    // The origin set in the cache tile must have the sub image offset in it
    // since "theTile" is relative to any sub image offset.  This is so that
@@ -1757,16 +2005,16 @@ bool ossimNitfTileSource::loadBlock(ossim_uint32 x, ossim_uint32 y)
    ossimIpt origin(x, y);
     
    const ossimNitfImageHeader* hdr = getCurrentImageHeader();
-   theCacheTile->setOrigin(origin);
+   block->setOrigin(origin);
    ossim_uint32 readSize = theReadBlockSizeInBytes;
-   if(!theCacheTile->getImageRectangle().completely_within(theBlockImageRect))
+   if(!block->getImageRectangle().completely_within(theBlockImageRect))
    {
       readSize = getPartialReadSize(origin);
    }
    if((hdr->hasBlockMaskRecords())||
       (readSize != theReadBlockSizeInBytes))
    {
-      theCacheTile->makeBlank();
+      block->makeBlank();
    }
 
    switch (theReadMode)
@@ -1779,15 +2027,15 @@ bool ossimNitfTileSource::loadBlock(ossim_uint32 x, ossim_uint32 y)
          std::streamoff p;
          if(getPosition(p, x, y, 0))
          {
-            theFileStr->seekg(p, ios::beg);
-            char* buf = (char*)(theCacheTile->getBuf());
-            if (!theFileStr->read(buf, readSize))
+            in.seekg(p, ios::beg);
+            char* buf = (char*)(block->getBuf());
+            if (!in.read(buf, readSize))
             {
-               theFileStr->clear();
+               in.clear();
                ossimNotify(ossimNotifyLevel_FATAL)
                   << "ossimNitfTileSource::loadBlock BIP Read Error!"
                   << "\nReturning error..." << endl;
-               theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+               readError = true;
                
                return false;
             }
@@ -1804,46 +2052,47 @@ bool ossimNitfTileSource::loadBlock(ossim_uint32 x, ossim_uint32 y)
          // The reads are done per for future enabling on band selection
          // at the image handler level.
          //---
+         ossimRefPtr<ossimImageData> destination = block;
          for (ossim_uint32 band = 0; band < theNumberOfInputBands; ++band)
          {
             ossim_uint8* buf =0;
             if(isVqCompressed(hdr->getCompressionCode())||
                hdr->getRepresentation().upcase().contains("LUT"))
             {
-               buf = (ossim_uint8*)&(theCompressedBuf.front());
+               buf = (ossim_uint8*)&(compressedBuf.front());
             }
             else
             {
-               buf = (ossim_uint8*)(theCacheTile->getBuf(band));
+               buf = (ossim_uint8*)(block->getBuf(band));
             }
             std::streamoff p;
             if(getPosition(p, x, y, band))
             {
-               theFileStr->seekg(p, ios::beg);
-               if (!theFileStr->read((char*)buf, readSize))
+               in.seekg(p, ios::beg);
+               if (!in.read((char*)buf, readSize))
                {
-                  theFileStr->clear();
+                  in.clear();
                   ossimNotify(ossimNotifyLevel_FATAL)
                      << "ossimNitfTileSource::loadBlock Read Error!"
                      << "\nReturning error..." << endl;
-                  theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+                  readError = true;
                   return false;
                }
                else if(hdr->getCompressionCode() == "C4")
                {
-                  vqUncompressC4(theCacheTile,
-                                 (ossim_uint8*)&(theCompressedBuf.front()));
+                  vqUncompressC4(destination,
+                                 (ossim_uint8*)&(compressedBuf.front()));
                }
 
                else if(hdr->getCompressionCode() == "M4")
                {
-                  vqUncompressM4(theCacheTile,
-                                 (ossim_uint8*)&(theCompressedBuf.front()));
+                  vqUncompressM4(destination,
+                                 (ossim_uint8*)&(compressedBuf.front()));
                }
                else if(hdr->getRepresentation().upcase().contains("LUT"))
                {
-                  lutUncompress(theCacheTile,
-                                (ossim_uint8*)&(theCompressedBuf.front()));
+                  lutUncompress(destination,
+                                (ossim_uint8*)&(compressedBuf.front()));
                }
             }
          }
@@ -1851,10 +2100,20 @@ bool ossimNitfTileSource::loadBlock(ossim_uint32 x, ossim_uint32 y)
       }
       case READ_JPEG_BLOCK:
       {
-         if (uncompressJpegBlock(x, y) == false)
+         // theCacheTile goes through uncompressJpegBlock which may be overridden.
+         bool status = false;
+         if ( block == theCacheTile.get() )
+         {
+            status = uncompressJpegBlock(x, y);
+         }
+         else
+         {
+            status = decodeJpegBlock(getBlockNumber(origin), block, in);
+         }
+         if (status == false)
          {
-            theCacheTile->makeBlank();
-            theFileStr->clear();
+            block->makeBlank();
+            in.clear();
             ossimNotify(ossimNotifyLevel_FATAL)
                << "ossimNitfTileSource::loadBlock Read Error!"
                << "\nReturning error..." << endl;
@@ -1868,30 +2127,24 @@ bool ossimNitfTileSource::loadBlock(ossim_uint32 x, ossim_uint32 y)
    
    if(thePackedBitsFlag)
    {
-      explodePackedBits(theCacheTile);
+      explodePackedBits(block);
    }
    // Check for swap bytes.
    if (theSwapBytesFlag)
    {
       ossimEndian swapper;
       swapper.swap(theScalarType,
-                   theCacheTile->getBuf(),
-                   theCacheTile->getSize());
+                   block->getBuf(),
+                   block->getSize());
    }
 
    if ( !isVqCompressed(hdr->getCompressionCode()) )
    {
-      convertTransparentToNull(theCacheTile);
+      convertTransparentToNull(block);
    }
 
-   // Set the origin of the cache tile.
-   theCacheTile->validate();
-   if (theCacheEnabledFlag)
-   {
-      // Add it to the cache for the next time.
-      ossimAppFixedTileCache::instance()->addTile(theCacheId, theCacheTile);
-   }
-   
+   block->validate();
+
    return true;
 }
 
@@ -2342,6 +2595,13 @@ bool ossimNitfTileSource::loadState(const ossimKeywordlist& kwl,
       theCacheEnabledFlag = s.toBool();
    }
 
+   lookup = kwl.find(prefix, DECODE_THREADS_KW);
+   if (lookup)
+   {
+      ossimString s(lookup);
+      setNumberOfDecodeThreads( s.toUInt32() );
+   }
+
    if(traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -2363,6 +2623,8 @@ bool ossimNitfTileSource::saveState(ossimKeywordlist& kwl,
    // Add the cache_enable flag.
    kwl.add(prefix, ossimKeywordNames::ENABLE_CACHE_KW, theCacheEnabledFlag, true);
 
+   kwl.add(prefix, DECODE_THREADS_KW, m_decodeThreads, true);
+
    // Call the base class save state.
    return ossimImageHandler::saveState(kwl, prefix);
 }
@@ -2515,7 +2777,7 @@ ossim_uint32 ossimNitfTileSource::getBlockNumber(const ossimIpt& block_origin) c
    return blockNumber;
 }
 
-ossim_uint32 ossimNitfTileSource::getPartialReadSize(const ossimIpt& /* blockOrigin */)const
+ossim_uint32 ossimNitfTileSource::getPartialReadSize(const ossimIpt& blockOrigin)const
 {
    ossim_uint32 result = 0;
    const ossimNitfImageHeader* hdr = getCurrentImageHeader();
@@ -2523,12 +2785,17 @@ ossim_uint32 ossimNitfTileSource::getPartialReadSize(const ossimIpt& /* blockOri
    {
       return result;
    }
-   
-   if(theCacheTile->getImageRectangle().completely_within(theBlockImageRect))
+
+   // The block read at blockOrigin, which may not be in theCacheTile.
+   const ossimIrect BLOCK_RECT(blockOrigin.x,
+                               blockOrigin.y,
+                               blockOrigin.x + theCacheSize.x - 1,
+                               blockOrigin.y + theCacheSize.y - 1);
+   if(BLOCK_RECT.completely_within(theBlockImageRect))
    {
       return theReadBlockSizeInBytes;
    }
-   ossimIrect clipRect = theCacheTile->getImageRectangle().clipToRect(theBlockImageRect);
+   ossimIrect clipRect = BLOCK_RECT.clipToRect(theBlockImageRect);
    
    result = (theCacheSize.x*
              clipRect.height()*
@@ -2814,6 +3081,13 @@ ossimRefPtr<ossimProperty> ossimNitfTileSource::getProperty(const ossimString& n
       ossimProperty* p = new ossimBooleanProperty(name, theCacheEnabledFlag);
       return ossimRefPtr<ossimProperty>(p);
    }
+   else if (name == DECODE_THREADS_KW)
+   {
+      ossimProperty* p = new ossimNumericProperty(
+         name, ossimString::toString(m_decodeThreads), 1, 64);
+      p->setCacheRefreshBit();
+      return ossimRefPtr<ossimProperty>(p);
+   }
    else 
    {
       if(theNitfFile.valid())
@@ -2858,6 +3132,10 @@ void ossimNitfTileSource::setProperty(ossimRefPtr<ossimProperty> property)
          setCacheEnabledFlag(obj->getBoolean());
       }
    }
+   else if (name == DECODE_THREADS_KW)
+   {
+      setNumberOfDecodeThreads( property->valueToString().toUInt32() );
+   }
    else
    {
       ossimImageHandler::setProperty(property);
@@ -2868,6 +3146,7 @@ void ossimNitfTileSource::getPropertyNames(std::vector<ossimString>& propertyNam
 {
    ossimImageHandler::getPropertyNames(propertyNames);
    propertyNames.push_back(ossimKeywordNames::ENABLE_CACHE_KW);
+   propertyNames.push_back(DECODE_THREADS_KW);
    if(getFileHeader())
    {
       getFileHeader()->getPropertyNames(propertyNames);
@@ -3225,8 +3504,68 @@ bool ossimNitfTileSource::scanForJpegBlockOffsets()
    // found equals total_blocks get out.
    //---
    ossim_uint32 total_blocks = hdr->getNumberOfBlocksPerRow()*hdr->getNumberOfBlocksPerCol();
-   
+
+   //---
+   // M3 blocks are located by the block mask.  C3 blocks come from an index
+   // written by an earlier scan if the image has not changed since, else are
+   // scanned for on all threads and the index written if enabled by the
+   // preference "ossim.imaging.nitf.jpeg_block_index.write".  The index is
+   // kept next to the image (or in the supplementary directory) and, if that
+   // cannot be written, in the handler state store directory when one is set
+   // by "ossim.imaging.handler.registry.state_store.directory".
+   //---
+   ossimNitfJpegBlockIndex index;
+   if ( hdr->hasBlockMaskRecords() )
+   {
+      allBlocksFound = index.buildFromBlockMask(*theFileStr, *hdr);
+   }
+   else
+   {
+      const std::streamoff START = (std::streamoff)hdr->getDataLocation();
+      ossimFilename indexFile = getFilenameWithThisExtension(ossimString("jbi"));
+      ossimFilename storeIndexFile;
+      ossimString storeDirectory = ossimPreferences::instance()->
+         findPreference("ossim.imaging.handler.registry.state_store.directory");
+      if ( storeDirectory.size() )
+      {
+         storeIndexFile = ossim::ImageHandlerStateStore(ossimFilename(storeDirectory)).
+            getSupportFile(theImageFile, getCurrentEntry(), ossimString("jbi"));
+      }
+
+      allBlocksFound = index.read(indexFile, theImageFile, START, total_blocks) ||
+         ( storeIndexFile.size() &&
+           index.read(storeIndexFile, theImageFile, START, total_blocks) );
+      if ( !allBlocksFound )
+      {
+         allBlocksFound = index.scan(theImageFile.string(), START, total_blocks,
+                                     ossim::getNumberOfThreads());
+         if ( allBlocksFound )
+         {
+            ossimString writeIndex = ossimPreferences::instance()->
+               findPreference("ossim.imaging.nitf.jpeg_block_index.write");
+            if ( writeIndex.toBool() &&
+                 !index.write(indexFile, theImageFile) && storeIndexFile.size() )
+            {
+               ossimFilename storePath = storeIndexFile.path();
+               if ( !storePath.exists() )
+               {
+                  storePath.createDirectory();
+               }
+               index.write(storeIndexFile, theImageFile);
+            }
+         }
+      }
+   }
+   if ( allBlocksFound || hdr->hasBlockMaskRecords() )
+   {
+      index.release(theNitfBlockOffset, theNitfBlockSize);
+      return allBlocksFound;
+   }
+
    //---
+   // Else scan sequentially on our own stream, e.g. when the image could not
+   // be opened again for the threaded scan.
+   //
    // NOTE:
    // SOI = 0xffd8 Start of image
    // EOI = 0xffd9 End of image
@@ -3406,6 +3745,16 @@ bool ossimNitfTileSource::uncompressJpegBlock(ossim_uint32 x, ossim_uint32 y)
          << std::endl;
    }
 
+   if ( !loadJpegBlockOffsets() )
+   {
+      return false;
+   }
+
+   return decodeJpegBlock(blockNumber, theCacheTile.get(), *theFileStr);
+}
+
+bool ossimNitfTileSource::loadJpegBlockOffsets()
+{
    //---
    // Logic to hold off on scanning for offsets until a block is actually needed
    // to speed up loads for things like ossim-info that don't actually read
@@ -3426,7 +3775,18 @@ bool ossimNitfTileSource::uncompressJpegBlock(ossim_uint32 x, ossim_uint32 y)
          return false;
       }
    }
-   
+   return true;
+}
+
+bool ossimNitfTileSource::decodeJpegBlock(ossim_uint32 blockNumber,
+                                          ossimImageData* block,
+                                          ossim::istream& in) const
+{
+   if ( blockNumber >= theNitfBlockOffset.size() )
+   {
+      return false;
+   }
+
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -3435,15 +3795,21 @@ bool ossimNitfTileSource::uncompressJpegBlock(ossim_uint32 x, ossim_uint32 y)
          << std::endl;
    }
    
+   if ( theNitfBlockSize[blockNumber] == 0 )
+   {
+      // Masked M3 block.  loadBlock blanked the tile.
+      return true;
+   }
+
    // Seek to the block.
-   theFileStr->seekg(theNitfBlockOffset[blockNumber], ios::beg);
-   
+   in.seekg(theNitfBlockOffset[blockNumber], ios::beg);
+
    // Read the block into memory.
    std::vector<ossim_uint8> compressedBuf(theNitfBlockSize[blockNumber]);
-   if (!theFileStr->read((char*)&(compressedBuf.front()),
-                        theNitfBlockSize[blockNumber]))
+   if (!in.read((char*)&(compressedBuf.front()),
+                theNitfBlockSize[blockNumber]))
    {
-      theFileStr->clear();
+      in.clear();
       ossimNotify(ossimNotifyLevel_FATAL)
          << "ossimNitfTileSource::uncompressJpegBlock Read Error!"
          << "\nReturning error..." << endl;
@@ -3491,7 +3857,7 @@ bool ossimNitfTileSource::uncompressJpegBlock(ossim_uint32 x, ossim_uint32 y)
    //---
    ossimJpegMemorySrc (&cinfo,
                        &(compressedBuf.front()),
-                       static_cast<size_t>(theReadBlockSizeInBytes));
+                       compressedBuf.size());
 
    /* Step 3: read file parameters with jpeg_read_header() */
    jpeg_read_header(&cinfo, TRUE);
@@ -3555,14 +3921,14 @@ bool ossimNitfTileSource::uncompressJpegBlock(ossim_uint32 x, ossim_uint32 y)
    /* JSAMPLEs per row in output buffer */
    const ossim_uint32 ROW_STRIDE = SAMPLES * cinfo.output_components;
 
-   if ( (SAMPLES < theCacheTile->getWidth() ) ||
-        (LINES_TO_READ < theCacheTile->getHeight()) )
+   if ( (SAMPLES < block->getWidth() ) ||
+        (LINES_TO_READ < block->getHeight()) )
    {
-      theCacheTile->makeBlank();
+      block->makeBlank();
    }
 
-   if ( (SAMPLES > theCacheTile->getWidth()) ||
-        (LINES_TO_READ > theCacheTile->getHeight()) )
+   if ( (SAMPLES > block->getWidth()) ||
+        (LINES_TO_READ > block->getHeight()) )
    {
      // Error...
      jpeg_finish_decompress(&cinfo);
@@ -3574,7 +3940,7 @@ bool ossimNitfTileSource::uncompressJpegBlock(ossim_uint32 x, ossim_uint32 y)
    std::vector<ossim_uint8*> destinationBuffer(theNumberOfInputBands);
    for (ossim_uint32 band = 0; band < theNumberOfInputBands; ++band)
    {
-     destinationBuffer[band] = theCacheTile->getUcharBuf(band);
+     destinationBuffer[band] = block->getUcharBuf(band);
    }
 
    std::vector<ossim_uint8> lineBuffer(ROW_STRIDE);
@@ -19,7 +19,11 @@
 #include <ossim/imaging/ossimImageDataFactory.h>
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/support_data/ossimImageMetaData.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
 #include <ossim/parallel/ossimMpi.h>
+#include <algorithm>
 
 
 #ifdef OSSIM_ID_ENABLED
@@ -28,6 +32,55 @@ static const char OSSIM_ID[] = "$Id: ossimOverviewSequencer.cpp 23377 2015-06-17
 
 static ossimTrace traceDebug("ossimOverviewSequencer:debug");
 
+/**
+ * Decimates a copy of an input tile into an output tile.  The copy is dropped
+ * once the output tile is done.
+ */
+class ossimOverviewSequencer::ResampleJob : public ossimJob
+{
+public:
+   ResampleJob(const ossimOverviewSequencer* sequencer,
+               ossimImageData* inputTile,
+               ossimImageData* outputTile)
+      :
+      ossimJob(),
+      m_sequencer(sequencer),
+      m_inputTile(inputTile),
+      m_outputTile(outputTile),
+      m_resampled(false)
+   {
+   }
+
+   /** @return true if the output tile holds resampled data. */
+   bool isResampled() const
+   {
+      return m_resampled;
+   }
+
+   ossimRefPtr<ossimImageData> getTile()
+   {
+      return m_outputTile;
+   }
+
+protected:
+   virtual void run()
+   {
+      m_resampled = m_inputTile.valid();
+      if ( m_resampled )
+      {
+         m_sequencer->resampleTile(m_inputTile.get(), m_outputTile.get(), ossimIpt(0, 0));
+         m_outputTile->validate();
+         m_inputTile = 0;
+      }
+   }
+
+private:
+   const ossimOverviewSequencer* m_sequencer;
+   ossimRefPtr<ossimImageData>   m_inputTile;
+   ossimRefPtr<ossimImageData>   m_outputTile;
+   bool                          m_resampled;
+};
+
 ossimOverviewSequencer::ossimOverviewSequencer()
    :
    ossimReferenced(),
@@ -52,7 +105,11 @@ ossimOverviewSequencer::ossimOverviewSequencer()
    m_scanForMinMaxNull(false),
    m_minValues(0),
    m_maxValues(0),
-   m_nulValues(0)
+   m_nulValues(0),
+   m_numberOfThreads(1),
+   m_readAheadTileNumber(0),
+   m_jobQueue(),
+   m_pendingJobs()
 {
    m_areaOfInterest.makeNan();
 
@@ -71,6 +128,10 @@ ossimOverviewSequencer::ossimOverviewSequencer()
 
 ossimOverviewSequencer::~ossimOverviewSequencer()
 {
+   // Jobs point back to this object.
+   clearPendingTiles();
+   m_jobQueue.reset();
+
    m_imageHandler = 0;
    m_maskFilter   = 0;
    m_maskWriter   = 0;
@@ -212,6 +273,7 @@ void ossimOverviewSequencer::initialize()
    updateTileDimensions();
 
    // Start on first tile.
+   clearPendingTiles();
    m_currentTileNumber = 0;
 
    // Use this factory constructor as it copies the min/max/nulls from the image handler.
@@ -300,6 +362,7 @@ void ossimOverviewSequencer::initialize()
 
 void ossimOverviewSequencer::setToStartOfSequence()
 {
+   clearPendingTiles();
    m_currentTileNumber = 0;
 }
 
@@ -310,9 +373,10 @@ ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTile()
       return ossimRefPtr<ossimImageData>();
    }
 
-   // Get the rectangle to grab from the image.
-   ossimIrect inputRect;
-   getInputTileRectangle(inputRect);
+   if ( m_numberOfThreads > 1 )
+   {
+      return getNextTileThreaded();
+   }
 
    // Get the output rectangle.
    ossimIrect outputRect;
@@ -324,6 +388,118 @@ ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTile()
    // Start with a blank tile.
    m_tile->makeBlank();
 
+   // Grab the input tile.
+   ossimRefPtr<ossimImageData> inputTile = readInputTile(m_currentTileNumber);
+   if ( inputTile.valid() )
+   {
+      if ( (inputTile->getDataObjectStatus() == OSSIM_PARTIAL) ||
+           (inputTile->getDataObjectStatus() == OSSIM_FULL ) )
+      {
+         // Resample the tile.
+         resampleTile(inputTile.get(), m_tile.get(), ossimIpt(0, 0));
+         m_tile->validate();
+         
+         // Scan the resampled pixels for bogus values to be masked out (if masking enabled)
+         if (m_maskWriter.valid())
+            m_maskWriter->generateMask(m_tile, m_sourceResLevel+1);
+      }
+   }
+
+   // Increment the tile index.
+   ++m_currentTileNumber;
+
+   return m_tile;
+}
+
+ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTileThreaded()
+{
+   ossimRefPtr<ossimImageData> result = 0;
+
+   if ( !m_jobQueue )
+   {
+      m_jobQueue = std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(), m_numberOfThreads);
+   }
+
+   // Keep two tiles per thread in flight.
+   const std::deque< std::shared_ptr<ResampleJob> >::size_type MAX_PENDING =
+      2 * m_numberOfThreads;
+   const ossim_uint32 TILES = getNumberOfTiles();
+
+   if ( m_readAheadTileNumber < m_currentTileNumber )
+   {
+      m_readAheadTileNumber = m_currentTileNumber;
+   }
+
+   while ( (m_pendingJobs.size() < MAX_PENDING) &&
+           (m_readAheadTileNumber < TILES) && !hasError() )
+   {
+      ossimIrect outputRect;
+      getOutputTileRectangle(m_readAheadTileNumber, outputRect);
+
+      ossimRefPtr<ossimImageData> outputTile = ossimImageDataFactory::instance()->
+         create( 0, m_tile->getScalarType(), m_tile->getNumberOfBands(),
+                 m_tile->getWidth(), m_tile->getHeight() );
+      outputTile->setNullPix( m_tile->getNullPix(), m_tile->getNumberOfBands() );
+      outputTile->setMinPix( m_tile->getMinPix(), m_tile->getNumberOfBands() );
+      outputTile->setMaxPix( m_tile->getMaxPix(), m_tile->getNumberOfBands() );
+      outputTile->initialize();
+      outputTile->setImageRectangle(outputRect);
+      outputTile->makeBlank();
+
+      //---
+      // The source reuses its tile on the next read so the job works from a
+      // copy.  Tiles with nothing to resample get no input and stay blank.
+      //---
+      ossimRefPtr<ossimImageData> inputCopy = 0;
+      ossimRefPtr<ossimImageData> inputTile = readInputTile(m_readAheadTileNumber);
+      if ( inputTile.valid() &&
+           ( (inputTile->getDataObjectStatus() == OSSIM_PARTIAL) ||
+             (inputTile->getDataObjectStatus() == OSSIM_FULL ) ) )
+      {
+         inputCopy = ossimImageDataFactory::instance()->
+            create( 0, inputTile->getScalarType(), inputTile->getNumberOfBands(),
+                    inputTile->getWidth(), inputTile->getHeight() );
+         inputCopy->assign( inputTile.get() );
+      }
+
+      std::shared_ptr<ResampleJob> job =
+         std::make_shared<ResampleJob>(this, inputCopy.get(), outputTile.get());
+      m_pendingJobs.push_back(job);
+      m_jobQueue->getJobQueue()->add(job);
+
+      ++m_readAheadTileNumber;
+   }
+
+   if ( m_pendingJobs.size() )
+   {
+      std::shared_ptr<ResampleJob> job = m_pendingJobs.front();
+      m_pendingJobs.pop_front();
+      while ( !job->isFinished() )
+      {
+         m_jobQueue->waitAny();
+      }
+      
+      result = job->getTile();
+
+      // The mask writer accumulates in tile order so stays on this thread.
+      if ( m_maskWriter.valid() && job->isResampled() )
+      {
+         m_maskWriter->generateMask(result, m_sourceResLevel+1);
+      }
+   }
+
+   ++m_currentTileNumber;
+
+   return result;
+}
+
+ossimRefPtr<ossimImageData> ossimOverviewSequencer::readInputTile(ossim_uint32 tileNumber)
+{
+   // Get the rectangle to grab from the image.
+   ossimIrect inputRect;
+   getInputTileRectangle(tileNumber, inputRect);
+
    // Grab the input tile.
    ossimRefPtr<ossimImageData> inputTile;
    if (m_maskFilter.valid())
@@ -351,11 +527,12 @@ ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTile()
    {
       ossimNotify(ossimNotifyLevel_WARN)
          << "ossimOverviewSequencer::getNextTile  ERROR:"
-         << "\nError set reading tile:  " << m_currentTileNumber << std::endl;
+         << "\nError set reading tile:  " << tileNumber << std::endl;
       if ( inputTile.valid() )
       {
          inputTile->makeBlank();
       }
+      inputTile = 0;
    }
    else if ( inputTile.valid() )
    {
@@ -369,29 +546,17 @@ ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTile()
       }
       
       if ( ( m_histoMode != OSSIM_HISTO_MODE_UNKNOWN ) &&
-           ( (m_currentTileNumber % m_histoTileIndex) == 0 ) )
+           ( (tileNumber % m_histoTileIndex) == 0 ) )
       {
          if (traceDebug())
          {
             ossimNotify(ossimNotifyLevel_DEBUG)
                << "ossimOverviewSequencer::getNextTile DEBUG:"
-               << "\npopulating histogram for tile: " << m_currentTileNumber
+               << "\npopulating histogram for tile: " << tileNumber
                << "\n";
          }
          inputTile->populateHistogram(m_histogram);
       }
-      
-      if ( (inputTile->getDataObjectStatus() == OSSIM_PARTIAL) ||
-           (inputTile->getDataObjectStatus() == OSSIM_FULL ) )
-      {
-         // Resample the tile.
-         resampleTile(inputTile.get());
-         m_tile->validate();
-         
-         // Scan the resampled pixels for bogus values to be masked out (if masking enabled)
-         if (m_maskWriter.valid())
-            m_maskWriter->generateMask(m_tile, m_sourceResLevel+1);
-      }
    }
    else
    {
@@ -401,10 +566,17 @@ ossimRefPtr<ossimImageData> ossimOverviewSequencer::getNextTile()
          << "\nRes level:  " << m_sourceResLevel << std::endl;
    }
 
-   // Increment the tile index.
-   ++m_currentTileNumber;
+   return inputTile;
+}
 
-   return m_tile;
+void ossimOverviewSequencer::clearPendingTiles()
+{
+   if ( m_jobQueue )
+   {
+      m_jobQueue->waitAll();
+   }
+   m_pendingJobs.clear();
+   m_readAheadTileNumber = 0;
 }
 
 void ossimOverviewSequencer::slaveProcessTiles()
@@ -434,6 +606,22 @@ void ossimOverviewSequencer::setResampleType(
    m_resampleType = resampleType;
 }
 
+void ossimOverviewSequencer::setNumberOfThreads(ossim_uint32 threads)
+{
+   threads = std::max<ossim_uint32>(threads, 1);
+   if ( threads != m_numberOfThreads )
+   {
+      clearPendingTiles();
+      m_jobQueue.reset();
+      m_numberOfThreads = threads;
+   }
+}
+
+ossim_uint32 ossimOverviewSequencer::getNumberOfThreads() const
+{
+   return m_numberOfThreads;
+}
+
 void ossimOverviewSequencer::setScanForMinMax(bool flag)
 {
    m_scanForMinMax  = flag;
@@ -772,10 +960,16 @@ bool ossimOverviewSequencer::writeOmdFile(const std::string& file)
 }
 
 void ossimOverviewSequencer::getInputTileRectangle(ossimIrect& inputRect) const
+{
+   getInputTileRectangle(m_currentTileNumber, inputRect);
+}
+
+void ossimOverviewSequencer::getInputTileRectangle(ossim_uint32 tileNumber,
+                                                   ossimIrect& inputRect) const
 {
    if (!m_imageHandler) return;
    
-   getOutputTileRectangle(inputRect);
+   getOutputTileRectangle(tileNumber, inputRect);
    inputRect = inputRect * m_decimationFactor;
 
 #if 0
@@ -790,10 +984,16 @@ void ossimOverviewSequencer::getInputTileRectangle(ossimIrect& inputRect) const
 
 void ossimOverviewSequencer::getOutputTileRectangle(
    ossimIrect& outputRect) const
+{
+   getOutputTileRectangle(m_currentTileNumber, outputRect);
+}
+
+void ossimOverviewSequencer::getOutputTileRectangle(
+   ossim_uint32 tileNumber, ossimIrect& outputRect) const
 {
    // Get the row and column.
-   ossim_int32 row = m_currentTileNumber / m_numberOfTilesHorizontal;
-   ossim_int32 col = m_currentTileNumber % m_numberOfTilesHorizontal;
+   ossim_int32 row = tileNumber / m_numberOfTilesHorizontal;
+   ossim_int32 col = tileNumber % m_numberOfTilesHorizontal;
 
    ossimIpt pt;
 
@@ -847,13 +1047,15 @@ void ossimOverviewSequencer::updateTileDimensions()
    }
 }
 
-void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile)
+void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile,
+                                          ossimImageData* outputTile,
+                                          const ossimIpt& outputOffset) const
 {
-   switch(m_imageHandler->getOutputScalarType())
+   switch(inputTile->getScalarType())
    {
       case OSSIM_UINT8:
       {
-         resampleTile(inputTile, ossim_uint8(0));
+         resampleTile(inputTile, outputTile, outputOffset, ossim_uint8(0));
          break;
       }
 
@@ -864,37 +1066,37 @@ void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile)
       case OSSIM_USHORT15:
       case OSSIM_UINT16:
       {
-         resampleTile(inputTile, ossim_uint16(0));
+         resampleTile(inputTile, outputTile, outputOffset, ossim_uint16(0));
          break;
       }
       case OSSIM_SINT16:
       {
-         resampleTile(inputTile, ossim_sint16(0));
+         resampleTile(inputTile, outputTile, outputOffset, ossim_sint16(0));
          break;
       }
 
       case OSSIM_UINT32:
       {
-         resampleTile(inputTile, ossim_uint32(0));
+         resampleTile(inputTile, outputTile, outputOffset, ossim_uint32(0));
          break;
       }
          
       case OSSIM_SINT32:
       {
-         resampleTile(inputTile, ossim_sint32(0));
+         resampleTile(inputTile, outputTile, outputOffset, ossim_sint32(0));
          break;
       }
          
       case OSSIM_FLOAT32:
       {
-         resampleTile(inputTile, ossim_float32(0.0));
+         resampleTile(inputTile, outputTile, outputOffset, ossim_float32(0.0));
          break;
       }
          
       case OSSIM_NORMALIZED_DOUBLE:
       case OSSIM_FLOAT64:
       {
-         resampleTile(inputTile, ossim_float64(0.0));
+         resampleTile(inputTile, outputTile, outputOffset, ossim_float64(0.0));
          break;
       }
       default:
@@ -903,28 +1105,38 @@ void ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile)
             << std::endl;
          return;
          
-   } // End of "switch(m_imageHandler->getOutputScalarType())"
+   } // End of "switch(inputTile->getScalarType())"
 }
 
 template <class T>
-void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile, T  /* dummy */ )
+void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile,
+                                           ossimImageData* outputTile,
+                                           const ossimIpt& outputOffset,
+                                           T  /* dummy */ ) const
 {
 #if 0
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
          << "ossimOverviewSequencer::resampleTile DEBUG: "
-         << "\ncurrent tile: " << m_currentTileNumber
          << "\ninput tile:\n" << *inputTile
-         << "output tile:\n" << *(m_tile.get())
+         << "output tile:\n" << *outputTile
          << endl;
    }
 #endif
    
-   const ossim_uint32 BANDS = m_tile->getNumberOfBands();
-   const ossim_uint32 LINES = m_tile->getHeight();
-   const ossim_uint32 SAMPS = m_tile->getWidth();
-   const ossim_uint32 INPUT_WIDTH = m_decimationFactor*m_tileSize.x;
+   const ossim_uint32 BANDS = outputTile->getNumberOfBands();
+   const ossim_uint32 INPUT_WIDTH  = inputTile->getWidth();
+   const ossim_uint32 OUTPUT_WIDTH = outputTile->getWidth();
+
+   // Decimated input clipped to the output tile.
+   const ossim_uint32 LINES = std::min<ossim_uint32>(
+      inputTile->getHeight() / m_decimationFactor,
+      outputTile->getHeight() - outputOffset.y );
+   const ossim_uint32 SAMPS = std::min<ossim_uint32>(
+      INPUT_WIDTH / m_decimationFactor,
+      OUTPUT_WIDTH - outputOffset.x );
+   const ossim_uint32 OUTPUT_OFFSET = outputOffset.y * OUTPUT_WIDTH + outputOffset.x;
    
    T nullPixel              = 0;
    ossim_float64 weight     = 0.0;
@@ -936,7 +1148,7 @@ void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile, T  /
       for (ossim_uint32 band=0; band<BANDS; ++band)
       {
          const T* s = static_cast<const T*>(inputTile->getBuf(band)); // source
-         T*       d = static_cast<T*>(m_tile->getBuf(band)); // destination
+         T*       d = static_cast<T*>(outputTile->getBuf(band)) + OUTPUT_OFFSET; // destination
          
          nullPixel = static_cast<T>(inputTile->getNullPix(band));
          weight = 0.0;
@@ -962,7 +1174,7 @@ void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile, T  /
                
             } // End of sample loop.
             
-            d += m_tileSize.x;
+            d += OUTPUT_WIDTH;
             
          } // End of line loop.
          
@@ -981,7 +1193,7 @@ void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile, T  /
       for (ossim_uint32 band=0; band<BANDS; ++band)
       {
          const T* s = static_cast<const T*>(inputTile->getBuf(band)); // source
-         T*       d = static_cast<T*>(m_tile->getBuf(band)); // destination
+         T*       d = static_cast<T*>(outputTile->getBuf(band)) + OUTPUT_OFFSET; // destination
 
          nullPixel = static_cast<T>(inputTile->getNullPix(band));
          weight = 0.0;
@@ -1040,7 +1252,7 @@ void  ossimOverviewSequencer::resampleTile(const ossimImageData* inputTile, T  /
             
             } // End of sample loop.
             
-            d += m_tileSize.x;
+            d += OUTPUT_WIDTH;
             
          } // End of line loop.
          
@@ -165,3 +165,8 @@ bool ossimQuickbirdNitfTileSource::loadState(const ossimKeywordlist& kwl,
 {
    return ossimNitfTileSource::loadState( kwl, prefix );
 }
+
+bool ossimQuickbirdNitfTileSource::canDecodeConcurrently() const
+{
+   return true;
+}
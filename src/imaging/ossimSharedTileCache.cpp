@@ -0,0 +1,488 @@
+//******************************************************************
+//
+// License:  MIT
+// 
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Tile cache shared by processes through a shared memory
+// mapping.
+//
+//*******************************************************************
+#include <ossim/imaging/ossimSharedTileCache.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/base/ossimTrace.h>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <ostream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static ossimTrace traceDebug("ossimSharedTileCache:debug");
+
+static const ossim_uint64 MAGIC            = 0x6f7373696d544331ULL; // "ossimTC1"
+static const ossim_uint32 VERSION          = 1;
+static const ossim_uint64 HEADER_SIZE      = 64;
+static const ossim_uint64 SLOT_HEADER_SIZE = 64;
+
+/** Slots looked at for a key, starting at its hash. */
+static const ossim_uint32 PROBES = 8;
+
+struct ossimSharedTileCache::Header
+{
+   ossim_uint64              m_magic;
+   ossim_uint32              m_version;
+   ossim_uint32              m_slotCount;
+   ossim_uint64              m_slotSize;
+   std::atomic<ossim_uint64> m_hits;
+   std::atomic<ossim_uint64> m_misses;
+   std::atomic<ossim_uint64> m_inserts;
+   std::atomic<ossim_uint64> m_evictions;
+};
+
+struct ossimSharedTileCache::Slot
+{
+   std::atomic<ossim_uint32> m_sequence;   // odd while being written
+   std::atomic<ossim_uint32> m_referenced; // second chance bit
+   ossim_uint64              m_sourceId;
+   ossim_int32               m_x;
+   ossim_int32               m_y;
+   ossim_uint32              m_width;
+   ossim_uint32              m_height;
+   ossim_uint32              m_resLevel;
+   ossim_uint32              m_bands;
+   ossim_uint32              m_scalar;
+   ossim_uint32              m_status;
+   ossim_uint64              m_size;       // 0 when empty
+
+   ossim_uint8* data() { return reinterpret_cast<ossim_uint8*>(this) + SLOT_HEADER_SIZE; }
+};
+
+static_assert(sizeof(std::atomic<ossim_uint64>) == sizeof(ossim_uint64),
+              "shared tile cache needs address free atomics");
+
+ossimSharedTileCache* ossimSharedTileCache::instance()
+{
+   static ossimSharedTileCache cache;
+   return &cache;
+}
+
+ossimSharedTileCache::ossimSharedTileCache()
+   :
+   m_mutex(),
+   m_map(0),
+   m_mapSize(0),
+   m_header(0),
+   m_slotStride(0)
+{
+   static_assert(sizeof(Header) <= HEADER_SIZE, "header too large");
+   static_assert(sizeof(Slot) <= SLOT_HEADER_SIZE, "slot header too large");
+}
+
+ossimSharedTileCache::~ossimSharedTileCache()
+{
+   close();
+}
+
+bool ossimSharedTileCache::open(ossim_uint64 sizeInBytes,
+                                ossim_uint32 slotSizeInBytes,
+                                const ossimFilename& file)
+{
+   close();
+
+#if defined(_WIN32)
+   return false;
+#else
+   std::lock_guard<std::mutex> lock(m_mutex);
+
+   // Slot data is kept 64 byte aligned.
+   const ossim_uint64 SLOT_SIZE   = ((ossim_uint64)slotSizeInBytes + 63) & ~(ossim_uint64)63;
+   const ossim_uint64 STRIDE      = SLOT_HEADER_SIZE + SLOT_SIZE;
+   const ossim_uint64 SLOT_COUNT  = (sizeInBytes > HEADER_SIZE) ?
+      (sizeInBytes - HEADER_SIZE) / STRIDE : 0;
+   if ( !SLOT_SIZE || !SLOT_COUNT || ( SLOT_COUNT > 0xffffffffULL ) )
+   {
+      return false;
+   }
+   const ossim_uint64 MAP_SIZE = HEADER_SIZE + SLOT_COUNT * STRIDE;
+
+   bool initialize = true;
+   void* map = MAP_FAILED;
+   if ( file.empty() )
+   {
+      // Shared with children forked after this.  Anonymous maps start zeroed.
+      map = mmap(0, MAP_SIZE, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+      if ( map != MAP_FAILED )
+      {
+         format(static_cast<ossim_uint8*>(map), SLOT_COUNT, SLOT_SIZE, STRIDE);
+      }
+   }
+   else
+   {
+      int fd = ::open(file.c_str(), O_RDWR|O_CREAT, 0666);
+      if ( fd >= 0 )
+      {
+         // Only one process sets the file up.
+         flock(fd, LOCK_EX);
+         struct stat sbuf;
+         if ( ( fstat(fd, &sbuf) == 0 ) && ( (ossim_uint64)sbuf.st_size == MAP_SIZE ) )
+         {
+            initialize = false;
+         }
+         else if ( ftruncate(fd, (off_t)MAP_SIZE) != 0 )
+         {
+            flock(fd, LOCK_UN);
+            ::close(fd);
+            fd = -1;
+         }
+
+         if ( fd >= 0 )
+         {
+            map = mmap(0, MAP_SIZE, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+            if ( ( map != MAP_FAILED ) && !initialize )
+            {
+               const Header* h = static_cast<const Header*>(map);
+               initialize = ( ( h->m_magic != MAGIC ) || ( h->m_version != VERSION ) ||
+                              ( h->m_slotCount != SLOT_COUNT ) ||
+                              ( h->m_slotSize != SLOT_SIZE ) );
+            }
+            if ( ( map != MAP_FAILED ) && initialize )
+            {
+               memset(map, 0, MAP_SIZE);
+               format(static_cast<ossim_uint8*>(map), SLOT_COUNT, SLOT_SIZE, STRIDE);
+            }
+            flock(fd, LOCK_UN);
+            ::close(fd); // The mapping stays.
+         }
+      }
+   }
+
+   if ( map == MAP_FAILED )
+   {
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_WARN)
+            << "ossimSharedTileCache::open WARNING: could not map "
+            << MAP_SIZE << " bytes " << file << std::endl;
+      }
+      return false;
+   }
+
+   m_map        = static_cast<ossim_uint8*>(map);
+   m_mapSize    = MAP_SIZE;
+   m_slotStride = STRIDE;
+   m_header     = reinterpret_cast<Header*>(m_map);
+
+   if ( traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "ossimSharedTileCache::open DEBUG: slots: " << SLOT_COUNT
+         << " slot_size: " << SLOT_SIZE << " file: " << file << std::endl;
+   }
+
+   return true;
+#endif
+}
+
+void ossimSharedTileCache::format(ossim_uint8* map,
+                                  ossim_uint64 slotCount,
+                                  ossim_uint64 slotSize,
+                                  ossim_uint64 stride)
+{
+   // Memory is zero so this only constructs the atomics in place.
+   Header* header = new (map) Header();
+   header->m_magic     = MAGIC;
+   header->m_version   = VERSION;
+   header->m_slotCount = (ossim_uint32)slotCount;
+   header->m_slotSize  = slotSize;
+   header->m_hits      = 0;
+   header->m_misses    = 0;
+   header->m_inserts   = 0;
+   header->m_evictions = 0;
+   for ( ossim_uint64 i = 0; i < slotCount; ++i )
+   {
+      Slot* slot = new (map + HEADER_SIZE + i * stride) Slot();
+      slot->m_sequence   = 0;
+      slot->m_referenced = 0;
+      slot->m_size       = 0;
+   }
+}
+
+bool ossimSharedTileCache::openFromPreferences()
+{
+   ossimString size = ossimPreferences::instance()->
+      findPreference("ossim.imaging.shared_tile_cache.size");
+   if ( size.empty() || !size.toUInt64() )
+   {
+      return false;
+   }
+
+   ossim_uint32 slotSize = 512 * 1024;
+   ossimString value = ossimPreferences::instance()->
+      findPreference("ossim.imaging.shared_tile_cache.slot_size");
+   if ( value.size() )
+   {
+      slotSize = value.toUInt32() * 1024;
+   }
+
+   ossimFilename file = ossimPreferences::instance()->
+      findPreference("ossim.imaging.shared_tile_cache.file");
+
+   return open(size.toUInt64() * 1024 * 1024, slotSize, file.expand());
+}
+
+void ossimSharedTileCache::close()
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+#if !defined(_WIN32)
+   if ( m_map )
+   {
+      munmap(m_map, m_mapSize);
+   }
+#endif
+   m_map        = 0;
+   m_mapSize    = 0;
+   m_header     = 0;
+   m_slotStride = 0;
+}
+
+bool ossimSharedTileCache::isOpen() const
+{
+   return ( m_header != 0 );
+}
+
+bool ossimSharedTileCache::getTile(ossim_uint64 sourceId,
+                                   ossim_uint32 resLevel,
+                                   ossimImageData* tile)
+{
+   if ( !m_header || !tile || !tile->getBuf() )
+   {
+      return false;
+   }
+
+   const ossimIrect RECT    = tile->getImageRectangle();
+   const ossim_uint64 BYTES = tile->getSizeInBytes();
+   const ossim_uint32 START = (ossim_uint32)
+      ( hashKey(sourceId, resLevel, RECT.ul().x, RECT.ul().y) % m_header->m_slotCount );
+
+   for ( ossim_uint32 p = 0; p < PROBES; ++p )
+   {
+      Slot* slot = getSlot( (START + p) % m_header->m_slotCount );
+      const ossim_uint32 SEQUENCE = slot->m_sequence.load(std::memory_order_acquire);
+      if ( SEQUENCE & 1 )
+      {
+         continue; // Being written.
+      }
+      if ( ( slot->m_size != BYTES ) ||
+           ( slot->m_sourceId != sourceId ) ||
+           ( slot->m_resLevel != resLevel ) ||
+           ( slot->m_x != RECT.ul().x ) ||
+           ( slot->m_y != RECT.ul().y ) ||
+           ( slot->m_width != RECT.width() ) ||
+           ( slot->m_height != RECT.height() ) ||
+           ( slot->m_bands != tile->getNumberOfBands() ) ||
+           ( slot->m_scalar != (ossim_uint32)tile->getScalarType() ) )
+      {
+         continue;
+      }
+      const ossim_uint32 STATUS = slot->m_status;
+      memcpy(tile->getBuf(), slot->data(), BYTES);
+
+      // A writer that took the slot meanwhile changed the sequence.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ( slot->m_sequence.load(std::memory_order_relaxed) != SEQUENCE )
+      {
+         continue;
+      }
+
+      slot->m_referenced.store(1, std::memory_order_relaxed);
+      tile->setDataObjectStatus( (ossimDataObjectStatus)STATUS );
+      m_header->m_hits.fetch_add(1, std::memory_order_relaxed);
+      return true;
+   }
+
+   m_header->m_misses.fetch_add(1, std::memory_order_relaxed);
+   return false;
+}
+
+bool ossimSharedTileCache::addTile(ossim_uint64 sourceId,
+                                   ossim_uint32 resLevel,
+                                   const ossimImageData* tile)
+{
+   if ( !m_header || !tile || !tile->getBuf() )
+   {
+      return false;
+   }
+
+   const ossim_uint64 BYTES = tile->getSizeInBytes();
+   if ( !BYTES || ( BYTES > m_header->m_slotSize ) )
+   {
+      return false;
+   }
+
+   const ossimIrect RECT    = tile->getImageRectangle();
+   const ossim_uint32 START = (ossim_uint32)
+      ( hashKey(sourceId, resLevel, RECT.ul().x, RECT.ul().y) % m_header->m_slotCount );
+
+   //---
+   // Take an empty slot in the run, else the first one not used since the
+   // last pass (second chance).  Give up if already cached.
+   //---
+   Slot* victim = 0;
+   for ( ossim_uint32 p = 0; p < PROBES; ++p )
+   {
+      Slot* slot = getSlot( (START + p) % m_header->m_slotCount );
+      if ( slot->m_sequence.load(std::memory_order_acquire) & 1 )
+      {
+         continue;
+      }
+      if ( slot->m_size == 0 )
+      {
+         if ( !victim )
+         {
+            victim = slot;
+         }
+      }
+      else if ( ( slot->m_sourceId == sourceId ) && ( slot->m_resLevel == resLevel ) &&
+                ( slot->m_x == RECT.ul().x ) && ( slot->m_y == RECT.ul().y ) )
+      {
+         return false;
+      }
+   }
+   for ( ossim_uint32 pass = 0; !victim && ( pass < 2 ); ++pass )
+   {
+      for ( ossim_uint32 p = 0; !victim && ( p < PROBES ); ++p )
+      {
+         Slot* slot = getSlot( (START + p) % m_header->m_slotCount );
+         if ( slot->m_referenced.exchange(0, std::memory_order_relaxed) == 0 )
+         {
+            victim = slot;
+         }
+      }
+   }
+   if ( !victim )
+   {
+      return false;
+   }
+
+   // Claim the slot; another writer may have beaten us to it.
+   ossim_uint32 sequence = victim->m_sequence.load(std::memory_order_acquire);
+   if ( ( sequence & 1 ) ||
+        !victim->m_sequence.compare_exchange_strong(sequence, sequence + 1,
+                                                    std::memory_order_acq_rel) )
+   {
+      return false;
+   }
+
+   const bool EVICTED = ( victim->m_size != 0 );
+   victim->m_sourceId = sourceId;
+   victim->m_x        = RECT.ul().x;
+   victim->m_y        = RECT.ul().y;
+   victim->m_width    = RECT.width();
+   victim->m_height   = RECT.height();
+   victim->m_resLevel = resLevel;
+   victim->m_bands    = tile->getNumberOfBands();
+   victim->m_scalar   = (ossim_uint32)tile->getScalarType();
+   victim->m_status   = (ossim_uint32)tile->getDataObjectStatus();
+   victim->m_size     = BYTES;
+   memcpy(victim->data(), tile->getBuf(), BYTES);
+   victim->m_referenced.store(1, std::memory_order_relaxed);
+   victim->m_sequence.store(sequence + 2, std::memory_order_release);
+
+   m_header->m_inserts.fetch_add(1, std::memory_order_relaxed);
+   if ( EVICTED )
+   {
+      m_header->m_evictions.fetch_add(1, std::memory_order_relaxed);
+   }
+   return true;
+}
+
+void ossimSharedTileCache::flush()
+{
+   if ( !m_header )
+   {
+      return;
+   }
+   for ( ossim_uint32 i = 0; i < m_header->m_slotCount; ++i )
+   {
+      Slot* slot = getSlot(i);
+      ossim_uint32 sequence = slot->m_sequence.load(std::memory_order_acquire);
+      if ( !( sequence & 1 ) &&
+           slot->m_sequence.compare_exchange_strong(sequence, sequence + 1,
+                                                    std::memory_order_acq_rel) )
+      {
+         slot->m_size = 0;
+         slot->m_referenced.store(0, std::memory_order_relaxed);
+         slot->m_sequence.store(sequence + 2, std::memory_order_release);
+      }
+   }
+}
+
+ossim_uint64 ossimSharedTileCache::getNumberOfHits() const
+{
+   return m_header ? m_header->m_hits.load() : 0;
+}
+
+ossim_uint64 ossimSharedTileCache::getNumberOfMisses() const
+{
+   return m_header ? m_header->m_misses.load() : 0;
+}
+
+ossim_uint64 ossimSharedTileCache::getNumberOfInserts() const
+{
+   return m_header ? m_header->m_inserts.load() : 0;
+}
+
+ossim_uint64 ossimSharedTileCache::getNumberOfEvictions() const
+{
+   return m_header ? m_header->m_evictions.load() : 0;
+}
+
+ossim_uint32 ossimSharedTileCache::getNumberOfSlots() const
+{
+   return m_header ? m_header->m_slotCount : 0;
+}
+
+std::ostream& ossimSharedTileCache::print(std::ostream& out) const
+{
+   const ossim_uint64 HITS   = getNumberOfHits();
+   const ossim_uint64 MISSES = getNumberOfMisses();
+   out << "shared_tile_cache.slots:      " << getNumberOfSlots()
+       << "\nshared_tile_cache.hits:       " << HITS
+       << "\nshared_tile_cache.misses:     " << MISSES
+       << "\nshared_tile_cache.hit_rate:   "
+       << ( (HITS + MISSES) ? (double)HITS / (double)(HITS + MISSES) : 0.0 )
+       << "\nshared_tile_cache.inserts:    " << getNumberOfInserts()
+       << "\nshared_tile_cache.evictions:  " << getNumberOfEvictions()
+       << "\n";
+   return out;
+}
+
+ossimSharedTileCache::Slot* ossimSharedTileCache::getSlot(ossim_uint32 i) const
+{
+   return reinterpret_cast<Slot*>(m_map + HEADER_SIZE + i * m_slotStride);
+}
+
+ossim_uint64 ossimSharedTileCache::hashKey(ossim_uint64 sourceId,
+                                           ossim_uint32 resLevel,
+                                           ossim_int32 x,
+                                           ossim_int32 y)
+{
+   // splitmix64 finalizer over the key fields.
+   ossim_uint64 h = sourceId;
+   h ^= ( (ossim_uint64)resLevel << 56 ) ^ ( (ossim_uint64)(ossim_uint32)y << 28 ) ^
+      (ossim_uint64)(ossim_uint32)x;
+   h += 0x9e3779b97f4a7c15ULL;
+   h = ( h ^ ( h >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+   h = ( h ^ ( h >> 27 ) ) * 0x94d049bb133111ebULL;
+   return h ^ ( h >> 31 );
+}
@@ -12,6 +12,9 @@
 // $Id$
 
 #include <ossim/imaging/ossimTiffOverviewBuilder.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
 #include <ossim/parallel/ossimMpi.h>
 #include <ossim/parallel/ossimMpiMasterOverviewSequencer.h>
 #include <ossim/parallel/ossimMpiSlaveOverviewSequencer.h>
@@ -19,10 +22,12 @@
 #include <ossim/base/ossimErrorCodes.h>
 #include <ossim/base/ossimErrorContext.h>
 #include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimStdOutProgress.h>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimIrect.h>
 #include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimKeywordNames.h>
 #include <ossim/base/ossimScalarTypeLut.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/imaging/ossimBitMaskTileSource.h>
@@ -30,6 +35,7 @@
 #include <ossim/imaging/ossimImageDataFactory.h>
 #include <ossim/imaging/ossimImageGeometry.h>
 #include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimOverviewSequencer.h>
 #include <ossim/imaging/ossimTiffTileSource.h>
 #include <ossim/projection/ossimMapProjection.h>
 #include <ossim/projection/ossimMapProjectionInfo.h>
@@ -37,6 +43,9 @@
 #include <ossim/support_data/ossimGeoTiff.h>
 
 #include <xtiffio.h>
+#if OSSIM_HAS_LIBZ
+#  include <zlib.h>
+#endif
 #include <algorithm> /* for std::fill */
 #include <sstream>
 using namespace std;
@@ -52,10 +61,121 @@ static const char COPY_ALL_KW[]           = "copy_all_flag";
 static const char TEMP_EXTENSION[] = "temp_extension";
 static const char INTERNAL_OVERVIEWS_KW[] = "internal_overviews_flag";
 
+// Default level memory budget in megabytes when the preference is not set.
+static const ossim_uint64 DEFAULT_LEVEL_MEMORY_BUDGET_MB = 256;
+
 #ifdef OSSIM_ID_ENABLED
 static const char OSSIM_ID[] = "$Id: ossimTiffOverviewBuilder.cpp 22362 2013-08-07 20:23:22Z dburken $";
 #endif
 
+/**
+ * Decimates a tile into its quadrant of a next level tile and deflates its
+ * bands.  Either step is optional; the tile is written by the calling thread.
+ */
+class ossimTiffOverviewBuilder::TileJob : public ossimJob
+{
+public:
+   TileJob(ossimImageData* tile,
+           ossim_uint32 x,
+           ossim_uint32 y,
+           bool deflate,
+           const ossimOverviewSequencer* resampler,
+           ossimImageData* nextLevelTile,
+           const ossimIpt& nextLevelOffset)
+      :
+      ossimJob(),
+      m_tile(tile),
+      m_x(x),
+      m_y(y),
+      m_deflate(deflate),
+      m_resampler(resampler),
+      m_nextLevelTile(nextLevelTile),
+      m_nextLevelOffset(nextLevelOffset),
+      m_bands(0),
+      m_deflated(false)
+   {
+   }
+
+   /** @return The tile, null if the null data buffer is to be written. */
+   const ossimImageData* getTile() const
+   {
+      return m_tile.get();
+   }
+
+   ossim_uint32 getX() const
+   {
+      return m_x;
+   }
+
+   ossim_uint32 getY() const
+   {
+      return m_y;
+   }
+
+   /** @return true if getBand holds the deflated bands. */
+   bool isDeflated() const
+   {
+      return m_deflated;
+   }
+
+   const std::vector<ossim_uint8>& getBand(ossim_uint32 band) const
+   {
+      return m_bands[band];
+   }
+
+protected:
+   virtual void run()
+   {
+      if ( !m_tile.valid() )
+      {
+         return;
+      }
+      
+      if ( m_nextLevelTile.valid() )
+      {
+         m_resampler->resampleTile(m_tile.get(), m_nextLevelTile.get(), m_nextLevelOffset);
+         m_nextLevelTile = 0;
+      }
+
+#if OSSIM_HAS_LIBZ
+      if ( m_deflate )
+      {
+         const ossim_uint32 BANDS = m_tile->getNumberOfBands();
+         const uLong BYTES = m_tile->getSizePerBandInBytes();
+         m_bands.resize(BANDS);
+         m_deflated = true;
+         for ( ossim_uint32 band = 0; m_deflated && (band < BANDS); ++band )
+         {
+            uLongf size = compressBound(BYTES);
+            m_bands[band].resize(size);
+            m_deflated = ( compress2( &(m_bands[band].front()),
+                                      &size,
+                                      static_cast<const Bytef*>(m_tile->getBuf(band)),
+                                      BYTES,
+                                      Z_DEFAULT_COMPRESSION ) == Z_OK );
+            m_bands[band].resize(size);
+         }
+         if ( !m_deflated )
+         {
+            // The writer falls back to TIFFWriteTile.
+            m_bands.clear();
+         }
+      }
+#endif
+   }
+
+private:
+   ossimRefPtr<ossimImageData>             m_tile;
+   ossim_uint32                            m_x;
+   ossim_uint32                            m_y;
+   bool                                    m_deflate;
+   const ossimOverviewSequencer*           m_resampler;
+   ossimRefPtr<ossimImageData>             m_nextLevelTile;
+   ossimIpt                                m_nextLevelOffset;
+   std::vector< std::vector<ossim_uint8> > m_bands;
+   bool                                    m_deflated;
+};
+
 
 //*******************************************************************
 // Public Constructor:
@@ -77,8 +197,26 @@ ossimTiffOverviewBuilder::ossimTiffOverviewBuilder()
       m_nullPixelValues(),
       m_copyAllFlag(false),
       m_outputTileSizeSetFlag(false),
-      m_internalOverviewsFlag(false)
+      m_internalOverviewsFlag(false),
+      m_numberOfThreads(ossim::getNumberOfThreads()),
+      m_levelMemoryBudget(DEFAULT_LEVEL_MEMORY_BUDGET_MB * 1024 * 1024),
+      m_levelTiles(0),
+      m_levelRect(),
+      m_nextLevelTiles(0),
+      m_nextLevelRect(),
+      m_nextLevelTilesWide(0),
+      m_levelResampler(0),
+      m_deflateTiles(false),
+      m_queuedTiles(),
+      m_jobQueue()
 {
+   ossimString budget = ossimPreferences::instance()->
+      findPreference("ossim.imaging.tiff_overview_builder.level_memory_budget");
+   if ( budget.size() )
+   {
+      m_levelMemoryBudget = budget.toUInt64() * 1024 * 1024;
+   }
+
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -97,6 +235,9 @@ ossimTiffOverviewBuilder::ossimTiffOverviewBuilder()
 
 ossimTiffOverviewBuilder::~ossimTiffOverviewBuilder()
 {
+   // Jobs point to m_levelResampler.
+   clearQueuedTiles();
+   m_jobQueue.reset();
 }
 
 void ossimTiffOverviewBuilder::setResampleType(
@@ -105,6 +246,16 @@ void ossimTiffOverviewBuilder::setResampleType(
    m_resampleType = resampleType;
 }
 
+void ossimTiffOverviewBuilder::setNumberOfThreads(ossim_uint32 threads)
+{
+   m_numberOfThreads = std::max<ossim_uint32>(threads, 1);
+}
+
+ossim_uint32 ossimTiffOverviewBuilder::getNumberOfThreads() const
+{
+   return m_numberOfThreads;
+}
+
 bool ossimTiffOverviewBuilder::buildOverview(const ossimFilename& overview_file, bool copy_all)
 {
    if (traceDebug())
@@ -250,6 +401,25 @@ bool ossimTiffOverviewBuilder::execute()
          return false;
       } 
 
+      //---
+      // Tiles are read and written on this thread.  Workers decimate them into
+      // the next level and, for deflate, compress them for TIFFWriteRawTile.
+      //---
+      clearQueuedTiles();
+      if ( ossimMpi::instance()->getNumberOfProcessors() > 1 )
+      {
+         m_numberOfThreads = 1;
+      }
+      m_jobQueue = std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(), m_numberOfThreads);
+      m_levelResampler = new ossimOverviewSequencer();
+      m_levelResampler->setResampleType(m_resampleType);
+#if OSSIM_HAS_LIBZ
+      m_deflateTiles = ( ( m_tiffCompressType == COMPRESSION_DEFLATE ) ||
+                         ( m_tiffCompressType == COMPRESSION_ADOBE_DEFLATE ) ) &&
+         !TIFFIsByteSwapped(tif);
+#endif
+
       //---
       // Check for a listeners.  If the list is empty, add a standard out
       // listener so that command line apps like img2rr will get some progress.
@@ -271,6 +441,7 @@ bool ossimTiffOverviewBuilder::execute()
                << __FILE__ << " " << __LINE__
                << "\nError copying image!" << std::endl;
 
+            clearQueuedTiles();
             closeTiff(tif);
             if (progressListener)
             {
@@ -291,6 +462,7 @@ bool ossimTiffOverviewBuilder::execute()
 
       if (needsAborting())
       {
+         clearQueuedTiles();
          closeTiff(tif);
          if (progressListener)
          {
@@ -316,52 +488,63 @@ bool ossimTiffOverviewBuilder::execute()
       ossimMpi::instance()->barrier();
       
       ossimRefPtr<ossimImageHandler> ih = 0;
+      bool levelWritten = false;
 
-      //---
-      // If we copied r0 to the overview file use it instead of the
-      // original image handler as it is probably faster.
-      //---
-      if ( !copyR0() && (i <= m_imageHandler->getNumberOfDecimationLevels()) ) 
+      if ( m_levelTiles.size() )
       {
-         ih = m_imageHandler;
+         // Decimated into memory while the previous level was written.
+         levelWritten = writeRnFromMemory(tif, i);
       }
       else
       {
-         // We know we're a tiff so don't use the factory.
-         ih = new ossimTiffTileSource;
-         if ( ih->open(outputFileTemp) == false )
+         //---
+         // If we copied r0 to the overview file use it instead of the
+         // original image handler as it is probably faster.
+         //---
+         if ( !copyR0() && (i <= m_imageHandler->getNumberOfDecimationLevels()) ) 
          {
-            ih = 0;
+            ih = m_imageHandler;
+         }
+         else
+         {
+            // We know we're a tiff so don't use the factory.
+            ih = new ossimTiffTileSource;
+            if ( ih->open(outputFileTemp) == false )
+            {
+               ih = 0;
             
-            // Set the error...
-            setErrorStatus();
-            ossimNotify(ossimNotifyLevel_WARN)
-               << __FILE__ << " " << __LINE__ << " " << MODULE
-               << "\nCannot open file: " << outputFileTemp << std::endl;
+               // Set the error...
+               setErrorStatus();
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << __FILE__ << " " << __LINE__ << " " << MODULE
+                  << "\nCannot open file: " << outputFileTemp << std::endl;
             
-            return false;
-         }
+               return false;
+            }
 
-         //---
-         // Since the overview file is being opened here, need to set its handler's starting res
-         // level where the original image file left off. This is usually R1 since the original
-         // file only has R0, but the original file may have more than R0:
-         //---
-         if ( !copyR0() &&  !buildInternalOverviews() )
-         {
-            ih->setStartingResLevel( m_imageHandler->getNumberOfDecimationLevels());
+            //---
+            // Since the overview file is being opened here, need to set its handler's starting res
+            // level where the original image file left off. This is usually R1 since the original
+            // file only has R0, but the original file may have more than R0:
+            //---
+            if ( !copyR0() &&  !buildInternalOverviews() )
+            {
+               ih->setStartingResLevel( m_imageHandler->getNumberOfDecimationLevels());
+            }
          }
-      }
       
-      // If mask is to be generated, need to notify both the writer and the reader of new 
-      // input source:
-      if (m_bitMaskSpec.getSize() > 0)
-      {
-         m_maskFilter->connectMyInputTo(0, ih.get());
-         m_maskWriter->connectMyInputTo(ih.get());
+         // If mask is to be generated, need to notify both the writer and the reader of new 
+         // input source:
+         if (m_bitMaskSpec.getSize() > 0)
+         {
+            m_maskFilter->connectMyInputTo(0, ih.get());
+            m_maskWriter->connectMyInputTo(ih.get());
+         }
+
+         levelWritten = writeRn( ih.get(), tif, i, (i==startingResLevel) && !copyR0() );
       }
 
-      if ( !writeRn( ih.get(), tif, i, (i==startingResLevel) && !copyR0() ) )
+      if ( !levelWritten )
       {
          // Set the error...
          setErrorStatus();
@@ -369,8 +552,12 @@ bool ossimTiffOverviewBuilder::execute()
             << __FILE__ << " " << __LINE__ << " " << MODULE
             << "\nError creating reduced res set: " << i << std::endl;
 
-         ih->disconnect();
-         ih = 0;
+         clearQueuedTiles();
+         if ( ih.valid() )
+         {
+            ih->disconnect();
+            ih = 0;
+         }
          if (tif)
          {
             closeTiff(tif);
@@ -394,8 +581,12 @@ bool ossimTiffOverviewBuilder::execute()
       
       if (needsAborting())
       {
-         ih->disconnect();
-         ih = 0;
+         clearQueuedTiles();
+         if ( ih.valid() )
+         {
+            ih->disconnect();
+            ih = 0;
+         }
          if (tif)
          {
             closeTiff(tif);
@@ -418,6 +609,8 @@ bool ossimTiffOverviewBuilder::execute()
       ih = 0;
    }
 
+   clearQueuedTiles();
+
    if (ossimMpi::instance()->getRank() == 0 )
    {
       if (tif)
@@ -509,6 +702,8 @@ bool ossimTiffOverviewBuilder::writeR0(TIFF* tif)
    }
 
    setCurrentMessage(ossimString("Copying r0..."));
+
+   initializeNextLevel(rect, 0);
    
    //***
    // Tile loop in the line direction.
@@ -543,48 +738,23 @@ bool ossimTiffOverviewBuilder::writeR0(TIFF* tif)
          if (m_maskWriter.valid())
             m_maskWriter->generateMask(t, 0);
 
-         //***
-         // Band loop.
-         //***
-         for (uint32 band=0;
-              band < m_imageHandler->getNumberOfOutputBands();
-              ++band)
+         //---
+         // The handler reuses its tile so queue a copy.  Null tiles are queued
+         // as a null pointer to write the null data buffer.
+         //---
+         ossimRefPtr<ossimImageData> tileCopy = 0;
+         if ( t.valid() && (t->getDataObjectStatus() != OSSIM_NULL) )
          {
-            tdata_t data;
-            
-            if ( t.valid() && (t->getDataObjectStatus() != OSSIM_NULL) )
-            {
-               // Grab a pointer to the tile for the band.
-               data = static_cast<tdata_t>(t->getBuf(band));
-            }
-            else
-            {
-               data = static_cast<tdata_t>(&(m_nullDataBuffer.front()));
-            }
-
-            // Write the tile.
-            int bytesWritten = 0;
-            bytesWritten = TIFFWriteTile(tif,
-                                         data,
-                                         origin.x,
-                                         origin.y,
-                                         0,        // z
-                                         band);    // sample
-
-            if (bytesWritten != m_tileSizeInBytes)
-            {
-               ossimNotify(ossimNotifyLevel_WARN)
-                  << MODULE << " ERROR:"
-                  << "Error returned writing tiff tile:  " << i
-                  << "\nExpected bytes written:  " << m_tileSizeInBytes
-                  << "\nBytes written:  " << bytesWritten
-                  << std::endl;
-               theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
-               return false;
-            }
+            tileCopy = copyTile( t.get() );
+         }
+         if ( !queueTile(tif, tileCopy.get(), i, j) )
+         {
+            ossimNotify(ossimNotifyLevel_WARN)
+               << MODULE << " ERROR: writing tile:  " << i << std::endl;
+            theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+            return false;
+         }
 
-         } // End of band loop.  
-        
          ++tileNumber;
 
       } // End of tile loop in the sample (width) direction.
@@ -603,6 +773,14 @@ bool ossimTiffOverviewBuilder::writeR0(TIFF* tif)
 
    } // End of tile loop in the line (height) direction.
 
+   if ( !finishLevel(tif) )
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+         << MODULE << " Error writing tiles!" << std::endl;
+      theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+      return false;
+   }
+
    //***
    // Write the current dirctory.
    //***
@@ -655,6 +833,7 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
    else
    {
       sequencer = new ossimOverviewSequencer();
+      sequencer->setNumberOfThreads(m_numberOfThreads);
    }
    
    sequencer->setImageHandler(imageHandler);
@@ -753,6 +932,8 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
       }
    }
 
+   initializeNextLevel(rect, resLevel);
+
    ossim_uint32 outputTilesWide = sequencer->getNumberOfTilesHorizontal();
    ossim_uint32 outputTilesHigh = sequencer->getNumberOfTilesVertical();
    ossim_uint32 numberOfTiles   = sequencer->getNumberOfTiles();
@@ -768,13 +949,16 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
          << std::endl;
    }
  
-   // Tile loop in the line direction.
-   ossim_uint32 y = 0;
+   //---
+   // Only a threaded sequencer hands out a new tile per call; otherwise queue a
+   // copy.
+   //---
+   const bool COPY_TILES = (sequencer->getNumberOfThreads() < 2);
 
+   // Tile loop in the line direction.
    for(ossim_uint32 i = 0; i < outputTilesHigh; ++i)
    {
       // Tile loop in the sample (width) direction.
-      ossim_uint32 x = 0;
       for(ossim_uint32 j = 0; j < outputTilesWide; ++j)
       {
          // Grab the resampled tile.
@@ -791,33 +975,23 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
          
          if ( t.valid() && ( t->getDataObjectStatus() != OSSIM_NULL ) )
          {
+            if ( COPY_TILES )
+            {
+               t = copyTile( t.get() );
+            }
+            
             // Write it to the tiff.
-            for (ossim_uint32 band = 0; band < t->getNumberOfBands(); ++band)
+            if ( !queueTile(tif, t.get(), i, j) )
             {
-               // Write the tile.
-               int bytesWritten = 0;
-               bytesWritten = TIFFWriteTile(tif,
-                                            t->getBuf(band),
-                                            x,
-                                            y,
-                                            0,        // z
-                                            band);    // sample
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << MODULE << " ERROR:"
+                  << "Error returned writing tiff tile:  " << i
+                  << std::endl;
+               theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
                
-               if (bytesWritten != m_tileSizeInBytes)
-               {
-                  ossimNotify(ossimNotifyLevel_WARN)
-                     << MODULE << " ERROR:"
-                     << "Error returned writing tiff tile:  " << i
-                     << "\nExpected bytes written:  " << m_tileSizeInBytes
-                     << "\nBytes written:  " << bytesWritten
-                     << std::endl;
-                  theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
-                  
-                  return false;
-               }
+               return false;
             }
          }
-         x += m_tileWidth; // Increment x for next TIFFWriteTile.
          ++tileNumber;      // Increment tile number for percent complete.
 
       } // End of tile loop in the sample (width) direction.
@@ -834,10 +1008,16 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
          setPercentComplete(tile / numTiles * 100.0);
       }
 
-      y += m_tileHeight; // Increment y for next TIFFWriteTile.
-
    } // End of tile loop in the line (height) direction.
 
+   if ( !finishLevel(tif) )
+   {
+      setErrorStatus();
+      ossimNotify(ossimNotifyLevel_WARN)
+         << MODULE << " Error writing tiles!" << std::endl;
+      return false;
+   }
+
    //---
    // Write the current dirctory.
    //---
@@ -876,6 +1056,309 @@ bool ossimTiffOverviewBuilder::writeRn( ossimImageHandler* imageHandler,
    return true;
 }
 
+bool ossimTiffOverviewBuilder::writeRnFromMemory( TIFF* tif, ossim_uint32 resLevel )
+{
+   static const char MODULE[] = "ossimTiffOverviewBuilder::writeRnFromMemory";
+
+   if ( !tif || (resLevel == 0) )
+   {
+      return false;
+   }
+
+   // Create an empty directory to start with.
+   TIFFCreateDirectory( tif );
+
+   ostringstream os;
+   os << "creating r" << resLevel << "...";
+   setCurrentMessage(os.str());
+
+   // Take the tiles so the next level can be decimated into memory.
+   std::vector< ossimRefPtr<ossimImageData> > tiles;
+   tiles.swap(m_levelTiles);
+   const ossimIrect RECT = m_levelRect;
+
+   if (!setTags(tif, RECT, resLevel))
+   {
+      setErrorStatus();
+      ossimNotify(ossimNotifyLevel_WARN) << MODULE << " Error writing tags!" << std::endl;
+      return false;
+   }
+
+   initializeNextLevel(RECT, resLevel);
+
+   const ossim_uint32 TILES_WIDE = (RECT.width()  + m_tileWidth  - 1) / m_tileWidth;
+   const ossim_uint32 TILES_HIGH = (RECT.height() + m_tileHeight - 1) / m_tileHeight;
+   const double NUMBER_OF_TILES  = TILES_WIDE * TILES_HIGH;
+   ossim_uint32 tileNumber       = 0;
+
+   if (traceDebug())
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << MODULE << " DEBUG:"
+         << "\noutputTilesWide:  " << TILES_WIDE
+         << "\noutputTilesHigh:  " << TILES_HIGH
+         << std::endl;
+   }
+
+   for(ossim_uint32 i = 0; i < TILES_HIGH; ++i)
+   {
+      for(ossim_uint32 j = 0; j < TILES_WIDE; ++j)
+      {
+         // Drop our reference as we go; the job holds the tile until written.
+         ossimRefPtr<ossimImageData> t = tiles[tileNumber];
+         tiles[tileNumber] = 0;
+
+         if ( t.valid() && ( t->getDataObjectStatus() != OSSIM_NULL ) )
+         {
+            if ( !queueTile(tif, t.get(), i, j) )
+            {
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << MODULE << " ERROR:"
+                  << "Error returned writing tiff tile:  " << i
+                  << std::endl;
+               theErrorStatus = ossimErrorCodes::OSSIM_ERROR;
+               return false;
+            }
+         }
+         ++tileNumber;
+      }
+
+      if (needsAborting())
+      {
+         setPercentComplete(100.0);
+         break;
+      }
+      else
+      {
+         setPercentComplete(tileNumber / NUMBER_OF_TILES * 100.0);
+      }
+   }
+
+   if ( !finishLevel(tif) )
+   {
+      setErrorStatus();
+      ossimNotify(ossimNotifyLevel_WARN)
+         << MODULE << " Error writing tiles!" << std::endl;
+      return false;
+   }
+
+   if (!TIFFFlush(tif))
+   {
+      setErrorStatus();
+      ossimNotify(ossimNotifyLevel_WARN)
+         << MODULE << " Error writing to TIF file!" << std::endl;
+      return false;
+   }
+
+   ++m_currentTiffDir;
+
+   return true;
+}
+
+void ossimTiffOverviewBuilder::initializeNextLevel(const ossimIrect& levelRect,
+                                                   ossim_uint32 resLevel)
+{
+   m_nextLevelTiles.clear();
+   m_nextLevelTilesWide = 0;
+
+   //---
+   // The mask writer follows the source handler of each level and mpi
+   // slaves read back from the file so both need the file.
+   //---
+   if ( (m_levelMemoryBudget == 0) || m_maskWriter.valid() ||
+        (ossimMpi::instance()->getNumberOfProcessors() > 1) ||
+        ( resLevel + 1 >= getRequiredResLevels( m_imageHandler.get() ) ) )
+   {
+      return;
+   }
+
+   // Same rounding as ossimOverviewSequencer::getOutputImageRectangle.
+   const ossim_int32 WIDTH  = levelRect.width()  / 2 + levelRect.width()  % 2;
+   const ossim_int32 HEIGHT = levelRect.height() / 2 + levelRect.height() % 2;
+   const ossim_uint32 TILES_WIDE = (WIDTH  + m_tileWidth  - 1) / m_tileWidth;
+   const ossim_uint32 TILES_HIGH = (HEIGHT + m_tileHeight - 1) / m_tileHeight;
+   const ossim_uint64 BYTES = static_cast<ossim_uint64>(TILES_WIDE) * TILES_HIGH *
+      m_tileSizeInBytes * m_imageHandler->getNumberOfOutputBands();
+
+   if ( BYTES <= m_levelMemoryBudget )
+   {
+      // Tiles are allocated by queueTile as their first quadrant comes in.
+      m_nextLevelRect = ossimIrect(0, 0, WIDTH - 1, HEIGHT - 1);
+      m_nextLevelTilesWide = TILES_WIDE;
+      m_nextLevelTiles.resize(TILES_WIDE * TILES_HIGH);
+
+      if (traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimTiffOverviewBuilder::initializeNextLevel DEBUG:"
+            << "\nDecimating r" << (resLevel + 1) << " into memory: "
+            << m_nextLevelRect << std::endl;
+      }
+   }
+}
+
+bool ossimTiffOverviewBuilder::queueTile(TIFF* tif,
+                                         ossimImageData* tile,
+                                         ossim_uint32 row,
+                                         ossim_uint32 col)
+{
+   ossimRefPtr<ossimImageData> nextLevelTile = 0;
+   ossimIpt nextLevelOffset(0, 0);
+
+   if ( m_nextLevelTiles.size() && tile &&
+        ( (tile->getDataObjectStatus() == OSSIM_PARTIAL) ||
+          (tile->getDataObjectStatus() == OSSIM_FULL) ) )
+   {
+      // Each tile fills one quadrant of a next level tile.
+      ossimRefPtr<ossimImageData>& target =
+         m_nextLevelTiles[ (row / 2) * m_nextLevelTilesWide + (col / 2) ];
+      if ( !target.valid() )
+      {
+         const ossim_uint32 BANDS = tile->getNumberOfBands();
+         target = ossimImageDataFactory::instance()->create(
+            0, tile->getScalarType(), BANDS, m_tileWidth, m_tileHeight );
+         target->setNullPix( tile->getNullPix(), BANDS );
+         target->setMinPix( tile->getMinPix(), BANDS );
+         target->setMaxPix( tile->getMaxPix(), BANDS );
+         target->initialize();
+         target->setImageRectangle( ossimIrect( (col / 2) * m_tileWidth,
+                                                (row / 2) * m_tileHeight,
+                                                (col / 2 + 1) * m_tileWidth - 1,
+                                                (row / 2 + 1) * m_tileHeight - 1 ) );
+         target->makeBlank();
+      }
+      nextLevelTile = target;
+      nextLevelOffset.x = (col % 2) * m_tileWidth  / 2;
+      nextLevelOffset.y = (row % 2) * m_tileHeight / 2;
+   }
+
+   std::shared_ptr<TileJob> job = std::make_shared<TileJob>( tile,
+                                                             col * m_tileWidth,
+                                                             row * m_tileHeight,
+                                                             m_deflateTiles,
+                                                             m_levelResampler.get(),
+                                                             nextLevelTile.get(),
+                                                             nextLevelOffset );
+   m_queuedTiles.push_back(job);
+   m_jobQueue->getJobQueue()->add(job);
+
+   // Keep two tiles per thread in flight.
+   return writeQueuedTiles(tif, 2 * m_numberOfThreads);
+}
+
+bool ossimTiffOverviewBuilder::writeQueuedTiles(TIFF* tif, ossim_uint32 maxPending)
+{
+   static const char MODULE[] = "ossimTiffOverviewBuilder::writeQueuedTiles";
+   
+   bool result = true;
+   while ( result && m_queuedTiles.size() &&
+           ( (m_queuedTiles.size() > maxPending) || m_queuedTiles.front()->isFinished() ) )
+   {
+      std::shared_ptr<TileJob> job = m_queuedTiles.front();
+      m_queuedTiles.pop_front();
+      while ( !job->isFinished() )
+      {
+         m_jobQueue->waitAny();
+      }
+
+      const ossimImageData* tile = job->getTile();
+      const ossim_uint32 BANDS = m_imageHandler->getNumberOfOutputBands();
+      for ( ossim_uint32 band = 0; result && (band < BANDS); ++band )
+      {
+         if ( job->isDeflated() )
+         {
+            const std::vector<ossim_uint8>& data = job->getBand(band);
+            tsize_t bytesWritten = TIFFWriteRawTile(
+               tif,
+               TIFFComputeTile(tif, job->getX(), job->getY(), 0, band),
+               const_cast<ossim_uint8*>( &(data.front()) ),
+               static_cast<tsize_t>( data.size() ) );
+            result = ( bytesWritten == static_cast<tsize_t>( data.size() ) );
+         }
+         else
+         {
+            tdata_t data;
+            if ( tile )
+            {
+               data = const_cast<tdata_t>( tile->getBuf(band) );
+            }
+            else
+            {
+               data = static_cast<tdata_t>(&(m_nullDataBuffer.front()));
+            }
+            int bytesWritten = TIFFWriteTile(tif,
+                                             data,
+                                             job->getX(),
+                                             job->getY(),
+                                             0,        // z
+                                             band);    // sample
+            result = ( bytesWritten == m_tileSizeInBytes );
+         }
+
+         if ( !result )
+         {
+            ossimNotify(ossimNotifyLevel_WARN)
+               << MODULE << " ERROR:"
+               << "\nError returned writing tiff tile at:  "
+               << job->getX() << ", " << job->getY()
+               << "\nband:  " << band << std::endl;
+         }
+      }
+   }
+
+   if ( !result )
+   {
+      clearQueuedTiles();
+   }
+   
+   return result;
+}
+
+bool ossimTiffOverviewBuilder::finishLevel(TIFF* tif)
+{
+   bool result = writeQueuedTiles(tif, 0);
+   if ( result )
+   {
+      // All quadrants are in.
+      std::vector< ossimRefPtr<ossimImageData> >::iterator i = m_nextLevelTiles.begin();
+      while ( i != m_nextLevelTiles.end() )
+      {
+         if ( (*i).valid() )
+         {
+            (*i)->validate();
+         }
+         ++i;
+      }
+      m_levelTiles.swap(m_nextLevelTiles);
+      m_levelRect = m_nextLevelRect;
+   }
+   m_nextLevelTiles.clear();
+   m_nextLevelTilesWide = 0;
+   
+   return result;
+}
+
+void ossimTiffOverviewBuilder::clearQueuedTiles()
+{
+   if ( m_jobQueue )
+   {
+      m_jobQueue->waitAll();
+   }
+   m_queuedTiles.clear();
+   m_levelTiles.clear();
+   m_nextLevelTiles.clear();
+   m_nextLevelTilesWide = 0;
+}
+
+ossimRefPtr<ossimImageData> ossimTiffOverviewBuilder::copyTile(const ossimImageData* tile) const
+{
+   ossimRefPtr<ossimImageData> result = ossimImageDataFactory::instance()->
+      create( 0, tile->getScalarType(), tile->getNumberOfBands(),
+              tile->getWidth(), tile->getHeight() );
+   result->assign( tile );
+   return result;
+}
+
 //*******************************************************************
 // Private Method:
 //*******************************************************************
@@ -1397,6 +1880,10 @@ void ossimTiffOverviewBuilder::setProperty(ossimRefPtr<ossimProperty> property)
       {
          m_internalOverviewsFlag = property->valueToString().toBool();
       }
+      else if( property->getName() == ossimKeywordNames::THREADS_KW )
+      {
+         setNumberOfThreads( property->valueToString().toUInt32() );
+      }
       else if(property->getName() == ossimKeywordNames::OVERVIEW_STOP_DIMENSION_KW)
       {
          m_overviewStopDimension = property->valueToString().toUInt32();
@@ -1420,6 +1907,7 @@ void ossimTiffOverviewBuilder::getPropertyNames(std::vector<ossimString>& proper
    propertyNames.push_back(INTERNAL_OVERVIEWS_KW);
    propertyNames.push_back(ossimKeywordNames::OVERVIEW_STOP_DIMENSION_KW);
    propertyNames.push_back(TEMP_EXTENSION);
+   propertyNames.push_back(ossimKeywordNames::THREADS_KW);
 }
 
 bool ossimTiffOverviewBuilder::canConnectMyInputTo(
@@ -0,0 +1,322 @@
+//---
+//
+// License: MIT
+//
+// Description:
+//
+// Contains class definition for ossimTiffTilePrefetcher.
+//
+//---
+
+#include <ossim/imaging/ossimTiffTilePrefetcher.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimTrace.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
+#include <ossim/support_data/TiffStreamAdaptor.h>
+#include <xtiffio.h>
+#include <ostream>
+
+static ossimTrace traceDebug("ossimTiffTilePrefetcher:debug");
+
+/** Reads one tile on the prefetch thread. */
+class ossimTiffTilePrefetcher::ReadJob : public ossimJob
+{
+public:
+   ReadJob(ossimTiffTilePrefetcher* prefetcher,
+           const TileKey& key,
+           ossim_uint32 generation)
+      :
+      ossimJob(),
+      m_prefetcher(prefetcher),
+      m_key(key),
+      m_generation(generation)
+   {
+   }
+
+protected:
+   virtual void run()
+   {
+      m_prefetcher->readTile(m_key, m_generation);
+   }
+
+private:
+   ossimTiffTilePrefetcher* m_prefetcher;
+   TileKey                  m_key;
+   ossim_uint32             m_generation;
+};
+
+ossimTiffTilePrefetcher::ossimTiffTilePrefetcher()
+   :
+   m_streamAdaptor(),
+   m_tiffPtr(0),
+   m_jobQueue(),
+   m_mutex(),
+   m_tileReady(),
+   m_tiles(),
+   m_generation(0),
+   m_requests(0),
+   m_hits(0),
+   m_misses(0),
+   m_maxTiles(0)
+{
+}
+
+ossimTiffTilePrefetcher::~ossimTiffTilePrefetcher()
+{
+   close();
+}
+
+bool ossimTiffTilePrefetcher::open(const std::string& connectionString)
+{
+   close();
+
+   m_streamAdaptor = std::make_shared<ossim::TiffIStreamAdaptor>(connectionString);
+   if ( m_streamAdaptor->getStream() )
+   {
+      //---
+      // Note:  The 'm' in "rm" is to tell TIFFOpen to not memory map the file.
+      //---
+      m_tiffPtr = XTIFFClientOpen(connectionString.c_str(), "rm",
+                                  (thandle_t)m_streamAdaptor.get(),
+                                  ossim::TiffIStreamAdaptor::tiffRead,
+                                  ossim::TiffIStreamAdaptor::tiffWrite,
+                                  ossim::TiffIStreamAdaptor::tiffSeek,
+                                  ossim::TiffIStreamAdaptor::tiffClose,
+                                  ossim::TiffIStreamAdaptor::tiffSize,
+                                  ossim::TiffIStreamAdaptor::tiffMap,
+                                  ossim::TiffIStreamAdaptor::tiffUnmap);
+   }
+
+   if ( m_tiffPtr )
+   {
+      // One thread as the handle can only be used by one at a time.
+      m_jobQueue = std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(), 1);
+   }
+   else
+   {
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_WARN)
+            << "ossimTiffTilePrefetcher::open WARNING:\n"
+            << "libtiff could not open " << connectionString << std::endl;
+      }
+      m_streamAdaptor.reset();
+   }
+
+   return ( m_tiffPtr != 0 );
+}
+
+void ossimTiffTilePrefetcher::close()
+{
+   // Waits for the read in progress.
+   m_jobQueue.reset();
+
+   if ( m_tiffPtr )
+   {
+      XTIFFClose(m_tiffPtr);
+      m_tiffPtr = 0;
+   }
+   m_streamAdaptor.reset();
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_tiles.clear();
+   ++m_generation;
+   m_requests = 0;
+   m_hits     = 0;
+   m_misses   = 0;
+   m_maxTiles = 0;
+}
+
+bool ossimTiffTilePrefetcher::isOpen() const
+{
+   return ( m_tiffPtr != 0 );
+}
+
+void ossimTiffTilePrefetcher::request(ossim_uint16 directory,
+                                      ossim_uint32 tile,
+                                      ossim_uint64 lastUse)
+{
+   if ( !m_jobQueue )
+   {
+      return;
+   }
+
+   const TileKey KEY(directory, tile);
+   ossim_uint32 generation = 0;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::map<TileKey, Tile>::iterator i = m_tiles.find(KEY);
+      if ( i != m_tiles.end() )
+      {
+         if ( i->second.m_lastUse < lastUse )
+         {
+            i->second.m_lastUse = lastUse;
+         }
+         return;
+      }
+      m_tiles[KEY].m_lastUse = lastUse;
+      ++m_requests;
+      if ( m_tiles.size() > m_maxTiles )
+      {
+         m_maxTiles = (ossim_uint32)m_tiles.size();
+      }
+      generation = m_generation;
+   }
+
+   m_jobQueue->getJobQueue()->add( std::make_shared<ReadJob>(this, KEY, generation) );
+}
+
+std::shared_ptr<const std::vector<ossim_uint8> > ossimTiffTilePrefetcher::take(
+   ossim_uint16 directory, ossim_uint32 tile)
+{
+   std::shared_ptr<const std::vector<ossim_uint8> > result;
+
+   std::unique_lock<std::mutex> lock(m_mutex);
+   std::map<TileKey, Tile>::iterator i = m_tiles.find( TileKey(directory, tile) );
+   if ( i != m_tiles.end() )
+   {
+      while ( !i->second.m_ready )
+      {
+         // The tile stays in the map until release() which is our caller's.
+         m_tileReady.wait(lock);
+      }
+      result = i->second.m_data;
+   }
+
+   if ( result )
+   {
+      ++m_hits;
+   }
+   else
+   {
+      ++m_misses;
+   }
+
+   return result;
+}
+
+void ossimTiffTilePrefetcher::release(ossim_uint64 requestIndex)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   std::map<TileKey, Tile>::iterator i = m_tiles.begin();
+   while ( i != m_tiles.end() )
+   {
+      // Queued tiles are kept so take() never waits on a read that was dropped.
+      if ( i->second.m_ready && ( i->second.m_lastUse < requestIndex ) )
+      {
+         m_tiles.erase(i++);
+      }
+      else
+      {
+         ++i;
+      }
+   }
+}
+
+void ossimTiffTilePrefetcher::clear()
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_tiles.clear();
+   ++m_generation;
+}
+
+ossim_uint32 ossimTiffTilePrefetcher::getNumberOfTiles() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return (ossim_uint32)m_tiles.size();
+}
+
+bool ossimTiffTilePrefetcher::hasTile(ossim_uint16 directory, ossim_uint32 tile) const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return ( m_tiles.find( TileKey(directory, tile) ) != m_tiles.end() );
+}
+
+ossim_uint64 ossimTiffTilePrefetcher::getNumberOfRequests() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_requests;
+}
+
+ossim_uint64 ossimTiffTilePrefetcher::getNumberOfHits() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_hits;
+}
+
+ossim_uint64 ossimTiffTilePrefetcher::getNumberOfMisses() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_misses;
+}
+
+ossim_uint32 ossimTiffTilePrefetcher::getMaxNumberOfTiles() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_maxTiles;
+}
+
+std::ostream& ossimTiffTilePrefetcher::print(std::ostream& out) const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   const ossim_uint64 TAKEN = m_hits + m_misses;
+   out << "prefetch_requests:             " << m_requests
+       << "\nprefetch_hits:                 " << m_hits
+       << "\nprefetch_misses:               " << m_misses
+       << "\nprefetch_hit_rate:             "
+       << ( TAKEN ? (double)m_hits / (double)TAKEN : 0.0 )
+       << "\nprefetch_queue_depth:          " << m_tiles.size()
+       << "\nprefetch_max_queue_depth:      " << m_maxTiles
+       << "\n";
+   return out;
+}
+
+void ossimTiffTilePrefetcher::readTile(const TileKey& key, ossim_uint32 generation)
+{
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if ( generation != m_generation )
+      {
+         return; // Dropped by clear().
+      }
+   }
+
+   //---
+   // Only this thread uses m_tiffPtr once open.  A failed read leaves the
+   // data null so the reader falls back to its own handle and reports the
+   // error the usual way.
+   //---
+   std::shared_ptr< std::vector<ossim_uint8> > data;
+   bool status = true;
+   if ( TIFFCurrentDirectory(m_tiffPtr) != key.first )
+   {
+      status = ( TIFFSetDirectory(m_tiffPtr, key.first) != 0 );
+   }
+   if ( status )
+   {
+      tsize_t tileSize = TIFFTileSize(m_tiffPtr);
+      if ( tileSize > 0 )
+      {
+         data = std::make_shared< std::vector<ossim_uint8> >(tileSize);
+         if ( TIFFReadEncodedTile(m_tiffPtr, key.second, &data->front(), (tsize_t)-1) <= 0 )
+         {
+            data.reset();
+         }
+      }
+   }
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   if ( generation == m_generation )
+   {
+      std::map<TileKey, Tile>::iterator i = m_tiles.find(key);
+      if ( i != m_tiles.end() )
+      {
+         i->second.m_data  = data;
+         i->second.m_ready = true;
+      }
+   }
+   m_tileReady.notify_all();
+}
@@ -30,12 +30,15 @@
 #include <ossim/base/ossimEllipsoid.h>
 #include <ossim/base/ossimDatum.h>
 #include <ossim/base/ossimBooleanProperty.h>
+#include <ossim/base/ossimNumericProperty.h>
 #include <ossim/base/ossimStringProperty.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/imaging/ossimTiffTilePrefetcher.h>
 #include <ossim/projection/ossimProjectionFactoryRegistry.h>
 #include <xtiffio.h>
 #include <geo_normalize.h>
 #include <cstdlib> /* for abs(int) */
+#include <sstream>
 #include <ossim/base/ossimStreamFactoryRegistry.h>
 #include <ossim/support_data/TiffHandlerState.h>
 
@@ -43,6 +46,23 @@ RTTI_DEF1(ossimTiffTileSource, "ossimTiffTileSource", ossimImageHandler)
 
 static ossimTrace traceDebug("ossimTiffTileSource:debug");
 
+/** A libtiff handle and tile buffer used by one concurrent read at a time. */
+class ossimTiffTileSource::ReadHandle
+{
+public:
+   ReadHandle() : m_streamAdaptor(), m_tiffPtr(0), m_buffer() {}
+   ~ReadHandle()
+   {
+      if ( m_tiffPtr )
+      {
+         XTIFFClose(m_tiffPtr);
+      }
+   }
+   std::shared_ptr<ossim::TiffIStreamAdaptor> m_streamAdaptor;
+   TIFF*                                      m_tiffPtr;
+   std::vector<ossim_uint8>                   m_buffer;
+};
+
 #define OSSIM_TIFF_UNPACK_R4(value) ( (value)&0x000000FF)
 #define OSSIM_TIFF_UNPACK_G4(value) ( ((value)>>8)&0x000000FF)
 #define OSSIM_TIFF_UNPACK_B4(value) ( ((value)>>16)&0x000000FF)
@@ -99,8 +119,36 @@ ossimTiffTileSource::ossimTiffTileSource()
       theImageDirectoryList(0),
       theCurrentTiffRlevel(0),
       theCompressionType(0),
-      theOutputBandList(0)
-{}
+      theOutputBandList(0),
+      m_prefetcher(),
+      m_prefetchedTile(),
+      m_prefetchTiles(0),
+      m_prefetchArea(),
+      m_prefetchTileSize(0, 0),
+      m_prefetchResLevel(0),
+      m_prefetchDirectory(0),
+      m_prefetchCursor(0),
+      m_concurrentReads(false),
+      m_readMutex(),
+      m_readHandles(),
+      m_readHandleMutex()
+{
+   m_prefetchArea.makeNan();
+
+   ossimString tiles = ossimPreferences::instance()->
+      findPreference("ossim.imaging.tiff.prefetch_tiles");
+   if ( tiles.size() )
+   {
+      m_prefetchTiles = tiles.toUInt32();
+   }
+
+   ossimString concurrent = ossimPreferences::instance()->
+      findPreference("ossim.imaging.tiff.concurrent_reads");
+   if ( concurrent.size() )
+   {
+      m_concurrentReads = concurrent.toBool();
+   }
+}
 
 ossimTiffTileSource::~ossimTiffTileSource()
 {
@@ -138,6 +186,20 @@ bool ossimTiffTileSource::getTile(ossimImageData* result,
    static const char MODULE[] = "ossimTiffTileSource::getTile(ossimImageData*, resLevel)";
 
    bool status = false;
+
+   //---
+   // Tiled directories are read with a pooled handle when concurrent reads
+   // are on.  Anything that would touch theTiffPtr or theBuffer is locked.
+   //---
+   std::unique_lock<std::mutex> lock(m_readMutex, std::defer_lock);
+   if ( m_concurrentReads )
+   {
+      if ( getTileConcurrent( result, resLevel, status ) )
+      {
+         return status;
+      }
+      lock.lock();
+   }
    
    //---
    // Not open, this tile source bypassed, or invalid res level,
@@ -229,6 +291,12 @@ bool ossimTiffTileSource::getTile(ossimImageData* result,
 
             if ( status )
             {  
+               if ( m_prefetcher && ( resLevel == m_prefetchResLevel ) &&
+                    ( theCurrentDirectory == m_prefetchDirectory ) )
+               {
+                  prefetch( tile_rect );
+               }
+
                ossimIrect clip_rect = tile_rect.clipToRect( image_rect );
                
                if ( !tile_rect.completely_within( clip_rect ) )
@@ -307,6 +375,16 @@ bool ossimTiffTileSource::saveState(ossimKeywordlist& kwl,
               "apply_color_palette_flag",
               theApplyColorPaletteFlag,
               true);
+
+      kwl.add(prefix,
+              "prefetch_tiles",
+              m_prefetchTiles,
+              true);
+
+      kwl.add(prefix,
+              "concurrent_reads",
+              (m_concurrentReads ? "true" : "false"),
+              true);
    }
    
    return result;
@@ -337,6 +415,20 @@ bool ossimTiffTileSource::loadState(const ossimKeywordlist& kwl,
          theApplyColorPaletteFlag = true;
       }
 
+      key = "prefetch_tiles";
+      value.string() = kwl.findKey( pfx, key );
+      if ( value.size() )
+      {
+         setNumberOfPrefetchTiles( value.toUInt32() );
+      }
+
+      key = "concurrent_reads";
+      value.string() = kwl.findKey( pfx, key );
+      if ( value.size() )
+      {
+         setConcurrentReads( value.toBool() );
+      }
+
       key = ossimKeywordNames::BANDS_KW;
       value.string() = kwl.findKey( pfx, key );
       if ( value.size() )
@@ -365,6 +457,9 @@ bool ossimTiffTileSource::open(const ossimFilename& image_file)
 
 void ossimTiffTileSource::close()
 {
+   closePrefetcher();
+   closeReadHandles();
+
    if(theTiffPtr)
    {
       XTIFFClose(theTiffPtr);
@@ -1233,15 +1328,11 @@ bool ossimTiffTileSource::loadFromTile(const ossimIrect& clip_rect,
             
             if  (thePlanarConfig[theCurrentDirectory] == PLANARCONFIG_CONTIG)
             {
-               tileSizeRead = TIFFReadTile(theTiffPtr,
-                                           theBuffer,
-                                           ulTilePt.x,
-                                           ulTilePt.y,
-                                           0,
-                                           0);
+               const ossim_uint8* data = 0;
+               tileSizeRead = readTiffTile(ulTilePt, 0, data);
                if (tileSizeRead > 0)
                {
-                  result->loadTile(theBuffer,
+                  result->loadTile(data,
                                   bufRectWithOffset,
                                   clipRectWithOffset,
                                   OSSIM_BIP);
@@ -1271,15 +1362,13 @@ bool ossimTiffTileSource::loadFromTile(const ossimIrect& clip_rect,
                ossim_uint32 destinationBand = 0;
                while ( bandIter != theOutputBandList.end() )
                {
-                  tileSizeRead = TIFFReadTile( theTiffPtr,
-                                               theBuffer,
-                                               ulTilePt.x,
-                                               ulTilePt.y,
-                                               0,
-                                               (*bandIter) );
+                  const ossim_uint8* data = 0;
+                  tileSizeRead = readTiffTile( ulTilePt,
+                                               (ossim_uint16)(*bandIter),
+                                               data );
                   if(tileSizeRead > 0)
                   {
-                     result->loadBand( theBuffer,
+                     result->loadBand( data,
                                        bufRectWithOffset,
                                        clipRectWithOffset,
                                        destinationBand );
@@ -1313,6 +1402,495 @@ bool ossimTiffTileSource::loadFromTile(const ossimIrect& clip_rect,
    return true;
 }
 
+ossim_int32 ossimTiffTileSource::readTiffTile(const ossimIpt& origin,
+                                              ossim_uint16 sample,
+                                              const ossim_uint8*& data)
+{
+   if ( m_prefetcher && ( theCurrentDirectory == m_prefetchDirectory ) &&
+        !m_prefetchArea.hasNans() )
+   {
+      //---
+      // Hold on to the tile as release() may drop it from the prefetcher
+      // before the caller is done with it.
+      //---
+      m_prefetchedTile = m_prefetcher->take(
+         theCurrentDirectory, computeTiffTile(theCurrentDirectory, origin, sample) );
+      if ( m_prefetchedTile && m_prefetchedTile->size() )
+      {
+         data = &m_prefetchedTile->front();
+         return (ossim_int32)m_prefetchedTile->size();
+      }
+   }
+
+   // Not read ahead or the read failed; read it here as before.
+   data = theBuffer;
+   return TIFFReadTile(theTiffPtr, theBuffer, origin.x, origin.y, 0, sample);
+}
+
+void ossimTiffTileSource::prefetch(const ossimIrect& tile_rect)
+{
+   //---
+   // Only tiles on the announced grid are tracked.  Anything else is read
+   // as before without touching the read ahead.
+   //---
+   const ossim_int32 W = m_prefetchTileSize.x;
+   const ossim_int32 H = m_prefetchTileSize.y;
+   if ( m_prefetchArea.hasNans() ||
+        ( (ossim_int32)tile_rect.width() != W ) ||
+        ( (ossim_int32)tile_rect.height() != H ) )
+   {
+      return;
+   }
+   ossimIpt offset = tile_rect.ul() - m_prefetchArea.ul();
+   if ( (offset.x < 0) || (offset.y < 0) || (offset.x % W) || (offset.y % H) )
+   {
+      return;
+   }
+
+   const ossim_uint64 TILES_ACROSS = (m_prefetchArea.width()  + W - 1) / W;
+   const ossim_uint64 TILES_DOWN   = (m_prefetchArea.height() + H - 1) / H;
+   const ossim_uint64 TOTAL_TILES  = TILES_ACROSS * TILES_DOWN;
+   const ossim_uint64 INDEX = (offset.y / H) * TILES_ACROSS + (offset.x / W);
+   if ( ( (ossim_uint64)(offset.x / W) >= TILES_ACROSS ) || ( INDEX >= TOTAL_TILES ) )
+   {
+      return;
+   }
+
+   m_prefetcher->release(INDEX);
+
+   if ( m_prefetchCursor < INDEX )
+   {
+      m_prefetchCursor = INDEX; // Caller skipped ahead.
+   }
+
+   while ( ( m_prefetchCursor < TOTAL_TILES ) &&
+           ( m_prefetcher->getNumberOfTiles() < m_prefetchTiles ) )
+   {
+      requestTiffTiles(m_prefetchCursor);
+      ++m_prefetchCursor;
+   }
+}
+
+void ossimTiffTileSource::requestTiffTiles(ossim_uint64 requestIndex)
+{
+   const ossim_int32 W = m_prefetchTileSize.x;
+   const ossim_int32 H = m_prefetchTileSize.y;
+   const ossim_uint64 TILES_ACROSS = (m_prefetchArea.width() + W - 1) / W;
+
+   ossimIpt ul( m_prefetchArea.ul().x + (ossim_int32)(requestIndex % TILES_ACROSS) * W,
+                m_prefetchArea.ul().y + (ossim_int32)(requestIndex / TILES_ACROSS) * H );
+   ossimIrect rect(ul.x, ul.y, ul.x + W - 1, ul.y + H - 1);
+   ossimIrect image_rect = getImageRectangle(m_prefetchResLevel);
+   if ( !rect.intersects(image_rect) )
+   {
+      return;
+   }
+   rect = rect.clipToRect(image_rect);
+
+   const ossim_uint32 DIR = m_prefetchDirectory;
+   const ossim_int32 TW = theImageTileWidth[DIR];
+   const ossim_int32 TL = theImageTileLength[DIR];
+   const bool SEPARATE = ( thePlanarConfig[DIR] != PLANARCONFIG_CONTIG );
+
+   std::vector<ossim_uint32> bands = theOutputBandList;
+   if ( bands.empty() )
+   {
+      ossimImageSource::getOutputBandList( bands );
+   }
+
+   for ( ossim_int32 y = (rect.ul().y / TL) * TL; y <= rect.lr().y; y += TL )
+   {
+      for ( ossim_int32 x = (rect.ul().x / TW) * TW; x <= rect.lr().x; x += TW )
+      {
+         ossimIpt origin(x, y);
+         if ( SEPARATE )
+         {
+            for ( ossim_uint32 i = 0; i < bands.size(); ++i )
+            {
+               m_prefetcher->request( (ossim_uint16)DIR,
+                                      computeTiffTile(DIR, origin, (ossim_uint16)bands[i]),
+                                      requestIndex );
+            }
+         }
+         else
+         {
+            m_prefetcher->request( (ossim_uint16)DIR,
+                                   computeTiffTile(DIR, origin, 0),
+                                   requestIndex );
+         }
+      }
+   }
+}
+
+ossim_uint32 ossimTiffTileSource::computeTiffTile(ossim_uint32 directory,
+                                                  const ossimIpt& origin,
+                                                  ossim_uint16 sample) const
+{
+   // Same as TIFFComputeTile for a two dimensional image.
+   const ossim_uint32 TW = theImageTileWidth[directory];
+   const ossim_uint32 TL = theImageTileLength[directory];
+   const ossim_uint32 TILES_ACROSS = (theImageWidth[directory]  + TW - 1) / TW;
+   const ossim_uint32 TILES_DOWN   = (theImageLength[directory] + TL - 1) / TL;
+
+   ossim_uint32 tile = TILES_ACROSS * ( origin.y / TL ) + ( origin.x / TW );
+   if ( thePlanarConfig[directory] != PLANARCONFIG_CONTIG )
+   {
+      tile += TILES_ACROSS * TILES_DOWN * sample;
+   }
+   return tile;
+}
+
+void ossimTiffTileSource::closePrefetcher()
+{
+   if ( m_prefetcher )
+   {
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimTiffTileSource::closePrefetcher DEBUG:\n"
+            << "image_file: " << theImageFile << "\n";
+         m_prefetcher->print( ossimNotify(ossimNotifyLevel_DEBUG) );
+      }
+      m_prefetcher->close();
+      m_prefetcher.reset();
+   }
+   m_prefetchedTile.reset();
+   m_prefetchArea.makeNan();
+   m_prefetchCursor = 0;
+}
+
+void ossimTiffTileSource::setTileRequestOrder(const ossimIrect& area,
+                                              const ossimIpt& tileSize,
+                                              ossim_uint32 resLevel)
+{
+   if ( theOverview.valid() && theOverview->isValidRLevel(resLevel) )
+   {
+      ossimImageHandler::setTileRequestOrder(area, tileSize, resLevel);
+      return;
+   }
+
+   if ( m_prefetcher )
+   {
+      m_prefetcher->clear();
+   }
+   m_prefetchedTile.reset();
+   m_prefetchArea.makeNan();
+   m_prefetchCursor = 0;
+
+   if ( !m_prefetchTiles || !isOpen() || !isValidRLevel(resLevel) ||
+        area.hasNans() || (tileSize.x <= 0) || (tileSize.y <= 0) )
+   {
+      return;
+   }
+
+   // Same level adjustment as getTile.
+   ossim_uint32 level = resLevel;
+   if ( theStartingResLevel && !theR0isFullRes && (level >= theStartingResLevel) )
+   {
+      level -= theStartingResLevel;
+   }
+   if ( level >= theImageDirectoryList.size() )
+   {
+      return;
+   }
+   const ossim_uint32 DIR = theImageDirectoryList[level];
+
+   // Only plain tile reads are done on the prefetch thread.
+   if ( ( DIR >= theReadMethod.size() ) || ( theReadMethod[DIR] != READ_TILE ) )
+   {
+      return;
+   }
+
+   if ( !m_prefetcher )
+   {
+      m_prefetcher = std::make_shared<ossimTiffTilePrefetcher>();
+      if ( !m_prefetcher->open( theImageFile.string() ) )
+      {
+         m_prefetcher.reset();
+         return;
+      }
+   }
+
+   m_prefetchArea      = area;
+   m_prefetchTileSize  = tileSize;
+   m_prefetchResLevel  = resLevel;
+   m_prefetchDirectory = DIR;
+}
+
+void ossimTiffTileSource::setNumberOfPrefetchTiles(ossim_uint32 tiles)
+{
+   m_prefetchTiles = tiles;
+   if ( !m_prefetchTiles )
+   {
+      closePrefetcher();
+   }
+}
+
+ossim_uint32 ossimTiffTileSource::getNumberOfPrefetchTiles() const
+{
+   return m_prefetchTiles;
+}
+
+void ossimTiffTileSource::setConcurrentReads(bool flag)
+{
+   m_concurrentReads = flag;
+   if ( !m_concurrentReads )
+   {
+      closeReadHandles();
+   }
+}
+
+bool ossimTiffTileSource::getConcurrentReads() const
+{
+   return m_concurrentReads;
+}
+
+bool ossimTiffTileSource::supportsConcurrentReads() const
+{
+   return m_concurrentReads;
+}
+
+bool ossimTiffTileSource::getTileConcurrent(ossimImageData* result,
+                                            ossim_uint32 resLevel,
+                                            bool& status)
+{
+   // Leave the odd cases to the serial path so they behave as before.
+   if( !isOpen() || !isSourceEnabled() || !isValidRLevel(resLevel) || !result ||
+       (result->getNumberOfBands() != getNumberOfOutputBands()) )
+   {
+      return false;
+   }
+
+   if ( theOverview.valid() && theOverview->isValidRLevel(resLevel) )
+   {
+      // The overview may share state of its own unless it says otherwise.
+      if ( !theOverview->supportsConcurrentReads() )
+      {
+         return false;
+      }
+      result->ref();
+      status = getOverviewTile(resLevel, result);
+      result->unref();
+      if ( status )
+      {
+         return true;
+      }
+   }
+
+   // Same level adjustment as getTile.
+   ossim_uint32 level = resLevel;
+   if ( theStartingResLevel && !theR0isFullRes && (level >= theStartingResLevel) )
+   {
+      level -= theStartingResLevel;
+   }
+   if ( level >= theImageDirectoryList.size() )
+   {
+      return false;
+   }
+   const ossim_uint32 DIR = theImageDirectoryList[level];
+   if ( ( DIR >= theReadMethod.size() ) || ( theReadMethod[DIR] != READ_TILE ) )
+   {
+      return false;
+   }
+
+   // No handle could be opened, let the serial path read it.
+   ReadHandle* handle = acquireReadHandle();
+   if ( !handle )
+   {
+      return false;
+   }
+
+   result->ref();
+
+   ossimIrect tile_rect  = result->getImageRectangle();
+   ossimIrect image_rect = getImageRectangle(resLevel);
+   if ( tile_rect.intersects(image_rect) )
+   {
+      if (result->getDataObjectStatus() == OSSIM_NULL)
+      {
+         result->initialize();
+      }
+
+      ossimIrect clip_rect = tile_rect.clipToRect( image_rect );
+      if ( !tile_rect.completely_within( clip_rect ) )
+      {
+         result->makeBlank();
+      }
+
+      status = loadFromTileConcurrent( handle, DIR, clip_rect, result );
+      if ( status )
+      {
+         result->validate();
+      }
+   }
+   else
+   {
+      // No part of requested tile within the image rectangle.
+      status = true;
+      result->makeBlank();
+   }
+
+   releaseReadHandle(handle);
+   result->unref();
+
+   return true;
+}
+
+bool ossimTiffTileSource::loadFromTileConcurrent(ReadHandle* handle,
+                                                 ossim_uint32 directory,
+                                                 const ossimIrect& clip_rect,
+                                                 ossimImageData* result)
+{
+   static const char MODULE[] = "ossimTiffTileSource::loadFromTileConcurrent";
+
+   bool status = true;
+   if ( TIFFCurrentDirectory(handle->m_tiffPtr) != directory )
+   {
+      status = ( TIFFSetDirectory(handle->m_tiffPtr, (ossim_uint16)directory) != 0 );
+   }
+
+   if ( status )
+   {
+      tsize_t tileSize = TIFFTileSize(handle->m_tiffPtr);
+      if ( tileSize > 0 )
+      {
+         if ( handle->m_buffer.size() < (std::size_t)tileSize )
+         {
+            handle->m_buffer.resize(tileSize);
+         }
+      }
+      else
+      {
+         status = false;
+      }
+   }
+
+   const ossim_int32 TW = theImageTileWidth[directory];
+   const ossim_int32 TL = theImageTileLength[directory];
+   const bool CONTIG = ( thePlanarConfig[directory] == PLANARCONFIG_CONTIG );
+
+   // Do not fill in theOutputBandList here as getTile(rect) does.
+   std::vector<ossim_uint32> bands = theOutputBandList;
+   if ( !CONTIG && bands.empty() )
+   {
+      ossimImageSource::getOutputBandList( bands );
+   }
+
+   // theCurrentDirectory belongs to the serial path, so align to this directory's tiles.
+   ossimIpt tileOrigin = clip_rect.ul();
+   adjustToStartOfTile(tileOrigin, TW, TL);
+
+   for ( ossim_int32 y = tileOrigin.y; status && ( y <= clip_rect.lr().y ); y += TL )
+   {
+      for ( ossim_int32 x = tileOrigin.x; status && ( x <= clip_rect.lr().x ); x += TW )
+      {
+         ossimIrect tiff_tile_rect(x, y, x + TW - 1, y + TL - 1);
+         ossimIrect tiff_tile_clip_rect = tiff_tile_rect.clipToRect(clip_rect);
+         ossim_uint8* buf = &handle->m_buffer.front();
+
+         if ( CONTIG )
+         {
+            ossim_int32 tileSizeRead =
+               TIFFReadTile(handle->m_tiffPtr, buf, x, y, 0, 0);
+            if ( tileSizeRead > 0 )
+            {
+               result->loadTile(buf, tiff_tile_rect, tiff_tile_clip_rect, OSSIM_BIP);
+            }
+            else if ( tileSizeRead < 0 )
+            {
+               status = false;
+            }
+         }
+         else
+         {
+            for ( ossim_uint32 band = 0; status && ( band < bands.size() ); ++band )
+            {
+               ossim_int32 tileSizeRead = TIFFReadTile(
+                  handle->m_tiffPtr, buf, x, y, 0, (ossim_uint16)bands[band] );
+               if ( tileSizeRead > 0 )
+               {
+                  result->loadBand(buf, tiff_tile_rect, tiff_tile_clip_rect, band);
+               }
+               else if ( tileSizeRead < 0 )
+               {
+                  status = false;
+               }
+            }
+         }
+      }
+   }
+
+   if ( !status && traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+         << MODULE << " Read Error!"
+         << "\nReturning error...  " << endl;
+   }
+
+   return status;
+}
+
+ossimTiffTileSource::ReadHandle* ossimTiffTileSource::acquireReadHandle()
+{
+   {
+      std::lock_guard<std::mutex> lock(m_readHandleMutex);
+      if ( m_readHandles.size() )
+      {
+         ReadHandle* handle = m_readHandles.back();
+         m_readHandles.pop_back();
+         return handle;
+      }
+   }
+
+   //---
+   // None free so open another.  libtiff only reads the first directory
+   // here; others are read on demand by TIFFSetDirectory.
+   //---
+   ReadHandle* handle = new ReadHandle();
+   handle->m_streamAdaptor =
+      std::make_shared<ossim::TiffIStreamAdaptor>( theImageFile.string() );
+   if ( handle->m_streamAdaptor->getStream() )
+   {
+      handle->m_tiffPtr = XTIFFClientOpen(theImageFile.c_str(), "rm",
+                                          (thandle_t)handle->m_streamAdaptor.get(),
+                                          ossim::TiffIStreamAdaptor::tiffRead,
+                                          ossim::TiffIStreamAdaptor::tiffWrite,
+                                          ossim::TiffIStreamAdaptor::tiffSeek,
+                                          ossim::TiffIStreamAdaptor::tiffClose,
+                                          ossim::TiffIStreamAdaptor::tiffSize,
+                                          ossim::TiffIStreamAdaptor::tiffMap,
+                                          ossim::TiffIStreamAdaptor::tiffUnmap);
+   }
+   if ( !handle->m_tiffPtr )
+   {
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_WARN)
+            << "ossimTiffTileSource::acquireReadHandle WARNING:\n"
+            << "libtiff could not open " << theImageFile << endl;
+      }
+      delete handle;
+      handle = 0;
+   }
+   return handle;
+}
+
+void ossimTiffTileSource::releaseReadHandle(ReadHandle* handle)
+{
+   std::lock_guard<std::mutex> lock(m_readHandleMutex);
+   m_readHandles.push_back(handle);
+}
+
+void ossimTiffTileSource::closeReadHandles()
+{
+   std::lock_guard<std::mutex> lock(m_readHandleMutex);
+   for ( std::size_t i = 0; i < m_readHandles.size(); ++i )
+   {
+      delete m_readHandles[i];
+   }
+   m_readHandles.clear();
+}
+
 bool ossimTiffTileSource::loadFromRgbaU8Tile(const ossimIrect& tile_rect,
                                              const ossimIrect& clip_rect,
                                              ossimImageData* result)
@@ -1863,17 +2441,19 @@ bool ossimTiffTileSource::loadFromU16Strip( const ossimIrect& clip_rect, ossimIm
 } // End: ossimTiffTileSource::loadFromU16Strip( ... )
 
 void ossimTiffTileSource::adjustToStartOfTile(ossimIpt& pt) const
+{
+   adjustToStartOfTile( pt,
+                        static_cast<ossim_int32>(theImageTileWidth[theCurrentDirectory]),
+                        static_cast<ossim_int32>(theImageTileLength[theCurrentDirectory]) );
+}
+
+void ossimTiffTileSource::adjustToStartOfTile(ossimIpt& pt, ossim_int32 tw, ossim_int32 th)
 {
    //***
    // Notes:
    // - Assumes an origin of (0,0)
    // - Shifts in to the upper left direction.
    //***
-   ossim_int32 tw =
-      static_cast<ossim_int32>(theImageTileWidth[theCurrentDirectory]);
-   ossim_int32 th =
-      static_cast<ossim_int32>(theImageTileLength[theCurrentDirectory]);
-   
    if (pt.x > 0)
    {
       pt.x = (pt.x/tw) * tw;
@@ -2093,6 +2673,12 @@ std::ostream& ossimTiffTileSource::print(std::ostream& os) const
       os << "\nOutput tile dump:\n" << *theTile << endl;
    }
 
+   if (m_prefetcher)
+   {
+      os << "\nprefetch_tiles:                " << m_prefetchTiles << "\n";
+      m_prefetcher->print(os);
+   }
+
    if (theOverview.valid())
    {
       os << "\nOverview file:\n";
@@ -2310,6 +2896,14 @@ void ossimTiffTileSource::setProperty(ossimRefPtr<ossimProperty> property)
       // Assuming first directory...
       setApplyColorPaletteFlag(property->valueToString().toBool());
    }
+   else if(property->getName() == "prefetch_tiles")
+   {
+      setNumberOfPrefetchTiles(property->valueToString().toUInt32());
+   }
+   else if(property->getName() == "concurrent_reads")
+   {
+      setConcurrentReads(property->valueToString().toBool());
+   }
    else
    {
       ossimImageHandler::setProperty(property);
@@ -2330,6 +2924,28 @@ ossimRefPtr<ossimProperty> ossimTiffTileSource::getProperty(const ossimString& n
 	{
 		return new ossimStringProperty(name, "TIFF");
 	}
+   else if(name == "prefetch_tiles")
+   {
+      ossimNumericProperty* property =
+         new ossimNumericProperty(name, ossimString::toString(m_prefetchTiles), 0, 4096);
+      property->setNumericType(ossimNumericProperty::ossimNumericPropertyType_UINT);
+      return property;
+   }
+   else if(name == "concurrent_reads")
+   {
+      return new ossimBooleanProperty(name, m_concurrentReads);
+   }
+   else if(name == "prefetch_statistics")
+   {
+      std::ostringstream out;
+      if ( m_prefetcher )
+      {
+         m_prefetcher->print(out);
+      }
+      ossimStringProperty* property = new ossimStringProperty(name, out.str());
+      property->setReadOnlyFlag(true);
+      return property;
+   }
 	
    return ossimImageHandler::getProperty(name);
 }
@@ -2339,6 +2955,9 @@ void ossimTiffTileSource::getPropertyNames(std::vector<ossimString>& propertyNam
    ossimImageHandler::getPropertyNames(propertyNames);
    propertyNames.push_back("file_type");
    propertyNames.push_back("apply_color_palette_flag");
+   propertyNames.push_back("prefetch_tiles");
+   propertyNames.push_back("prefetch_statistics");
+   propertyNames.push_back("concurrent_reads");
 }
 
 bool ossimTiffTileSource::setTiffDirectory(ossim_uint16 directory)
@@ -12,6 +12,7 @@
 //  $Id$
 #include <ossim/parallel/ossimImageHandlerMtAdaptor.h>
 #include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/imaging/ossimImageDataFactory.h>
   // #include <ossim/parallel/ossimMtDebug.h>
 #include <ossim/base/ossimCommon.h>
 #include <ossim/base/ossimTimer.h>
@@ -157,6 +158,19 @@ ossimRefPtr<ossimImageData>
    if (!m_adaptedHandler.valid())
       return NULL;
 
+   // Handlers that read concurrently fill a tile of our own with no lock:
+   if (!d_useCache && m_adaptedHandler->supportsConcurrentReads())
+   {
+      ossimRefPtr<ossimImageData> tile =
+         ossimImageDataFactory::instance()->create(this, this);
+      if (!tile.valid())
+         return NULL;
+      tile->setImageRectangle(tile_rect);
+      if (!m_adaptedHandler->getTile(tile.get(), rLevel))
+         tile->makeBlank();
+      return tile;
+   }
+
    // The sole purpose of the adapter is this mutex lock around the actual handler getTile:
    //std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -213,6 +227,9 @@ bool ossimImageHandlerMtAdaptor::getTile(ossimImageData* tile, ossim_uint32 rLev
    if ((!m_adaptedHandler.valid()) || (tile == NULL))
       return false;
 
+   if (!d_useCache && m_adaptedHandler->supportsConcurrentReads())
+      return m_adaptedHandler->getTile(tile, rLevel);
+
    // The sole purpose of the adapter is this mutex lock around the actual handler getTile:
    std::lock_guard<std::mutex> lock(m_mutex);
 
@@ -108,6 +108,30 @@ bool ossimJobMultiThreadQueue::hasJobsToProcess()const
    return result;
 }
 
+void ossimJobMultiThreadQueue::waitAll()
+{
+   std::shared_ptr<ossimJobQueue> jobQueue = getJobQueue();
+   if(jobQueue) jobQueue->waitAll();
+}
+
+bool ossimJobMultiThreadQueue::waitAll(ossim_uint64 waitTimeMillis)
+{
+   std::shared_ptr<ossimJobQueue> jobQueue = getJobQueue();
+   return jobQueue ? jobQueue->waitAll(waitTimeMillis) : true;
+}
+
+ossim_uint32 ossimJobMultiThreadQueue::waitAny()
+{
+   std::shared_ptr<ossimJobQueue> jobQueue = getJobQueue();
+   return jobQueue ? jobQueue->waitAny() : 0;
+}
+
+ossim_uint32 ossimJobMultiThreadQueue::getNumberOfPendingJobs()const
+{
+   std::shared_ptr<ossimJobQueue> jobQueue = getJobQueue();
+   return jobQueue ? jobQueue->getNumberOfPendingJobs() : 0;
+}
+
 void ossimJobMultiThreadQueue::cancel()
 {
    for(auto thread:m_threadQueueList)
@@ -1,8 +1,16 @@
 #include <ossim/parallel/ossimJobQueue.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimTrace.h>
 
 #include <algorithm> /* for std::find */
+#include <chrono>
+
+static ossimTrace traceDebug("ossimJobQueue:debug");
 
 ossimJobQueue::ossimJobQueue()
+:  m_pendingCount(0),
+   m_completedCount(0),
+   m_pendingWaiters(0)
 {
 }
 
@@ -16,7 +24,7 @@ void ossimJobQueue::add(std::shared_ptr<ossimJob> job,
          
          if(guaranteeUniqueFlag)
          {
-            if(findByPointer(job) != m_jobQueue.end())
+            if(hasJob(job))
             {
                m_block.set(true);
                return;
@@ -29,6 +37,8 @@ void ossimJobQueue::add(std::shared_ptr<ossimJob> job,
       job->ready();
       m_jobQueueMutex.lock();
       m_jobQueue.push_back(job);
+      m_jobIndex.insert(job.get());
+      addPending();
       m_jobQueueMutex.unlock();
    }
    if(cb)
@@ -49,7 +59,8 @@ std::shared_ptr<ossimJob> ossimJobQueue::removeByName(const ossimString& name)
       if(iter!=m_jobQueue.end())
       {
          result = *iter;
-         m_jobQueue.erase(iter);
+         eraseJob(iter);
+         releasePending(1);
       }
       cb = m_callback;
    }      
@@ -72,7 +83,8 @@ std::shared_ptr<ossimJob> ossimJobQueue::removeById(const ossimString& id)
       if(iter!=m_jobQueue.end())
       {
          result = *iter;
-         m_jobQueue.erase(iter);
+         eraseJob(iter);
+         releasePending(1);
       }
       cb = m_callback;
       m_block.set(!m_jobQueue.empty());
@@ -90,11 +102,12 @@ void ossimJobQueue::remove(const std::shared_ptr<ossimJob> job)
    std::shared_ptr<Callback> cb;
    {
       std::lock_guard<std::mutex> lock(m_jobQueueMutex);
-      ossimJob::List::iterator iter = std::find(m_jobQueue.begin(), m_jobQueue.end(), job);
-      if(iter!=m_jobQueue.end())
+      if(hasJob(job))
       {
+         ossimJob::List::iterator iter = findByPointer(job);
          removedJob = (*iter);
-         m_jobQueue.erase(iter);
+         eraseJob(iter);
+         releasePending(1);
       }
       cb = m_callback;
    }
@@ -117,13 +130,14 @@ void ossimJobQueue::removeStoppedJobs()
          if((*iter)->isStopped())
          {
             removedJobs.push_back(*iter);
-            iter = m_jobQueue.erase(iter);
+            iter = eraseJob(iter);
          }
          else 
          {
             ++iter;
          }
       }
+      releasePending((ossim_uint32) removedJobs.size());
    }
    if(!removedJobs.empty())
    {
@@ -142,11 +156,13 @@ void ossimJobQueue::removeStoppedJobs()
 
 void ossimJobQueue::clear()
 {
-   ossimJob::List removedJobs(m_jobQueue);
+   ossimJob::List removedJobs;
    std::shared_ptr<Callback> cb;
    {
       std::lock_guard<std::mutex> lock(m_jobQueueMutex);
-      m_jobQueue.clear();
+      removedJobs.swap(m_jobQueue);
+      m_jobIndex.clear();
+      releasePending((ossim_uint32) removedJobs.size());
       cb = m_callback;
    }
    if(cb)
@@ -182,12 +198,13 @@ std::shared_ptr<ossimJob> ossimJobQueue::nextJob(bool blockIfEmptyFlag)
          (((*iter)->isCanceled())))
    {
       (*iter)->finished(); // mark the ob as being finished 
-      iter = m_jobQueue.erase(iter);
+      iter = eraseJob(iter);
+      releasePending(1);
    }
    if(iter != m_jobQueue.end())
    {
       result = *iter;
-      m_jobQueue.erase(iter);
+      eraseJob(iter);
    }
    m_block.set(!m_jobQueue.empty());
 
@@ -278,17 +295,93 @@ ossimJob::List::iterator ossimJobQueue::findByNameOrPointer(const std::shared_pt
 
 bool ossimJobQueue::hasJob(std::shared_ptr<ossimJob> job)
 {
-   ossimJob::List::const_iterator iter = m_jobQueue.begin();
-   while(iter != m_jobQueue.end())
+   return (m_jobIndex.find(job.get()) != m_jobIndex.end());
+}
+
+ossimJob::List::iterator ossimJobQueue::eraseJob(ossimJob::List::iterator iter)
+{
+   std::unordered_multiset<const ossimJob*>::iterator indexIter = m_jobIndex.find(iter->get());
+   if(indexIter != m_jobIndex.end())
    {
-      if(job == (*iter))
-      {
-         return true;
-      }
-      ++iter;
+      m_jobIndex.erase(indexIter);
+   }
+   return m_jobQueue.erase(iter);
+}
+
+void ossimJobQueue::jobCompleted(std::shared_ptr<ossimJob> /* job */)
+{
+   releasePending(1);
+}
+
+ossim_uint32 ossimJobQueue::getNumberOfPendingJobs()const
+{
+   return m_pendingCount.load();
+}
+
+void ossimJobQueue::waitAll()
+{
+   std::unique_lock<std::mutex> lock(m_pendingMutex);
+   ++m_pendingWaiters;
+   m_pendingCondition.wait(lock, [this]{ return m_pendingCount.load() == 0; });
+   --m_pendingWaiters;
+}
+
+bool ossimJobQueue::waitAll(ossim_uint64 waitTimeMillis)
+{
+   std::unique_lock<std::mutex> lock(m_pendingMutex);
+   ++m_pendingWaiters;
+   bool result = m_pendingCondition.wait_for(lock,
+                                             std::chrono::milliseconds(waitTimeMillis),
+                                             [this]{ return m_pendingCount.load() == 0; });
+   --m_pendingWaiters;
+   return result;
+}
+
+ossim_uint32 ossimJobQueue::waitAny()
+{
+   std::unique_lock<std::mutex> lock(m_pendingMutex);
+   ++m_pendingWaiters;
+   ossim_uint64 completedCount = m_completedCount.load();
+   m_pendingCondition.wait(lock, [this, completedCount]{
+      return (m_pendingCount.load() == 0) || (m_completedCount.load() != completedCount);
+   });
+   --m_pendingWaiters;
+   return m_pendingCount.load();
+}
+
+void ossimJobQueue::addPending()
+{
+   ++m_pendingCount;
+}
+
+void ossimJobQueue::releasePending(ossim_uint32 count)
+{
+   if (count == 0)
+      return;
+
+   ossim_uint32 pending = m_pendingCount.load();
+   ossim_uint32 remaining = 0;
+   do
+   {
+      remaining = (pending > count) ? (pending - count) : 0;
+   } while (!m_pendingCount.compare_exchange_weak(pending, remaining));
+   m_completedCount += count;
+
+   // More released than added means a job was released twice:
+   if (traceDebug() && (pending < count))
+   {
+      ossimNotify(ossimNotifyLevel_WARN)
+         << "ossimJobQueue::releasePending WARNING: released " << count << " with "
+         << pending << " pending." << std::endl;
+   }
+
+   // The waiter count is raised before a waiter tests its predicate, so either the
+   // waiter sees the new count or we see the waiter:
+   if (m_pendingWaiters.load() > 0)
+   {
+      std::lock_guard<std::mutex> lock(m_pendingMutex);
+      m_pendingCondition.notify_all();
    }
-   
-   return false;
 }
 
 void ossimJobQueue::setCallback(std::shared_ptr<Callback> c)
@@ -0,0 +1,321 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+//**************************************************************************************************
+#include <ossim/parallel/ossimJobStealingQueue.h>
+#include <ossim/base/ossimCommon.h>
+#include <cstddef>
+
+namespace
+{
+   // Lane binding of the calling consumer thread.  A thread normally pulls from a single
+   // queue, so one slot is enough; pulling from another queue simply rebinds it.
+   struct ConsumerBinding
+   {
+      const ossimJobStealingQueue* m_queue;
+      ossim_uint32                 m_lane;
+   };
+   thread_local ConsumerBinding t_binding = { 0, 0 };
+}
+
+ossimJobStealingQueue::ossimJobStealingQueue(ossim_uint32 numberOfLanes)
+:  m_lanes(),
+   m_size(0),
+   m_nextProducerLane(0),
+   m_nextConsumerLane(0),
+   m_idleCount(0),
+   m_releaseCount(0)
+{
+   if (numberOfLanes == 0)
+      numberOfLanes = ossim::getNumberOfThreads();
+   if (numberOfLanes == 0)
+      numberOfLanes = 1;
+
+   m_lanes.resize(numberOfLanes);
+   for (ossim_uint32 i = 0; i < numberOfLanes; ++i)
+      m_lanes[i] = new Lane;
+}
+
+ossimJobStealingQueue::~ossimJobStealingQueue()
+{
+   for (ossim_uint32 i = 0; i < m_lanes.size(); ++i)
+      delete m_lanes[i];
+   m_lanes.clear();
+}
+
+ossim_uint32 ossimJobStealingQueue::getNumberOfLanes() const
+{
+   return (ossim_uint32) m_lanes.size();
+}
+
+void ossimJobStealingQueue::add(std::shared_ptr<ossimJob> job, bool guaranteeUniqueFlag)
+{
+   if (!job)
+      return;
+
+   {
+      IndexShard& shard = indexShard(job.get());
+      std::lock_guard<std::mutex> lock(shard.m_mutex);
+      if (guaranteeUniqueFlag && (shard.m_jobs.find(job.get()) != shard.m_jobs.end()))
+         return;
+      shard.m_jobs.insert(job.get());
+   }
+
+   std::shared_ptr<Callback> cb = callback();
+   if (cb)
+      cb->adding(getSharedFromThis(), job);
+
+   job->ready();
+
+   // Consumers keep follow-on work local, everybody else spreads it:
+   ossim_uint32 laneIdx;
+   if (t_binding.m_queue == this)
+      laneIdx = consumerLane(false);
+   else
+      laneIdx = m_nextProducerLane.fetch_add(1);
+
+   // Counted before it becomes visible so a fast consumer cannot complete it first:
+   addPending();
+
+   Lane& lane = *m_lanes[laneIdx % m_lanes.size()];
+   {
+      std::lock_guard<std::mutex> lock(lane.m_mutex);
+      lane.m_jobs.push_back(job);
+      ++lane.m_count;
+   }
+   ++m_size;
+
+   if (cb)
+      cb->added(getSharedFromThis(), job);
+
+   // Only touch the wait mutex when somebody is actually waiting. The idle count is
+   // incremented before the waiter tests m_size, so one of the two always sees the other.
+   if (m_idleCount.load() > 0)
+   {
+      std::lock_guard<std::mutex> lock(m_waitMutex);
+      m_waitCondition.notify_one();
+   }
+}
+
+std::shared_ptr<ossimJob> ossimJobStealingQueue::nextJob(bool blockIfEmptyFlag)
+{
+   ossim_uint32 lane = consumerLane(true);
+   ossim_uint32 releaseCount = m_releaseCount.load();
+
+   std::shared_ptr<ossimJob> job = popJob(lane);
+   while (!job && blockIfEmptyFlag)
+   {
+      {
+         std::unique_lock<std::mutex> lock(m_waitMutex);
+         ++m_idleCount;
+         m_waitCondition.wait(lock, [this, releaseCount]{
+            return (m_size.load() > 0) || (m_releaseCount.load() != releaseCount);
+         });
+         --m_idleCount;
+      }
+
+      job = popJob(lane);
+      if (m_releaseCount.load() != releaseCount)
+         break;
+   }
+
+   return job;
+}
+
+void ossimJobStealingQueue::releaseBlock()
+{
+   std::lock_guard<std::mutex> lock(m_waitMutex);
+   ++m_releaseCount;
+   m_waitCondition.notify_all();
+}
+
+std::shared_ptr<ossimJob> ossimJobStealingQueue::removeByName(const ossimString& name)
+{
+   std::shared_ptr<ossimJob> result;
+   if (name.empty())
+      return result;
+
+   ossimJob::List removedJobs;
+   removeIf([&name](const std::shared_ptr<ossimJob>& job){ return job->name() == name; },
+            true, removedJobs);
+   if (!removedJobs.empty())
+      result = removedJobs.front();
+   notifyRemoved(removedJobs);
+
+   return result;
+}
+
+std::shared_ptr<ossimJob> ossimJobStealingQueue::removeById(const ossimString& id)
+{
+   std::shared_ptr<ossimJob> result;
+   if (id.empty())
+      return result;
+
+   ossimJob::List removedJobs;
+   removeIf([&id](const std::shared_ptr<ossimJob>& job){ return job->id() == id; },
+            true, removedJobs);
+   if (!removedJobs.empty())
+      result = removedJobs.front();
+   notifyRemoved(removedJobs);
+
+   return result;
+}
+
+void ossimJobStealingQueue::remove(const std::shared_ptr<ossimJob> job)
+{
+   if (!job)
+      return;
+
+   // Avoid scanning the lanes for jobs that are not queued:
+   {
+      IndexShard& shard = indexShard(job.get());
+      std::lock_guard<std::mutex> lock(shard.m_mutex);
+      if (shard.m_jobs.find(job.get()) == shard.m_jobs.end())
+         return;
+   }
+
+   ossimJob::List removedJobs;
+   removeIf([&job](const std::shared_ptr<ossimJob>& j){ return j == job; }, true, removedJobs);
+   notifyRemoved(removedJobs);
+}
+
+void ossimJobStealingQueue::removeStoppedJobs()
+{
+   ossimJob::List removedJobs;
+   removeIf([](const std::shared_ptr<ossimJob>& job){ return job->isStopped(); },
+            false, removedJobs);
+   notifyRemoved(removedJobs);
+}
+
+void ossimJobStealingQueue::clear()
+{
+   ossimJob::List removedJobs;
+   removeIf([](const std::shared_ptr<ossimJob>&){ return true; }, false, removedJobs);
+   notifyRemoved(removedJobs);
+}
+
+bool ossimJobStealingQueue::isEmpty() const
+{
+   return (m_size.load() == 0);
+}
+
+ossim_uint32 ossimJobStealingQueue::size()
+{
+   return m_size.load();
+}
+
+ossim_uint32 ossimJobStealingQueue::consumerLane(bool bindFlag)
+{
+   if ((t_binding.m_queue != this) && bindFlag)
+   {
+      t_binding.m_queue = this;
+      t_binding.m_lane = m_nextConsumerLane.fetch_add(1) % (ossim_uint32) m_lanes.size();
+   }
+   // Modulo guards against a stale binding left by a destroyed queue at the same address:
+   return (t_binding.m_queue == this) ? (t_binding.m_lane % (ossim_uint32) m_lanes.size()) : 0;
+}
+
+std::shared_ptr<ossimJob> ossimJobStealingQueue::popJob(ossim_uint32 lane)
+{
+   std::shared_ptr<ossimJob> job;
+   ossim_uint32 numLanes = (ossim_uint32) m_lanes.size();
+   while (m_size.load() > 0)
+   {
+      // Own lane first, then walk the others starting with the neighbour:
+      for (ossim_uint32 i = 0; (i < numLanes) && !job; ++i)
+      {
+         Lane& victim = *m_lanes[(lane + i) % numLanes];
+         if (victim.m_count.load(std::memory_order_relaxed) > 0)
+            job = popFront(victim);
+      }
+      if (!job)
+         break;
+      if (!job->isCanceled())
+         break;
+
+      job->finished(); // mark the job as being finished
+      job.reset();
+      releasePending(1);
+   }
+   return job;
+}
+
+std::shared_ptr<ossimJob> ossimJobStealingQueue::popFront(Lane& lane)
+{
+   std::shared_ptr<ossimJob> job;
+   {
+      std::lock_guard<std::mutex> lock(lane.m_mutex);
+      if (lane.m_jobs.empty())
+         return job;
+      job = lane.m_jobs.front();
+      lane.m_jobs.pop_front();
+      --lane.m_count;
+   }
+   --m_size;
+   unindex(job.get());
+   return job;
+}
+
+template <class Predicate>
+void ossimJobStealingQueue::removeIf(Predicate pred, bool firstOnly, ossimJob::List& removedJobs)
+{
+   for (ossim_uint32 i = 0; i < m_lanes.size(); ++i)
+   {
+      Lane& lane = *m_lanes[i];
+      std::lock_guard<std::mutex> lock(lane.m_mutex);
+      std::deque<std::shared_ptr<ossimJob> >::iterator iter = lane.m_jobs.begin();
+      while (iter != lane.m_jobs.end())
+      {
+         if (pred(*iter))
+         {
+            removedJobs.push_back(*iter);
+            iter = lane.m_jobs.erase(iter);
+            --lane.m_count;
+            --m_size;
+            if (firstOnly)
+               break;
+         }
+         else
+         {
+            ++iter;
+         }
+      }
+      if (firstOnly && !removedJobs.empty())
+         break;
+   }
+
+   for (ossimJob::List::const_iterator iter = removedJobs.begin(); iter != removedJobs.end(); ++iter)
+      unindex(iter->get());
+   releasePending((ossim_uint32) removedJobs.size());
+}
+
+ossimJobStealingQueue::IndexShard& ossimJobStealingQueue::indexShard(const ossimJob* job)
+{
+   // Heap addresses are aligned, so drop the low bits before picking the shard:
+   std::size_t key = reinterpret_cast<std::size_t>(job);
+   return m_index[((key >> 4) ^ (key >> 12)) % NUMBER_OF_INDEX_SHARDS];
+}
+
+void ossimJobStealingQueue::unindex(const ossimJob* job)
+{
+   IndexShard& shard = indexShard(job);
+   std::lock_guard<std::mutex> lock(shard.m_mutex);
+   std::unordered_multiset<const ossimJob*>::iterator iter = shard.m_jobs.find(job);
+   if (iter != shard.m_jobs.end())
+      shard.m_jobs.erase(iter);
+}
+
+void ossimJobStealingQueue::notifyRemoved(const ossimJob::List& removedJobs)
+{
+   if (removedJobs.empty())
+      return;
+
+   std::shared_ptr<Callback> cb = callback();
+   if (cb)
+   {
+      for (ossimJob::List::const_iterator iter = removedJobs.begin(); iter != removedJobs.end(); ++iter)
+         cb->removed(getSharedFromThis(), *iter);
+   }
+}
@@ -59,11 +59,13 @@ void ossimJobThreadQueue::run()
    bool firstTime = true;
    bool validQueue = true;
    std::shared_ptr<ossimJob> job;
+   std::shared_ptr<ossimJobQueue> jobQueue;
    do
    {
       interrupt();
       // osg::notify(osg::NOTICE)<<"In thread loop "<<this<<std::endl;
       validQueue = isValidQueue();
+      jobQueue = getJobQueue();
       job = nextJob();
       if (job&&!m_doneFlag)
       {
@@ -81,6 +83,10 @@ void ossimJobThreadQueue::run()
             std::lock_guard<std::mutex> lock(m_threadMutex);
             m_currentJob = 0;
          }
+
+         // Let the queue know so anybody in waitAll()/waitAny() is woken:
+         if (jobQueue)
+            jobQueue->jobCompleted(job);
          job.reset();
       }
       
@@ -99,6 +105,10 @@ void ossimJobThreadQueue::run()
    {
       job->cancel();
    }
+   if(job&&jobQueue)
+   {
+      jobQueue->jobCompleted(job);
+   }
    job = 0;
 }
 
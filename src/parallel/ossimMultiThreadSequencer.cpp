@@ -14,6 +14,7 @@
 
 #include <ossim/parallel/ossimMultiThreadSequencer.h>
 #include <ossim/parallel/ossimMtDebug.h>
+#include <ossim/parallel/ossimJobStealingQueue.h>
 #include <ossim/base/ossimIrect.h>
 #include <ossim/base/ossimTimer.h>
 static const ossim_uint32 DEFAULT_MAX_TILE_CACHE_FACTOR = 8; // Must be > 1
@@ -202,7 +203,8 @@ void ossimMultiThreadSequencer::setToStartOfSequence()
 
    // Set up the job queue and fill it with first N jobs:
    ossim_uint32 num_jobs_to_launch =  min<ossim_uint32>(m_numThreads, m_totalNumberOfTiles);
-   std::shared_ptr<ossimJobQueue> jobQueue = std::make_shared<ossimJobQueue>();
+   std::shared_ptr<ossimJobQueue> jobQueue =
+      std::make_shared<ossimJobStealingQueue>(num_jobs_to_launch);
    for (ossim_uint32 chain_id=0; chain_id<num_jobs_to_launch; ++chain_id)
    {
       if (d_debugEnabled)
@@ -9,13 +9,34 @@
 
 RTTI_DEF1(ossimPointBlock, "ossimPointBlock", ossimDataObject)
 
+static const ossimPointRecord::FIELD_CODES FIELD_LIST[ossimPointBlock::NUM_FIELDS] =
+{
+   ossimPointRecord::Intensity,
+   ossimPointRecord::ReturnNumber,
+   ossimPointRecord::NumberOfReturns,
+   ossimPointRecord::Red,
+   ossimPointRecord::Green,
+   ossimPointRecord::Blue,
+   ossimPointRecord::GpsTime,
+   ossimPointRecord::Infrared
+};
+
 ossimPointBlock::ossimPointBlock(ossimSource* owner, ossim_uint32 fields)
 :  ossimDataObject(owner),
-   m_nullPCR(fields),
    m_minMaxValid(false),
    m_fieldCode(0),
    m_isNormalized(false)
 {
+   addFields(fields);
+}
+
+ossimPointBlock::ossimPointBlock(const ossimPointBlock& rhs)
+:  ossimDataObject(rhs),
+   m_minMaxValid(false),
+   m_fieldCode(0),
+   m_isNormalized(false)
+{
+   *this = rhs;
 }
 
 ossimPointBlock::~ossimPointBlock()
@@ -23,11 +44,75 @@ ossimPointBlock::~ossimPointBlock()
 
 }
 
+int ossimPointBlock::fieldIndex(ossimPointRecord::FIELD_CODES fc)
+{
+   // Field codes are single bits starting at Intensity (0x0008):
+   switch (fc)
+   {
+   case ossimPointRecord::Intensity:       return 0;
+   case ossimPointRecord::ReturnNumber:    return 1;
+   case ossimPointRecord::NumberOfReturns: return 2;
+   case ossimPointRecord::Red:             return 3;
+   case ossimPointRecord::Green:           return 4;
+   case ossimPointRecord::Blue:            return 5;
+   case ossimPointRecord::GpsTime:         return 6;
+   case ossimPointRecord::Infrared:        return 7;
+   default:
+      break;
+   }
+   return -1;
+}
+
+void ossimPointBlock::reserve(ossim_uint32 numPoints)
+{
+   m_pointIds.reserve(numPoints);
+   m_lat.reserve(numPoints);
+   m_lon.reserve(numPoints);
+   m_hgt.reserve(numPoints);
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+   {
+      if (m_fieldCode & FIELD_LIST[f])
+         m_fields[f].reserve(numPoints);
+   }
+}
+
+void ossimPointBlock::clear()
+{
+   m_pointIds.clear();
+   m_lat.clear();
+   m_lon.clear();
+   m_hgt.clear();
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+      m_fields[f].clear();
+   m_pointList.clear();
+   m_isNormalized = false;
+   m_minMaxValid = false;
+}
+
+void ossimPointBlock::addFields(ossim_uint32 code)
+{
+   ossim_uint32 new_fields = (code & ossimPointRecord::All) & ~m_fieldCode;
+   if (!new_fields)
+      return;
+
+   // Backfill any new columns with nulls for the points already stored:
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+   {
+      if (new_fields & FIELD_LIST[f])
+         m_fields[f].assign(m_pointIds.size(), ossim::nan());
+   }
+   m_fieldCode |= new_fields;
+   m_minMaxValid = false;
+}
+
 void ossimPointBlock::getFieldMin(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const
 {
    if (empty())
+   {
       value = ossim::nan();
-   else if (!m_minMaxValid)
+      return;
+   }
+   if (!m_minMaxValid)
       scanForMinMax();
 
    value = m_minRecord.getField(field);
@@ -36,8 +121,11 @@ void ossimPointBlock::getFieldMin(ossimPointRecord::FIELD_CODES field, ossim_flo
 void ossimPointBlock::getFieldMax(ossimPointRecord::FIELD_CODES field, ossim_float32& value) const
 {
    if (empty())
+   {
       value = ossim::nan();
-   else if (!m_minMaxValid)
+      return;
+   }
+   if (!m_minMaxValid)
       scanForMinMax();
 
    value = m_maxRecord.getField(field);
@@ -52,30 +140,98 @@ void ossimPointBlock::getBounds(ossimGrect& block_bounds) const
    block_bounds = ossimGrect(m_minRecord.getPosition(), m_maxRecord.getPosition());
 }
 
-const ossimPointRecord* ossimPointBlock::getPoint(ossim_uint32 point_offset) const
+ossimPointBlock::PointView ossimPointBlock::getPoint(ossim_uint32 point_offset) const
+{
+   if (point_offset < size())
+      return PointView(this, point_offset);
+   return PointView(0, 0);
+}
+
+const ossimPointBlock::PointList& ossimPointBlock::getPoints() const
+{
+   ossim_uint32 numPoints = size();
+   m_pointList.resize(numPoints);
+   for (ossim_uint32 i=0; i<numPoints; ++i)
+   {
+      m_pointList[i] = new ossimPointRecord(m_fieldCode);
+      getRecord(i, *m_pointList[i]);
+   }
+   return m_pointList;
+}
+
+ossimPointBlock::PointList& ossimPointBlock::getPoints()
+{
+   return const_cast<PointList&>(static_cast<const ossimPointBlock*>(this)->getPoints());
+}
+
+void ossimPointBlock::setPosition(ossim_uint32 i, const ossimGpt& p)
+{
+   m_lat[i] = p.lat;
+   m_lon[i] = p.lon;
+   m_hgt[i] = p.hgt;
+   m_minMaxValid = false;
+}
+
+ossim_float32 ossimPointBlock::getField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc) const
+{
+   int f = fieldIndex(fc);
+   if ((f < 0) || m_fields[f].empty())
+      return ossim::nan();
+   return m_fields[f][i];
+}
+
+void ossimPointBlock::setField(ossim_uint32 i, ossimPointRecord::FIELD_CODES fc, ossim_float32 v)
+{
+   int f = fieldIndex(fc);
+   if (f < 0)
+      return;
+   if (!(m_fieldCode & fc))
+      addFields(fc);
+   m_fields[f][i] = v;
+   m_minMaxValid = false;
+}
+
+const ossim_float32* ossimPointBlock::getFieldBuf(ossimPointRecord::FIELD_CODES fc) const
+{
+   int f = fieldIndex(fc);
+   if ((f < 0) || m_fields[f].empty())
+      return 0;
+   return &m_fields[f].front();
+}
+
+ossim_float32* ossimPointBlock::getFieldBuf(ossimPointRecord::FIELD_CODES fc)
 {
-   if (point_offset < m_pointList.size())
-      return m_pointList[point_offset].get();
-   return 0;
+   int f = fieldIndex(fc);
+   if ((f < 0) || m_fields[f].empty())
+      return 0;
+   m_minMaxValid = false; // Caller may modify values
+   return &m_fields[f].front();
 }
 
-ossimPointRecord* ossimPointBlock::getPoint(ossim_uint32 point_offset)
+void ossimPointBlock::getRecord(ossim_uint32 i, ossimPointRecord& record) const
 {
-   if (point_offset < m_pointList.size())
-      return m_pointList[point_offset].get();
-   return 0;
+   record = ossimPointRecord(m_fieldCode);
+   record.setPointId(m_pointIds[i]);
+   record.setPosition(getPosition(i));
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+   {
+      if (m_fieldCode & FIELD_LIST[f])
+         record.setField(FIELD_LIST[f], m_fields[f][i]);
+   }
 }
 
 const ossimPointBlock& ossimPointBlock::operator=(const ossimPointBlock& block )
 {
-   ossim_uint32 numPoints = block.size();
-   if (numPoints == 0)
+   if (this == &block)
       return *this;
 
-   for (ossim_uint32 i=0; i<numPoints; ++i)
-      m_pointList.push_back(new ossimPointRecord(*(block[i])));
+   m_pointIds = block.m_pointIds;
+   m_lat = block.m_lat;
+   m_lon = block.m_lon;
+   m_hgt = block.m_hgt;
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+      m_fields[f] = block.m_fields[f];
 
-   m_nullPCR = block.m_nullPCR;
    m_minRecord = block.m_minRecord;
    m_maxRecord = block.m_maxRecord;
    m_minMaxValid = block.m_minMaxValid;
@@ -92,51 +248,102 @@ ossimObject* ossimPointBlock::dup() const
    return copy;
 }
 
-ossim_uint32 ossimPointBlock::getFieldCode() const
+ossim_uint32 ossimPointBlock::getDataSizeInBytes() const
 {
-   if (!m_pointList.empty())
-      m_fieldCode = m_pointList[0]->getFieldCode();
+   ossim_uint32 numPoints = size();
+   ossim_uint32 bytes = numPoints * (sizeof(ossim_uint32) + 3*sizeof(ossim_float64));
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+      bytes += (ossim_uint32) (m_fields[f].size() * sizeof(ossim_float32));
+   return bytes;
+}
 
+ossim_uint32 ossimPointBlock::getFieldCode() const
+{
    return m_fieldCode;
 }
 
 vector<ossimPointRecord::FIELD_CODES> ossimPointBlock::getFieldCodesAsList() const
 {
    vector<ossimPointRecord::FIELD_CODES> code_list;
-   if (m_fieldCode & ossimPointRecord::Intensity)
-      code_list.push_back(ossimPointRecord::Intensity);
-   if (m_fieldCode & ossimPointRecord::ReturnNumber)
-      code_list.push_back(ossimPointRecord::ReturnNumber);
-   if (m_fieldCode & ossimPointRecord::NumberOfReturns)
-      code_list.push_back(ossimPointRecord::NumberOfReturns);
-   if (m_fieldCode & ossimPointRecord::Red)
-      code_list.push_back(ossimPointRecord::Red);
-   if (m_fieldCode & ossimPointRecord::Green)
-      code_list.push_back(ossimPointRecord::Green);
-   if (m_fieldCode & ossimPointRecord::Blue)
-      code_list.push_back(ossimPointRecord::Blue);
-   if (m_fieldCode & ossimPointRecord::GpsTime)
-      code_list.push_back(ossimPointRecord::GpsTime);
-   if (m_fieldCode & ossimPointRecord::Infrared)
-      code_list.push_back(ossimPointRecord::Infrared);
-  return code_list;
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+   {
+      if (m_fieldCode & FIELD_LIST[f])
+         code_list.push_back(FIELD_LIST[f]);
+   }
+   return code_list;
 }
 
 void ossimPointBlock::setFieldCode(ossim_uint32 code)
 {
-   if (getFieldCode() != code)
-      clear();
+   if (m_fieldCode == code)
+      return;
 
-   m_fieldCode = code;
+   clear();
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+      m_fields[f] = std::vector<ossim_float32>();
+   m_fieldCode = 0;
+   addFields(code);
 }
 
-void ossimPointBlock::addPoint(ossimPointRecord* opr)
+ossim_uint32 ossimPointBlock::addPoint(const ossimGpt& position, ossim_uint32 pointId)
 {
-   // First check that the fields match the expected. If not, sync up to this point:
-   if ((opr->getFieldCode() & m_fieldCode) != m_fieldCode)
-      m_fieldCode = opr->getFieldCode();
+   ossim_uint32 index = size();
+   m_pointIds.push_back(pointId);
+   m_lat.push_back(position.lat);
+   m_lon.push_back(position.lon);
+   m_hgt.push_back(position.hgt);
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+   {
+      if (m_fieldCode & FIELD_LIST[f])
+         m_fields[f].push_back(ossim::nan());
+   }
+   m_minMaxValid = false;
+   return index;
+}
+
+void ossimPointBlock::addPoint(ossimPointRecord* record)
+{
+   // Only the values are copied. The record is not referenced, so one on the stack is fine:
+   if (!record)
+      return;
+
+   const std::map<ossimPointRecord::FIELD_CODES, ossim_float32>& field_map = record->getFieldMap();
+   ossim_uint32 code = 0;
+   std::map<ossimPointRecord::FIELD_CODES, ossim_float32>::const_iterator iter = field_map.begin();
+   while (iter != field_map.end())
+   {
+      code |= iter->first;
+      ++iter;
+   }
+   addFields(code);
+
+   ossim_uint32 index = addPoint(record->getPosition(), record->getPointId());
+   iter = field_map.begin();
+   while (iter != field_map.end())
+   {
+      int f = fieldIndex(iter->first);
+      if (f >= 0)
+         m_fields[f][index] = iter->second;
+      ++iter;
+   }
+}
 
-   m_pointList.push_back(ossimRefPtr<ossimPointRecord>(opr));
+void ossimPointBlock::addPoint(const ossimPointBlock& src, ossim_uint32 i)
+{
+   m_pointIds.push_back(src.m_pointIds[i]);
+   m_lat.push_back(src.m_lat[i]);
+   m_lon.push_back(src.m_lon[i]);
+   m_hgt.push_back(src.m_hgt[i]);
+   for (ossim_uint32 f=0; f<NUM_FIELDS; ++f)
+   {
+      if (m_fieldCode & FIELD_LIST[f])
+      {
+         if (src.m_fields[f].empty())
+            m_fields[f].push_back(ossim::nan());
+         else
+            m_fields[f].push_back(src.m_fields[f][i]);
+      }
+   }
    m_minMaxValid = false;
 }
 
@@ -147,92 +354,77 @@ void ossimPointBlock::scanForMinMax() const
       return;
 
    // Latch first point:
-   m_minRecord = *(m_pointList[0].get());
+   getRecord(0, m_minRecord);
    m_maxRecord = m_minRecord;
    ossimGpt minPos (m_minRecord.getPosition());
    ossimGpt maxPos (minPos);
 
-   // For shorthand later:
-   const ossimPointRecord::FIELD_CODES I = ossimPointRecord::Intensity;
-   const ossimPointRecord::FIELD_CODES R = ossimPointRecord::Red;
-   const ossimPointRecord::FIELD_CODES G = ossimPointRecord::Green;
-   const ossimPointRecord::FIELD_CODES B = ossimPointRecord::Blue;
-   const ossimPointRecord::FIELD_CODES S = ossimPointRecord::ReturnNumber;
-   const ossimPointRecord::FIELD_CODES N = ossimPointRecord::NumberOfReturns;
-
-   // If color available, latch the min for all bands as one to minimize color distortion:
-   bool hasRGB = false;
-   if (m_minRecord.hasFields(R|G|B))
-   {
-      hasRGB = true;
-      ossim_float32 r = m_pointList[0]->getField(R);
-      ossim_float32 g = m_pointList[0]->getField(G);
-      ossim_float32 b = m_pointList[0]->getField(B);
-      float minC = std::min(r, std::min(g, b));
-      float maxC = std::max(r, std::max(g, b));
-      m_minRecord.setField(R,   minC);
-      m_minRecord.setField(G, minC);
-      m_minRecord.setField(B,  minC);
-      m_maxRecord.setField(R,   maxC);
-      m_maxRecord.setField(G, maxC);
-      m_maxRecord.setField(B,  maxC);
-   }
-
-   // Now loop over all points in file to latch min/max:
-   for (ossim_uint32 i=0; i<numPoints; ++i)
+   // Position columns are scanned independently for cache-friendly access:
+   for (ossim_uint32 i=1; i<numPoints; ++i)
    {
-      if (m_pointList[i]->getPosition().lat < minPos.lat)
-         minPos.lat = m_pointList[i]->getPosition().lat;
-      if (m_pointList[i]->getPosition().lon < minPos.lon)
-         minPos.lon = m_pointList[i]->getPosition().lon;
-      if (m_pointList[i]->getPosition().hgt < minPos.hgt)
-         minPos.hgt = m_pointList[i]->getPosition().hgt;
-
-      if (m_pointList[i]->getPosition().lat > maxPos.lat)
-         maxPos.lat = m_pointList[i]->getPosition().lat;
-      if (m_pointList[i]->getPosition().lon > maxPos.lon)
-         maxPos.lon = m_pointList[i]->getPosition().lon;
-      if (m_pointList[i]->getPosition().hgt > maxPos.hgt)
-         maxPos.hgt = m_pointList[i]->getPosition().hgt;
-
-      if (m_minRecord.hasFields(I) &&  (m_minRecord.getField(I) > m_pointList[i]->getField(I)))
-         m_minRecord.setField(I, m_pointList[i]->getField(I));
-
-      if (m_minRecord.hasFields(S) &&  (m_minRecord.getField(S) > m_pointList[i]->getField(S)))
-         m_minRecord.setField(S, m_pointList[i]->getField(S));
+      if (m_lat[i] < minPos.lat) minPos.lat = m_lat[i];
+      if (m_lat[i] > maxPos.lat) maxPos.lat = m_lat[i];
+   }
+   for (ossim_uint32 i=1; i<numPoints; ++i)
+   {
+      if (m_lon[i] < minPos.lon) minPos.lon = m_lon[i];
+      if (m_lon[i] > maxPos.lon) maxPos.lon = m_lon[i];
+   }
+   for (ossim_uint32 i=1; i<numPoints; ++i)
+   {
+      if (m_hgt[i] < minPos.hgt) minPos.hgt = m_hgt[i];
+      if (m_hgt[i] > maxPos.hgt) maxPos.hgt = m_hgt[i];
+   }
 
-      if (m_minRecord.hasFields(N) &&  (m_minRecord.getField(N) > m_pointList[i]->getField(N)))
-         m_minRecord.setField(N, m_pointList[i]->getField(N));
+   // Intensity and return counts latch their extremes independently:
+   const ossimPointRecord::FIELD_CODES SCALAR_FIELDS[3] =
+   {
+      ossimPointRecord::Intensity,
+      ossimPointRecord::ReturnNumber,
+      ossimPointRecord::NumberOfReturns
+   };
+   for (int k=0; k<3; ++k)
+   {
+      const ossim_float32* column = getFieldBuf(SCALAR_FIELDS[k]);
+      if (!column)
+         continue;
+      ossim_float32 minV = column[0];
+      ossim_float32 maxV = column[0];
+      for (ossim_uint32 i=1; i<numPoints; ++i)
+      {
+         if (column[i] < minV) minV = column[i];
+         if (column[i] > maxV) maxV = column[i];
+      }
+      m_minRecord.setField(SCALAR_FIELDS[k], minV);
+      m_maxRecord.setField(SCALAR_FIELDS[k], maxV);
+   }
 
-      if (hasRGB)
+   // If color available, latch the min for all bands as one to minimize color distortion:
+   const ossim_float32* r = getFieldBuf(ossimPointRecord::Red);
+   const ossim_float32* g = getFieldBuf(ossimPointRecord::Green);
+   const ossim_float32* b = getFieldBuf(ossimPointRecord::Blue);
+   if (r && g && b)
+   {
+      ossim_float32 minC = std::min(r[0], std::min(g[0], b[0]));
+      ossim_float32 maxC = std::max(r[0], std::max(g[0], b[0]));
+      for (ossim_uint32 i=1; i<numPoints; ++i)
       {
-         ossim_float32 r = m_pointList[i]->getField(R);
-         ossim_float32 g = m_pointList[i]->getField(G);
-         ossim_float32 b = m_pointList[i]->getField(B);
-
-         float minC = std::min(r, std::min(g, b));
-         if (m_minRecord.getField(R) > minC)
-         {
-            m_minRecord.setField(R, minC);
-            m_minRecord.setField(G, minC);
-            m_minRecord.setField(B, minC);
-         }
-
-         float maxC = std::max(r, std::max(g, b));
-         if (m_maxRecord.getField(R) < maxC)
-         {
-            m_maxRecord.setField(R, maxC);
-            m_maxRecord.setField(G, maxC);
-            m_maxRecord.setField(B, maxC);
-         }
+         ossim_float32 c = std::min(r[i], std::min(g[i], b[i]));
+         if (c < minC)
+            minC = c;
+         c = std::max(r[i], std::max(g[i], b[i]));
+         if (c > maxC)
+            maxC = c;
       }
-   } // end loop over all points
+      m_minRecord.setField(ossimPointRecord::Red,   minC);
+      m_minRecord.setField(ossimPointRecord::Green, minC);
+      m_minRecord.setField(ossimPointRecord::Blue,  minC);
+      m_maxRecord.setField(ossimPointRecord::Red,   maxC);
+      m_maxRecord.setField(ossimPointRecord::Green, maxC);
+      m_maxRecord.setField(ossimPointRecord::Blue,  maxC);
+   }
 
    m_minRecord.setPosition(minPos);
    m_maxRecord.setPosition(maxPos);
    m_minMaxValid = true;
 }
-
-
-
-
@@ -41,7 +41,7 @@ void ossimPointCloudHandler::getBlock(const ossimGrect& bounds, ossimPointBlock&
 
    // This default implementation simply reads the whole datafile in file-blocks, retaining
    // only those points inside the bounds:
-   ossimPointBlock file_block;
+   ossimPointBlock file_block (0, block.getFieldCode());
    rewind();
    ossimGpt gpt;
 
@@ -49,16 +49,21 @@ void ossimPointCloudHandler::getBlock(const ossimGrect& bounds, ossimPointBlock&
    {
       file_block.clear();
       getNextFileBlock(file_block, DEFAULT_BLOCK_SIZE);
-      ossimPointBlock::PointList& pointList = file_block.getPoints();
-      ossimPointBlock::PointList::iterator iter = pointList.begin();
-      while (iter != pointList.end())
+      if (block.getFieldCode() == 0)
+         block.setFieldCode(file_block.getFieldCode());
+
+      // Scan the position columns directly, copying only the points within the bounds:
+      const ossim_uint32 numPoints = file_block.size();
+      const ossim_float64* lat = file_block.getLatBuf();
+      const ossim_float64* lon = file_block.getLonBuf();
+      const ossim_float64* hgt = file_block.getHgtBuf();
+      for (ossim_uint32 i=0; i<numPoints; ++i)
       {
-         gpt = (*iter)->getPosition();
+         gpt.lat = lat[i];
+         gpt.lon = lon[i];
+         gpt.hgt = hgt[i];
          if (bounds.pointWithin(gpt))
-         {
-            block.addPoint(iter->get());
-         }
-         ++iter;
+            block.addPoint(file_block, i);
       }
    } while (file_block.size() == DEFAULT_BLOCK_SIZE);
 }
@@ -77,23 +82,20 @@ void ossimPointCloudHandler::normalizeBlock(ossimPointBlock& block)
       return;
 
    ossim_uint32 numPoints = block.size();
-   float val, norm, min, max;
+   float norm, min, max;
    vector<ossimPointRecord::FIELD_CODES> field_codes = block.getFieldCodesAsList();
-   vector<ossimPointRecord::FIELD_CODES>::const_iterator iter;
+   vector<ossimPointRecord::FIELD_CODES>::const_iterator iter = field_codes.begin();
    ossimPointRecord::FIELD_CODES field_code;
-   for (ossim_uint32 i=0; i<numPoints; ++i)
+   while (iter != field_codes.end())
    {
-      ossimPointRecord* opr = block[i];
-      iter = field_codes.begin();
-      while (iter != field_codes.end())
-      {
-         field_code = *iter;
-         min = m_minRecord->getField(field_code);
-         max = m_maxRecord->getField(field_code);
-         val = opr->getField(field_code);
-         norm = (val - min) / (max - min);
-         opr->setField(field_code, norm);
-         ++iter;
-      }
+      // Normalize one field column at a time:
+      field_code = *iter;
+      min = m_minRecord->getField(field_code);
+      max = m_maxRecord->getField(field_code);
+      norm = 1.0f / (max - min);
+      ossim_float32* column = block.getFieldBuf(field_code);
+      for (ossim_uint32 i=0; i<numPoints; ++i)
+         column[i] = (column[i] - min) * norm;
+      ++iter;
    }
 }
@@ -41,43 +41,6 @@ static const char* LOWEST_KW = "LOWEST";
 static const char* RETURNS_KW = "RETURNS";
 static const char* RGB_KW = "RGB";
 
-ossimPointCloudImageHandler::PcrBucket::PcrBucket(const ossim_float32* init_value,
-                                                  ossim_uint32 numBands)
-:  m_numSamples (1)
-{
-   m_bucket = new ossim_float32[numBands];
-   for (ossim_uint32 i=0; i<numBands; i++)
-      m_bucket[i] = init_value[i];
-}
-
-
-ossimPointCloudImageHandler::PcrBucket::PcrBucket(const ossim_float32& R,
-      const ossim_float32& G,
-      const ossim_float32& B)
-:  m_numSamples (1)
-{
-   m_bucket = new ossim_float32[3];
-   m_bucket[0] = R;
-   m_bucket[1] = G;
-   m_bucket[2] = B;
-
-}
-
-
-ossimPointCloudImageHandler::PcrBucket::PcrBucket(const ossim_float32& init_value)
-:  m_numSamples (1)
-{
-   m_bucket = new ossim_float32[1];
-   m_bucket[0] = init_value;
-}
-
-
-ossimPointCloudImageHandler::PcrBucket::~PcrBucket()
-{
-   delete [] m_bucket;
-}
-
-
 ossimPointCloudImageHandler::ossimPointCloudImageHandler()
       : ossimImageHandler(),
         m_maxPixel(1.0),
@@ -235,7 +198,6 @@ bool ossimPointCloudImageHandler::getTile(ossimImageData* result, ossim_uint32 r
    const ossimIrect img_tile_rect = result->getImageRectangle();
    const ossimIpt tile_offset (img_tile_rect.ul());
    const ossim_uint32 tile_width = img_tile_rect.width();
-   const ossim_uint32 tile_height = img_tile_rect.height();
    const ossim_uint32 tile_size = img_tile_rect.area();
 
    ossimGpt gnd_ul, gnd_lr;
@@ -257,30 +219,21 @@ bool ossimPointCloudImageHandler::getTile(ossimImageData* result, ossim_uint32 r
       result->makeBlank();
       return false;
    }
-   std::map<ossim_int32, PcrBucket*> accumulator;
+   // Dense, band-sequential accumulator with a sample count per pixel. This replaces a map of
+   // individually allocated buckets and keeps the rasterization loop allocation-free:
+   std::vector<ossim_float32> accumulator (tile_size*numBands, 0.0f);
+   std::vector<ossim_uint32> counts (tile_size, 0);
 
    // initialize a point block with desired fields as requested in the reader properties
    ossimPointBlock pointBlock (this);
    pointBlock.setFieldCode(componentToFieldCode());
    m_pch->rewind();
 
-   ossimDpt ipt;
-   ossimGpt pos;
-
 #define USE_GETBLOCK
 #ifdef USE_GETBLOCK
    m_pch->getBlock(gnd_rect, pointBlock);
-   for (ossim_uint32 id=0; id<pointBlock.size(); ++id)
-   {
-      pos = pointBlock[id]->getPosition();
-      theGeometry->worldToRn(pos, resLevel, ipt);
-      ipt.x = ossim::round<double,double>(ipt.x) - tile_offset.x;
-      ipt.y = ossim::round<double,double>(ipt.y) - tile_offset.y;
-
-      ossim_int32 bucketIndex = ipt.y*tile_width + ipt.x;
-      if ((bucketIndex >= 0) && (bucketIndex < (ossim_int32)tile_size))
-         addSample(accumulator, bucketIndex, pointBlock[id]);
-   }
+   accumulate(pointBlock, 0, resLevel, tile_offset, tile_width, tile_size,
+              &accumulator.front(), &counts.front());
 
 #else // using getFileBlock
    ossim_uint32 numPoints = m_pch->getNumPoints();
@@ -294,142 +247,129 @@ bool ossimPointCloudImageHandler::getTile(ossimImageData* result, ossim_uint32 r
       m_pch->getNextFileBlock(pointBlock, numPoints);
       //m_pch->normalizeBlock(pointBlock);
 
-      for (ossim_uint32 id=0; id<pointBlock.size(); ++id)
-      {
-         // Check that each point in read block is inside the ROI before accumulating it:
-         pos = pointBlock[id]->getPosition();
-         if (gnd_rect.pointWithin(pos))
-         {
-            theGeometry->worldToRn(pos, resLevel, ipt);
-            ipt.x = ossim::round<double,double>(ipt.x) - tile_offset.x;
-            ipt.y = ossim::round<double,double>(ipt.y) - tile_offset.y;
-
-            ossim_int32 bucketIndex = ipt.y*tile_width + ipt.x;
-            if ((bucketIndex >= 0) && (bucketIndex < (ossim_int32)tile_size))
-               addSample(accumulator, bucketIndex, pointBlock[id]);
-         }
-      }
+      // Check that each point in read block is inside the ROI before accumulating it:
+      accumulate(pointBlock, &gnd_rect, resLevel, tile_offset, tile_width, tile_size,
+                 &accumulator.front(), &counts.front());
    } while (pointBlock.size() == numPoints);
 #endif
 
    // Finished accumulating, need to normalize and fill the tile.
    // We must always blank out the tile as we may not have a point for every pixel.
-   normalize(accumulator);
-   auto buf = new ossim_float32*[numBands];
-   std::map<ossim_int32, PcrBucket*>::iterator accum_iter;
+   normalize(&accumulator.front(), &counts.front(), tile_size, numBands);
    ossim_float32 null_pixel = OSSIM_DEFAULT_NULL_PIX_FLOAT;
    result->setNullPix(null_pixel);
    for (ossim_uint32 band = 0; band < numBands; band++)
    {
-      ossim_uint32 index = 0;
-      buf[band] = result->getFloatBuf(band);
-      for (ossim_uint32 y = 0; y < tile_height; y++)
-      {
-         for (ossim_uint32 x = 0; x < tile_width; x++)
-         {
-            accum_iter = accumulator.find(index);
-            if (accum_iter != accumulator.end())
-               buf[band][index] = accum_iter->second->m_bucket[band];
-            else
-               buf[band][index] = null_pixel;
-            ++index;
-         }
-      }
-   }
-
-   delete [] buf;
-   buf = 0;
-
-   auto pcr_iter = accumulator.begin();
-   while (pcr_iter != accumulator.end())
-   {
-      delete pcr_iter->second;
-      pcr_iter++;
+      ossim_float32* buf = result->getFloatBuf(band);
+      const ossim_float32* bucket = &accumulator[band*tile_size];
+      for (ossim_uint32 index = 0; index < tile_size; ++index)
+         buf[index] = counts[index] ? bucket[index] : null_pixel;
    }
 
    result->validate();
    return true;
 }
 
-void ossimPointCloudImageHandler::addSample(std::map<ossim_int32, PcrBucket*>& accumulator,
-                                            ossim_int32 index,
-                                            const ossimPointRecord* sample)
+void ossimPointCloudImageHandler::accumulate(const ossimPointBlock& pointBlock,
+                                             const ossimGrect* roi,
+                                             ossim_uint32 resLevel,
+                                             const ossimIpt& tile_offset,
+                                             ossim_uint32 tile_width,
+                                             ossim_uint32 tile_size,
+                                             ossim_float32* accumulator,
+                                             ossim_uint32* counts)
 {
-   if (sample == 0)
+   const ossim_uint32 numPoints = pointBlock.size();
+   if (numPoints == 0)
       return;
 
-   //cout << "sample: "<<*sample<<endl;//TODO: REMOVE DEBUG
+   // Resolve the columns needed for the active component once, outside of the point loop:
+   const ossim_float64* lat = pointBlock.getLatBuf();
+   const ossim_float64* lon = pointBlock.getLonBuf();
+   const ossim_float64* hgt = pointBlock.getHgtBuf();
+   const ossim_float32* column[3] = { 0, 0, 0 };
+   ossim_uint32 numColumns = 0;
+   if (m_activeComponent == INTENSITY)
+   {
+      column[0] = pointBlock.getFieldBuf(ossimPointRecord::Intensity);
+      numColumns = 1;
+   }
+   else if (m_activeComponent == RGB)
+   {
+      column[0] = pointBlock.getFieldBuf(ossimPointRecord::Red);
+      column[1] = pointBlock.getFieldBuf(ossimPointRecord::Green);
+      column[2] = pointBlock.getFieldBuf(ossimPointRecord::Blue);
+      numColumns = 3;
+   }
+   else if (m_activeComponent == RETURNS)
+   {
+      column[0] = pointBlock.getFieldBuf(ossimPointRecord::NumberOfReturns);
+      numColumns = 1;
+   }
 
-   // Search map for exisiting point in that location:
-   auto iter = accumulator.find(index);
-   if (iter == accumulator.end())
+   // A missing field column means the source does not provide the component:
+   for (ossim_uint32 c=0; c<numColumns; ++c)
    {
-      // First hit. Initialize location with current sample:
-      if (m_activeComponent == INTENSITY)
-      {
-         accumulator[index] = new PcrBucket(sample->getField(ossimPointRecord::Intensity));
-      }
-      else if (m_activeComponent == RGB)
-      {
-         ossim_float32 color[3];
-         color[0] = sample->getField(ossimPointRecord::Red);
-         color[1] = sample->getField(ossimPointRecord::Green);
-         color[2] = sample->getField(ossimPointRecord::Blue);
-         accumulator[index] = new PcrBucket(color, 3);
-      }
-      else if ((m_activeComponent == LOWEST) || (m_activeComponent == HIGHEST))
-         accumulator[index] = new PcrBucket(sample->getPosition().hgt);
-      else if (m_activeComponent == RETURNS)
-         accumulator[index] = new PcrBucket(sample->getField(ossimPointRecord::NumberOfReturns));
+      if (!column[c])
+         return;
    }
-   else
+
+   ossimGpt pos;
+   ossimDpt ipt;
+   for (ossim_uint32 id=0; id<numPoints; ++id)
    {
-      // Not the first hit at this location, accumulate:
-      // First hit. Initialize location with current sample:
-      if (m_activeComponent == INTENSITY)
+      pos.lat = lat[id];
+      pos.lon = lon[id];
+      pos.hgt = hgt[id];
+      if (roi && !roi->pointWithin(pos))
+         continue;
+
+      theGeometry->worldToRn(pos, resLevel, ipt);
+      ipt.x = ossim::round<double,double>(ipt.x) - tile_offset.x;
+      ipt.y = ossim::round<double,double>(ipt.y) - tile_offset.y;
+
+      ossim_int32 index = ipt.y*tile_width + ipt.x;
+      if ((index < 0) || (index >= (ossim_int32)tile_size))
+         continue;
+
+      if ((m_activeComponent == LOWEST) || (m_activeComponent == HIGHEST))
       {
-         iter->second->m_bucket[0] += sample->getField(ossimPointRecord::Intensity);
+         // Highest and lowest elevations latch extremes:
+         ossim_float32 h = (ossim_float32) hgt[id];
+         if ((counts[index] == 0) ||
+             ((m_activeComponent == HIGHEST) && (h > accumulator[index])) ||
+             ((m_activeComponent == LOWEST)  && (h < accumulator[index])))
+         {
+            accumulator[index] = h;
+         }
       }
-      else if (m_activeComponent == RGB)
+      else
       {
-         iter->second->m_bucket[0] += sample->getField(ossimPointRecord::Red);
-         iter->second->m_bucket[1] += sample->getField(ossimPointRecord::Green);
-         iter->second->m_bucket[2] += sample->getField(ossimPointRecord::Blue);
+         for (ossim_uint32 c=0; c<numColumns; ++c)
+            accumulator[c*tile_size + index] += column[c][id];
       }
-      else if ((m_activeComponent == HIGHEST) &&
-            (sample->getPosition().hgt > iter->second->m_bucket[0]))
-         iter->second->m_bucket[0] = sample->getPosition().hgt;
-      else if ((m_activeComponent == LOWEST) &&
-            (sample->getPosition().hgt < iter->second->m_bucket[0]))
-         iter->second->m_bucket[0] = sample->getPosition().hgt;
-      else if (m_activeComponent == RETURNS)
-         iter->second->m_bucket[0] += sample->getField(ossimPointRecord::NumberOfReturns);
-
-      iter->second->m_numSamples++;
+      ++counts[index];
    }
 }
 
-void ossimPointCloudImageHandler::normalize(std::map<ossim_int32, PcrBucket*>& accumulator)
+void ossimPointCloudImageHandler::normalize(ossim_float32* accumulator,
+                                            const ossim_uint32* counts,
+                                            ossim_uint32 tile_size,
+                                            ossim_uint32 numBands)
 {
    // highest and lowest elevations latch extremes, no mean is computed but needs to be normalized
    if ((m_activeComponent == LOWEST) || (m_activeComponent == HIGHEST) ||
          (m_activeComponent == RETURNS))
       return;
 
-   int numBands = 1;
-   if (m_activeComponent == RGB)
-      numBands = 3;
-
-   auto iter = accumulator.begin();
-   ossim_float32 avg;
-   while (iter != accumulator.end())
+   for (ossim_uint32 band=0; band<numBands; ++band)
    {
-      for (int i=0; i<numBands; i++)
+      ossim_float32* bucket = accumulator + band*tile_size;
+      for (ossim_uint32 index=0; index<tile_size; ++index)
       {
-         avg = iter->second->m_bucket[i] / iter->second->m_numSamples;
-         iter->second->m_bucket[i] = avg;
+         if (counts[index] > 1)
+            bucket[index] /= counts[index];
       }
-      iter++;
    }
 }
 
@@ -20,6 +20,7 @@
 #include <ossim/base/ossimDatum.h>
 #include <ossim/base/ossimNotifyContext.h>
 #include <ossim/elevation/ossimElevManager.h>
+#include <vector>
 
 static ossimTrace traceDebug("ossimEquDistCylProjection:debug");
 
@@ -211,6 +212,146 @@ void ossimEquDistCylProjection::lineSampleHeightToWorld(const ossimDpt &lineSamp
    }
 }
 
+void ossimEquDistCylProjection::lineSampleToWorldPoints(const ossimDpt* lineSampPoints,
+                                                        ossim_uint32    count,
+                                                        ossimGpt*       worldPoints) const
+{
+   inverseLineSamplePoints(lineSampPoints, 0, count, worldPoints);
+}
+
+void ossimEquDistCylProjection::lineSampleHeightToWorldPoints(
+   const ossimDpt* lineSampPoints,
+   const double*   heightsAboveEllipsoid,
+   ossim_uint32    count,
+   ossimGpt*       worldPoints) const
+{
+   inverseLineSamplePoints(lineSampPoints, heightsAboveEllipsoid, count, worldPoints);
+}
+
+void ossimEquDistCylProjection::inverseLineSamplePoints(const ossimDpt* lineSampPoints,
+                                                        const double*   heightsAboveEllipsoid,
+                                                        ossim_uint32    count,
+                                                        ossimGpt*       worldPoints) const
+{
+   if ( (theModelTransformUnitType != OSSIM_UNIT_UNKNOWN) || theUlEastingNorthing.hasNans() )
+   {
+      // Uncommon cases, let the single point code handle them:
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         if (heightsAboveEllipsoid)
+         {
+            lineSampleHeightToWorld(lineSampPoints[i], heightsAboveEllipsoid[i], worldPoints[i]);
+         }
+         else
+         {
+            lineSampleToWorld(lineSampPoints[i], worldPoints[i]);
+         }
+      }
+      return;
+   }
+
+   // Same math as lineSampleHeightToWorld() with inverse() inlined:
+   std::vector<ossim_uint32> lookupIdx;
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      const ossimDpt& lineSample = lineSampPoints[i];
+      ossimGpt& gpt = worldPoints[i];
+      if (lineSample.hasNans())
+      {
+         gpt.makeNan();
+         continue;
+      }
+
+      double easting  = theUlEastingNorthing.x + lineSample.x*theMetersPerPixel.x;
+      double northing = theUlEastingNorthing.y - lineSample.y*theMetersPerPixel.y;
+      double lat = (northing - Eqcy_False_Northing) / Ra;
+      double lon = 0.0;
+      if (Ra_Cos_Eqcy_Std_Parallel != 0)
+      {
+         lon = Eqcy_Origin_Long + (easting - Eqcy_False_Easting) / Ra_Cos_Eqcy_Std_Parallel;
+      }
+      gpt.lat = lat*DEG_PER_RAD;
+      gpt.lon = lon*DEG_PER_RAD;
+      gpt.datum(theDatum);
+
+      if (gpt.isLatNan() && gpt.isLonNan())
+      {
+         gpt.makeNan();
+      }
+      else
+      {
+         gpt.hgt = heightsAboveEllipsoid ? heightsAboveEllipsoid[i] : ossim::nan();
+      }
+      if (theElevationLookupFlag)
+      {
+         lookupIdx.push_back(i);
+      }
+   }
+
+   if (!lookupIdx.empty())
+   {
+      std::vector<ossimGpt> lookupPts(lookupIdx.size());
+      for (ossim_uint32 i = 0; i < lookupIdx.size(); ++i)
+      {
+         lookupPts[i] = worldPoints[lookupIdx[i]];
+      }
+      std::vector<double> heights(lookupIdx.size());
+      ossimElevManager::instance()->getHeightsAboveEllipsoid(
+         &lookupPts.front(), (ossim_uint32)lookupPts.size(), &heights.front());
+      for (ossim_uint32 i = 0; i < lookupIdx.size(); ++i)
+      {
+         worldPoints[lookupIdx[i]].hgt = heights[i];
+      }
+   }
+}
+
+void ossimEquDistCylProjection::worldToLineSamplePoints(const ossimGpt* worldPoints,
+                                                        ossim_uint32    count,
+                                                        ossimDpt*       lineSampPoints) const
+{
+   if ( (theModelTransformUnitType != OSSIM_UNIT_UNKNOWN) || theUlEastingNorthing.isNan() )
+   {
+      ossimMapProjection::worldToLineSamplePoints(worldPoints, count, lineSampPoints);
+      return;
+   }
+
+   // Same math as worldToLineSample() with forward() inlined.  Points are
+   // usually all on one datum, so remember the last one found to match ours.
+   const ossimDatum* sameDatum = theDatum;
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      const ossimGpt& worldPoint = worldPoints[i];
+      ossimDpt& lineSample = lineSampPoints[i];
+      if (worldPoint.isLatNan() || worldPoint.isLonNan())
+      {
+         lineSample.makeNan();
+         continue;
+      }
+
+      double latr = worldPoint.latr();
+      double lonr = worldPoint.lonr();
+      if ( theDatum && (worldPoint.datum() != sameDatum) )
+      {
+         if ( *worldPoint.datum() == *theDatum )
+         {
+            sameDatum = worldPoint.datum();
+         }
+         else
+         {
+            ossimGpt gpt = worldPoint;
+            gpt.changeDatum(theDatum);
+            latr = gpt.latr();
+            lonr = gpt.lonr();
+         }
+      }
+
+      double easting  = Ra_Cos_Eqcy_Std_Parallel * (lonr - Eqcy_Origin_Long) + Eqcy_False_Easting;
+      double northing = Ra * latr + Eqcy_False_Northing;
+      lineSample.x = (easting - theUlEastingNorthing.x) / theMetersPerPixel.x;
+      lineSample.y = -(northing - theUlEastingNorthing.y) / theMetersPerPixel.y;
+   }
+}
+
 void ossimEquDistCylProjection::worldToLineSample(const ossimGpt &worldPoint,
                                                   ossimDpt&       lineSample)const
 {
@@ -0,0 +1,470 @@
+//*******************************************************************
+//
+// License:  See top level LICENSE.txt file.
+//
+// DESCRIPTION: Contains definition of ossimImageViewGridTransform.
+//    See header for description.
+//
+//*******************************************************************
+#include <ossim/projection/ossimImageViewGridTransform.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimDblGrid.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
+#include <cmath>
+#include <vector>
+
+RTTI_DEF1(ossimImageViewGridTransform,
+          "ossimImageViewGridTransform",
+          ossimImageViewTransform);
+
+//*****************************************************************************
+// Image x and y at the (BLOCK_CELLS+1)^2 nodes of one block, plus a flag per
+// cell telling if bilinear interpolation of its nodes is within the error
+// bound.
+//*****************************************************************************
+class ossimImageViewGridTransform::Block
+{
+public:
+   //! @return false if the cell holding viewPoint must go to the real transform.
+   bool lookup(const ossimDpt& viewPoint, ossimDpt& imagePoint) const
+   {
+      const ossimDpt& origin  = m_xGrid.origin();
+      const ossimDpt& spacing = m_xGrid.spacing();
+      ossim_int32 col = (ossim_int32) std::floor((viewPoint.x - origin.x) / spacing.x);
+      ossim_int32 row = (ossim_int32) std::floor((viewPoint.y - origin.y) / spacing.y);
+      const ossim_int32 LAST = BLOCK_CELLS - 1;
+      col = (col < 0) ? 0 : ( (col > LAST) ? LAST : col );
+      row = (row < 0) ? 0 : ( (row > LAST) ? LAST : row );
+      if ( !m_cellOk[row*BLOCK_CELLS + col] )
+      {
+         return false;
+      }
+      imagePoint.x = m_xGrid(viewPoint.x, viewPoint.y);
+      imagePoint.y = m_yGrid(viewPoint.x, viewPoint.y);
+      return true;
+   }
+
+   ossimDblGrid      m_xGrid;
+   ossimDblGrid      m_yGrid;
+   std::vector<bool> m_cellOk;
+};
+
+//*****************************************************************************
+// Builds one block for buildGrid().
+//*****************************************************************************
+class ossimImageViewGridTransform::BlockJob : public ossimJob
+{
+public:
+   BlockJob(const ossimImageViewGridTransform* owner, const BlockKey& key)
+      : ossimJob(),
+        m_owner(owner),
+        m_key(key)
+   {
+   }
+
+protected:
+   virtual void run()
+   {
+      m_owner->getBlock(m_key);
+   }
+
+private:
+   const ossimImageViewGridTransform* m_owner;
+   BlockKey                           m_key;
+};
+
+ossimImageViewGridTransform::ossimImageViewGridTransform(ossimImageViewTransform* transform,
+                                                         ossim_uint32 gridSpacing,
+                                                         double maxError,
+                                                         ossim_uint32 maxBlocks)
+   : ossimImageViewTransform(),
+     m_transform(transform),
+     m_gridSpacing(gridSpacing ? gridSpacing : 1),
+     m_maxError(maxError),
+     m_maxBlocks(maxBlocks),
+     m_mutex(),
+     m_blocks(),
+     m_blockOrder(),
+     m_generation(0)
+{
+}
+
+ossimImageViewGridTransform::ossimImageViewGridTransform(const ossimImageViewGridTransform& src)
+   : ossimImageViewTransform(src),
+     m_transform(src.m_transform),
+     m_gridSpacing(src.m_gridSpacing),
+     m_maxError(src.m_maxError),
+     m_maxBlocks(src.m_maxBlocks),
+     m_mutex(),
+     m_blocks(),
+     m_blockOrder(),
+     m_generation(0)
+{
+}
+
+ossimImageViewGridTransform::~ossimImageViewGridTransform()
+{
+}
+
+void ossimImageViewGridTransform::setTransform(ossimImageViewTransform* transform)
+{
+   m_transform = transform;
+   clearGrid();
+}
+
+void ossimImageViewGridTransform::setGridSpacing(ossim_uint32 gridSpacing)
+{
+   m_gridSpacing = gridSpacing ? gridSpacing : 1;
+   clearGrid();
+}
+
+void ossimImageViewGridTransform::setMaxError(double maxError)
+{
+   m_maxError = maxError;
+   clearGrid();
+}
+
+void ossimImageViewGridTransform::setMaxBlocks(ossim_uint32 maxBlocks)
+{
+   m_maxBlocks = maxBlocks;
+   clearGrid();
+}
+
+void ossimImageViewGridTransform::clearGrid()
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_blocks.clear();
+   m_blockOrder.clear();
+   ++m_generation;
+}
+
+ossim_uint32 ossimImageViewGridTransform::getNumberOfBlocks() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return (ossim_uint32) m_blocks.size();
+}
+
+void ossimImageViewGridTransform::buildGrid(const ossimIrect& viewRect,
+                                            ossim_uint32 numberOfThreads)
+{
+   if ( !m_transform.valid() || viewRect.hasNans() || !m_maxBlocks )
+   {
+      return;
+   }
+
+   BlockKey ul = getBlockKey(ossimDpt(viewRect.ul()));
+   BlockKey lr = getBlockKey(ossimDpt(viewRect.lr()));
+   std::vector<BlockKey> keys;
+   for (ossim_int32 by = ul.second; (by <= lr.second) && (keys.size() < m_maxBlocks); ++by)
+   {
+      for (ossim_int32 bx = ul.first; (bx <= lr.first) && (keys.size() < m_maxBlocks); ++bx)
+      {
+         keys.push_back(BlockKey(bx, by));
+      }
+   }
+
+   if ( (numberOfThreads < 2) || (keys.size() < 2) )
+   {
+      for (ossim_uint32 i = 0; i < keys.size(); ++i)
+      {
+         getBlock(keys[i]);
+      }
+      return;
+   }
+
+   std::shared_ptr<ossimJobMultiThreadQueue> jobQueue =
+      std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(),
+         ossim::min<ossim_uint32>(numberOfThreads, (ossim_uint32) keys.size()));
+   for (ossim_uint32 i = 0; i < keys.size(); ++i)
+   {
+      jobQueue->getJobQueue()->add(std::make_shared<BlockJob>(this, keys[i]));
+   }
+   jobQueue->waitAll();
+}
+
+bool ossimImageViewGridTransform::isIdentity() const
+{
+   return m_transform.valid() && m_transform->isIdentity();
+}
+
+bool ossimImageViewGridTransform::isValid() const
+{
+   return m_transform.valid() && m_transform->isValid();
+}
+
+ossimDpt ossimImageViewGridTransform::getInputMetersPerPixel() const
+{
+   ossimDpt result;
+   result.makeNan();
+   if ( m_transform.valid() )
+   {
+      result = m_transform->getInputMetersPerPixel();
+   }
+   return result;
+}
+
+ossimDpt ossimImageViewGridTransform::getOutputMetersPerPixel() const
+{
+   ossimDpt result;
+   result.makeNan();
+   if ( m_transform.valid() )
+   {
+      result = m_transform->getOutputMetersPerPixel();
+   }
+   return result;
+}
+
+void ossimImageViewGridTransform::imageToView(const ossimDpt& imagePoint,
+                                              ossimDpt& viewPoint) const
+{
+   if ( m_transform.valid() )
+   {
+      m_transform->imageToView(imagePoint, viewPoint);
+   }
+   else
+   {
+      viewPoint.makeNan();
+   }
+}
+
+void ossimImageViewGridTransform::imageToViewPoints(const ossimDpt* imagePoints,
+                                                    ossim_uint32 count,
+                                                    ossimDpt* viewPoints) const
+{
+   if ( m_transform.valid() )
+   {
+      m_transform->imageToViewPoints(imagePoints, count, viewPoints);
+   }
+   else
+   {
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         viewPoints[i].makeNan();
+      }
+   }
+}
+
+void ossimImageViewGridTransform::viewToImage(const ossimDpt& viewPoint,
+                                              ossimDpt& imagePoint) const
+{
+   if ( !m_transform.valid() )
+   {
+      imagePoint.makeNan();
+      return;
+   }
+   if ( !viewPoint.hasNans() && m_maxBlocks )
+   {
+      std::shared_ptr<const Block> block = getBlock(getBlockKey(viewPoint));
+      if ( block->lookup(viewPoint, imagePoint) )
+      {
+         return;
+      }
+   }
+   m_transform->viewToImage(viewPoint, imagePoint);
+}
+
+void ossimImageViewGridTransform::viewToImagePoints(const ossimDpt* viewPoints,
+                                                    ossim_uint32 count,
+                                                    ossimDpt* imagePoints) const
+{
+   if ( !m_transform.valid() || !m_maxBlocks )
+   {
+      ossimImageViewTransform::viewToImagePoints(viewPoints, count, imagePoints);
+      return;
+   }
+
+   // Points the grid can't answer go to the real transform in one batch:
+   std::vector<ossimDpt> missPts;
+   std::vector<ossim_uint32> missIdx;
+   std::shared_ptr<const Block> block;
+   BlockKey blockKey;
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      if ( !viewPoints[i].hasNans() )
+      {
+         BlockKey key = getBlockKey(viewPoints[i]);
+         if ( !block || (key != blockKey) )
+         {
+            block    = getBlock(key);
+            blockKey = key;
+         }
+         if ( block->lookup(viewPoints[i], imagePoints[i]) )
+         {
+            continue;
+         }
+      }
+      missPts.push_back(viewPoints[i]);
+      missIdx.push_back(i);
+   }
+
+   if ( !missPts.empty() )
+   {
+      std::vector<ossimDpt> missResults(missPts.size());
+      m_transform->viewToImagePoints(&missPts.front(), (ossim_uint32) missPts.size(),
+                                     &missResults.front());
+      for (ossim_uint32 i = 0; i < missIdx.size(); ++i)
+      {
+         imagePoints[missIdx[i]] = missResults[i];
+      }
+   }
+}
+
+bool ossimImageViewGridTransform::setView(ossimObject* baseObject)
+{
+   bool result = false;
+   if ( m_transform.valid() )
+   {
+      result = m_transform->setView(baseObject);
+   }
+   clearGrid();
+   return result;
+}
+
+ossimObject* ossimImageViewGridTransform::getView()
+{
+   return m_transform.valid() ? m_transform->getView() : 0;
+}
+
+const ossimObject* ossimImageViewGridTransform::getView() const
+{
+   return m_transform.valid() ? m_transform->getView() : 0;
+}
+
+std::ostream& ossimImageViewGridTransform::print(std::ostream& out) const
+{
+   out << "ossimImageViewGridTransform::print:"
+       << "\ngrid spacing: " << m_gridSpacing
+       << "\nmax error:    " << m_maxError
+       << "\nmax blocks:   " << m_maxBlocks
+       << "\nblocks:       " << getNumberOfBlocks() << "\n";
+   if ( m_transform.valid() )
+   {
+      m_transform->print(out);
+   }
+   return out;
+}
+
+ossimImageViewGridTransform::BlockKey
+ossimImageViewGridTransform::getBlockKey(const ossimDpt& viewPoint) const
+{
+   const double BLOCK_SIZE = (double) (BLOCK_CELLS * m_gridSpacing);
+   return BlockKey( (ossim_int32) std::floor(viewPoint.x / BLOCK_SIZE),
+                    (ossim_int32) std::floor(viewPoint.y / BLOCK_SIZE) );
+}
+
+std::shared_ptr<const ossimImageViewGridTransform::Block>
+ossimImageViewGridTransform::getBlock(const BlockKey& key) const
+{
+   ossim_uint32 generation;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      BlockMap::const_iterator iter = m_blocks.find(key);
+      if ( iter != m_blocks.end() )
+      {
+         return iter->second;
+      }
+      generation = m_generation;
+   }
+
+   // Build outside of the lock so other blocks can be looked up meanwhile:
+   std::shared_ptr<const Block> block = buildBlock(key);
+   addBlock(key, block, generation);
+   return block;
+}
+
+std::shared_ptr<const ossimImageViewGridTransform::Block>
+ossimImageViewGridTransform::buildBlock(const BlockKey& key) const
+{
+   const ossim_uint32 NODES   = BLOCK_CELLS + 1;
+   const double       SPACING = (double) m_gridSpacing;
+   const ossimDpt ORIGIN(key.first  * SPACING * BLOCK_CELLS,
+                         key.second * SPACING * BLOCK_CELLS);
+
+   // Nodes first, then cell centers, all through the transform in one batch:
+   std::vector<ossimDpt> vpts(NODES*NODES + BLOCK_CELLS*BLOCK_CELLS);
+   ossim_uint32 idx = 0;
+   ossim_uint32 row;
+   ossim_uint32 col;
+   for (row = 0; row < NODES; ++row)
+   {
+      for (col = 0; col < NODES; ++col)
+      {
+         vpts[idx++] = ossimDpt(ORIGIN.x + col*SPACING, ORIGIN.y + row*SPACING);
+      }
+   }
+   for (row = 0; row < BLOCK_CELLS; ++row)
+   {
+      for (col = 0; col < BLOCK_CELLS; ++col)
+      {
+         vpts[idx++] = ossimDpt(ORIGIN.x + (col + 0.5)*SPACING, ORIGIN.y + (row + 0.5)*SPACING);
+      }
+   }
+   std::vector<ossimDpt> ipts(vpts.size());
+   m_transform->viewToImagePoints(&vpts.front(), (ossim_uint32) vpts.size(), &ipts.front());
+
+   std::shared_ptr<Block> block = std::make_shared<Block>();
+   block->m_xGrid.initialize(ossimIpt(NODES, NODES), ORIGIN, ossimDpt(SPACING, SPACING),
+                             ossim::nan());
+   block->m_yGrid.initialize(ossimIpt(NODES, NODES), ORIGIN, ossimDpt(SPACING, SPACING),
+                             ossim::nan());
+   block->m_xGrid.enableExtrapolation(false);
+   block->m_yGrid.enableExtrapolation(false);
+   for (row = 0; row < NODES; ++row)
+   {
+      for (col = 0; col < NODES; ++col)
+      {
+         const ossimDpt& ipt = ipts[row*NODES + col];
+         block->m_xGrid.setNode(col, row, ipt.x);
+         block->m_yGrid.setNode(col, row, ipt.y);
+      }
+   }
+
+   //---
+   // A cell is used when all its nodes project and the bilinear estimate of
+   // its center (the mean of the nodes) is within the error bound:
+   //---
+   block->m_cellOk.resize(BLOCK_CELLS*BLOCK_CELLS, false);
+   const ossimDpt* centers = &ipts[NODES*NODES];
+   for (row = 0; row < BLOCK_CELLS; ++row)
+   {
+      for (col = 0; col < BLOCK_CELLS; ++col)
+      {
+         const ossimDpt& ul = ipts[row*NODES + col];
+         const ossimDpt& ur = ipts[row*NODES + col + 1];
+         const ossimDpt& ll = ipts[(row + 1)*NODES + col];
+         const ossimDpt& lr = ipts[(row + 1)*NODES + col + 1];
+         const ossimDpt& center = centers[row*BLOCK_CELLS + col];
+         if ( ul.hasNans() || ur.hasNans() || ll.hasNans() || lr.hasNans() || center.hasNans() )
+         {
+            continue;
+         }
+         ossimDpt estimate = (ul + ur + lr + ll) * 0.25;
+         block->m_cellOk[row*BLOCK_CELLS + col] = ( (estimate - center).length() <= m_maxError );
+      }
+   }
+
+   return block;
+}
+
+void ossimImageViewGridTransform::addBlock(const BlockKey& key,
+                                           std::shared_ptr<const Block> block,
+                                           ossim_uint32 generation) const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   if ( (generation != m_generation) || !m_maxBlocks )
+   {
+      return; // Built against a transform that has since changed.
+   }
+   if ( m_blocks.insert(std::make_pair(key, block)).second )
+   {
+      m_blockOrder.push_back(key);
+      while ( m_blocks.size() > m_maxBlocks )
+      {
+         m_blocks.erase(m_blockOrder.front());
+         m_blockOrder.pop_front();
+      }
+   }
+}
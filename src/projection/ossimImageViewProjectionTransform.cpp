@@ -186,6 +186,58 @@ void ossimImageViewProjectionTransform::viewToImage(const ossimDpt& vp, ossimDpt
 #endif
 }
 
+void ossimImageViewProjectionTransform::imageToViewPoints(const ossimDpt* imagePoints,
+                                                          ossim_uint32 count,
+                                                          ossimDpt* viewPoints) const
+{
+   // Only the project-to-ground case has anything to share between points (same tests as
+   // imageToView()):
+   bool throughGround = (m_imageGeometry != m_viewGeometry) &&
+                        m_imageGeometry.valid() && m_viewGeometry.valid() &&
+                        (m_imageGeometry->getProjection() != m_viewGeometry->getProjection());
+   if (!throughGround)
+   {
+      ossimImageViewTransform::imageToViewPoints(imagePoints, count, viewPoints);
+      return;
+   }
+
+   // Project all points to the ground and back in one batch per geometry:
+   std::vector<ossimGpt> gpts(count);
+   if (count)
+   {
+      m_imageGeometry->localToWorldPoints(imagePoints, count, &gpts.front());
+      m_viewGeometry->worldToLocalPoints(&gpts.front(), count, viewPoints);
+   }
+}
+
+void ossimImageViewProjectionTransform::viewToImagePoints(const ossimDpt* viewPoints,
+                                                          ossim_uint32 count,
+                                                          ossimDpt* imagePoints) const
+{
+   // Only the project-to-ground case has anything to share between points:
+   bool throughGround = (m_imageGeometry != m_viewGeometry) &&
+                        m_imageGeometry.valid() && m_viewGeometry.valid();
+   if (throughGround)
+   {
+      const ossimProjection* iproj = m_imageGeometry->getProjection();
+      const ossimProjection* vproj = m_viewGeometry->getProjection();
+      throughGround = !((iproj && vproj && iproj->isEqualTo(*vproj)) || (iproj == vproj));
+   }
+   if (!throughGround)
+   {
+      ossimImageViewTransform::viewToImagePoints(viewPoints, count, imagePoints);
+      return;
+   }
+
+   // Project all points to the ground and back in one batch per geometry:
+   std::vector<ossimGpt> gpts(count);
+   if (count)
+   {
+      m_viewGeometry->localToWorldPoints(viewPoints, count, &gpts.front());
+      m_imageGeometry->worldToLocalPoints(&gpts.front(), count, imagePoints);
+   }
+}
+
 void ossimImageViewProjectionTransform::getViewSegments(std::vector<ossimDrect>& viewBounds, 
                                                       ossimPolyArea2d& polyArea,
                                                       ossim_uint32 numberOfEdgePoints)const
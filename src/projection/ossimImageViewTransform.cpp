@@ -38,6 +38,26 @@ void ossimImageViewTransform::viewToImage(const ossimDpt& viewPoint,
    ossim2dTo2dTransform::inverse(viewPoint, imagePoint);
 }
 
+void ossimImageViewTransform::imageToViewPoints(const ossimDpt* imagePoints,
+                                                ossim_uint32    count,
+                                                ossimDpt*       viewPoints)const
+{
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      imageToView(imagePoints[i], viewPoints[i]);
+   }
+}
+
+void ossimImageViewTransform::viewToImagePoints(const ossimDpt* viewPoints,
+                                                ossim_uint32    count,
+                                                ossimDpt*       imagePoints)const
+{
+   for(ossim_uint32 i = 0; i < count; ++i)
+   {
+      viewToImage(viewPoints[i], imagePoints[i]);
+   }
+}
+
 ossimDpt ossimImageViewTransform::imageToView(const ossimDpt& imagePoint)const
 {
    ossimDpt tempPt;
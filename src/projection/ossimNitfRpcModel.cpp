@@ -270,6 +270,21 @@ void ossimNitfRpcModel::worldToLineSample(const ossimGpt& world_point,
    image_point.y = image_point.y * theDecimation;
 }
 
+void ossimNitfRpcModel::worldToLineSamplePoints(const ossimGpt* world_points,
+                                                ossim_uint32    count,
+                                                ossimDpt*       image_points) const
+{
+   // Get the full res (not decimated) points.
+   ossimRpcModel::worldToLineSamplePoints(world_points, count, image_points);
+
+   // Apply decimation.
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      image_points[i].x = image_points[i].x * theDecimation;
+      image_points[i].y = image_points[i].y * theDecimation;
+   }
+}
+
 void ossimNitfRpcModel::lineSampleHeightToWorld(
    const ossimDpt& image_point,
    const double&   heightEllipsoid,
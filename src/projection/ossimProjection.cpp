@@ -165,7 +165,38 @@ void ossimProjection::worldToLineSample(const ossimGpt& worldPoint,
 //            << "point for ground point: " << worldPoint
 //            << "\nCheck the geometry file for valid quantities." << endl;
    }
-   
+
+}
+
+void ossimProjection::worldToLineSamplePoints(const ossimGpt* worldPoints,
+                                              ossim_uint32    count,
+                                              ossimDpt*       lineSampPoints) const
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      worldToLineSample(worldPoints[i], lineSampPoints[i]);
+   }
+}
+
+void ossimProjection::lineSampleToWorldPoints(const ossimDpt* lineSampPoints,
+                                              ossim_uint32    count,
+                                              ossimGpt*       worldPoints) const
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      lineSampleToWorld(lineSampPoints[i], worldPoints[i]);
+   }
+}
+
+void ossimProjection::lineSampleHeightToWorldPoints(const ossimDpt* lineSampPoints,
+                                                    const double*   heightsAboveEllipsoid,
+                                                    ossim_uint32    count,
+                                                    ossimGpt*       worldPoints) const
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      lineSampleHeightToWorld(lineSampPoints[i], heightsAboveEllipsoid[i], worldPoints[i]);
+   }
 }
 
 void ossimProjection::getRoundTripError(const ossimDpt& imagePoint,
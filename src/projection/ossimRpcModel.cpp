@@ -323,6 +323,136 @@ void ossimRpcModel::worldToLineSample(const ossimGpt& ground_point,
    return;
 }
 
+//*****************************************************************************
+//  METHOD: ossimRpcModel::worldToLineSamplePoints()
+//
+//  Overrides base class implementation. Same math as worldToLineSample() but
+//  laid out as structure of arrays: every loop below runs across the points
+//  of a block so the compiler can vectorize it, and the 20 monomials of a
+//  point are formed once and shared by the four polynomials.
+//*****************************************************************************
+void ossimRpcModel::worldToLineSamplePoints(const ossimGpt* world_points,
+                                            ossim_uint32    count,
+                                            ossimDpt*       image_points) const
+{
+   static const ossim_uint32 BLOCK_SIZE = 64;
+   static const ossim_uint32 NUM_TERMS  = 20;
+
+   double nlat[BLOCK_SIZE];
+   double nlon[BLOCK_SIZE];
+   double nhgt[BLOCK_SIZE];
+   double terms[NUM_TERMS][BLOCK_SIZE];
+   double Pu[BLOCK_SIZE];
+   double Qu[BLOCK_SIZE];
+   double Pv[BLOCK_SIZE];
+   double Qv[BLOCK_SIZE];
+
+   const double NULL_HGT = ( - theHgtOffset) / theHgtScale;
+   const double LINE_SCALE  = theLineScale + theIntrackScale;
+   const double SAMP_SCALE  = theSampScale + theCrtrackScale;
+   const double LINE_OFFSET = theLineOffset + theIntrackOffset;
+   const double SAMP_OFFSET = theSampOffset + theCrtrackOffset;
+
+   // Monomial order of each polynomial format, see polynomial():
+   ossim_uint32 L3 = 11, L2P = 12, L2H = 13, LP2 = 14, P2H = 16, LH2 = 17, PH2 = 18;
+   ossim_uint32 LPH = 7, L2 = 8, P2 = 9, H2 = 10;
+   if (thePolyType != A)
+   {
+      L2 = 7; P2 = 8; H2 = 9; LPH = 10;
+      LP2 = 12; LH2 = 13; L2P = 14; PH2 = 16; L2H = 17; P2H = 18;
+   }
+
+   for (ossim_uint32 start = 0; start < count; start += BLOCK_SIZE)
+   {
+      const ossim_uint32 N = std::min(BLOCK_SIZE, count - start);
+      const ossimGpt* gpts = world_points + start;
+      ossim_uint32 i;
+
+      //***
+      // Normalize the lat, lon, hgt:
+      //***
+      for (i = 0; i < N; ++i)
+      {
+         nlat[i] = (gpts[i].lat - theLatOffset) / theLatScale;
+         nlon[i] = (gpts[i].lon - theLonOffset) / theLonScale;
+         nhgt[i] = gpts[i].isHgtNan() ? NULL_HGT :
+            (gpts[i].hgt - theHgtOffset) / theHgtScale;
+      }
+
+      for (i = 0; i < N; ++i)
+      {
+         const double P = nlat[i];
+         const double L = nlon[i];
+         const double H = nhgt[i];
+         terms[0][i]   = 1.0;
+         terms[1][i]   = L;
+         terms[2][i]   = P;
+         terms[3][i]   = H;
+         terms[4][i]   = L*P;
+         terms[5][i]   = L*H;
+         terms[6][i]   = P*H;
+         terms[LPH][i] = L*P*H;
+         terms[L2][i]  = L*L;
+         terms[P2][i]  = P*P;
+         terms[H2][i]  = H*H;
+         terms[L3][i]  = L*L*L;
+         terms[L2P][i] = L*L*P;
+         terms[L2H][i] = L*L*H;
+         terms[LP2][i] = L*P*P;
+         terms[15][i]  = P*P*P;
+         terms[P2H][i] = P*P*H;
+         terms[LH2][i] = L*H*H;
+         terms[PH2][i] = P*H*H;
+         terms[19][i]  = H*H*H;
+      }
+
+      for (i = 0; i < N; ++i)
+      {
+         Pu[i] = theLineNumCoef[0];
+         Qu[i] = theLineDenCoef[0];
+         Pv[i] = theSampNumCoef[0];
+         Qv[i] = theSampDenCoef[0];
+      }
+      for (ossim_uint32 t = 1; t < NUM_TERMS; ++t)
+      {
+         const double* term = terms[t];
+         const double CLN = theLineNumCoef[t];
+         const double CLD = theLineDenCoef[t];
+         const double CSN = theSampNumCoef[t];
+         const double CSD = theSampDenCoef[t];
+         for (i = 0; i < N; ++i)
+         {
+            Pu[i] += CLN*term[i];
+            Qu[i] += CLD*term[i];
+            Pv[i] += CSN*term[i];
+            Qv[i] += CSD*term[i];
+         }
+      }
+
+      //***
+      // Back out rotation, skew, scale and offset as in worldToLineSample():
+      //***
+      ossimDpt* ipts = image_points + start;
+      for (i = 0; i < N; ++i)
+      {
+         const double U_rot = Pu[i] / Qu[i];
+         const double V_rot = Pv[i] / Qv[i];
+         const double U = U_rot*theCosMapRot + V_rot*theSinMapRot;
+         const double V = V_rot*theCosMapRot - U_rot*theSinMapRot;
+         ipts[i].line = U*LINE_SCALE + LINE_OFFSET;
+         ipts[i].samp = V*SAMP_SCALE + SAMP_OFFSET;
+      }
+
+      for (i = 0; i < N; ++i)
+      {
+         if ( gpts[i].isLatNan() || gpts[i].isLonNan() )
+         {
+            ipts[i].makeNan();
+         }
+      }
+   }
+}
+
 //*****************************************************************************
 //  METHOD: ossimRpcModel::lineSampleToWorld()
 //  
@@ -76,17 +76,25 @@ void ossimRpcSolver::solveCoefficients(const ossimDrect& imageBounds,
             gpt.height(0.0);
 
          gpt.changeDatum(defaultGround.datum());
-         if(theHeightAboveMSLFlag)
-         {
-            double h = ossimElevManager::instance()->getHeightAboveMSL(gpt);
-            if(ossim::isnan(h) == false)
-               gpt.height(h);
-         }
 
          imagePoints.push_back(dpt);
          groundPoints.push_back(gpt);
       }
    }
+
+   // One batch query for the whole grid:
+   if(theHeightAboveMSLFlag && !groundPoints.empty())
+   {
+      std::vector<double> heights(groundPoints.size());
+      ossimElevManager::instance()->getHeightsAboveMSL(&groundPoints.front(),
+                                                       (ossim_uint32)groundPoints.size(),
+                                                       &heights.front());
+      for(ossim_uint32 i = 0; i < heights.size(); ++i)
+      {
+         if(ossim::isnan(heights[i]) == false)
+            groundPoints[i].height(heights[i]);
+      }
+   }
    solveCoefficients(imagePoints, groundPoints);
 }
 
@@ -324,6 +332,10 @@ bool ossimRpcSolver::solve(const ossimDrect& imageBounds,
       double deltaY = h/(ySamples-1);
 
       // Sample the midpoints between image grid used to compute RPC:
+      std::vector<ossimDpt> ipts;
+      std::vector<ossimGpt> gpts;
+      ipts.reserve((xSamples-1)*(ySamples-1));
+      gpts.reserve((xSamples-1)*(ySamples-1));
       for (ossim_uint32 y=0; y<ySamples-1; ++y)
       {
          ipt.y = deltaY*((double)y + 0.5) + ul.y;
@@ -335,24 +347,35 @@ bool ossimRpcSolver::solve(const ossimDrect& imageBounds,
                geom->localToWorld(ipt, gpt);
             else
                geom->localToWorld(ipt, 0, gpt);
-            if(theHeightAboveMSLFlag)
-            {
-               double h = ossimElevManager::instance()->getHeightAboveMSL(gpt);
-               if(ossim::isnan(h) == false)
-                  gpt.height(h);
-            }
-
-            // Reverse projection using RPC:
-            evalPoint(gpt, irpc);
-
-            // Compute residual and accumulate:
-            residual = (ipt-irpc).length();
-            if (residual > theMaxResidual)
-               theMaxResidual = residual;
-            sumResiduals += residual;
-            ++numResiduals;
+            ipts.push_back(ipt);
+            gpts.push_back(gpt);
          }
       }
+      if(theHeightAboveMSLFlag && !gpts.empty())
+      {
+         std::vector<double> heights(gpts.size());
+         ossimElevManager::instance()->getHeightsAboveMSL(&gpts.front(),
+                                                          (ossim_uint32)gpts.size(),
+                                                          &heights.front());
+         for(ossim_uint32 i = 0; i < heights.size(); ++i)
+         {
+            if(ossim::isnan(heights[i]) == false)
+               gpts[i].height(heights[i]);
+         }
+      }
+
+      for (ossim_uint32 i=0; i<gpts.size(); ++i)
+      {
+         // Reverse projection using RPC:
+         evalPoint(gpts[i], irpc);
+
+         // Compute residual and accumulate:
+         residual = (ipts[i]-irpc).length();
+         if (residual > theMaxResidual)
+            theMaxResidual = residual;
+         sumResiduals += residual;
+         ++numResiduals;
+      }
 
       theMeanResidual = sumResiduals/numResiduals;
       if (theMaxResidual > tolerance)
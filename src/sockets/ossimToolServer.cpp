@@ -6,9 +6,12 @@
 //**************************************************************************************************
 
 #include <ossim/sockets/ossimToolServer.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <sstream>
 #include <map>
+#include <thread>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,6 +26,10 @@
 #include <ossim/base/ossimException.h>
 #include <ossim/base/ossimNotify.h>
 #include <ossim/base/ossimArgumentParser.h>
+#include <ossim/imaging/ossimSharedTileCache.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
 #include <ossim/util/ossimChipProcTool.h>
 #include <ossim/util/ossimToolRegistry.h>
 
@@ -42,23 +49,133 @@
 #include <netinet/tcp.h>
 #include <netinet/in.h>
 #endif
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
 
 
 #define OWARN ossimNotify(ossimNotifyLevel_WARN)
 #define OINFO ossimNotify(ossimNotifyLevel_INFO)
 #define MAX_BUF_LEN 4096
-#define FORK_PROCESS false
+#define MAX_EVENTS 64
+#define LATENCY_WINDOW 1024
 #define _DEBUG_ false
 
+/** One client connection: its socket, buffer and the requests read from it. */
+class ossimToolServer::Session
+{
+public:
+   /**
+    * @param exitOnError Exit the process on a socket error. If false, only this connection is
+    * lost: error() throws and the caller closes the socket.
+    */
+   Session(ossimToolServer* server,
+           int clisockfd,
+           const struct sockaddr_in& cli_addr,
+           bool exitOnError);
+   ~Session();
+
+   /** Serves requests until the client disconnects or the connection is to be closed. */
+   void serve();
+
+   /**
+    * Reads and serves one request.
+    * @return false if the client disconnected.
+    */
+   bool processOssimRequest();
+
+   int  getSocket() const { return m_clisockfd; }
+   bool closeRequested() const { return m_closeRequested; }
+
+private:
+   bool runCommand(ossimString& command);
+   void writeSocket(const char* buf, int bufsize);
+   bool sendFile(const ossimFilename& fname);
+   void error(const char* msg);
+   bool acknowledgeRcvd();
+
+   /** Has the owner of the socket close it once the request returns. */
+   void closeConnection() { m_closeRequested = true; }
+
+   ossimToolServer*   m_server;
+   int                m_clisockfd;
+   char*              m_buffer;
+   struct sockaddr_in m_cliAddr;
+   bool               m_exitOnError;
+   bool               m_closeRequested;
+};
+
+/** Serves the next request on a session in the thread pool. */
+class ossimToolServer::RequestJob : public ossimJob
+{
+public:
+   RequestJob(ossimToolServer* server, std::shared_ptr<Session> session)
+   :  ossimJob(),
+      m_server(server),
+      m_session(session)
+   {}
+
+protected:
+   virtual void run()
+   {
+      m_server->serveSession(m_session);
+   }
+
+private:
+   ossimToolServer*         m_server;
+   std::shared_ptr<Session> m_session;
+};
+
 ossimToolServer::ossimToolServer()
 :  m_svrsockfd(-1),
-   m_clisockfd(-1),
-   m_buffer(new char[MAX_BUF_LEN])
-{}
+#if defined(__linux__)
+   m_mode(THREAD_POOL_MODE),
+#else
+   m_mode(SERIAL_MODE),
+#endif
+   m_numThreads(std::thread::hardware_concurrency()),
+   m_jobQueue(),
+   m_epollfd(-1),
+   m_uncapturedRuns(0),
+   m_capturing(false),
+   m_heldConsole(),
+   m_requestCount(0),
+   m_totalLatency(0.0),
+   m_maxLatency(0.0),
+   m_latencyIndex(0)
+{
+   if (m_numThreads == 0)
+      m_numThreads = 1;
+}
 
 ossimToolServer::~ossimToolServer()
 {
-   close(m_svrsockfd);
+   // Waits for the requests being served.
+   m_jobQueue.reset();
+
+   if (m_svrsockfd >= 0)
+      close(m_svrsockfd);
+#if defined(__linux__)
+   if (m_epollfd >= 0)
+      ::close(m_epollfd);
+#endif
+}
+
+void ossimToolServer::setServerMode(ServerMode mode)
+{
+#if !defined(__linux__)
+   if (mode == THREAD_POOL_MODE)
+   {
+      OWARN<<"ossimToolServer: The thread pool needs epoll. Serving connections serially."<<endl;
+      mode = SERIAL_MODE;
+   }
+#endif
+   m_mode = mode;
+}
+
+void ossimToolServer::setNumberOfThreads(ossim_uint32 threads)
+{
+   m_numThreads = threads ? threads : 1;
 }
 
 
@@ -66,9 +183,17 @@ void ossimToolServer::startListening(const char* portid)
 {
    initSocket(portid);
 
+   // Mapped before any fork so the children share decoded tiles.
+   if (ossimSharedTileCache::instance()->openFromPreferences())
+      ossimSharedTileCache::instance()->print(OINFO);
+
+   if (m_mode == THREAD_POOL_MODE)
+   {
+      serveWithThreadPool();
+      return;
+   }
+
    socklen_t clilen;
-   ostringstream xmsg;
-   bool status_ok = true;
 
    // Loop forever to listen for OSSIM requests:
    OINFO<<"Waiting for connections...\n"<<endl;
@@ -77,21 +202,21 @@ void ossimToolServer::startListening(const char* portid)
       // Message received at server socket, establish connection to client's socket:
       struct sockaddr_in cli_addr;
       clilen = sizeof(cli_addr);
-      m_clisockfd = accept(m_svrsockfd, (struct sockaddr *) &cli_addr, &clilen);
-      if (m_clisockfd < 0)
+      int clisockfd = accept(m_svrsockfd, (struct sockaddr *) &cli_addr, &clilen);
+      if (clisockfd < 0)
          error("Error accepting message on port.");
 
       // Test code:
       char clientname[256];
       char clientport[256];
       getnameinfo((struct sockaddr *) &cli_addr, clilen, clientname, 256, clientport, 256, 0);
-      cout<<"ossimToolServer: Got connection from  "<<clientname<<":"<<clientport
-            <<" Forking child process..."<<endl;
-
+      ostringstream msg;
+      msg<<"ossimToolServer: Got connection from  "<<clientname<<":"<<clientport
+         <<(m_mode == FORK_MODE ? " Forking child process..." : "")<<"\n";
+      writeConsole(msg.str());
 
-#if 1
       // Fork process to handle client request:
-      if (FORK_PROCESS)
+      if (m_mode == FORK_MODE)
       {
          if (!fork())
          {
@@ -99,43 +224,139 @@ void ossimToolServer::startListening(const char* portid)
             close(m_svrsockfd); // child doesn't need the listener
 
             // Receive request from client:
-            bool connected = true;
-            while (connected)
-               connected = processOssimRequest(cli_addr);
+            Session session (this, clisockfd, cli_addr, true);
+            session.serve();
+            close(clisockfd);
 
             exit(0); // exit forked process
          }
       }
       else
       {
-         bool connected = true;
-         while (connected)
-            connected = processOssimRequest(cli_addr);
+         Session session (this, clisockfd, cli_addr, true);
+         session.serve();
       }
-#else
-      int n=0;
-      while (1)
+
+      // Finished serving this client. Close the connection:
+      close(clisockfd);
+   }
+}
+
+void ossimToolServer::serveWithThreadPool()
+{
+#if defined(__linux__)
+   // A client going away must not take the whole server down:
+   signal(SIGPIPE, SIG_IGN);
+
+   m_epollfd = epoll_create1(0);
+   if (m_epollfd < 0)
+      error("Error on epoll_create1()");
+
+   struct epoll_event ev;
+   memset(&ev, 0, sizeof ev);
+   ev.events = EPOLLIN;
+   ev.data.fd = m_svrsockfd;
+   if (epoll_ctl(m_epollfd, EPOLL_CTL_ADD, m_svrsockfd, &ev) == -1)
+      error("Error on epoll_ctl()");
+
+   m_jobQueue = std::make_shared<ossimJobMultiThreadQueue>(
+      std::make_shared<ossimJobQueue>(), m_numThreads);
+
+   OINFO<<"Waiting for connections on "<<m_numThreads<<" threads...\n"<<endl;
+   struct epoll_event events[MAX_EVENTS];
+   while (1)
+   {
+      int n = epoll_wait(m_epollfd, events, MAX_EVENTS, -1);
+      if (n < 0)
+      {
+         if (errno == EINTR)
+            continue;
+         error("Error on epoll_wait()");
+      }
+
+      for (int i = 0; i < n; ++i)
       {
-         // Clear the input m_buffer and read the message sent:
-         memset(m_buffer, 0, 256);
-         n = recv(m_clisockfd,m_buffer,256,0);
-         if (n < 0)
+         if (events[i].data.fd == m_svrsockfd)
          {
-            printf("recv returned -1 from port %d.\n", m_clisockfd);
+            struct sockaddr_in cli_addr;
+            socklen_t clilen = sizeof(cli_addr);
+            int clisockfd = accept(m_svrsockfd, (struct sockaddr *) &cli_addr, &clilen);
+            if (clisockfd < 0)
+            {
+               perror("Error accepting message on port.");
+               continue;
+            }
+
+            char clientname[256];
+            char clientport[256];
+            getnameinfo((struct sockaddr *) &cli_addr, clilen, clientname, 256, clientport, 256, 0);
+            ostringstream msg;
+            msg<<"ossimToolServer: Got connection from  "<<clientname<<":"<<clientport<<"\n";
+            writeConsole(msg.str());
+
+            std::shared_ptr<Session> session(new Session(this, clisockfd, cli_addr, false));
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+            m_sessions[clisockfd] = session;
+
+            // One shot so only one worker at a time reads a connection, in request order.
+            ev.events = EPOLLIN | EPOLLONESHOT;
+            ev.data.fd = clisockfd;
+            if (epoll_ctl(m_epollfd, EPOLL_CTL_ADD, clisockfd, &ev) == -1)
+            {
+               perror("Error on epoll_ctl()");
+               close(clisockfd);
+               m_sessions.erase(clisockfd);
+            }
+         }
+         else
+         {
+            std::shared_ptr<Session> session;
+            {
+               std::lock_guard<std::mutex> lock(m_sessionMutex);
+               std::map<int, std::shared_ptr<Session> >::iterator iter =
+                  m_sessions.find(events[i].data.fd);
+               if (iter != m_sessions.end())
+                  session = iter->second;
+            }
+            if (session)
+               m_jobQueue->getJobQueue()->add(std::make_shared<RequestJob>(this, session));
          }
-
-         // Send acknowledgement back to client:
-         printf("Received: %s\n",m_buffer);
-         string msg ="server received message: ";
-         msg.append(m_buffer, strlen(m_buffer));
-         n = send(m_clisockfd, msg.c_str(), msg.size(), 0);
-         if (n < 0)
-            error("ERROR writing to socket");
       }
+   }
 #endif
-      // Finished serving this client. Close the connection:
-      close(m_clisockfd);
+}
+
+void ossimToolServer::serveSession(std::shared_ptr<Session> session)
+{
+#if defined(__linux__)
+   const int CLISOCKFD = session->getSocket();
+   bool connected = false;
+   try
+   {
+      connected = session->processOssimRequest() && !session->closeRequested();
+   }
+   catch (ossimException& x)
+   {
+      OWARN<<"ossimToolServer: "<<x.what()<<" Closing connection."<<endl;
+   }
+
+   struct epoll_event ev;
+   memset(&ev, 0, sizeof ev);
+   if (connected)
+   {
+      // Wait for the next request on this connection:
+      ev.events = EPOLLIN | EPOLLONESHOT;
+      ev.data.fd = CLISOCKFD;
+      if (epoll_ctl(m_epollfd, EPOLL_CTL_MOD, CLISOCKFD, &ev) == 0)
+         return;
    }
+
+   // Under the lock so an accept() reusing the descriptor finds the session gone.
+   std::lock_guard<std::mutex> lock(m_sessionMutex);
+   epoll_ctl(m_epollfd, EPOLL_CTL_DEL, CLISOCKFD, &ev);
+   close(CLISOCKFD);
+   m_sessions.erase(CLISOCKFD);
+#endif
 }
 
 void ossimToolServer::initSocket(const char* portid)
@@ -210,7 +431,39 @@ void ossimToolServer::error(const char* msg)
    exit (1);
 }
 
-void ossimToolServer::writeSocket(const char* buf, int bufsize)
+ossimToolServer::Session::Session(ossimToolServer* server,
+                                  int clisockfd,
+                                  const struct sockaddr_in& cli_addr,
+                                  bool exitOnError)
+:  m_server(server),
+   m_clisockfd(clisockfd),
+   m_buffer(new char[MAX_BUF_LEN]),
+   m_cliAddr(cli_addr),
+   m_exitOnError(exitOnError),
+   m_closeRequested(false)
+{}
+
+ossimToolServer::Session::~Session()
+{
+   delete [] m_buffer;
+}
+
+void ossimToolServer::Session::serve()
+{
+   while (processOssimRequest() && !m_closeRequested);
+}
+
+void ossimToolServer::Session::error(const char* msg)
+{
+   perror(msg);
+   if (m_exitOnError)
+      exit (1);
+
+   // Only the session's connection is lost:
+   throw ossimException(msg);
+}
+
+void ossimToolServer::Session::writeSocket(const char* buf, int bufsize)
 {
    int remaining = bufsize;
    int n;
@@ -223,11 +476,12 @@ void ossimToolServer::writeSocket(const char* buf, int bufsize)
       n = send(m_clisockfd, buf, remaining, 0);
       if (n < 0)
          error("ERROR writing to socket");
+      buf += n;
       remaining -= n;
    }
 }
 
-bool ossimToolServer::sendFile(const ossimFilename& fname)
+bool ossimToolServer::Session::sendFile(const ossimFilename& fname)
 {
    ostringstream xmsg;
 
@@ -284,11 +538,11 @@ bool ossimToolServer::sendFile(const ossimFilename& fname)
    if (!acknowledgeRcvd())
       return false;
 
-   cout << "Send complete."<<endl;
+   m_server->writeConsole("Send complete.\n");
    svrfile.close();
    return true;
 }
-bool ossimToolServer::acknowledgeRcvd()
+bool ossimToolServer::Session::acknowledgeRcvd()
 {
    if (_DEBUG_) cout<<"ossimToolServer:"<<__LINE__<<" Waiting to recv"<<endl; //TODO REMOVE DEBUG
    int n = recv(m_clisockfd, m_buffer, 11, 0);
@@ -301,7 +555,7 @@ bool ossimToolServer::acknowledgeRcvd()
    return true;
 }
 
-bool ossimToolServer::runCommand(ossimString& command)
+bool ossimToolServer::Session::runCommand(ossimString& command)
 {
    ostringstream xmsg;
    bool status_ok = false;
@@ -317,88 +571,130 @@ bool ossimToolServer::runCommand(ossimString& command)
       return true;
    }
 
+   // Intercept latency statistics request:
+   if (command == "stats")
+   {
+      ostringstream stats;
+      m_server->printStatistics(stats);
+      const char* response = "TEXT ";
+      writeSocket(response, strlen(response));
+      writeSocket(stats.str().c_str(), stats.str().size());
+      if (!acknowledgeRcvd())
+         error("ERROR receiving acknowledge from client.");
+      return true;
+   }
+
+   // Intercept help request:
+   bool listCommands = false;
+   ossimString c1 = command.before(" ");
+   ossimString c2 = command.after(" ");
+   if (c1 == "help")
+   {
+      if (!c2.empty())
+         command = c2 + " --help";
+      else
+         listCommands = true;
+   }
+
+   // Fetch OSSIM utility for requested operation:
+   ossimArgumentParser ap (command);
+   ossimString util_name = ap[0];
+   ossimRefPtr<ossimTool> utility = 0;
+   if (!listCommands)
+      utility = m_server->acquireTool(util_name.string());
+
+   //---
+   // The console output of a chip processor is not sent back, so in the thread pool it runs
+   // without capturing stdout and beside other chip requests.
+   //---
+   bool capture = !((m_server->m_mode == THREAD_POOL_MODE) && utility.valid() &&
+                    utility->isChipProcessor() && !command.contains("--help"));
+   ostringstream uncaptured;
+   ostream& out = capture ? cout : uncaptured;
+   if (!capture)
+      utility->setOutputStream(&uncaptured);
+   m_server->beginToolRun(capture);
+
    // Redirect stdout:
    memset(m_buffer, 0, MAX_BUF_LEN);
    int pipeDesc[2] = {0,0};
-   int savedStdout = dup( fileno(stdout) );
-   if( pipe( pipeDesc ) == -1 )
-      error("Could not redirect stdout (1).");
-   setbuf( stdout, NULL );
-   dup2( pipeDesc[1], fileno(stdout) );
+   int savedStdout = -1;
+   if (capture)
+   {
+      savedStdout = dup( fileno(stdout) );
+      if( pipe( pipeDesc ) == -1 )
+      {
+         close(savedStdout);
+         m_server->endToolRun(capture);
+         error("Could not redirect stdout (1).");
+      }
+      setbuf( stdout, NULL );
+      dup2( pipeDesc[1], fileno(stdout) );
 
 #ifdef _MSC_VER
-   u_long iMode = 1;
-   ioctlsocket(pipeDesc[0], FIONBIO, &iMode);
+      u_long iMode = 1;
+      ioctlsocket(pipeDesc[0], FIONBIO, &iMode);
 #else
-   fcntl( pipeDesc[0], F_SETFL, O_NONBLOCK );
+      fcntl( pipeDesc[0], F_SETFL, O_NONBLOCK );
 #endif
+   }
 
-   ossimToolFactoryBase* factory = ossimToolRegistry::instance();
-   ossimRefPtr<ossimTool> utility = 0;
-
-   // Intercept help request:
-   ossimString c1 = command.before(" ");
-   ossimString c2 = command.after(" ");
-   while (1)
+   if (listCommands)
+   {
+      map<string, string> capabilities;
+      ossimToolRegistry::instance()->getCapabilities(capabilities);
+      map<string, string>::iterator iter = capabilities.begin();
+      cout<<"\nAvailable commands:\n"<<endl;
+      for (;iter != capabilities.end(); ++iter)
+         cout<<"  "<<iter->first<<" -- "<<iter->second<<endl;
+      cout<<"\nUse option \"--help\" with above commands to get detailed tool command."<<endl;
+      status_ok = true;
+   }
+   else
    {
-      if (c1 == "help")
-      {
-         if (!c2.empty())
-         {
-            command = c2 + " --help";
-         }
-         else
-         {
-            map<string, string> capabilities;
-            factory->getCapabilities(capabilities);
-            map<string, string>::iterator iter = capabilities.begin();
-            cout<<"\nAvailable commands:\n"<<endl;
-            for (;iter != capabilities.end(); ++iter)
-               cout<<"  "<<iter->first<<" -- "<<iter->second<<endl;
-            cout<<"\nUse option \"--help\" with above commands to get detailed tool command."<<endl;
-            status_ok = true;
-            break;
-         }
-      }
-      // Fetch OSSIM utility for requested operation:
-      ossimArgumentParser ap (command);
-      ossimString util_name = ap[0];
-      utility = factory->createTool(util_name);
-
       try
       {
          // Perform OSSIM command execution:
          if (!utility.valid())
-            cout<<msg<<"Did not understand command <"<<util_name<<">"<<endl;
+            out<<msg<<"Did not understand command <"<<util_name<<">"<<endl;
          else if (!utility->initialize(ap))
-            cout<<msg<<"Could not execute command sequence <"<<command<<">."<<endl;
+            out<<msg<<"Could not execute command sequence <"<<command<<">."<<endl;
          else if (!utility->helpRequested() && !utility->execute())
-            cout<<msg<<"Error encountered executing\n    <"<<command <<">\nCheck options."<<endl;
+            out<<msg<<"Error encountered executing\n    <"<<command <<">\nCheck options."<<endl;
          else
             status_ok = true;
       }
       catch (ossimException& x)
       {
-         cout << msg << "Caught OSSIM exception: "<<x.what()<<endl;
+         out << msg << "Caught OSSIM exception: "<<x.what()<<endl;
       }
       catch (exception& x)
       {
-         cout << msg << "Caught unknown exception: "<<x.what()<<endl;
+         out << msg << "Caught unknown exception: "<<x.what()<<endl;
       }
-
-      break;
    }
 
    // Stop redirecting stdout and copy the output stream buffer to local memory:
-   dup2( savedStdout, fileno(stdout) );
-   int n = MAX_BUF_LEN;
    string full_output;
-   while (n == MAX_BUF_LEN)
+   if (capture)
    {
-       n = read(pipeDesc[0], m_buffer, MAX_BUF_LEN);
-       if (n > 0)
-          full_output.append(m_buffer, n);
+      dup2( savedStdout, fileno(stdout) );
+      int n = MAX_BUF_LEN;
+      while (n == MAX_BUF_LEN)
+      {
+          n = read(pipeDesc[0], m_buffer, MAX_BUF_LEN);
+          if (n > 0)
+             full_output.append(m_buffer, n);
+      }
+      close(pipeDesc[0]);
+      close(pipeDesc[1]);
+      close(savedStdout);
+   }
+   else
+   {
+      full_output = uncaptured.str();
    }
+   m_server->endToolRun(capture);
 
    if (status_ok)
    {
@@ -418,26 +714,137 @@ bool ossimToolServer::runCommand(ossimString& command)
          if (!acknowledgeRcvd())
             error("ERROR receiving acknowledge from client.");
       }
+      m_server->releaseTool(util_name.string(), utility);
    }
    else
    {
       const char* response = "ERROR";
       writeSocket(response, strlen(response));
       writeSocket(full_output.c_str(), full_output.size());
-      cout << "Sending ERROR to client and closing connection: <"<<full_output<<">"<<endl;
-      close(m_clisockfd);
+      m_server->writeConsole("Sending ERROR to client and closing connection: <" + full_output +
+                             ">\n");
+      closeConnection();
    }
 
    return status_ok;
 }
 
-bool ossimToolServer::processOssimRequest(struct sockaddr_in& cli_addr)
+ossimRefPtr<ossimTool> ossimToolServer::acquireTool(const std::string& name)
+{
+   {
+      std::lock_guard<std::mutex> lock(m_toolMutex);
+      map<string, vector< ossimRefPtr<ossimTool> > >::iterator idle = m_idleTools.find(name);
+      if ((idle != m_idleTools.end()) && !idle->second.empty())
+      {
+         ossimRefPtr<ossimTool> tool = idle->second.back();
+         idle->second.pop_back();
+         return tool;
+      }
+   }
+   return ossimToolRegistry::instance()->createTool(name);
+}
+
+void ossimToolServer::releaseTool(const std::string& name, ossimRefPtr<ossimTool> tool)
+{
+   if (!tool.valid() || !tool->isReusable())
+      return;
+
+   tool->clear();
+   tool->setOutputStream(&cout);
+
+   std::lock_guard<std::mutex> lock(m_toolMutex);
+   m_idleTools[name].push_back(tool);
+}
+
+void ossimToolServer::beginToolRun(bool capture)
+{
+   std::unique_lock<std::mutex> lock(m_outputMutex);
+   if (capture)
+   {
+      m_outputCondition.wait(lock, [this] { return !m_capturing && !m_uncapturedRuns; });
+      m_capturing = true;
+   }
+   else
+   {
+      m_outputCondition.wait(lock, [this] { return !m_capturing; });
+      ++m_uncapturedRuns;
+   }
+}
+
+void ossimToolServer::endToolRun(bool capture)
+{
+   std::lock_guard<std::mutex> lock(m_outputMutex);
+   if (capture)
+   {
+      m_capturing = false;
+      if (!m_heldConsole.empty())
+      {
+         cout << m_heldConsole << flush;
+         m_heldConsole.clear();
+      }
+   }
+   else
+      --m_uncapturedRuns;
+   m_outputCondition.notify_all();
+}
+
+void ossimToolServer::writeConsole(const std::string& text)
+{
+   std::lock_guard<std::mutex> lock(m_outputMutex);
+   if (m_capturing)
+      m_heldConsole += text;
+   else
+      cout << text << flush;
+}
+
+void ossimToolServer::addLatency(double seconds)
+{
+   std::lock_guard<std::mutex> lock(m_statsMutex);
+   ++m_requestCount;
+   m_totalLatency += seconds;
+   if (seconds > m_maxLatency)
+      m_maxLatency = seconds;
+   if (m_latencies.size() < LATENCY_WINDOW)
+      m_latencies.push_back(seconds);
+   else
+      m_latencies[m_latencyIndex] = seconds;
+   m_latencyIndex = (m_latencyIndex + 1) % LATENCY_WINDOW;
+}
+
+std::ostream& ossimToolServer::printStatistics(std::ostream& out) const
+{
+   std::lock_guard<std::mutex> lock(m_statsMutex);
+
+   // Percentiles are over the last LATENCY_WINDOW requests.
+   std::vector<double> window (m_latencies);
+   std::sort(window.begin(), window.end());
+   double p50 = 0.0;
+   double p99 = 0.0;
+   if (!window.empty())
+   {
+      p50 = window[(window.size() - 1) / 2];
+      p99 = window[((window.size() - 1) * 99) / 100];
+   }
+
+   out << "requests:          " << m_requestCount
+       << "\nmean_latency_ms:   "
+       << (m_requestCount ? 1000.0 * m_totalLatency / m_requestCount : 0.0)
+       << "\np50_latency_ms:    " << 1000.0 * p50
+       << "\np99_latency_ms:    " << 1000.0 * p99
+       << "\nmax_latency_ms:    " << 1000.0 * m_maxLatency
+       << "\n";
+   return out;
+}
+
+bool ossimToolServer::Session::processOssimRequest()
 {
    char dst[INET6_ADDRSTRLEN];
 
    // TEST CODE:
-   cout << "\nprocessOssimRequest() -- Process ID: "<<getpid()<<endl;
-   cout <<   "                  Parent process ID: "<<getppid()<<endl;
+   ostringstream log;
+   log << "\nprocessOssimRequest() -- Process ID: "<<getpid()
+       << "\n                  Parent process ID: "<<getppid()<<"\n";
+   m_server->writeConsole(log.str());
 
    // Clear the input m_buffer and read the message sent:
    memset(m_buffer, 0, MAX_BUF_LEN);
@@ -451,11 +858,13 @@ bool ossimToolServer::processOssimRequest(struct sockaddr_in& cli_addr)
    if (n != 0)
    {
       // Log the message received:
-      void* addr = &(cli_addr.sin_addr);
+      void* addr = &(m_cliAddr.sin_addr);
       if (!inet_ntop(AF_INET, addr, dst, INET6_ADDRSTRLEN))
          error("ossimToolServer: Error returned from inet_ntop(). ");
-      cout << "\nossimToolServer: received message from: "<<dst<<"\n---------------\n"<<m_buffer
-            <<"\n---------------\n"<< endl;
+      log.str("");
+      log << "\nossimToolServer: received message from: "<<dst<<"\n---------------\n"<<m_buffer
+          <<"\n---------------\n\n";
+      m_server->writeConsole(log.str());
 
       // process request:
       ossimString command (m_buffer);
@@ -463,11 +872,18 @@ bool ossimToolServer::processOssimRequest(struct sockaddr_in& cli_addr)
 
       if (command == "goodbye")
       {
-         close(m_clisockfd);
+         closeConnection();
          return true;
       }
 
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
       runCommand(command);
+      double seconds = std::chrono::duration<double>(
+         std::chrono::steady_clock::now() - start).count();
+      m_server->addLatency(seconds);
+      log.str("");
+      log << "ossimToolServer: request served in " << 1000.0 * seconds << " ms\n";
+      m_server->writeConsole(log.str());
       return true;
    }
    return false;
@@ -0,0 +1,190 @@
+//*******************************************************************
+//
+// License:  See top level LICENSE.txt file
+//
+//*************************************************************************
+
+#include <ossim/support_data/ImageHandlerStateStore.h>
+#include <ossim/support_data/ImageHandlerStateRegistry.h>
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimTrace.h>
+#include <cstdio>
+#include <sstream>
+
+static ossimTrace traceDebug("ImageHandlerStateStore:debug");
+
+static const char SOURCE_FILE_KW[]     = "source_file";
+static const char SOURCE_SIZE_KW[]     = "source_size";
+static const char SOURCE_MODIFIED_KW[] = "source_modified";
+static const char DIRECTORY_MODIFIED_KW[] = "source_directory_modified";
+static const char STATE_PREFIX[]       = "state.";
+
+ossim::ImageHandlerStateStore::ImageHandlerStateStore(const ossimFilename& directory)
+: m_directory(directory.expand())
+{
+}
+
+std::shared_ptr<ossim::ImageHandlerState> ossim::ImageHandlerStateStore::getState(
+   const ossimFilename& file, ossim_uint32 entry)const
+{
+   std::shared_ptr<ossim::ImageHandlerState> result;
+
+   ossimString id = file + "_e" + ossimString::toString(entry);
+   ossimFilename stateFile = getStateFile(id);
+   ossim_int64 size = 0;
+   ossim_int64 modified = 0;
+   ossim_int64 directoryModified = 0;
+   if(stateFile.exists() && getStamp(file, size, modified, directoryModified))
+   {
+      ossimKeywordlist kwl;
+      if(kwl.addFile(stateFile))
+      {
+         // The id check catches two images hashing to the same file name.
+         if((id == kwl.find(SOURCE_FILE_KW)) &&
+            (size == ossimString(kwl.find(SOURCE_SIZE_KW)).toInt64()) &&
+            (modified == ossimString(kwl.find(SOURCE_MODIFIED_KW)).toInt64()) &&
+            (directoryModified == ossimString(kwl.find(DIRECTORY_MODIFIED_KW)).toInt64()))
+         {
+            result = ossim::ImageHandlerStateRegistry::instance()->createState(kwl, STATE_PREFIX);
+         }
+      }
+   }
+
+   if(traceDebug())
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "ImageHandlerStateStore::getState: " << id
+         << (result ? " hit" : " miss") << std::endl;
+   }
+
+   return result;
+}
+
+bool ossim::ImageHandlerStateStore::addState(
+   const ossimFilename& file, std::shared_ptr<const ossim::ImageHandlerState> state)const
+{
+   bool result = false;
+   ossim_int64 size = 0;
+   ossim_int64 modified = 0;
+   ossim_int64 directoryModified = 0;
+   if(state && getStamp(file, size, modified, directoryModified))
+   {
+      if(!m_directory.exists())
+      {
+         m_directory.createDirectory();
+      }
+
+      ossimString id = file + "_e" + ossimString::toString(state->getCurrentEntry());
+      ossimKeywordlist kwl;
+      kwl.add(SOURCE_FILE_KW, id.c_str());
+      kwl.add(SOURCE_SIZE_KW, size);
+      kwl.add(SOURCE_MODIFIED_KW, modified);
+      kwl.add(DIRECTORY_MODIFIED_KW, directoryModified);
+      if(state->save(kwl, STATE_PREFIX))
+      {
+         //---
+         // Write to a name no other writer uses, then rename over the store
+         // file so readers only ever see a whole state.
+         //---
+         ossimFilename stateFile = getStateFile(id);
+         ossimFilename tmpFile = stateFile.getUniqueTempFilename();
+         if(kwl.write(tmpFile.c_str()))
+         {
+            result = (std::rename(tmpFile.c_str(), stateFile.c_str()) == 0);
+            if(!result)
+            {
+               // Platforms that do not rename over an existing file.
+               result = tmpFile.rename(stateFile, true);
+            }
+            if(!result)
+            {
+               tmpFile.remove();
+            }
+         }
+      }
+
+      if(traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ImageHandlerStateStore::addState: " << id
+            << (result ? " stored" : " failed") << std::endl;
+      }
+   }
+
+   return result;
+}
+
+void ossim::ImageHandlerStateStore::removeState(const ossimFilename& file,
+                                                ossim_uint32 entry)const
+{
+   ossimFilename stateFile = getStateFile(file + "_e" + ossimString::toString(entry));
+   if(stateFile.exists())
+   {
+      stateFile.remove();
+   }
+}
+
+ossimFilename ossim::ImageHandlerStateStore::getSupportFile(const ossimFilename& file,
+                                                            ossim_uint32 entry,
+                                                            const ossimString& ext)const
+{
+   ossimFilename result = getStateFile(file + "_e" + ossimString::toString(entry));
+   result.setExtension(ext);
+   return result;
+}
+
+ossimFilename ossim::ImageHandlerStateStore::getStateFile(const ossimString& id)const
+{
+   //---
+   // 64 bit FNV-1a of the id.  std::hash is not used as its value may differ
+   // between builds sharing the store.
+   //---
+   ossim_uint64 hash = 14695981039346656037ULL;
+   for(std::string::const_iterator i = id.string().begin(); i != id.string().end(); ++i)
+   {
+      hash ^= (ossim_uint8)(*i);
+      hash *= 1099511628211ULL;
+   }
+   std::ostringstream name;
+   name << std::hex << hash << ".kwl";
+   return m_directory.dirCat(ossimFilename(name.str()));
+}
+
+bool ossim::ImageHandlerStateStore::getStamp(const ossimFilename& file,
+                                             ossim_int64& size,
+                                             ossim_int64& modified,
+                                             ossim_int64& directoryModified)
+{
+   bool result = false;
+   if(file.isFile())
+   {
+      modified = getModified(file);
+      if(modified >= 0)
+      {
+         size = file.fileSize();
+
+         // Files added next to the image, e.g. overviews, change this.
+         ossimFilename directory = file.expand().path();
+         if(directory.empty())
+         {
+            directory = ".";
+         }
+         directoryModified = getModified(directory);
+         result = true;
+      }
+   }
+   return result;
+}
+
+ossim_int64 ossim::ImageHandlerStateStore::getModified(const ossimFilename& file)
+{
+   ossim_int64 result = -1;
+   ossimLocalTm modTime;
+   if(file.getTimes(0, &modTime, 0))
+   {
+      result = (ossim_int64)((time_t)modTime);
+   }
+   return result;
+}
@@ -0,0 +1,616 @@
+//---
+//
+// License: MIT
+//
+// Description:
+//
+// Contains class definition for ossimNitfJpegBlockIndex.
+//
+//---
+
+#include <ossim/support_data/ossimNitfJpegBlockIndex.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimEndian.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimStreamFactoryRegistry.h>
+#include <ossim/base/ossimTrace.h>
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/parallel/ossimJobQueue.h>
+#include <ossim/support_data/ossimNitfImageHeader.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <memory>
+
+static ossimTrace traceDebug("ossimNitfJpegBlockIndex:debug");
+
+static const char         INDEX_MAGIC[8]  = { 'O','S','S','I','M','J','B','I' };
+static const ossim_uint32 INDEX_VERSION   = 1;
+
+// Bytes each scan thread reads at a time.
+static const std::streamoff SCAN_CHUNK_SIZE = 8 * 1024 * 1024;
+
+// Marker segments after the start of image allowed before the start of scan.
+static const ossim_uint32 MAX_HEADER_SEGMENTS = 64;
+
+static const ossim_uint8 FF  = 0xff;
+static const ossim_uint8 SOI = 0xd8;
+static const ossim_uint8 EOI = 0xd9;
+static const ossim_uint8 SOS = 0xda;
+
+/** @return true if marker is followed by a two byte length. */
+static bool hasLength(ossim_uint8 marker)
+{
+   // SOFn, DHT, DAC, SOS, DQT, DNL, DRI, DHP, EXP, APPn, JPGn and COM.
+   return ( ( ( marker >= 0xc0 ) && ( marker <= 0xcf ) ) ||
+            ( ( marker >= 0xda ) && ( marker <= 0xfe ) ) );
+}
+
+/**
+ * @brief Gets the size and modification time of file.
+ * @return false if file is not a file on disk.
+ */
+static bool getStamp(const ossimFilename& file, ossim_int64& size, ossim_int64& modified)
+{
+   bool result = false;
+   if ( file.isFile() )
+   {
+      ossimLocalTm modTime;
+      if ( file.getTimes(0, &modTime, 0) )
+      {
+         size     = file.fileSize();
+         modified = (ossim_int64)((time_t)modTime);
+         result   = true;
+      }
+   }
+   return result;
+}
+
+/** Scans one chunk on a thread of the scan queue. */
+class ossimNitfJpegBlockIndex::ScanJob : public ossimJob
+{
+public:
+   ScanJob(const std::string& connectionString,
+           std::streamoff begin,
+           std::streamoff end,
+           ChunkResult* result)
+      :
+      ossimJob(),
+      m_connectionString(connectionString),
+      m_begin(begin),
+      m_end(end),
+      m_result(result)
+   {
+   }
+
+protected:
+   virtual void run()
+   {
+      m_result->m_status = ossimNitfJpegBlockIndex::scanRange(
+         m_connectionString, m_begin, m_end, m_result->m_candidates);
+   }
+
+private:
+   std::string    m_connectionString;
+   std::streamoff m_begin;
+   std::streamoff m_end;
+   ChunkResult*   m_result;
+};
+
+ossimNitfJpegBlockIndex::ossimNitfJpegBlockIndex()
+   :
+   m_start(0),
+   m_offsets(),
+   m_sizes()
+{
+}
+
+void ossimNitfJpegBlockIndex::clear()
+{
+   m_start = 0;
+   m_offsets.clear();
+   m_sizes.clear();
+}
+
+bool ossimNitfJpegBlockIndex::buildFromBlockMask(ossim::istream& in,
+                                                 const ossimNitfImageHeader& hdr)
+{
+   clear();
+
+   const ossim_uint32 BLOCKS = hdr.getNumberOfBlocksPerRow() * hdr.getNumberOfBlocksPerCol();
+   const std::streamoff START = (std::streamoff)hdr.getDataLocation();
+   if ( !BLOCKS || !hdr.hasBlockMaskRecords() )
+   {
+      return false;
+   }
+
+   m_start = START;
+   m_offsets.resize(BLOCKS, 0);
+   m_sizes.resize(BLOCKS, 0);
+
+   // Blocks are stored in offset order, so each ends where the next begins.
+   std::vector< std::pair<std::streamoff, ossim_uint32> > present;
+   for ( ossim_uint32 i = 0; i < BLOCKS; ++i )
+   {
+      ossim_uint32 offset = hdr.getBlockMaskRecordOffset(i, 0);
+      if ( offset != 0xffffffff )
+      {
+         m_offsets[i] = START + offset;
+         present.push_back( std::make_pair(m_offsets[i], i) );
+      }
+   }
+   std::sort( present.begin(), present.end() );
+
+   bool status = true;
+   for ( ossim_uint32 i = 0; i < present.size(); ++i )
+   {
+      std::streamoff end = 0;
+      if ( i + 1 < present.size() )
+      {
+         end = present[i + 1].first;
+      }
+      else if ( !findEndOfImage(in, present[i].first, end) )
+      {
+         status = false;
+         break;
+      }
+      m_sizes[ present[i].second ] = (ossim_uint32)(end - present[i].first);
+   }
+
+   in.clear();
+   in.seekg(0, std::ios_base::beg);
+
+   if ( !status )
+   {
+      clear();
+   }
+   return status;
+}
+
+bool ossimNitfJpegBlockIndex::scan(const std::string& connectionString,
+                                   std::streamoff start,
+                                   ossim_uint32 numberOfBlocks,
+                                   ossim_uint32 numberOfThreads)
+{
+   clear();
+
+   std::shared_ptr<ossim::istream> in =
+      ossim::StreamFactoryRegistry::instance()->createIstream(connectionString);
+   if ( !in || !numberOfBlocks )
+   {
+      return false;
+   }
+   in->seekg(0, std::ios_base::end);
+   const std::streamoff FILE_SIZE = in->tellg();
+   if ( FILE_SIZE <= start )
+   {
+      return false;
+   }
+
+   if ( numberOfThreads < 1 )
+   {
+      numberOfThreads = 1;
+   }
+   std::shared_ptr<ossimJobMultiThreadQueue> jobQueue;
+   if ( numberOfThreads > 1 )
+   {
+      jobQueue = std::make_shared<ossimJobMultiThreadQueue>(
+         std::make_shared<ossimJobQueue>(), numberOfThreads);
+   }
+
+   //---
+   // Scan a chunk per thread at a time so at most one round of chunks is read
+   // past the last block when the file holds more than this image.
+   //---
+   bool status = true;
+   std::streamoff position = start;
+   std::streamoff headerEnd = start;
+   std::vector<std::streamoff> offsets;
+   while ( status && ( position < FILE_SIZE ) && ( offsets.size() < numberOfBlocks ) )
+   {
+      std::vector<ChunkResult> results(numberOfThreads);
+      ossim_uint32 chunks = 0;
+      for ( ; ( chunks < numberOfThreads ) && ( position < FILE_SIZE ); ++chunks )
+      {
+         std::streamoff end = ossim::min<std::streamoff>(position + SCAN_CHUNK_SIZE, FILE_SIZE);
+         if ( jobQueue )
+         {
+            jobQueue->getJobQueue()->add(
+               std::make_shared<ScanJob>(connectionString, position, end, &results[chunks]) );
+         }
+         else
+         {
+            results[chunks].m_status = scanRange(connectionString, position, end,
+                                                 results[chunks].m_candidates);
+         }
+         position = end;
+      }
+      if ( jobQueue )
+      {
+         jobQueue->waitAll();
+      }
+
+      //---
+      // A marker inside the headers of a block is not the start of another
+      // block, so candidates before the end of the last start of scan are
+      // dropped.  Entropy coded data has no 0xffd8 sequence.
+      //---
+      for ( ossim_uint32 c = 0; ( c < chunks ) && ( offsets.size() < numberOfBlocks ); ++c )
+      {
+         const std::vector<Candidate>& candidates = results[c].m_candidates;
+         if ( !results[c].m_status )
+         {
+            status = false;
+            break;
+         }
+         for ( ossim_uint32 i = 0; i < candidates.size(); ++i )
+         {
+            if ( candidates[i].m_soi >= headerEnd )
+            {
+               offsets.push_back( candidates[i].m_soi );
+               headerEnd = candidates[i].m_headerEnd;
+               if ( offsets.size() == numberOfBlocks )
+               {
+                  break;
+               }
+            }
+         }
+      }
+   }
+
+   if ( status && ( offsets.size() == numberOfBlocks ) )
+   {
+      std::streamoff end = 0;
+      status = findEndOfImage(*in, offsets.back(), end);
+      if ( status )
+      {
+         m_sizes.resize(numberOfBlocks);
+         for ( ossim_uint32 i = 0; i + 1 < numberOfBlocks; ++i )
+         {
+            m_sizes[i] = (ossim_uint32)(offsets[i + 1] - offsets[i]);
+         }
+         m_sizes.back() = (ossim_uint32)(end - offsets.back());
+         m_offsets.swap(offsets);
+         m_start = start;
+      }
+   }
+   else
+   {
+      status = false;
+   }
+
+   if ( traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "ossimNitfJpegBlockIndex::scan DEBUG:"
+         << "\nexpected blocks: " << numberOfBlocks
+         << "\nfound blocks:    " << ( status ? numberOfBlocks : (ossim_uint32)offsets.size() )
+         << "\nthreads:         " << numberOfThreads
+         << std::endl;
+   }
+
+   return status;
+}
+
+bool ossimNitfJpegBlockIndex::read(const ossimFilename& indexFile,
+                                   const ossimFilename& imageFile,
+                                   std::streamoff start,
+                                   ossim_uint32 numberOfBlocks)
+{
+   clear();
+
+   ossim_int64 size = 0;
+   ossim_int64 modified = 0;
+   if ( !indexFile.isFile() || !getStamp(imageFile, size, modified) )
+   {
+      return false;
+   }
+
+   std::ifstream in(indexFile.c_str(), std::ios_base::in | std::ios_base::binary);
+   if ( !in )
+   {
+      return false;
+   }
+
+   // Index files are little endian.
+   ossimEndian* swapper = 0;
+   if ( ossim::byteOrder() == OSSIM_BIG_ENDIAN )
+   {
+      swapper = new ossimEndian();
+   }
+
+   bool status = false;
+   char magic[8];
+   ossim_uint32 header32[2]; // version, blocks
+   ossim_uint64 header64[3]; // image size, image modified, start
+   if ( in.read(magic, 8) &&
+        in.read((char*)header32, sizeof(header32)) &&
+        in.read((char*)header64, sizeof(header64)) )
+   {
+      if ( swapper )
+      {
+         swapper->swap(header32, 2);
+         swapper->swap(header64, 3);
+      }
+      if ( ( std::memcmp(magic, INDEX_MAGIC, 8) == 0 ) &&
+           ( header32[0] == INDEX_VERSION ) &&
+           ( header32[1] == numberOfBlocks ) &&
+           ( (ossim_int64)header64[0] == size ) &&
+           ( (ossim_int64)header64[1] == modified ) &&
+           ( (std::streamoff)header64[2] == start ) )
+      {
+         std::vector<ossim_uint64> offsets(numberOfBlocks);
+         m_sizes.resize(numberOfBlocks);
+         if ( numberOfBlocks &&
+              in.read((char*)&offsets.front(), numberOfBlocks * sizeof(ossim_uint64)) &&
+              in.read((char*)&m_sizes.front(), numberOfBlocks * sizeof(ossim_uint32)) )
+         {
+            if ( swapper )
+            {
+               swapper->swap(&offsets.front(), numberOfBlocks);
+               swapper->swap(&m_sizes.front(), numberOfBlocks);
+            }
+            m_offsets.assign(offsets.begin(), offsets.end());
+            m_start = start;
+            status = true;
+         }
+      }
+   }
+
+   if ( swapper )
+   {
+      delete swapper;
+      swapper = 0;
+   }
+
+   if ( !status )
+   {
+      clear();
+   }
+
+   if ( traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "ossimNitfJpegBlockIndex::read: " << indexFile
+         << (status ? " hit" : " stale or invalid") << std::endl;
+   }
+
+   return status;
+}
+
+bool ossimNitfJpegBlockIndex::write(const ossimFilename& indexFile,
+                                    const ossimFilename& imageFile) const
+{
+   bool result = false;
+
+   ossim_int64 size = 0;
+   ossim_int64 modified = 0;
+   if ( m_offsets.empty() || !getStamp(imageFile, size, modified) )
+   {
+      return result;
+   }
+
+   const ossim_uint32 BLOCKS = (ossim_uint32)m_offsets.size();
+   ossim_uint32 header32[2] = { INDEX_VERSION, BLOCKS };
+   ossim_uint64 header64[3] = { (ossim_uint64)size, (ossim_uint64)modified, (ossim_uint64)m_start };
+   std::vector<ossim_uint64> offsets(m_offsets.begin(), m_offsets.end());
+   std::vector<ossim_uint32> sizes(m_sizes);
+
+   if ( ossim::byteOrder() == OSSIM_BIG_ENDIAN )
+   {
+      ossimEndian swapper;
+      swapper.swap(header32, 2);
+      swapper.swap(header64, 3);
+      swapper.swap(&offsets.front(), BLOCKS);
+      swapper.swap(&sizes.front(), BLOCKS);
+   }
+
+   //---
+   // Write to a name no other writer uses, then rename over the index file so
+   // readers only ever see a whole index.
+   //---
+   ossimFilename tmpFile = indexFile.getUniqueTempFilename();
+   {
+      std::ofstream out(tmpFile.c_str(), std::ios_base::out | std::ios_base::binary);
+      if ( out )
+      {
+         out.write(INDEX_MAGIC, 8);
+         out.write((const char*)header32, sizeof(header32));
+         out.write((const char*)header64, sizeof(header64));
+         out.write((const char*)&offsets.front(), BLOCKS * sizeof(ossim_uint64));
+         out.write((const char*)&sizes.front(), BLOCKS * sizeof(ossim_uint32));
+         result = out.good();
+      }
+   }
+   if ( result )
+   {
+      result = (std::rename(tmpFile.c_str(), indexFile.c_str()) == 0);
+      if ( !result )
+      {
+         // Platforms that do not rename over an existing file.
+         result = tmpFile.rename(indexFile, true);
+      }
+   }
+   if ( !result && tmpFile.exists() )
+   {
+      tmpFile.remove();
+   }
+
+   if ( traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "ossimNitfJpegBlockIndex::write: " << indexFile
+         << (result ? " written" : " failed") << std::endl;
+   }
+
+   return result;
+}
+
+ossim_uint32 ossimNitfJpegBlockIndex::getNumberOfBlocks() const
+{
+   return (ossim_uint32)m_offsets.size();
+}
+
+void ossimNitfJpegBlockIndex::release(std::vector<std::streamoff>& offsets,
+                                      std::vector<ossim_uint32>& sizes)
+{
+   offsets.clear();
+   sizes.clear();
+   offsets.swap(m_offsets);
+   sizes.swap(m_sizes);
+}
+
+bool ossimNitfJpegBlockIndex::parseHeaders(ossim::istream& in,
+                                           std::streamoff soi,
+                                           std::streamoff& headerEnd)
+{
+   bool result = false;
+   std::streamoff position = soi + 2;
+   ossim_uint8 buf[4];
+   for ( ossim_uint32 segments = 0; segments < MAX_HEADER_SEGMENTS; )
+   {
+      in.seekg(position, std::ios_base::beg);
+      if ( !in.read((char*)buf, 4) || ( buf[0] != FF ) )
+      {
+         break;
+      }
+      if ( buf[1] == FF )
+      {
+         ++position; // Fill byte.
+         continue;
+      }
+      if ( !hasLength(buf[1]) )
+      {
+         break; // SOI, EOI, RSTn or TEM before a start of scan.
+      }
+      ossim_uint16 length = (ossim_uint16)( ( buf[2] << 8 ) | buf[3] );
+      if ( length < 2 )
+      {
+         break;
+      }
+      // Length includes the two length bytes.
+      position += 2 + length;
+      if ( buf[1] == SOS )
+      {
+         headerEnd = position;
+         result = true;
+         break;
+      }
+      ++segments;
+   }
+   in.clear();
+   return result;
+}
+
+bool ossimNitfJpegBlockIndex::findEndOfImage(ossim::istream& in,
+                                             std::streamoff soi,
+                                             std::streamoff& end)
+{
+   std::streamoff position = 0;
+   if ( !parseHeaders(in, soi, position) )
+   {
+      return false;
+   }
+
+   //---
+   // In entropy coded data 0xff is followed by a stuffed zero or a restart
+   // marker.  Segments between scans are skipped by their length so a 0xffd9
+   // in a table is not taken for the end of image.
+   //---
+   bool result = false;
+   std::vector<ossim_uint8> buf(64 * 1024);
+   std::streamoff bufStart = position;
+   std::streamoff bufSize = 0;
+   bool afterFF = false;
+   while ( !result )
+   {
+      if ( position >= bufStart + bufSize )
+      {
+         in.clear();
+         in.seekg(position, std::ios_base::beg);
+         in.read((char*)&buf.front(), buf.size());
+         bufStart = position;
+         bufSize = in.gcount();
+         if ( bufSize < 1 )
+         {
+            break;
+         }
+      }
+
+      ossim_uint8 c = buf[position - bufStart];
+      ++position;
+      if ( !afterFF )
+      {
+         afterFF = ( c == FF );
+      }
+      else if ( c == EOI )
+      {
+         end = position;
+         result = true;
+      }
+      else if ( c != FF )
+      {
+         afterFF = false;
+         if ( hasLength(c) )
+         {
+            ossim_uint8 length[2];
+            in.clear();
+            in.seekg(position, std::ios_base::beg);
+            if ( !in.read((char*)length, 2) )
+            {
+               break;
+            }
+            position += ( length[0] << 8 ) | length[1];
+         }
+      }
+   }
+   in.clear();
+   return result;
+}
+
+bool ossimNitfJpegBlockIndex::scanRange(const std::string& connectionString,
+                                        std::streamoff begin,
+                                        std::streamoff end,
+                                        std::vector<Candidate>& candidates)
+{
+   std::shared_ptr<ossim::istream> in =
+      ossim::StreamFactoryRegistry::instance()->createIstream(connectionString);
+   if ( !in )
+   {
+      return false;
+   }
+
+   // Two bytes past the end to see markers starting on the last byte.
+   std::vector<ossim_uint8> buf( (size_t)(end - begin) + 2 );
+   in->seekg(begin, std::ios_base::beg);
+   in->read((char*)&buf.front(), buf.size());
+   const size_t SIZE = (size_t)in->gcount();
+   in->clear();
+
+   const size_t LAST = ossim::min<size_t>( (size_t)(end - begin), SIZE );
+   const ossim_uint8* p = &buf.front();
+   for ( size_t i = 0; ( i < LAST ) && ( i + 2 < SIZE ); ++i )
+   {
+      const ossim_uint8* ff = (const ossim_uint8*)std::memchr(p + i, FF, LAST - i);
+      if ( !ff )
+      {
+         break;
+      }
+      i = ff - p;
+      if ( ( i + 2 < SIZE ) && ( p[i + 1] == SOI ) && ( p[i + 2] == FF ) )
+      {
+         Candidate candidate;
+         candidate.m_soi = begin + (std::streamoff)i;
+         if ( parseHeaders(*in, candidate.m_soi, candidate.m_headerEnd) )
+         {
+            candidates.push_back(candidate);
+         }
+      }
+   }
+
+   return true;
+}
@@ -35,6 +35,12 @@ ossimBandMergeTool::~ossimBandMergeTool()
 {
 }
 
+void ossimBandMergeTool::clear()
+{
+   m_stretchProduct = false;
+   ossimChipProcTool::clear();
+}
+
 void ossimBandMergeTool::setUsage(ossimArgumentParser& ap)
 {
    // Add options.
@@ -80,18 +80,34 @@ ossimChipProcTool::ossimChipProcTool()
 
 ossimChipProcTool::~ossimChipProcTool()
 {
-   clear();
+   m_procChain = 0;
+   m_imgLayers.clear();
+   m_writer = 0;
+   m_geom = 0;
 }
 
 void ossimChipProcTool::clear()
 {
-   m_gsd.makeNan();
-
+   // Release the product chain before the layers feeding it:
    m_procChain = 0;
+   m_cutRectFilter = 0;
    m_imgLayers.clear();
+   m_demSources.clear();
    m_writer = 0;
-   m_geom = 0;
+
+   // Back to the constructed state:
+   m_geom = new ossimImageGeometry;
+   m_procChain = new ossimImageChain;
+   m_aoiViewRect = ossimIrect();
+   m_aoiGroundRect = ossimGrect();
+   m_projIsIdentity = false;
+   m_gsd.makeNan();
+   m_geoScaled = false;
+   m_productFilename.clear();
+   m_productScalarType = OSSIM_SCALAR_UNKNOWN;
    m_needCutRect = false;
+
+   ossimTool::clear();
 }
 
 bool ossimChipProcTool::initialize(ossimArgumentParser& ap)
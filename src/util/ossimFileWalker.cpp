@@ -111,15 +111,8 @@ void ossimFileWalker::walk(const std::vector<ossimFilename>& files)
       
       } // while ( i != files.end() )
 
-      // FOREVER loop until all jobs are completed.
-      while (1)
-      {
-         ossim::Thread::sleepInMicroSeconds(250);
-         if ( m_jobQueue->hasJobsToProcess() == false )
-         {
-            break;
-         }
-      }
+      // Block until all jobs are completed.
+      m_jobQueue->waitAll();
 
    } // if ( files.size() )
 
@@ -147,15 +140,8 @@ void ossimFileWalker::walk(const ossimFilename& root)
          {
             walkDir(rootFile);
 
-            // FOREVER loop until all jobs are completed.
-            while (1)
-            {
-               ossim::Thread::sleepInMicroSeconds(250);
-               if ( m_jobQueue->hasJobsToProcess() == false )
-               {
-                  break;
-               }
-            }
+            // Block until all jobs are completed.
+            m_jobQueue->waitAll();
          }
          else
          {
@@ -264,15 +250,8 @@ void ossimFileWalker::walkDir(const ossimFilename& dir)
 
       if ( m_waitOnDirFlag )
       {
-         // FOREVER loop until all jobs are completed.
-         while (1)
-         {
-            ossim::Thread::sleepInMicroSeconds(250);
-            if ( m_jobQueue->hasJobsToProcess() == false )
-            {
-               break;
-            }
-         }
+         // Block until all jobs are completed.
+         m_jobQueue->waitAll();
       }
 
       m_mutex.lock();
@@ -86,7 +86,6 @@ const ossimHillshadeTool& ossimHillshadeTool::operator=( const ossimHillshadeToo
 
 ossimHillshadeTool::~ossimHillshadeTool()
 {
-   clear();
 }
 
 bool ossimHillshadeTool::initialize(ossimArgumentParser& ap)
@@ -64,6 +64,28 @@ ossimHlzTool::~ossimHlzTool()
 {
 }
 
+void ossimHlzTool::clear()
+{
+   m_slopeThreshold = 7.0;
+   m_roughnessThreshold = 0.5;
+   m_hlzMinRadius = 25.0;
+   m_slopeFile.clear();
+   m_demFilterSize = ossimIpt();
+   m_demBuffer = 0;
+   m_outBuffer = 0;
+   m_memSource = 0;
+   m_badLzValue = 255;
+   m_marginalLzValue = 128;
+   m_goodLzValue = 64;
+   m_useLsFitMethod = true;
+   m_combinedElevSource = 0;
+   m_pcSources.clear();
+   m_maskSources.clear();
+   m_numThreads = 1;
+   d_accumT = 0;
+   ossimChipProcTool::clear();
+}
+
 void ossimHlzTool::setUsage(ossimArgumentParser& ap)
 {
    // Add global usage options.
@@ -513,11 +535,10 @@ bool ossimHlzTool::computeHLZ()
 
       // Wait until all chips have been processed before proceeding:
       ossimNotify(ossimNotifyLevel_INFO) << "All jobs queued. Waiting for job threads to finish..." << endl;
-      while (jobMtQueue->hasJobsToProcess() || jobMtQueue->numberOfBusyThreads())
+      while (!jobMtQueue->waitAll(100))
       {
-         qsize = jobMtQueue->getJobQueue()->size();
+         qsize = jobMtQueue->getNumberOfPendingJobs();
          setPercentComplete(100*(numPatches-qsize)/numPatches);
-         ossim::Thread::sleepInMicroSeconds(10000);
       }
       jobMtQueue = 0;
    }
@@ -679,15 +700,13 @@ bool ossimHlzTool::PatchProcessorJob::level2Test()
 
    bool found_obstruction = false;
 
-   // Scan the block for obstructions:
-   ossimGpt point_plh;
-   ossimDpt point_xy;
-   ossim_uint32 numPoints = pc_block.size();
-   for (ossim_uint32 i=0; (i<numPoints) && !found_obstruction; ++i)
+   // Scan the block's returns column for obstructions:
+   const ossim_float32* num_returns = pc_block.getFieldBuf(ossimPointRecord::NumberOfReturns);
+   ossim_uint32 numPoints = num_returns ? pc_block.size() : 0;
+   for (ossim_uint32 i=0; i<numPoints; ++i)
    {
       //If this is not the only return, implies clutter along the ray:
-      int num_returns = (int) pc_block[i]->getField(ossimPointRecord::NumberOfReturns);
-      if (num_returns > 1)
+      if ((int) num_returns[i] > 1)
       {
          found_obstruction = true;
          break;
@@ -29,6 +29,8 @@
 #include <ossim/base/ossimGpt.h>
 #include <ossim/init/ossimInit.h>
 #include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimMultiBandHistogram.h>
+#include <ossim/base/ossimMultiResLevelHistogram.h>
 #include <ossim/base/ossimNotify.h>
 #include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimProperty.h>
@@ -80,7 +82,9 @@ static std::string CREATE_THUMBNAILS_KW        = "create_thumbnails";
 static std::string DUMP_FILTERED_IMAGES_KW     = "dump_filter_image";
 static std::string FALSE_KW                    = "false";
 static std::string FILE_KW                     = "file";
+static std::string HISTOGRAM_THREADS_KW        = "histogram_threads";
 static std::string INTERNAL_OVERVIEWS_FLAG_KW  = "internal_overviews_flag";
+static std::string MEMORY_BUDGET_KW            = "memory_budget";
 static std::string OUTPUT_DIRECTORY_KW         = "output_directory";
 static std::string OUTPUT_FILENAMES_KW         = "output_filenames";
 static std::string OVERRIDE_FILTERED_IMAGES_KW = "override_filtered_images";
@@ -109,6 +113,8 @@ ossimImageUtil::ossimImageUtil()
    m_kwl( new ossimKeywordlist() ),
    m_fileWalker(0),
    m_mutex(),
+   m_memoryCondition(),
+   m_memoryInUse(0),
    m_errorStatus(0),
    m_filteredImages(0)
 {
@@ -151,12 +157,16 @@ void ossimImageUtil::addOptions(ossimApplicationUsage* au)
  
    au->addCommandLineOption("-h", "Display this information");
  
+   au->addCommandLineOption("--histogram-threads", "<threads> The number of threads each histogram is computed with. Only used by --ch and --create-histogram-r0 when the histogram is not built with the overviews. Note a default can be set in your ossim preferences file by setting the key \"ossim.imaging.histogram.threads\".");
+ 
    au->addCommandLineOption("-i or --internal-overviews", "Builds internal overviews. Requires -o option. Option only valid with tiff input image and tiff overview builder. WARNING: Modifies source image and cannot be undone!");
  
    au->addCommandLineOption("--list-entries", "Lists the entries within the image");
  
    au->addCommandLineOption("--max","Overrides max value for compute-min-max option.");
  
+   au->addCommandLineOption("--memory-budget", "<megabytes> Limits the estimated memory of the files processed at the same time. Files wait for memory instead of starting on every thread. Note a default can be set in your ossim preferences file by setting the key \"ossim.util.image_util.memory_budget\".");
+ 
    au->addCommandLineOption("--min","Overrides min value for compute-min-max option.");
  
    au->addCommandLineOption("--null", "<null_value> Overrides null value for compute-min-max option.  e.g. -9999.0 for float data");
@@ -324,6 +334,15 @@ bool ossimImageUtil::initialize(ossimArgumentParser& ap)
             }
          }
  
+         if( ap.read("--histogram-threads", sp1) )
+         {
+            setNumberOfHistogramThreads( ts1 );
+            if ( ap.argc() < 2 )
+            {
+               break;
+            }
+         }
+ 
          if( ap.read("-i") || ap.read("--internal-overviews") )
          {
             setInternalOverviewsFlag( true );
@@ -342,6 +361,15 @@ bool ossimImageUtil::initialize(ossimArgumentParser& ap)
             }
          }
  
+         if( ap.read("--memory-budget", sp1) )
+         {
+            setMemoryBudget( ts1 );
+            if ( ap.argc() < 2 )
+            {
+               break;
+            }
+         }
+ 
          if( ap.read("--min", sp1) )
          {
             addOption( CMM_MIN_KW, ts1 );
@@ -738,11 +766,19 @@ void ossimImageUtil::processFile(const ossimFilename& file)
             // Simply output the file name of any images we can open:
             ossimNotify(ossimNotifyLevel_NOTICE) << ih->getFilename().expand(); 
          }
+
+         // Wait for room in the memory budget before reading the image.
+         MemoryReservation memory( this, getMemoryEstimate( ih.get() ) );
  
-         // Compute/Scan for min, max.  Note the overview sequencer may have computed for us.
-         if ( ( scanForMinMax() || scanForMinMaxNull() ) && !consumedCmmOptions )
+         //---
+         // Compute/Scan for min, max.  With min, max or null overrides the dot omd must be written
+         // before the overviews are built.  Else the overview sequencer scans while building and
+         // the separate pass is only made if it did not run.
+         //---
+         const bool SCAN_FLAG = ( scanForMinMax() || scanForMinMaxNull() );
+         if ( SCAN_FLAG && hasCmmOption() )
          {
-            computeMinMax( ih );
+            computeMinMax( ih, false, consumedHistogramOptions );
          }
 
          if ( createOverviews() )
@@ -753,6 +789,12 @@ void ossimImageUtil::processFile(const ossimFilename& file)
                createOverview(ih, consumedHistogramOptions, consumedCmmOptions);
             }
          }
+
+         if ( SCAN_FLAG && !hasCmmOption() && !consumedCmmOptions )
+         {
+            // Reading R0 anyway so let the scan populate the histogram too.
+            computeMinMax( ih, !consumedHistogramOptions, consumedHistogramOptions );
+         }
          if (createThumbnails())
          {
                for (ossim_uint32 idx = 0; idx < ih->getNumberOfEntries(); ++idx)
@@ -846,7 +888,8 @@ void ossimImageUtil::createOverview( ossimRefPtr<ossimImageHandler>& ih,
  
          for(ossim_uint32 idx = 0; idx < entryList.size(); ++idx)
          {
-            createOverview(ih, ob, entryList[idx], useEntryIndex, consumedHistogramOptions);
+            createOverview(ih, ob, entryList[idx], useEntryIndex,
+                           consumedHistogramOptions, consumedCmmOptions);
          }
       }
       else
@@ -868,7 +911,8 @@ void ossimImageUtil::createOverview(ossimRefPtr<ossimImageHandler>& ih,
                                     ossimRefPtr<ossimOverviewBuilderBase>& ob,
                                     ossim_uint32 entry,
                                     bool useEntryIndex,
-                                    bool& consumedHistogramOptions)
+                                    bool& consumedHistogramOptions,
+                                    bool& consumedCmmOptions)
 {
    static const char M[] = "ossimImageUtil::createOverview #2";
    if(traceDebug())
@@ -994,7 +1038,9 @@ void ossimImageUtil::createOverview(ossimRefPtr<ossimImageHandler>& ih,
       }
       else
       {
+         // Builder did not run so it did not scan this entry.
          consumedHistogramOptions = false;
+         consumedCmmOptions = false;
          ossimNotify(ossimNotifyLevel_NOTICE)
             << "Image has required reduced resolution data sets." << std::endl;
       }
@@ -1218,6 +1264,12 @@ void ossimImageUtil::createHistogram(ossimRefPtr<ossimImageHandler>& ih,
          ossimRefPtr<ossimHistogramWriter> writer = new ossimHistogramWriter;
  
          histoSource->setMaxNumberOfRLevels(1); // Currently hard coded...
+
+         ossim_uint32 histoThreads = getNumberOfHistogramThreads();
+         if ( histoThreads )
+         {
+            histoSource->setNumberOfThreads( histoThreads );
+         }
  
 #if 0 /* TODO tmp drb */
          if( !ossim::isnan(histoMin) )
@@ -1275,7 +1327,9 @@ void ossimImageUtil::createHistogram(ossimRefPtr<ossimImageHandler>& ih,
  
 } // End: ossimImageUtil::createHistogram #2
  
-void ossimImageUtil::computeMinMax(ossimRefPtr<ossimImageHandler>& ih)
+void ossimImageUtil::computeMinMax(ossimRefPtr<ossimImageHandler>& ih,
+                                   bool histogramFlag,
+                                   bool& consumedHistogramOptions)
 {
    static const char M[] = "ossimImageUtil::computeMinMax #1";
    if(traceDebug())
@@ -1295,9 +1349,27 @@ void ossimImageUtil::computeMinMax(ossimRefPtr<ossimImageHandler>& ih)
          if ( (entryList.size() > 1) || (entryList[0] != 0) ) useEntryIndex = true;
       }
  
+      //---
+      // Only a normal mode histogram is taken from the scan.  Fast mode samples a few tiles so
+      // the separate pass is cheaper than populating from all of them.
+      //---
+      if ( histogramFlag && ( getHistogramMode() != OSSIM_HISTO_MODE_NORMAL ) )
+      {
+         histogramFlag = false;
+      }
+
+      bool histogramDone = histogramFlag && entryList.size();
       for(ossim_uint32 idx = 0; idx < entryList.size(); ++idx)
       {
-         computeMinMax(ih, entryList[idx], useEntryIndex);
+         if ( !computeMinMax(ih, entryList[idx], useEntryIndex, histogramFlag) )
+         {
+            histogramDone = false;
+         }
+      }
+
+      if ( histogramDone )
+      {
+         consumedHistogramOptions = true;
       }
    }
  
@@ -1308,15 +1380,18 @@ void ossimImageUtil::computeMinMax(ossimRefPtr<ossimImageHandler>& ih)
  
 } // End: ossimImageUtil::computeMinMax( ih )
  
-void ossimImageUtil::computeMinMax( ossimRefPtr<ossimImageHandler>& ih,
+bool ossimImageUtil::computeMinMax( ossimRefPtr<ossimImageHandler>& ih,
                                     ossim_uint32 entry,
-                                    bool useEntryIndex )
+                                    bool useEntryIndex,
+                                    bool histogramFlag )
 {
    static const char M[] = "ossimImageUtil::computeMinMax #2";
    if(traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG) << M << " entered...\n";
    }
+
+   bool histogramDone = false;
  
    if ( ih.valid() )
    {
@@ -1385,6 +1460,33 @@ void ossimImageUtil::computeMinMax( ossimRefPtr<ossimImageHandler>& ih,
       {
          omd_file.setExtension("omd");
       }
+
+      // Histogram populated from the same tiles, same bins as the overview sequencer.
+      ossimFilename histoFile;
+      ossimRefPtr<ossimMultiBandHistogram> histogram = 0;
+      std::vector<ossim_uint32> originalBandList(0);
+      if ( histogramFlag )
+      {
+         histoFile = ih->getFilenameWithThisExtension(ossimString(".his"), useEntryIndex);
+         if ( (histoFile.exists() == false) || rebuildHistogram() )
+         {
+            // Histogram is of all input bands like createHistogram.
+            if ( ih->isBandSelector() )
+            {
+               ih->getOutputBandList( originalBandList );
+               ih->setOutputToInputBandList();
+            }
+            histogram = new ossimMultiBandHistogram;
+            histogram->create( ih.get() );
+
+            ossimNotify(ossimNotifyLevel_NOTICE)
+               << "Computing histogram with min, max for file: " << ih->getFilename() << std::endl;
+         }
+         else
+         {
+            histogramDone = true; // Nothing to build.
+         }
+      }
  
       ossimRefPtr<ossimImageSourceSequencer> is = new ossimImageSourceSequencer(ih.get());
  
@@ -1453,7 +1555,7 @@ void ossimImageUtil::computeMinMax( ossimRefPtr<ossimImageHandler>& ih,
       ossimNotify(ossimNotifyLevel_INFO)
          << setiosflags(ios::fixed) << setprecision(0);
  
-      if( (ossim::isnan(minValue) ) || (ossim::isnan(maxValue) ) )
+      if( (ossim::isnan(minValue) ) || (ossim::isnan(maxValue) ) || histogram.valid() )
       {
          ossimRefPtr<ossimImageData> id = is->getNextTile();
          while(id.valid())
@@ -1464,6 +1566,10 @@ void ossimImageUtil::computeMinMax( ossimRefPtr<ossimImageHandler>& ih,
                id->setNullPix( nullValue );
             }
             id->computeMinMaxPix(tmin, tmax);
+            if ( histogram.valid() )
+            {
+               id->populateHistogram( histogram );
+            }
             id = is->getNextTile();
             ++tile_count;
             ossimNotify(ossimNotifyLevel_INFO)
@@ -1483,6 +1589,31 @@ void ossimImageUtil::computeMinMax( ossimRefPtr<ossimImageHandler>& ih,
       }
       ossimNotify(ossimNotifyLevel_WARN)
          << "\r100%\nFinished..." << endl;
+
+      if ( histogram.valid() )
+      {
+         ossimRefPtr<ossimMultiResLevelHistogram> histo = new ossimMultiResLevelHistogram;
+         histo->addHistogram( histogram.get() );
+         ossimKeywordlist hkwl;
+         histo->saveState(hkwl);
+         if ( hkwl.write( histoFile.c_str() ) )
+         {
+            histogramDone = true;
+            ossimNotify(ossimNotifyLevel_INFO)
+               << "wrote file:  " << histoFile << endl;
+         }
+         else
+         {
+            ossimNotify(ossimNotifyLevel_WARN)
+               << M << "\nCould not write: " << histoFile << std::endl;
+         }
+
+         // Reset the band list.
+         if ( ih->isBandSelector() && originalBandList.size() )
+         {
+            ih->setOutputBandList( originalBandList );
+         }
+      }
  
       ossimKeywordlist okwl(omd_file);
  
@@ -1552,6 +1683,8 @@ void ossimImageUtil::computeMinMax( ossimRefPtr<ossimImageHandler>& ih,
    {
       ossimNotify(ossimNotifyLevel_DEBUG) << M << " exited...\n";
    }
+
+   return histogramDone;
    
 } // End: ossimImageUtil::computeMinMax( ih, entry, ... )
 
@@ -2027,6 +2160,134 @@ ossim_uint32 ossimImageUtil::getNumberOfThreads() const
    return result;
 }
 
+void ossimImageUtil::setNumberOfHistogramThreads( ossim_uint32 threads )
+{
+   addOption( HISTOGRAM_THREADS_KW, threads );
+}
+
+void ossimImageUtil::setNumberOfHistogramThreads( const std::string& threads )
+{
+   addOption( HISTOGRAM_THREADS_KW, threads );
+}
+
+ossim_uint32 ossimImageUtil::getNumberOfHistogramThreads() const
+{
+   ossim_uint32 result = 0;
+   std::string lookup = m_kwl->findKey( HISTOGRAM_THREADS_KW );
+   if ( lookup.size() )
+   {
+      result = ossimString(lookup).toUInt32();
+   }
+   return result;
+}
+
+void ossimImageUtil::setMemoryBudget( ossim_uint32 megabytes )
+{
+   addOption( MEMORY_BUDGET_KW, megabytes );
+}
+
+void ossimImageUtil::setMemoryBudget( const std::string& megabytes )
+{
+   addOption( MEMORY_BUDGET_KW, megabytes );
+}
+
+ossim_uint64 ossimImageUtil::getMemoryBudget() const
+{
+   ossim_uint64 result = 0;
+   std::string lookup = m_kwl->findKey( MEMORY_BUDGET_KW );
+   if ( lookup.empty() )
+   {
+      const char* pref =
+         ossimPreferences::instance()->findPreference( "ossim.util.image_util.memory_budget" );
+      if ( pref )
+      {
+         lookup = pref;
+      }
+   }
+   if ( lookup.size() )
+   {
+      result = ossimString(lookup).toUInt64() * 1024 * 1024;
+   }
+   return result;
+}
+
+ossim_uint64 ossimImageUtil::getMemoryEstimate( ossimImageHandler* ih ) const
+{
+   ossim_uint64 result = 0;
+   if ( ih )
+   {
+      const ossim_uint64 BANDS = ih->getNumberOfInputBands();
+      const ossim_uint64 BYTES = ossim::scalarSizeInBytes( ih->getOutputScalarType() );
+
+      ossim_uint64 tileHeight = ih->getImageTileHeight();
+      if ( !tileHeight )
+      {
+         tileHeight = ih->getTileHeight();
+      }
+
+      // Row of tiles read at full resolution, plus as much again for the reduced and cached tiles.
+      result = 2 * ih->getNumberOfSamples(0) * tileHeight * BANDS * BYTES;
+
+      if ( hasHistogramOption() )
+      {
+         // Values and counts of each bin, 256 bins for 8 bit data else up to 65536.
+         const ossim_uint64 BINS = ( BYTES == 1 ) ? 256 : 65536;
+         result += 2 * BINS * BANDS * sizeof(float);
+      }
+   }
+   return result;
+}
+
+ossim_uint64 ossimImageUtil::acquireMemory( ossim_uint64 bytes )
+{
+   ossim_uint64 result = 0;
+   const ossim_uint64 BUDGET = getMemoryBudget();
+   if ( BUDGET && bytes )
+   {
+      std::unique_lock<std::mutex> lock( m_mutex );
+
+      // A file over the budget on its own still runs, by itself.
+      while ( m_memoryInUse && ( ( m_memoryInUse + bytes ) > BUDGET ) )
+      {
+         m_memoryCondition.wait( lock );
+      }
+      m_memoryInUse += bytes;
+      result = bytes;
+
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimImageUtil::acquireMemory bytes: " << bytes
+            << " in use: " << m_memoryInUse << "\n";
+      }
+   }
+   return result;
+}
+
+void ossimImageUtil::releaseMemory( ossim_uint64 bytes )
+{
+   if ( bytes )
+   {
+      m_mutex.lock();
+      m_memoryInUse -= bytes;
+      m_mutex.unlock();
+      m_memoryCondition.notify_all();
+   }
+}
+
+ossimImageUtil::MemoryReservation::MemoryReservation( ossimImageUtil* util,
+                                                      ossim_uint64 bytes )
+   :
+   m_util( util ),
+   m_bytes( util->acquireMemory( bytes ) )
+{
+}
+
+ossimImageUtil::MemoryReservation::~MemoryReservation()
+{
+   m_util->releaseMemory( m_bytes );
+}
+
 ossim_uint32 ossimImageUtil::getNextWriterPropIndex() const
 {
    ossim_uint32 result = m_kwl->numberOf( WRITER_PROP_KW.c_str() );
@@ -1666,6 +1666,12 @@ void ossimInfo::closeImage()
    m_img = 0;
 }
 
+void ossimInfo::clear()
+{
+   closeImage();
+   ossimTool::clear();
+}
+
 ossimRefPtr<ossimImageHandler> ossimInfo::getImageHandler()
 {
    return m_img;
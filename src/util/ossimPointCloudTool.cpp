@@ -37,6 +37,21 @@ ossimPointCloudTool::~ossimPointCloudTool()
    m_pcuFilter = 0;
 }
 
+void ossimPointCloudTool::clear()
+{
+   m_operation = LOWEST_DEM;
+   m_pcuFilter = 0;
+   m_pciHandler = 0;
+   m_pcHandler = 0;
+   m_prodGeom = 0;
+   m_gsd = 0;
+   m_lutFile.clear();
+   m_prodFile.clear();
+   m_demFile.clear();
+   m_pcFile.clear();
+   ossimTool::clear();
+}
+
 void ossimPointCloudTool::addArguments(ossimArgumentParser& ap)
 {
    // Set the general usage:
@@ -64,6 +64,26 @@ ossimShorelineTool::~ossimShorelineTool()
 {
 }
 
+void ossimShorelineTool::clear()
+{
+   m_waterValue = 0;
+   m_marginalValue = 128;
+   m_landValue = 255;
+   m_sensor = "ls8";
+   m_threshold = -1.0;
+   m_tolerance = 0.0;
+   m_algorithm = NDWI;
+   m_thresholdMode = SIGMA;
+   m_smoothing = 0;
+   m_vectorFilename.clear();
+   m_indexFilename.clear();
+   m_threshFilename.clear();
+   m_maskFilename.clear();
+   m_geoJsonProps.clear();
+   m_noVector = false;
+   ossimChipProcTool::clear();
+}
+
 void ossimShorelineTool::setUsage(ossimArgumentParser& ap)
 {
    // Add global usage options.
@@ -34,6 +34,12 @@ ossimSubImageTool::~ossimSubImageTool()
 {
 }
 
+void ossimSubImageTool::clear()
+{
+   m_geomFormat = OGEOM;
+   ossimChipProcTool::clear();
+}
+
 void ossimSubImageTool::setUsage(ossimArgumentParser& ap)
 {
    // Add options.
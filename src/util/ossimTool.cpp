@@ -27,6 +27,9 @@ ossimTool::~ossimTool()
 
 void ossimTool::clear()
 {
+   m_kwl.clear();
+   m_helpRequested = false;
+   m_response.clear();
 }
 
 void ossimTool::abort()
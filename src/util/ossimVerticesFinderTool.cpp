@@ -33,6 +33,14 @@ ossimVerticesFinderTool::~ossimVerticesFinderTool()
 {
 }
 
+void ossimVerticesFinderTool::clear()
+{
+   m_inputFile.clear();
+   m_outputFile.clear();
+   m_entryIndex = 0;
+   ossimTool::clear();
+}
+
 void ossimVerticesFinderTool::setUsage(ossimArgumentParser& ap)
 {
    // Add options.
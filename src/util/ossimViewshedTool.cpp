@@ -26,6 +26,7 @@
 #include <ossim/imaging/ossimMemoryImageSource.h>
 #include <ossim/imaging/ossimIndexToRgbLutFilter.h>
 #include <ossim/util/ossimViewshedTool.h>
+#include <ossim/parallel/ossimJobStealingQueue.h>
 #include <ossim/base/Thread.h>
 
 using namespace std;
@@ -66,12 +67,7 @@ ossimViewshedTool::ossimViewshedTool()
 
 ossimViewshedTool::~ossimViewshedTool()
 {
-   if (m_radials)
-   {
-      for (int i=0; i<4; ++i)
-         delete [] m_radials[i];
-      delete [] m_radials;
-   }
+   deleteRadials();
 }
 
 void ossimViewshedTool::setUsage(ossimArgumentParser& ap)
@@ -288,14 +284,43 @@ void ossimViewshedTool::initialize(const ossimKeywordlist& kwl)
 
 void ossimViewshedTool::clear()
 {
+   deleteRadials();
    m_observerGpt.makeNan();
+   m_observerVpt = ossimDpt();
+   m_obsHgtAbvTer = 1.5;
    m_visRadius = 0;
+   m_obsInsideAoi = true;
+   m_displayAsRadar = false;
+   m_halfWindow = 0;
    m_outBuffer = 0;
-   m_horizonMap.clear();
+   m_memSource = 0;
+   m_visibleValue = 1;
+   m_hiddenValue = 128;
+   m_overlayValue = 255;
+   m_reticleSize = 25;
+   m_simulation = false;
    m_jobMtQueue = 0;
+   m_numThreads = 1;
+   m_startFov = 0;
+   m_stopFov = 0;
+   m_threadBySector = false;
+   m_horizonFile.clear();
+   m_horizonMap.clear();
+   d_accumT = 0;
    ossimChipProcTool::clear();
 }
 
+void ossimViewshedTool::deleteRadials()
+{
+   if (m_radials)
+   {
+      for (int i=0; i<8; ++i)
+         delete [] m_radials[i];
+      delete [] m_radials;
+      m_radials = 0;
+   }
+}
+
 void ossimViewshedTool::initializeProjectionGsd()
 {
    // First try normal base class initialization. If that doesn't work, then probably no DEM
@@ -501,7 +526,8 @@ bool ossimViewshedTool::computeViewshed()
 
    if (m_numThreads > 1)
    {
-      std::shared_ptr<ossimJobQueue> jobQueue = std::make_shared<ossimJobQueue>();
+      std::shared_ptr<ossimJobQueue> jobQueue =
+         std::make_shared<ossimJobStealingQueue>(m_numThreads);
       for (int sector=0; sector<8; ++sector)
       {
          if (m_radials[sector] == 0)
@@ -529,8 +555,7 @@ bool ossimViewshedTool::computeViewshed()
 
       // Wait until all radials have been processed before proceeding:
       ossimNotify(ossimNotifyLevel_INFO) << "Waiting for job threads to finish..."<<endl;
-      while (m_jobMtQueue->hasJobsToProcess() || m_jobMtQueue->numberOfBusyThreads())
-         ossim::Thread::sleepInMicroSeconds(250);
+      m_jobMtQueue->waitAll();
    }
    else
    {
@@ -748,6 +773,7 @@ void ossimViewshedTool::initRadials()
    }
 
    // Compute the azimuth slopes for each radial in the sector.
+   deleteRadials();
    m_radials = new Radial* [8];
    double du = m_halfWindow;
    for (int sector=0; sector<8; ++sector)
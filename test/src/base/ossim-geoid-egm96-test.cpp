@@ -0,0 +1,109 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of ossimGeoidEgm96: the batch and grid offsets must match offsetFromEllipsoid exactly.
+// Prints the time of each way over the same regular grid.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimGeoidEgm96.h>
+#include <ossim/base/ossimGpt.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/** @return Seconds since start. */
+static double elapsed(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/** @return true if a and b are equal or both nan. */
+static bool same(double a, double b)
+{
+   return (a == b) || (ossim::isnan(a) && ossim::isnan(b));
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+   if (argc != 2)
+   {
+      cout << "usage: " << argv[0] << " <egm96.grd or its directory>" << endl;
+      return 0;
+   }
+
+   ossimRefPtr<ossimGeoidEgm96> geoid = new ossimGeoidEgm96(ossimFilename(argv[1]));
+   if (geoid->getErrorStatus() != ossimErrorCodes::OSSIM_OK)
+   {
+      cerr << "Could not open " << argv[1] << endl;
+      return 1;
+   }
+   cout << "memory mapped: " << (geoid->isMemoryMapped() ? "true" : "false") << endl;
+
+   //---
+   // About a half degree grid, 288000 points, with spacings off the quarter degree egm96 posts.
+   // Goes a little past the poles and the date line to check the wraps.
+   //---
+   const ossimDpt ORIGIN(-181.0, 91.0);
+   const ossimDpt SPACING(0.5037, -0.4561);
+   const ossim_uint32 COLS = 720;
+   const ossim_uint32 ROWS = 400;
+   const ossim_uint32 STEP = 7; // rows checked against the single point form
+
+   vector<double> gridOffsets((size_t)COLS * ROWS);
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   geoid->offsetsFromEllipsoidGrid(ORIGIN, SPACING, COLS, ROWS, &gridOffsets.front());
+   double gridTime = elapsed(start);
+
+   vector<ossimGpt> gpts(COLS);
+   vector<double> batchOffsets(COLS);
+   double pointTime = 0.0;
+   double batchTime = 0.0;
+   ossim_uint32 mismatches = 0;
+   ossim_uint32 checked = 0;
+   for (ossim_uint32 r = 0; r < ROWS; r += STEP)
+   {
+      for (ossim_uint32 c = 0; c < COLS; ++c)
+         gpts[c] = ossimGpt(ORIGIN.y + r * SPACING.y, ORIGIN.x + c * SPACING.x);
+
+      start = chrono::steady_clock::now();
+      geoid->offsetsFromEllipsoid(&gpts.front(), COLS, &batchOffsets.front());
+      batchTime += elapsed(start);
+
+      for (ossim_uint32 c = 0; c < COLS; ++c)
+      {
+         start = chrono::steady_clock::now();
+         double offset = geoid->offsetFromEllipsoid(gpts[c]);
+         pointTime += elapsed(start);
+
+         if (!same(offset, batchOffsets[c]) || !same(offset, gridOffsets[r * COLS + c]))
+         {
+            if (mismatches < 10)
+            {
+               cerr << "mismatch at " << gpts[c] << ": point " << offset << " batch "
+                    << batchOffsets[c] << " grid " << gridOffsets[r * COLS + c] << endl;
+            }
+            ++mismatches;
+         }
+         ++checked;
+      }
+   }
+
+   cout << "points checked:      " << checked
+        << "\nmismatches:          " << mismatches
+        << "\npoint ns/offset:     " << 1.0e9 * pointTime / checked
+        << "\nbatch ns/offset:     " << 1.0e9 * batchTime / checked
+        << "\ngrid ns/offset:      " << 1.0e9 * gridTime / ((double)COLS * ROWS) << endl;
+
+   return mismatches ? 1 : 0;
+}
@@ -0,0 +1,229 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of the byte accounting of ossimFixedTileCache and ossimAppFixedTileCache while tiles are
+// added from several threads and the caches are flushed, re-gridded and trimmed at the same time.
+// Once the threads are done the bytes added must equal the bytes flushed plus the bytes still
+// cached, and the application total must equal the sum of the tiles left in its caches.
+//
+//**************************************************************************************************
+#include <ossim/init/ossimInit.h>
+#include <ossim/imaging/ossimAppFixedTileCache.h>
+#include <ossim/imaging/ossimFixedTileCache.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const ossim_int32 TILE = 64;
+static const ossim_int32 TILES = 16; // Per side of the grid.
+static const ossim_uint32 ADDERS = 4;
+static const ossim_uint32 ROUNDS = 40;
+static const ossimIrect GRID(0, 0, TILE * TILES - 1, TILE * TILES - 1);
+
+static ossim_uint32 failures = 0;
+
+static void expect(bool condition, const string& what)
+{
+   cout << what << ": " << ( condition ? "passed" : "FAILED" ) << endl;
+   if ( !condition )
+   {
+      ++failures;
+   }
+}
+
+static ossimRefPtr<ossimImageData> makeTile(ossim_int32 x, ossim_int32 y)
+{
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, OSSIM_UINT8, 1, TILE, TILE);
+   tile->setOrigin(ossimIpt(x, y));
+   tile->initialize();
+   return tile;
+}
+
+/** @return Bytes of the tiles of the grid found in cache. */
+static ossim_uint64 cachedBytes(ossimFixedTileCache* cache)
+{
+   ossim_uint64 result = 0;
+   for ( ossim_int32 y = 0; y < TILES; ++y )
+   {
+      for ( ossim_int32 x = 0; x < TILES; ++x )
+      {
+         ossimRefPtr<ossimImageData> tile = cache->getTile(ossimIpt(x * TILE, y * TILE));
+         if ( tile.valid() )
+         {
+            result += tile->getDataSizeInBytes();
+         }
+      }
+   }
+   return result;
+}
+
+/** Same for a cache of the application cache. */
+static ossim_uint64 cachedBytes(ossimAppFixedTileCache::ossimAppFixedCacheId id)
+{
+   ossim_uint64 result = 0;
+   for ( ossim_int32 y = 0; y < TILES; ++y )
+   {
+      for ( ossim_int32 x = 0; x < TILES; ++x )
+      {
+         ossimRefPtr<ossimImageData> tile =
+            ossimAppFixedTileCache::instance()->getTile(id, ossimIpt(x * TILE, y * TILE));
+         if ( tile.valid() )
+         {
+            result += tile->getDataSizeInBytes();
+         }
+      }
+   }
+   return result;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+   //---
+   // ossimFixedTileCache: adders against a thread flushing and resetting the rect.
+   //---
+   {
+      ossimRefPtr<ossimFixedTileCache> cache = new ossimFixedTileCache();
+      cache->setRect(GRID, ossimIpt(TILE, TILE));
+
+      atomic<ossim_uint64> added(0);
+      atomic<ossim_uint64> removed(0);
+      atomic<bool> adding(true);
+      vector<thread> threads;
+      for ( ossim_uint32 t = 0; t < ADDERS; ++t )
+      {
+         threads.push_back(thread([&, t]()
+         {
+            for ( ossim_uint32 r = 0; r < ROUNDS; ++r )
+            {
+               for ( ossim_int32 i = 0; i < TILES * TILES; ++i )
+               {
+                  ossim_int32 id = ( i * 7 + (ossim_int32)t * 31 ) % ( TILES * TILES );
+                  ossimRefPtr<ossimImageData> tile =
+                     cache->addTile(makeTile(( id % TILES ) * TILE, ( id / TILES ) * TILE), false);
+                  if ( tile.valid() )
+                  {
+                     added += tile->getDataSizeInBytes();
+                  }
+               }
+            }
+         }));
+      }
+      thread flusher([&]()
+      {
+         for ( ossim_uint32 i = 0; adding; ++i )
+         {
+            removed += ( i % 4 ) ? cache->flush() : cache->setRect(GRID, ossimIpt(TILE, TILE));
+            this_thread::yield();
+         }
+      });
+      for ( ossim_uint32 t = 0; t < ADDERS; ++t )
+      {
+         threads[t].join();
+      }
+      adding = false;
+      flusher.join();
+
+      cout << "fixed cache: added " << added << " removed " << removed
+           << " cached " << cache->getCacheSize() << endl;
+      expect( added > 0 && removed > 0, "fixed cache: tiles added and flushed" );
+      expect( added == removed + cache->getCacheSize(),
+              "fixed cache: added bytes equal flushed plus cached bytes" );
+      expect( cachedBytes(cache.get()) == cache->getCacheSize(),
+              "fixed cache: cache size equals the bytes of its tiles" );
+      ossim_uint32 size = cache->getCacheSize();
+      expect( cache->flush() == size, "fixed cache: flush returns the cached bytes" );
+      expect( cache->getCacheSize() == 0, "fixed cache: size is 0 after flush" );
+   }
+
+   //---
+   // ossimAppFixedTileCache: one cache per adder, with a budget small enough that adds trim
+   // the caches, against a thread flushing single caches, all caches and resetting rects.
+   //---
+   {
+      ossimAppFixedTileCache* appCache = ossimAppFixedTileCache::instance();
+      const ossim_uint64 OTHER_BYTES = appCache->getCurrentCacheSize(); // Caches not ours.
+      appCache->setMaxCacheSize(TILES * TILES * TILE * TILE);
+
+      vector<ossimAppFixedTileCache::ossimAppFixedCacheId> ids;
+      for ( ossim_uint32 t = 0; t < ADDERS; ++t )
+      {
+         ids.push_back(appCache->newTileCache(GRID, ossimIpt(TILE, TILE)));
+      }
+
+      atomic<bool> adding(true);
+      vector<thread> threads;
+      for ( ossim_uint32 t = 0; t < ADDERS; ++t )
+      {
+         threads.push_back(thread([&, t]()
+         {
+            for ( ossim_uint32 r = 0; r < ROUNDS; ++r )
+            {
+               for ( ossim_int32 i = 0; i < TILES * TILES; ++i )
+               {
+                  ossim_int32 id = ( i * 7 + (ossim_int32)t * 31 ) % ( TILES * TILES );
+                  appCache->addTile(ids[t], makeTile(( id % TILES ) * TILE, ( id / TILES ) * TILE));
+               }
+            }
+         }));
+      }
+      thread flusher([&]()
+      {
+         for ( ossim_uint32 i = 0; adding; ++i )
+         {
+            switch ( i % 8 )
+            {
+               case 0:
+                  appCache->flush();
+                  break;
+               case 1:
+                  appCache->setRect(ids[i % ADDERS], GRID);
+                  break;
+               default:
+                  appCache->flush(ids[i % ADDERS]);
+                  break;
+            }
+            this_thread::yield();
+         }
+      });
+      for ( ossim_uint32 t = 0; t < ADDERS; ++t )
+      {
+         threads[t].join();
+      }
+      adding = false;
+      flusher.join();
+
+      ossim_uint64 sum = 0;
+      for ( ossim_uint32 t = 0; t < ADDERS; ++t )
+      {
+         sum += cachedBytes(ids[t]);
+      }
+      cout << "app cache: current " << appCache->getCurrentCacheSize() << " tiles " << sum << endl;
+      expect( appCache->getCurrentCacheSize() == OTHER_BYTES + sum,
+              "app cache: current size equals the bytes of the cached tiles" );
+
+      for ( ossim_uint32 t = 0; t < ADDERS; ++t )
+      {
+         appCache->deleteCache(ids[t]);
+      }
+      expect( appCache->getCurrentCacheSize() == OTHER_BYTES,
+              "app cache: deleting the caches removes their bytes" );
+   }
+
+   cout << "seconds: "
+        << chrono::duration<double>(chrono::steady_clock::now() - start).count()
+        << "\nfailures: " << failures << endl;
+
+   return failures ? 1 : 0;
+}
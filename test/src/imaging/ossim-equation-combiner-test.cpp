@@ -0,0 +1,176 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of the compiled ossimEquationCombiner equations: each equation must compile with
+// ossimEquationProgram and each tile must match the one the interpreter makes from the same
+// inputs.  Prints the time of each way per tile.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimConnectableObject.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/imaging/ossimEquationCombiner.h>
+#include <ossim/imaging/ossimEquationProgram.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+/** Combiner that always interprets its equation. */
+class ossimInterpretedEquationCombiner : public ossimEquationCombiner
+{
+public:
+   ossimInterpretedEquationCombiner(ossimConnectableObject::ConnectableObjectList& inputs)
+      : ossimEquationCombiner(inputs)
+   {
+   }
+
+protected:
+   virtual bool evaluateProgram()
+   {
+      return false;
+   }
+};
+
+/** @return Seconds since start. */
+static double elapsed(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/** @return Source of a bands x size x size uint16 image with a pattern and some null pixels. */
+static ossimRefPtr<ossimMemoryImageSource> makeSource(ossim_uint32 bands,
+                                                      ossim_uint32 size,
+                                                      ossim_uint32 seed)
+{
+   ossimRefPtr<ossimImageData> image = new ossimImageData(0, OSSIM_UINT16, bands, size, size);
+   image->initialize();
+   for (ossim_uint32 b = 0; b < bands; ++b)
+   {
+      ossim_uint16* buf = static_cast<ossim_uint16*>(image->getBuf(b));
+      for (ossim_uint32 i = 0; i < size * size; ++i)
+      {
+         ossim_uint32 v = (i * (7 + seed) + b * 131 + seed * 17) % 4096;
+         buf[i] = ((i + seed) % 97 == 0) ? 0 : (ossim_uint16)(v + 1);
+      }
+   }
+   image->validate();
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource();
+   source->setImage(image);
+   source->setRect(0, 0, size, size);
+   return source;
+}
+
+/** @return true if a and b are equal or both nan. */
+static bool same(double a, double b)
+{
+   return (a == b) || (ossim::isnan(a) && ossim::isnan(b));
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   const ossim_uint32 SIZE = 256;
+   const ossim_uint32 REPEAT = 20;
+   const char* EQUATIONS[] =
+   {
+      "in[0] + in[1]",
+      "(in[0] - in[1]) / (in[0] + in[1])",
+      "band(in[0], 0) * 0.5 + band(in[1], 1) * 2",
+      "min(in[0], in[1], 1000)",
+      "max(in[0], 10) > in[1]",
+      "sqrt(abs(in[0] - in[1])) + log10(in[1])",
+      "(in[0] & 255) | (in[1] ^ 3)",
+      "-in[0] + 2 * PI",
+      "in[0] == in[1] | in[0] < 100",
+      0
+   };
+
+   ossimConnectableObject::ConnectableObjectList inputs;
+   inputs.push_back(makeSource(2, SIZE, 1).get());
+   inputs.push_back(makeSource(2, SIZE, 2).get());
+
+   ossimRefPtr<ossimEquationCombiner> compiled = new ossimEquationCombiner(inputs);
+   ossimRefPtr<ossimEquationCombiner> interpreted = new ossimInterpretedEquationCombiner(inputs);
+   const ossimIrect RECT(0, 0, SIZE - 1, SIZE - 1);
+
+   ossim_uint32 mismatches = 0;
+   for (ossim_uint32 e = 0; EQUATIONS[e]; ++e)
+   {
+      // Else both combiners interpret and the comparison proves nothing.
+      ossimEquationProgram program;
+      if (!program.compile(EQUATIONS[e]))
+      {
+         cerr << EQUATIONS[e] << ": does not compile" << endl;
+         ++mismatches;
+         continue;
+      }
+
+      compiled->setEquation(EQUATIONS[e]);
+      interpreted->setEquation(EQUATIONS[e]);
+      compiled->initialize();
+      interpreted->initialize();
+
+      ossimRefPtr<ossimImageData> expected;
+      ossimRefPtr<ossimImageData> result;
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (ossim_uint32 i = 0; i < REPEAT; ++i)
+      {
+         expected = interpreted->getTile(RECT);
+      }
+      double interpretedTime = elapsed(start);
+
+      start = chrono::steady_clock::now();
+      for (ossim_uint32 i = 0; i < REPEAT; ++i)
+      {
+         result = compiled->getTile(RECT);
+      }
+      double compiledTime = elapsed(start);
+
+      if (!expected.valid() || !result.valid() ||
+          (expected->getNumberOfBands() != result->getNumberOfBands()))
+      {
+         cerr << EQUATIONS[e] << ": missing tile or band count differs" << endl;
+         ++mismatches;
+         continue;
+      }
+
+      ossim_uint32 differences = 0;
+      for (ossim_uint32 b = 0; b < result->getNumberOfBands(); ++b)
+      {
+         for (ossim_uint32 i = 0; i < SIZE * SIZE; ++i)
+         {
+            double a = expected->getPix(i, b);
+            double c = result->getPix(i, b);
+            if (!same(a, c))
+            {
+               if (differences < 5)
+               {
+                  cerr << EQUATIONS[e] << ": band " << b << " pixel " << i
+                       << " interpreted " << a << " compiled " << c << endl;
+               }
+               ++differences;
+            }
+         }
+      }
+      if (differences)
+      {
+         ++mismatches;
+      }
+
+      cout << EQUATIONS[e]
+           << "\n   interpreted ms/tile: " << 1.0e3 * interpretedTime / REPEAT
+           << "\n   compiled ms/tile:    " << 1.0e3 * compiledTime / REPEAT
+           << "\n   differences:         " << differences << endl;
+   }
+
+   return mismatches ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of the two pass (separable) kernel of ossimFilterResampler: for every filter, scalar type
+// and scale the output must match the 2-D kernel (separable flag off) byte for byte, including
+// null pixels, tile edges and output sub-rects.  Prints the time of each way per case.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/imaging/ossimFilterResampler.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+
+/** @return Seconds since start. */
+static double elapsed(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/** Sets pixel i of band b of tile to v. */
+static void setPixel(ossimImageData* tile, ossim_uint32 b, ossim_uint32 i, ossim_float64 v)
+{
+   switch (tile->getScalarType())
+   {
+   case OSSIM_UINT8:
+      static_cast<ossim_uint8*>(tile->getBuf(b))[i] = (ossim_uint8)v;
+      break;
+   case OSSIM_SINT16:
+      static_cast<ossim_sint16*>(tile->getBuf(b))[i] = (ossim_sint16)v;
+      break;
+   case OSSIM_FLOAT32:
+      static_cast<ossim_float32*>(tile->getBuf(b))[i] = (ossim_float32)v;
+      break;
+   default:
+      static_cast<ossim_uint16*>(tile->getBuf(b))[i] = (ossim_uint16)v;
+      break;
+   }
+}
+
+/** @return Input tile of type with a pattern and about 3% null pixels. */
+static ossimRefPtr<ossimImageData> makeInput(ossimScalarType type,
+                                             const ossimIrect& rect,
+                                             ossim_uint32 seed)
+{
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, type, 3, rect.width(), rect.height());
+   tile->setImageRectangle(rect);
+   tile->initialize();
+   const ossim_uint32 COUNT = rect.width() * rect.height();
+   for (ossim_uint32 b = 0; b < 3; ++b)
+   {
+      const ossim_float64 MIN = tile->getMinPix(b);
+      const ossim_float64 RANGE = tile->getMaxPix(b) - MIN;
+      for (ossim_uint32 i = 0; i < COUNT; ++i)
+      {
+         ossim_uint32 r = (i * 2654435761u + b * 40503u + seed * 977u) >> 9;
+         ossim_float64 v = MIN + RANGE * (ossim_float64)(r % 1000) / 999.0;
+         if ((r + i) % 31 == 0)
+         {
+            v = tile->getNullPix(b);
+         }
+         setPixel(tile.get(), b, i, v);
+      }
+   }
+   tile->validate();
+   return tile;
+}
+
+/** @return Number of bytes that differ in the buffers of a and b. */
+static ossim_uint32 compare(const ossimImageData* a, const ossimImageData* b)
+{
+   ossim_uint32 differences = 0;
+   const ossim_uint32 BYTES = a->getSizePerBandInBytes();
+   for (ossim_uint32 band = 0; band < a->getNumberOfBands(); ++band)
+   {
+      const ossim_uint8* pa = static_cast<const ossim_uint8*>(a->getBuf(band));
+      const ossim_uint8* pb = static_cast<const ossim_uint8*>(b->getBuf(band));
+      if (memcmp(pa, pb, BYTES) != 0)
+      {
+         for (ossim_uint32 i = 0; i < BYTES; ++i)
+         {
+            if (pa[i] != pb[i])
+            {
+               ++differences;
+            }
+         }
+      }
+   }
+   return differences;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   const ossimFilterResampler::ossimFilterResamplerType FILTERS[] =
+   {
+      ossimFilterResampler::ossimFilterResampler_BOX,
+      ossimFilterResampler::ossimFilterResampler_GAUSSIAN,
+      ossimFilterResampler::ossimFilterResampler_CUBIC,
+      ossimFilterResampler::ossimFilterResampler_HANNING,
+      ossimFilterResampler::ossimFilterResampler_HAMMING,
+      ossimFilterResampler::ossimFilterResampler_LANCZOS,
+      ossimFilterResampler::ossimFilterResampler_MITCHELL,
+      ossimFilterResampler::ossimFilterResampler_CATROM,
+      ossimFilterResampler::ossimFilterResampler_BSPLINE,
+      ossimFilterResampler::ossimFilterResampler_QUADRATIC
+   };
+   const ossimScalarType TYPES[] =
+   {
+      OSSIM_UINT8, OSSIM_SINT16, OSSIM_UINT16, OSSIM_USHORT11, OSSIM_FLOAT32
+   };
+   const ossim_float64 SCALES[] = { 0.5, 0.37, 0.8, 2.0 };
+   const ossim_uint32 OUT_SIZE = 64;
+
+   ossim_uint32 failures = 0;
+   ossim_uint32 cases = 0;
+   double separableTime = 0.0;
+   double kernel2dTime = 0.0;
+
+   for (ossim_uint32 f = 0; f < sizeof(FILTERS) / sizeof(FILTERS[0]); ++f)
+   {
+      for (ossim_uint32 t = 0; t < sizeof(TYPES) / sizeof(TYPES[0]); ++t)
+      {
+         for (ossim_uint32 s = 0; s < sizeof(SCALES) / sizeof(SCALES[0]); ++s)
+         {
+            const ossim_float64 SCALE = SCALES[s];
+            const ossim_float64 STEP = 1.0 / SCALE; // input pixels per output pixel
+
+            ossimFilterResampler separable;
+            ossimFilterResampler kernel2d;
+            separable.setFilterType(FILTERS[f]);
+            kernel2d.setFilterType(FILTERS[f]);
+            separable.setScaleFactor(ossimDpt(SCALE, SCALE));
+            kernel2d.setScaleFactor(ossimDpt(SCALE, SCALE));
+            separable.setSeparableFlag(true);
+            kernel2d.setSeparableFlag(false);
+
+            // Input covers the output footprint plus a margin; the odd origin puts the kernel
+            // over the input edges on the first rows and columns.
+            const ossim_int32 IN_SIZE = (ossim_int32)std::ceil(OUT_SIZE * STEP) + 12;
+            const ossimIrect IN_RECT(-5, 3, IN_SIZE - 6, IN_SIZE + 2);
+            separable.setBoundingInputRect(IN_RECT);
+            kernel2d.setBoundingInputRect(IN_RECT);
+            ossimRefPtr<ossimImageData> input = makeInput(TYPES[t], IN_RECT, f * 31 + t * 7 + s);
+
+            // Edge case and interior case, each over the whole tile and a sub-rect.
+            const ossimDpt ORIGINS[] = { ossimDpt(-4.8, 3.3), ossimDpt(0.27, 6.61) };
+            for (ossim_uint32 o = 0; o < 2; ++o)
+            {
+               const ossimIrect OUT_RECT(0, 0, OUT_SIZE - 1, OUT_SIZE - 1);
+               const ossimIrect SUB_RECTS[] = { OUT_RECT, ossimIrect(5, 9, 50, 40) };
+
+               for (ossim_uint32 r = 0; r < 2; ++r)
+               {
+                  // As the renderer calls it: corners and length are those of the sub-rect.
+                  const ossimIrect& SUB = SUB_RECTS[r];
+                  const ossimDpt UL(ORIGINS[o].x + SUB.ul().x * STEP,
+                                    ORIGINS[o].y + SUB.ul().y * STEP);
+                  const ossimDpt UR(UL.x + (SUB.width() - 1) * STEP, UL.y);
+                  const ossimDpt DELTA(0.0, STEP);
+                  const ossimDpt LENGTH(SUB.width(), SUB.height());
+
+                  ossimRefPtr<ossimImageData> expected =
+                     new ossimImageData(0, TYPES[t], 3, OUT_SIZE, OUT_SIZE);
+                  expected->initialize();
+                  expected->makeBlank();
+                  ossimRefPtr<ossimImageData> result =
+                     new ossimImageData(0, TYPES[t], 3, OUT_SIZE, OUT_SIZE);
+                  result->initialize();
+                  result->makeBlank();
+
+                  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                  kernel2d.resample(input, expected, SUB, UL, UR, DELTA, DELTA, LENGTH);
+                  kernel2dTime += elapsed(start);
+
+                  start = chrono::steady_clock::now();
+                  separable.resample(input, result, SUB, UL, UR, DELTA, DELTA, LENGTH);
+                  separableTime += elapsed(start);
+
+                  ossim_uint32 differences = compare(expected.get(), result.get());
+                  if (differences)
+                  {
+                     if (failures < 10)
+                     {
+                        cerr << "filter " << separable.getMinifyFilterTypeAsString()
+                             << " type " << TYPES[t] << " scale " << SCALE
+                             << " origin " << UL << " sub rect " << SUB
+                             << ": " << differences << " bytes differ" << endl;
+                     }
+                     ++failures;
+                  }
+                  ++cases;
+               }
+            }
+         }
+      }
+   }
+
+   cout << "cases:              " << cases
+        << "\nfailures:           " << failures
+        << "\n2-D ms/case:        " << 1.0e3 * kernel2dTime / cases
+        << "\nseparable ms/case:  " << 1.0e3 * separableTime / cases << endl;
+
+   return failures ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Benchmark of opening images the normal way (cold) against opening them from a state kept in an
+// ossim::ImageHandlerStateStore (warm). Run with the registry state cache and state store
+// preferences unset so the cold opens parse the headers every time.  Only images whose reader
+// has a handler state, currently tiff, can be stored; others are listed as "no state".
+//
+//**************************************************************************************************
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimApplicationUsage.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/support_data/ImageHandlerStateStore.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+
+using namespace std;
+
+static const ossim_uint32 DEFAULT_ITERATIONS = 20;
+
+/** @return Seconds since start. */
+static double elapsed(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ap.getApplicationUsage()->setApplicationName(ap.getApplicationName());
+   ap.getApplicationUsage()->setCommandLineUsage(
+      ap.getApplicationName() + " [options] <image> [<image>...]");
+   ap.getApplicationUsage()->addCommandLineOption("-h or --help", "Display this information");
+   ap.getApplicationUsage()->addCommandLineOption("--store <dir>",
+                                                  "State store directory. Default: ./state_store");
+   ap.getApplicationUsage()->addCommandLineOption("--iterations <n>",
+                                                  "Times each image is opened each way.");
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   if ((ap.argc() < 2) || ap.read("-h") || ap.read("--help"))
+   {
+      ap.getApplicationUsage()->write(ossimNotify(ossimNotifyLevel_INFO));
+      return 0;
+   }
+
+   ossimFilename storeDir = "state_store";
+   ossim_uint32 iterations = DEFAULT_ITERATIONS;
+   std::string ts;
+   ossimArgumentParser::ossimParameter sp(ts);
+   if (ap.read("--store", sp))
+      storeDir = ts;
+   if (ap.read("--iterations", sp))
+      iterations = (ossim_uint32) atoi(ts.c_str());
+   if (iterations == 0)
+      iterations = 1;
+
+   ossim::ImageHandlerStateStore store(storeDir);
+   ossimImageHandlerRegistry* registry = ossimImageHandlerRegistry::instance();
+
+   cout << "store: " << store.getDirectory() << "  iterations: " << iterations << "\n\n"
+        << setw(14) << "cold (ms)" << setw(14) << "warm (ms)" << setw(10) << "speedup"
+        << "  image" << endl;
+
+   int failures = 0;
+   for (int i = 1; i < ap.argc(); ++i)
+   {
+      ossimFilename file = ap[i];
+
+      // Cold: every open parses the headers.
+      double coldTime = 0.0;
+      std::shared_ptr<ossim::ImageHandlerState> state;
+      for (ossim_uint32 n = 0; n < iterations; ++n)
+      {
+         chrono::steady_clock::time_point start = chrono::steady_clock::now();
+         ossimRefPtr<ossimImageHandler> h = registry->open(file, true, true);
+         coldTime += elapsed(start);
+         if (h.valid())
+            state = h->getState();
+      }
+
+      if (!state || !store.addState(file, state))
+      {
+         cout << setw(14) << "-" << setw(14) << "-" << setw(10) << "-" << "  " << file
+              << " (no state)" << endl;
+         ++failures;
+         continue;
+      }
+
+      // Warm: the state is read back from the store as another process would.
+      double warmTime = 0.0;
+      for (ossim_uint32 n = 0; n < iterations; ++n)
+      {
+         chrono::steady_clock::time_point start = chrono::steady_clock::now();
+         ossimRefPtr<ossimImageHandler> h;
+         std::shared_ptr<ossim::ImageHandlerState> storedState = store.getState(file, 0);
+         if (storedState)
+            h = registry->open(storedState);
+         warmTime += elapsed(start);
+         if (!h.valid())
+         {
+            ++failures;
+            break;
+         }
+      }
+
+      coldTime = 1000.0 * coldTime / iterations;
+      warmTime = 1000.0 * warmTime / iterations;
+      cout << fixed << setprecision(3) << setw(14) << coldTime << setw(14) << warmTime
+           << setprecision(2) << setw(10) << (warmTime > 0.0 ? coldTime / warmTime : 0.0)
+           << "  " << file << endl;
+   }
+
+   return failures ? 1 : 0;
+}
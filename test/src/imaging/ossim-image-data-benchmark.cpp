@@ -0,0 +1,275 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Micro-benchmark of the ossimImageData pixel loops (tile loads, min/max scans and
+// normalization) with the scalar kernels against each SIMD level the CPU supports. Output
+// of every SIMD run is compared with the scalar run.
+//
+//**************************************************************************************************
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageDataKernels.h>
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimApplicationUsage.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/base/ossimScalarTypeLut.h>
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 DEFAULT_SIZE = 256;
+static const ossim_uint32 DEFAULT_BANDS = 3;
+static const ossim_uint32 DEFAULT_ITERATIONS = 200;
+
+static const ossimScalarType SCALARS[] = { OSSIM_UINT8, OSSIM_UINT16, OSSIM_SINT16, OSSIM_FLOAT32 };
+
+enum Operation
+{
+   LOAD_BIP = 0,
+   LOAD_BIL,
+   LOAD_BSQ,
+   MIN_MAX,
+   MIN_MAX_NUL,
+   NORMALIZE,
+   UNNORMALIZE,
+   OPERATION_COUNT
+};
+
+static const char* OPERATION_NAMES[] =
+{
+   "loadTileFromBip",
+   "loadTileFromBil",
+   "loadTileFromBsq",
+   "computeMinMaxPix",
+   "computeMinMaxNulPix",
+   "convertToNormalizedFloat",
+   "unnormalizeInput"
+};
+
+/** Fills buf with random pixels between the tile min and max, every 17th one null. */
+template <class T>
+static void fillRandom(T* buf, ossim_uint32 count, double minPix, double maxPix, double nullPix)
+{
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      if (i % 17 == 0)
+         buf[i] = (T)nullPix;
+      else
+         buf[i] = (T)(minPix + (maxPix - minPix) * ((double)rand() / RAND_MAX));
+   }
+}
+
+static void fillRandom(ossimScalarType scalar, void* buf, ossim_uint32 count,
+                       const ossimImageData* tile)
+{
+   const double MIN = tile->getMinPix(0);
+   const double MAX = tile->getMaxPix(0);
+   const double NUL = tile->getNullPix(0);
+   switch (scalar)
+   {
+   case OSSIM_UINT8:
+      fillRandom((ossim_uint8*)buf, count, MIN, MAX, NUL);
+      break;
+   case OSSIM_UINT16:
+      fillRandom((ossim_uint16*)buf, count, MIN, MAX, NUL);
+      break;
+   case OSSIM_SINT16:
+      fillRandom((ossim_sint16*)buf, count, MIN, MAX, NUL);
+      break;
+   default:
+      fillRandom((ossim_float32*)buf, count, -10000.0, 10000.0, NUL);
+      break;
+   }
+}
+
+static void appendBytes(vector<ossim_uint8>& out, const void* buf, ossim_uint32 bytes)
+{
+   const ossim_uint8* p = (const ossim_uint8*)buf;
+   out.insert(out.end(), p, p + bytes);
+}
+
+/**
+ * Runs one operation iterations times.
+ * @param output Set to the bytes produced by the last run for comparison.
+ * @return Elapsed seconds.
+ */
+static double runOperation(Operation op, ossimImageData* tile, ossimImageData* normTile,
+                           const vector<ossim_uint8>& src, ossim_uint32 iterations,
+                           vector<ossim_uint8>& output)
+{
+   const ossimIrect RECT = tile->getImageRectangle();
+   vector<ossim_float64> minBands;
+   vector<ossim_float64> maxBands;
+   vector<ossim_float64> nulBands;
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   for (ossim_uint32 i = 0; i < iterations; ++i)
+   {
+      switch (op)
+      {
+      case LOAD_BIP:
+         tile->loadTile(&src.front(), RECT, OSSIM_BIP);
+         break;
+      case LOAD_BIL:
+         tile->loadTile(&src.front(), RECT, OSSIM_BIL);
+         break;
+      case LOAD_BSQ:
+         tile->loadTile(&src.front(), RECT, OSSIM_BSQ);
+         break;
+      case MIN_MAX:
+         minBands.clear();
+         maxBands.clear();
+         tile->computeMinMaxPix(minBands, maxBands);
+         break;
+      case MIN_MAX_NUL:
+         minBands.clear();
+         maxBands.clear();
+         nulBands.clear();
+         tile->computeMinMaxNulPix(minBands, maxBands, nulBands);
+         break;
+      case NORMALIZE:
+         tile->convertToNormalizedFloat(normTile);
+         break;
+      case UNNORMALIZE:
+         tile->unnormalizeInput(normTile);
+         break;
+      default:
+         break;
+      }
+   }
+   std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+   output.clear();
+   if (op == NORMALIZE)
+   {
+      appendBytes(output, normTile->getBuf(), normTile->getSizeInBytes());
+   }
+   else if ( (op == MIN_MAX) || (op == MIN_MAX_NUL) )
+   {
+      appendBytes(output, &minBands.front(), minBands.size() * sizeof(ossim_float64));
+      appendBytes(output, &maxBands.front(), maxBands.size() * sizeof(ossim_float64));
+      if (op == MIN_MAX_NUL)
+         appendBytes(output, &nulBands.front(), nulBands.size() * sizeof(ossim_float64));
+   }
+   else
+   {
+      appendBytes(output, tile->getBuf(), tile->getSizeInBytes());
+   }
+
+   return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ap.getApplicationUsage()->setApplicationName(ap.getApplicationName());
+   ap.getApplicationUsage()->setDescription(
+      "Times the ossimImageData load, min/max and normalize loops for each SIMD level.");
+   ap.getApplicationUsage()->setCommandLineUsage(
+      ap.getApplicationName() + " [options]");
+   ap.getApplicationUsage()->addCommandLineOption("--size <n>", "Tile width and height.");
+   ap.getApplicationUsage()->addCommandLineOption("--bands <n>", "Number of bands.");
+   ap.getApplicationUsage()->addCommandLineOption("--iterations <n>",
+                                                  "Times each operation is repeated.");
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   if (ap.read("-h") || ap.read("--help"))
+   {
+      ap.getApplicationUsage()->write(ossimNotify(ossimNotifyLevel_INFO));
+      return 0;
+   }
+
+   ossim_uint32 size = DEFAULT_SIZE;
+   ossim_uint32 bands = DEFAULT_BANDS;
+   ossim_uint32 iterations = DEFAULT_ITERATIONS;
+   std::string ts;
+   ossimArgumentParser::ossimParameter sp(ts);
+   if (ap.read("--size", sp))
+      size = (ossim_uint32) atoi(ts.c_str());
+   if (ap.read("--bands", sp))
+      bands = (ossim_uint32) atoi(ts.c_str());
+   if (ap.read("--iterations", sp))
+      iterations = (ossim_uint32) atoi(ts.c_str());
+   if (size == 0)
+      size = 1;
+   if (bands == 0)
+      bands = 1;
+   if (iterations == 0)
+      iterations = 1;
+
+   const ossim::SimdLevel SUPPORTED = ossim::getSupportedSimdLevel();
+   cout << "tile: " << size << "x" << size << "x" << bands << "  iterations: " << iterations
+        << "  supported: " << ossim::getSimdLevelName(SUPPORTED) << "\n\n"
+        << setw(10) << "scalar" << setw(26) << "operation" << setw(8) << "level"
+        << setw(14) << "none (s)" << setw(14) << "simd (s)" << setw(10) << "speedup"
+        << setw(8) << "match" << endl;
+
+   int mismatches = 0;
+   for (ossim_uint32 s = 0; s < sizeof(SCALARS) / sizeof(SCALARS[0]); ++s)
+   {
+      const ossimScalarType SCALAR = SCALARS[s];
+      ossimRefPtr<ossimImageData> tile = new ossimImageData(0, SCALAR, bands, size, size);
+      tile->initialize();
+      ossimRefPtr<ossimImageData> normTile =
+         new ossimImageData(0, OSSIM_NORMALIZED_FLOAT, bands, size, size);
+      normTile->initialize();
+
+      vector<ossim_uint8> src(tile->getSizeInBytes());
+      srand(1);
+      fillRandom(SCALAR, &src.front(), tile->getSize(), tile.get());
+
+      for (int op = 0; op < OPERATION_COUNT; ++op)
+      {
+         // Every operation starts from the same tile contents:
+         ossim::setSimdLevel(ossim::SIMD_NONE);
+         tile->loadTile(&src.front(), tile->getImageRectangle(), OSSIM_BSQ);
+         tile->validate();
+         tile->convertToNormalizedFloat(normTile.get());
+
+         vector<ossim_uint8> expected;
+         double scalarTime = runOperation((Operation)op, tile.get(), normTile.get(), src,
+                                          iterations, expected);
+
+         for (int level = ossim::SIMD_SSE42; level <= SUPPORTED; ++level)
+         {
+            ossim::setSimdLevel((ossim::SimdLevel)level);
+            tile->loadTile(&src.front(), tile->getImageRectangle(), OSSIM_BSQ);
+            tile->validate();
+            tile->convertToNormalizedFloat(normTile.get());
+
+            vector<ossim_uint8> actual;
+            double simdTime = runOperation((Operation)op, tile.get(), normTile.get(), src,
+                                           iterations, actual);
+            bool match = (actual == expected);
+            if (!match)
+               ++mismatches;
+
+            cout << setw(10) << ossimScalarTypeLut::instance()->getEntryString(SCALAR)
+                 << setw(26) << OPERATION_NAMES[op]
+                 << setw(8) << ossim::getSimdLevelName((ossim::SimdLevel)level)
+                 << fixed << setprecision(4) << setw(14) << scalarTime << setw(14) << simdTime
+                 << setprecision(2) << setw(10) << (simdTime > 0.0 ? scalarTime / simdTime : 0.0)
+                 << setw(8) << (match ? "yes" : "NO") << endl;
+         }
+      }
+   }
+
+   ossim::setSimdLevel(SUPPORTED);
+
+   if (mismatches)
+   {
+      cout << "\n" << mismatches << " SIMD result(s) differ from the scalar result!" << endl;
+      return 1;
+   }
+   return 0;
+}
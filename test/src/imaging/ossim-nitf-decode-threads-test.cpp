@@ -0,0 +1,262 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of the nitf block decode threads.  Writes a jpeg compressed (C3) and an uncompressed
+// blocked nitf whose right and bottom blocks run past the image, then reads tiles spanning
+// several blocks and the image edges with one and with four decode threads.  The tiles must be
+// the same, and those of the uncompressed image must hold the pixels written.  A derived tile
+// source overriding loadBlock must be read through its loadBlock with four threads set.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimTempFilename.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimJpegCodec.h>
+#include <ossim/imaging/ossimNitfTileSource.h>
+#include <ossim/support_data/ossimNitfFileHeaderV2_1.h>
+#include <ossim/support_data/ossimNitfImageBandV2_1.h>
+#include <ossim/support_data/ossimNitfImageHeaderV2_1.h>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 WIDTH = 500;
+static const ossim_uint32 HEIGHT = 300;
+static const ossim_uint32 BLOCK = 128; // 4 x 3 blocks, the last column and row partial.
+
+/** Tile source counting the blocks loaded through loadBlock. */
+class CountingNitfTileSource : public ossimNitfTileSource
+{
+public:
+   CountingNitfTileSource() : ossimNitfTileSource(), m_loadBlockCalls(0) {}
+   ossim_uint32 m_loadBlockCalls;
+
+protected:
+   virtual bool loadBlock(ossim_uint32 x, ossim_uint32 y)
+   {
+      ++m_loadBlockCalls;
+      return ossimNitfTileSource::loadBlock(x, y);
+   }
+};
+
+static ossim_uint32 failures = 0;
+
+static void expect(bool condition, const string& what)
+{
+   cout << what << ": " << ( condition ? "passed" : "FAILED" ) << endl;
+   if ( !condition )
+   {
+      ++failures;
+   }
+}
+
+static ossim_uint8 pixel(ossim_uint32 x, ossim_uint32 y)
+{
+   if ( ( x >= WIDTH ) || ( y >= HEIGHT ) )
+   {
+      return 0;
+   }
+   return (ossim_uint8)( x * 3 + y * 5 + ( x * y ) % 17 );
+}
+
+/** Writes a one band, eight bit, blocked nitf, jpeg compressed if jpeg is true. */
+static bool writeNitf(const ossimFilename& file, bool jpeg)
+{
+   const ossim_uint32 BLOCKS_H = ( WIDTH + BLOCK - 1 ) / BLOCK;
+   const ossim_uint32 BLOCKS_V = ( HEIGHT + BLOCK - 1 ) / BLOCK;
+
+   // Blocks in row order, padded with zeros past the image.
+   ossimJpegCodec codec;
+   vector<ossim_uint8> data;
+   for ( ossim_uint32 by = 0; by < BLOCKS_V; ++by )
+   {
+      for ( ossim_uint32 bx = 0; bx < BLOCKS_H; ++bx )
+      {
+         ossimRefPtr<ossimImageData> block =
+            new ossimImageData(0, OSSIM_UINT8, 1, BLOCK, BLOCK);
+         block->initialize();
+         ossim_uint8* buf = (ossim_uint8*)block->getBuf();
+         for ( ossim_uint32 y = 0; y < BLOCK; ++y )
+         {
+            for ( ossim_uint32 x = 0; x < BLOCK; ++x )
+            {
+               buf[y * BLOCK + x] = pixel(bx * BLOCK + x, by * BLOCK + y);
+            }
+         }
+         block->validate();
+         if ( jpeg )
+         {
+            vector<ossim_uint8> encoded;
+            if ( !codec.encode(block, encoded) )
+            {
+               return false;
+            }
+            data.insert(data.end(), encoded.begin(), encoded.end());
+         }
+         else
+         {
+            data.insert(data.end(), buf, buf + BLOCK * BLOCK);
+         }
+      }
+   }
+
+   ossimRefPtr<ossimNitfFileHeaderV2_1> fileHeader = new ossimNitfFileHeaderV2_1;
+   ossimRefPtr<ossimNitfImageHeaderV2_1> imageHeader = new ossimNitfImageHeaderV2_1;
+   fileHeader->setEncryption( ossimString("0") );
+   fileHeader->setDate();
+
+   ossimNitfImageInfoRecordV2_1 imageInfoRecord;
+   imageInfoRecord.setSubheaderLength(439);
+   imageInfoRecord.setImageLength(data.size());
+   fileHeader->addImageInfoRecord(imageInfoRecord);
+
+   ofstream out(file.c_str(), ios_base::out | ios_base::binary);
+   fileHeader->writeStream(out);
+   const ossim_uint64 HEADER_LENGTH = (ossim_uint64)out.tellp();
+
+   imageHeader->setJustification( ossimString("R") );
+   imageHeader->setActualBitsPerPixel(8);
+   imageHeader->setBitsPerPixel(8);
+   imageHeader->setPixelType("INT");
+   imageHeader->setNumberOfBands(1);
+   imageHeader->setImageMode('B');
+   imageHeader->setRepresentation("MONO");
+   imageHeader->setCategory("VIS");
+   imageHeader->setCompression( jpeg ? "C3" : "NC" );
+   imageHeader->setBlocksPerRow(BLOCKS_H);
+   imageHeader->setBlocksPerCol(BLOCKS_V);
+   imageHeader->setNumberOfPixelsPerBlockRow(BLOCK);
+   imageHeader->setNumberOfPixelsPerBlockCol(BLOCK);
+   imageHeader->setNumberOfRows(HEIGHT);
+   imageHeader->setNumberOfCols(WIDTH);
+   ossimNitfImageBandV2_1 bandInfo;
+   bandInfo.setBandRepresentation("M");
+   imageHeader->setBandInfo(0, bandInfo);
+
+   const ossim_uint64 IMAGE_HEADER_START = (ossim_uint64)out.tellp();
+   imageHeader->writeStream(out);
+   const ossim_uint64 IMAGE_HEADER_SIZE = (ossim_uint64)out.tellp() - IMAGE_HEADER_START;
+
+   out.write((const char*)&data.front(), data.size());
+
+   // Header again with the lengths.
+   fileHeader->setFileLength((ossim_uint64)out.tellp());
+   fileHeader->setHeaderLength(HEADER_LENGTH);
+   imageInfoRecord.setSubheaderLength(IMAGE_HEADER_SIZE);
+   fileHeader->replaceImageInfoRecord(0, imageInfoRecord);
+   out.seekp(0, ios_base::beg);
+   fileHeader->writeStream(out);
+
+   return out.good();
+}
+
+static bool open(ossimNitfTileSource* source, const ossimFilename& file, ossim_uint32 threads)
+{
+   source->setCacheEnabledFlag(false); // Every tile decodes its blocks.
+   source->setNumberOfDecodeThreads(threads);
+   source->setFilename(file);
+   return source->open();
+}
+
+/** @return true if the tiles have the same status and bytes. */
+static bool sameTile(const ossimRefPtr<ossimImageData>& a, const ossimRefPtr<ossimImageData>& b)
+{
+   return a.valid() && b.valid() &&
+          ( a->getImageRectangle() == b->getImageRectangle() ) &&
+          ( a->getDataObjectStatus() == b->getDataObjectStatus() ) &&
+          ( a->getSizeInBytes() == b->getSizeInBytes() ) &&
+          ( memcmp(a->getBuf(), b->getBuf(), a->getSizeInBytes()) == 0 );
+}
+
+/** @return true if the pixels of tile inside the image are the ones written. */
+static bool writtenPixels(const ossimRefPtr<ossimImageData>& tile)
+{
+   const ossimIrect RECT = tile->getImageRectangle();
+   for ( ossim_int32 y = RECT.ul().y; y <= RECT.lr().y; ++y )
+   {
+      for ( ossim_int32 x = RECT.ul().x; x <= RECT.lr().x; ++x )
+      {
+         if ( ( x < (ossim_int32)WIDTH ) && ( y < (ossim_int32)HEIGHT ) &&
+              ( tile->getPix(ossimIpt(x, y)) != pixel(x, y) ) )
+         {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+/** Compares the tiles of file read with one and four decode threads. */
+static void compare(const ossimFilename& file, const string& what, bool checkPixels)
+{
+   ossimRefPtr<ossimNitfTileSource> serial = new ossimNitfTileSource;
+   ossimRefPtr<ossimNitfTileSource> threaded = new ossimNitfTileSource;
+   if ( !open(serial.get(), file, 1) || !open(threaded.get(), file, 4) )
+   {
+      expect( false, what + ": open" );
+      return;
+   }
+
+   const ossimIrect RECTS[] =
+   {
+      ossimIrect(0, 0, WIDTH - 1, HEIGHT - 1),      // Whole image.
+      ossimIrect(100, 50, 419, 289),                // Inner and partial blocks.
+      ossimIrect(300, 200, WIDTH + 39, HEIGHT + 29), // Past the lower right corner.
+      ossimIrect(380, 0, 511, 255),                 // Partial column only.
+      ossimIrect(10, 10, 60, 60)                    // Inside one block.
+   };
+   for ( ossim_uint32 i = 0; i < sizeof(RECTS) / sizeof(RECTS[0]); ++i )
+   {
+      ossimRefPtr<ossimImageData> a = serial->getTile(RECTS[i]);
+      if ( a.valid() )
+      {
+         a = (ossimImageData*)a->dup(); // The tile is reused by the next getTile.
+      }
+      ossimRefPtr<ossimImageData> b = threaded->getTile(RECTS[i]);
+      ostringstream name;
+      name << what << ": rect " << RECTS[i] << " same with 1 and 4 threads";
+      expect( sameTile(a, b), name.str() );
+      if ( checkPixels && b.valid() )
+      {
+         expect( writtenPixels(b), what + ": pixels written" );
+      }
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   ossimTempFilename jpegFile(".", "decode", "ntf", true, false);
+   jpegFile.generateRandomFile();
+   ossimTempFilename rawFile(".", "decode", "ntf", true, false);
+   rawFile.generateRandomFile();
+
+   expect( writeNitf(jpegFile, true), "write C3 image" );
+   expect( writeNitf(rawFile, false), "write uncompressed image" );
+
+   compare(jpegFile, "C3", false);
+   compare(rawFile, "uncompressed", true);
+
+   // A derived class replacing loadBlock is not bypassed by the decode threads.
+   ossimRefPtr<CountingNitfTileSource> derived = new CountingNitfTileSource;
+   if ( open(derived.get(), jpegFile, 4) )
+   {
+      derived->getTile(ossimIrect(0, 0, WIDTH - 1, HEIGHT - 1));
+      expect( derived->m_loadBlockCalls == 12, "derived loadBlock called for every block" );
+   }
+   else
+   {
+      expect( false, "derived: open" );
+   }
+
+   cout << "failures: " << failures << endl;
+
+   return failures ? 1 : 0;
+}
@@ -0,0 +1,285 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of ossimImageData::populateHistogram: the counts of each integer type must match the ones
+// UpCount gives pixel by pixel, and per thread histograms added with addCounts must match one
+// histogram of all tiles.  ossimImageHistogramSource on 4 threads must give the serial histogram of
+// an in-memory image with partial last tiles.  Prints the time of each way per tile.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimHistogram.h>
+#include <ossim/base/ossimMultiBandHistogram.h>
+#include <ossim/base/ossimMultiResLevelHistogram.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageHistogramSource.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+/** @return Seconds since start. */
+static double elapsed(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/** Sets pixel i of band b of an 8 or 16 bit integer tile. */
+static void setPixel(ossimImageData* tile, ossim_uint32 b, ossim_uint32 i, ossim_int32 v)
+{
+   switch (tile->getScalarType())
+   {
+   case OSSIM_UINT8:
+      static_cast<ossim_uint8*>(tile->getBuf(b))[i] = (ossim_uint8)v;
+      break;
+   case OSSIM_SINT16:
+      static_cast<ossim_sint16*>(tile->getBuf(b))[i] = (ossim_sint16)v;
+      break;
+   default:
+      static_cast<ossim_uint16*>(tile->getBuf(b))[i] = (ossim_uint16)v;
+      break;
+   }
+}
+
+/** @return Tile of type with a pattern over [minVal, maxVal] and some null pixels. */
+static ossimRefPtr<ossimImageData> makeTile(ossimScalarType type,
+                                            ossim_uint32 width,
+                                            ossim_uint32 height,
+                                            ossim_int32 minVal,
+                                            ossim_int32 maxVal,
+                                            ossim_int32 nullVal,
+                                            ossim_uint32 seed)
+{
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, type, 2, width, height);
+   tile->initialize();
+   for (ossim_uint32 b = 0; b < 2; ++b)
+   {
+      tile->setNullPix(nullVal, b);
+      for (ossim_uint32 i = 0; i < width * height; ++i)
+      {
+         ossim_uint32 r = (i * 2654435761u + b * 40503u + seed * 977u) >> 7;
+         ossim_int32 v = minVal + (ossim_int32)(r % (ossim_uint32)(maxVal - minVal + 1));
+         if ((i + seed) % 53 == 0)
+         {
+            v = nullVal;
+         }
+         setPixel(tile.get(), b, i, v);
+      }
+   }
+   tile->validate();
+   return tile;
+}
+
+/** @return Histogram of tile made with UpCount on each non null pixel. */
+static ossimRefPtr<ossimMultiBandHistogram> upCountHistogram(const ossimImageData* tile,
+                                                             ossim_int32 bins,
+                                                             float minVal,
+                                                             float maxVal)
+{
+   ossimRefPtr<ossimMultiBandHistogram> histo =
+      new ossimMultiBandHistogram(tile->getNumberOfBands(), bins, minVal, maxVal);
+   const ossim_uint32 COUNT = tile->getWidth() * tile->getHeight();
+   for (ossim_uint32 b = 0; b < tile->getNumberOfBands(); ++b)
+   {
+      for (ossim_uint32 i = 0; i < COUNT; ++i)
+      {
+         ossim_float64 p = tile->getPix(i, b);
+         if (p != tile->getNullPix(b))
+         {
+            histo->getHistogram(b)->UpCount((float)p);
+         }
+      }
+   }
+   return histo;
+}
+
+/** @return Number of bins that differ. */
+static ossim_uint32 compare(const ossimMultiBandHistogram* expected,
+                            const ossimMultiBandHistogram* result,
+                            const char* what)
+{
+   ossim_uint32 differences = 0;
+   for (ossim_uint32 b = 0; b < expected->getNumberOfBands(); ++b)
+   {
+      const ossimRefPtr<ossimHistogram> e = expected->getHistogram(b);
+      const ossimRefPtr<ossimHistogram> r = result->getHistogram(b);
+      for (int i = 0; i < e->GetRes(); ++i)
+      {
+         if (e->GetCounts()[i] != r->GetCounts()[i])
+         {
+            if (differences < 5)
+            {
+               cerr << what << ": band " << b << " bin " << i << " expected "
+                    << e->GetCounts()[i] << " got " << r->GetCounts()[i] << endl;
+            }
+            ++differences;
+         }
+      }
+   }
+   return differences;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   struct Case
+   {
+      const char*     name;
+      ossimScalarType type;
+      ossim_uint32    size;
+      ossim_int32     minVal;   // Pixel range.
+      ossim_int32     maxVal;
+      ossim_int32     nullVal;
+      ossim_int32     bins;     // Histogram bins.
+      float           binMin;
+      float           binMax;
+   };
+   const Case CASES[] =
+   {
+      { "uint8 100 bins",          OSSIM_UINT8,    256, 1,      255,   0,      100,   0,      255   },
+      { "uint11 2048 bins",        OSSIM_USHORT11, 256, 1,      2047,  0,      2048,  0,      2047  },
+      { "uint16 65536 bins",       OSSIM_UINT16,   256, 100,    4000,  0,      65536, 0,      65535 },
+      { "uint16 1000 bins, clip",  OSSIM_UINT16,   256, 0,      9000,  65535,  1000,  500,    7000  },
+      { "uint16 wide range",       OSSIM_UINT16,   32,  1,      65535, 0,      65536, 0,      65535 },
+      { "sint16 65536 bins",       OSSIM_SINT16,   256, -5000,  5000,  -32768, 65536, -32768, 32767 },
+      { "sint16 300 bins",         OSSIM_SINT16,   256, -200,   900,   0,      300,   -100,   800   },
+      { 0,                         OSSIM_SCALAR_UNKNOWN, 0, 0, 0, 0, 0, 0, 0 }
+   };
+   const ossim_uint32 REPEAT = 20;
+
+   ossim_uint32 failures = 0;
+   for (ossim_uint32 c = 0; CASES[c].name; ++c)
+   {
+      const Case& C = CASES[c];
+      ossimRefPtr<ossimImageData> tile = makeTile(C.type, C.size, C.size, C.minVal, C.maxVal, C.nullVal, c);
+
+      ossimRefPtr<ossimMultiBandHistogram> expected;
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (ossim_uint32 i = 0; i < REPEAT; ++i)
+      {
+         expected = upCountHistogram(tile.get(), C.bins, C.binMin, C.binMax);
+      }
+      double upCountTime = elapsed(start);
+
+      ossimRefPtr<ossimMultiBandHistogram> result;
+      start = chrono::steady_clock::now();
+      for (ossim_uint32 i = 0; i < REPEAT; ++i)
+      {
+         result = new ossimMultiBandHistogram(2, C.bins, C.binMin, C.binMax);
+         tile->populateHistogram(result);
+      }
+      double populateTime = elapsed(start);
+
+      ossim_uint32 differences = compare(expected.get(), result.get(), C.name);
+
+      // Three tiles counted one at a time against the sum of three histograms:
+      ossimRefPtr<ossimMultiBandHistogram> all =
+         new ossimMultiBandHistogram(2, C.bins, C.binMin, C.binMax);
+      ossimRefPtr<ossimMultiBandHistogram> sum =
+         new ossimMultiBandHistogram(2, C.bins, C.binMin, C.binMax);
+      for (ossim_uint32 t = 0; t < 3; ++t)
+      {
+         ossimRefPtr<ossimImageData> part =
+            makeTile(C.type, C.size, C.size, C.minVal, C.maxVal, C.nullVal, c + 10 * t);
+         part->populateHistogram(all);
+         ossimRefPtr<ossimMultiBandHistogram> one =
+            new ossimMultiBandHistogram(2, C.bins, C.binMin, C.binMax);
+         part->populateHistogram(one);
+         if (!sum->addCounts(*one))
+         {
+            cerr << C.name << ": addCounts refused histogram with the same bins" << endl;
+            ++differences;
+         }
+      }
+      differences += compare(all.get(), sum.get(), C.name);
+
+      if (differences)
+      {
+         ++failures;
+      }
+
+      cout << C.name
+           << "\n   UpCount ms/tile:           " << 1.0e3 * upCountTime / REPEAT
+           << "\n   populateHistogram ms/tile: " << 1.0e3 * populateTime / REPEAT
+           << "\n   differences:               " << differences << endl;
+   }
+
+   //---
+   // Normal mode histogram of an in-memory image on 4 threads against the serial one.  The image
+   // size is not a multiple of any tile size, so the last tile of each row and column is partial.
+   //---
+   const ossimScalarType IMAGE_TYPES[] = { OSSIM_UINT8, OSSIM_UINT16, OSSIM_SINT16 };
+   for (ossim_uint32 t = 0; t < sizeof(IMAGE_TYPES) / sizeof(IMAGE_TYPES[0]); ++t)
+   {
+      ossimRefPtr<ossimImageData> image = (IMAGE_TYPES[t] == OSSIM_SINT16) ?
+         makeTile(IMAGE_TYPES[t], 1001, 533, -3000, 3000, -32768, t) :
+         makeTile(IMAGE_TYPES[t], 1001, 533, 1, 250, 0, t);
+      ossimRefPtr<ossimMemoryImageSource> memory = new ossimMemoryImageSource();
+      memory->setImage(image);
+      memory->initialize();
+
+      ossimRefPtr<ossimMultiBandHistogram> histos[2];
+      double times[2] = { 0.0, 0.0 };
+      const ossim_uint32 THREADS[2] = { 1, 4 };
+      for (ossim_uint32 i = 0; i < 2; ++i)
+      {
+         ossimRefPtr<ossimImageHistogramSource> source = new ossimImageHistogramSource();
+         source->connectMyInputTo(0, memory.get());
+         source->setMaxNumberOfRLevels(1);
+         source->setComputationMode(OSSIM_HISTO_MODE_NORMAL);
+         source->setNumberOfThreads(THREADS[i]);
+
+         chrono::steady_clock::time_point start = chrono::steady_clock::now();
+         ossimRefPtr<ossimMultiResLevelHistogram> histo =
+            source->getHistogram(image->getImageRectangle());
+         times[i] = elapsed(start);
+         if (histo.valid())
+         {
+            histos[i] = histo->getMultiBandHistogram(0);
+         }
+         source->disconnect();
+      }
+
+      ossim_uint32 differences = 0;
+      if (histos[0].valid() && histos[1].valid() && histos[0]->getHistogram(0).valid())
+      {
+         differences = compare(histos[0].get(), histos[1].get(), "threaded histogram source");
+
+         // The serial histogram itself must count every non null pixel.
+         ossimRefPtr<ossimMultiBandHistogram> expected = upCountHistogram(
+            image.get(), histos[0]->getHistogram(0)->GetRes(),
+            histos[0]->getHistogram(0)->GetRangeMin(), histos[0]->getHistogram(0)->GetRangeMax());
+         differences += compare(expected.get(), histos[0].get(), "serial histogram source");
+      }
+      else
+      {
+         cerr << "threaded histogram source: no histogram" << endl;
+         ++differences;
+      }
+      if (differences)
+      {
+         ++failures;
+      }
+
+      cout << "histogram source " << IMAGE_TYPES[t] << " 1001 x 533"
+           << "\n   1 thread ms:               " << 1.0e3 * times[0]
+           << "\n   4 threads ms:              " << 1.0e3 * times[1]
+           << "\n   differences:               " << differences << endl;
+   }
+
+   // Histograms with other bins must not be added:
+   ossimRefPtr<ossimMultiBandHistogram> a = new ossimMultiBandHistogram(1, 256, 0, 255);
+   ossimRefPtr<ossimMultiBandHistogram> b = new ossimMultiBandHistogram(1, 128, 0, 255);
+   if (a->addCounts(*b))
+   {
+      cerr << "addCounts added a histogram with other bins" << endl;
+      ++failures;
+   }
+
+   return failures ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Benchmark of ossimSharedTileCache. Forks worker processes that each read every tile of an image
+// through an ossimCacheTileSource, as ossim-tool-server children serving the same image would.
+// The workers are run once with a private cache each and once sharing the cache, and the wall
+// time of both runs and the shared hit rate are reported.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimApplicationUsage.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/imaging/ossimCacheTileSource.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageHandler.h>
+#include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/imaging/ossimSharedTileCache.h>
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const ossim_uint32 DEFAULT_WORKERS = 4;
+static const ossim_uint32 DEFAULT_CACHE_MB = 256;
+
+/** Reads every tile of file through a cache. @return Process exit code. */
+static int readImage(const ossimFilename& file)
+{
+   ossimRefPtr<ossimImageHandler> h = ossimImageHandlerRegistry::instance()->open(file);
+   if (!h.valid())
+      return 1;
+
+   ossimRefPtr<ossimCacheTileSource> cache = new ossimCacheTileSource();
+   cache->connectMyInputTo(0, h.get());
+   cache->initialize();
+
+   const ossimIrect bounds = cache->getBoundingRect(0);
+   const ossim_int32 TW = (ossim_int32)cache->getTileWidth();
+   const ossim_int32 TH = (ossim_int32)cache->getTileHeight();
+   for (ossim_int32 y = bounds.ul().y; y <= bounds.lr().y; y += TH)
+   {
+      for (ossim_int32 x = bounds.ul().x; x <= bounds.lr().x; x += TW)
+      {
+         if (!cache->getTile(ossimIrect(x, y, x + TW - 1, y + TH - 1), 0).valid())
+            return 1;
+      }
+   }
+   return 0;
+}
+
+/** Forks workers reading file and waits for them. @return Wall seconds or -1 on error. */
+static double runWorkers(const ossimFilename& file, ossim_uint32 workers)
+{
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (ossim_uint32 i = 0; i < workers; ++i)
+   {
+      pid_t pid = fork();
+      if (pid == 0)
+         _exit(readImage(file));
+      if (pid < 0)
+         return -1.0;
+   }
+
+   bool ok = true;
+   int status = 0;
+   while (wait(&status) > 0)
+   {
+      if (!WIFEXITED(status) || WEXITSTATUS(status))
+         ok = false;
+   }
+   return ok ? chrono::duration<double>(chrono::steady_clock::now() - start).count() : -1.0;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ap.getApplicationUsage()->setApplicationName(ap.getApplicationName());
+   ap.getApplicationUsage()->setCommandLineUsage(ap.getApplicationName() + " [options] <image>");
+   ap.getApplicationUsage()->addCommandLineOption("-h or --help", "Display this information");
+   ap.getApplicationUsage()->addCommandLineOption("--workers <n>",
+                                                  "Worker processes. Default: 4");
+   ap.getApplicationUsage()->addCommandLineOption("--size <mb>",
+                                                  "Shared cache size in MB. Default: 256");
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   // Options are read first so they are not counted as arguments.
+   ossim_uint32 workers = DEFAULT_WORKERS;
+   ossim_uint32 sizeMb = DEFAULT_CACHE_MB;
+   std::string ts;
+   ossimArgumentParser::ossimParameter sp(ts);
+   if (ap.read("--workers", sp))
+      workers = (ossim_uint32) atoi(ts.c_str());
+   if (ap.read("--size", sp))
+      sizeMb = (ossim_uint32) atoi(ts.c_str());
+   if (workers == 0)
+      workers = 1;
+
+   if (ap.read("-h") || ap.read("--help") || (ap.argc() != 2))
+   {
+      ap.getApplicationUsage()->write(ossimNotify(ossimNotifyLevel_INFO));
+      return 0;
+   }
+
+   ossimFilename file = ap[1];
+
+   // Private: the cache is not open when the workers fork.
+   ossimSharedTileCache::instance()->close();
+   double privateTime = runWorkers(file, workers);
+
+   // Shared: mapped before the fork so every worker sees it.
+   if (!ossimSharedTileCache::instance()->open((ossim_uint64)sizeMb * 1024 * 1024, 512 * 1024))
+   {
+      cerr << "Could not open a " << sizeMb << " MB shared tile cache." << endl;
+      return 1;
+   }
+   double sharedTime = runWorkers(file, workers);
+
+   if ((privateTime < 0.0) || (sharedTime < 0.0))
+   {
+      cerr << "A worker failed to read " << file << endl;
+      return 1;
+   }
+
+   cout << "image:        " << file << "\nworkers:      " << workers
+        << fixed << setprecision(3)
+        << "\nprivate (s):  " << privateTime << "\nshared (s):   " << sharedTime
+        << setprecision(2) << "\nspeedup:      " << (sharedTime > 0.0 ? privateTime / sharedTime : 0.0)
+        << "\n\n";
+   ossimSharedTileCache::instance()->print(cout);
+   return 0;
+}
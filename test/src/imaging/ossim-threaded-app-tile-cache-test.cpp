@@ -62,6 +62,14 @@ public:
             }
          }
       }
+
+      ossimFixedTileCache::Statistics stats;
+      if(ossimAppFixedTileCache::instance()->getStatistics(m_cacheId, stats))
+      {
+         std::cout << "THREAD " << m_threadName << " cache " << m_cacheId
+                   << ": hits = " << stats.theHits << ", misses = " << stats.theMisses
+                   << ", evictions = " << stats.theEvictions << std::endl;
+      }
       
       ossimAppFixedTileCache::instance()->deleteCache(m_cacheId);
       // let all threads end at the same time
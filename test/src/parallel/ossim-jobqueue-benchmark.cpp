@@ -0,0 +1,132 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Micro-benchmark comparing the shared-list ossimJobQueue against ossimJobStealingQueue when
+// driven by ossimJobMultiThreadQueue. Jobs are tiny so that queue overhead dominates.
+//
+//**************************************************************************************************
+#include <ossim/parallel/ossimJob.h>
+#include <ossim/parallel/ossimJobQueue.h>
+#include <ossim/parallel/ossimJobStealingQueue.h>
+#include <ossim/parallel/ossimJobMultiThreadQueue.h>
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimApplicationUsage.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/Block.h>
+#include <ossim/init/ossimInit.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+
+static const ossim_uint32 THREAD_COUNTS[] = { 1, 8, 32, 64 };
+static const ossim_uint32 DEFAULT_JOBS = 200000;
+static const ossim_uint32 DEFAULT_WORK = 200;
+
+class BenchmarkJob : public ossimJob
+{
+public:
+   BenchmarkJob(std::atomic<ossim_uint32>& remaining, ossim::Block& done, ossim_uint32 work)
+   :  m_remaining(remaining), m_done(done), m_work(work) {}
+
+protected:
+   virtual void run()
+   {
+      // A few hundred flops, roughly what a trivially small tile job costs outside of I/O:
+      volatile double acc = 0.0;
+      for (ossim_uint32 i = 0; i < m_work; ++i)
+         acc = acc + i * 0.5;
+
+      if (--m_remaining == 0)
+         m_done.release();
+   }
+
+private:
+   std::atomic<ossim_uint32>& m_remaining;
+   ossim::Block&              m_done;
+   ossim_uint32               m_work;
+};
+
+static double runBenchmark(bool stealing, ossim_uint32 nThreads, ossim_uint32 nJobs,
+                           ossim_uint32 work)
+{
+   std::atomic<ossim_uint32> remaining(nJobs);
+   ossim::Block done;
+
+   std::shared_ptr<ossimJobQueue> jobQueue;
+   if (stealing)
+      jobQueue = std::make_shared<ossimJobStealingQueue>(nThreads);
+   else
+      jobQueue = std::make_shared<ossimJobQueue>();
+   std::shared_ptr<ossimJobMultiThreadQueue> jobMtQueue =
+      std::make_shared<ossimJobMultiThreadQueue>(jobQueue, nThreads);
+
+   // Jobs are created up front so only queue traffic is timed:
+   ossimJob::List jobs;
+   for (ossim_uint32 i = 0; i < nJobs; ++i)
+      jobs.push_back(std::make_shared<BenchmarkJob>(remaining, done, work));
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   for (ossimJob::List::iterator iter = jobs.begin(); iter != jobs.end(); ++iter)
+      jobQueue->add(*iter);
+   done.block();
+   std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+
+   jobMtQueue->cancel();
+   jobMtQueue->waitForCompletion();
+
+   return std::chrono::duration<double>(stop - start).count();
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ap.getApplicationUsage()->setApplicationName(ap.getApplicationName());
+   ap.getApplicationUsage()->setDescription(
+      "Times ossimJobQueue against ossimJobStealingQueue at 1, 8, 32 and 64 threads.");
+   ap.getApplicationUsage()->setCommandLineUsage(
+      ap.getApplicationName() + " [options]");
+   ap.getApplicationUsage()->addCommandLineOption("--jobs <n>", "Number of jobs per run.");
+   ap.getApplicationUsage()->addCommandLineOption("--work <n>",
+                                                  "Loop iterations performed by each job.");
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   if (ap.read("-h") || ap.read("--help"))
+   {
+      ap.getApplicationUsage()->write(ossimNotify(ossimNotifyLevel_INFO));
+      return 0;
+   }
+
+   ossim_uint32 nJobs = DEFAULT_JOBS;
+   ossim_uint32 work = DEFAULT_WORK;
+   std::string ts;
+   ossimArgumentParser::ossimParameter sp(ts);
+   if (ap.read("--jobs", sp))
+      nJobs = (ossim_uint32) atoi(ts.c_str());
+   if (ap.read("--work", sp))
+      work = (ossim_uint32) atoi(ts.c_str());
+   if (nJobs == 0)
+      nJobs = 1;
+
+   cout << "jobs: " << nJobs << "  work/job: " << work << "\n\n"
+        << setw(8) << "threads" << setw(16) << "shared (s)" << setw(16) << "stealing (s)"
+        << setw(12) << "speedup" << endl;
+
+   for (ossim_uint32 i = 0; i < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); ++i)
+   {
+      ossim_uint32 nThreads = THREAD_COUNTS[i];
+      double shared = runBenchmark(false, nThreads, nJobs, work);
+      double stealing = runBenchmark(true, nThreads, nJobs, work);
+      cout << setw(8) << nThreads << fixed << setprecision(4) << setw(16) << shared
+           << setw(16) << stealing << setprecision(2) << setw(12)
+           << (stealing > 0.0 ? shared / stealing : 0.0) << endl;
+   }
+
+   return 0;
+}
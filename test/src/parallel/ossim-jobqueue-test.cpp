@@ -63,16 +63,8 @@ int main(int argc, char *argv[])
       q->add(job);
    }
    
-   // FOREVER loop until all jobs are completed.
-   while(true)
-   {
-      ossim::Thread::sleepInMicroSeconds(250);
-      if ( threadQueue->hasJobsToProcess() == false )
-      {
-         break;
-      }
-      ossim::Thread::yieldCurrentThread();
-   }
+   // Block until all jobs are completed.
+   threadQueue->waitAll();
    
    return 0;
 }
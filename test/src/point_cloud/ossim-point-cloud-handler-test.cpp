@@ -64,7 +64,6 @@ int main(int argc, char* argv[])
       ossim_uint32 size_read = points.size();
       if (points.empty() )
          break;
-      ossimPointRecord* p = points[0];
 
       // Sum intensity channel as "checksum" value:
       double checksum = 0;
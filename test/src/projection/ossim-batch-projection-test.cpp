@@ -0,0 +1,214 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Compares the batch projection methods (worldToLineSamplePoints, lineSampleToWorldPoints) with
+// the single point methods for an RPC model and an equidistant cylindrical projection, and times
+// both.
+//
+//**************************************************************************************************
+#include <ossim/projection/ossimRpcModel.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimApplicationUsage.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+using namespace std;
+
+static const ossim_uint32 DEFAULT_POINTS = 1000000;
+
+// Largest difference allowed between batch and single point results:
+static const double MAX_PIXEL_DIFF  = 1.0e-6;
+static const double MAX_DEGREE_DIFF = 1.0e-9;
+
+static double random(double minValue, double maxValue)
+{
+   return minValue + (maxValue - minValue) * (rand() / (double)RAND_MAX);
+}
+
+/** Synthetic but well conditioned RPC: denominators stay close to one. */
+static ossimRefPtr<ossimRpcModel> createRpcModel(ossimRpcModel::PolynomialType polyType)
+{
+   vector<double> lineNum(20), lineDen(20), sampNum(20), sampDen(20);
+   for (ossim_uint32 i = 0; i < 20; ++i)
+   {
+      lineNum[i] = random(-0.01, 0.01);
+      sampNum[i] = random(-0.01, 0.01);
+      lineDen[i] = random(-0.001, 0.001);
+      sampDen[i] = random(-0.001, 0.001);
+   }
+   lineNum[2] = -1.0; // line mostly follows -latitude
+   sampNum[1] =  1.0; // sample mostly follows longitude
+   lineDen[0] =  1.0;
+   sampDen[0] =  1.0;
+
+   ossimRefPtr<ossimRpcModel> model = new ossimRpcModel();
+   model->setAttributes(5000.0, 5000.0, 5000.0, 5000.0,   // samp/line offset and scale
+                        38.5, -77.5, 100.0,               // lat, lon, height offsets
+                        0.05, 0.05, 500.0,                // lat, lon, height scales
+                        sampNum, sampDen, lineNum, lineDen, polyType, false);
+   return model;
+}
+
+static double elapsed(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static double maxDiff(const vector<ossimDpt>& a, const vector<ossimDpt>& b)
+{
+   double result = 0.0;
+   for (ossim_uint32 i = 0; i < a.size(); ++i)
+   {
+      if (a[i].hasNans() != b[i].hasNans())
+         return ossim::nan();
+      if (!a[i].hasNans())
+         result = max(result, max(fabs(a[i].x - b[i].x), fabs(a[i].y - b[i].y)));
+   }
+   return result;
+}
+
+static double maxDiff(const vector<ossimGpt>& a, const vector<ossimGpt>& b)
+{
+   double result = 0.0;
+   for (ossim_uint32 i = 0; i < a.size(); ++i)
+   {
+      if (a[i].hasNans() != b[i].hasNans())
+         return ossim::nan();
+      if (!a[i].hasNans())
+         result = max(result, max(fabs(a[i].lat - b[i].lat), fabs(a[i].lon - b[i].lon)));
+   }
+   return result;
+}
+
+static bool report(const char* name, double singleTime, double batchTime, double diff,
+                   double maxAllowed)
+{
+   bool match = (diff <= maxAllowed); // false for NaN
+   cout << setw(34) << name << fixed << setprecision(4) << setw(12) << singleTime
+        << setw(12) << batchTime << setprecision(2) << setw(10)
+        << (batchTime > 0.0 ? singleTime / batchTime : 0.0)
+        << scientific << setprecision(2) << setw(12) << diff
+        << setw(8) << (match ? "yes" : "NO") << endl;
+   return match;
+}
+
+static bool testWorldToLineSample(const char* name, const ossimProjection* proj,
+                                  const vector<ossimGpt>& gpts)
+{
+   vector<ossimDpt> single(gpts.size());
+   vector<ossimDpt> batch(gpts.size());
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (ossim_uint32 i = 0; i < gpts.size(); ++i)
+      proj->worldToLineSample(gpts[i], single[i]);
+   double singleTime = elapsed(start);
+
+   start = chrono::steady_clock::now();
+   proj->worldToLineSamplePoints(&gpts.front(), (ossim_uint32)gpts.size(), &batch.front());
+   double batchTime = elapsed(start);
+
+   return report(name, singleTime, batchTime, maxDiff(single, batch), MAX_PIXEL_DIFF);
+}
+
+static bool testLineSampleToWorld(const char* name, const ossimProjection* proj,
+                                  const vector<ossimDpt>& ipts)
+{
+   vector<ossimGpt> single(ipts.size());
+   vector<ossimGpt> batch(ipts.size());
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (ossim_uint32 i = 0; i < ipts.size(); ++i)
+      proj->lineSampleToWorld(ipts[i], single[i]);
+   double singleTime = elapsed(start);
+
+   start = chrono::steady_clock::now();
+   proj->lineSampleToWorldPoints(&ipts.front(), (ossim_uint32)ipts.size(), &batch.front());
+   double batchTime = elapsed(start);
+
+   return report(name, singleTime, batchTime, maxDiff(single, batch), MAX_DEGREE_DIFF);
+}
+
+int main(int argc, char *argv[])
+{
+   ossimArgumentParser ap(&argc, argv);
+   ap.getApplicationUsage()->setApplicationName(ap.getApplicationName());
+   ap.getApplicationUsage()->setDescription(
+      "Checks the batch projection methods against the single point methods and times both.");
+   ap.getApplicationUsage()->setCommandLineUsage(
+      ap.getApplicationName() + " [options]");
+   ap.getApplicationUsage()->addCommandLineOption("--points <n>", "Number of points.");
+   ossimInit::instance()->addOptions(ap);
+   ossimInit::instance()->initialize(ap);
+
+   if (ap.read("-h") || ap.read("--help"))
+   {
+      ap.getApplicationUsage()->write(ossimNotify(ossimNotifyLevel_INFO));
+      return 0;
+   }
+
+   ossim_uint32 points = DEFAULT_POINTS;
+   std::string ts;
+   ossimArgumentParser::ossimParameter sp(ts);
+   if (ap.read("--points", sp))
+      points = (ossim_uint32) atoi(ts.c_str());
+   if (points == 0)
+      points = 1;
+
+   srand(1);
+
+   // Ground points around the RPC footprint; every 13th without height, one with no latitude.
+   vector<ossimGpt> gpts(points);
+   for (ossim_uint32 i = 0; i < points; ++i)
+   {
+      gpts[i] = ossimGpt(random(38.45, 38.55), random(-77.55, -77.45), random(-400.0, 600.0));
+      if (i % 13 == 0)
+         gpts[i].hgt = ossim::nan();
+   }
+   gpts[points / 2].lat = ossim::nan();
+
+   // Image points over a 10000 x 10000 image:
+   vector<ossimDpt> ipts(points);
+   for (ossim_uint32 i = 0; i < points; ++i)
+      ipts[i] = ossimDpt(random(0.0, 10000.0), random(0.0, 10000.0));
+   ipts[points / 2].makeNan();
+
+   cout << "points: " << points << "\n\n"
+        << setw(34) << "method" << setw(12) << "single (s)" << setw(12) << "batch (s)"
+        << setw(10) << "speedup" << setw(12) << "max diff" << setw(8) << "match" << endl;
+
+   int mismatches = 0;
+
+   ossimRefPtr<ossimRpcModel> rpcA = createRpcModel(ossimRpcModel::A);
+   ossimRefPtr<ossimRpcModel> rpcB = createRpcModel(ossimRpcModel::B);
+   if (!testWorldToLineSample("ossimRpcModel(A) worldToLineSample", rpcA.get(), gpts))
+      ++mismatches;
+   if (!testWorldToLineSample("ossimRpcModel(B) worldToLineSample", rpcB.get(), gpts))
+      ++mismatches;
+
+   ossimRefPtr<ossimEquDistCylProjection> eqProj = new ossimEquDistCylProjection();
+   eqProj->setUlTiePoints(ossimGpt(38.55, -77.55));
+   eqProj->setDecimalDegreesPerPixel(ossimDpt(0.00001, 0.00001));
+   if (!testWorldToLineSample("ossimEquDistCyl worldToLineSample", eqProj.get(), gpts))
+      ++mismatches;
+   if (!testLineSampleToWorld("ossimEquDistCyl lineSampleToWorld", eqProj.get(), ipts))
+      ++mismatches;
+
+   if (mismatches)
+   {
+      cout << "\n" << mismatches << " batch result(s) differ from the single point result!"
+           << endl;
+      return 1;
+   }
+   return 0;
+}
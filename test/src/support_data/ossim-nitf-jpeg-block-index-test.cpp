@@ -0,0 +1,258 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of ossimNitfJpegBlockIndex on synthetic jpeg blocks.  Each block has an APP1 segment
+// holding a nested start of image, and the second block starts on the last byte of the first
+// scan chunk.  Checks scan() with one and several threads, the write()/read() round trip, read()
+// rejecting a stale index and buildFromBlockMask() with a masked block.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimDate.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/base/ossimTempFilename.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/support_data/ossimNitfImageHeaderV2_1.h>
+#include <ossim/support_data/ossimNitfJpegBlockIndex.h>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Same as SCAN_CHUNK_SIZE in ossimNitfJpegBlockIndex.cpp.
+static const std::streamoff SCAN_CHUNK_SIZE = 8 * 1024 * 1024;
+
+// Offset of the first block, after a stand in for the nitf headers.
+static const std::streamoff START = 1000;
+
+/** Image header with a block mask set by the test. */
+class TestImageHeader : public ossimNitfImageHeaderV2_1
+{
+public:
+   TestImageHeader(ossim_uint64 dataLocation,
+                   ossim_int32 blocksPerRow,
+                   ossim_int32 blocksPerCol,
+                   const vector<ossim_uint32>& maskOffsets)
+      :
+      ossimNitfImageHeaderV2_1(),
+      m_dataLocation(dataLocation),
+      m_blocksPerRow(blocksPerRow),
+      m_blocksPerCol(blocksPerCol),
+      m_maskOffsets(maskOffsets)
+   {
+   }
+   virtual ossim_uint64 getDataLocation() const { return m_dataLocation; }
+   virtual ossim_int32 getNumberOfBlocksPerRow() const { return m_blocksPerRow; }
+   virtual ossim_int32 getNumberOfBlocksPerCol() const { return m_blocksPerCol; }
+   virtual bool hasBlockMaskRecords() const { return true; }
+   virtual ossim_uint32 getBlockMaskRecordOffset(ossim_uint32 blockNumber,
+                                                 ossim_uint32 /* bandNumber */) const
+   {
+      return m_maskOffsets[blockNumber];
+   }
+
+private:
+   ossim_uint64           m_dataLocation;
+   ossim_int32            m_blocksPerRow;
+   ossim_int32            m_blocksPerCol;
+   vector<ossim_uint32>   m_maskOffsets;
+};
+
+/**
+ * Appends a jpeg block of exactly size bytes to out: start of image, an APP1 segment holding
+ * FF D8 FF and the headers of a nested image, DQT, start of scan, entropy coded data with
+ * stuffed bytes and restart markers, end of image.
+ */
+static void appendBlock(vector<ossim_uint8>& out, size_t size, ossim_uint32 seed)
+{
+   const ossim_uint8 HEADERS[] =
+   {
+      0xff, 0xd8,                                     // SOI
+      0xff, 0xe1, 0x00, 0x1a,                         // APP1, length 26
+      'E', 'x', 'i', 'f', 0x00, 0x00,
+      0xff, 0xd8, 0xff, 0xdb, 0x00, 0x04, 0x01, 0x02, // Nested SOI and DQT.
+      0xff, 0xda, 0x00, 0x04, 0x01, 0x01,             // Nested SOS.
+      0xff, 0xd9, 0x00, 0x00,
+      0xff, 0xdb, 0x00, 0x06, 0x00, 0x10, 0xff, 0xd9, // DQT holding FF D9.
+      0xff, 0xda, 0x00, 0x0c,                         // SOS, length 12
+      0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00
+   };
+   const size_t HEADER_SIZE = sizeof(HEADERS);
+   out.insert(out.end(), HEADERS, HEADERS + HEADER_SIZE);
+
+   // Entropy coded data: 0xff is followed by a stuffed zero or a restart marker.
+   size_t remaining = size - HEADER_SIZE - 2;
+   ossim_uint32 r = seed * 2654435761u + 1;
+   ossim_uint32 restart = 0;
+   while ( remaining )
+   {
+      r = r * 1664525u + 1013904223u;
+      ossim_uint8 c = (ossim_uint8)(r >> 24);
+      if ( ( c == 0xff ) && ( remaining >= 2 ) )
+      {
+         out.push_back(0xff);
+         out.push_back( ( r & 0x100 ) ? 0x00 : (ossim_uint8)(0xd0 + ( restart++ % 8 )) );
+         remaining -= 2;
+      }
+      else
+      {
+         out.push_back( c == 0xff ? 0x12 : c );
+         --remaining;
+      }
+   }
+
+   out.push_back(0xff); // EOI
+   out.push_back(0xd9);
+}
+
+/** Writes data to file. */
+static bool writeFile(const ossimFilename& file, const vector<ossim_uint8>& data)
+{
+   ofstream out(file.c_str(), ios_base::out | ios_base::binary);
+   out.write((const char*)&data.front(), data.size());
+   return out.good();
+}
+
+/** @return true if the offsets and sizes of index match. */
+static bool check(const string& what,
+                  ossimNitfJpegBlockIndex& index,
+                  const vector<std::streamoff>& expectedOffsets,
+                  const vector<ossim_uint32>& expectedSizes)
+{
+   vector<std::streamoff> offsets;
+   vector<ossim_uint32> sizes;
+   index.release(offsets, sizes);
+   bool result = ( offsets == expectedOffsets ) && ( sizes == expectedSizes );
+   if ( !result )
+   {
+      cerr << what << ": offsets or sizes differ\n";
+      for ( size_t i = 0; i < offsets.size(); ++i )
+      {
+         cerr << "block " << i << " offset " << offsets[i] << " size "
+              << ( i < sizes.size() ? sizes[i] : 0 ) << "\n";
+      }
+      cerr << flush;
+   }
+   return result;
+}
+
+static ossim_uint32 failures = 0;
+
+static void expect(bool condition, const string& what)
+{
+   cout << what << ": " << ( condition ? "passed" : "FAILED" ) << endl;
+   if ( !condition )
+   {
+      ++failures;
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   //---
+   // C3 image: the first block fills the first scan chunk but its last byte, so the next start
+   // of image straddles the chunk boundary and its block spans both chunks.
+   //---
+   vector<size_t> blockSizes;
+   blockSizes.push_back( (size_t)SCAN_CHUNK_SIZE - 1 );
+   blockSizes.push_back( 300000 );
+   for ( ossim_uint32 i = 0; i < 4; ++i )
+   {
+      blockSizes.push_back( 5000 + i * 77 );
+   }
+
+   vector<ossim_uint8> data( (size_t)START, 0x20 );
+   data[10] = 0xff; // A start of image before START is not a block.
+   data[11] = 0xd8;
+   data[12] = 0xff;
+   vector<std::streamoff> offsets;
+   vector<ossim_uint32> sizes;
+   for ( ossim_uint32 i = 0; i < blockSizes.size(); ++i )
+   {
+      offsets.push_back( (std::streamoff)data.size() );
+      sizes.push_back( (ossim_uint32)blockSizes[i] );
+      appendBlock(data, blockSizes[i], i);
+   }
+   data.insert(data.end(), 512, 0x20); // Trailing segment data.
+   const ossim_uint32 BLOCKS = (ossim_uint32)blockSizes.size();
+
+   ossimTempFilename imageFile(".", "jbi", "ntf", true, false);
+   imageFile.generateRandomFile();
+   ossimTempFilename indexFile(".", "jbi", "idx", true, false);
+   indexFile.generateRandomFile();
+   if ( !writeFile(imageFile, data) )
+   {
+      cerr << "Could not write " << imageFile << endl;
+      return 1;
+   }
+
+   ossimNitfJpegBlockIndex index;
+   expect( index.scan(imageFile.string(), START, BLOCKS, 1) &&
+           check("scan 1 thread", index, offsets, sizes ), "scan 1 thread" );
+   expect( index.scan(imageFile.string(), START, BLOCKS, 4) &&
+           check("scan 4 threads", index, offsets, sizes ), "scan 4 threads" );
+   expect( !index.scan(imageFile.string(), START, BLOCKS + 1, 4) &&
+           ( index.getNumberOfBlocks() == 0 ), "scan for a missing block fails" );
+
+   // Round trip.
+   index.scan(imageFile.string(), START, BLOCKS, 4);
+   expect( index.write(indexFile, imageFile), "write" );
+   expect( index.read(indexFile, imageFile, START, BLOCKS) &&
+           check("read", index, offsets, sizes), "read" );
+
+   // Stale or mismatched index.
+   expect( !index.read(indexFile, imageFile, START + 1, BLOCKS), "read rejects start" );
+   expect( !index.read(indexFile, imageFile, START, BLOCKS - 1), "read rejects block count" );
+
+   ossimLocalTm modTime;
+   imageFile.getTimes(0, &modTime, 0);
+   ossimLocalTm newModTime( (time_t)modTime - 10 );
+   imageFile.setTimes(&newModTime, &newModTime, 0);
+   expect( !index.read(indexFile, imageFile, START, BLOCKS), "read rejects modification time" );
+
+   data.push_back(0x20);
+   writeFile(imageFile, data);
+   imageFile.setTimes(&modTime, &modTime, 0);
+   expect( !index.read(indexFile, imageFile, START, BLOCKS), "read rejects size" );
+
+   //---
+   // M3 image, 3 x 2 blocks with block 2 masked: present blocks are stored in order and the
+   // last one is only found by reading to its end of image.
+   //---
+   data.assign( (size_t)START, 0x20 );
+   offsets.clear();
+   sizes.clear();
+   vector<ossim_uint32> maskOffsets;
+   for ( ossim_uint32 i = 0; i < 6; ++i )
+   {
+      if ( i == 2 )
+      {
+         maskOffsets.push_back( 0xffffffff );
+         offsets.push_back( 0 );
+         sizes.push_back( 0 );
+      }
+      else
+      {
+         const size_t SIZE = 4000 + i * 131;
+         maskOffsets.push_back( (ossim_uint32)( data.size() - START ) );
+         offsets.push_back( (std::streamoff)data.size() );
+         sizes.push_back( (ossim_uint32)SIZE );
+         appendBlock(data, SIZE, i + 100);
+      }
+   }
+   data.insert(data.end(), 512, 0x20);
+   writeFile(imageFile, data);
+
+   ossimRefPtr<TestImageHeader> hdr = new TestImageHeader(START, 3, 2, maskOffsets);
+   ifstream in(imageFile.c_str(), ios_base::in | ios_base::binary);
+   expect( index.buildFromBlockMask(in, *hdr) &&
+           check("block mask", index, offsets, sizes), "buildFromBlockMask" );
+
+   cout << "failures: " << failures << endl;
+
+   return failures ? 1 : 0;
+}
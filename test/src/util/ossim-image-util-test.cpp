@@ -0,0 +1,215 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of ossimImageUtil::processFile.  Two copies of an image are given overviews.  One is then
+// processed with --compute-min-max and --ch in one run, where the min/max scan also populates the
+// histogram, the other with --compute-min-max and then --ch in two runs, the separate passes of
+// before.  The dot his and dot omd files of both must be the same.  Then several images are
+// processed on four threads with a memory budget smaller than two images' estimates; the run
+// must finish and give every image its overviews.
+//
+//**************************************************************************************************
+#include <ossim/base/ossimArgumentParser.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimTempFilename.h>
+#include <ossim/init/ossimInit.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/util/ossimImageUtil.h>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static ossim_uint32 failures = 0;
+
+static void expect(bool condition, const string& what)
+{
+   cout << what << ": " << ( condition ? "passed" : "FAILED" ) << endl;
+   if ( !condition )
+   {
+      ++failures;
+   }
+}
+
+/** Writes a three band, eight bit tiff of width x height with some null pixels. */
+static bool writeImage(const ossimFilename& file, ossim_uint32 width, ossim_uint32 height)
+{
+   ossimRefPtr<ossimImageData> image =
+      new ossimImageData(0, OSSIM_UINT8, 3, width, height);
+   image->initialize();
+   for ( ossim_uint32 band = 0; band < 3; ++band )
+   {
+      ossim_uint8* buf = (ossim_uint8*)image->getBuf(band);
+      for ( ossim_uint32 y = 0; y < height; ++y )
+      {
+         for ( ossim_uint32 x = 0; x < width; ++x )
+         {
+            // Zero (null) in the upper left corner, else 10 to 209 by band.
+            buf[y * width + x] = ( ( x < 16 ) && ( y < 16 ) ) ? 0 :
+               (ossim_uint8)( 10 + ( x * ( band + 1 ) + y * 3 ) % 200 );
+         }
+      }
+   }
+   image->validate();
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource;
+   source->setImage(image);
+   ossimRefPtr<ossimTiffWriter> writer = new ossimTiffWriter;
+   writer->setFilename(file);
+   writer->connectMyInputTo(0, source.get());
+   writer->setAreaOfInterest(image->getImageRectangle());
+   writer->setGeotiffFlag(false);
+   bool result = writer->execute();
+   writer->close();
+   writer->disconnect();
+   return result;
+}
+
+/** Runs ossimImageUtil with the options on the files, as ossim-preproc would. */
+static bool run(const string& options, const vector<ossimFilename>& files)
+{
+   string command = "ossim-preproc " + options;
+   for ( ossim_uint32 i = 0; i < files.size(); ++i )
+   {
+      command += " " + files[i].string();
+   }
+   cout << command << endl;
+
+   ossimArgumentParser ap(command);
+   ossimRefPtr<ossimImageUtil> util = new ossimImageUtil;
+   return util->initialize(ap) && ( util->execute() == 0 );
+}
+
+static bool run(const string& options, const ossimFilename& file)
+{
+   return run(options, vector<ossimFilename>(1, file));
+}
+
+/** @return true if both keyword list files exist and hold the same keywords and values. */
+static bool sameKeywords(const ossimFilename& a, const ossimFilename& b)
+{
+   if ( !a.exists() || !b.exists() )
+   {
+      cerr << "missing: " << ( a.exists() ? b : a ) << endl;
+      return false;
+   }
+   ossimKeywordlist akwl(a);
+   ossimKeywordlist bkwl(b);
+
+   bool result = ( akwl.getMap().size() == bkwl.getMap().size() );
+   ossimKeywordlist::KeywordMap::const_iterator i = akwl.getMap().begin();
+   while ( result && ( i != akwl.getMap().end() ) )
+   {
+      const char* value = bkwl.find(i->first.c_str());
+      if ( !value || ( i->second != value ) )
+      {
+         cerr << a << " " << i->first << ": " << i->second << "\n"
+              << b << " " << i->first << ": " << ( value ? value : "<none>" ) << endl;
+         result = false;
+      }
+      ++i;
+   }
+   return result;
+}
+
+/** Image base names; the image, overview, dot his and dot omd are base.<ext>. */
+class TestImage
+{
+public:
+   TestImage()
+      : m_base(".", "imgutil", "", true, true)
+   {
+      m_base.generateRandomFile();
+   }
+   ~TestImage()
+   {
+      const char* EXTS[] = { "tif", "ovr", "his", "omd" };
+      for ( ossim_uint32 i = 0; i < sizeof(EXTS) / sizeof(EXTS[0]); ++i )
+      {
+         file(EXTS[i]).remove();
+      }
+      m_base.remove();
+   }
+   ossimFilename file(const char* ext) const
+   {
+      return ossimFilename(m_base.string() + "." + ext);
+   }
+
+private:
+   ossimTempFilename m_base;
+};
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   //---
+   // One pass against separate passes on an image that already has overviews.
+   //---
+   {
+      TestImage one;
+      TestImage separate;
+      expect( writeImage(one.file("tif"), 700, 500) &&
+              writeImage(separate.file("tif"), 700, 500), "write images" );
+      expect( run("-o", one.file("tif")) && run("-o", separate.file("tif")) &&
+              one.file("ovr").exists() && separate.file("ovr").exists(), "build overviews" );
+
+      expect( run("-o --compute-min-max --ch", one.file("tif")),
+              "min/max and histogram in one run" );
+      expect( run("--compute-min-max", separate.file("tif")) &&
+              run("--ch", separate.file("tif")), "min/max, then histogram" );
+
+      expect( sameKeywords(one.file("his"), separate.file("his")), "same dot his" );
+      expect( sameKeywords(one.file("omd"), separate.file("omd")), "same dot omd" );
+   }
+
+   //---
+   // Memory budget of 1 MB against images of over half a megabyte each: a row of 2048 pixel
+   // wide tiles is at least 2 * 2048 * 64 * 3 bytes.  Files must wait their turn, not forever.
+   //---
+   {
+      const ossim_uint32 IMAGES = 4;
+      vector< shared_ptr<TestImage> > images;
+      vector<ossimFilename> files;
+      bool written = true;
+      for ( ossim_uint32 i = 0; i < IMAGES; ++i )
+      {
+         images.push_back(make_shared<TestImage>());
+         files.push_back(images.back()->file("tif"));
+         written = writeImage(files.back(), 2048, 256) && written;
+      }
+      expect( written, "write budget images" );
+
+      future<bool> done = async(launch::async, [&files]()
+      {
+         return run("-o --ch --threads 4 --memory-budget 1", files);
+      });
+      if ( done.wait_for(chrono::minutes(5)) != future_status::ready )
+      {
+         expect( false, "budget run finishes" );
+         cout << "failures: " << failures << endl;
+         _Exit(1); // The run is stuck; do not wait for it.
+      }
+      expect( done.get(), "budget run finishes" );
+
+      bool overviews = true;
+      for ( ossim_uint32 i = 0; i < IMAGES; ++i )
+      {
+         overviews = images[i]->file("ovr").exists() && overviews;
+      }
+      expect( overviews, "every budget image has overviews" );
+   }
+
+   cout << "failures: " << failures << endl;
+
+   return failures ? 1 : 0;
+}
@@ -0,0 +1,175 @@
+//**************************************************************************************************
+//                          OSSIM -- Open Source Software Image Map
+//
+// LICENSE: See top level LICENSE.txt file.
+//
+// Test of ossimToolServer in THREAD_POOL_MODE. Two different requests to the same tool are sent
+// one after the other on each connection, from several connections at once, so the pooled info
+// tools serve both requests in turn. Every response must match the one the request gets alone on
+// a new connection, so neither tool options nor the server's own console output carry over into a
+// response.
+//
+// Usage: ossim-tool-server-test [port]  (default 47123)
+//
+//**************************************************************************************************
+#include <ossim/init/ossimInit.h>
+#include <ossim/sockets/ossimToolClient.h>
+#include <ossim/sockets/ossimToolServer.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#if defined(__linux__)
+
+static const char* REQUESTS[] = { "info --build-date", "info --version" };
+static const ossim_uint32 CLIENTS = 4;
+static const ossim_uint32 ROUNDS = 10;
+
+/** @return true once a connection to port on this host is accepted, waiting up to 10 s. */
+static bool waitForServer(int port)
+{
+   for (int i = 0; i < 100; ++i)
+   {
+      int fd = socket(AF_INET, SOCK_STREAM, 0);
+      struct sockaddr_in addr;
+      memset(&addr, 0, sizeof addr);
+      addr.sin_family = AF_INET;
+      addr.sin_port = htons((unsigned short)port);
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      bool connected = (connect(fd, (struct sockaddr*) &addr, sizeof addr) == 0);
+      close(fd);
+      if (connected)
+         return true;
+      this_thread::sleep_for(chrono::milliseconds(100));
+   }
+   return false;
+}
+
+/** @return Text response to request on a new connection, or "" on error. */
+static string runAlone(const string& port, const char* request)
+{
+   string host = "localhost";
+   ossimToolClient client;
+   if (client.connectToServer(&host[0], (char*) port.c_str()) < 0)
+      return "";
+   string response;
+   if (client.execute(request))
+      response = client.getTextResponse();
+   client.disconnect();
+   return response;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   const string PORT = (argc > 1) ? argv[1] : "47123";
+
+   //---
+   // The server runs in a child process, as the client prints its responses to the stdout the
+   // server captures. The listener never returns; the child is killed at the end.
+   //---
+   pid_t serverPid = fork();
+   if (serverPid == 0)
+   {
+      ossimToolServer server;
+      server.setServerMode(ossimToolServer::THREAD_POOL_MODE);
+      server.setNumberOfThreads(CLIENTS);
+      server.startListening(PORT.c_str());
+      exit(0);
+   }
+   if ((serverPid < 0) || !waitForServer(atoi(PORT.c_str())))
+   {
+      cerr << "Server did not start on port " << PORT << endl;
+      if (serverPid > 0)
+         kill(serverPid, SIGTERM);
+      return 1;
+   }
+
+   // Reference responses, each request alone on a new connection:
+   string expected[2];
+   for (ossim_uint32 r = 0; r < 2; ++r)
+      expected[r] = runAlone(PORT, REQUESTS[r]);
+   ossim_uint32 failures = 0;
+   if (expected[0].empty() || expected[1].empty() || (expected[0] == expected[1]))
+   {
+      cerr << "Requests alone gave no or equal responses:\n<" << expected[0] << ">\n<"
+           << expected[1] << ">" << endl;
+      ++failures;
+   }
+
+   // Both requests in turn on each connection, all connections at once:
+   atomic<ossim_uint32> differences(0);
+   atomic<ossim_uint32> requests(0);
+   vector<thread> clients;
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (ossim_uint32 c = 0; c < CLIENTS; ++c)
+   {
+      clients.push_back(thread([&, c]()
+      {
+         string host = "localhost";
+         ossimToolClient client;
+         if (client.connectToServer(&host[0], (char*) PORT.c_str()) < 0)
+         {
+            ++differences;
+            return;
+         }
+         for (ossim_uint32 i = 0; i < ROUNDS * 2; ++i)
+         {
+            ossim_uint32 r = (i + c) % 2;
+            string response;
+            if (client.execute(REQUESTS[r]))
+               response = client.getTextResponse();
+            ++requests;
+            if (response != expected[r])
+            {
+               cerr << "client " << c << " request " << REQUESTS[r] << " got:\n<" << response
+                    << ">\nexpected:\n<" << expected[r] << ">" << endl;
+               ++differences;
+            }
+         }
+         client.disconnect();
+      }));
+   }
+   for (ossim_uint32 c = 0; c < CLIENTS; ++c)
+      clients[c].join();
+   double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   if (differences)
+      ++failures;
+
+   kill(serverPid, SIGTERM);
+   waitpid(serverPid, 0, 0);
+
+   cout << "\nrequests:     " << requests
+        << "\ndifferences:  " << differences
+        << "\nms/request:   " << 1.0e3 * seconds / (requests ? (ossim_uint32)requests : 1)
+        << endl;
+
+   return failures ? 1 : 0;
+}
+
+#else
+
+int main(int /* argc */, char* /* argv */[])
+{
+   cout << "ossimToolServer THREAD_POOL_MODE needs epoll. Skipped." << endl;
+   return 0;
+}
+
+#endif